@@ -29,6 +29,13 @@ attribute vec4 aBoneWeightsB;
 attribute float aPopProtected;
 #endif
 
+#ifdef MODEL_TO_WORLD_INSTANCED
+attribute vec4 aInstanceModelToWorld0;
+attribute vec4 aInstanceModelToWorld1;
+attribute vec4 aInstanceModelToWorld2;
+attribute vec4 aInstanceModelToWorld3;
+#endif
+
 uniform mat4 uModelToWorldMatrix;
 uniform mat4 uWorldToScreenMatrix;
 
@@ -112,7 +119,11 @@ void main(void)
     #endif // POP_LOD_ENABLED
 
 	#ifdef MODEL_TO_WORLD
-		pos = uModelToWorldMatrix * pos;
+		#ifdef MODEL_TO_WORLD_INSTANCED
+			pos = mat4(aInstanceModelToWorld0, aInstanceModelToWorld1, aInstanceModelToWorld2, aInstanceModelToWorld3) * pos;
+		#else
+			pos = uModelToWorldMatrix * pos;
+		#endif // MODEL_TO_WORLD_INSTANCED
 	#endif
 
     vec4 screenPos = uWorldToScreenMatrix * pos;
@@ -0,0 +1,144 @@
+#ifdef CLUSTERED_LIGHTING_MAX_LIGHTS
+
+#ifndef _CLUSTEREDLIGHTING_FUNCTION_GLSL_
+#define _CLUSTEREDLIGHTING_FUNCTION_GLSL_
+
+// Point and spot lights binned in clusters by the ClusteredLighting component, all stored in
+// RGBA8 data textures:
+// - clusters: one texel per cluster, the offset of its first light index in rgb and the number
+//   of lights in a
+// - indices: two 16 bits light indices per texel
+// - lights: 8 texels per light, the 16 bits values being split in 2 channels (see
+//   ClusteredLighting.cpp for the layout)
+
+uniform vec3 uClusteredLightingGrid;
+uniform vec2 uClusteredLightingDepth;
+uniform sampler2D uClusteredLightingClusters;
+uniform vec2 uClusteredLightingClustersSize;
+uniform sampler2D uClusteredLightingIndices;
+uniform vec2 uClusteredLightingIndicesSize;
+uniform sampler2D uClusteredLightingLights;
+uniform vec2 uClusteredLightingLightsSize;
+uniform vec3 uClusteredLightingBoundsMin;
+uniform vec3 uClusteredLightingBoundsSize;
+uniform vec3 uClusteredLightingScales;
+
+vec4
+clusteredLighting_fetch(sampler2D map, vec2 size, float index)
+{
+	float y = floor((index + 0.5) / size.x);
+
+	return texture2D(map, (vec2(index - y * size.x, y) + 0.5) / size);
+}
+
+float
+clusteredLighting_unpack16(vec2 value)
+{
+	return dot(value, vec2(65280.0, 255.0)) / 65535.0;
+}
+
+// The offset of the first light index of the cluster in x and its number of lights in y.
+vec2
+clusteredLighting_getCluster(vec4 screenPosition)
+{
+	vec2 tile = floor((screenPosition.xy / screenPosition.w * 0.5 + 0.5) * uClusteredLightingGrid.xy);
+	float slice = floor(log(max(screenPosition.w, uClusteredLightingDepth.x) / uClusteredLightingDepth.x) * uClusteredLightingDepth.y);
+	vec3 cluster = clamp(vec3(tile, slice), vec3(0.0), uClusteredLightingGrid - 1.0);
+	vec4 texel = clusteredLighting_fetch(
+		uClusteredLightingClusters,
+		uClusteredLightingClustersSize,
+		cluster.x + uClusteredLightingGrid.x * (cluster.y + uClusteredLightingGrid.y * cluster.z)
+	);
+
+	return floor(vec2(dot(texel.rgb, vec3(16711680.0, 65280.0, 255.0)), texel.a * 255.0) + 0.5);
+}
+
+float
+clusteredLighting_getLightIndex(float index)
+{
+	vec4 texel = clusteredLighting_fetch(uClusteredLightingIndices, uClusteredLightingIndicesSize, floor(index * 0.5));
+
+	return floor(dot(mod(index, 2.0) < 0.5 ? texel.rg : texel.ba, vec2(65280.0, 255.0)) + 0.5);
+}
+
+// Reads the light stored at the given index of the light indices and returns its attenuation
+// at the given world space position: the attenuation coefficients as in Phong.fragment.glsl, the
+// range window and, for spot lights, the cone cutoff.
+float
+clusteredLighting_getLight(float		index,
+						   vec3			position,
+						   out vec3		dir,
+						   out vec3		color,
+						   out float	diffuse,
+						   out float	specular)
+{
+	float base = clusteredLighting_getLightIndex(index) * 8.0;
+	vec4 t0 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base);
+	vec4 t1 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 1.0);
+	vec4 t2 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 2.0);
+	vec4 t3 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 3.0);
+	vec3 lightPosition = uClusteredLightingBoundsMin + uClusteredLightingBoundsSize * vec3(
+		clusteredLighting_unpack16(t0.rg),
+		clusteredLighting_unpack16(t0.ba),
+		clusteredLighting_unpack16(t1.rg)
+	);
+	float range = clusteredLighting_unpack16(t1.ba) * uClusteredLightingScales.y;
+	vec3 lightVector = lightPosition - position;
+	float dist = length(lightVector);
+	float att = 1.0;
+
+	// smooth window reaching 0 at the range, a range of 0 being unbounded
+	if (range > 0.0)
+	{
+		float ratio = dist / range;
+
+		att = clamp(1.0 - ratio * ratio * ratio * ratio, 0.0, 1.0);
+		att *= att;
+	}
+
+	// flags: 1 for spot lights, 2 for attenuated lights
+	float flags = floor(t2.a * 3.0 + 0.5);
+	vec4 t6 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 6.0);
+
+	if (flags > 1.5)
+	{
+		vec4 t7 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 7.0);
+		vec3 attenuationCoeffs = vec3(
+			clusteredLighting_unpack16(t6.ba),
+			clusteredLighting_unpack16(t7.rg),
+			clusteredLighting_unpack16(t7.ba)
+		) * uClusteredLightingScales.z;
+
+		att *= max(0.0, 1.0 - dist / dot(attenuationCoeffs, vec3(1.0, dist, dist * dist)));
+	}
+
+	dir = lightVector / max(dist, 0.00001);
+	color = t2.rgb;
+	diffuse = clusteredLighting_unpack16(t3.rg) * uClusteredLightingScales.x;
+	specular = clusteredLighting_unpack16(t3.ba) * uClusteredLightingScales.x;
+
+	if (mod(flags, 2.0) > 0.5)
+	{
+		vec4 t4 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 4.0);
+		vec4 t5 = clusteredLighting_fetch(uClusteredLightingLights, uClusteredLightingLightsSize, base + 5.0);
+		vec3 spotDirection = vec3(
+			clusteredLighting_unpack16(t4.rg),
+			clusteredLighting_unpack16(t4.ba),
+			clusteredLighting_unpack16(t5.rg)
+		) * 2.0 - 1.0;
+		float cosOuter = clusteredLighting_unpack16(t5.ba);
+		float cosInner = clusteredLighting_unpack16(t6.rg);
+		float cosSpot = dot(-dir, normalize(spotDirection));
+
+		if (cosSpot <= cosOuter)
+			att = 0.0;
+		else if (cosSpot < cosInner && cosOuter < cosInner)
+			att *= (cosSpot - cosOuter) / (cosInner - cosOuter);
+	}
+
+	return att;
+}
+
+#endif // _CLUSTEREDLIGHTING_FUNCTION_GLSL_
+
+#endif // CLUSTERED_LIGHTING_MAX_LIGHTS
@@ -18,6 +18,7 @@
 #pragma include "LightMapping.function.glsl"
 #pragma include "PBR.function.glsl"
 #pragma include "ToneMapping.function.glsl"
+#pragma include "ClusteredLighting.function.glsl"
 
 #ifdef GAMMA_CORRECTION
 uniform float uGammaCorrection;
@@ -533,7 +534,7 @@ void main(void)
     	#endif // NUM_AMBIENT_LIGHTS > 3
     #endif
 
-	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS
+	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined CLUSTERED_LIGHTING_MAX_LIGHTS
 		#if defined(NORMAL_MAP) && defined(VERTEX_UV)
 			// warning: the normal vector must be normalized at this point!
 			mat3 tangentToWorldMatrix = phong_getTangentToWorldSpaceMatrix(normalVector, vVertexTangent);
@@ -764,7 +765,31 @@ void main(void)
             #endif // NUM_SPOT_LIGHTS > 3
         #endif // defined(NUM_SPOT_LIGHTS)
 
-	#endif // defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS
+        #ifdef CLUSTERED_LIGHTING_MAX_LIGHTS
+            // only the lights binned in the cluster of the fragment are read
+            vec2 cluster = clusteredLighting_getCluster(vVertexScreenPosition);
+            vec3 lightColor = vec3(0.);
+            float lightDiffuse = 0.;
+            float lightSpecular = 0.;
+
+            for (int i = 0; i < CLUSTERED_LIGHTING_MAX_LIGHTS; ++i)
+            {
+                if (float(i) >= cluster.y)
+                    break;
+
+                att = clusteredLighting_getLight(cluster.x + float(i), vVertexPosition, dir, lightColor, lightDiffuse, lightSpecular);
+                diffuseAccum += phong_diffuseReflection(normalVector, dir) * lightColor * lightDiffuse * att;
+                #if defined(SHININESS)
+                    #if defined(FRESNEL)
+                        lightFresnel = phong_fresnel(specular.rgb, dir, eyeVector);
+                    #endif // FRESNEL
+                    specularAccum += phong_specularReflection(normalVector, dir, eyeVector, shininessCoeff) * lightColor * lightSpecular * att
+                        * lightFresnel;
+                #endif // defined(SHININESS)
+            }
+        #endif // defined(CLUSTERED_LIGHTING_MAX_LIGHTS)
+
+	#endif // defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined CLUSTERED_LIGHTING_MAX_LIGHTS
 
 	vec3 phong = diffuse.rgb * (ambientAccum + diffuseAccum) + specular.rgb * specular.a * specularAccum;
 
@@ -34,6 +34,13 @@ attribute	float	aColor;
 attribute	float 	aPopProtected;
 #endif
 
+#ifdef MODEL_TO_WORLD_INSTANCED
+attribute	vec4	aInstanceModelToWorld0;
+attribute	vec4	aInstanceModelToWorld1;
+attribute	vec4	aInstanceModelToWorld2;
+attribute	vec4	aInstanceModelToWorld3;
+#endif
+
 uniform 	mat4 	uModelToWorldMatrix;
 uniform 	mat4 	uWorldToScreenMatrix;
 
@@ -87,6 +94,14 @@ void main(void)
 		vVertexColor = vec4(packFloat8bitRGB(aColor), 1.0);
 	#endif // VERTEX_COLOR
 
+	#ifdef MODEL_TO_WORLD
+		#ifdef MODEL_TO_WORLD_INSTANCED
+			mat4 modelToWorldMatrix = mat4(aInstanceModelToWorld0, aInstanceModelToWorld1, aInstanceModelToWorld2, aInstanceModelToWorld3);
+		#else
+			mat4 modelToWorldMatrix = uModelToWorldMatrix;
+		#endif // MODEL_TO_WORLD_INSTANCED
+	#endif // MODEL_TO_WORLD
+
 	vec4 worldPosition = vec4(aPosition, 1.0);
 
 	#ifdef SKINNING_NUM_BONES
@@ -108,10 +123,10 @@ void main(void)
 	#endif // POP_LOD_ENABLED
 
 	#ifdef MODEL_TO_WORLD
-		worldPosition 	= uModelToWorldMatrix * worldPosition;
+		worldPosition 	= modelToWorldMatrix * worldPosition;
 	#endif // MODEL_TO_WORLD
 
-	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined ENVIRONMENT_MAP_2D || defined ENVIRONMENT_CUBE_MAP
+	#if defined NUM_DIRECTIONAL_LIGHTS || defined NUM_POINT_LIGHTS || defined NUM_SPOT_LIGHTS || defined CLUSTERED_LIGHTING_MAX_LIGHTS || defined ENVIRONMENT_MAP_2D || defined ENVIRONMENT_CUBE_MAP
 
 		vVertexPosition = worldPosition.xyz;
 		vVertexNormal = aNormal;
@@ -121,19 +136,19 @@ void main(void)
 		#endif // SKINNING_NUM_BONES
 
 		#ifdef MODEL_TO_WORLD
-			vVertexNormal = mat3(uModelToWorldMatrix) * vVertexNormal;
+			vVertexNormal = mat3(modelToWorldMatrix) * vVertexNormal;
 		#endif // MODEL_TO_WORLD
 		vVertexNormal = normalize(vVertexNormal);
 
 		#ifdef NORMAL_MAP
 			vVertexTangent = aTangent;
 			#ifdef MODEL_TO_WORLD
-				vVertexTangent = mat3(uModelToWorldMatrix) * vVertexTangent;
+				vVertexTangent = mat3(modelToWorldMatrix) * vVertexTangent;
 			#endif // MODEL_TO_WORLD
 			vVertexTangent = normalize(vVertexTangent);
 		#endif // NORMAL_MAP
 
-	#endif // NUM_DIRECTIONAL_LIGHTS || NUM_POINT_LIGHTS || NUM_SPOT_LIGHTS || ENVIRONMENT_MAP_2D || ENVIRONMENT_CUBE_MAP
+	#endif // NUM_DIRECTIONAL_LIGHTS || NUM_POINT_LIGHTS || NUM_SPOT_LIGHTS || CLUSTERED_LIGHTING_MAX_LIGHTS || ENVIRONMENT_MAP_2D || ENVIRONMENT_CUBE_MAP
 
 	vec4 screenPosition = uWorldToScreenMatrix * worldPosition;
 
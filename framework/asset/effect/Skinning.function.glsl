@@ -1,10 +1,105 @@
 #if defined(VERTEX_SHADER) && defined(SKINNING_NUM_BONES)
 # if SKINNING_NUM_BONES != 0
 
-	uniform mat4 uBoneMatrices[SKINNING_NUM_BONES];
+// SKINNING_PALETTE: 0 = 4x4 matrices, 1 = 3x4 matrices (3 rows per bone),
+// 2 = dual quaternions (real then dual part of each bone)
+#  ifndef SKINNING_PALETTE
+#   define SKINNING_PALETTE 0
+#  endif
+
 	attribute vec4 aBoneIdsA;
 	attribute vec4 aBoneIdsB;
 
+#  if SKINNING_PALETTE == 1
+
+	uniform vec4 uBoneMatrices[SKINNING_NUM_BONES * 3];
+
+	vec4 skinning_blendRow(int row, vec4 boneWeightsA, vec4 boneWeightsB)
+	{
+		return boneWeightsA.x * uBoneMatrices[int(aBoneIdsA.x) * 3 + row] +
+			boneWeightsA.y * uBoneMatrices[int(aBoneIdsA.y) * 3 + row] +
+			boneWeightsA.z * uBoneMatrices[int(aBoneIdsA.z) * 3 + row] +
+			boneWeightsA.w * uBoneMatrices[int(aBoneIdsA.w) * 3 + row] +
+			boneWeightsB.x * uBoneMatrices[int(aBoneIdsB.x) * 3 + row] +
+			boneWeightsB.y * uBoneMatrices[int(aBoneIdsB.y) * 3 + row] +
+			boneWeightsB.z * uBoneMatrices[int(aBoneIdsB.z) * 3 + row] +
+			boneWeightsB.w * uBoneMatrices[int(aBoneIdsB.w) * 3 + row];
+	}
+
+	vec4 skinning_moveVertex(vec4 inputVec,
+							 vec4 boneWeightsA,
+							 vec4 boneWeightsB)
+	{
+		return vec4(
+			dot(skinning_blendRow(0, boneWeightsA, boneWeightsB), inputVec),
+			dot(skinning_blendRow(1, boneWeightsA, boneWeightsB), inputVec),
+			dot(skinning_blendRow(2, boneWeightsA, boneWeightsB), inputVec),
+			inputVec.w
+		);
+	}
+
+	vec3 skinning_skinNormal(vec3 inputVec,
+							 vec4 boneWeightsA,
+							 vec4 boneWeightsB)
+	{
+		return skinning_moveVertex(vec4(inputVec, 0.0), boneWeightsA, boneWeightsB).xyz;
+	}
+
+#  elif SKINNING_PALETTE == 2
+
+	uniform vec4 uBoneMatrices[SKINNING_NUM_BONES * 2];
+
+	void skinning_addDualQuaternion(float boneId, float weight, vec4 pivot, inout vec4 real, inout vec4 dual)
+	{
+		vec4 boneReal = uBoneMatrices[int(boneId) * 2];
+
+		// q and -q are the same rotation: blend in the hemisphere of the first bone
+		weight = dot(boneReal, pivot) < 0.0 ? -weight : weight;
+
+		real += weight * boneReal;
+		dual += weight * uBoneMatrices[int(boneId) * 2 + 1];
+	}
+
+	vec4 skinning_moveVertex(vec4 inputVec,
+							 vec4 boneWeightsA,
+							 vec4 boneWeightsB)
+	{
+		vec4 pivot = uBoneMatrices[int(aBoneIdsA.x) * 2];
+		vec4 real = vec4(0.0);
+		vec4 dual = vec4(0.0);
+
+		skinning_addDualQuaternion(aBoneIdsA.x, boneWeightsA.x, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsA.y, boneWeightsA.y, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsA.z, boneWeightsA.z, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsA.w, boneWeightsA.w, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsB.x, boneWeightsB.x, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsB.y, boneWeightsB.y, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsB.z, boneWeightsB.z, pivot, real, dual);
+		skinning_addDualQuaternion(aBoneIdsB.w, boneWeightsB.w, pivot, real, dual);
+
+		float len = length(real);
+
+		real /= len;
+		dual /= len;
+
+		vec3 v = inputVec.xyz;
+		vec3 rotated = v + 2.0 * cross(real.xyz, cross(real.xyz, v) + real.w * v);
+		vec3 translation = 2.0 * (real.w * dual.xyz - dual.w * real.xyz + cross(real.xyz, dual.xyz));
+
+		return vec4(rotated + inputVec.w * translation, inputVec.w);
+	}
+
+	vec3 skinning_skinNormal(vec3 inputVec,
+							 vec4 boneWeightsA,
+							 vec4 boneWeightsB)
+	{
+		return skinning_moveVertex(vec4(inputVec, 0.0), boneWeightsA, boneWeightsB).xyz;
+	}
+
+#  else
+
+	uniform mat4 uBoneMatrices[SKINNING_NUM_BONES];
+
 	vec4 skinning_moveVertex(vec4 inputVec,
 							 vec4 boneWeightsA,
 							 vec4 boneWeightsB)
@@ -37,5 +132,6 @@
 		) * inputVec;
 	}
 
+#  endif
 # endif
 #endif
@@ -100,6 +100,8 @@ namespace minko
         class DrawCallPool;
 		class AbstractContext;
 		class OpenGLES2Context;
+		class RecordingContext;
+		class CommandLogReplayer;
         class Blending;
 		enum class CompareMode;
         enum class TriangleCulling;
@@ -121,6 +123,8 @@ namespace minko
 		class Shader;
 		class Program;
 		class ProgramSignature;
+		class ProgramCache;
+		class ProgramBuilder;
 		class VertexFormat;
         class VertexAttribute;
         class VertexBuffer;
@@ -138,6 +142,8 @@ namespace minko
         class RectangleTexture;
 		class CubeTexture;
         struct TextureSampler;
+		class TextureProcessor;
+		class LightClusters;
 
 		typedef std::function<std::string(const std::string&)> FormatNameFunction;
 		typedef std::list<std::pair<Flyweight<std::string>, Flyweight<std::string>>> EffectVariables;
@@ -147,6 +153,7 @@ namespace minko
 	{
 		class Node;
 		class NodeSet;
+		class RayQuery;
 	}
 
 	namespace component
@@ -160,6 +167,7 @@ namespace minko
 		class PerspectiveCamera;
 		class Culling;
 		class Picking;
+		enum class PickingMode;
 		class JobManager;
 
         class AbstractLight;
@@ -169,6 +177,7 @@ namespace minko
 		class SpotLight;
 		class PointLight;
         class ShadowMappingTechnique;
+        class ClusteredLighting;
 
 		class BoundingBox;
 
@@ -176,6 +185,7 @@ namespace minko
 		class MouseManager;
         class AbstractScript;
 		enum class SkinningMethod;
+		enum class SkinningPalette;
 
 		class AbstractAnimation;
 		class MasterAnimation;
@@ -191,6 +201,7 @@ namespace minko
 		class Store;
 		class AbstractFilter;
         class Collection;
+        class PropertyPath;
 
         struct Binding;
         struct MacroBinding;
@@ -214,6 +225,7 @@ namespace minko
 	{
 		class AbstractTimeline;
 		class Matrix4x4Timeline;
+		class AnimationClip;
 	}
 
 	namespace math
@@ -225,6 +237,7 @@ namespace minko
 		class Box;
 		class Frustum;
 		class OctTree;
+		class BoundingVolumeHierarchy;
 
 		inline
 		vec4
@@ -293,6 +306,7 @@ namespace minko
         class AbstractProtocol;
 		class AbstractParser;
 		class EffectParser;
+		class EffectCache;
         class AssetLibrary;
         class AssetLocation;
         class AbstractAssetDescriptor;
@@ -344,6 +358,7 @@ namespace minko
 	namespace async
 	{
 		class Worker;
+		class ThreadPool;
 	}
 
     namespace log
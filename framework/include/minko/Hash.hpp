@@ -23,6 +23,20 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 namespace minko
 {
+    // FNV-1a of size bytes. Passing the result of a previous call as seed hashes the
+    // concatenation of both byte ranges.
+    inline
+    std::uint64_t
+    hash(const void* data, std::size_t size, std::uint64_t seed = 14695981039346656037ull)
+    {
+        auto bytes = static_cast<const unsigned char*>(data);
+
+        for (std::size_t i = 0; i < size; ++i)
+            seed = (seed ^ bytes[i]) * 1099511628211ull;
+
+        return seed;
+    }
+
     template <typename T>
     struct Hash;
 
@@ -31,6 +31,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/CloneOption.hpp"
 #include "minko/render/AbstractContext.hpp"
 #include "minko/render/OpenGLES2Context.hpp"
+#include "minko/render/RecordingContext.hpp"
+#include "minko/render/CommandLogReplayer.hpp"
 #include "minko/render/ProgramInputs.hpp"
 #include "minko/render/Pass.hpp"
 #include "minko/render/Shader.hpp"
@@ -40,14 +42,18 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/CompareMode.hpp"
 #include "minko/render/StencilOperation.hpp"
 #include "minko/math/AbstractShape.hpp"
+#include "minko/math/BoundingVolumeHierarchy.hpp"
 #include "minko/math/Box.hpp"
 #include "minko/math/Frustum.hpp"
 #include "minko/math/OctTree.hpp"
 #include "minko/math/Ray.hpp"
+#include "minko/math/Simd.hpp"
 #include "minko/scene/Node.hpp"
 #include "minko/scene/NodeSet.hpp"
+#include "minko/scene/RayQuery.hpp"
 #include "minko/data/Provider.hpp"
 #include "minko/data/Store.hpp"
+#include "minko/data/PropertyPath.hpp"
 #include "minko/data/AbstractFilter.hpp"
 #include "minko/data/MacroBinding.hpp"
 #include "minko/component/AbstractComponent.hpp"
@@ -64,12 +70,15 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/PointLight.hpp"
 #include "minko/component/ImageBasedLight.hpp"
 #include "minko/component/ShadowMappingTechnique.hpp"
+#include "minko/component/ClusteredLighting.hpp"
 #include "minko/component/BoundingBox.hpp"
 #include "minko/component/MousePicking.hpp"
 #include "minko/component/MouseManager.hpp"
 #include "minko/component/SkinningMethod.hpp"
+#include "minko/component/SkinningPalette.hpp"
 #include "minko/component/Culling.hpp"
 #include "minko/component/Picking.hpp"
+#include "minko/component/PickingMode.hpp"
 #include "minko/component/AbstractAnimation.hpp"
 #include "minko/component/MasterAnimation.hpp"
 #include "minko/component/Animation.hpp"
@@ -77,9 +86,12 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/Metadata.hpp"
 #include "minko/animation/AbstractTimeline.hpp"
 #include "minko/animation/Matrix4x4Timeline.hpp"
+#include "minko/animation/AnimationClip.hpp"
 #include "minko/component/JobManager.hpp"
 #include "minko/render/AbstractResource.hpp"
 #include "minko/render/Program.hpp"
+#include "minko/render/ProgramCache.hpp"
+#include "minko/render/ProgramBuilder.hpp"
 #include "minko/render/VertexBuffer.hpp"
 #include "minko/render/IndexBuffer.hpp"
 #include "minko/render/AbstractTexture.hpp"
@@ -88,6 +100,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/CubeTexture.hpp"
 #include "minko/render/Priority.hpp"
 #include "minko/render/TextureFormat.hpp"
+#include "minko/render/TextureProcessor.hpp"
+#include "minko/render/LightClusters.hpp"
 #include "minko/geometry/Geometry.hpp"
 #include "minko/geometry/CubeGeometry.hpp"
 #include "minko/geometry/SphereGeometry.hpp"
@@ -102,6 +116,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/FileProtocolWorker.hpp"
 #include "minko/file/AbstractParser.hpp"
 #include "minko/file/EffectParser.hpp"
+#include "minko/file/EffectCache.hpp"
 #include "minko/file/AssetLibrary.hpp"
 #include "minko/file/AssetLocation.hpp"
 #include "minko/file/AbstractAssetDescriptor.hpp"
@@ -114,4 +129,6 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/input/Touch.hpp"
 #include "minko/scene/Layout.hpp"
 #include "minko/async/Worker.hpp"
+#include "minko/async/ThreadPool.hpp"
+#include "minko/async/SpscQueue.hpp"
 #include "minko/log/Logger.hpp"
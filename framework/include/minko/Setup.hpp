@@ -274,3 +274,19 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #else
 # define MINKO_DEVICE MINKO_DEVICE_UNKNOWN
 #endif
+
+// SIMD
+
+#define MINKO_SIMD_NONE                0x00000000
+#define MINKO_SIMD_SSE2                0x00000001
+#define MINKO_SIMD_NEON                0x00000002
+
+#if defined(MINKO_FORCE_SIMD_NONE)
+# define MINKO_SIMD MINKO_SIMD_NONE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define MINKO_SIMD MINKO_SIMD_SSE2
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+# define MINKO_SIMD MINKO_SIMD_NEON
+#else
+# define MINKO_SIMD MINKO_SIMD_NONE
+#endif
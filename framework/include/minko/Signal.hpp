@@ -34,37 +34,93 @@ namespace minko
 		template <typename... B>
 		class SignalSlot;
 
-        typedef std::weak_ptr<SignalSlot<A...>>             SlotWeakPtr;
-        typedef std::tuple<float, Callback, SlotWeakPtr>	CallbackRecord;
-        typedef std::list<CallbackRecord>                   CallbackCollection;
-		typedef typename CallbackCollection::iterator		CallbackIterator;
+        struct CallbackRecord
+        {
+            float               priority;
+            Callback            callback;
+            // Set to nullptr when the callback is disconnected while the signal is executed.
+            SignalSlot<A...>*   slot;
+        };
+
+        typedef std::vector<CallbackRecord>                 CallbackCollection;
+
+        // Restores the dispatch state when leaving execute(), unless the signal was destroyed
+        // by one of its callbacks.
+        struct ExecuteGuard
+        {
+            const Signal*   signal;
+            bool            destroyed;
+            bool*           outerDestroyed;
+
+            ExecuteGuard(const Signal* signal) :
+                signal(signal),
+                destroyed(false),
+                outerDestroyed(signal->_destroyed)
+            {
+                signal->_destroyed = &destroyed;
+                ++signal->_executeDepth;
+            }
+
+            ~ExecuteGuard()
+            {
+                if (destroyed)
+                {
+                    if (outerDestroyed)
+                        *outerDestroyed = true;
+                    return;
+                }
+
+                signal->_destroyed = outerDestroyed;
+                if (--signal->_executeDepth == 0 && signal->_mustCompact)
+                    signal->compact();
+            }
+        };
 
     public:
 		typedef std::shared_ptr<SignalSlot<A...>>   Slot;
 
 	private:
-        CallbackCollection  _callbacks;
+        // Callbacks are stored contiguously, sorted by decreasing priority. While the signal is
+        // executed, disconnected callbacks are only flagged and new ones are queued in
+        // _pendingCallbacks so that execute() can iterate without copying anything: both are
+        // applied when the outermost execute() returns.
+        mutable CallbackCollection  _callbacks;
+        mutable CallbackCollection  _pendingCallbacks;
+        uint                        _numCallbacks;
+        mutable uint                _executeDepth;
+        mutable bool                _mustCompact;
+        mutable bool*               _destroyed;
 
 	public:
-        Signal()
+        Signal() :
+            _numCallbacks(0),
+            _executeDepth(0),
+            _mustCompact(false),
+            _destroyed(nullptr)
         {
         }
 
-		Signal(const Signal& other)
+		Signal(const Signal& other) :
+            _numCallbacks(0),
+            _executeDepth(0),
+            _mustCompact(false),
+            _destroyed(nullptr)
 		{
 		}
 
-        Signal(Signal&& other)
+        Signal(Signal&& other) :
+            _numCallbacks(0),
+            _executeDepth(0),
+            _mustCompact(false),
+            _destroyed(nullptr)
         {
-            std::move(other._callbacks.begin(), other._callbacks.end(), _callbacks.begin());
-            assert(other._callbacks.size() == 0);
+            moveFrom(other);
         }
 
         Signal&
         operator=(Signal&& other)
         {
-            std::move(other._callbacks.begin(), other._callbacks.end(), _callbacks.begin());
-            assert(other._callbacks.size() == 0);
+            moveFrom(other);
 
             return *this;
         }
@@ -72,13 +128,14 @@ namespace minko
         ~Signal()
         {
             for (const auto& callback : _callbacks)
-            {
-                auto slot = std::get<2>(callback).lock();
-
-                if (slot)
-                    slot->_signal = nullptr;
-            }
-            _callbacks.clear();
+                if (callback.slot)
+                    callback.slot->_signal = nullptr;
+            for (const auto& callback : _pendingCallbacks)
+                if (callback.slot)
+                    callback.slot->_signal = nullptr;
+
+            if (_destroyed)
+                *_destroyed = true;
         }
 
         inline
@@ -93,7 +150,7 @@ namespace minko
 		uint
 		numCallbacks() const
 		{
-			return _callbacks.size();
+			return _numCallbacks;
 		}
 
 		Slot
@@ -101,37 +158,46 @@ namespace minko
 		{
 			auto connection = std::make_shared<SignalSlot<A...>>(this);
 
-            _callbacks.push_back(CallbackRecord(priority, callback, connection));
-            connection->_it = std::prev(_callbacks.end());
-
-			if (_callbacks.size() >= 2)
-			{
-				auto prec = std::prev(_callbacks.end(), 2);
+            ++_numCallbacks;
 
-                if (priority > std::get<0>(*prec))
-                {
-                    _callbacks.sort([](const CallbackRecord& callback1, const CallbackRecord& callback2)
-                    {
-                        return std::get<0>(callback1) > std::get<0>(callback2);
-                    });
-                }
-			}
+            // Callbacks connected during execute() will only be called by the next one.
+            if (_executeDepth != 0)
+            {
+                connection->_pending = true;
+                connection->_index = _pendingCallbacks.size();
+                _pendingCallbacks.push_back({ priority, std::move(callback), connection.get() });
+                _mustCompact = true;
+            }
+            else
+                insertCallback({ priority, std::move(callback), connection.get() });
 
 			return connection;
 		}
 
+		// A callback disconnected by an earlier callback of the same execute() is not called, even
+		// though the previous list-based implementation still called it as long as its slot was
+		// alive. A callback connected during execute() is only called by the next one.
 		void
 		execute(A... arguments) const
 		{
-            auto callbacks = _callbacks;
-            for (auto& callback : callbacks)
-                if (!std::get<2>(callback).expired())
-				    std::get<1>(callback)(arguments...);
-
-#ifdef DEBUG
-            for (auto& callback : _callbacks)
-                assert(!std::get<2>(callback).expired());
-#endif // DEBUG
+            if (_callbacks.empty())
+                return;
+
+            ExecuteGuard guard(this);
+            auto numCallbacks = _callbacks.size();
+
+            for (auto i = 0u; i < numCallbacks; ++i)
+            {
+                const auto& callback = _callbacks[i];
+
+                if (callback.slot == nullptr)
+                    continue;
+
+                callback.callback(arguments...);
+
+                if (guard.destroyed)
+                    return;
+            }
 		}
 
         inline
@@ -141,6 +207,82 @@ namespace minko
             return connect(callback);
         }
 
+	private:
+        void
+        insertCallback(CallbackRecord&& callback) const
+        {
+            // after the callbacks with the same priority to keep the connection order
+            auto position = std::upper_bound(
+                _callbacks.begin(),
+                _callbacks.end(),
+                callback.priority,
+                [](float priority, const CallbackRecord& record) { return priority > record.priority; }
+            );
+            auto index = position - _callbacks.begin();
+
+            callback.slot->_pending = false;
+            _callbacks.insert(position, std::move(callback));
+            updateIndices(index);
+        }
+
+        void
+        removeCallback(SignalSlot<A...>* slot)
+        {
+            --_numCallbacks;
+
+            if (_executeDepth != 0)
+            {
+                (slot->_pending ? _pendingCallbacks : _callbacks)[slot->_index].slot = nullptr;
+                _mustCompact = true;
+
+                return;
+            }
+
+            _callbacks.erase(_callbacks.begin() + slot->_index);
+            updateIndices(slot->_index);
+        }
+
+        void
+        compact() const
+        {
+            _callbacks.erase(
+                std::remove_if(_callbacks.begin(), _callbacks.end(), [](const CallbackRecord& r) { return r.slot == nullptr; }),
+                _callbacks.end()
+            );
+            updateIndices(0);
+
+            for (auto& callback : _pendingCallbacks)
+                if (callback.slot != nullptr)
+                    insertCallback(std::move(callback));
+            _pendingCallbacks.clear();
+
+            _mustCompact = false;
+        }
+
+        void
+        updateIndices(uint first) const
+        {
+            for (auto i = first; i < _callbacks.size(); ++i)
+                _callbacks[i].slot->_index = i;
+        }
+
+        void
+        moveFrom(Signal& other)
+        {
+            assert(other._executeDepth == 0 && _executeDepth == 0);
+
+            for (const auto& callback : _callbacks)
+                callback.slot->_signal = nullptr;
+
+            _callbacks = std::move(other._callbacks);
+            _numCallbacks = other._numCallbacks;
+            other._callbacks.clear();
+            other._numCallbacks = 0;
+
+            for (const auto& callback : _callbacks)
+                callback.slot->_signal = this;
+        }
+
 	private:
 		template <typename... T>
 		class SignalSlot :
@@ -153,11 +295,14 @@ namespace minko
 
 		private:
 			Signal<T...>* 	  _signal;
-            CallbackIterator  _it;
+            uint              _index;
+            bool              _pending;
 
 		public:
 			SignalSlot(Signal<T...>* signal) :
-				_signal(signal)
+				_signal(signal),
+                _index(0),
+                _pending(false)
 			{
 			}
 
@@ -172,7 +317,7 @@ namespace minko
 			{
                 if (_signal)
                 {
-                    _signal->_callbacks.erase(_it);
+                    _signal->removeCallback(this);
                     _signal = nullptr;
                 }
 			}
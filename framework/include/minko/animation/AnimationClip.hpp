@@ -0,0 +1,159 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace animation
+	{
+		// Compressed animation of several transform tracks, typically one per bone. Each key stores
+		// its rotation on 48 bits (smallest three encoding) and its translation and scale on 16 bits
+		// per component, quantized in the bounds of the track. Keys are stored as structures of
+		// arrays, the keys of a track being contiguous.
+		class AnimationClip
+		{
+		public:
+			typedef std::shared_ptr<AnimationClip>	Ptr;
+
+			// Key of each track found by the last call to sample(): sampling at increasing times
+			// then locates the keys in constant time.
+			typedef std::vector<uint>				Cursors;
+
+		private:
+			typedef std::vector<unsigned short>		QuantizedComponents;
+
+			struct Track
+			{
+				uint		firstKey;
+				uint		numKeys;
+				math::vec3	translationMin;
+				math::vec3	translationStep;
+				math::vec3	scaleMin;
+				math::vec3	scaleStep;
+			};
+
+		private:
+			uint								_duration;
+			std::vector<Track>					_tracks;
+
+			std::vector<uint>					_times;
+			std::array<QuantizedComponents, 3>	_rotations;
+			std::array<QuantizedComponents, 3>	_translations;
+			std::array<QuantizedComponents, 3>	_scales;
+
+		public:
+			// Compresses one track per timetable, matrices[i][j] being the transform of the track i
+			// at the time timetables[i][j]. The matrices must be affine, without shear.
+			inline static
+			Ptr
+			create(uint										duration,
+				   const std::vector<std::vector<uint>>&		timetables,
+				   const std::vector<std::vector<math::mat4>>&	matrices)
+			{
+				return std::shared_ptr<AnimationClip>(new AnimationClip(duration, timetables, matrices));
+			}
+
+			inline
+			uint
+			duration() const
+			{
+				return _duration;
+			}
+
+			inline
+			uint
+			numTracks() const
+			{
+				return _tracks.size();
+			}
+
+			inline
+			uint
+			numKeys(uint trackId) const
+			{
+				return _tracks[trackId].numKeys;
+			}
+
+			// Size of the keys and of the tracks, in bytes.
+			uint
+			memorySize() const;
+
+			// Decoded key, without interpolation.
+			void
+			key(uint trackId, uint keyId, math::vec3& translation, math::quat& rotation, math::vec3& scale) const;
+
+			// Writes the transform of every track at the given time, looped over the duration. The
+			// keys are interpolated linearly (normalized linearly for the rotations), 4 tracks at a
+			// time with SIMD instructions.
+			void
+			sample(uint time, Cursors& cursors, math::mat4* matrices) const;
+
+			inline
+			void
+			sample(uint time, Cursors& cursors, std::vector<math::mat4>& matrices) const
+			{
+				matrices.resize(_tracks.size());
+
+				if (!matrices.empty())
+					sample(time, cursors, matrices.data());
+			}
+
+		private:
+			AnimationClip(uint											duration,
+						  const std::vector<std::vector<uint>>&			timetables,
+						  const std::vector<std::vector<math::mat4>>&	matrices);
+
+			void
+			addTrack(const std::vector<uint>& timetable, const std::vector<math::mat4>& matrices);
+
+			uint
+			findKey(const Track& track, uint time, uint& cursor) const;
+
+			static
+			void
+			encodeRotation(const math::quat& rotation, unsigned short* components);
+
+			static
+			math::quat
+			decodeRotation(unsigned short a, unsigned short b, unsigned short c);
+
+			inline
+			math::quat
+			rotation(uint key) const
+			{
+				return decodeRotation(_rotations[0][key], _rotations[1][key], _rotations[2][key]);
+			}
+
+			static
+			inline
+			math::vec3
+			dequantize(const std::array<QuantizedComponents, 3>& components,
+					   uint										key,
+					   const math::vec3&							min,
+					   const math::vec3&							step)
+			{
+				return min + step * math::vec3(components[0][key], components[1][key], components[2][key]);
+			}
+		};
+	}
+}
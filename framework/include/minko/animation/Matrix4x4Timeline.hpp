@@ -38,6 +38,7 @@ namespace minko
 		private:
 			MatrixTimetable	            _matrices;
 			bool			            _interpolate;
+			mutable uint				_keyCursor;		// key found by the last lookup
 
 		public:
 			inline static
@@ -0,0 +1,104 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include <atomic>
+
+namespace minko
+{
+    namespace async
+    {
+        // Bounded lock-free queue for one producer thread and one consumer thread. Items are moved
+        // in and out, so that large buffers change hands without being copied.
+        template <typename T>
+        class SpscQueue
+        {
+        private:
+            std::vector<T>      _items;
+            const uint          _mask;
+            std::atomic<uint>   _head;  // next item to pop, only written by the consumer
+            std::atomic<uint>   _tail;  // next item to push, only written by the producer
+
+        public:
+            // capacity is rounded up to a power of 2.
+            explicit
+            SpscQueue(uint capacity) :
+                _items(math::clp2(std::max(capacity, 2u))),
+                _mask(_items.size() - 1),
+                _head(0),
+                _tail(0)
+            {
+            }
+
+            inline
+            uint
+            capacity() const
+            {
+                return _items.size();
+            }
+
+            // Can be called from both threads, the result being only a hint for the other one.
+            inline
+            bool
+            empty() const
+            {
+                return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+            }
+
+            // Producer side. item is only moved from when there was room for it.
+            bool
+            tryPush(T&& item)
+            {
+                const auto tail = _tail.load(std::memory_order_relaxed);
+
+                if (tail - _head.load(std::memory_order_acquire) == _items.size())
+                    return false;
+
+                _items[tail & _mask] = std::move(item);
+                _tail.store(tail + 1, std::memory_order_release);
+
+                return true;
+            }
+
+            // Consumer side.
+            bool
+            tryPop(T& item)
+            {
+                const auto head = _head.load(std::memory_order_relaxed);
+
+                if (head == _tail.load(std::memory_order_acquire))
+                    return false;
+
+                item = std::move(_items[head & _mask]);
+                _head.store(head + 1, std::memory_order_release);
+
+                return true;
+            }
+
+        private:
+            SpscQueue(const SpscQueue&) = delete;
+
+            SpscQueue&
+            operator=(const SpscQueue&) = delete;
+        };
+    }
+}
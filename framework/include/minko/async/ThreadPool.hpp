@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+
+namespace minko
+{
+    namespace async
+    {
+        // A fixed set of threads waiting for data-parallel work. parallelFor() splits a range in
+        // chunks that are processed by the pool threads and by the calling thread, and returns once
+        // all of them are done. enqueue() runs independent tasks in the background: they are started
+        // in FIFO order, but may run concurrently.
+        // Without thread support (HTML5) everything runs on the calling thread.
+        class ThreadPool
+        {
+        public:
+            typedef std::shared_ptr<ThreadPool>                 Ptr;
+            typedef std::function<void(uint begin, uint end)>   RangeTask;
+            typedef std::function<void()>                       Task;
+
+        private:
+            struct Job
+            {
+                const RangeTask*    task;
+                uint                size;
+                uint                chunkSize;
+                uint                numChunks;
+                std::atomic<uint>   nextChunk;
+                std::atomic<uint>   numDoneChunks;
+                std::exception_ptr  exception;
+            };
+
+        private:
+            std::vector<std::thread>                    _threads;
+
+            std::mutex                                  _jobMutex;
+            std::mutex                                  _mutex;
+            std::condition_variable                     _workAvailable;
+            std::condition_variable                     _workDone;
+            Job                                         _job;
+            std::deque<std::packaged_task<void()>>      _tasks;
+            uint                                        _jobId;
+            uint                                        _numBusyThreads;
+            bool                                        _stopping;
+
+        public:
+            // numThreads = 0 uses one thread less than the number of cores, the calling thread
+            // being the last one.
+            inline static
+            Ptr
+            create(uint numThreads = 0)
+            {
+                return std::shared_ptr<ThreadPool>(new ThreadPool(numThreads));
+            }
+
+            // Pool shared by the components of the engine, created on first use.
+            static
+            Ptr
+            defaultPool();
+
+            inline
+            uint
+            numThreads() const
+            {
+                return _threads.size();
+            }
+
+            // Calls task on sub-ranges of [0, size) of at least minChunkSize elements. Calls made
+            // from a pool thread or while the pool is already busy run on the calling thread.
+            // The first exception thrown by a chunk is rethrown once all the chunks are done.
+            void
+            parallelFor(uint size, uint minChunkSize, const RangeTask& task);
+
+            // Runs task on the first available pool thread. Tasks are started in FIFO order, they
+            // may run concurrently. The pool threads pick the chunks of a parallelFor() before the
+            // pending tasks. Exceptions are rethrown by get().
+            std::future<void>
+            enqueue(const Task& task);
+
+            ~ThreadPool();
+
+        private:
+            ThreadPool(uint numThreads);
+
+            void
+            run();
+
+            void
+            runChunks();
+
+            void
+            runTask();
+        };
+    }
+}
@@ -20,6 +20,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #pragma once
 
 #include "minko/async/Worker.hpp"
+#include "minko/async/ThreadPool.hpp"
+#include "minko/async/SpscQueue.hpp"
+#include "minko/log/Logger.hpp"
 
 #if MINKO_PLATFORM == MINKO_PLATFORM_HTML5
 # error "ThreadWorkerImpl is not available under Emscripten"
@@ -31,43 +34,58 @@ namespace minko
     {
         class Worker::WorkerImpl // ThreadWorkerImpl
         {
+        private:
+            static const uint QUEUE_CAPACITY = 1024;
+
         public:
             void
-            start(const std::vector<char>& input)
+            start(std::vector<char> input)
             {
-                //std::cout << "ThreadWorkerImpl::start()" << std::endl;;
+                _input = std::move(input);
+                _finished = false;
 
-                _input = input;
+                auto that = _that->shared_from_this();
 
-                std::thread(&Worker::run, _that->shared_from_this(), std::ref(_input)).detach();
+                workerPool()->enqueue([that]()
+                {
+                    try
+                    {
+                        that->run(that->_impl->_input);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        LOG_ERROR(e.what());
+
+                        that->post(Message("error"));
+                    }
+
+                    that->_impl->_finished.store(true, std::memory_order_release);
+                });
             }
 
             void
             poll()
             {
-                // std::cout << "ThreadWorkerImpl::poll()" << std::endl;;
+                Message message;
 
-                std::lock_guard<std::mutex> lock(_mutex);
+                while (_messages.tryPop(message))
+                    _message->execute(_that->shared_from_this(), message);
+            }
 
-                while (!_messages.empty())
-                {
-                    //std::cout << "ThreadWorkerImpl::poll(): message execute" << std::endl;
-                    _message->execute(_that->shared_from_this(), _messages.front());
-                    _messages.pop();
-                }
+            bool
+            finished()
+            {
+                return _finished.load(std::memory_order_acquire) && _messages.empty();
             }
 
             void
             post(Message message)
             {
-                //std::cout << "ThreadWorkerImpl::post(): " << message.type << std::endl;
-                std::lock_guard<std::mutex> lock(_mutex);
-
-                // FIXME: Optimize here (useless copy).
-                _messages.push(message);
+                while (!_messages.tryPush(std::move(message)))
+                    std::this_thread::yield();
             }
 
-            Signal<Ptr, Message>::Ptr
+            MessageSignal::Ptr
             message()
             {
                 return _message;
@@ -75,24 +93,35 @@ namespace minko
 
             ~WorkerImpl()
             {
-                //std::cout << "ThreadWorkerImpl::~ThreadWorkerImpl()" << std::endl;
             }
 
             WorkerImpl(Worker* that, const std::string& name) :
                 _that(that),
                 _name(name),
-                _message(Signal<Ptr, Message>::create())
+                _messages(QUEUE_CAPACITY),
+                _message(MessageSignal::create()),
+                _finished(false)
             {
-                //std::cout << "ThreadWorkerImpl::ThreadWorkerImpl()" << std::endl;
             }
 
         private:
             Worker*                                         _that;
             std::string                                     _name;
-            std::mutex                                      _mutex;
-            std::queue<Message>                             _messages;
-            std::shared_ptr<Signal<Ptr, Message>>           _message;
+            SpscQueue<Message>                              _messages;
+            MessageSignal::Ptr                              _message;
             std::vector<char>                               _input;
+            std::atomic<bool>                               _finished;
+
+            // Workers mostly wait for I/O: they get their own pool so that they never delay the
+            // parallelFor() of the default one.
+            static
+            ThreadPool::Ptr
+            workerPool()
+            {
+                static auto pool = ThreadPool::create(std::max(4u, std::thread::hardware_concurrency()));
+
+                return pool;
+            }
         };
     }
 }
@@ -35,7 +35,7 @@ namespace minko
         {
         public:
             void
-            start(const std::vector<char>& input)
+            start(std::vector<char> input)
             {
                 std::cout << "WebWorkerImpl::start()" << std::endl;;
 
@@ -52,11 +52,20 @@ namespace minko
                 if (!_messages.empty())
                 {
                     std::cout << "WebWorkerImpl::poll(): message execute" << std::endl;
-                    _message->execute(_that->shared_from_this(), _messages.front());
+                    auto message = std::move(_messages.front());
+
                     _messages.pop();
+                    _message->execute(_that->shared_from_this(), message);
                 }
             }
 
+            // The end of a web worker is not reported back.
+            bool
+            finished()
+            {
+                return false;
+            }
+
             void
             post(Message message)
             {
@@ -64,7 +73,7 @@ namespace minko
                 emscripten_worker_respond(&*message.data.begin(), message.data.size());
             }
 
-            Signal<Ptr, Message>::Ptr
+            MessageSignal::Ptr
             message()
             {
                 return _message;
@@ -77,7 +86,7 @@ namespace minko
 
             WorkerImpl(Worker* that, const std::string& name) :
                 _that(that),
-                _message(Signal<Ptr, Message>::create())
+                _message(MessageSignal::create())
             {
                 std::string path = "minko-worker-" + name + ".js";
                 _handle = emscripten_create_worker(path.c_str());
@@ -87,7 +96,7 @@ namespace minko
             Worker*                                     _that;
             std::string                                 _messageType;
             std::queue<Message>                         _messages;
-            std::shared_ptr<Signal<Ptr, Message>>       _message;
+            MessageSignal::Ptr                          _message;
             int                                         _handle;
 
             static
@@ -107,7 +116,7 @@ namespace minko
                 {
                     std::cout << "WebWorkerImpl::messageHandler(): reading data" << std::endl;
 
-                    worker->_messages.push(Message { worker->_messageType }.set(std::vector<char>(data, data + size)));
+                    worker->_messages.push(Message(worker->_messageType, std::vector<char>(data, data + size)));
                     worker->_messageType.erase();
                 }
             }
@@ -21,6 +21,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/Common.hpp"
 
+#include <type_traits>
+
 #include "minko/Signal.hpp"
 
 #include "minko/async/WorkerImpl.hpp"
@@ -36,39 +38,111 @@ namespace minko
             typedef std::shared_ptr<Worker>                                            Ptr;
             typedef std::function<void (Worker::Ptr, const std::vector<char>&)>        EntryPoint;
 
+            struct Message;
+
+            typedef Signal<Ptr, const Message&>                                         MessageSignal;
+
+            // Messages are moved from the worker thread to the canvas, never copied: their data can
+            // be a whole file.
             struct Message
             {
                 std::string type;
                 std::vector<char> data;
 
+                Message()
+                {
+                }
+
+                Message(const std::string& type) :
+                    type(type)
+                {
+                }
+
+                // Takes the ownership of data when it is moved in.
+                Message(const std::string& type, std::vector<char> data) :
+                    type(type),
+                    data(std::move(data))
+                {
+                }
+
+                // Stores a trivially copyable value, read back with get<T>().
                 template<typename T>
+                Message(const std::string& type, const T& value) :
+                    type(type)
+                {
+                    static_assert(std::is_trivially_copyable<T>::value, "Message values must be trivially copyable.");
+
+                    set(value);
+                }
+
+                Message(Message&& message) :
+                    type(std::move(message.type)),
+                    data(std::move(message.data))
+                {
+                }
+
                 Message&
-                set(T value)
+                operator=(Message&& message)
                 {
+                    type = std::move(message.type);
+                    data = std::move(message.data);
+
+                    return *this;
+                }
+
+                template<typename T>
+                Message&
+                set(const T& value)
+                {
+                    static_assert(std::is_trivially_copyable<T>::value, "Message values must be trivially copyable.");
+
                     data.resize(sizeof(T));
-                    T* dest = reinterpret_cast<T*>(&*data.begin());
-                    *dest = value;
+                    std::memcpy(data.data(), &value, sizeof(T));
                     return *this;
                 }
 
                 Message&
-                set(const std::vector<char>& value)
+                set(std::vector<char> value)
                 {
-                    data = value;
+                    data = std::move(value);
                     return *this;
                 }
+
+                template<typename T>
+                T
+                get() const
+                {
+                    static_assert(std::is_trivially_copyable<T>::value, "Message values must be trivially copyable.");
+
+                    if (data.size() != sizeof(T))
+                        throw std::logic_error("The message does not hold a value of this type.");
+
+                    T value;
+
+                    std::memcpy(&value, data.data(), sizeof(T));
+
+                    return value;
+                }
+
+            private:
+                Message(const Message&) = delete;
+
+                Message&
+                operator=(const Message&) = delete;
             };
 
         public:
-            // Starts the worker.
+            // Starts the worker. Its code runs on a thread pool shared by all the workers.
             void
-            start(const std::vector<char>& input);
+            start(std::vector<char> input);
 
             // Must be called. Register on this signal to get updates from the worker.
-            Signal<Ptr, Message>::Ptr
+            MessageSignal::Ptr
             message();
 
-            // Can be called from the worker code to send data back to the application.
+            // Can be called from the worker code to send data back to the application. The
+            // messages go through a bounded queue: post() waits while it is full, so it must not
+            // be called from the thread polling the worker.
             void
             post(Message message);
 
@@ -83,6 +157,10 @@ namespace minko
             void
             poll();
 
+            // True once run() has returned and all its messages were polled.
+            bool
+            finished();
+
             ~Worker();
 
         protected:
@@ -0,0 +1,156 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/Signal.hpp"
+#include "minko/component/AbstractComponent.hpp"
+
+namespace minko
+{
+	namespace component
+	{
+		// Clustered forward lighting: every frame, the point and spot lights of the scene are
+		// binned in the clusters of the camera the component is added to, and the light lists
+		// are packed in data textures read by the effects using the CLUSTERED_LIGHTING_MAX_LIGHTS
+		// macro, such as PhongClustered.effect. Those effects do not depend on the number of
+		// lights, so adding or removing lights never compiles new programs. Lights should be
+		// given a range() to be binned in the clusters they reach only: the ones without a range
+		// are added to every cluster, and a warning is logged. The attenuation coefficients are
+		// applied as by Phong.effect, on top of the range.
+		class ClusteredLighting :
+			public AbstractComponent
+		{
+		public:
+			typedef std::shared_ptr<ClusteredLighting>	Ptr;
+
+		private:
+			typedef std::shared_ptr<scene::Node>					NodePtr;
+			typedef std::shared_ptr<render::Texture>				TexturePtr;
+			typedef std::shared_ptr<render::AbstractTexture>		AbsTexPtr;
+			typedef std::shared_ptr<SceneManager>					SceneMngrPtr;
+			typedef Signal<SceneMngrPtr, uint, AbsTexPtr>::Slot		RenderingBeginSlot;
+
+		public:
+			// Texels per light in the lights texture.
+			static const uint LIGHT_SIZE;
+			// Width of the data textures.
+			static const uint TEXTURE_WIDTH;
+
+		private:
+			std::shared_ptr<render::LightClusters>		_clusters;
+			std::shared_ptr<data::Provider>				_data;
+
+			TexturePtr									_clustersTexture;
+			TexturePtr									_indicesTexture;
+			TexturePtr									_lightsTexture;
+
+			// point lights first, then spot lights
+			std::vector<std::shared_ptr<data::Provider>>	_lights;
+			uint										_numPointLights;
+			std::vector<math::vec4>						_spheres;
+			math::vec3									_boundsMin;
+			math::vec3									_boundsSize;
+			float										_intensityScale;
+			float										_rangeScale;
+			float										_attenuationScale;
+			uint										_numUnboundedLights;
+			uint										_numDroppedEntries;
+
+			Signal<NodePtr, NodePtr, NodePtr>::Slot		_addedToSceneSlot;
+			RenderingBeginSlot							_renderingBeginSlot;
+
+		public:
+			inline static
+			Ptr
+			create(uint numClustersX			= 16,
+				   uint numClustersY			= 8,
+				   uint numClustersZ			= 24,
+				   uint maxLightsPerCluster		= 32)
+			{
+				return std::shared_ptr<ClusteredLighting>(new ClusteredLighting(
+					numClustersX, numClustersY, numClustersZ, maxLightsPerCluster
+				));
+			}
+
+			inline
+			std::shared_ptr<render::LightClusters>
+			clusters() const
+			{
+				return _clusters;
+			}
+
+			inline
+			std::shared_ptr<data::Provider>
+			data() const
+			{
+				return _data;
+			}
+
+			// Number of lights binned by the last update.
+			inline
+			uint
+			numLights() const
+			{
+				return _spheres.size();
+			}
+
+			// Number of lights without a range() found by the last update.
+			inline
+			uint
+			numUnboundedLights() const
+			{
+				return _numUnboundedLights;
+			}
+
+		protected:
+			void
+			targetAdded(NodePtr target);
+
+			void
+			targetRemoved(NodePtr target);
+
+		private:
+			ClusteredLighting(uint numClustersX, uint numClustersY, uint numClustersZ, uint maxLightsPerCluster);
+
+			void
+			targetAddedToSceneHandler(NodePtr node, NodePtr target, NodePtr ancestor);
+
+			void
+			update();
+
+			void
+			collectLights();
+
+			void
+			uploadLights(SceneMngrPtr sceneManager);
+
+			void
+			uploadClusters(SceneMngrPtr sceneManager);
+
+			TexturePtr
+			reserveTexture(SceneMngrPtr			sceneManager,
+						   TexturePtr&			texture,
+						   uint					numTexels,
+						   const std::string&	propertyName);
+		};
+	}
+}
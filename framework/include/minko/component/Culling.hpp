@@ -42,15 +42,32 @@ namespace minko
 			typedef std::shared_ptr<render::AbstractTexture>			AbsTexPtr;
 			typedef std::shared_ptr<SceneManager>						SceneMngrPtr;
 			typedef Signal<SceneMngrPtr, uint, AbsTexPtr>::Slot			RenderingBeginSlot;
+			typedef std::shared_ptr<math::BoundingVolumeHierarchy>		BvhPtr;
+			typedef std::shared_ptr<BoundingBox>						BoundingBoxPtr;
 
 		private:
-			std::shared_ptr<math::OctTree>			        _octTree;
-            float                                           _worldSize;
-            unsigned int                                    _maxDepth;
+			BvhPtr											_bvh;
 			scene::Layout									_layout;
 
+			// culled nodes, indexed by their item id in the hierarchy
+			std::vector<NodePtr>							_nodes;
+			std::vector<BoundingBoxPtr>						_boundingBoxes;
+			std::vector<math::vec3>							_minBounds;
+			std::vector<math::vec3>							_maxBounds;
+			std::vector<PropertyChangedSignal::Slot>		_modelToWorldChangedSlots;
+			std::unordered_map<NodePtr, uint>				_nodeToItemId;
+
+			std::vector<uint>								_movedItems;
+			bool											_invalidHierarchy;
+
+			// one bit per item: visibility applied to the layouts, visibility of the current frame,
+			// and items whose layout has not been set yet
+			std::vector<uint32_t>							_visibleItems;
+			std::vector<uint32_t>							_newVisibleItems;
+			std::vector<uint32_t>							_invalidVisibility;
+
 			std::string										_bindProperty;
-			std::shared_ptr<math::AbstractShape>			_frustum;
+			std::shared_ptr<math::Frustum>					_frustum;
 
 			Signal<AbstractComponent::Ptr, NodePtr>::Slot	_targetAddedSlot;
             Signal<AbstractComponent::Ptr, NodePtr>::Slot	_targetRemovedSlot;
@@ -73,43 +90,19 @@ namespace minko
 			}
 
             inline
-            float
-            worldSize() const
+            BvhPtr
+            bvh() const
             {
-                return _worldSize;
+                return _bvh;
             }
 
             inline
-            Ptr
-            worldSize(float value)
+            uint
+            numCulledNodes() const
             {
-                _worldSize = value;
-
-                return std::static_pointer_cast<Culling>(shared_from_this());
-            }
-
-            inline
-            unsigned int
-            maxDepth() const
-            {
-                return _maxDepth;
-            }
-
-            inline
-            Ptr
-            maxDepth(unsigned int value)
-            {
-                _maxDepth = value;
-
-                return std::static_pointer_cast<Culling>(shared_from_this());
+                return _nodes.size();
             }
 
-            std::shared_ptr<minko::math::OctTree>
-            octTree() const
-			{
-                return _octTree;
-			}
-
         protected:
 			void
             targetAdded(NodePtr target);
@@ -131,6 +124,21 @@ namespace minko
 
 			void
 			targetAddedToSceneHandler(NodePtr node, NodePtr target, NodePtr ancestor);
+
+			bool
+			isCulled(NodePtr node) const;
+
+			void
+			addNode(NodePtr node);
+
+			void
+			removeNode(NodePtr node);
+
+			void
+			updateBounds(uint itemId);
+
+			void
+			updateVisibility();
 		};
 	}
 }
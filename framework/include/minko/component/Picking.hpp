@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Common.hpp"
 #include "minko/Signal.hpp"
 #include "minko/component/AbstractComponent.hpp"
+#include "minko/component/PickingMode.hpp"
 #include "minko/data/Provider.hpp"
 
 namespace minko
@@ -45,8 +46,10 @@ namespace minko
 			typedef std::shared_ptr<Surface>					SurfacePtr;
 			typedef std::shared_ptr<data::Provider>	            ProviderPtr;
 			typedef std::shared_ptr<AbstractCanvas>				AbstractCanvasPtr;
+			typedef std::shared_ptr<math::BoundingVolumeHierarchy>	BVHPtr;
 
 		private:
+			PickingMode									_mode;
 			TexturePtr							        _renderTarget;
 			RendererPtr							        _renderer;
 			SceneManagerPtr						        _sceneManager;
@@ -67,6 +70,16 @@ namespace minko
 
 			std::vector<NodePtr>						_descendants;
 
+			BVHPtr										_sceneHierarchy;
+			std::vector<SurfacePtr>						_rayCastSurfaces;
+			std::vector<math::vec3>						_rayCastMinBounds;
+			std::vector<math::vec3>						_rayCastMaxBounds;
+			bool										_sceneHierarchyInvalid;
+			bool										_rayCastValid;
+			int											_rayCastX;
+			int											_rayCastY;
+			SurfacePtr									_rayCastSurface;
+
 			Signal<AbsCtrlPtr, NodePtr>::Slot			_targetAddedSlot;
 			Signal<AbsCtrlPtr, NodePtr>::Slot			_targetRemovedSlot;
 			Signal<NodePtr, NodePtr, NodePtr>::Slot		_addedSlot;
@@ -147,15 +160,27 @@ namespace minko
 		public:
 			inline static
 			Ptr
-            create(NodePtr camera, bool addPickingLayoutToNodes = true, bool emulateMouseWithTouch = true, EffectPtr pickingEffect = nullptr, EffectPtr pickingDepthEffect = nullptr)
+            create(NodePtr      camera,
+                   bool         addPickingLayoutToNodes = true,
+                   bool         emulateMouseWithTouch = true,
+                   EffectPtr    pickingEffect = nullptr,
+                   EffectPtr    pickingDepthEffect = nullptr,
+                   PickingMode  mode = PickingMode::RENDER)
 			{
                 Ptr picking = std::shared_ptr<Picking>(new Picking());
 
-                picking->initialize(camera, addPickingLayoutToNodes, emulateMouseWithTouch, pickingEffect, pickingDepthEffect);
+                picking->initialize(camera, addPickingLayoutToNodes, emulateMouseWithTouch, pickingEffect, pickingDepthEffect, mode);
 
 				return picking;
 			}
 
+            inline
+            PickingMode
+            mode() const
+            {
+                return _mode;
+            }
+
 			inline
 			Signal<NodePtr>::Ptr
 			mouseOver()
@@ -323,7 +348,11 @@ namespace minko
                        bool         addPickingLayout, 
                        bool         emulateMouseWithTouch, 
                        EffectPtr    pickingEffect = nullptr, 
-                       EffectPtr    pickingDepthEffect = nullptr);
+                       EffectPtr    pickingDepthEffect = nullptr,
+                       PickingMode  mode = PickingMode::RENDER);
+
+			void
+            createRenderers();
 
 			void
             bindSignals();
@@ -431,6 +460,12 @@ namespace minko
 
             void
             updatePickingOrigin();
+
+            void
+            rayCast();
+
+            void
+            updateSceneHierarchy();
 		};
 	}
 }
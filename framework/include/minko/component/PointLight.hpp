@@ -72,6 +72,14 @@ namespace minko
 			Ptr
 			attenuationCoefficients(const math::vec3& coef);
 
+			// Distance beyond which the light is ignored by the clustered lighting, where it fades
+			// out smoothly. A range <= 0, the default, makes the light unbounded.
+			float
+			range() const;
+
+			Ptr
+			range(float value);
+
             inline
             math::vec3
             position() const
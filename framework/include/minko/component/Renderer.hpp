@@ -114,6 +114,13 @@ namespace minko
 
 			uint																	_numDrawCalls;
 			uint																	_numTriangles;
+			bool																	_minimizeStateChanges;
+			uint																	_numStateChanges;
+			uint																	_numSkippedStateChanges;
+			bool																	_instancing;
+			ProviderPtr																_instancingData;
+			std::shared_ptr<render::VertexBuffer>									_instanceBuffer;
+			std::vector<float>														_instanceData;
 
 		public:
 			inline static
@@ -185,6 +192,50 @@ namespace minko
 				return _numTriangles;
 			}
 
+			// Number of program, uniform, texture, vertex attribute and state changes sent to the
+			// context during the last frame.
+			inline
+			unsigned int
+			numStateChanges()
+			{
+				return _numStateChanges;
+			}
+
+			// Number of state changes that were not sent to the context during the last frame because
+			// they were identical to the ones of the previously submitted draw call.
+			inline
+			unsigned int
+			numSkippedStateChanges()
+			{
+				return _numSkippedStateChanges;
+			}
+
+			inline
+			bool
+			minimizeStateChanges()
+			{
+				return _minimizeStateChanges;
+			}
+
+			inline
+			void
+			minimizeStateChanges(bool value)
+			{
+				_minimizeStateChanges = value;
+			}
+
+			inline
+			bool
+			instancing()
+			{
+				return _instancing;
+			}
+
+			// Surfaces sharing the same geometry and material are rendered with a single instanced
+			// draw call when the context supports it.
+			void
+			instancing(bool value);
+
 			inline
 			unsigned int
 			backgroundColor()
@@ -404,6 +455,12 @@ namespace minko
 			void
 			initializePostProcessingGeometry();
 
+			void
+			initializeInstancing();
+
+			void
+			disposeInstancing();
+
 			void
 			addedHandler(NodePtr node, NodePtr target, NodePtr parent);
 
@@ -24,15 +24,11 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include <minko/component/AbstractAnimation.hpp>
 #include <minko/render/VertexBuffer.hpp>
 #include <minko/component/SkinningMethod.hpp>
+#include <minko/component/SkinningPalette.hpp>
+#include <minko/geometry/Skin.hpp>
 
 namespace minko
 {
-	namespace geometry
-	{
-		class Skin;
-		class Bone;
-	};
-
 	namespace component
 	{
 		class Skinning:
@@ -61,6 +57,7 @@ namespace minko
 		public:
 			static const std::string								PNAME_NUM_BONES;
 			static const std::string								PNAME_BONE_MATRICES;
+			static const std::string								PNAME_SKINNING_PALETTE;
 			static const std::string								ATTRNAME_BONE_IDS_A;
 			static const std::string								ATTRNAME_BONE_IDS_B;
 			static const std::string								ATTRNAME_BONE_WEIGHTS_A;
@@ -75,6 +72,7 @@ namespace minko
 			SkinPtr													_skin;
 			AbstractContextPtr										_context;
 			SkinningMethod											_method;
+			SkinningPalette											_palette;
 
 			NodePtr													_skeletonRoot;
 			bool													_moveTargetBelowRoot;
@@ -84,6 +82,14 @@ namespace minko
 			std::unordered_map<NodePtr, GeometryPtr>				_targetGeometry;
 			std::unordered_map<NodePtr,	std::vector<float>>			_targetInputPositions;	// only for software skinning
 			std::unordered_map<NodePtr,	std::vector<float>>			_targetInputNormals;	// only for software skinning
+			std::unordered_map<NodePtr, int>						_targetFrameIds;
+
+			// software skinning: palette of the last skinned frame and range of the vertices that
+			// are actually influenced by a bone
+			geometry::Skin::BonePalette								_bonePalette;
+			int														_bonePaletteFrameId;
+			uint													_firstSkinnedVertexId;
+			uint													_lastSkinnedVertexId;
 
 			TargetAddedOrRemovedSignal::Slot						_targetAddedSlot;
 
@@ -95,9 +101,10 @@ namespace minko
 				   AbstractContextPtr					context, 
 				   NodePtr								skeletonRoot,
 				   bool									moveTargetBelowRoot = false,
-				   bool									isLooping = true)
+				   bool									isLooping = true,
+				   SkinningPalette						palette = SkinningPalette::MATRIX_4X4)
 			{
-				Ptr ptr(new Skinning(skin, method, context, skeletonRoot, moveTargetBelowRoot, isLooping));
+				Ptr ptr(new Skinning(skin, method, context, skeletonRoot, moveTargetBelowRoot, isLooping, palette));
 
 				ptr->initialize();
 
@@ -114,6 +121,15 @@ namespace minko
                 return _skin;
             }
 
+            // Bone palette layout used by hardware skinning, exposed to the effects through the
+            // `skinningPalette` geometry property (SKINNING_PALETTE macro).
+            inline
+            SkinningPalette
+            palette() const
+            {
+                return _palette;
+            }
+
         protected:
             void
             initialize();
@@ -127,7 +143,8 @@ namespace minko
 					 AbstractContextPtr, 
 					 NodePtr,
 					 bool,
-					 bool);
+					 bool,
+					 SkinningPalette);
 
 			Skinning(const Skinning&     skinning,
 	                 const CloneOption&  option);
@@ -145,14 +162,13 @@ namespace minko
 			updateFrame(uint frameId, NodePtr);
 
 			void
-			performSoftwareSkinning(NodePtr, const std::vector<math::mat4>&);
+			performSoftwareSkinning(NodePtr, uint frameId);
+
+			void
+			initializeBonePalette(GeometryPtr);
 
 			void
-			performSoftwareSkinning(const render::VertexAttribute&, 
-									render::VertexBuffer::Ptr, 
-									const std::vector<float>&, 
-                                    const std::vector<math::mat4>&,
-									bool doDeltaTransform);
+			updateBonePalette(GeometryPtr, uint frameId);
 
 			render::VertexBuffer::Ptr
 			createVertexBufferForBones() const;
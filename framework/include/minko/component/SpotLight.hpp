@@ -82,6 +82,14 @@ namespace minko
 			SpotLight&
 			attenuationCoefficients(const math::vec3&);
 
+			// Distance beyond which the light is ignored by the clustered lighting, where it fades
+			// out smoothly. A range <= 0, the default, makes the light unbounded.
+			float
+			range() const;
+
+			SpotLight&
+			range(float value);
+
             inline
             math::vec3
             position() const
@@ -26,6 +26,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/Renderer.hpp"
 #include "minko/Any.hpp"
 #include "minko/data/Provider.hpp"
+#include "minko/math/Simd.hpp"
 
 namespace minko
 {
@@ -50,7 +51,7 @@ namespace minko
 			Signal<NodePtr, NodePtr, NodePtr>::Slot 		_addedSlot;
 			Signal<NodePtr, NodePtr, NodePtr>::Slot 		_removedSlot;
 
-            bool                                            _dirty;
+            int                                             _id;
 
 		public:
 			inline static
@@ -96,8 +97,8 @@ namespace minko
                 {
                     auto rootTransform = target()->root()->component<RootTransform>();
 
-                    if (rootTransform && !rootTransform->_invalidLists)
-                        rootTransform->_nodeTransformCache.at(rootTransform->_nodeToId[target()])._dirty = true;
+                    if (rootTransform && rootTransform->contains(*this))
+                        rootTransform->invalidateMatrix(_id);
                 }
 			}
 
@@ -160,24 +161,22 @@ namespace minko
 				typedef Signal<SceneMgrPtr, uint, AbsTexturePtr> 	RenderingBeginSignal;
 				typedef RenderingBeginSignal::Slot 					RenderingBeginSlot;
                 typedef std::shared_ptr<data::Provider>             ProviderPtr;
+                typedef std::vector<math::mat4, math::AlignedAllocator<math::mat4>> MatrixArray;
+                typedef Signal<data::Store&, ProviderPtr, const data::Provider::PropertyName&>::Slot PropertyChangedSlot;
 
-                struct NodeTransformCacheEntry
+                // A depth-first sequence of new nodes spliced right after the subtree of anchorId,
+                // or appended at the end when anchorId is -1.
+                struct Insertion
                 {
-                    NodePtr             _node;
-				    const math::mat4*   _matrix;
-				    math::mat4*		    _modelToWorldMatrix;
-
-                    int                 _parentId;
-                    int                 _firstChildId;
-                    int                 _numChildren;
-
-                    bool                _dirty;
-
-                    ProviderPtr         _provider;
-
-                    NodeTransformCacheEntry();
+                    int     anchorId;
+                    uint    afterId;
+                    uint    first;
+                    uint    count;
                 };
 
+            public:
+                typedef Signal<Ptr, uint, uint>                     MatricesChangedSignal;
+
 			public:
 				inline static
 				Ptr
@@ -192,31 +191,66 @@ namespace minko
 				void
 				forceUpdate(NodePtr node, bool updateTransformLists = false);
 
+                // Executed once per update with the [firstId, lastId) range of the nodes whose
+                // model to world matrix changed.
+                inline
+                MatricesChangedSignal::Ptr
+                matricesChanged() const
+                {
+                    return _matricesChanged;
+                }
+
+                inline
+                uint
+                numNodes() const
+                {
+                    return _nodes.size();
+                }
+
+                inline
+                NodePtr
+                node(uint nodeId) const
+                {
+                    return _nodes[nodeId];
+                }
+
+                inline
+                const math::mat4&
+                modelToWorldMatrix(uint nodeId) const
+                {
+                    return _worldMatrices[nodeId];
+                }
+
                 ~RootTransform()
                 {
-                    _nodeTransformCache.clear();
-                    _nodeToId.clear();
+                    _nodes.clear();
+                    _transforms.clear();
+                    _matrixChangedSlots.clear();
                     _targetSlots.clear();
                     _renderingBeginSlot = nullptr;
                 }
 
 			private:
-                std::vector<NodeTransformCacheEntry>            _nodeTransformCache;
+                // Nodes are stored depth-first: a node always comes before its descendants, which
+                // all follow it in a contiguous range of _numDescendants[nodeId] entries.
+                std::vector<NodePtr>                            _nodes;
+                std::vector<Transform*>                         _transforms;
+                std::vector<int>                                _parentIds;
+                std::vector<uint>                               _numDescendants;
+                MatrixArray                                     _localMatrices;
+                MatrixArray                                     _worldMatrices;
+                std::vector<uint32_t>                           _dirtyBits;
+                std::vector<PropertyChangedSlot>                _matrixChangedSlots;
 
-                std::unordered_map<NodePtr, unsigned int>	    _nodeToId;
-                std::list<NodePtr>                              _nodes;
 				bool							                _invalidLists;
 
+                MatricesChangedSignal::Ptr                      _matricesChanged;
+
 				std::list<Any>					                _targetSlots;
                 Signal<SceneMgrPtr, uint, AbsTexPtr>::Slot      _renderingBeginSlot;
 
                 std::list<NodePtr>                              _toAdd;
-                std::list<NodePtr>                              _toRemove;
-
-                std::unordered_map<
-                    NodePtr,
-                    Signal<data::Store&, ProviderPtr, const data::Provider::PropertyName&>::Slot
-                >                                               _nodeToPropertyChangedSlot;
+                std::vector<uint>                               _toRemove;
 
             protected:
             	void
@@ -226,6 +260,8 @@ namespace minko
 				targetRemoved(NodePtr target);
 
 			private:
+				RootTransform();
+
 				void
 				componentRemovedHandler(NodePtr node, NodePtr target, AbsCtrlPtr ctrl);
 
@@ -241,20 +277,45 @@ namespace minko
 				void
 				updateTransformsList();
 
+				void
+				rebuildTransformsList();
+
+                inline
+                bool
+                contains(const Transform& transform) const
+                {
+                    return transform._id >= 0
+                        && transform._id < static_cast<int>(_transforms.size())
+                        && _transforms[transform._id] == &transform;
+                }
+
+				void
+				removeTransform(const Transform& transform);
+
 				void
 				updateTransforms();
 
 				void
-				updateTransformPath(const std::vector<unsigned int>& path);
+				invalidateMatrix(uint nodeId);
+
+                inline
+                void
+                setDirty(uint nodeId)
+                {
+                    _dirtyBits[nodeId >> 5] |= 1u << (nodeId & 31);
+                }
+
+                inline
+                bool
+                isDirty(uint nodeId) const
+                {
+                    return (_dirtyBits[nodeId >> 5] & (1u << (nodeId & 31))) != 0;
+                }
 
 				void
                 renderingBeginHandler(std::shared_ptr<SceneManager>             sceneManager,
                                       uint                                      frameId,
                                       std::shared_ptr<render::AbstractTexture>  abstractTexture);
-
-
-				void
-				sortNodes();
 			};
 		};
 	}
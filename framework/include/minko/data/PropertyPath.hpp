@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/Flyweight.hpp"
+
+namespace minko
+{
+	namespace data
+	{
+		// A property name parsed once and for all. A name can either target a provider directly
+		// ("diffuseColor") or an item of a collection by index or by uuid ("material[0].diffuseColor",
+		// "material[${materialUuid}].diffuseColor"), and may contain ${var} or $var placeholders.
+		// Parsing is not free: Store keeps the paths of the collection items it resolves.
+		class PropertyPath
+		{
+		public:
+			typedef Flyweight<std::string>						FString;
+			typedef std::list<std::pair<FString, FString>>		FStringList;
+
+		private:
+			struct Segment
+			{
+				std::string	text;
+				bool		isVariable;
+				FString		variable;
+			};
+
+		private:
+			FString					_name;
+			bool					_isCollectionItem;
+			FString					_collectionName;
+			bool					_isUuid;
+			uint					_index;
+			std::string				_uuid;
+			FString					_token;
+			std::vector<Segment>	_segments;
+
+		public:
+			PropertyPath(const FString& name);
+
+			inline
+			const FString&
+			name() const
+			{
+				return _name;
+			}
+
+			inline
+			bool
+			isCollectionItem() const
+			{
+				return _isCollectionItem;
+			}
+
+			inline
+			const FString&
+			collectionName() const
+			{
+				return _collectionName;
+			}
+
+			inline
+			bool
+			isUuid() const
+			{
+				return _isUuid;
+			}
+
+			inline
+			uint
+			index() const
+			{
+				return _index;
+			}
+
+			inline
+			const std::string&
+			uuid() const
+			{
+				return _uuid;
+			}
+
+			// The name of the property in the targeted provider.
+			inline
+			const FString&
+			token() const
+			{
+				return _token;
+			}
+
+			inline
+			bool
+			hasVariables() const
+			{
+				return !_segments.empty();
+			}
+
+			// Replaces the placeholders with their value in variables. Placeholders without a
+			// matching variable are left untouched.
+			std::string
+			resolve(const FStringList& variables) const;
+
+		private:
+			void
+			parseVariables(const std::string& name);
+		};
+	}
+}
@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Common.hpp"
 #include "minko/Flyweight.hpp"
 #include "minko/data/Provider.hpp"
+#include "minko/data/PropertyPath.hpp"
 
 #include "sparsehash/forward.h"
 
@@ -62,6 +63,12 @@ namespace minko
             typedef map<PropertyName, PropertyChangedSignal*> 			ChangedSignalMap;
             typedef map<ProviderPtr, ProviderChangedSignalSlotList> 	ProviderToChangedSlotListMap;
             typedef map<CollectionPtr, CollectionChangedSignalSlot> 	CollectionToChangedSlotMap;
+            typedef std::unordered_map<FString, CollectionPtr>         NameToCollectionMap;
+            typedef std::unordered_map<std::string, ProviderPtr>        UuidToProviderMap;
+            typedef std::unordered_map<const Collection*, UuidToProviderMap> CollectionToItemsMap;
+            typedef std::unordered_map<const std::string*, PropertyPath> PathCache;
+
+            static const uint               MIN_NUM_CACHED_PATHS;
 
         private:
 			std::list<ProviderPtr>			_providers;
@@ -79,6 +86,13 @@ namespace minko
             CollectionToChangedSlotMap*     _collectionItemAddedSlots;
             CollectionToChangedSlotMap*     _collectionItemRemovedSlots;
 
+            // Lookup indices for the collection paths: "collection[uuid].token" and
+            // "collection[index].token" resolve with hash lookups only.
+            NameToCollectionMap             _collectionByName;
+            CollectionToItemsMap            _collectionItemByUuid;
+            // Parsed "collection[...].token" names, keyed by their flyweight.
+            mutable PathCache               _collectionItemPaths;
+
 		public:
             Store();
 
@@ -96,7 +110,7 @@ namespace minko
 			bool
 			propertyHasType(const PropertyName& propertyName) const
 			{
-                auto providerAndToken = getProviderByPropertyName(*propertyName);
+                auto providerAndToken = getProviderByPropertyName(propertyName);
                 auto provider = std::get<0>(providerAndToken);
 
                 if (provider == nullptr)
@@ -109,7 +123,7 @@ namespace minko
 			const T&
 			get(const PropertyName& propertyName) const
 			{
-                auto providerAndToken = getProviderByPropertyName(*propertyName);
+                auto providerAndToken = getProviderByPropertyName(propertyName);
                 auto provider = std::get<0>(providerAndToken);
 
                 if (provider == nullptr)
@@ -122,7 +136,7 @@ namespace minko
             const T*
             getPointer(const PropertyName& propertyName) const
             {
-                auto providerAndToken = getProviderByPropertyName(*propertyName);
+                auto providerAndToken = getProviderByPropertyName(propertyName);
                 auto provider = std::get<0>(providerAndToken);
 
                 if (provider == nullptr)
@@ -135,7 +149,7 @@ namespace minko
             T*
             getUnsafePointer(const PropertyName& propertyName) const
             {
-                auto providerAndToken = getProviderByPropertyName(*propertyName);
+                auto providerAndToken = getProviderByPropertyName(propertyName);
                 auto provider = std::get<0>(providerAndToken);
 
                 if (provider == nullptr)
@@ -151,7 +165,7 @@ namespace minko
 			void
 			set(const PropertyName& propertyName, T value)
 			{
-                auto providerAndToken = getProviderByPropertyName(*propertyName);
+                auto providerAndToken = getProviderByPropertyName(propertyName);
                 auto provider = std::get<0>(providerAndToken);
 
                 if (provider == nullptr)
@@ -252,7 +266,7 @@ namespace minko
 			bool
             hasProperty(const PropertyName& propertyName) const
             {
-                return std::get<0>(getProviderByPropertyName(*propertyName)) != nullptr;
+                return std::get<0>(getProviderByPropertyName(propertyName)) != nullptr;
             }
 
             bool
@@ -269,8 +283,17 @@ namespace minko
             getActualPropertyName(const FStringList& variables, const FString& propertyName);
 
 		private:
-			std::pair<ProviderPtr, std::string>
-            getProviderByPropertyName(const std::string& propertyName) const;
+			std::pair<ProviderPtr, PropertyName>
+            getProviderByPropertyName(const PropertyName& propertyName) const;
+
+            const PropertyPath&
+            collectionItemPath(const PropertyName& propertyName) const;
+
+            void
+            indexCollection(CollectionPtr collection);
+
+            void
+            unindexCollection(CollectionPtr collection);
 
 			void
 			providerPropertyAddedHandler(ProviderPtr        provider,
@@ -0,0 +1,114 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/Flyweight.hpp"
+
+namespace minko
+{
+    namespace file
+    {
+        // In-process cache of the effects flattened in the binary effect format, keyed by their
+        // resolved path and include paths. An entry is used only when the hash of the effect file
+        // and the hashes of all the GLSL files it expanded still match: the effects loaded again
+        // are still fetched with their includes, but they are neither parsed nor expanded again.
+        class EffectCache
+        {
+        public:
+            typedef std::shared_ptr<EffectCache>        Ptr;
+            typedef std::uint64_t                       HashType;
+            typedef std::list<Flyweight<std::string>>   IncludePaths;
+
+            // A GLSL file expanded by an effect, as it was requested and as it was loaded.
+            struct Include
+            {
+                std::string     filename;
+                IncludePaths    includePaths;
+                HashType        contentHash;
+            };
+
+            typedef std::vector<Include>                Includes;
+
+            struct BinaryEffect
+            {
+                HashType                    contentHash;
+                Includes                    includes;
+                std::vector<unsigned char>  data;
+            };
+
+        private:
+            static Ptr                                              _default;
+
+            std::unordered_map<std::string, BinaryEffect>           _binaryEffects;
+
+        public:
+            inline static
+            Ptr
+            create()
+            {
+                return std::shared_ptr<EffectCache>(new EffectCache());
+            }
+
+            // Cache used by all the effect parsers, nullptr to always parse the effects.
+            inline static
+            Ptr
+            defaultCache()
+            {
+                return _default;
+            }
+
+            inline static
+            void
+            defaultCache(Ptr cache)
+            {
+                _default = cache;
+            }
+
+            inline
+            uint
+            numBinaryEffects() const
+            {
+                return _binaryEffects.size();
+            }
+
+            // Returns nullptr when there is no effect for key or when its content changed. The
+            // hashes of its includes are checked by the caller, who has to load them.
+            const BinaryEffect*
+            binaryEffect(const std::string& key, HashType contentHash) const;
+
+            void
+            binaryEffect(const std::string&                 key,
+                         HashType                           contentHash,
+                         const Includes&                    includes,
+                         const std::vector<unsigned char>&  data);
+
+            void
+            clear();
+
+        private:
+            EffectCache()
+            {
+            }
+        };
+    }
+}
@@ -23,6 +23,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/Signal.hpp"
 #include "minko/file/AbstractParser.hpp"
+#include "minko/file/EffectCache.hpp"
 #include "minko/file/FileProtocol.hpp"
 #include "minko/render/Blending.hpp"
 #include "minko/render/Shader.hpp"
@@ -186,6 +187,17 @@ namespace minko
             unsigned int					_numLoadedDependencies;
             std::shared_ptr<data::Provider> _effectData;
 
+            std::shared_ptr<Json::Value>                    _root;
+            std::unordered_map<ShaderPtr, std::string>      _shaderSources;
+            bool                                            _isBinaryEffect;
+            std::string                                     _cacheKey;
+            std::uint64_t                                   _contentHash;
+            EffectCache::Includes                           _includes;
+            std::vector<unsigned char>                      _source;
+            std::vector<unsigned char>                      _cachedBinaryEffect;
+            unsigned int                                    _numIncludesToValidate;
+            bool                                            _includesChanged;
+
             LoaderCompleteSlotMap           _loaderCompleteSlots;
             LoaderErrorSlotMap              _loaderErrorSlots;
 
@@ -218,12 +230,35 @@ namespace minko
                   const std::vector<unsigned char>&	data,
                   std::shared_ptr<AssetLibrary>		assetLibrary);
 
+            // The effect in the binary format, valid once the parser completed. The GLSL files
+            // included by its shaders are expanded, and its strings are stored once: it loads
+            // without fetching any other file but its textures and the effects it extends. The
+            // passes skipped because of their configuration keep their includes.
+            std::vector<unsigned char>
+            binaryEffect() const;
+
+            static
+            bool
+            isBinaryEffect(const std::vector<unsigned char>& data);
+
         private:
             EffectParser();
 
             float
             getPriorityValue(const std::string& name);
 
+            void
+            parseEffect(const std::vector<unsigned char>& data, const std::vector<unsigned char>* cachedBinaryEffect);
+
+            void
+            validateIncludes(const std::vector<unsigned char>& data, const EffectCache::BinaryEffect& cachedBinaryEffect);
+
+            void
+            includeValidationCompleteHandler(LoaderPtr loader, const EffectCache::Include& include);
+
+            void
+            includeValidated(bool unchanged);
+
             void
             parseGlobalScope(const Json::Value& node, Scope& scope);
 
@@ -444,8 +479,16 @@ namespace minko
                                        GLSLBlockList::iterator 	blockIt,
                                        const std::string&       filename);
 
+            void
+            parseInclude(GLSLBlockListPtr           blocks,
+                         GLSLBlockList::iterator    blockIt,
+                         const std::string&         filename,
+                         const std::string&         resolvedFilename,
+                         const std::string&         source,
+                         OptionsPtr                 options);
+
             std::string
-            concatenateGLSLBlocks(GLSLBlockListPtr blocks);
+            concatenateGLSLBlocks(GLSLBlockListPtr blocks) const;
 
             void
             loadTexture(const std::string&  textureFilename,
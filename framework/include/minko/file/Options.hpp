@@ -22,6 +22,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/Common.hpp"
 #include "minko/Flyweight.hpp"
 #include "minko/component/SkinningMethod.hpp"
+#include "minko/component/SkinningPalette.hpp"
 #include "minko/file/EffectParser.hpp"
 #include "minko/render/TextureFormat.hpp"
 #include "minko/Hash.hpp"
@@ -100,6 +101,8 @@ namespace minko
             bool                                                        _trackAssetDescriptor;
 			unsigned int								                _skinningFramerate;
 			component::SkinningMethod					                _skinningMethod;
+            component::SkinningPalette                                  _skinningPalette;
+            bool                                                        _compressSkinningAnimations;
 			std::shared_ptr<render::Effect>                             _effect;
 			MaterialPtr									                _material;
             std::list<render::TextureFormat>                            _textureFormats;
@@ -504,6 +507,41 @@ namespace minko
 				return shared_from_this();
 			}
 
+			inline
+			component::SkinningPalette
+			skinningPalette() const
+			{
+				return _skinningPalette;
+			}
+
+			inline
+			Ptr
+			skinningPalette(component::SkinningPalette value)
+			{
+				_skinningPalette = value;
+
+				return shared_from_this();
+			}
+
+            // Stores the sampled bone matrices of the skins as animation clips (see
+            // geometry::Skin::compress()), about 3 times smaller. Disabled by default since the
+            // compression assumes bone matrices without shear.
+            inline
+            bool
+            compressSkinningAnimations() const
+            {
+                return _compressSkinningAnimations;
+            }
+
+            inline
+            Ptr
+            compressSkinningAnimations(bool value)
+            {
+                _compressSkinningAnimations = value;
+
+                return shared_from_this();
+            }
+
 			inline
 			std::shared_ptr<render::Effect>
 			effect() const
@@ -49,6 +49,9 @@ namespace minko
 
 			std::unordered_map<VBPtr, Signal<VBPtr, int>::Slot>	_vbToVertexSizeChangedSlot;
 
+			std::shared_ptr<math::BoundingVolumeHierarchy>			_triangleHierarchy;
+			bool													_triangleHierarchyInvalid;
+
 		public:
 			virtual
 			~Geometry()
@@ -131,6 +134,7 @@ namespace minko
 			indices(std::shared_ptr<render::IndexBuffer> indices)
 			{
 				_indexBuffer = indices;
+				_triangleHierarchyInvalid = true;
 
                 if (indices->isReady())
                 {
@@ -188,9 +192,44 @@ namespace minko
 									 std::vector<std::vector<float>>&	vertices,
 									 uint								numVertices);
 
+			// Merges the vertices whose attributes have the same bits, or fall in the same cell of
+			// a grid of size epsilon when epsilon > 0, and remaps the indices. The first occurrence
+			// of each vertex is kept, in the original order.
+			Ptr
+			weldVertices(float epsilon = 0.f);
+
+			// Welds numVertices vertices split in several streams and returns the new number of
+			// vertices. The streams are resized accordingly.
+			static
+			uint
+			weldVertices(std::vector<unsigned short>&		indices,
+						 std::vector<std::vector<float>>&	vertices,
+						 uint								numVertices,
+						 float								epsilon = 0.f);
+
+			static
+			uint
+			weldVertices(std::vector<unsigned int>&			indices,
+						 std::vector<std::vector<float>>&	vertices,
+						 uint								numVertices,
+						 float								epsilon = 0.f);
+
             const render::VertexAttribute&
             getVertexAttribute(const std::string& attributeName) const;
 
+			// Hierarchy of the bounding boxes of the triangles, item i being the triangle starting
+			// at the index 3 * i. It is built on first use and kept until it is invalidated.
+			std::shared_ptr<math::BoundingVolumeHierarchy>
+			triangleHierarchy();
+
+			// Must be called when the positions or the indices are modified in place.
+			inline
+			void
+			invalidateTriangleHierarchy()
+			{
+				_triangleHierarchyInvalid = true;
+			}
+
 			bool
 			cast(std::shared_ptr<math::Ray>		ray,
 				 float&							distance,
@@ -199,6 +238,17 @@ namespace minko
 				 math::vec2*					hitUv 		= nullptr,
 				 math::vec3*					hitNormal 	= nullptr);
 
+			// Casts up to 4 rays at once, as cast() does for each of them. The distances are the
+			// maximum distances on input and the distances of the hits on output. Returns the mask
+			// of the rays that hit a triangle. It can be called from several threads as long as
+			// the triangle hierarchy is up to date.
+			uint
+			castRayPacket(const math::vec3*	origins,
+						  const math::vec3*	directions,
+						  uint				numRays,
+						  float*			distances,
+						  uint*				triangles);
+
 			virtual
 			void
 			upload();
@@ -236,6 +286,30 @@ namespace minko
 
 			void
 			getHitNormal(uint triangle, math::vec3* hitNormal);
+
+			template <typename T>
+			static
+			uint
+			weldVertices(std::vector<T>&							indices,
+						 const std::vector<std::vector<float>*>&	vertices,
+						 uint										numVertices,
+						 float										epsilon);
+
+			// The bits of the value, or its cell on the welding grid when invEpsilon is not 0.
+			static inline
+			uint64_t
+			weldingKey(float value, float invEpsilon)
+			{
+				if (invEpsilon != 0.f)
+					return static_cast<uint64_t>(static_cast<int64_t>(std::floor(value * invEpsilon + .5f)));
+
+				uint32_t bits;
+
+				value = value == 0.f ? 0.f : value; // -0 and +0 are welded
+				std::memcpy(&bits, &value, sizeof(float));
+
+				return bits;
+			}
 		};
 	}
 }
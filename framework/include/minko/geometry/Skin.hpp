@@ -21,6 +21,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/Common.hpp"
 
+#include "minko/math/Simd.hpp"
+
 namespace minko
 {
 	namespace geometry
@@ -31,10 +33,12 @@ namespace minko
 			public std::enable_shared_from_this<Skin>
 		{
 		public:
-			typedef std::shared_ptr<Skin>	Ptr;
+			typedef std::shared_ptr<Skin>							Ptr;
+			typedef std::vector<float, math::AlignedAllocator<float>>	BonePalette;
 
 		private:
-			typedef std::shared_ptr<Bone>	BonePtr;
+			typedef std::shared_ptr<Bone>						BonePtr;
+			typedef std::shared_ptr<animation::AnimationClip>	AnimationClipPtr;
 
 		private:
 			const unsigned int				        _numBones;
@@ -42,12 +46,19 @@ namespace minko
 
 			const uint						        _duration;				// in milliseconds
 			const float						        _timeFactor;
+			uint							        _numFrames;
 			std::vector<std::vector<math::mat4>>	_boneMatricesPerFrame;
 
+			// once compressed, the matrices of the last requested frame are decoded from the clip
+			AnimationClipPtr						_clip;
+			mutable std::vector<uint>				_clipCursors;
+			mutable std::vector<math::mat4>			_clipMatrices;
+			mutable int								_clipFrameId;
+
 			unsigned int					        _maxNumVertexBones;
 			std::vector<unsigned int>		        _numVertexBones;		// size = #vertices
-			std::vector<unsigned int>		        _vertexBones;			// size = #vertices * #bones      
-			std::vector<float>				        _vertexBoneWeights;		// size = #vertices * #bones   
+			std::vector<unsigned int>		        _vertexBones;			// size = #vertices * max #bones per vertex
+			std::vector<float>				        _vertexBoneWeights;		// size = #vertices * max #bones per vertex
 			
 		public:
 			inline
@@ -117,7 +128,7 @@ namespace minko
 			unsigned int
 			numFrames() const
 			{
-				return _boneMatricesPerFrame.size();
+				return _numFrames;
 			}
 
 			inline
@@ -125,20 +136,30 @@ namespace minko
 			setBoneMatricesPerFrame(std::vector<std::vector<math::mat4>> boneMatricesPerFrame)
 			{
 				_boneMatricesPerFrame = boneMatricesPerFrame;
+				_numFrames = _boneMatricesPerFrame.size();
+				_clip = nullptr;
 			}
 
-			inline
-            std::vector<std::vector<math::mat4>>
-			getBoneMatricesPerFrame()
-			{
-				return _boneMatricesPerFrame;
-			}
+			std::vector<std::vector<math::mat4>>
+			getBoneMatricesPerFrame();
 
-			inline
+			// Bone matrices of a frame. Once the skin is compressed, the returned vector is only
+			// valid until the matrices of another frame are requested.
 			const std::vector<math::mat4>&
-			matrices(unsigned int frameId) const
+			matrices(unsigned int frameId) const;
+
+			// Replaces the matrices of every frame by an animation clip with one track per bone,
+			// each frame being a key. The matrices must be affine, without shear. They cannot be
+			// changed with matrix() afterwards.
+			Ptr
+			compress();
+
+			// nullptr until compress() is called.
+			inline
+			AnimationClipPtr
+			clip() const
 			{
-				return _boneMatricesPerFrame[frameId];
+				return _clip;
 			}
 
 			void
@@ -171,9 +192,57 @@ namespace minko
 			float 
 			vertexBoneWeight(unsigned int vertexId, unsigned int j) const;
 
+			// Bone ids and weights of all the vertices, maxNumVertexBones() per vertex. Unused
+			// slots have a zero weight.
+			inline
+			const std::vector<unsigned int>&
+			vertexBoneIds() const
+			{
+				return _vertexBones;
+			}
+
+			inline
+			const std::vector<float>&
+			vertexBoneWeights() const
+			{
+				return _vertexBoneWeights;
+			}
+
 			Ptr
 			reorganizeByVertices();
 
+			// Converts bone matrices to the palette used by skinVertices(): one 3x4 row-major affine
+			// matrix (12 floats) per bone.
+			static
+			void
+			computeBonePalette(const std::vector<math::mat4>& boneMatrices, BonePalette& palette);
+
+			// Same layout, written to a caller-provided array of 12 floats per bone.
+			static
+			void
+			computeBonePalette(const std::vector<math::mat4>& boneMatrices, float* palette);
+
+			// Converts rigid bone matrices to unit dual quaternions: real then dual part of each
+			// bone, as (x, y, z, w), 8 floats per bone. Scale is discarded.
+			static
+			void
+			computeDualQuaternionPalette(const std::vector<math::mat4>& boneMatrices, float* palette);
+
+			// Skins the vertices [firstVertexId, lastVertexId) in a single pass: the bone matrices of
+			// each vertex are blended once and applied to both its position and its normal.
+			// The pointers address the attribute of vertex 0 and strides are in floats. Normals
+			// are optional (nullptr).
+			void
+			skinVertices(const BonePalette&	palette,
+						 uint				firstVertexId,
+						 uint				lastVertexId,
+						 const float*		positions,
+						 float*				outPositions,
+						 uint				positionStride,
+						 const float*		normals,
+						 float*				outNormals,
+						 uint				normalStride) const;
+
 			Ptr
 			disposeBones();
 
@@ -193,7 +262,7 @@ namespace minko
 				assert(vertexId < numVertices() && j < numVertexBones(vertexId));
 #endif // DEBUG_SKINNING
 
-				return j + _numBones * vertexId;
+				return j + _maxNumVertexBones * vertexId;
 			}
 
 		};
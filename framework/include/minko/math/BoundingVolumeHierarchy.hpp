@@ -0,0 +1,174 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/math/Simd.hpp"
+
+namespace minko
+{
+	namespace math
+	{
+		// Flat 4-wide bounding volume hierarchy over axis-aligned boxes. Each node stores the
+		// boxes of its (up to) 4 children as SoA arrays so that they are tested together with
+		// SIMD instructions. Nodes are stored in depth-first order, so the hierarchy can be refit
+		// in a single reverse pass when the boxes move without changing its topology.
+		// Items are identified by their index in the arrays of boxes given to build().
+		class BoundingVolumeHierarchy
+		{
+		public:
+			typedef std::shared_ptr<BoundingVolumeHierarchy>	Ptr;
+			// Intersects the ray with an item: returns true and lowers distance on a closer hit.
+			typedef std::function<bool(uint, float&)>			RayItemFunction;
+			// Intersects the rays of a packet selected by a mask with an item: lowers the distances
+			// of the rays it hits closer and returns the mask of those rays.
+			typedef std::function<uint(uint, uint, float*)>		RayPacketItemFunction;
+
+			enum class SplitMethod
+			{
+				MEDIAN,					// fast to build, for boxes that move
+				SURFACE_AREA_HEURISTIC	// slower to build, faster to cast rays against
+			};
+
+			static const int									EMPTY_CHILD;
+
+			struct Node
+			{
+				float	minX[4];
+				float	minY[4];
+				float	minZ[4];
+				float	maxX[4];
+				float	maxY[4];
+				float	maxZ[4];
+				int		children[4];	// >= 0: node index, EMPTY_CHILD or ~item
+				uint	firstItem;		// the items of the subtree are items()[firstItem, firstItem + numItems)
+				uint	numItems;
+				int		parent;
+				uint	depth;
+			};
+
+		private:
+			typedef std::vector<Node, AlignedAllocator<Node, 64>>	NodeArray;
+
+		private:
+			NodeArray				_nodes;
+			std::vector<uint>		_items;
+			SplitMethod				_splitMethod;
+
+		public:
+			inline static
+			Ptr
+			create()
+			{
+				return std::shared_ptr<BoundingVolumeHierarchy>(new BoundingVolumeHierarchy());
+			}
+
+			inline
+			uint
+			numItems() const
+			{
+				return _items.size();
+			}
+
+			inline
+			const NodeArray&
+			nodes() const
+			{
+				return _nodes;
+			}
+
+			// Item ids, ordered so that the items of any subtree are contiguous.
+			inline
+			const std::vector<uint>&
+			items() const
+			{
+				return _items;
+			}
+
+			// Union of the boxes of all the items; minBound > maxBound when there is none.
+			void
+			bounds(math::vec3& minBound, math::vec3& maxBound) const;
+
+			// Builds the hierarchy of the boxes [minBounds[i], maxBounds[i]].
+			void
+			build(const std::vector<math::vec3>&	minBounds,
+				  const std::vector<math::vec3>&	maxBounds,
+				  SplitMethod						splitMethod = SplitMethod::MEDIAN);
+
+			// Updates the boxes of the nodes after the boxes of the items changed. The number
+			// of items must not change.
+			void
+			refit(const std::vector<math::vec3>& minBounds, const std::vector<math::vec3>& maxBounds);
+
+			// Sets in visibleItems the bits of the items which are not entirely behind one of the
+			// planes (a, b, c, d), a * x + b * y + c * z + d >= 0 being the inside half-space.
+			void
+			testPlanes(const std::array<math::vec4, 6>& planes, std::vector<uint32_t>& visibleItems) const;
+
+			// Calls intersectItem, nearest boxes first, for the items whose box is hit by the ray
+			// closer than distance. Returns whether one of them was hit, in which case item and
+			// distance are the ones of the closest hit.
+			bool
+			castRay(const math::vec3&		origin,
+					const math::vec3&		direction,
+					float&					distance,
+					uint&					item,
+					const RayItemFunction&	intersectItem) const;
+
+			// Same as castRay() for a packet of up to 4 rays, which traverse the hierarchy together
+			// so that each box is tested against all of them at once. Returns the mask of the rays
+			// that hit an item.
+			uint
+			castRayPacket(const math::vec3*				origins,
+						  const math::vec3*				directions,
+						  uint							numRays,
+						  float*						distances,
+						  uint*							items,
+						  const RayPacketItemFunction&	intersectItems) const;
+
+		private:
+			BoundingVolumeHierarchy();
+
+			int
+			buildNode(uint								first,
+					  uint								last,
+					  int								parent,
+					  uint								depth,
+					  const std::vector<math::vec3>&	centers,
+					  const std::vector<math::vec3>&	minBounds,
+					  const std::vector<math::vec3>&	maxBounds);
+
+			uint
+			splitItems(uint								first,
+					   uint								last,
+					   const std::vector<math::vec3>&	centers,
+					   const std::vector<math::vec3>&	minBounds,
+					   const std::vector<math::vec3>&	maxBounds);
+
+			uint
+			splitItemsAtMedian(uint first, uint last, uint axis, const std::vector<math::vec3>& centers);
+
+			void
+			setVisible(int child, std::vector<uint32_t>& visibleItems) const;
+		};
+	}
+}
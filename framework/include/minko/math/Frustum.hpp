@@ -60,6 +60,14 @@ namespace minko
 			void
 			updateFromMatrix(const math::mat4& matrix);
 
+			// Normalized planes, indexed by PlanePosition, pointing inside the frustum.
+			inline
+			const std::array<math::vec4, 6>&
+			planes() const
+			{
+				return _planes;
+			}
+
 			std::pair<ShapePosition, unsigned int>
 			testBoundingBox(std::shared_ptr<math::Box> box, unsigned int basePlaneId);
 
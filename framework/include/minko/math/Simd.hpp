@@ -0,0 +1,612 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include <cstdlib>
+
+#if MINKO_SIMD == MINKO_SIMD_SSE2
+# include <emmintrin.h>
+#elif MINKO_SIMD == MINKO_SIMD_NEON
+# include <arm_neon.h>
+#endif
+
+#if MINKO_COMPILER & MINKO_COMPILER_VC
+# include <intrin.h>
+#endif
+
+namespace minko
+{
+	namespace math
+	{
+		// Minimal std allocator returning memory aligned on Alignment bytes, used to store
+		// math types in contiguous arrays processed with SIMD instructions.
+		template <typename T, std::size_t Alignment = 16>
+		class AlignedAllocator
+		{
+		public:
+			typedef T			value_type;
+			typedef T*			pointer;
+			typedef const T*	const_pointer;
+			typedef T&			reference;
+			typedef const T&	const_reference;
+			typedef std::size_t	size_type;
+			typedef std::ptrdiff_t	difference_type;
+
+			template <typename U>
+			struct rebind
+			{
+				typedef AlignedAllocator<U, Alignment> other;
+			};
+
+		public:
+			AlignedAllocator() = default;
+
+			template <typename U>
+			AlignedAllocator(const AlignedAllocator<U, Alignment>&)
+			{
+			}
+
+			T*
+			allocate(std::size_t n)
+			{
+				// The original pointer is stored right before the aligned block.
+				auto memory = static_cast<unsigned char*>(std::malloc(n * sizeof(T) + Alignment + sizeof(void*)));
+
+				if (memory == nullptr)
+					throw std::bad_alloc();
+
+				auto address = reinterpret_cast<std::uintptr_t>(memory + sizeof(void*));
+				auto aligned = reinterpret_cast<void**>((address + Alignment - 1) & ~(std::uintptr_t)(Alignment - 1));
+
+				aligned[-1] = memory;
+
+				return reinterpret_cast<T*>(aligned);
+			}
+
+			void
+			deallocate(T* p, std::size_t)
+			{
+				if (p != nullptr)
+					std::free(reinterpret_cast<void**>(p)[-1]);
+			}
+
+			template <typename U, typename... Args>
+			void
+			construct(U* p, Args&&... args)
+			{
+				::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+			}
+
+			template <typename U>
+			void
+			destroy(U* p)
+			{
+				p->~U();
+			}
+
+			template <typename U>
+			bool
+			operator==(const AlignedAllocator<U, Alignment>&) const
+			{
+				return true;
+			}
+
+			template <typename U>
+			bool
+			operator!=(const AlignedAllocator<U, Alignment>&) const
+			{
+				return false;
+			}
+		};
+
+		// result = a * b. Works on unaligned matrices, but is faster when all three are
+		// 16 bytes aligned. result must not alias a or b.
+		inline
+		void
+		multiply(const mat4& a, const mat4& b, mat4& result)
+		{
+			const float* lhs = &a[0][0];
+			const float* rhs = &b[0][0];
+			float* out = &result[0][0];
+
+#if MINKO_SIMD == MINKO_SIMD_SSE2
+			const __m128 a0 = _mm_loadu_ps(lhs);
+			const __m128 a1 = _mm_loadu_ps(lhs + 4);
+			const __m128 a2 = _mm_loadu_ps(lhs + 8);
+			const __m128 a3 = _mm_loadu_ps(lhs + 12);
+
+			for (auto i = 0; i < 4; ++i)
+			{
+				const float* column = rhs + (i << 2);
+				__m128 r = _mm_mul_ps(a0, _mm_set1_ps(column[0]));
+
+				r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(column[1])));
+				r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(column[2])));
+				r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(column[3])));
+
+				_mm_storeu_ps(out + (i << 2), r);
+			}
+#elif MINKO_SIMD == MINKO_SIMD_NEON
+			const float32x4_t a0 = vld1q_f32(lhs);
+			const float32x4_t a1 = vld1q_f32(lhs + 4);
+			const float32x4_t a2 = vld1q_f32(lhs + 8);
+			const float32x4_t a3 = vld1q_f32(lhs + 12);
+
+			for (auto i = 0; i < 4; ++i)
+			{
+				const float32x4_t column = vld1q_f32(rhs + (i << 2));
+				float32x4_t r = vmulq_lane_f32(a0, vget_low_f32(column), 0);
+
+				r = vmlaq_lane_f32(r, a1, vget_low_f32(column), 1);
+				r = vmlaq_lane_f32(r, a2, vget_high_f32(column), 0);
+				r = vmlaq_lane_f32(r, a3, vget_high_f32(column), 1);
+
+				vst1q_f32(out + (i << 2), r);
+			}
+#else
+			for (auto i = 0; i < 4; ++i)
+				for (auto j = 0; j < 4; ++j)
+					out[(i << 2) + j] = lhs[j] * rhs[i << 2]
+						+ lhs[4 + j] * rhs[(i << 2) + 1]
+						+ lhs[8 + j] * rhs[(i << 2) + 2]
+						+ lhs[12 + j] * rhs[(i << 2) + 3];
+#endif
+		}
+
+		// Thin wrappers over 4-wide float registers, so that data-parallel loops over SoA arrays
+		// are written once for SSE2, NEON and the scalar fallback. Comparisons return one bit per
+		// lane (lane i -> bit i).
+		namespace simd
+		{
+#if MINKO_SIMD == MINKO_SIMD_SSE2
+			typedef __m128 float4;
+
+			inline
+			float4
+			load(const float* p)
+			{
+				return _mm_load_ps(p);
+			}
+
+			inline
+			float4
+			loadu(const float* p)
+			{
+				return _mm_loadu_ps(p);
+			}
+
+			inline
+			void
+			store(float* p, float4 a)
+			{
+				_mm_store_ps(p, a);
+			}
+
+			inline
+			void
+			storeu(float* p, float4 a)
+			{
+				_mm_storeu_ps(p, a);
+			}
+
+			inline
+			float4
+			splat(float x)
+			{
+				return _mm_set1_ps(x);
+			}
+
+			inline
+			float4
+			add(float4 a, float4 b)
+			{
+				return _mm_add_ps(a, b);
+			}
+
+			inline
+			float4
+			sub(float4 a, float4 b)
+			{
+				return _mm_sub_ps(a, b);
+			}
+
+			inline
+			float4
+			mul(float4 a, float4 b)
+			{
+				return _mm_mul_ps(a, b);
+			}
+
+			inline
+			float4
+			madd(float4 a, float4 b, float4 c)
+			{
+				return _mm_add_ps(_mm_mul_ps(a, b), c);
+			}
+
+			inline
+			float4
+			div(float4 a, float4 b)
+			{
+				return _mm_div_ps(a, b);
+			}
+
+			inline
+			float4
+			min(float4 a, float4 b)
+			{
+				return _mm_min_ps(a, b);
+			}
+
+			inline
+			float4
+			max(float4 a, float4 b)
+			{
+				return _mm_max_ps(a, b);
+			}
+
+			inline
+			float4
+			sqrt(float4 a)
+			{
+				return _mm_sqrt_ps(a);
+			}
+
+			inline
+			uint
+			lessThan(float4 a, float4 b)
+			{
+				return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+			}
+
+			inline
+			uint
+			lessEqual(float4 a, float4 b)
+			{
+				return _mm_movemask_ps(_mm_cmple_ps(a, b));
+			}
+
+			// Transposes the 4x4 matrix whose rows are a, b, c and d.
+			inline
+			void
+			transpose(float4& a, float4& b, float4& c, float4& d)
+			{
+				_MM_TRANSPOSE4_PS(a, b, c, d);
+			}
+#elif MINKO_SIMD == MINKO_SIMD_NEON
+			typedef float32x4_t float4;
+
+			inline
+			uint
+			movemask(uint32x4_t mask)
+			{
+				static const uint32_t bits[4] = { 1u, 2u, 4u, 8u };
+				const uint32x4_t r = vandq_u32(mask, vld1q_u32(bits));
+				const uint32x2_t s = vorr_u32(vget_low_u32(r), vget_high_u32(r));
+
+				return vget_lane_u32(s, 0) | vget_lane_u32(s, 1);
+			}
+
+			inline
+			float4
+			load(const float* p)
+			{
+				return vld1q_f32(p);
+			}
+
+			inline
+			float4
+			loadu(const float* p)
+			{
+				return vld1q_f32(p);
+			}
+
+			inline
+			void
+			store(float* p, float4 a)
+			{
+				vst1q_f32(p, a);
+			}
+
+			inline
+			void
+			storeu(float* p, float4 a)
+			{
+				vst1q_f32(p, a);
+			}
+
+			inline
+			float4
+			splat(float x)
+			{
+				return vdupq_n_f32(x);
+			}
+
+			inline
+			float4
+			add(float4 a, float4 b)
+			{
+				return vaddq_f32(a, b);
+			}
+
+			inline
+			float4
+			sub(float4 a, float4 b)
+			{
+				return vsubq_f32(a, b);
+			}
+
+			inline
+			float4
+			mul(float4 a, float4 b)
+			{
+				return vmulq_f32(a, b);
+			}
+
+			inline
+			float4
+			madd(float4 a, float4 b, float4 c)
+			{
+				return vmlaq_f32(c, a, b);
+			}
+
+			inline
+			float4
+			div(float4 a, float4 b)
+			{
+#if defined(__aarch64__)
+				return vdivq_f32(a, b);
+#else
+				// reciprocal estimate refined by 2 Newton-Raphson steps
+				float32x4_t r = vrecpeq_f32(b);
+
+				r = vmulq_f32(vrecpsq_f32(b, r), r);
+				r = vmulq_f32(vrecpsq_f32(b, r), r);
+
+				return vmulq_f32(a, r);
+#endif
+			}
+
+			inline
+			float4
+			min(float4 a, float4 b)
+			{
+				return vminq_f32(a, b);
+			}
+
+			inline
+			float4
+			max(float4 a, float4 b)
+			{
+				return vmaxq_f32(a, b);
+			}
+
+			inline
+			float4
+			sqrt(float4 a)
+			{
+#if defined(__aarch64__)
+				return vsqrtq_f32(a);
+#else
+				// a * 1 / sqrt(a), the estimate being refined by 2 Newton-Raphson steps. a is
+				// clamped to FLT_MIN so that 0 does not give 0 * inf.
+				a = vmaxq_f32(a, vdupq_n_f32(FLT_MIN));
+
+				float32x4_t r = vrsqrteq_f32(a);
+
+				r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+				r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+
+				return vmulq_f32(a, r);
+#endif
+			}
+
+			inline
+			uint
+			lessThan(float4 a, float4 b)
+			{
+				return movemask(vcltq_f32(a, b));
+			}
+
+			inline
+			uint
+			lessEqual(float4 a, float4 b)
+			{
+				return movemask(vcleq_f32(a, b));
+			}
+
+			// Transposes the 4x4 matrix whose rows are a, b, c and d.
+			inline
+			void
+			transpose(float4& a, float4& b, float4& c, float4& d)
+			{
+				const float32x4x2_t ab = vtrnq_f32(a, b);
+				const float32x4x2_t cd = vtrnq_f32(c, d);
+
+				a = vcombine_f32(vget_low_f32(ab.val[0]), vget_low_f32(cd.val[0]));
+				b = vcombine_f32(vget_low_f32(ab.val[1]), vget_low_f32(cd.val[1]));
+				c = vcombine_f32(vget_high_f32(ab.val[0]), vget_high_f32(cd.val[0]));
+				d = vcombine_f32(vget_high_f32(ab.val[1]), vget_high_f32(cd.val[1]));
+			}
+#else
+			struct float4
+			{
+				float v[4];
+			};
+
+			template <typename F>
+			inline
+			float4
+			map(float4 a, float4 b, F f)
+			{
+				return {{ f(a.v[0], b.v[0]), f(a.v[1], b.v[1]), f(a.v[2], b.v[2]), f(a.v[3], b.v[3]) }};
+			}
+
+			inline
+			float4
+			load(const float* p)
+			{
+				return {{ p[0], p[1], p[2], p[3] }};
+			}
+
+			inline
+			float4
+			loadu(const float* p)
+			{
+				return load(p);
+			}
+
+			inline
+			void
+			store(float* p, float4 a)
+			{
+				p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3];
+			}
+
+			inline
+			void
+			storeu(float* p, float4 a)
+			{
+				store(p, a);
+			}
+
+			inline
+			float4
+			splat(float x)
+			{
+				return {{ x, x, x, x }};
+			}
+
+			inline
+			float4
+			add(float4 a, float4 b)
+			{
+				return map(a, b, [](float x, float y) { return x + y; });
+			}
+
+			inline
+			float4
+			sub(float4 a, float4 b)
+			{
+				return map(a, b, [](float x, float y) { return x - y; });
+			}
+
+			inline
+			float4
+			mul(float4 a, float4 b)
+			{
+				return map(a, b, [](float x, float y) { return x * y; });
+			}
+
+			inline
+			float4
+			madd(float4 a, float4 b, float4 c)
+			{
+				return add(mul(a, b), c);
+			}
+
+			inline
+			float4
+			div(float4 a, float4 b)
+			{
+				return map(a, b, [](float x, float y) { return x / y; });
+			}
+
+			inline
+			float4
+			min(float4 a, float4 b)
+			{
+				return map(a, b, [](float x, float y) { return y < x ? y : x; });
+			}
+
+			inline
+			float4
+			max(float4 a, float4 b)
+			{
+				return map(a, b, [](float x, float y) { return x < y ? y : x; });
+			}
+
+			inline
+			float4
+			sqrt(float4 a)
+			{
+				return {{ std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3]) }};
+			}
+
+			inline
+			uint
+			lessThan(float4 a, float4 b)
+			{
+				return (a.v[0] < b.v[0] ? 1u : 0u) | (a.v[1] < b.v[1] ? 2u : 0u)
+					| (a.v[2] < b.v[2] ? 4u : 0u) | (a.v[3] < b.v[3] ? 8u : 0u);
+			}
+
+			inline
+			uint
+			lessEqual(float4 a, float4 b)
+			{
+				return (a.v[0] <= b.v[0] ? 1u : 0u) | (a.v[1] <= b.v[1] ? 2u : 0u)
+					| (a.v[2] <= b.v[2] ? 4u : 0u) | (a.v[3] <= b.v[3] ? 8u : 0u);
+			}
+
+			// Transposes the 4x4 matrix whose rows are a, b, c and d.
+			inline
+			void
+			transpose(float4& a, float4& b, float4& c, float4& d)
+			{
+				std::swap(a.v[1], b.v[0]);
+				std::swap(a.v[2], c.v[0]);
+				std::swap(a.v[3], d.v[0]);
+				std::swap(b.v[2], c.v[1]);
+				std::swap(b.v[3], d.v[1]);
+				std::swap(c.v[3], d.v[2]);
+			}
+#endif
+		}
+
+		// Index of the lowest set bit of a non-zero word.
+		inline
+		uint
+		countTrailingZeros(uint32_t word)
+		{
+#if MINKO_COMPILER & MINKO_COMPILER_VC
+			unsigned long index;
+
+			_BitScanForward(&index, word);
+
+			return static_cast<uint>(index);
+#elif defined(__GNUC__) || defined(__clang__)
+			return static_cast<uint>(__builtin_ctz(word));
+#else
+			uint index = 0;
+
+			while ((word & 1u) == 0)
+			{
+				word >>= 1;
+				++index;
+			}
+
+			return index;
+#endif
+		}
+	}
+}
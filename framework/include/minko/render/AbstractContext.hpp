@@ -97,6 +97,22 @@ namespace minko
 			void
 			drawTriangles(const uint firstIndex, const int numTriangles) = 0;
 
+            virtual
+            void
+            drawTrianglesInstanced(const uint   indexBuffer,
+                                   const uint   firstIndex,
+                                   const int    numTriangles,
+                                   const uint   numInstances) = 0;
+
+            virtual
+            bool
+            supportsInstancing() = 0;
+
+            // Whether index buffers can hold 32 bits indices (OES_element_index_uint on ES 2.0).
+            virtual
+            bool
+            supportsUnsignedIntIndices() = 0;
+
             virtual
             const uint
             createVertexBuffer(const uint size) = 0;
@@ -109,6 +125,10 @@ namespace minko
                               const uint    stride,
                               const uint    offset) = 0;
 
+            virtual
+            void
+            setVertexAttributeDivisor(const uint position, const uint divisor) = 0;
+
             virtual
             void
             uploadVertexBufferData(const uint     vertexBuffer,
@@ -122,7 +142,7 @@ namespace minko
 
             virtual
             const uint
-            createIndexBuffer(const uint size) = 0;
+            createIndexBuffer(const uint size, const bool unsignedIntIndices = false) = 0;
 
             virtual
             void
@@ -262,6 +282,24 @@ namespace minko
 			ProgramInputs
             getProgramInputs(const uint program) = 0;
 
+            // Whether linked programs can be read back as driver-specific binaries and loaded in
+            // place of their shaders (ARB_get_program_binary, core since OpenGL 4.1).
+            virtual
+            bool
+            supportsProgramBinaries() = 0;
+
+            // Returns false when the binary of the linked program cannot be read.
+            virtual
+            bool
+            getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary) = 0;
+
+            // Links program from a binary returned by getProgramBinary(). Returns false when the
+            // driver rejects it, typically after a driver update: the program must then be built
+            // from its shaders.
+            virtual
+            bool
+            programBinary(const uint program, const uint format, const std::vector<unsigned char>& binary) = 0;
+
             virtual
             void
             setBlendingMode(Blending::Source source, Blending::Destination destination) = 0;
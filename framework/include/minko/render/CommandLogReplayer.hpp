@@ -0,0 +1,151 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/render/RecordingContext.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		// Feeds a command log captured by a RecordingContext into another context. Resource ids
+		// are translated to the ones returned by the target context, and uniform and attribute
+		// locations are matched by name once each program is linked.
+		class CommandLogReplayer
+		{
+		public:
+			typedef std::shared_ptr<CommandLogReplayer>	Ptr;
+
+		private:
+			typedef RecordingContext::Command			Command;
+			typedef std::unordered_map<int, int>		LocationMap;
+
+			struct ProgramLocations
+			{
+				LocationMap uniforms;
+				LocationMap attributes;
+			};
+
+		private:
+			std::shared_ptr<AbstractContext>				_context;
+
+			std::unordered_map<uint, uint>					_resources;
+			std::unordered_map<uint, std::string>			_shaderSources;
+			std::unordered_map<uint, std::vector<uint>>		_programShaders;
+			std::unordered_map<uint, ProgramLocations>		_programLocations;
+			std::unordered_set<uint>						_unsignedIntIndexBuffers;
+			ProgramLocations*								_currentLocations;
+
+			const unsigned char*							_cursor;
+			const unsigned char*							_end;
+			std::vector<unsigned char>						_buffer;
+
+			uint											_numCommands;
+			uint											_numSkippedCommands;
+			uint											_numFrames;
+
+		public:
+			inline static
+			Ptr
+			create(std::shared_ptr<AbstractContext> context)
+			{
+				return std::shared_ptr<CommandLogReplayer>(new CommandLogReplayer(context));
+			}
+
+			inline
+			std::shared_ptr<AbstractContext>
+			context() const
+			{
+				return _context;
+			}
+
+			inline
+			uint
+			numCommands() const
+			{
+				return _numCommands;
+			}
+
+			// Number of commands that were dropped because they target a uniform or an attribute
+			// the target context does not report as active.
+			inline
+			uint
+			numSkippedCommands() const
+			{
+				return _numSkippedCommands;
+			}
+
+			inline
+			uint
+			numFrames() const
+			{
+				return _numFrames;
+			}
+
+			// Replays the whole log. The resources created by a previous log remain known, so
+			// the frames of a single recording can be replayed in several chunks.
+			void
+			replay(const std::vector<unsigned char>& log);
+
+		private:
+			CommandLogReplayer(std::shared_ptr<AbstractContext> context);
+
+			void
+			replayCommand(Command command);
+
+			template <typename T>
+			inline
+			T
+			read()
+			{
+				T value;
+
+				checkAvailable(sizeof(T));
+				std::memcpy(&value, _cursor, sizeof(T));
+				_cursor += sizeof(T);
+
+				return value;
+			}
+
+			void*
+			readData();
+
+			void*
+			readUniformData(uint count, uint numComponents);
+
+			void
+			checkAvailable(uint size);
+
+			uint
+			resource(uint recordedId);
+
+			int
+			uniformLocation(int recordedLocation);
+
+			int
+			attributeLocation(int recordedLocation);
+
+			void
+			mapProgramLocations(uint recordedProgram);
+		};
+	}
+}
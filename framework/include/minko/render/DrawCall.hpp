@@ -40,6 +40,8 @@ namespace minko
         public:
             static const unsigned int	MAX_NUM_TEXTURES;
             static const unsigned int   MAX_NUM_VERTEXBUFFERS;
+            // Vertex attributes whose name starts with this prefix are read once per instance.
+            static const std::string    INSTANCE_ATTRIBUTE_PREFIX;
 
             template <typename T>
             struct UniformValue
@@ -50,6 +52,19 @@ namespace minko
                 const T* data;
             };
 
+            // Number of context state changes issued and skipped when submitting draw calls.
+            struct StateChanges
+            {
+                uint issued;
+                uint skipped;
+
+                StateChanges() :
+                    issued(0),
+                    skipped(0)
+                {
+                }
+            };
+
 		private:
             typedef const ProgramInputs::UniformInput&      ConstUniformInputRef;
             typedef const ProgramInputs::AttributeInput&    ConstAttrInputRef;
@@ -101,6 +116,7 @@ namespace minko
             std::vector<UniformValue<int>>      _uniformBool;
             std::vector<SamplerValue>           _samplers;
             std::vector<AttributeValue>         _attributes;
+            std::vector<AttributeValue>         _instanceAttributes;
 
             const float*				        _priority;
             const bool*						    _zSorted;
@@ -132,6 +148,13 @@ namespace minko
 
             uint                                _vertexAttribArray;
 
+            int                                 _sortIndex;
+
+            DrawCall*                           _instanceLeader;
+            std::vector<DrawCall*>              _instances;
+            uint                                _firstInstance;
+            uint                                _numInstances;
+
 		public:
             DrawCall(uint					batchId,
 					 std::shared_ptr<Pass>  pass,
@@ -154,6 +177,81 @@ namespace minko
                 _enabled = value;
             }
 
+            // Position of the draw call in the render queue of its DrawCallPool, -1 if not queued.
+            inline
+            int
+            sortIndex() const
+            {
+                return _sortIndex;
+            }
+
+            inline
+            void
+            sortIndex(int value)
+            {
+                _sortIndex = value;
+            }
+
+            // True if the program reads per-instance vertex attributes: the draw call is then rendered
+            // by the leader of its instance group.
+            inline
+            bool
+            instanced() const
+            {
+                return !_instanceAttributes.empty();
+            }
+
+            inline
+            DrawCall*
+            instanceLeader() const
+            {
+                return _instanceLeader;
+            }
+
+            inline
+            void
+            instanceLeader(DrawCall* value)
+            {
+                _instanceLeader = value;
+            }
+
+            // Draw calls rendered along with this one, starting with itself. Empty if this draw
+            // call is not the leader of an instance group.
+            inline
+            std::vector<DrawCall*>&
+            instances()
+            {
+                return _instances;
+            }
+
+            inline
+            uint
+            firstInstance() const
+            {
+                return _firstInstance;
+            }
+
+            inline
+            void
+            firstInstance(uint value)
+            {
+                _firstInstance = value;
+            }
+
+            inline
+            uint
+            numInstances() const
+            {
+                return _numInstances;
+            }
+
+            inline
+            void
+            numInstances(uint value)
+            {
+                _numInstances = value;
+            }
+
 			inline
 			std::vector<uint>&
 			batchIDs()
@@ -367,6 +465,13 @@ namespace minko
 				return _numIndices ? *_numIndices / 3 : 0;
 			}
 
+            inline
+            const math::mat4*
+            modelToWorldMatrix() const
+            {
+                return _modelToWorldMatrix;
+            }
+
             void
             bind(std::shared_ptr<Program> program);
 
@@ -376,6 +481,27 @@ namespace minko
 				   const math::ivec4&				 viewport,
 				   uint 							 clearColor);
 
+            // Only the program, uniforms, textures, vertex attributes and states that differ from
+            // the ones of the previously submitted draw call are sent to the context.
+            void
+            render(std::shared_ptr<AbstractContext>  context,
+                   AbsTexturePtr                     renderTarget,
+                   const math::ivec4&                viewport,
+                   uint                              clearColor,
+                   const DrawCall*                   previous,
+                   StateChanges&                     stateChanges);
+
+            // Whether both draw calls only differ by their model to world matrix and can therefore
+            // be merged into a single instanced draw.
+            bool
+            canBeInstancedWith(const DrawCall& drawCall) const;
+
+            size_t
+            samplersHash() const;
+
+            size_t
+            attributesHash() const;
+
             void
             bindAttribute(ConstAttrInputRef     						        input,
 						  const std::unordered_map<std::string, data::Binding>& attributeBindings,
@@ -449,6 +575,31 @@ namespace minko
 									   const std::string&                   propertyName,
 									   const data::Store&                   store);
 
+            template <typename T>
+            static
+            bool
+            uniformAlreadySubmitted(const UniformValue<T>&              uniform,
+                                    const std::vector<UniformValue<T>>& previousUniforms,
+                                    uint                                index)
+            {
+                // draw calls using the same program bind their uniforms in the same order
+                if (index >= previousUniforms.size())
+                    return false;
+
+                const auto& previousUniform = previousUniforms[index];
+
+                return previousUniform.location == uniform.location
+                    && previousUniform.data == uniform.data
+                    && previousUniform.size == uniform.size
+                    && previousUniform.count == uniform.count;
+            }
+
+            void
+            setUniformInt(const AbsCtxPtr& context, const UniformValue<int>& u);
+
+            void
+            setUniformFloat(const AbsCtxPtr& context, const UniformValue<float>& u);
+
             template <typename T>
             void
             setUniformValue(std::vector<UniformValue<T>>& 	uniforms,
@@ -62,22 +62,10 @@ namespace minko
                 }
             };*/
 
-            typedef std::tuple<float, int*>	SortPropertyTuple;
-
-            struct SortPropertyKeyComparator
-            {
-                bool
-                operator()(const SortPropertyTuple& left,
-                           const SortPropertyTuple& right) const;
-            };
-
             typedef std::vector<DrawCall*>	DrawCallList;
+            typedef std::vector<uint64_t>   SortKeyList;
+            typedef DrawCallList            DrawCallContainer;
 
-            typedef std::map<
-                SortPropertyTuple,
-                std::array<DrawCallList, 2u>,
-                SortPropertyKeyComparator
-            >                                                                   DrawCallContainer;
             typedef DrawCallList::iterator                                      DrawCallIterator;
             typedef data::Store::PropertyChangedSignal                          PropertyChanged;
             typedef std::pair<PropertyChanged::Slot, uint>                      ChangedSlot;
@@ -101,11 +89,27 @@ namespace minko
 		private:
 			uint							_batchId;
             DrawCallContainer             	_drawCalls;
+            SortKeyList                     _sortKeys;
+            DrawCallList                    _drawCallsSwap;
+            SortKeyList                     _sortKeysSwap;
+            bool                            _mustSort;
+            bool                            _mustUpdateInstances;
+            // render target ids used in the sort keys, recycled when no sort key uses them
+            std::unordered_map<const int*, uint> _targetIds;
+            std::vector<const int*>         _targetIdToTarget;
+            std::vector<uint>               _targetIdRefCounts;
+            std::vector<uint>               _freeTargetIds;
             MacroToDrawCallsMap*            _macroToDrawCalls;
             std::unordered_map<
                 DrawCall*,
                 std::pair<bool, EffectVariables>
             >                               _invalidDrawCalls;
+            // draw calls waiting for their program to be linked by the default ProgramBuilder
+            std::unordered_map<
+                DrawCall*,
+                std::pair<bool, EffectVariables>
+            >                               _pendingDrawCalls;
+            uint                            _numLinkedPrograms;
             std::unordered_set<DrawCall*>   _drawCallsToBeSorted;
             MacroToChangedSlotMap*          _macroChangedSlot;
             PropertyChangedSlotMap*         _propChangedSlot;
@@ -152,6 +156,11 @@ namespace minko
             unsigned int
             numDrawCalls() const;
 
+            // Packs the model to world matrices of the enabled instances of each instance group
+            // in rendering order and returns the number of packed instances.
+            uint
+            packInstances(std::vector<float>& instanceData);
+
         private:
             void
             watchProgramSignature(DrawCall&                     drawCall,
@@ -219,6 +228,28 @@ namespace minko
             void
             removeDrawCallFromSortedBucket(DrawCall* drawCall);
 
+            void
+            updateDrawCallSortKey(DrawCall* drawCall);
+
+            // The returned key holds a reference on the target id, released by releaseSortKey().
+            uint64_t
+            computeSortKey(DrawCall* drawCall);
+
+            void
+            releaseSortKey(uint64_t sortKey);
+
+            uint
+            acquireTargetId(const int* target);
+
+            void
+            releaseTargetId(uint targetId);
+
+            void
+            sortDrawCalls();
+
+            void
+            updateInstances();
+
             DrawCall*
             findDrawCall(const std::function<bool(DrawCall*)>& predicate);
 
@@ -234,10 +265,6 @@ namespace minko
 			void
 			unbindDrawCall(DrawCall& drawCall);
 
-            static
-            bool
-            compareZSortedDrawCalls(DrawCall* a, DrawCall* b);
-
             void
             zSortDrawCalls();
         };
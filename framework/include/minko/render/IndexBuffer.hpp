@@ -72,6 +72,8 @@ namespace minko
 			{
 				Ptr ptr = std::shared_ptr<IndexBuffer>(new IndexBuffer(context, data));
 
+				ptr->upload();
+
 				return ptr;
 			}
 
@@ -94,11 +96,18 @@ namespace minko
 				dispose();
 			}
 
+			// The 16 bits indices. Use dataPointer<unsigned int>() or index() when the indices may
+			// be 32 bits.
 			inline
 			std::vector<unsigned short>&
 			data()
 			{
-				return *Any::unsafe_cast<std::vector<unsigned short>>(&_data);
+				auto u16Data = dataPointer<unsigned short>();
+
+				if (!u16Data)
+					throw std::logic_error("The index buffer holds 32 bits indices.");
+
+				return *u16Data;
 			}
 
             template <typename T>
@@ -109,6 +118,23 @@ namespace minko
 			    return Any::cast<std::vector<T>>(&_data);
 			}
 
+			inline
+			bool
+			unsignedIntIndices()
+			{
+				return dataPointer<unsigned int>() != nullptr;
+			}
+
+			// The i-th index, whatever the size of the indices.
+			inline
+			uint
+			index(uint i)
+			{
+				auto u16Data = dataPointer<unsigned short>();
+
+				return u16Data ? (*u16Data)[i] : (*dataPointer<unsigned int>())[i];
+			}
+
 			inline
 			unsigned int
 			numIndices() const
@@ -129,6 +155,9 @@ namespace minko
 			void
 			upload(uint offset, int count, const std::vector<unsigned short>& data);
 
+			void
+			upload(uint offset, int count, const std::vector<unsigned int>& data);
+
 			void
 			dispose();
 
@@ -151,6 +180,14 @@ namespace minko
 			}
 
 		protected:
+			template <typename T>
+			void
+			uploadData(uint offset, int count, std::vector<T>& data);
+
+			template <typename T>
+			void
+			uploadRange(uint offset, int count, const std::vector<T>& data);
+
 			inline
 			IndexBuffer(AbsContextPtr context) :
 				AbstractResource(context),
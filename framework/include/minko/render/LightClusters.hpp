@@ -0,0 +1,198 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		// Bins light bounding spheres into a grid of clusters splitting the view frustum in
+		// screen tiles and exponential depth slices. The lights of each cluster are stored
+		// contiguously in lightIndices(), in the order of the input, and a fragment only has to
+		// read the list of the cluster it falls in: the cost of a light no longer depends on the
+		// number of lights in the scene and the shader does not change with that number.
+		class LightClusters
+		{
+		public:
+			typedef std::shared_ptr<LightClusters>	Ptr;
+
+		private:
+			struct Entry
+			{
+				uint cluster;
+				uint light;
+			};
+
+		private:
+			uint					_numClustersX;
+			uint					_numClustersY;
+			uint					_numClustersZ;
+			uint					_maxLightsPerCluster;
+
+			math::mat4				_projection;
+			float					_zNear;
+			float					_zFar;
+			float					_depthScale;
+
+			std::vector<float>		_tileX;
+			std::vector<float>		_tileY;
+			std::vector<float>		_sliceDepth;
+
+			std::vector<uint>		_offsets;
+			std::vector<uint>		_counts;
+			std::vector<uint>		_lightIndices;
+			std::vector<Entry>		_entries;
+			uint					_numDroppedEntries;
+
+		public:
+			inline static
+			Ptr
+			create(uint numClustersX			= 16,
+				   uint numClustersY			= 8,
+				   uint numClustersZ			= 24,
+				   uint maxLightsPerCluster		= 32)
+			{
+				return std::shared_ptr<LightClusters>(new LightClusters(
+					numClustersX, numClustersY, numClustersZ, maxLightsPerCluster
+				));
+			}
+
+			inline
+			uint
+			numClustersX() const
+			{
+				return _numClustersX;
+			}
+
+			inline
+			uint
+			numClustersY() const
+			{
+				return _numClustersY;
+			}
+
+			inline
+			uint
+			numClustersZ() const
+			{
+				return _numClustersZ;
+			}
+
+			inline
+			uint
+			numClusters() const
+			{
+				return _numClustersX * _numClustersY * _numClustersZ;
+			}
+
+			inline
+			uint
+			maxLightsPerCluster() const
+			{
+				return _maxLightsPerCluster;
+			}
+
+			inline
+			uint
+			clusterIndex(uint x, uint y, uint z) const
+			{
+				return x + _numClustersX * (y + _numClustersY * z);
+			}
+
+			inline
+			float
+			zNear() const
+			{
+				return _zNear;
+			}
+
+			inline
+			float
+			zFar() const
+			{
+				return _zFar;
+			}
+
+			// Number of slices per unit of log(depth / zNear): the slice of a depth d is
+			// floor(log(d / zNear) * depthScale()).
+			inline
+			float
+			depthScale() const
+			{
+				return _depthScale;
+			}
+
+			// Index in lightIndices() of the first light of each cluster.
+			inline
+			const std::vector<uint>&
+			offsets() const
+			{
+				return _offsets;
+			}
+
+			inline
+			const std::vector<uint>&
+			counts() const
+			{
+				return _counts;
+			}
+
+			inline
+			const std::vector<uint>&
+			lightIndices() const
+			{
+				return _lightIndices;
+			}
+
+			// Number of (cluster, light) pairs left out by the last update() because the cluster
+			// already held maxLightsPerCluster() lights.
+			inline
+			uint
+			numDroppedEntries() const
+			{
+				return _numDroppedEntries;
+			}
+
+			// Bins the lights for a perspective camera. Each sphere holds the world space center
+			// of a light and its radius, a radius <= 0 meaning the light reaches every cluster.
+			void
+			update(const math::mat4&				view,
+				   const math::mat4&				projection,
+				   const std::vector<math::vec4>&	spheres);
+
+			// Cluster of a view space position, found the same way the shaders do and clamped to
+			// the grid.
+			uint
+			cluster(const math::vec3& viewPosition) const;
+
+		private:
+			LightClusters(uint numClustersX, uint numClustersY, uint numClustersZ, uint maxLightsPerCluster);
+
+			void
+			binSphere(uint light, const math::vec3& center, float radius);
+
+			uint
+			slice(float depth) const;
+		};
+	}
+}
@@ -66,6 +66,7 @@ namespace minko
 
 			std::list<uint>	                		_vertexBuffers;
 			std::list<uint>	                		_indexBuffers;
+			std::unordered_set<uint>				_unsignedIntIndexBuffers;
 			std::list<uint>                 		_programs;
 			std::list<uint>                 		_vertexShaders;
 			std::list<uint>                 		_fragmentShaders;
@@ -110,6 +111,10 @@ namespace minko
 
             std::vector<bool>                       _vertexAttributeEnabled;
 
+			bool									_supportsInstancing;
+			bool									_supportsUnsignedIntIndices;
+			bool									_supportsProgramBinaries;
+
 			int										_stencilBits;
 
 		public:
@@ -199,6 +204,26 @@ namespace minko
 			void
 			drawTriangles(const uint firstIndex, const int numTriangles) override;
 
+			void
+			drawTrianglesInstanced(const uint	indexBuffer,
+								   const uint	firstIndex,
+								   const int	numTriangles,
+								   const uint	numInstances) override;
+
+			inline
+			bool
+			supportsInstancing() override
+			{
+				return _supportsInstancing;
+			}
+
+			inline
+			bool
+			supportsUnsignedIntIndices() override
+			{
+				return _supportsUnsignedIntIndices;
+			}
+
 			const uint
 			createVertexBuffer(const uint size) override;
 
@@ -208,6 +233,10 @@ namespace minko
 							  const uint	size,
 							  const uint	stride,
 							  const uint	offset) override;
+
+			void
+			setVertexAttributeDivisor(const uint position, const uint divisor) override;
+
 			void
 			uploadVertexBufferData(const uint 	vertexBuffer,
 								   const uint 	offset,
@@ -218,7 +247,7 @@ namespace minko
 			deleteVertexBuffer(const uint vertexBuffer) override;
 
 			const uint
-			createIndexBuffer(const uint size) override;
+			createIndexBuffer(const uint size, const bool unsignedIntIndices = false) override;
 
 			void
 			uploaderIndexBufferData(const uint 	indexBuffer,
@@ -336,6 +365,19 @@ namespace minko
 			ProgramInputs
 			getProgramInputs(const uint program) override;
 
+			inline
+			bool
+			supportsProgramBinaries() override
+			{
+				return _supportsProgramBinaries;
+			}
+
+			bool
+			getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary) override;
+
+			bool
+			programBinary(const uint program, const uint format, const std::vector<unsigned char>& binary) override;
+
 			std::string
 			getShaderCompilationLogs(const uint shader);
 
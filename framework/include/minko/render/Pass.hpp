@@ -44,11 +44,24 @@ namespace minko
  			typedef std::shared_ptr<Program>							ProgramPtr;
 			typedef std::shared_ptr<VertexBuffer>						VertexBufferPtr;
             typedef std::unordered_map<std::string, SamplerState>		SamplerStatesMap;
-            typedef std::unordered_map<ProgramSignature*, ProgramPtr>	SignatureToProgramMap;
 			typedef std::function<void(ProgramPtr)>						ProgramFunc;
 			typedef std::unordered_map<std::string, ProgramFunc>		ProgramFuncMap;
 			typedef std::unordered_map<std::string, data::MacroBinding> MacroBindingsMap;
 
+			// A slot of the open addressing table of the variants, empty when signature is null.
+			struct ProgramVariant
+			{
+				ProgramSignature::HashType	hash;
+				ProgramSignature*			signature;
+				ProgramPtr					program;
+
+				ProgramVariant() :
+					hash(0),
+					signature(nullptr)
+				{
+				}
+			};
+
 		private:
 			const std::string		_name;
 			bool					_isForward;
@@ -58,7 +71,8 @@ namespace minko
 			data::BindingMap		_stateBindings;
 			data::MacroBindingMap	_macroBindings;
             States				    _states;
-            SignatureToProgramMap	_signatureToProgram;
+			std::vector<ProgramVariant>	_variants;
+			uint					_numVariants;
 
 			ProgramFuncMap			_uniformFunctions;
 			ProgramFuncMap			_attributeFunctions;
@@ -67,8 +81,8 @@ namespace minko
 		public:
             ~Pass()
             {
-                for (auto& signatureAndProgram : _signatureToProgram)
-                    delete signatureAndProgram.first;
+                for (auto& variant : _variants)
+                    delete variant.signature;
             }
 
 			inline static
@@ -106,8 +120,9 @@ namespace minko
 					pass->_macroBindings
 				);
 
-                for (auto& signatureProgram : pass->_signatureToProgram)
-                    p->_signatureToProgram[new ProgramSignature(*signatureProgram.first)] = signatureProgram.second;
+                for (auto& variant : pass->_variants)
+                    if (variant.signature != nullptr)
+                        p->addVariant(new ProgramSignature(*variant.signature), variant.program);
 
 				p->_uniformFunctions = pass->_uniformFunctions;
 				p->_attributeFunctions = pass->_attributeFunctions;
@@ -182,6 +197,16 @@ namespace minko
 				return _states;
 			}
 
+			// Number of programs built for the different values of the macros.
+			inline
+			uint
+			numVariants() const
+			{
+				return _numVariants;
+			}
+
+			// The program of a forward pass is not ready yet when it is being built by the default
+			// ProgramBuilder.
             std::pair<std::shared_ptr<Program>, const ProgramSignature*>
             selectProgram(const EffectVariables&    translatedPropertyNames,
 						  const data::Store&    	targetData,
@@ -199,8 +224,9 @@ namespace minko
 
 				if (_programTemplate->isReady())
 					_programTemplate->setUniform(name, values...);
-				for (auto signatureAndProgram : _signatureToProgram)
-					signatureAndProgram.second->setUniform(name, values...);
+				for (auto& variant : _variants)
+					if (variant.program != nullptr && variant.program->isReady())
+						variant.program->setUniform(name, values...);
 			}
 
 			inline
@@ -214,8 +240,9 @@ namespace minko
 
 				if (_programTemplate->isReady())
 					_programTemplate->setAttribute(name, attribute);
-				for (auto signatureAndProgram : _signatureToProgram)
-					signatureAndProgram.second->setAttribute(name, attribute);
+				for (auto& variant : _variants)
+					if (variant.program != nullptr && variant.program->isReady())
+						variant.program->setAttribute(name, attribute);
 			}
 
 			inline
@@ -281,8 +308,17 @@ namespace minko
                 program->define(macroName, value);
             }
 
+			const ProgramVariant*
+			findVariant(const ProgramSignature& signature) const;
+
+			void
+			addVariant(ProgramSignature* signature, ProgramPtr program);
+
 			ProgramPtr
 			finalizeProgram(ProgramPtr program);
+
+			void
+			applyProgramFunctions(ProgramPtr program);
 		};
 	}
 }
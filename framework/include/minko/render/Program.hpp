@@ -152,6 +152,11 @@ namespace minko
 			void
 			upload();
 
+			// Links the program from a binary instead of its shaders. Returns false, the program
+			// being left not ready, when the context rejects it.
+			bool
+			upload(const uint binaryFormat, const std::vector<unsigned char>& binary);
+
 			void
 			dispose();
 
@@ -0,0 +1,166 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/render/ProgramCache.hpp"
+
+namespace minko
+{
+	namespace async
+	{
+		class ThreadPool;
+	}
+
+	namespace render
+	{
+		// Builds the program variants in two steps: their shaders are preprocessed and optimized
+		// on a thread pool, then they are compiled and linked on the render thread by update(),
+		// within a time budget. The program cache is looked up before optimizing the shaders.
+		class ProgramBuilder
+		{
+		public:
+			typedef std::shared_ptr<ProgramBuilder>			Ptr;
+			typedef std::shared_ptr<Program>				ProgramPtr;
+			typedef std::function<void(ProgramPtr)>			LinkedCallback;
+
+		private:
+			struct Build
+			{
+				ProgramPtr						program;
+				LinkedCallback					linked;
+				std::string						vertexSource;
+				std::string						fragmentSource;
+				std::shared_ptr<ProgramCache>	cache;
+				ProgramCache::KeyType			key;
+				ProgramCache::Entry				entry;
+				bool							cached;
+			};
+
+			typedef std::shared_ptr<Build>						BuildPtr;
+			typedef std::pair<BuildPtr, std::future<void>>		PendingBuild;
+
+		private:
+			static Ptr									_default;
+
+			std::shared_ptr<async::ThreadPool>			_pool;
+			std::list<PendingBuild>						_builds;
+			std::unordered_set<const Program*>			_pendingPrograms;
+			float										_linkTimeBudget;
+			uint										_numLinkedPrograms;
+
+		public:
+			// A null pool uses async::ThreadPool::defaultPool().
+			inline static
+			Ptr
+			create(std::shared_ptr<async::ThreadPool> pool = nullptr)
+			{
+				return std::shared_ptr<ProgramBuilder>(new ProgramBuilder(pool));
+			}
+
+			// Builder used by the forward passes, none by default: the programs are then built
+			// as soon as they are selected.
+			inline static
+			Ptr
+			defaultBuilder()
+			{
+				return _default;
+			}
+
+			inline static
+			void
+			defaultBuilder(Ptr builder)
+			{
+				_default = builder;
+			}
+
+			// Time, in milliseconds, update() can spend linking programs. At least one program
+			// is linked per update() anyway.
+			inline
+			float
+			linkTimeBudget() const
+			{
+				return _linkTimeBudget;
+			}
+
+			inline
+			void
+			linkTimeBudget(float value)
+			{
+				_linkTimeBudget = value;
+			}
+
+			inline
+			bool
+			isPending(ProgramPtr program) const
+			{
+				return _pendingPrograms.count(program.get()) != 0;
+			}
+
+			inline
+			uint
+			numPendingPrograms() const
+			{
+				return _pendingPrograms.size();
+			}
+
+			// Number of programs linked by update() since the builder was created.
+			inline
+			uint
+			numLinkedPrograms() const
+			{
+				return _numLinkedPrograms;
+			}
+
+			// Starts building program in the background. linked is called by update() once the
+			// program is ready.
+			void
+			build(ProgramPtr program, const LinkedCallback& linked);
+
+			// Links the programs whose shaders are ready and returns how many were linked. Must
+			// be called on the render thread.
+			uint
+			update();
+
+			// Builds program right away, using the default program cache if any.
+			static
+			void
+			buildNow(ProgramPtr program);
+
+		private:
+			ProgramBuilder(std::shared_ptr<async::ThreadPool> pool);
+
+			static
+			BuildPtr
+			createBuild(ProgramPtr program);
+
+			// Can run on any thread.
+			static
+			void
+			prepare(Build& build);
+
+			static
+			void
+			link(Build& build);
+		};
+	}
+}
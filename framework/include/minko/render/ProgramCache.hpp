@@ -0,0 +1,121 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		// Persistent cache of the program variants: the context sources of their shaders, after
+		// the GLSL optimizer ran, and their binaries when the context supports them. Entries are
+		// keyed by the sources of the variants, so editing an effect does not require to clear the
+		// cache. Each entry is written in its own file of the cache directory as soon as it is
+		// stored, the directory being expected to exist. It can be used from several threads.
+		class ProgramCache
+		{
+		public:
+			typedef std::shared_ptr<ProgramCache>	Ptr;
+			typedef std::uint64_t					KeyType;
+
+			struct Entry
+			{
+				std::string					vertexSource;
+				std::string					fragmentSource;
+				std::string					driverInfo;
+				uint						binaryFormat;
+				std::vector<unsigned char>	binary;
+
+				Entry() :
+					binaryFormat(0)
+				{
+				}
+			};
+
+		private:
+			static Ptr									_default;
+
+			const std::string							_directory;
+			mutable std::mutex							_mutex;
+			std::unordered_map<KeyType, Entry>			_entries;
+			std::unordered_set<KeyType>					_missingKeys;
+
+		public:
+			// An empty directory keeps the entries in memory only.
+			inline static
+			Ptr
+			create(const std::string& directory = "")
+			{
+				return std::shared_ptr<ProgramCache>(new ProgramCache(directory));
+			}
+
+			// Cache used by all the passes, none by default.
+			inline static
+			Ptr
+			defaultCache()
+			{
+				return _default;
+			}
+
+			inline static
+			void
+			defaultCache(Ptr cache)
+			{
+				_default = cache;
+			}
+
+			inline
+			const std::string&
+			directory() const
+			{
+				return _directory;
+			}
+
+			static
+			KeyType
+			key(const std::string& vertexSource, const std::string& fragmentSource);
+
+			// Copies the entry for key into entry. Returns false when there is none, neither in
+			// memory nor on disk.
+			bool
+			find(KeyType key, Entry& entry);
+
+			void
+			store(KeyType key, const Entry& entry);
+
+		private:
+			ProgramCache(const std::string& directory) :
+				_directory(directory)
+			{
+			}
+
+			std::string
+			filename(KeyType key) const;
+
+			bool
+			load(KeyType key, Entry& entry) const;
+
+			void
+			save(KeyType key, const Entry& entry) const;
+		};
+	}
+}
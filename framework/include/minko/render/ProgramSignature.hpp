@@ -31,11 +31,13 @@ namespace minko
 		{
         public:
             typedef std::uint64_t                           MaskType;
+            typedef std::uint64_t                           HashType;
 
 		private:
             static const uint                               _maxNumMacros;
 
 			MaskType				                    	_mask;
+            HashType                                        _hash;
             std::vector<Any>	                    		_values;
             std::vector<data::MacroBindingMap::MacroType>   _types;
             std::vector<Flyweight<std::string>>             _macros;
@@ -59,6 +61,13 @@ namespace minko
 			bool
 			operator==(const ProgramSignature&) const;
 
+            inline
+            bool
+            operator!=(const ProgramSignature& x) const
+            {
+                return !(*this == x);
+            }
+
             void
             updateProgram(Program& program) const;
 
@@ -69,6 +78,15 @@ namespace minko
 				return _mask;
 			}
 
+            // Hash of the mask and of the values, computed once on construction. Equal signatures
+            // of the same pass have the same hash.
+            inline
+            HashType
+            hash() const
+            {
+                return _hash;
+            }
+
 			inline
 			const std::vector<Any>&
 			values() const
@@ -91,6 +109,9 @@ namespace minko
             }
 
         private:
+            HashType
+            computeHash() const;
+
             Any
             getValueFromStore(const data::Store&        				store,
                               const std::string&        				propertyName,
@@ -98,23 +119,3 @@ namespace minko
 		};
 	}
 }
-//
-//namespace std
-//{
-//	template<>
-//    struct hash<minko::render::ProgramSignature>
-//	{
-//		inline
-//		size_t
-//		operator()(const minko::render::ProgramSignature& x) const
-//		{
-//			size_t seed = std::hash<minko::uint>()(x.mask());
-//            auto i = 0u;
-//
-//            for (auto value : x.values())
-//                hash_combine(seed, (x.mask() >> i) != 0 ? value : 0);
-//
-//			return seed;
-//		}
-//	};
-//}
@@ -0,0 +1,519 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/render/AbstractContext.hpp"
+#include "minko/render/ProgramInputs.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		// A headless AbstractContext that does not talk to any driver: every call is appended
+		// to a compact binary command log that can later be replayed with a CommandLogReplayer.
+		// Each log entry is a Command opcode followed by its arguments; resources are referred
+		// to by the ids returned by this context.
+		class RecordingContext :
+			public AbstractContext
+		{
+		public:
+			typedef std::shared_ptr<RecordingContext> Ptr;
+
+			enum class Command : unsigned char
+			{
+				ConfigureViewport,
+				Clear,
+				Present,
+				DrawIndexedTriangles,
+				DrawTriangles,
+				DrawTrianglesInstanced,
+				CreateVertexBuffer,
+				SetVertexBufferAt,
+				SetVertexAttributeDivisor,
+				UploadVertexBufferData,
+				DeleteVertexBuffer,
+				CreateIndexBuffer,
+				UploadIndexBufferData,
+				DeleteIndexBuffer,
+				CreateTexture,
+				CreateRectangleTexture,
+				CreateCompressedTexture,
+				UploadTexture2dData,
+				UploadCubeTextureData,
+				UploadCompressedTexture2dData,
+				UploadCompressedCubeTextureData,
+				ActivateMipMapping,
+				DeleteTexture,
+				SetTextureAt,
+				SetSamplerStateAt,
+				CreateProgram,
+				AttachShader,
+				LinkProgram,
+				DeleteProgram,
+				SetProgram,
+				CompileShader,
+				SetShaderSource,
+				CreateVertexShader,
+				DeleteVertexShader,
+				CreateFragmentShader,
+				DeleteFragmentShader,
+				SetBlendingFactors,
+				SetBlendingMode,
+				SetColorMask,
+				SetDepthTest,
+				SetStencilTest,
+				SetScissorTest,
+				SetTriangleCulling,
+				SetRenderToBackBuffer,
+				SetRenderToTexture,
+				GenerateMipmaps,
+				SetUniformFloat,
+				SetUniformFloat2,
+				SetUniformFloat3,
+				SetUniformFloat4,
+				SetUniformMatrix4x4,
+				SetUniformInt,
+				SetUniformInt2,
+				SetUniformInt3,
+				SetUniformInt4,
+
+				NUM_COMMANDS
+			};
+
+		private:
+			typedef std::vector<unsigned char> CommandLog;
+
+		private:
+			bool											_errorsEnabled;
+			bool											_supportsInstancing;
+			std::string										_driverInfo;
+
+			CommandLog										_log;
+			std::vector<uint>								_numCommands;
+			uint											_numFrames;
+
+			uint											_nextResourceId;
+			uint											_currentTarget;
+			uint											_currentProgram;
+			uint											_viewportWidth;
+			uint											_viewportHeight;
+
+			std::unordered_map<uint, std::string>			_shaderSources;
+			std::unordered_map<uint, std::vector<uint>>		_programShaders;
+			std::unordered_set<uint>						_unsignedIntIndexBuffers;
+
+		public:
+			static
+			Ptr
+			create(bool supportsInstancing = false)
+			{
+				return std::shared_ptr<RecordingContext>(new RecordingContext(supportsInstancing));
+			}
+
+			inline
+			const CommandLog&
+			log() const
+			{
+				return _log;
+			}
+
+			uint
+			numCommands() const;
+
+			inline
+			uint
+			numCommands(Command command) const
+			{
+				return _numCommands[static_cast<uint>(command)];
+			}
+
+			inline
+			uint
+			numFrames() const
+			{
+				return _numFrames;
+			}
+
+			// Empties the log and the command counters but keeps track of the living resources,
+			// so that the next frames can be recorded (or replayed) on their own.
+			void
+			clearLog();
+
+			// Parses the uniform and attribute declarations of GLSL sources the same way
+			// a driver would report the active inputs of the linked program.
+			static
+			ProgramInputs
+			parseProgramInputs(const std::vector<std::string>& sources);
+
+			inline
+			bool
+			errorsEnabled() override
+			{
+				return _errorsEnabled;
+			}
+
+			inline
+			void
+			errorsEnabled(bool errorsEnabled) override
+			{
+				_errorsEnabled = errorsEnabled;
+			}
+
+			inline
+			const std::string&
+			driverInfo() override
+			{
+				return _driverInfo;
+			}
+
+			inline
+			uint
+			renderTarget() override
+			{
+				return _currentTarget;
+			}
+
+			inline
+			uint
+			viewportWidth() override
+			{
+				return _viewportWidth;
+			}
+
+			inline
+			uint
+			viewportHeight() override
+			{
+				return _viewportHeight;
+			}
+
+			inline
+			uint
+			currentProgram() override
+			{
+				return _currentProgram;
+			}
+
+			void
+			configureViewport(const uint x,
+							  const uint y,
+							  const uint with,
+							  const uint height) override;
+
+			void
+			clear(float red 	= 0.f,
+				  float green	= 0.f,
+				  float blue	= 0.f,
+				  float alpha	= 0.f,
+				  float depth	= 1.f,
+				  uint stencil	= 0,
+				  uint mask		= 0xffffffff) override;
+
+			void
+			present() override;
+
+			void
+			drawTriangles(const uint indexBuffer, const uint firstIndex, const int numTriangles) override;
+
+			void
+			drawTriangles(const uint firstIndex, const int numTriangles) override;
+
+			void
+			drawTrianglesInstanced(const uint	indexBuffer,
+								   const uint	firstIndex,
+								   const int	numTriangles,
+								   const uint	numInstances) override;
+
+			inline
+			bool
+			supportsInstancing() override
+			{
+				return _supportsInstancing;
+			}
+
+			inline
+			bool
+			supportsUnsignedIntIndices() override
+			{
+				return true;
+			}
+
+			const uint
+			createVertexBuffer(const uint size) override;
+
+			void
+			setVertexBufferAt(const uint	position,
+							  const uint	vertexBuffer,
+							  const uint	size,
+							  const uint	stride,
+							  const uint	offset) override;
+
+			void
+			setVertexAttributeDivisor(const uint position, const uint divisor) override;
+
+			void
+			uploadVertexBufferData(const uint 	vertexBuffer,
+								   const uint 	offset,
+								   const uint 	size,
+								   void* 		data) override;
+
+			void
+			deleteVertexBuffer(const uint vertexBuffer) override;
+
+			const uint
+			createIndexBuffer(const uint size, const bool unsignedIntIndices = false) override;
+
+			void
+			uploaderIndexBufferData(const uint 	indexBuffer,
+									const uint 	offset,
+									const uint 	size,
+									void*		data) override;
+
+			void
+			deleteIndexBuffer(const uint indexBuffer) override;
+
+			uint
+			createTexture(TextureType	type,
+						  uint			width,
+						  uint			height,
+						  bool			mipMapping,
+						  bool			optimizeForRenderToTexture = false) override;
+
+			uint
+			createCompressedTexture(TextureType		type,
+									TextureFormat	format,
+									uint			width,
+									uint			height,
+									bool			mipMapping) override;
+
+			uint
+			createRectangleTexture(TextureType	type,
+								   uint			width,
+								   uint			height) override;
+
+			void
+			uploadTexture2dData(uint	texture,
+								uint 	width,
+								uint 	height,
+								uint 	mipLevel,
+								void*	data) override;
+
+			void
+			uploadCubeTextureData(uint				texture,
+								  CubeTexture::Face face,
+								  uint 				width,
+								  uint 				height,
+								  uint 				mipLevel,
+								  void*				data) override;
+
+			void
+			uploadCompressedTexture2dData(uint			texture,
+										  TextureFormat	format,
+										  uint			width,
+										  uint			height,
+										  uint			size,
+										  uint			mipLevel,
+										  void*			data) override;
+
+			void
+			uploadCompressedCubeTextureData(uint				texture,
+											CubeTexture::Face	face,
+											TextureFormat		format,
+											uint				width,
+											uint				height,
+											uint				mipLevel,
+											void*				data) override;
+
+			void
+			activateMipMapping(uint texture) override;
+
+			void
+			deleteTexture(uint texture) override;
+
+			void
+			setTextureAt(uint	position,
+						 int	texture		= 0,
+						 int	location	= -1) override;
+
+			void
+			setSamplerStateAt(uint			position,
+							  WrapMode		wrapping,
+							  TextureFilter	filtering,
+							  MipFilter		mipFiltering) override;
+
+			const uint
+			createProgram() override;
+
+			void
+			attachShader(const uint program, const uint shader) override;
+
+			void
+			linkProgram(const uint program) override;
+
+			void
+			deleteProgram(const uint program) override;
+
+			void
+			compileShader(const uint shader) override;
+
+			void
+			setProgram(const uint program) override;
+
+			void
+			setShaderSource(const uint shader, const std::string& source) override;
+
+			const uint
+			createVertexShader() override;
+
+			void
+			deleteVertexShader(const uint vertexShader) override;
+
+			const uint
+			createFragmentShader() override;
+
+			void
+			deleteFragmentShader(const uint fragmentShader) override;
+
+			ProgramInputs
+			getProgramInputs(const uint program) override;
+
+			// Binaries are specific to the driver the log is replayed on.
+			inline
+			bool
+			supportsProgramBinaries() override
+			{
+				return false;
+			}
+
+			inline
+			bool
+			getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary) override
+			{
+				return false;
+			}
+
+			inline
+			bool
+			programBinary(const uint program, const uint format, const std::vector<unsigned char>& binary) override
+			{
+				return false;
+			}
+
+			void
+			setBlendingMode(Blending::Source source, Blending::Destination destination) override;
+
+			void
+			setBlendingMode(Blending::Mode blendingMode) override;
+
+			void
+			setDepthTest(bool depthMask, CompareMode depthFunc) override;
+
+			void
+			setColorMask(bool) override;
+
+			void
+			setStencilTest(CompareMode		stencilFunc,
+						   int				stencilRef,
+						   uint				stencilMask,
+						   StencilOperation	stencilFailOp,
+						   StencilOperation	stencilZFailOp,
+						   StencilOperation	stencilZPassOp) override;
+
+			void
+			setScissorTest(bool	scissorTest, const math::ivec4& scissorBox) override;
+
+			void
+			readPixels(uint x, uint y, uint width, uint height, unsigned char* pixels) override;
+
+			void
+			readPixels(unsigned char* pixels) override;
+
+			void
+			setTriangleCulling(TriangleCulling triangleCulling) override;
+
+			void
+			setRenderToBackBuffer() override;
+
+			void
+			setRenderToTexture(uint texture, bool enableDepthAndStencil = false) override;
+
+			void
+			generateMipmaps(uint texture) override;
+
+			void
+			setUniformFloat(uint location, uint count, const float* v) override;
+
+			void
+			setUniformFloat2(uint location, uint count, const float* v) override;
+
+			void
+			setUniformFloat3(uint location, uint count, const float* v) override;
+
+			void
+			setUniformFloat4(uint location, uint count, const float* v) override;
+
+			void
+			setUniformMatrix4x4(uint location, uint count, const float* v) override;
+
+			void
+			setUniformInt(uint location, uint count, const int* v) override;
+
+			void
+			setUniformInt2(uint location, uint count, const int* v) override;
+
+			void
+			setUniformInt3(uint location, uint count, const int* v) override;
+
+			void
+			setUniformInt4(uint location, uint count, const int* v) override;
+
+			int
+			createVertexAttributeArray() override;
+
+			void
+			setVertexAttributeArray(const uint vertexArray) override;
+
+		private:
+			RecordingContext(bool supportsInstancing);
+
+			void
+			write(Command command);
+
+			template <typename T>
+			inline
+			void
+			write(const T& value)
+			{
+				auto offset = _log.size();
+
+				_log.resize(offset + sizeof(T));
+				std::memcpy(&_log[offset], &value, sizeof(T));
+			}
+
+			void
+			writeData(const void* data, uint size);
+
+			void
+			writeUniform(Command command, uint location, uint count, uint numComponents, const void* v);
+		};
+	}
+}
@@ -23,10 +23,6 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/render/AbstractResource.hpp"
 
-#ifdef MINKO_GLSL_OPTIMIZER_ENABLED
-    struct glslopt_ctx;
-#endif
-
 namespace minko
 {
 	namespace render
@@ -47,9 +43,6 @@ namespace minko
 			Type		               _type;
 			std::string                _source;
             std::set<std::string>      _definedMacros;
-#ifdef MINKO_GLSL_OPTIMIZER_ENABLED
-            static const glslopt_ctx*  _glslOptimizer;
-#endif
 
 		public:
 			inline static
@@ -132,6 +125,30 @@ namespace minko
 			void
 			upload();
 
+			// Source actually given to the context: the version directive is added and, when it is
+			// enabled, the GLSL optimizer is run.
+			inline
+			std::string
+			contextSource() const
+			{
+				return contextSource(_type, _source);
+			}
+
+			// Can be called from any thread. Calls to the GLSL optimizer are serialized by a global
+			// lock.
+			static
+			std::string
+			contextSource(Type type, const std::string& source);
+
+			// Number of sources preprocessed so far, for profiling.
+			static
+			uint
+			numContextSources();
+
+			// Uploads a source previously returned by contextSource(), skipping the optimizer.
+			void
+			upload(const std::string& contextSource);
+
 		private:
 			Shader(std::shared_ptr<AbstractContext> context,
 				   Type								type) :
@@ -23,6 +23,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/render/TextureFormat.hpp"
 #include "minko/render/AbstractTexture.hpp"
+#include "minko/render/TextureProcessor.hpp"
 
 namespace minko
 {
@@ -86,6 +87,16 @@ namespace minko
             void
             resize(unsigned int width, unsigned int height, bool resizeSmoothly);
 
+            // Appends every mip level to the base level of an uncompressed texture, replacing the
+            // levels it may already hold. upload() then provides all the levels instead of asking
+            // the context to generate them.
+            void
+            generateMipChain(TextureProcessor::Filter  filter  = TextureProcessor::Filter::BOX,
+                             bool                      srgb    = false);
+
+            bool
+            hasMipChain() const;
+
             void
             dispose();
 
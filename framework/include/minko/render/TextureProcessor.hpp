@@ -0,0 +1,79 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+namespace minko
+{
+	namespace render
+	{
+		// CPU processing of RGBA8 images: resampling and mip chain generation. The rows of the
+		// result are split in tiles processed by the default thread pool, and each pixel is
+		// filtered as a whole with the 4-wide SIMD helpers. When srgb is true, the color channels
+		// are filtered in linear space and encoded back to sRGB, alpha being always linear.
+		class TextureProcessor
+		{
+		public:
+			enum class Filter
+			{
+				NEAREST,	// corner aligned, as resizeData() always did
+				LINEAR,		// corner aligned bilinear interpolation
+				BOX,		// average of the covered pixels, the usual mip filter
+				KAISER		// Kaiser windowed sinc, sharper when downsampling
+			};
+
+		public:
+			// Resizes an RGBA8 image. newData is left empty when one of the new sizes is 0.
+			static
+			void
+			resize(uint							width,
+				   uint							height,
+				   const unsigned char*			data,
+				   uint							newWidth,
+				   uint							newHeight,
+				   Filter						filter,
+				   bool							srgb,
+				   std::vector<unsigned char>&	newData);
+
+			// Number of levels down to 1x1, the base level included.
+			static
+			uint
+			numMipLevels(uint width, uint height);
+
+			// Offset in bytes of a level in a chain built by generateMipChain().
+			static
+			uint
+			mipLevelOffset(uint width, uint height, uint level);
+
+			// Stores the base level followed by every level down to 1x1, each level being half the
+			// size of the previous one and computed from it.
+			static
+			void
+			generateMipChain(uint							width,
+							 uint							height,
+							 const unsigned char*			data,
+							 Filter							filter,
+							 bool							srgb,
+							 std::vector<unsigned char>&	chain);
+		};
+	}
+}
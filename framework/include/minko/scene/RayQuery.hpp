@@ -0,0 +1,113 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+
+#include "minko/scene/Layout.hpp"
+
+namespace minko
+{
+	namespace scene
+	{
+		// Casts batches of rays against the surfaces of a subtree. Each cast() gathers the world
+		// boxes of the surfaces in a hierarchy, then the rays go through it and through the
+		// triangle hierarchies of the geometries by packets of 4, on the threads of the default
+		// pool. The rays of a packet are consecutive in the batch: coherent rays should be too.
+		class RayQuery
+		{
+		public:
+			typedef std::shared_ptr<RayQuery>	Ptr;
+
+			struct Hit
+			{
+				std::shared_ptr<component::Surface>	surface;	// nullptr when nothing is hit
+				float								distance;	// in units of the ray direction
+				uint								triangle;	// first index of the triangle
+			};
+
+		private:
+			std::shared_ptr<Node>									_root;
+			Layout													_layoutMask;
+
+			std::shared_ptr<math::BoundingVolumeHierarchy>			_hierarchy;
+			std::vector<std::shared_ptr<component::Surface>>		_surfaces;
+			std::vector<math::mat4>									_worldToModel;
+			std::vector<math::vec3>									_minBounds;
+			std::vector<math::vec3>									_maxBounds;
+
+		public:
+			// Only the surfaces of nodes with a layout in layoutMask and without
+			// BuiltinLayout::IGNORE_RAYCASTING are hit.
+			inline static
+			Ptr
+			create(std::shared_ptr<Node> root, Layout layoutMask = LayoutMask::EVERYTHING)
+			{
+				return std::shared_ptr<RayQuery>(new RayQuery(root, layoutMask));
+			}
+
+			inline
+			std::shared_ptr<Node>
+			root() const
+			{
+				return _root;
+			}
+
+			inline
+			Layout
+			layoutMask() const
+			{
+				return _layoutMask;
+			}
+
+			inline
+			void
+			layoutMask(Layout value)
+			{
+				_layoutMask = value;
+			}
+
+			// Number of surfaces gathered by the last cast().
+			inline
+			uint
+			numSurfaces() const
+			{
+				return _surfaces.size();
+			}
+
+			// Casts the ray i from origins[i] along directions[i], no farther than maxDistance,
+			// and stores its closest hit in hits[i].
+			void
+			cast(const std::vector<math::vec3>&	origins,
+				 const std::vector<math::vec3>&	directions,
+				 std::vector<Hit>&				hits,
+				 float							maxDistance = std::numeric_limits<float>::infinity());
+
+		private:
+			RayQuery(std::shared_ptr<Node> root, Layout layoutMask);
+
+			void
+			updateSurfaces();
+
+			void
+			castPacket(const math::vec3* origins, const math::vec3* directions, uint numRays, Hit* hits) const;
+		};
+	}
+}
@@ -0,0 +1,370 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/animation/AnimationClip.hpp"
+
+#include "minko/math/Simd.hpp"
+#include "timeline_lookup.hpp"
+
+using namespace minko;
+using namespace minko::animation;
+
+namespace
+{
+	// The 3 smallest components of a unit quaternion are in [-1/sqrt(2), 1/sqrt(2)].
+	const float ROTATION_RANGE	= 1.41421356f;
+	const float ROTATION_MAX	= 32767.f;		// 15 bits, the last bit of 2 components being the index
+	const float QUANTIZED_MAX	= 65535.f;
+
+	enum LaneComponent
+	{
+		RATIO			= 0,
+		ROTATION_0		= 1,
+		ROTATION_1		= 5,
+		TRANSLATION_0	= 9,
+		TRANSLATION_1	= 12,
+		SCALE_0			= 15,
+		SCALE_1			= 18,
+		NUM_COMPONENTS	= 21
+	};
+}
+
+AnimationClip::AnimationClip(uint											duration,
+							 const std::vector<std::vector<uint>>&			timetables,
+							 const std::vector<std::vector<math::mat4>>&	matrices) :
+	_duration(duration),
+	_tracks(),
+	_times(),
+	_rotations(),
+	_translations(),
+	_scales()
+{
+	if (timetables.size() != matrices.size())
+		throw std::logic_error("The number of tracks must match in both the 'timetables' and 'matrices' parameters.");
+
+	_tracks.reserve(timetables.size());
+
+	for (uint trackId = 0; trackId < timetables.size(); ++trackId)
+		addTrack(timetables[trackId], matrices[trackId]);
+}
+
+void
+AnimationClip::addTrack(const std::vector<uint>&		timetable,
+						const std::vector<math::mat4>&	matrices)
+{
+	if (timetable.empty())
+		throw std::invalid_argument("timetable");
+	if (timetable.size() != matrices.size())
+		throw std::logic_error("The number of keys must match in both the 'timetable' and 'matrices' parameters.");
+
+	const uint numKeys = timetable.size();
+	std::vector<uint> order(numKeys);
+
+	for (uint keyId = 0; keyId < numKeys; ++keyId)
+		order[keyId] = keyId;
+
+	std::stable_sort(order.begin(), order.end(), [&](uint a, uint b) { return timetable[a] < timetable[b]; });
+
+	std::vector<math::vec3> translations(numKeys);
+	std::vector<math::quat> rotations(numKeys);
+	std::vector<math::vec3> scales(numKeys);
+
+	for (uint keyId = 0; keyId < numKeys; ++keyId)
+	{
+		const auto& matrix = matrices[order[keyId]];
+		const auto x = math::vec3(matrix[0]);
+		const auto y = math::vec3(matrix[1]);
+		const auto z = math::vec3(matrix[2]);
+		auto scale = math::vec3(math::length(x), math::length(y), math::length(z));
+
+		// mirrored transform
+		if (math::dot(math::cross(x, y), z) < 0.f)
+			scale.x = -scale.x;
+
+		const auto rotation = math::mat3(
+			scale.x != 0.f ? x / scale.x : math::vec3(1.f, 0.f, 0.f),
+			scale.y != 0.f ? y / scale.y : math::vec3(0.f, 1.f, 0.f),
+			scale.z != 0.f ? z / scale.z : math::vec3(0.f, 0.f, 1.f)
+		);
+
+		translations[keyId] = math::vec3(matrix[3]);
+		rotations[keyId] = math::normalize(math::quat_cast(rotation));
+		scales[keyId] = scale;
+	}
+
+	auto computeBounds = [](const std::vector<math::vec3>& values, math::vec3& min, math::vec3& step)
+	{
+		auto max = values[0];
+
+		min = values[0];
+		for (const auto& value : values)
+		{
+			min = math::min(min, value);
+			max = math::max(max, value);
+		}
+
+		step = (max - min) / QUANTIZED_MAX;
+	};
+
+	auto quantize = [](std::array<QuantizedComponents, 3>&	components,
+					   const math::vec3&					value,
+					   const math::vec3&					min,
+					   const math::vec3&					step)
+	{
+		for (auto i = 0; i < 3; ++i)
+			components[i].push_back(step[i] > 0.f
+				? static_cast<unsigned short>(std::min(QUANTIZED_MAX, std::floor((value[i] - min[i]) / step[i] + .5f)))
+				: 0
+			);
+	};
+
+	Track track;
+
+	track.firstKey = _times.size();
+	track.numKeys = numKeys;
+	computeBounds(translations, track.translationMin, track.translationStep);
+	computeBounds(scales, track.scaleMin, track.scaleStep);
+
+	for (uint keyId = 0; keyId < numKeys; ++keyId)
+	{
+		unsigned short rotation[3];
+
+		encodeRotation(rotations[keyId], rotation);
+
+		_times.push_back(timetable[order[keyId]]);
+		for (auto i = 0; i < 3; ++i)
+			_rotations[i].push_back(rotation[i]);
+		quantize(_translations, translations[keyId], track.translationMin, track.translationStep);
+		quantize(_scales, scales[keyId], track.scaleMin, track.scaleStep);
+	}
+
+	_tracks.push_back(track);
+}
+
+void
+AnimationClip::encodeRotation(const math::quat& rotation, unsigned short* components)
+{
+	const float values[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+	uint largest = 0;
+
+	for (uint i = 1; i < 4; ++i)
+		if (std::abs(values[i]) > std::abs(values[largest]))
+			largest = i;
+
+	// q and -q are the same rotation: the largest component is made positive and dropped
+	const auto sign = values[largest] < 0.f ? -1.f : 1.f;
+
+	for (uint i = 0, j = 0; i < 4; ++i)
+	{
+		if (i == largest)
+			continue;
+
+		const auto value = math::clamp(values[i] * sign * ROTATION_RANGE, -1.f, 1.f);
+
+		components[j++] = static_cast<unsigned short>(std::floor((value * .5f + .5f) * ROTATION_MAX + .5f));
+	}
+
+	components[0] |= (largest & 1) << 15;
+	components[1] |= (largest >> 1) << 15;
+}
+
+math::quat
+AnimationClip::decodeRotation(unsigned short a, unsigned short b, unsigned short c)
+{
+	const uint largest = (a >> 15) | ((b >> 15) << 1);
+	const unsigned short components[3] = { a, b, c };
+	float values[4];
+	float sum = 0.f;
+
+	for (uint i = 0, j = 0; i < 4; ++i)
+	{
+		if (i == largest)
+			continue;
+
+		const auto value = ((components[j++] & 0x7fff) / ROTATION_MAX * 2.f - 1.f) / ROTATION_RANGE;
+
+		values[i] = value;
+		sum += value * value;
+	}
+	values[largest] = std::sqrt(std::max(0.f, 1.f - sum));
+
+	return math::quat(values[3], values[0], values[1], values[2]);
+}
+
+uint
+AnimationClip::memorySize() const
+{
+	return _tracks.size() * sizeof(Track) + _times.size() * (sizeof(uint) + 9 * sizeof(unsigned short));
+}
+
+void
+AnimationClip::key(uint			trackId,
+				   uint			keyId,
+				   math::vec3&	translation,
+				   math::quat&	rotation,
+				   math::vec3&	scale) const
+{
+	const auto& track = _tracks[trackId];
+	const auto key = track.firstKey + keyId;
+
+	translation = dequantize(_translations, key, track.translationMin, track.translationStep);
+	rotation = this->rotation(key);
+	scale = dequantize(_scales, key, track.scaleMin, track.scaleStep);
+}
+
+uint
+AnimationClip::findKey(const Track& track, uint time, uint& cursor) const
+{
+	const auto times = &_times[track.firstKey];
+	const auto numKeys = track.numKeys;
+
+	// looped or moved backward
+	if (cursor >= numKeys || times[cursor] > time)
+		cursor = 0;
+
+	if (cursor + 1 < numKeys && times[cursor + 1] <= time)
+	{
+		// more than one key forward: binary search in the remaining keys
+		if (cursor + 2 < numKeys && times[cursor + 2] <= time)
+			cursor = std::upper_bound(times + cursor + 2, times + numKeys, time) - times - 1;
+		else
+			++cursor;
+	}
+
+	return cursor;
+}
+
+void
+AnimationClip::sample(uint time, Cursors& cursors, math::mat4* matrices) const
+{
+	const uint numTracks = _tracks.size();
+	const uint t = getTimeInRange(time, _duration + 1);
+
+	// The keys are located and decoded track by track, then blended and converted to matrices 4
+	// tracks at a time, with one component of the 4 tracks per register.
+	alignas(16) float lanes[NUM_COMPONENTS][4];
+	alignas(16) float result[12][4];
+
+	cursors.resize(numTracks, 0);
+
+	for (uint firstTrackId = 0; firstTrackId < numTracks; firstTrackId += 4)
+	{
+		const uint numLanes = std::min(4u, numTracks - firstTrackId);
+
+		for (uint lane = 0; lane < 4; ++lane)
+		{
+			// the unused lanes repeat the last track
+			const auto trackId = firstTrackId + std::min(lane, numLanes - 1);
+			const auto& track = _tracks[trackId];
+			const auto keyId = findKey(track, t, cursors[trackId]);
+			const auto key0 = track.firstKey + keyId;
+			const auto key1 = track.firstKey + std::min(keyId + 1, track.numKeys - 1);
+			const auto time0 = _times[key0];
+			const auto time1 = _times[key1];
+			// the first and last keys are held before and after the track
+			const auto ratio = t > time0 && time1 > time0 ? (t - time0) / (float)(time1 - time0) : 0.f;
+
+			auto rotation0 = rotation(key0);
+			auto rotation1 = rotation(key1);
+
+			// q and -q are the same rotation: blend in the hemisphere of the first key
+			if (math::dot(rotation0, rotation1) < 0.f)
+				rotation1 = -rotation1;
+
+			const auto translation0 = dequantize(_translations, key0, track.translationMin, track.translationStep);
+			const auto translation1 = dequantize(_translations, key1, track.translationMin, track.translationStep);
+			const auto scale0 = dequantize(_scales, key0, track.scaleMin, track.scaleStep);
+			const auto scale1 = dequantize(_scales, key1, track.scaleMin, track.scaleStep);
+
+			lanes[RATIO][lane] = ratio;
+			for (auto i = 0; i < 4; ++i)
+			{
+				lanes[ROTATION_0 + i][lane] = rotation0[i];
+				lanes[ROTATION_1 + i][lane] = rotation1[i];
+			}
+			for (auto i = 0; i < 3; ++i)
+			{
+				lanes[TRANSLATION_0 + i][lane] = translation0[i];
+				lanes[TRANSLATION_1 + i][lane] = translation1[i];
+				lanes[SCALE_0 + i][lane] = scale0[i];
+				lanes[SCALE_1 + i][lane] = scale1[i];
+			}
+		}
+
+		const auto ratio = math::simd::load(lanes[RATIO]);
+		auto lerp = [&](uint from, uint to)
+		{
+			const auto a = math::simd::load(lanes[from]);
+
+			return math::simd::madd(math::simd::sub(math::simd::load(lanes[to]), a), ratio, a);
+		};
+
+		// glm::quat stores x, y, z then w
+		auto qx = lerp(ROTATION_0, ROTATION_1);
+		auto qy = lerp(ROTATION_0 + 1, ROTATION_1 + 1);
+		auto qz = lerp(ROTATION_0 + 2, ROTATION_1 + 2);
+		auto qw = lerp(ROTATION_0 + 3, ROTATION_1 + 3);
+		const auto length = math::simd::sqrt(math::simd::madd(qx, qx, math::simd::madd(qy, qy,
+			math::simd::madd(qz, qz, math::simd::mul(qw, qw)))));
+
+		qx = math::simd::div(qx, length);
+		qy = math::simd::div(qy, length);
+		qz = math::simd::div(qz, length);
+		qw = math::simd::div(qw, length);
+
+		const auto sx = lerp(SCALE_0, SCALE_1);
+		const auto sy = lerp(SCALE_0 + 1, SCALE_1 + 1);
+		const auto sz = lerp(SCALE_0 + 2, SCALE_1 + 2);
+
+		const auto one = math::simd::splat(1.f);
+		const auto two = math::simd::splat(2.f);
+		const auto xx = math::simd::mul(qx, qx);
+		const auto yy = math::simd::mul(qy, qy);
+		const auto zz = math::simd::mul(qz, qz);
+		const auto xy = math::simd::mul(qx, qy);
+		const auto xz = math::simd::mul(qx, qz);
+		const auto yz = math::simd::mul(qy, qz);
+		const auto wx = math::simd::mul(qw, qx);
+		const auto wy = math::simd::mul(qw, qy);
+		const auto wz = math::simd::mul(qw, qz);
+
+		// rotation * scale, column by column
+		math::simd::store(result[0], math::simd::mul(math::simd::sub(one, math::simd::mul(two, math::simd::add(yy, zz))), sx));
+		math::simd::store(result[1], math::simd::mul(math::simd::mul(two, math::simd::add(xy, wz)), sx));
+		math::simd::store(result[2], math::simd::mul(math::simd::mul(two, math::simd::sub(xz, wy)), sx));
+		math::simd::store(result[3], math::simd::mul(math::simd::mul(two, math::simd::sub(xy, wz)), sy));
+		math::simd::store(result[4], math::simd::mul(math::simd::sub(one, math::simd::mul(two, math::simd::add(xx, zz))), sy));
+		math::simd::store(result[5], math::simd::mul(math::simd::mul(two, math::simd::add(yz, wx)), sy));
+		math::simd::store(result[6], math::simd::mul(math::simd::mul(two, math::simd::add(xz, wy)), sz));
+		math::simd::store(result[7], math::simd::mul(math::simd::mul(two, math::simd::sub(yz, wx)), sz));
+		math::simd::store(result[8], math::simd::mul(math::simd::sub(one, math::simd::mul(two, math::simd::add(xx, yy))), sz));
+		math::simd::store(result[9], lerp(TRANSLATION_0, TRANSLATION_1));
+		math::simd::store(result[10], lerp(TRANSLATION_0 + 1, TRANSLATION_1 + 1));
+		math::simd::store(result[11], lerp(TRANSLATION_0 + 2, TRANSLATION_1 + 2));
+
+		for (uint lane = 0; lane < numLanes; ++lane)
+			matrices[firstTrackId + lane] = math::mat4(
+				result[0][lane], result[1][lane], result[2][lane], 0.f,
+				result[3][lane], result[4][lane], result[5][lane], 0.f,
+				result[6][lane], result[7][lane], result[8][lane], 0.f,
+				result[9][lane], result[10][lane], result[11][lane], 1.f
+			);
+	}
+}
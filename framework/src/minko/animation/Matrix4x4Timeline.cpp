@@ -33,7 +33,8 @@ Matrix4x4Timeline::Matrix4x4Timeline(const std::string& 			propertyName,
 									 bool 							interpolate):
 	AbstractTimeline(propertyName, duration),
 	_matrices(),
-	_interpolate(interpolate)
+	_interpolate(interpolate),
+	_keyCursor(0)
 {
 	initializeMatrixTimetable(timetable, matrices);
 }
@@ -41,7 +42,8 @@ Matrix4x4Timeline::Matrix4x4Timeline(const std::string& 			propertyName,
 Matrix4x4Timeline::Matrix4x4Timeline(const Matrix4x4Timeline& matrix) :
     AbstractTimeline(matrix._propertyName, matrix._duration),
     _matrices(matrix._matrices.size()),
-    _interpolate(matrix._interpolate)
+    _interpolate(matrix._interpolate),
+    _keyCursor(0)
 {
     for (uint keyId = 0; keyId < matrix._matrices.size(); ++keyId)
     {
@@ -100,7 +102,7 @@ Matrix4x4Timeline::update(uint time,
     else
     {
         const uint t = getTimeInRange(time, _duration + 1);
-	    const uint keyId = getIndexForTime(t, _matrices);
+	    const uint keyId = getIndexForTime(t, _matrices, _keyCursor);
 
     	data.set(_propertyName, _matrices[keyId].second);
     }
@@ -110,7 +112,7 @@ math::mat4
 Matrix4x4Timeline::interpolate(uint time) const
 {
     const auto t = getTimeInRange(time, _duration + 1);
-	const auto keyId = getIndexForTime(t, _matrices);
+	const auto keyId = getIndexForTime(t, _matrices, _keyCursor);
 
     // all matrices are sorted in order of increasing time
     if (t < _matrices.front().first || t >= _matrices.back().first)
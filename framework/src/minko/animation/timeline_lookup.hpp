@@ -6,14 +6,20 @@ namespace minko
 {
     namespace animation
     {
+        inline
         uint
         getTimeInRange(int time, uint duration);
 
         template<typename T>
         uint
         getIndexForTime(uint time, const std::vector<std::pair<uint,T>>& timetable);
+
+        template<typename T>
+        uint
+        getIndexForTime(uint time, const std::vector<std::pair<uint,T>>& timetable, uint& cursor);
     }
 
+    inline
     uint
     animation::getTimeInRange(int time, uint duration)
     {
@@ -53,7 +59,27 @@ namespace minko
 
         return lowerId;
     }
-}
 
+    // Same as above, starting from the key found by the previous lookup. Playback moves forward by
+    // less than a key most of the time, so this is O(1) instead of a binary search.
+    template<typename T>
+    uint
+    animation::getIndexForTime(uint time, const std::vector<std::pair<uint,T>>& timetable, uint& cursor)
+    {
+        const uint numKeys = timetable.size();
+        const uint maxSteps = 4;
+
+        if (cursor < numKeys && timetable[cursor].first <= time)
+        {
+            for (uint step = 0; step < maxSteps && cursor + 1 < numKeys && timetable[cursor + 1].first <= time; ++step)
+                ++cursor;
 
+            if (cursor + 1 == numKeys || timetable[cursor + 1].first > time)
+                return cursor;
+        }
 
+        cursor = getIndexForTime(time, timetable);
+
+        return cursor;
+    }
+}
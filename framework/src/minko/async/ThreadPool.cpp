@@ -0,0 +1,251 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/async/ThreadPool.hpp"
+
+using namespace minko;
+using namespace minko::async;
+
+ThreadPool::ThreadPool(uint numThreads) :
+    _jobId(0),
+    _numBusyThreads(0),
+    _stopping(false)
+{
+    _job.task = nullptr;
+    _job.size = 0;
+    _job.chunkSize = 0;
+    _job.numChunks = 0;
+    _job.nextChunk = 0;
+    _job.numDoneChunks = 0;
+
+#if MINKO_PLATFORM != MINKO_PLATFORM_HTML5
+    if (numThreads == 0)
+    {
+        auto numCores = std::thread::hardware_concurrency();
+
+        numThreads = numCores > 1 ? numCores - 1 : 0;
+    }
+
+    for (auto i = 0u; i < numThreads; ++i)
+        _threads.push_back(std::thread(&ThreadPool::run, this));
+#endif
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _stopping = true;
+    }
+
+    _workAvailable.notify_all();
+
+    for (auto& thread : _threads)
+        thread.join();
+}
+
+ThreadPool::Ptr
+ThreadPool::defaultPool()
+{
+    static auto pool = create();
+
+    return pool;
+}
+
+void
+ThreadPool::parallelFor(uint size, uint minChunkSize, const RangeTask& task)
+{
+    if (size == 0)
+        return;
+
+    minChunkSize = std::max(minChunkSize, 1u);
+
+    auto isPoolThread = std::find_if(_threads.begin(), _threads.end(), [](const std::thread& thread)
+    {
+        return thread.get_id() == std::this_thread::get_id();
+    }) != _threads.end();
+
+    std::unique_lock<std::mutex> jobLock(_jobMutex, std::defer_lock);
+
+    if (_threads.empty() || size <= minChunkSize || isPoolThread || !jobLock.try_lock())
+    {
+        task(0, size);
+
+        return;
+    }
+
+    // a few chunks per thread so that a slow thread does not hold the others back
+    const auto numWorkers = static_cast<uint>(_threads.size()) + 1;
+    const auto chunkSize = std::max(minChunkSize, (size + numWorkers * 4 - 1) / (numWorkers * 4));
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _job.task = &task;
+        _job.size = size;
+        _job.chunkSize = chunkSize;
+        _job.numChunks = (size + chunkSize - 1) / chunkSize;
+        _job.nextChunk = 0;
+        _job.numDoneChunks = 0;
+        ++_jobId;
+    }
+
+    _workAvailable.notify_all();
+
+    runChunks();
+
+    // the job lives in the pool, so we wait for the threads to leave it before returning
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    _workDone.wait(lock, [this]()
+    {
+        return _job.numDoneChunks == _job.numChunks && _numBusyThreads == 0;
+    });
+
+    _job.task = nullptr;
+
+    if (_job.exception)
+    {
+        auto exception = _job.exception;
+
+        _job.exception = nullptr;
+        lock.unlock();
+
+        std::rethrow_exception(exception);
+    }
+}
+
+std::future<void>
+ThreadPool::enqueue(const Task& task)
+{
+    std::packaged_task<void()> packagedTask(task);
+    auto future = packagedTask.get_future();
+
+    if (_threads.empty())
+    {
+        packagedTask();
+
+        return future;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        _tasks.push_back(std::move(packagedTask));
+    }
+
+    _workAvailable.notify_one();
+
+    return future;
+}
+
+void
+ThreadPool::runChunks()
+{
+    auto numDoneChunks = 0u;
+
+    while (true)
+    {
+        const auto chunk = _job.nextChunk++;
+
+        if (chunk >= _job.numChunks)
+            break;
+
+        const auto begin = chunk * _job.chunkSize;
+
+        // a failing chunk still counts as done, otherwise parallelFor() would wait forever
+        try
+        {
+            (*_job.task)(begin, std::min(begin + _job.chunkSize, _job.size));
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            if (!_job.exception)
+                _job.exception = std::current_exception();
+        }
+
+        ++numDoneChunks;
+    }
+
+    _job.numDoneChunks += numDoneChunks;
+}
+
+void
+ThreadPool::run()
+{
+    auto lastJobId = 0u;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+
+            _workAvailable.wait(lock, [&]()
+            {
+                return _stopping || (_jobId != lastJobId && _job.task != nullptr) || !_tasks.empty();
+            });
+
+            if (_stopping)
+                return;
+
+            if (_jobId == lastJobId || _job.task == nullptr)
+            {
+                lock.unlock();
+                runTask();
+
+                continue;
+            }
+
+            lastJobId = _jobId;
+            ++_numBusyThreads;
+        }
+
+        runChunks();
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            --_numBusyThreads;
+        }
+
+        _workDone.notify_all();
+    }
+}
+
+void
+ThreadPool::runTask()
+{
+    std::packaged_task<void()> task;
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_tasks.empty())
+            return;
+
+        task = std::move(_tasks.front());
+        _tasks.pop_front();
+    }
+
+    task();
+}
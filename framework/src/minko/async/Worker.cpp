@@ -35,15 +35,15 @@ Worker::Worker(const std::string& name)
 }
 
 void
-Worker::start(const std::vector<char>& input)
+Worker::start(std::vector<char> input)
 {
-    _impl->start(input);
+    _impl->start(std::move(input));
 }
 
 void
 Worker::post(Message message)
 {
-    _impl->post(message);
+    _impl->post(std::move(message));
 }
 
 void
@@ -52,7 +52,13 @@ Worker::poll()
     _impl->poll();
 }
 
-Signal<Worker::Ptr, Worker::Message>::Ptr
+bool
+Worker::finished()
+{
+    return _impl->finished();
+}
+
+Worker::MessageSignal::Ptr
 Worker::message()
 {
     return _impl->message();
@@ -0,0 +1,386 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/ClusteredLighting.hpp"
+
+#include "minko/component/SceneManager.hpp"
+#include "minko/data/Collection.hpp"
+#include "minko/data/Provider.hpp"
+#include "minko/data/Store.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/log/Logger.hpp"
+#include "minko/render/LightClusters.hpp"
+#include "minko/render/Texture.hpp"
+#include "minko/scene/Node.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+const uint ClusteredLighting::LIGHT_SIZE = 8;
+const uint ClusteredLighting::TEXTURE_WIDTH = 256;
+
+namespace
+{
+	// light indices are stored on 16 bits
+	const uint MAX_NUM_LIGHTS = 65536;
+
+	inline
+	void
+	write16(unsigned char* texel, float value)
+	{
+		const auto bits = static_cast<uint>(math::clamp(value, 0.f, 1.f) * 65535.f + .5f);
+
+		texel[0] = static_cast<unsigned char>(bits >> 8);
+		texel[1] = static_cast<unsigned char>(bits & 0xff);
+	}
+
+	inline
+	unsigned char
+	write8(float value)
+	{
+		return static_cast<unsigned char>(math::clamp(value, 0.f, 1.f) * 255.f + .5f);
+	}
+}
+
+ClusteredLighting::ClusteredLighting(uint numClustersX,
+									 uint numClustersY,
+									 uint numClustersZ,
+									 uint maxLightsPerCluster) :
+	AbstractComponent(),
+	_clusters(render::LightClusters::create(numClustersX, numClustersY, numClustersZ, maxLightsPerCluster)),
+	_data(data::Provider::create()),
+	_numPointLights(0),
+	_boundsMin(0.f),
+	_boundsSize(1.f),
+	_intensityScale(1.f),
+	_rangeScale(1.f),
+	_attenuationScale(1.f),
+	_numUnboundedLights(0),
+	_numDroppedEntries(0)
+{
+	// the number of lights of a cluster is stored on 8 bits
+	if (maxLightsPerCluster > 255)
+		throw std::invalid_argument("maxLightsPerCluster");
+
+	_data
+		->set("clusteredLightingMaxLights", static_cast<int>(maxLightsPerCluster))
+		->set("clusteredLightingGrid", math::vec3(numClustersX, numClustersY, numClustersZ));
+}
+
+void
+ClusteredLighting::targetAdded(NodePtr target)
+{
+	if (target->components<ClusteredLighting>().size() > 1)
+		throw std::logic_error("The same camera node cannot have more than one ClusteredLighting.");
+
+	target->data().addProvider(_data);
+
+	if (target->root()->hasComponent<SceneManager>())
+		targetAddedToSceneHandler(nullptr, target, nullptr);
+	else
+	{
+		_addedToSceneSlot = target->added().connect(
+			[this](NodePtr node, NodePtr target, NodePtr ancestor)
+			{
+				targetAddedToSceneHandler(node, target, ancestor);
+			}
+		);
+	}
+}
+
+void
+ClusteredLighting::targetRemoved(NodePtr target)
+{
+	target->data().removeProvider(_data);
+
+	_addedToSceneSlot = nullptr;
+	_renderingBeginSlot = nullptr;
+	_clustersTexture = nullptr;
+	_indicesTexture = nullptr;
+	_lightsTexture = nullptr;
+	_lights.clear();
+	_spheres.clear();
+	_numUnboundedLights = 0;
+	_numDroppedEntries = 0;
+}
+
+void
+ClusteredLighting::targetAddedToSceneHandler(NodePtr node, NodePtr target, NodePtr ancestor)
+{
+	auto sceneManager = target->root()->component<SceneManager>();
+
+	if (!sceneManager)
+		return;
+
+	_addedToSceneSlot = nullptr;
+
+	// after the transforms, and thus the lights and the camera, are updated
+	_renderingBeginSlot = sceneManager->renderingBegin()->connect(
+		[this](SceneManager::Ptr sm, uint frameId, render::AbstractTexture::Ptr renderTarget)
+		{
+			update();
+		},
+		-1.f
+	);
+}
+
+void
+ClusteredLighting::update()
+{
+	auto& cameraData = target()->data();
+
+	if (!cameraData.hasProperty("viewMatrix") || !cameraData.hasProperty("projectionMatrix"))
+		return;
+
+	auto sceneManager = target()->root()->component<SceneManager>();
+
+	collectLights();
+
+	_clusters->update(
+		cameraData.get<math::mat4>("viewMatrix"),
+		cameraData.get<math::mat4>("projectionMatrix"),
+		_spheres
+	);
+
+	// the lights missing from the full clusters are not lit, warn once when it starts happening
+	if (_clusters->numDroppedEntries() != 0 && _numDroppedEntries == 0)
+		LOG_WARNING("Some clusters reach more than " << _clusters->maxLightsPerCluster() << " lights: "
+			<< "the extra lights are ignored. Give the lights a smaller range() or increase maxLightsPerCluster.");
+	_numDroppedEntries = _clusters->numDroppedEntries();
+
+	uploadLights(sceneManager);
+	uploadClusters(sceneManager);
+}
+
+void
+ClusteredLighting::collectLights()
+{
+	data::Collection::Ptr pointLights;
+	data::Collection::Ptr spotLights;
+
+	for (auto collection : target()->root()->data().collections())
+	{
+		if (*collection->name() == "pointLight")
+			pointLights = collection;
+		else if (*collection->name() == "spotLight")
+			spotLights = collection;
+	}
+
+	_lights.clear();
+	if (pointLights)
+		_lights.insert(_lights.end(), pointLights->items().begin(), pointLights->items().end());
+	_numPointLights = _lights.size();
+	if (spotLights)
+		_lights.insert(_lights.end(), spotLights->items().begin(), spotLights->items().end());
+	if (_lights.size() > MAX_NUM_LIGHTS)
+		_lights.resize(MAX_NUM_LIGHTS);
+	_numPointLights = std::min<uint>(_numPointLights, _lights.size());
+
+	// quantization ranges of the light data
+	auto boundsMin = math::vec3(std::numeric_limits<float>::max());
+	auto boundsMax = math::vec3(-std::numeric_limits<float>::max());
+
+	auto numUnboundedLights = 0u;
+
+	_intensityScale = 1e-6f;
+	_rangeScale = 1e-6f;
+	_attenuationScale = 1e-6f;
+	for (auto light : _lights)
+	{
+		const auto& position = light->get<math::vec3>("position");
+		const auto& attenuation = light->get<math::vec3>("attenuationCoeffs");
+
+		boundsMin = math::min(boundsMin, position);
+		boundsMax = math::max(boundsMax, position);
+		_intensityScale = std::max(_intensityScale, std::max(light->get<float>("diffuse"), light->get<float>("specular")));
+		_rangeScale = std::max(_rangeScale, light->get<float>("range"));
+		if (math::all(math::greaterThanEqual(attenuation, math::vec3(0.f))))
+			_attenuationScale = std::max(_attenuationScale, std::max(attenuation.x, std::max(attenuation.y, attenuation.z)));
+		if (light->get<float>("range") <= 0.f)
+			++numUnboundedLights;
+	}
+
+	// the attenuation of Phong.effect does not reach 0 at a finite distance in general, no range
+	// can be derived from it: lights without a range reach every cluster and fill their lists
+	if (numUnboundedLights > _numUnboundedLights)
+		LOG_WARNING(numUnboundedLights << " lights have no range(): they are added to every cluster.");
+	_numUnboundedLights = numUnboundedLights;
+
+	_boundsMin = _lights.empty() ? math::vec3(0.f) : boundsMin;
+	_boundsSize = _lights.empty() ? math::vec3(1.f) : math::max(boundsMax - boundsMin, math::vec3(1e-3f));
+
+	// the spheres are padded by the quantization error of the positions and the ranges read by
+	// the shaders
+	const auto padding = (math::length(_boundsSize) + _rangeScale) / 65535.f;
+
+	_spheres.resize(_lights.size());
+	for (auto i = 0u; i < _lights.size(); ++i)
+	{
+		const auto& light = _lights[i];
+		const auto& position = light->get<math::vec3>("position");
+		const auto range = light->get<float>("range");
+
+		if (range <= 0.f)
+			_spheres[i] = math::vec4(position, -1.f);
+		else if (i < _numPointLights)
+			_spheres[i] = math::vec4(position, range + padding);
+		else
+		{
+			// bounding sphere of the cone
+			const auto& direction = light->get<math::vec3>("direction");
+			const auto cosOuter = light->get<float>("cosOuterConeAngle");
+
+			if (cosOuter < std::sqrt(.5f))
+				_spheres[i] = math::vec4(position + direction * cosOuter * range, std::sqrt(1.f - cosOuter * cosOuter) * range + padding);
+			else
+				_spheres[i] = math::vec4(position + direction * (.5f * range / cosOuter), .5f * range / cosOuter + padding);
+		}
+	}
+}
+
+void
+ClusteredLighting::uploadLights(SceneMngrPtr sceneManager)
+{
+	// 16 bits values, in the [0, 1] range of their quantization bounds:
+	// 0: position.x, position.y
+	// 1: position.z, range (0 when unbounded)
+	// 2: color (8 bits per channel), flags (8 bits, 1 for spot lights + 2 for attenuated lights)
+	// 3: diffuse, specular
+	// 4: direction.x, direction.y
+	// 5: direction.z, cos(outer cone angle)
+	// 6: cos(inner cone angle), attenuation constant
+	// 7: attenuation linear, attenuation quadratic
+	auto texture = reserveTexture(
+		sceneManager, _lightsTexture, std::max<uint>(_lights.size(), 1) * LIGHT_SIZE, "clusteredLightingLights"
+	);
+	auto& textureData = texture->data();
+
+	for (auto i = 0u; i < _lights.size(); ++i)
+	{
+		const auto& light = _lights[i];
+		auto texel = &textureData[i * LIGHT_SIZE * 4];
+		const auto position = (light->get<math::vec3>("position") - _boundsMin) / _boundsSize;
+		const auto range = light->get<float>("range");
+		const auto& color = light->get<math::vec3>("color");
+		const auto& attenuation = light->get<math::vec3>("attenuationCoeffs");
+		const auto attenuated = math::all(math::greaterThanEqual(attenuation, math::vec3(0.f)));
+
+		write16(texel, position.x);
+		write16(texel + 2, position.y);
+		write16(texel + 4, position.z);
+		// a bounded range must not be rounded to 0, which stands for unbounded lights
+		write16(texel + 6, range <= 0.f ? 0.f : std::max(range / _rangeScale, 1.f / 65535.f));
+		texel[8] = write8(color.r);
+		texel[9] = write8(color.g);
+		texel[10] = write8(color.b);
+		texel[11] = static_cast<unsigned char>(((i < _numPointLights ? 0 : 1) + (attenuated ? 2 : 0)) * 85);
+		write16(texel + 12, light->get<float>("diffuse") / _intensityScale);
+		write16(texel + 14, light->get<float>("specular") / _intensityScale);
+
+		if (i >= _numPointLights)
+		{
+			const auto& direction = light->get<math::vec3>("direction");
+
+			write16(texel + 16, direction.x * .5f + .5f);
+			write16(texel + 18, direction.y * .5f + .5f);
+			write16(texel + 20, direction.z * .5f + .5f);
+			write16(texel + 22, light->get<float>("cosOuterConeAngle"));
+			write16(texel + 24, light->get<float>("cosInnerConeAngle"));
+		}
+
+		if (attenuated)
+		{
+			write16(texel + 26, attenuation.x / _attenuationScale);
+			write16(texel + 28, attenuation.y / _attenuationScale);
+			write16(texel + 30, attenuation.z / _attenuationScale);
+		}
+	}
+
+	texture->upload();
+
+	_data
+		->set("clusteredLightingBoundsMin", _boundsMin)
+		->set("clusteredLightingBoundsSize", _boundsSize)
+		->set("clusteredLightingScales", math::vec3(_intensityScale, _rangeScale, _attenuationScale));
+}
+
+void
+ClusteredLighting::uploadClusters(SceneMngrPtr sceneManager)
+{
+	const auto& offsets = _clusters->offsets();
+	const auto& counts = _clusters->counts();
+	const auto& lightIndices = _clusters->lightIndices();
+
+	// one texel per cluster: 24 bits offset in the light indices and 8 bits count
+	auto clustersTexture = reserveTexture(
+		sceneManager, _clustersTexture, _clusters->numClusters(), "clusteredLightingClusters"
+	);
+	auto& clustersData = clustersTexture->data();
+
+	for (auto cluster = 0u; cluster < _clusters->numClusters(); ++cluster)
+	{
+		auto texel = &clustersData[cluster * 4];
+
+		texel[0] = static_cast<unsigned char>(offsets[cluster] >> 16);
+		texel[1] = static_cast<unsigned char>((offsets[cluster] >> 8) & 0xff);
+		texel[2] = static_cast<unsigned char>(offsets[cluster] & 0xff);
+		texel[3] = static_cast<unsigned char>(counts[cluster]);
+	}
+
+	clustersTexture->upload();
+
+	// two 16 bits light indices per texel
+	auto indicesTexture = reserveTexture(
+		sceneManager, _indicesTexture, std::max<uint>((lightIndices.size() + 1) / 2, 1), "clusteredLightingIndices"
+	);
+	auto& indicesData = indicesTexture->data();
+
+	for (auto i = 0u; i < lightIndices.size(); ++i)
+	{
+		indicesData[i * 2] = static_cast<unsigned char>(lightIndices[i] >> 8);
+		indicesData[i * 2 + 1] = static_cast<unsigned char>(lightIndices[i] & 0xff);
+	}
+
+	indicesTexture->upload();
+
+	_data->set("clusteredLightingDepth", math::vec2(_clusters->zNear(), _clusters->depthScale()));
+}
+
+ClusteredLighting::TexturePtr
+ClusteredLighting::reserveTexture(SceneMngrPtr			sceneManager,
+								  TexturePtr&			texture,
+								  uint					numTexels,
+								  const std::string&	propertyName)
+{
+	// the textures only grow, to avoid reallocations when the number of lights changes
+	const auto height = math::clp2((numTexels + TEXTURE_WIDTH - 1) / TEXTURE_WIDTH);
+
+	if (texture == nullptr || texture->height() < height)
+	{
+		texture = render::Texture::create(sceneManager->assets()->context(), TEXTURE_WIDTH, height, false, false, false);
+		texture->data().resize(TEXTURE_WIDTH * height * 4, 0);
+
+		_data
+			->set(propertyName, texture->sampler())
+			->set(propertyName + "Size", math::vec2(TEXTURE_WIDTH, height));
+	}
+
+	return texture;
+}
@@ -24,7 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/math/Frustum.hpp"
 #include "minko/scene/NodeSet.hpp"
 #include "minko/scene/Layout.hpp"
-#include "minko/math/OctTree.hpp"
+#include "minko/math/BoundingVolumeHierarchy.hpp"
 #include "minko/component/PerspectiveCamera.hpp"
 #include "minko/component/SceneManager.hpp"
 #include "minko/component/Surface.hpp"
@@ -34,14 +34,37 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace minko::component;
 
+namespace
+{
+    inline
+    bool
+    getBit(const std::vector<uint32_t>& bits, uint index)
+    {
+        return (bits[index >> 5] & (1u << (index & 31))) != 0u;
+    }
+
+    inline
+    void
+    setBit(std::vector<uint32_t>& bits, uint index, bool value)
+    {
+        if (value)
+            bits[index >> 5] |= 1u << (index & 31);
+        else
+            bits[index >> 5] &= ~(1u << (index & 31));
+    }
+}
+
 Culling::Culling(ShapePtr shape, const std::string& bindProperty, scene::Layout layout) :
     AbstractComponent(),
-    _frustum(shape),
+    _layout(layout),
+    _invalidHierarchy(false),
     _bindProperty(bindProperty),
-    _worldSize(50.f),
-    _maxDepth(7u),
-    _layout(layout)
+    _frustum(std::dynamic_pointer_cast<math::Frustum>(shape)),
+    _updateNextFrame(true)
 {
+    // the hierarchy is only tested against the planes of a frustum
+    if (_frustum == nullptr)
+        throw std::invalid_argument("shape");
 }
 
 void
@@ -50,8 +73,8 @@ Culling::targetAdded(NodePtr target)
     if (target->components<Culling>().size() > 1)
         throw std::logic_error("The same camera node cannot have more than one Culling.");
 
-    if (_octTree == nullptr)
-        _octTree = math::OctTree::create(worldSize(), maxDepth(), math::vec3(0.f));
+    if (_bvh == nullptr)
+        _bvh = math::BoundingVolumeHierarchy::create();
     
     if (target->root()->hasComponent<SceneManager>())
         targetAddedToSceneHandler(nullptr, target, nullptr);
@@ -80,10 +103,21 @@ Culling::targetRemoved(NodePtr target)
     _removedSlot            = nullptr;
     _layoutChangedSlot      = nullptr;
     _renderingBeginSlot     = nullptr;
-    _octTree                = nullptr;
+    _bvh                    = nullptr;
     _addedToSceneSlot       = nullptr;
     _viewMatrixChangedSlot  = nullptr;
-    _renderingBeginSlot     = nullptr;
+
+    _nodes.clear();
+    _boundingBoxes.clear();
+    _minBounds.clear();
+    _maxBounds.clear();
+    _modelToWorldChangedSlots.clear();
+    _nodeToItemId.clear();
+    _movedItems.clear();
+    _visibleItems.clear();
+    _newVisibleItems.clear();
+    _invalidVisibility.clear();
+    _invalidHierarchy = false;
 }
 
 void
@@ -120,35 +154,8 @@ Culling::targetAddedToSceneHandler(NodePtr node, NodePtr target, NodePtr ancesto
         _renderingBeginSlot = sceneManager->renderingBegin()->connect(
             [this](SceneManager::Ptr sm, uint fid, render::AbstractTexture::Ptr rt)
             {
-                if (_updateNextFrame)
-                {
-                    _frustum->updateFromMatrix(this->target()->data().get<math::mat4>(_bindProperty));
-
-                    _octTree->testFrustum(
-                        _frustum,
-                        [&](NodePtr node)
-                        {
-                            auto layout = node->layout();
-
-                            if ((layout & scene::BuiltinLayout::HIDDEN) == 0u)
-                                layout = layout | scene::BuiltinLayout::DEFAULT;
-                            layout = layout | scene::BuiltinLayout::INSIDE_FRUSTUM;
-
-                            node->layout(layout);
-                        },
-                        [&](NodePtr node)
-                        {
-                            auto layout = node->layout();
-
-                            layout = layout & ~scene::BuiltinLayout::DEFAULT;
-                            layout = layout & ~scene::BuiltinLayout::INSIDE_FRUSTUM;
-
-                            node->layout(layout);
-                        }
-                    );
-
-                    _updateNextFrame = false;
-                }
+                if (_updateNextFrame || _invalidHierarchy || !_movedItems.empty())
+                    updateVisibility();
             },
             -1.f
         );
@@ -164,12 +171,11 @@ Culling::addedHandler(NodePtr node, NodePtr target, NodePtr ancestor)
         ->descendants(true)
         ->where([&](NodePtr descendant)
         {
-            return (descendant->layout() & scene::BuiltinLayout::IGNORE_CULLING) == 0
-                && descendant->hasComponent<Surface>();
+            return isCulled(descendant);
         });
 
     for (auto n : nodeSet->nodes())
-        _octTree->insert(n);
+        addNode(n);
 }
 
 void
@@ -177,21 +183,178 @@ Culling::removedHandler(NodePtr node, NodePtr target, NodePtr ancestor)
 {
     auto nodeSet = scene::NodeSet::create(target)
         ->descendants(true)
-        ->where([](NodePtr descendant)
-    {
-        return (descendant->layout() & scene::BuiltinLayout::IGNORE_CULLING) == 0
-            && descendant->hasComponent<Surface>();
-    });
+        ->where([this](NodePtr descendant)
+        {
+            return _nodeToItemId.count(descendant) != 0;
+        });
 
     for (auto nodeToRemove : nodeSet->nodes())
-        _octTree->remove(nodeToRemove);
+        removeNode(nodeToRemove);
 }
 
 void
 Culling::layoutChangedHandler(NodePtr node, NodePtr target)
 {
-    if ((target->layout() & scene::BuiltinLayout::IGNORE_CULLING) == 0)
-        _octTree->insert(target);
-    else
-        _octTree->remove(target);
-}
\ No newline at end of file
+    // our own layout updates end up here as well: only changes of IGNORE_CULLING matter
+    if (_nodeToItemId.count(target) != 0)
+    {
+        if ((target->layout() & scene::BuiltinLayout::IGNORE_CULLING) != 0)
+            removeNode(target);
+    }
+    else if (isCulled(target))
+        addNode(target);
+}
+
+bool
+Culling::isCulled(NodePtr node) const
+{
+    return (node->layout() & scene::BuiltinLayout::IGNORE_CULLING) == 0
+        && node->hasComponent<Surface>()
+        && node->hasComponent<BoundingBox>();
+}
+
+void
+Culling::addNode(NodePtr node)
+{
+    if (_nodeToItemId.count(node) != 0)
+        return;
+
+    const uint itemId = _nodes.size();
+    const uint numWords = (itemId >> 5) + 1;
+
+    _nodeToItemId[node] = itemId;
+    _nodes.push_back(node);
+    _boundingBoxes.push_back(node->component<BoundingBox>());
+    _minBounds.push_back(math::vec3(0.f));
+    _maxBounds.push_back(math::vec3(0.f));
+    _modelToWorldChangedSlots.push_back(node->data().propertyChanged("modelToWorldMatrix").connect(
+        [this, node](data::Store&, data::Provider::Ptr, const data::Provider::PropertyName&)
+        {
+            _movedItems.push_back(_nodeToItemId[node]);
+        }
+    ));
+
+    _visibleItems.resize(numWords, 0u);
+    _invalidVisibility.resize(numWords, 0u);
+    setBit(_invalidVisibility, itemId, true);
+
+    _invalidHierarchy = true;
+}
+
+void
+Culling::removeNode(NodePtr node)
+{
+    auto itemIt = _nodeToItemId.find(node);
+
+    if (itemIt == _nodeToItemId.end())
+        return;
+
+    // the last item takes the place of the removed one so that ids remain dense
+    const auto itemId = itemIt->second;
+    const uint lastItemId = _nodes.size() - 1;
+
+    _nodeToItemId.erase(itemIt);
+
+    if (itemId != lastItemId)
+    {
+        _nodes[itemId] = _nodes[lastItemId];
+        _boundingBoxes[itemId] = _boundingBoxes[lastItemId];
+        _modelToWorldChangedSlots[itemId] = _modelToWorldChangedSlots[lastItemId];
+        setBit(_visibleItems, itemId, getBit(_visibleItems, lastItemId));
+        setBit(_invalidVisibility, itemId, getBit(_invalidVisibility, lastItemId));
+        _nodeToItemId[_nodes[itemId]] = itemId;
+    }
+
+    _nodes.pop_back();
+    _boundingBoxes.pop_back();
+    _minBounds.pop_back();
+    _maxBounds.pop_back();
+    _modelToWorldChangedSlots.pop_back();
+    setBit(_visibleItems, lastItemId, false);
+    setBit(_invalidVisibility, lastItemId, false);
+
+    _invalidHierarchy = true;
+}
+
+void
+Culling::updateBounds(uint itemId)
+{
+    auto box = _boundingBoxes[itemId]->box();
+
+    _minBounds[itemId] = box->bottomLeft();
+    _maxBounds[itemId] = box->topRight();
+}
+
+void
+Culling::updateVisibility()
+{
+    _frustum->updateFromMatrix(target()->data().get<math::mat4>(_bindProperty));
+
+    // topology changes rebuild the hierarchy, moves only refit it
+    if (_invalidHierarchy)
+    {
+        for (uint itemId = 0; itemId < _nodes.size(); ++itemId)
+            updateBounds(itemId);
+
+        _bvh->build(_minBounds, _maxBounds);
+    }
+    else if (!_movedItems.empty())
+    {
+        for (auto itemId : _movedItems)
+            updateBounds(itemId);
+
+        _bvh->refit(_minBounds, _maxBounds);
+    }
+
+    _movedItems.clear();
+    _invalidHierarchy = false;
+    _updateNextFrame = false;
+
+    _bvh->testPlanes(_frustum->planes(), _newVisibleItems);
+
+    _visibleItems.resize(_newVisibleItems.size(), 0u);
+    _invalidVisibility.resize(_newVisibleItems.size(), 0u);
+
+    // only the nodes whose visibility changed get a new layout, once the bitsets are up to
+    // date since setting a layout can add or remove culled nodes
+    auto changedNodes = std::vector<std::pair<NodePtr, bool>>();
+
+    for (uint wordId = 0; wordId < _newVisibleItems.size(); ++wordId)
+    {
+        auto changed = (_newVisibleItems[wordId] ^ _visibleItems[wordId]) | _invalidVisibility[wordId];
+
+        while (changed != 0u)
+        {
+            const auto bit = math::countTrailingZeros(changed);
+
+            changedNodes.push_back(std::make_pair(
+                _nodes[(wordId << 5) + bit],
+                (_newVisibleItems[wordId] & (1u << bit)) != 0u
+            ));
+            changed &= changed - 1u;
+        }
+    }
+
+    _visibleItems.swap(_newVisibleItems);
+    std::fill(_invalidVisibility.begin(), _invalidVisibility.end(), 0u);
+
+    for (const auto& changedNode : changedNodes)
+    {
+        auto node = changedNode.first;
+        auto layout = node->layout();
+
+        if (changedNode.second)
+        {
+            if ((layout & scene::BuiltinLayout::HIDDEN) == 0u)
+                layout = layout | scene::BuiltinLayout::DEFAULT;
+            layout = layout | scene::BuiltinLayout::INSIDE_FRUSTUM;
+        }
+        else
+        {
+            layout = layout & ~scene::BuiltinLayout::DEFAULT;
+            layout = layout & ~scene::BuiltinLayout::INSIDE_FRUSTUM;
+        }
+
+        node->layout(layout);
+    }
+}
@@ -31,34 +31,45 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/data/Provider.hpp"
 #include "minko/AbstractCanvas.hpp"
 #include "minko/math/Ray.hpp"
+#include "minko/math/BoundingVolumeHierarchy.hpp"
+#include "minko/component/Transform.hpp"
+#include "minko/geometry/Geometry.hpp"
 
 using namespace minko;
 using namespace component;
 
 Picking::Picking() :
+    _mode(PickingMode::RENDER),
     _sceneManager(nullptr),
-    _context(nullptr),
     _mouse(nullptr),
     _touch(nullptr),
     _camera(nullptr),
-    _pickingId(0),
     _pickingProjection(1.f),
+    _pickingId(0),
+    _context(nullptr),
     _pickingProvider(data::Provider::create()),
     _pickingEffect(nullptr),
     _pickingDepthEffect(nullptr),
-	_mouseMove(Signal<NodePtr>::create()),
-	_mouseLeftClick(Signal<NodePtr>::create()),
-	_mouseRightClick(Signal<NodePtr>::create()),
-	_mouseLeftDown(Signal<NodePtr>::create()),
+    _sceneHierarchy(math::BoundingVolumeHierarchy::create()),
+    _sceneHierarchyInvalid(true),
+    _rayCastValid(false),
+    _rayCastX(0),
+    _rayCastY(0),
+    _rayCastSurface(nullptr),
+    _frameBeginSlot(nullptr),
+	_mouseOver(Signal<NodePtr>::create()),
 	_mouseRightDown(Signal<NodePtr>::create()),
-	_mouseLeftUp(Signal<NodePtr>::create()),
+	_mouseLeftDown(Signal<NodePtr>::create()),
 	_mouseRightUp(Signal<NodePtr>::create()),
+	_mouseLeftUp(Signal<NodePtr>::create()),
+	_mouseRightClick(Signal<NodePtr>::create()),
+	_mouseLeftClick(Signal<NodePtr>::create()),
 	_mouseOut(Signal<NodePtr>::create()),
-	_mouseOver(Signal<NodePtr>::create()),
+	_mouseMove(Signal<NodePtr>::create()),
     _mouseWheel(Signal<NodePtr>::create()),
     _touchDown(Signal<NodePtr>::create()),
-    _touchMove(Signal<NodePtr>::create()),
     _touchUp(Signal<NodePtr>::create()),
+    _touchMove(Signal<NodePtr>::create()),
     _tap(Signal<NodePtr>::create()),
     _doubleTap(Signal<NodePtr>::create()),
     _longHold(Signal<NodePtr>::create()),
@@ -66,7 +77,6 @@ Picking::Picking() :
     _lastMergingMask(0),
     _addPickingLayout(true),
     _emulateMouseWithTouch(true),
-    _frameBeginSlot(nullptr),
     _enabled(false),
     _renderDepth(true),
     _debug(false)
@@ -78,8 +88,10 @@ Picking::initialize(NodePtr             camera,
                     bool                addPickingLayout, 
                     bool                emulateMouseWithTouch,
                     EffectPtr           pickingEffect, 
-                    EffectPtr           pickingDepthEffect)
+                    EffectPtr           pickingDepthEffect,
+                    PickingMode         mode)
 {
+    _mode = mode;
     _camera = camera;
     _addPickingLayout = addPickingLayout;
     _emulateMouseWithTouch = emulateMouseWithTouch;
@@ -241,7 +253,49 @@ Picking::targetAdded(NodePtr target)
     _context = canvas->context();
 
     bindSignals();
-    
+
+	// ray casting needs neither the picking renderers nor their effects
+	if (_mode == PickingMode::RENDER)
+		createRenderers();
+
+	updateDescendants(target);
+
+	_addedSlot = target->added().connect(std::bind(
+		&Picking::addedHandler,
+		std::static_pointer_cast<Picking>(shared_from_this()),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	_removedSlot = target->removed().connect(std::bind(
+		&Picking::removedHandler,
+		std::static_pointer_cast<Picking>(shared_from_this()),
+		std::placeholders::_1,
+		std::placeholders::_2,
+		std::placeholders::_3
+	));
+
+	if (target->parent() != nullptr || target->hasComponent<SceneManager>())
+		addedHandler(target, target, target->parent());
+
+	if (_mode == PickingMode::RENDER)
+	{
+		target->addComponent(_renderer);
+		target->addComponent(_depthRenderer);
+	}
+
+	auto perspectiveCamera = _camera->component<component::PerspectiveCamera>();
+
+	target->data().addProvider(_pickingProvider);
+	target->data().addProvider(perspectiveCamera->data());
+
+	addSurfacesForNode(target);
+}
+
+void
+Picking::createRenderers()
+{
     if (_pickingEffect == nullptr)
         _pickingEffect = _sceneManager->assets()->effect("effect/Picking.effect");
         
@@ -275,37 +329,6 @@ Picking::targetAdded(NodePtr target)
     _depthRenderer->scissorBox(0, 0, 1, 1);
     _depthRenderer->layoutMask(scene::BuiltinLayout::PICKING_DEPTH);
     _depthRenderer->enabled(false);
-
-	updateDescendants(target);
-
-	_addedSlot = target->added().connect(std::bind(
-		&Picking::addedHandler,
-		std::static_pointer_cast<Picking>(shared_from_this()),
-		std::placeholders::_1,
-		std::placeholders::_2,
-		std::placeholders::_3
-	));
-
-	_removedSlot = target->removed().connect(std::bind(
-		&Picking::removedHandler,
-		std::static_pointer_cast<Picking>(shared_from_this()),
-		std::placeholders::_1,
-		std::placeholders::_2,
-		std::placeholders::_3
-	));
-
-	if (target->parent() != nullptr || target->hasComponent<SceneManager>())
-		addedHandler(target, target, target->parent());
-
-	target->addComponent(_renderer);
-    target->addComponent(_depthRenderer);
-
-	auto perspectiveCamera = _camera->component<component::PerspectiveCamera>();
-
-	target->data().addProvider(_pickingProvider);
-	target->data().addProvider(perspectiveCamera->data());
-
-	addSurfacesForNode(target);
 }
 
 void
@@ -334,31 +357,34 @@ Picking::addedHandler(NodePtr target, NodePtr child, NodePtr parent)
 	if (std::find(_descendants.begin(), _descendants.end(), child) == _descendants.end())
 		return;
 
-	if (child == target && _renderingBeginSlot == nullptr)
+	if (child == target && _componentAddedSlot == nullptr)
 	{
-		_renderingBeginSlot = _renderer->renderingBegin()->connect(std::bind(
-			&Picking::renderingBegin,
-			std::static_pointer_cast<Picking>(shared_from_this()),
-			std::placeholders::_1
-        ));
-
-		_renderingEndSlot = _renderer->beforePresent()->connect(std::bind(
-			&Picking::renderingEnd,
-			std::static_pointer_cast<Picking>(shared_from_this()),
-			std::placeholders::_1
-        ));
-
-		_depthRenderingBeginSlot = _depthRenderer->renderingBegin()->connect(std::bind(
-			&Picking::depthRenderingBegin,
-			std::static_pointer_cast<Picking>(shared_from_this()),
-			std::placeholders::_1
-        ));
-
-		_depthRenderingEndSlot = _depthRenderer->beforePresent()->connect(std::bind(
-			&Picking::depthRenderingEnd,
-			std::static_pointer_cast<Picking>(shared_from_this()),
-			std::placeholders::_1
-        ));
+		if (_mode == PickingMode::RENDER)
+		{
+			_renderingBeginSlot = _renderer->renderingBegin()->connect(std::bind(
+				&Picking::renderingBegin,
+				std::static_pointer_cast<Picking>(shared_from_this()),
+				std::placeholders::_1
+			));
+
+			_renderingEndSlot = _renderer->beforePresent()->connect(std::bind(
+				&Picking::renderingEnd,
+				std::static_pointer_cast<Picking>(shared_from_this()),
+				std::placeholders::_1
+			));
+
+			_depthRenderingBeginSlot = _depthRenderer->renderingBegin()->connect(std::bind(
+				&Picking::depthRenderingBegin,
+				std::static_pointer_cast<Picking>(shared_from_this()),
+				std::placeholders::_1
+			));
+
+			_depthRenderingEndSlot = _depthRenderer->beforePresent()->connect(std::bind(
+				&Picking::depthRenderingEnd,
+				std::static_pointer_cast<Picking>(shared_from_this()),
+				std::placeholders::_1
+			));
+		}
 
 		_componentAddedSlot = child->componentAdded().connect(std::bind(
 			&Picking::componentAddedHandler,
@@ -434,6 +460,8 @@ Picking::addSurface(SurfacePtr surface)
             surface->target()->layout(target()->layout() | scene::BuiltinLayout::PICKING);
 
         surface->layoutMask(surface->layoutMask() & ~scene::BuiltinLayout::PICKING_DEPTH);
+
+        _sceneHierarchyInvalid = true;
 	}
 }
 
@@ -449,6 +477,8 @@ Picking::removeSurface(SurfacePtr surface, NodePtr node)
 
 	_surfaceToPickingId.erase(surface);
 	_pickingIdToSurface.erase(surfacePickingId);
+
+    _sceneHierarchyInvalid = true;
 }
 
 void
@@ -530,6 +560,13 @@ Picking::enabled(bool enabled)
 void
 Picking::frameBeginHandler(SceneManagerPtr, float, float)
 {
+    if (_mode == PickingMode::RAY_CAST)
+    {
+        rayCast();
+
+        return;
+    }
+
     if (_debug)
         return;
 
@@ -677,6 +714,139 @@ Picking::updatePickingOrigin()
     _pickingProvider->set("pickingOrigin", pickingRay->origin());
 }
 
+static
+void
+transformBox(const math::mat4& matrix, math::vec3& minBound, math::vec3& maxBound)
+{
+    const auto center = math::vec3(matrix * math::vec4((minBound + maxBound) * .5f, 1.f));
+    const auto halfSize = (maxBound - minBound) * .5f;
+    auto extent = math::vec3(0.f);
+
+    for (auto i = 0; i < 3; ++i)
+        extent += math::abs(math::vec3(matrix[i])) * halfSize[i];
+
+    minBound = center - extent;
+    maxBound = center + extent;
+}
+
+static
+math::mat4
+modelToWorldMatrix(scene::Node::Ptr node)
+{
+    auto transform = node->component<Transform>();
+
+    return transform ? transform->modelToWorldMatrix() : math::mat4(1.f);
+}
+
+void
+Picking::updateSceneHierarchy()
+{
+    if (_sceneHierarchyInvalid)
+    {
+        _rayCastSurfaces.clear();
+        for (const auto& surfaceAndId : _surfaceToPickingId)
+            _rayCastSurfaces.push_back(surfaceAndId.first);
+
+        _rayCastMinBounds.resize(_rayCastSurfaces.size());
+        _rayCastMaxBounds.resize(_rayCastSurfaces.size());
+    }
+
+    for (uint i = 0; i < _rayCastSurfaces.size(); ++i)
+    {
+        auto geometry = _rayCastSurfaces[i]->geometry();
+        auto& minBound = _rayCastMinBounds[i];
+        auto& maxBound = _rayCastMaxBounds[i];
+
+        // surfaces that cannot be hit get an empty box, always missed by the rays
+        minBound = math::vec3(std::numeric_limits<float>::max());
+        maxBound = math::vec3(-std::numeric_limits<float>::max());
+
+        if (!geometry || !geometry->indices() || !geometry->vertexBuffer("position"))
+            continue;
+
+        geometry->triangleHierarchy()->bounds(minBound, maxBound);
+
+        if (minBound.x <= maxBound.x)
+            transformBox(modelToWorldMatrix(_rayCastSurfaces[i]->target()), minBound, maxBound);
+    }
+
+    // the topology only changes with the surfaces: moving them is a refit
+    if (_sceneHierarchyInvalid)
+        _sceneHierarchy->build(_rayCastMinBounds, _rayCastMaxBounds);
+    else
+        _sceneHierarchy->refit(_rayCastMinBounds, _rayCastMaxBounds);
+
+    _sceneHierarchyInvalid = false;
+}
+
+void
+Picking::rayCast()
+{
+    const auto x = _mouse->x();
+    const auto y = _mouse->y();
+
+    // the picked surface only has to be searched for again when the pointer moves
+    if (!_rayCastValid || _sceneHierarchyInvalid || x != _rayCastX || y != _rayCastY)
+    {
+        updateSceneHierarchy();
+
+        auto perspectiveCamera = _camera->component<component::PerspectiveCamera>();
+        auto ray = perspectiveCamera->unproject(_mouse->normalizedX(), _mouse->normalizedY());
+        const auto origin = ray->origin();
+        const auto direction = ray->direction();
+        auto localRay = math::Ray::create();
+        auto distance = std::numeric_limits<float>::infinity();
+        uint surfaceId = 0;
+
+        auto intersectSurface = [&](uint itemId, float& maxDistance) -> bool
+        {
+            auto surface = _rayCastSurfaces[itemId];
+            auto node = surface->target();
+
+            if ((node->layout() & surface->layoutMask() & scene::BuiltinLayout::PICKING) == 0 ||
+                (node->layout() & scene::BuiltinLayout::HIDDEN) != 0)
+                return false;
+
+            const auto modelToWorld = modelToWorldMatrix(node);
+            const auto worldToModel = math::inverse(modelToWorld);
+            auto localDistance = 0.f;
+            uint triangle = 0;
+            auto localHit = math::vec3();
+
+            localRay->origin(math::vec3(worldToModel * math::vec4(origin, 1.f)));
+            localRay->direction(math::mat3(worldToModel) * direction);
+
+            if (!surface->geometry()->cast(localRay, localDistance, triangle, &localHit))
+                return false;
+
+            // the hit distance is measured in world space, as the depth of the PICKING_DEPTH pass
+            const auto hitDistance = math::distance(origin, math::vec3(modelToWorld * math::vec4(localHit, 1.f)));
+
+            if (hitDistance >= maxDistance)
+                return false;
+
+            maxDistance = hitDistance;
+
+            return true;
+        };
+
+        if (_sceneHierarchy->castRay(origin, direction, distance, surfaceId, intersectSurface))
+        {
+            _rayCastSurface = _rayCastSurfaces[surfaceId];
+            _lastDepthValue = std::min(distance, _camera->data().get<float>("zFar"));
+            _lastMergingMask = 0;
+        }
+        else
+            _rayCastSurface = nullptr;
+
+        _rayCastValid = true;
+        _rayCastX = x;
+        _rayCastY = y;
+    }
+
+    dispatchEvents(_rayCastSurface, _lastDepthValue);
+}
+
 void
 Picking::dispatchEvents(SurfacePtr pickedSurface, float depth)
 {
@@ -32,7 +32,9 @@ PointLight::PointLight(float diffuse,
 	_attenuationCoeffs(math::vec3(attenuationConstant, attenuationLinear, attenuationQuadratic)),
 	_worldPosition(math::vec3(0.f))
 {
-	data()->set("attenuationCoeffs", _attenuationCoeffs);
+	data()
+		->set("attenuationCoeffs", _attenuationCoeffs)
+		->set("range", -1.f);
     updateModelToWorldMatrix(math::mat4(1.f));
 }
 
@@ -40,6 +42,7 @@ PointLight::PointLight(const PointLight& pointLight, const CloneOption& option)
 	AbstractDiscreteLight("pointLights", pointLight.diffuse(), pointLight.specular()),
 	_attenuationCoeffs(pointLight.attenuationCoefficients())
 {
+	data()->set("range", pointLight.range());
     updateModelToWorldMatrix(math::mat4(1.f));
 }
 
@@ -77,6 +80,20 @@ PointLight::attenuationCoefficients(const math::vec3& value)
 	return std::static_pointer_cast<PointLight>(shared_from_this());
 }
 
+float
+PointLight::range() const
+{
+	return data()->get<float>("range");
+}
+
+PointLight::Ptr
+PointLight::range(float value)
+{
+	data()->set("range", value);
+
+	return std::static_pointer_cast<PointLight>(shared_from_this());
+}
+
 bool
 PointLight::attenuationEnabled() const
 {
@@ -70,7 +70,13 @@ Renderer::Renderer(std::shared_ptr<render::AbstractTexture> renderTarget,
 	_lightMaskFilter(data::LightMaskFilter::create()),*/
 	_filterChanged(Signal<Ptr, data::AbstractFilter::Ptr, data::Binding::Source, SurfacePtr>::create()),
 	_numDrawCalls(0),
-	_numTriangles(0)
+	_numTriangles(0),
+	_minimizeStateChanges(false),
+	_numStateChanges(0),
+	_numSkippedStateChanges(0),
+	_instancing(false),
+	_instancingData(nullptr),
+	_instanceBuffer(nullptr)
 {
 }
 
@@ -148,6 +154,61 @@ Renderer::initializePostProcessingGeometry()
 	target()->data().addProvider(p);
 }
 
+void
+Renderer::instancing(bool value)
+{
+	if (value == _instancing)
+		return;
+
+	_instancing = value;
+
+	if (!_sceneManager)
+		return;
+
+	if (_instancing)
+		initializeInstancing();
+	else
+		disposeInstancing();
+}
+
+void
+Renderer::initializeInstancing()
+{
+	auto context = _sceneManager->assets()->context();
+
+	if (!context->supportsInstancing())
+		return;
+
+	// the model to world matrices are packed in a single vertex buffer, one column per attribute;
+	// the buffer is never replaced since the draw calls keep pointers to its attributes
+	if (!_instanceBuffer)
+	{
+		_instanceBuffer = render::VertexBuffer::create(context);
+		_instanceBuffer->addAttribute("instanceModelToWorld0", 4);
+		_instanceBuffer->addAttribute("instanceModelToWorld1", 4);
+		_instanceBuffer->addAttribute("instanceModelToWorld2", 4);
+		_instanceBuffer->addAttribute("instanceModelToWorld3", 4);
+	}
+
+	_instancingData = data::Provider::create();
+	for (const auto& attribute : _instanceBuffer->attributes())
+		_instancingData->set(attribute.name, attribute);
+	// enables the MODEL_TO_WORLD_INSTANCED macro
+	_instancingData->set("instancing", true);
+
+	target()->data().addProvider(_instancingData);
+}
+
+void
+Renderer::disposeInstancing()
+{
+	if (!_instancingData)
+		return;
+
+	target()->data().removeProvider(_instancingData);
+	_instancingData = nullptr;
+}
+
 void
 Renderer::targetAdded(std::shared_ptr<Node> target)
 {
@@ -471,21 +532,57 @@ Renderer::render(render::AbstractContext::Ptr	context,
 
     _mustZSort = false;
 
+	if (_instanceBuffer)
+	{
+		auto numInstances = _drawCallPool.packInstances(_instanceData);
+
+		if (numInstances != 0)
+		{
+			auto& bufferData = _instanceBuffer->data();
+
+			// grow the buffer by re-creating it since uploads can only update existing data
+			if (_instanceData.size() > bufferData.size())
+			{
+				auto size = std::max(_instanceData.size(), 2 * bufferData.size());
+
+				_instanceBuffer->dispose();
+				bufferData.assign(_instanceData.begin(), _instanceData.end());
+				bufferData.resize(size);
+				_instanceBuffer->upload();
+			}
+			else
+				_instanceBuffer->upload(0, numInstances, _instanceData);
+		}
+	}
+
     const auto& drawCalls = _drawCallPool.drawCalls();
 
 	_numDrawCalls = 0;
 	_numTriangles = 0;
-    for (const auto& priorityToDrawCalls : drawCalls)
-        for (const auto& drawCalls : priorityToDrawCalls.second)
-            for (auto drawCall : drawCalls)
-			{
-				if (drawCall->enabled())
-				{
-	                drawCall->render(context, rt, _viewportBox, _backgroundColor);
-					++_numDrawCalls;
-					_numTriangles += drawCall->numTriangles();
-				}
-			}
+
+    render::DrawCall::StateChanges stateChanges;
+    const render::DrawCall* previousDrawCall = nullptr;
+
+    for (auto drawCall : drawCalls)
+    {
+        // draw calls without a program are waiting for their first one to be linked
+        if (drawCall->program() == nullptr)
+            continue;
+
+        // instances are rendered by the leader of their group
+        if (drawCall->instanced() ? drawCall->numInstances() != 0 : drawCall->enabled())
+        {
+            drawCall->render(context, rt, _viewportBox, _backgroundColor, previousDrawCall, stateChanges);
+            ++_numDrawCalls;
+            _numTriangles += drawCall->numTriangles() * (drawCall->instanced() ? drawCall->numInstances() : 1);
+
+            if (_minimizeStateChanges)
+                previousDrawCall = drawCall;
+        }
+    }
+
+    _numStateChanges = stateChanges.issued;
+    _numSkippedStateChanges = stateChanges.skipped;
 
     _beforePresent->execute(std::static_pointer_cast<Renderer>(shared_from_this()));
 
@@ -550,6 +647,9 @@ Renderer::setSceneManager(std::shared_ptr<SceneManager> sceneManager)
 			), _priority);
 
 			initializePostProcessingGeometry();
+
+			if (_instancing)
+				initializeInstancing();
 		}
 		else
 		{
@@ -561,6 +661,8 @@ Renderer::setSceneManager(std::shared_ptr<SceneManager> sceneManager)
 				target()->data().removeProvider(_postProcessingGeom->data(), Surface::GEOMETRY_COLLECTION_NAME);
 				_postProcessingGeom = nullptr;
 			}
+
+			disposeInstancing();
 		}
 	}
 }
@@ -740,20 +842,18 @@ Renderer::enableDrawCalls(SurfacePtr surface, bool enabled)
 
     const auto drawCallId = drawCallIt->second;
 
-    for (const auto& priorityToDrawCalls : _drawCallPool.drawCalls())
-        for (const auto& drawCalls : priorityToDrawCalls.second)
-            for (auto drawCall : drawCalls)
-            {
-                // FIXME: we don't enable/disable draw calls for deffered passes (ie draw calls
-                // with multiple batch IDs) despite it could lead to useless deferred passes.
-                // But it would require an (de)activation counter which is "very unlikely" to
-                // be equal to batchIDs.size.
-                if (drawCall->batchIDs().size() > 1u)
-                    continue;
-
-                if (drawCall->batchIDs().front() == drawCallId)
-                    drawCall->enabled(enabled);
-            }
+    for (auto drawCall : _drawCallPool.drawCalls())
+    {
+        // FIXME: we don't enable/disable draw calls for deffered passes (ie draw calls
+        // with multiple batch IDs) despite it could lead to useless deferred passes.
+        // But it would require an (de)activation counter which is "very unlikely" to
+        // be equal to batchIDs.size.
+        if (drawCall->batchIDs().size() > 1u)
+            continue;
+
+        if (drawCall->batchIDs().front() == drawCallId)
+            drawCall->enabled(enabled);
+    }
 }
 
 void
@@ -32,6 +32,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include <minko/component/MasterAnimation.hpp>
 #include <minko/component/Animation.hpp>
 #include <minko/component/Transform.hpp>
+#include <minko/async/ThreadPool.hpp>
 
 using namespace minko;
 using namespace minko::data;
@@ -43,6 +44,7 @@ using namespace minko::render;
 /*static*/ const unsigned int	Skinning::MAX_NUM_BONES_PER_VERTEX	= 8;
 /*static*/ const std::string	Skinning::PNAME_NUM_BONES			= "numBones";
 /*static*/ const std::string	Skinning::PNAME_BONE_MATRICES		= "boneMatrices";
+/*static*/ const std::string	Skinning::PNAME_SKINNING_PALETTE	= "skinningPalette";
 /*static*/ const std::string	Skinning::ATTRNAME_POSITION			= "position";
 /*static*/ const std::string	Skinning::ATTRNAME_NORMAL			= "normal";
 /*static*/ const std::string	Skinning::ATTRNAME_BONE_IDS_A		= "boneIdsA";
@@ -55,17 +57,24 @@ Skinning::Skinning(const Skin::Ptr						skin,
 				   AbstractContext::Ptr					context,
 				   Node::Ptr							skeletonRoot,
 				   bool									moveTargetBelowRoot,
-				   bool									isLooping):
+				   bool									isLooping,
+				   SkinningPalette						palette):
 	AbstractAnimation(isLooping),
 	_skin(skin),
 	_context(context),
 	_method(method),
+	_palette(palette),
 	_skeletonRoot(skeletonRoot),
 	_moveTargetBelowRoot(moveTargetBelowRoot),
 	_boneVertexBuffer(nullptr),
 	_targetGeometry(),
 	_targetInputPositions(),
 	_targetInputNormals(),
+	_targetFrameIds(),
+	_bonePalette(),
+	_bonePaletteFrameId(-1),
+	_firstSkinnedVertexId(0),
+	_lastSkinnedVertexId(0),
 	_targetAddedSlot(nullptr)
 {
 }
@@ -75,12 +84,18 @@ Skinning::Skinning(const Skinning& skinning, const CloneOption& option) :
 	_skin(),
 	_context(skinning._context),
 	_method(skinning._method),
+	_palette(skinning._palette),
 	_skeletonRoot(skinning._skeletonRoot),
 	_moveTargetBelowRoot(skinning._moveTargetBelowRoot),
 	_boneVertexBuffer(nullptr),
 	_targetGeometry(),
 	_targetInputPositions(),
 	_targetInputNormals(),
+	_targetFrameIds(),
+	_bonePalette(),
+	_bonePaletteFrameId(-1),
+	_firstSkinnedVertexId(0),
+	_lastSkinnedVertexId(0),
 	_targetAddedSlot(nullptr)
 {	
 	_skin = skinning._skin->clone();
@@ -127,6 +142,15 @@ Skinning::initialize()
 		? nullptr 
 		: createVertexBufferForBones();
 
+	_firstSkinnedVertexId = _skin->numVertices();
+	_lastSkinnedVertexId = 0;
+	for (uint vId = 0; vId < _skin->numVertices(); ++vId)
+		if (_skin->numVertexBones(vId) != 0)
+		{
+			_firstSkinnedVertexId = std::min(_firstSkinnedVertexId, vId);
+			_lastSkinnedVertexId = vId + 1;
+		}
+
 	_maxTime = _skin->duration();
 
 	setPlaybackWindow(0, _maxTime)->seek(0);
@@ -154,6 +178,7 @@ Skinning::addedHandler(Node::Ptr node, Node::Ptr target, Node::Ptr parent)
 		{
 			_targetGeometry[node]			= geometry;
 			_targetInputPositions[node]		= geometry->vertexBuffer(ATTRNAME_POSITION)->data();			
+			_targetFrameIds[node]			= -1;
 
 			if (geometry->hasVertexAttribute(ATTRNAME_NORMAL)
 				&& geometry->vertexBuffer(ATTRNAME_NORMAL)->numVertices() == _skin->numVertices())
@@ -163,8 +188,7 @@ Skinning::addedHandler(Node::Ptr node, Node::Ptr target, Node::Ptr parent)
 			{
 				geometry->addVertexBuffer(_boneVertexBuffer);
 
-                geometry->data()->set(PNAME_BONE_MATRICES, std::vector<math::mat4>());
-				geometry->data()->set<int>(PNAME_NUM_BONES, 0);
+				initializeBonePalette(geometry);
 			}
 		}
 	}
@@ -184,6 +208,7 @@ Skinning::removedHandler(Node::Ptr node, Node::Ptr target, Node::Ptr parent)
 			geometry->removeVertexBuffer(_boneVertexBuffer);
 			geometry->data()->unset(PNAME_BONE_MATRICES);
 			geometry->data()->unset(PNAME_NUM_BONES);
+			geometry->data()->unset(PNAME_SKINNING_PALETTE);
 		}
 
 		_targetGeometry.erase(target);
@@ -192,6 +217,7 @@ Skinning::removedHandler(Node::Ptr node, Node::Ptr target, Node::Ptr parent)
 		_targetInputPositions.erase(target);
 	if (_targetInputNormals.count(target) > 0)
 		_targetInputNormals.erase(target);
+	_targetFrameIds.erase(target);
 }
 
 VertexBuffer::Ptr
@@ -257,102 +283,148 @@ Skinning::updateFrame(unsigned int frameId, Node::Ptr target)
 	assert(frameId < _skin->numFrames());
 
 	auto& geometry = _targetGeometry[target];
-	const std::vector<math::mat4>&	boneMatrices = _skin->matrices(frameId);
 
 	if (_method == SkinningMethod::HARDWARE)
 	{
-		if (!geometry->data()->hasProperty(PNAME_NUM_BONES) ||
-			geometry->data()->get<int>(PNAME_NUM_BONES) != _skin->numBones())
+		auto& targetFrameId = _targetFrameIds[target];
+
+		if (targetFrameId != static_cast<int>(frameId))
+		{
+			targetFrameId = frameId;
+			updateBonePalette(geometry, frameId);
+		}
+
+		if (geometry->data()->get<int>(PNAME_NUM_BONES) != _skin->numBones())
 			geometry->data()->set<int>(PNAME_NUM_BONES, _skin->numBones());
-	
-        geometry->data()->set(PNAME_BONE_MATRICES, boneMatrices);
-        geometry->data()->set<int>(PNAME_NUM_BONES, _skin->numBones());
 	}
 	else
-		performSoftwareSkinning(target, boneMatrices);
+		performSoftwareSkinning(target, frameId);
 }
 
 void
-Skinning::performSoftwareSkinning(Node::Ptr					        target, 
-								  const std::vector<math::mat4>&	boneMatrices)
+Skinning::initializeBonePalette(Geometry::Ptr geometry)
 {
-#ifdef DEBUG_SKINNING
-	assert(target && _targetGeometry.count(target) > 0 && _targetInputPositions.count(target) > 0);
-#endif //DEBUG_SKINNING
-	
-	auto geometry = _targetGeometry[target];
+	auto data = geometry->data();
+	const auto numBones = _skin->numBones();
 
-	// transform positions
-	auto xyzBuffer = geometry->vertexBuffer(ATTRNAME_POSITION);
-    const auto& xyzAttr = xyzBuffer->attribute(ATTRNAME_POSITION);
+	// the palette is allocated once with its final size: draw calls keep a pointer to it
+	// and updateBonePalette() writes each frame in place
+	if (_palette == SkinningPalette::MATRIX_4X4)
+		data->set(PNAME_BONE_MATRICES, std::vector<math::mat4>(numBones));
+	else
+		data->set(
+			PNAME_BONE_MATRICES,
+			std::vector<math::vec4>(numBones * (_palette == SkinningPalette::MATRIX_3X4 ? 3 : 2))
+		);
 
-	performSoftwareSkinning(xyzAttr, xyzBuffer, _targetInputPositions[target], boneMatrices, false);
+	data->set<int>(PNAME_SKINNING_PALETTE, static_cast<int>(_palette));
+	data->set<int>(PNAME_NUM_BONES, 0);
+}
 
-	// transform normals
-	if (geometry->hasVertexAttribute(ATTRNAME_NORMAL) && _targetInputNormals.count(target) > 0)
-	{
-		auto normalBuffer = geometry->vertexBuffer(ATTRNAME_NORMAL);
-        const auto&	normalAttr = normalBuffer->attribute(ATTRNAME_NORMAL);
+void
+Skinning::updateBonePalette(Geometry::Ptr geometry, uint frameId)
+{
+	const auto& boneMatrices = _skin->matrices(frameId);
+	auto data = geometry->data();
 
-		performSoftwareSkinning(normalAttr, normalBuffer, _targetInputNormals[target], boneMatrices, true);
+	// no copy of the matrices nor change signal: uniforms are read from the property
+	// storage when the draw calls are rendered
+	switch (_palette)
+	{
+	case SkinningPalette::MATRIX_4X4:
+		std::copy(
+			boneMatrices.begin(),
+			boneMatrices.end(),
+			data->getUnsafePointer<std::vector<math::mat4>>(PNAME_BONE_MATRICES)->begin()
+		);
+		break;
+	case SkinningPalette::MATRIX_3X4:
+		Skin::computeBonePalette(
+			boneMatrices,
+			math::value_ptr(data->getUnsafePointer<std::vector<math::vec4>>(PNAME_BONE_MATRICES)->front())
+		);
+		break;
+	case SkinningPalette::DUAL_QUATERNION:
+		Skin::computeDualQuaternionPalette(
+			boneMatrices,
+			math::value_ptr(data->getUnsafePointer<std::vector<math::vec4>>(PNAME_BONE_MATRICES)->front())
+		);
+		break;
 	}
 }
 
 void
-Skinning::performSoftwareSkinning(const VertexAttribute&		 attr,
-								  VertexBuffer::Ptr				 vertexBuffer, 
-								  const std::vector<float>&		 inputData,
-								  const std::vector<math::mat4>& boneMatrices,
-								  bool							 doDeltaTransform)
+Skinning::performSoftwareSkinning(Node::Ptr target, uint frameId)
 {
 #ifdef DEBUG_SKINNING
-	assert(vertexBuffer && vertexBuffer->data().size() == inputData.size());
-	assert(attr && std::get<1>(*attr) == 3);
-	assert(boneMatrices.size() == (_skin->numBones() << 4));
-#endif // DEBUG_SKINNING
+	assert(target && _targetGeometry.count(target) > 0 && _targetInputPositions.count(target) > 0);
+#endif //DEBUG_SKINNING
 
-	const unsigned int vertexSize = vertexBuffer->vertexSize();
-	std::vector<float>&	outputData = vertexBuffer->data();
-	const unsigned int numVertices = outputData.size() / vertexSize;
-	
-#ifdef DEBUG_SKINNING
-	assert(numVertices == _skin->numVertices());
-#endif // DEBUG_SKINNING
+	auto& targetFrameId = _targetFrameIds[target];
 
-	unsigned int index = attr.offset;
-	for (unsigned int vId = 0; vId < numVertices; ++vId)
+	if (targetFrameId == static_cast<int>(frameId) || _firstSkinnedVertexId >= _lastSkinnedVertexId)
+		return;
+
+	targetFrameId = frameId;
+
+	if (_bonePaletteFrameId != static_cast<int>(frameId))
 	{
-        math::vec4 v1 = math::vec4(inputData[index], inputData[index + 1], inputData[index + 2], 1.f);
-        math::vec4 v2 = math::vec4(0.f);
+		geometry::Skin::computeBonePalette(_skin->matrices(frameId), _bonePalette);
+		_bonePaletteFrameId = frameId;
+	}
 
-		const unsigned int numVertexBones = _skin->numVertexBones(vId);
-		for (unsigned int j = 0; j < numVertexBones; ++j)
-		{
-			unsigned int boneId = 0;
-			float boneWeight = 0.0f;
+	auto geometry = _targetGeometry[target];
+	auto xyzBuffer = geometry->vertexBuffer(ATTRNAME_POSITION);
+	const auto& xyzAttr = xyzBuffer->attribute(ATTRNAME_POSITION);
+	const auto& inputPositions = _targetInputPositions[target];
 
-			_skin->vertexBoneData(vId, j, boneId, boneWeight);
+	VertexBuffer::Ptr normalBuffer = nullptr;
+	const float* inputNormals = nullptr;
+	float* outputNormals = nullptr;
 
-            const math::mat4& boneMatrix = (boneMatrices[boneId]);
+	if (geometry->hasVertexAttribute(ATTRNAME_NORMAL) && _targetInputNormals.count(target) > 0)
+	{
+		normalBuffer = geometry->vertexBuffer(ATTRNAME_NORMAL);
+		inputNormals = _targetInputNormals[target].data() + normalBuffer->attribute(ATTRNAME_NORMAL).offset;
+		outputNormals = normalBuffer->data().data() + normalBuffer->attribute(ATTRNAME_NORMAL).offset;
+	}
 
-			if (!doDeltaTransform)
-			{
-                v2 += boneWeight * (boneMatrix * v1);
-			}
-			else
-			{
-                v2 += math::vec4(boneWeight * (math::mat3(boneMatrix)) * math::vec3(v1), 0.f);
-			}
+	const float* inputXyz = inputPositions.data() + xyzAttr.offset;
+	float* outputXyz = xyzBuffer->data().data() + xyzAttr.offset;
+	const uint xyzStride = xyzBuffer->vertexSize();
+	const uint normalStride = normalBuffer ? normalBuffer->vertexSize() : 0;
+	const uint firstVertexId = _firstSkinnedVertexId;
+	const auto& skin = *_skin;
+	const auto& palette = _bonePalette;
+
+	// positions and normals are skinned together, by chunks of vertices spread over the pool
+	async::ThreadPool::defaultPool()->parallelFor(
+		_lastSkinnedVertexId - _firstSkinnedVertexId,
+		256,
+		[&](uint begin, uint end)
+		{
+			skin.skinVertices(
+				palette,
+				firstVertexId + begin,
+				firstVertexId + end,
+				inputXyz,
+				outputXyz,
+				xyzStride,
+				inputNormals,
+				outputNormals,
+				normalStride
+			);
 		}
+	);
 
-		outputData[index] = v2.x;
-		outputData[index+1]	= v2.y;
-		outputData[index+2]	= v2.z;
+	const auto numSkinnedVertices = _lastSkinnedVertexId - _firstSkinnedVertexId;
 
-		index += vertexSize;
-	}
+	xyzBuffer->upload(_firstSkinnedVertexId, numSkinnedVertices);
+	if (normalBuffer != nullptr && normalBuffer != xyzBuffer)
+		normalBuffer->upload(_firstSkinnedVertexId, numSkinnedVertices);
 
-	vertexBuffer->upload();
+	// ray casts must see the skinned positions
+	geometry->invalidateTriangleHierarchy();
 }
 
 void
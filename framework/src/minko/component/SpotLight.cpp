@@ -36,6 +36,7 @@ SpotLight::SpotLight(float diffuse,
     attenuationCoefficients(math::vec3(attenuationConstant, attenuationLinear, attenuationQuadratic));
 	innerConeAngle(innerAngleRadians);
 	outerConeAngle(outerAngleRadians);
+	range(-1.f);
 }
 
 SpotLight::SpotLight(const SpotLight& spotlight, const CloneOption& option) :
@@ -48,6 +49,7 @@ SpotLight::SpotLight(const SpotLight& spotlight, const CloneOption& option) :
 	data()->set("attenuationCoeffs", spotlight.attenuationCoefficients());
 	data()->set("cosInnerConeAngle", spotlight.innerConeAngle());
 	data()->set("cosOuterConeAngle", spotlight.outerConeAngle());
+	data()->set("range", spotlight.range());
 }
 
 AbstractComponent::Ptr
@@ -120,6 +122,20 @@ SpotLight::attenuationCoefficients(const math::vec3& value)
 	return *this;
 }
 
+float
+SpotLight::range() const
+{
+	return data()->get<float>("range");
+}
+
+SpotLight&
+SpotLight::range(float value)
+{
+	data()->set("range", value);
+
+	return *this;
+}
+
 bool
 SpotLight::attenuationEnabled() const
 {
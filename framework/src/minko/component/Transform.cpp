@@ -33,7 +33,7 @@ Transform::Transform() :
     _modelToWorld(nullptr),
 //	_worldToModel(1.),
 	_data(data::Provider::create()),
-    _dirty(false)
+    _id(-1)
 {
 	_data
 		->set<math::mat4>("matrix", 			math::mat4(1.f))
@@ -84,15 +84,10 @@ Transform::targetRemoved(scene::Node::Ptr target)
 	_removedSlot = nullptr;
 }
 
-Transform::RootTransform::NodeTransformCacheEntry::NodeTransformCacheEntry() :
-    _node(nullptr),
-    _matrix(nullptr),
-    _modelToWorldMatrix(nullptr),
-    _parentId(-1),
-    _firstChildId(-1),
-    _numChildren(0),
-    _dirty(true),
-    _provider(nullptr)
+Transform::RootTransform::RootTransform() :
+    AbstractComponent(),
+    _invalidLists(false),
+    _matricesChanged(MatricesChangedSignal::create())
 {
 }
 
@@ -171,15 +166,8 @@ Transform::RootTransform::componentAddedHandler(scene::Node::Ptr		node,
     {
         if (std::dynamic_pointer_cast<Transform>(ctrl) != nullptr)
         {
-            auto removeIt = std::find(_toRemove.begin(), _toRemove.end(), target);
-
-            if (removeIt != _toRemove.end())
-                _toRemove.erase(removeIt);
-            else
-            {
-                _toAdd.push_back(target);
-                _invalidLists = true;
-            }
+            _toAdd.push_back(target);
+            _invalidLists = true;
         }
     }
 }
@@ -195,17 +183,12 @@ Transform::RootTransform::componentRemovedHandler(scene::Node::Ptr			node,
 		_renderingBeginSlot = nullptr;
     else
     {
-        if (std::dynamic_pointer_cast<Transform>(ctrl) != nullptr)
-        {
-            auto addIt = std::find(_toAdd.begin(), _toAdd.end(), target);
+        auto transform = std::dynamic_pointer_cast<Transform>(ctrl);
 
-            if (addIt != _toAdd.end())
-                _toAdd.erase(addIt);
-            else
-            {
-                _toRemove.push_back(target);
-                _invalidLists = true;
-            }
+        if (transform != nullptr)
+        {
+            _toAdd.remove(target);
+            removeTransform(*transform);
         }
     }
 }
@@ -219,16 +202,21 @@ Transform::RootTransform::addedHandler(scene::Node::Ptr node,
     {
         auto otherRoot = target->component<RootTransform>();
 
-        if (otherRoot != nullptr)
+        // The other root lists might be stale or incomplete (a subtree that was removed from
+        // its root does not have a RootTransform anymore until a Transform is added to it), so we
+        // always collect the nodes from the added subtree itself.
+        auto withTransforms = scene::NodeSet::create(target)
+            ->descendants(true, true)
+            ->where([](scene::Node::Ptr n){ return n->hasComponent<Transform>(); });
+
+        if (!withTransforms->nodes().empty())
         {
-            _toAdd.insert(_toAdd.begin(), otherRoot->_nodes.begin(), otherRoot->_nodes.end());
-            _toAdd.insert(_toAdd.begin(), otherRoot->_toAdd.begin(), otherRoot->_toAdd.end());
-            for (const auto& toRemove : _toRemove)
-                _toAdd.remove(toRemove);
+            _toAdd.insert(_toAdd.end(), withTransforms->nodes().begin(), withTransforms->nodes().end());
             _invalidLists = true;
+        }
 
+        if (otherRoot != nullptr)
             target->removeComponent(otherRoot);
-        }
     }
 }
 
@@ -237,222 +225,421 @@ Transform::RootTransform::removedHandler(scene::Node::Ptr node,
 									     scene::Node::Ptr target,
 										 scene::Node::Ptr ancestor)
 {
-	_invalidLists = true;
-
     auto withTransforms = scene::NodeSet::create(target)
         ->descendants(true, false)
         ->where([](scene::Node::Ptr n){ return n->hasComponent<Transform>(); });
-    _toRemove.insert(_toRemove.begin(), withTransforms->nodes().begin(), withTransforms->nodes().end());
+
+    for (const auto& removed : withTransforms->nodes())
+        removeTransform(*removed->component<Transform>());
+}
+
+void
+Transform::RootTransform::removeTransform(const Transform& transform)
+{
+    if (!contains(transform))
+        return;
+
+    _toRemove.push_back(transform._id);
+    _invalidLists = true;
 }
 
 void
 Transform::RootTransform::updateTransformsList()
 {
     if (_toAdd.empty() && _toRemove.empty())
+    {
+        _invalidLists = false;
+
         return;
+    }
+
+    // Node ids remain valid until the end of this method: removals are expressed as ids and
+    // additions as nodes, and both are merged into the depth-first arrays in a single pass
+    // that starts at the first modified id.
+    const uint numOldNodes = _nodes.size();
+    std::vector<bool> removed(numOldNodes, false);
+    auto firstModifiedId = numOldNodes;
 
-    for (const auto& toRemove : _toRemove)
+    for (auto nodeId : _toRemove)
     {
-        _nodeToId.erase(toRemove);
-        _nodeToPropertyChangedSlot.erase(toRemove);
+        removed[nodeId] = true;
+        firstModifiedId = std::min(firstModifiedId, nodeId);
     }
 
-    _nodes.clear();
-
-    for (const auto& nodeAndId : _nodeToId)
-        _nodes.push_back(nodeAndId.first);
+    std::vector<std::pair<NodePtr, Transform*>> added;
+    std::unordered_map<const Transform*, uint> addedIndices;
 
     for (const auto& node : _toAdd)
     {
-        _nodes.push_back(node);
-        _nodeToPropertyChangedSlot.emplace(
-            node,
-            node->data().propertyChanged("matrix").connect([this, node](data::Store&                          store,
-                                                                        ProviderPtr                           provider,
-                                                                        const data::Provider::PropertyName&   propertyName)
-            {
-                _nodeTransformCache.at(_nodeToId.at(node))._dirty = true;
-            })
-        );
-    }
+        if (node->root() != target())
+            continue;
 
-    _toAdd.clear();
-    _toRemove.clear();
+        auto transform = node->component<Transform>().get();
+
+        if (transform == nullptr
+            || (contains(*transform) && !removed[transform->_id])
+            || addedIndices.count(transform) != 0)
+            continue;
 
-    _nodeTransformCache.clear();
-    _nodeTransformCache.resize(_nodes.size(), NodeTransformCacheEntry());
+        addedIndices.emplace(transform, added.size());
+        added.emplace_back(node, transform);
+    }
 
-    for (auto node : _nodes)
+    // Closest ancestor with a Transform that will still be in the list, either as an
+    // already known node (old id) or as a new one (index in added).
+    auto findAncestor = [&](NodePtr node, int& oldId, int& addedIndex)
     {
-        auto transform = node->component<Transform>();
+        oldId = -1;
+        addedIndex = -1;
 
-        transform->_dirty = true;
-    }
+        for (auto ancestor = node->parent(); ancestor != nullptr; ancestor = ancestor->parent())
+        {
+            auto transform = ancestor->component<Transform>().get();
 
-    sortNodes();
+            if (transform == nullptr)
+                continue;
 
-    auto nodeId = 0;
-    auto ancestor = scene::Node::Ptr();
-    auto ancestorId = -1;
-    auto firstSiblingId = -1;
-    auto numSiblings = 0;
+            auto addedIt = addedIndices.find(transform);
 
-    for (const auto& node : _nodes)
-	{
-        auto previousAncestor = ancestor;
+            if (addedIt != addedIndices.end())
+            {
+                addedIndex = addedIt->second;
+                break;
+            }
+            if (contains(*transform) && !removed[transform->_id])
+            {
+                oldId = transform->_id;
+                break;
+            }
+        }
+    };
 
-        ancestor = node->parent();
+    // A new node is spliced after the nodes already in the list, so it cannot become the parent
+    // of one of them (when a Transform is added to a node that already has descendants with a
+    // Transform). We fall back to a full rebuild in that case.
+    auto hasKeptTransformChild = [&](NodePtr node) -> bool
+    {
+        std::vector<NodePtr> stack(node->children().begin(), node->children().end());
 
-        while (ancestor != nullptr && !ancestor->hasComponent<Transform>())
-            ancestor = ancestor->parent();
+        while (!stack.empty())
+        {
+            auto descendant = stack.back();
+            auto transform = descendant->component<Transform>().get();
+
+            stack.pop_back();
+
+            if (transform == nullptr)
+                stack.insert(stack.end(), descendant->children().begin(), descendant->children().end());
+            else if (contains(*transform) && !removed[transform->_id])
+                return true;
+        }
 
-        if (previousAncestor == nullptr && ancestor == nullptr)
+        return false;
+    };
+
+    for (const auto& nodeAndTransform : added)
+    {
+        if (hasKeptTransformChild(nodeAndTransform.first))
         {
-            numSiblings = 0;
+            rebuildTransformsList();
+
+            return;
         }
-        else if (ancestor != previousAncestor)
+    }
+
+    // Kept nodes whose parent is removed (their parent only lost its Transform) are attached to
+    // their closest remaining ancestor, for the same reason it cannot be a new node.
+    std::unordered_map<uint, int> reparented;
+
+    if (!_toRemove.empty())
+    {
+        for (auto nodeId = firstModifiedId; nodeId < numOldNodes; ++nodeId)
         {
-            if (previousAncestor == nullptr)
+            const auto parentId = _parentIds[nodeId];
+
+            if (removed[nodeId] || parentId < 0 || !removed[parentId])
+                continue;
+
+            int ancestorId;
+            int addedIndex;
+
+            findAncestor(_nodes[nodeId], ancestorId, addedIndex);
+
+            if (addedIndex >= 0)
             {
-                ancestorId = _nodeToId.at(ancestor);
+                rebuildTransformsList();
 
-                firstSiblingId = nodeId;
-                ++numSiblings;
+                return;
             }
-            else
-            {
-                const auto previousAncestorId = _nodeToId.at(previousAncestor);
 
-                auto& previousAncestorCacheEntry = _nodeTransformCache.at(previousAncestorId);
+            reparented[nodeId] = ancestorId;
+        }
+    }
 
-                previousAncestorCacheEntry._firstChildId = firstSiblingId;
-                previousAncestorCacheEntry._numChildren = numSiblings;
+    const uint numAdded = added.size();
+    std::vector<int> addedParents(numAdded);
+    std::vector<int> anchorIds(numAdded);
+    std::vector<std::vector<uint>> addedChildren(numAdded);
+    std::vector<uint> addedOrder;
+    std::vector<Insertion> insertions;
 
-                firstSiblingId = nodeId;
-                numSiblings = ancestor != nullptr ? 1 : 0;
+    for (auto i = 0u; i < numAdded; ++i)
+    {
+        findAncestor(added[i].first, anchorIds[i], addedParents[i]);
 
-                previousAncestor = ancestor;
+        if (addedParents[i] >= 0)
+            addedChildren[addedParents[i]].push_back(i);
+    }
 
-                ancestorId = ancestor != nullptr
-                    ? _nodeToId.at(ancestor)
-                    : -1;
-            }
-        }
-        else
+    // each tree of new nodes is laid out depth-first and spliced after the subtree of its anchor
+    for (auto i = 0u; i < numAdded; ++i)
+    {
+        if (addedParents[i] >= 0)
+            continue;
+
+        Insertion insertion;
+
+        insertion.anchorId = anchorIds[i];
+        insertion.afterId = insertion.anchorId >= 0
+            ? insertion.anchorId + _numDescendants[insertion.anchorId]
+            : numOldNodes;
+        insertion.first = addedOrder.size();
+
+        std::vector<uint> stack(1, i);
+
+        while (!stack.empty())
         {
-            ++numSiblings;
+            auto index = stack.back();
+
+            stack.pop_back();
+            addedOrder.push_back(index);
+            stack.insert(stack.end(), addedChildren[index].rbegin(), addedChildren[index].rend());
         }
 
-		_nodeToId[node] = nodeId;
+        insertion.count = addedOrder.size() - insertion.first;
+        insertions.push_back(insertion);
 
-        auto& nodeCacheEntry = _nodeTransformCache.at(nodeId);
+        firstModifiedId = std::min(firstModifiedId, std::min(insertion.afterId + 1, numOldNodes));
+    }
 
-        nodeCacheEntry._node = node;
+    // When several subtrees end at the same id, the deepest anchor comes first so that its new
+    // children stay inside its own range.
+    std::stable_sort(insertions.begin(), insertions.end(), [](const Insertion& a, const Insertion& b)
+    {
+        return a.afterId != b.afterId ? a.afterId < b.afterId : a.anchorId > b.anchorId;
+    });
 
-        nodeCacheEntry._parentId = ancestorId;
+    // Everything before firstModifiedId is left untouched, the tail is rebuilt.
+    std::vector<NodePtr> nodes;
+    std::vector<Transform*> transforms;
+    std::vector<int> parentIds;
+    MatrixArray localMatrices;
+    MatrixArray worldMatrices;
+    std::vector<PropertyChangedSlot> slots;
+    std::vector<bool> dirty;
+    std::vector<int> oldToNew(numOldNodes, -1);
+    std::vector<int> addedToNew(numAdded, -1);
+    auto insertionIt = insertions.begin();
+
+    for (auto nodeId = 0u; nodeId < firstModifiedId; ++nodeId)
+        oldToNew[nodeId] = nodeId;
+
+    auto newId = [&]() -> int
+    {
+        return firstModifiedId + nodes.size();
+    };
+
+    auto insert = [&](const Insertion& insertion)
+    {
+        for (auto i = insertion.first; i < insertion.first + insertion.count; ++i)
+        {
+            auto index = addedOrder[i];
+            auto node = added[index].first;
+            auto transform = added[index].second;
+
+            addedToNew[index] = newId();
+            transform->_id = newId();
+
+            parentIds.push_back(addedParents[index] >= 0
+                ? addedToNew[addedParents[index]]
+                : (anchorIds[index] >= 0 ? oldToNew[anchorIds[index]] : -1)
+            );
+            nodes.push_back(node);
+            transforms.push_back(transform);
+            localMatrices.push_back(*transform->_matrix);
+            worldMatrices.push_back(*transform->_modelToWorld);
+            dirty.push_back(true);
+            slots.push_back(node->data().propertyChanged("matrix").connect(
+                [this, node](data::Store&                          store,
+                             ProviderPtr                           provider,
+                             const data::Provider::PropertyName&   propertyName)
+                {
+                    auto transform = node->component<Transform>();
 
-        nodeCacheEntry._matrix = node->data().getPointer<math::mat4>("matrix");
-		nodeCacheEntry._modelToWorldMatrix = node->data().getUnsafePointer<math::mat4>("modelToWorldMatrix");
-        nodeCacheEntry._provider = node->component<Transform>()->_data;
+                    if (transform != nullptr && contains(*transform))
+                        invalidateMatrix(transform->_id);
+                }
+            ));
+        }
+    };
 
-        ++nodeId;
-	}
+    while (insertionIt != insertions.end() && insertionIt->afterId < firstModifiedId)
+        insert(*insertionIt++);
 
-    if (ancestor != nullptr)
+    for (auto nodeId = firstModifiedId; nodeId < numOldNodes; ++nodeId)
     {
-        ancestorId = _nodeToId.at(ancestor);
+        if (!removed[nodeId])
+        {
+            auto reparentedIt = reparented.find(nodeId);
+            auto parentId = reparentedIt != reparented.end() ? reparentedIt->second : _parentIds[nodeId];
+
+            oldToNew[nodeId] = newId();
+            if (oldToNew[nodeId] != static_cast<int>(nodeId))
+                _transforms[nodeId]->_id = oldToNew[nodeId];
+
+            parentIds.push_back(parentId >= 0 ? oldToNew[parentId] : -1);
+            nodes.push_back(std::move(_nodes[nodeId]));
+            transforms.push_back(_transforms[nodeId]);
+            localMatrices.push_back(_localMatrices[nodeId]);
+            worldMatrices.push_back(_worldMatrices[nodeId]);
+            dirty.push_back(isDirty(nodeId) || reparentedIt != reparented.end());
+            slots.push_back(std::move(_matrixChangedSlots[nodeId]));
+        }
+
+        while (insertionIt != insertions.end() && insertionIt->afterId == nodeId)
+            insert(*insertionIt++);
+    }
 
-        auto& ancestorCacheEntry = _nodeTransformCache.at(ancestorId);
+    while (insertionIt != insertions.end())
+        insert(*insertionIt++);
+
+    const auto numNodes = firstModifiedId + nodes.size();
+
+    _nodes.resize(firstModifiedId);
+    _nodes.insert(_nodes.end(), std::make_move_iterator(nodes.begin()), std::make_move_iterator(nodes.end()));
+    _transforms.resize(firstModifiedId);
+    _transforms.insert(_transforms.end(), transforms.begin(), transforms.end());
+    _parentIds.resize(firstModifiedId);
+    _parentIds.insert(_parentIds.end(), parentIds.begin(), parentIds.end());
+    _localMatrices.resize(firstModifiedId);
+    _localMatrices.insert(_localMatrices.end(), localMatrices.begin(), localMatrices.end());
+    _worldMatrices.resize(firstModifiedId);
+    _worldMatrices.insert(_worldMatrices.end(), worldMatrices.begin(), worldMatrices.end());
+    _matrixChangedSlots.resize(firstModifiedId);
+    _matrixChangedSlots.insert(
+        _matrixChangedSlots.end(),
+        std::make_move_iterator(slots.begin()),
+        std::make_move_iterator(slots.end())
+    );
+
+    _dirtyBits.resize((numNodes + 31) >> 5, 0);
+    if (firstModifiedId & 31)
+        _dirtyBits[firstModifiedId >> 5] &= (1u << (firstModifiedId & 31)) - 1;
+    for (auto wordId = (firstModifiedId + 31) >> 5; wordId < _dirtyBits.size(); ++wordId)
+        _dirtyBits[wordId] = 0;
+    for (auto i = 0u; i < dirty.size(); ++i)
+        if (dirty[i])
+            setDirty(firstModifiedId + i);
+
+    // recomputing the subtree sizes is a single pass over plain integers
+    _numDescendants.assign(numNodes, 0);
+    for (auto nodeId = static_cast<int>(numNodes) - 1; nodeId >= 0; --nodeId)
+    {
+        const auto parentId = _parentIds[nodeId];
 
-        ancestorCacheEntry._firstChildId = firstSiblingId;
-        ancestorCacheEntry._numChildren = numSiblings;
+        if (parentId >= 0)
+            _numDescendants[parentId] += _numDescendants[nodeId] + 1;
     }
 
+    _toAdd.clear();
+    _toRemove.clear();
 	_invalidLists = false;
 }
 
 void
-Transform::RootTransform::sortNodes()
+Transform::RootTransform::rebuildTransformsList()
 {
-    auto sortedNodeSet = scene::NodeSet::create(_nodes.front()->root())
-        ->descendants(true, false)
-        ->where([this](scene::Node::Ptr descendant) -> bool
-    {
-        auto transform = descendant->component<Transform>();
+    const uint numNodes = _nodes.size();
 
-        return transform != nullptr && transform->_dirty;
-    });
+    _toAdd.insert(_toAdd.begin(), _nodes.begin(), _nodes.end());
+    _toRemove.resize(numNodes);
+    for (auto nodeId = 0u; nodeId < numNodes; ++nodeId)
+        _toRemove[nodeId] = nodeId;
 
-    _nodes.assign(sortedNodeSet->nodes().begin(), sortedNodeSet->nodes().end());
+    updateTransformsList();
+}
+
+void
+Transform::RootTransform::invalidateMatrix(uint nodeId)
+{
+    _localMatrices[nodeId] = *_transforms[nodeId]->_matrix;
+    setDirty(nodeId);
 }
 
 void
 Transform::RootTransform::updateTransforms()
 {
-    math::mat4 modelToWorldMatrix;
-    uint nodeId = 0;
+    const auto numWords = _dirtyBits.size();
 	auto propertyName = data::Store::PropertyName(std::string("modelToWorldMatrix"));
+    auto anyChanged = false;
+    auto firstChangedId = 0u;
+    auto lastChangedId = 0u;
+    math::mat4 modelToWorldMatrix;
 
-    for (const auto& node : _nodes)
-	{
-        auto& nodeCacheEntry = _nodeTransformCache.at(nodeId);
+    // Dirty nodes are visited in increasing id order. Since children always come after their
+    // parent, the children flagged when a parent changes are processed within the same pass.
+    for (auto wordId = 0u; wordId < numWords; ++wordId)
+    {
+        auto& word = _dirtyBits[wordId];
+
+        while (word != 0)
+        {
+            const uint nodeId = (wordId << 5) + math::countTrailingZeros(word);
+            const auto parentId = _parentIds[nodeId];
 
-		if (nodeCacheEntry._dirty)
-		{
-			auto parentId = nodeCacheEntry._parentId;
+            word &= word - 1;
 
-			if (parentId < 0)
-				modelToWorldMatrix = *nodeCacheEntry._matrix;
+            if (parentId < 0)
+                modelToWorldMatrix = _localMatrices[nodeId];
             else
-            {
-                const auto& parentCacheEntry = _nodeTransformCache.at(parentId);
+                math::multiply(_worldMatrices[parentId], _localMatrices[nodeId], modelToWorldMatrix);
 
-                modelToWorldMatrix = *parentCacheEntry._modelToWorldMatrix * *nodeCacheEntry._matrix;
-            }
+            if (modelToWorldMatrix == _worldMatrices[nodeId])
+                continue;
+
+            _worldMatrices[nodeId] = modelToWorldMatrix;
 
             // Because we use an unsafe pointer that gives us a direct access to the
             // data provider internal value for "modelToWorldMatrix", we have to trigger
-            // the "property changed" signal manually.
-            // This technique completely bypasses the storeproperty name resolving
-            // mechanism and is a lot faster.
-            if (*nodeCacheEntry._modelToWorldMatrix != modelToWorldMatrix)
-            {
-                auto& nodeData = node->data();
-                auto provider = nodeCacheEntry._provider;
-
-                // manually update the data provider internal mat4 object
-                *nodeCacheEntry._modelToWorldMatrix = modelToWorldMatrix;
-
-                // execute the "property changed" signal(s) manually
-                nodeData.propertyChanged().execute(nodeData, provider, propertyName);
-                if (nodeData.hasPropertyChangedSignal("modelToWorldMatrix"))
-                    nodeData.propertyChanged("modelToWorldMatrix").execute(nodeData, provider, propertyName);
-
-			    auto numChildren = nodeCacheEntry._numChildren;
+            // the "property changed" signal(s) manually, and only when someone listens.
+            auto transform = _transforms[nodeId];
+            auto& nodeData = _nodes[nodeId]->data();
 
-                if (numChildren > 0)
-                {
-                    auto firstChildId = nodeCacheEntry._firstChildId;
-                    auto lastChildId = firstChildId + numChildren;
-
-                    for (auto childId = firstChildId; childId < lastChildId; ++childId)
-                    {
-                        auto& childCacheEntry = _nodeTransformCache.at(childId);
+            *transform->_modelToWorld = modelToWorldMatrix;
 
-                        childCacheEntry._dirty = true;
-                    }
-                }
-            }
+            if (nodeData.propertyChanged().numCallbacks() != 0)
+                nodeData.propertyChanged().execute(nodeData, transform->_data, propertyName);
+            if (nodeData.hasPropertyChangedSignal(propertyName))
+                nodeData.propertyChanged(propertyName).execute(nodeData, transform->_data, propertyName);
 
-	       	nodeCacheEntry._dirty = false;
+            const auto lastDescendantId = nodeId + _numDescendants[nodeId];
 
-            auto transform = node->component<Transform>();
+            for (auto childId = nodeId + 1; childId <= lastDescendantId; childId += _numDescendants[childId] + 1)
+                setDirty(childId);
 
-            transform->_dirty = false;
-		}
+            if (!anyChanged)
+                firstChangedId = nodeId;
+            lastChangedId = nodeId;
+            anyChanged = true;
+        }
+    }
 
-        ++nodeId;
-	}
+    if (anyChanged)
+        _matricesChanged->execute(
+            std::static_pointer_cast<RootTransform>(shared_from_this()),
+            firstChangedId,
+            lastChangedId + 1
+        );
 }
 
 void
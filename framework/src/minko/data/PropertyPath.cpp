@@ -0,0 +1,132 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/data/PropertyPath.hpp"
+
+using namespace minko;
+using namespace minko::data;
+
+PropertyPath::PropertyPath(const FString& name) :
+    _name(name),
+    _isCollectionItem(false),
+    _collectionName(""),
+    _isUuid(false),
+    _index(0),
+    _uuid(),
+    _token(name),
+    _segments()
+{
+    const auto& str = *name;
+    auto pos = str.find_first_of("[");
+
+    if (pos != std::string::npos)
+    {
+        auto pos2 = str.find_first_of("]");
+        auto indexStr = str.substr(pos + 1, pos2 - pos - 1);
+        auto pos3 = indexStr.find_first_of("-");
+
+        _isCollectionItem = true;
+        _collectionName = str.substr(0, pos);
+        _token = pos2 != std::string::npos && pos2 + 2 <= str.size() ? str.substr(pos2 + 2) : std::string();
+
+        if (pos3 != std::string::npos)
+        {
+            _isUuid = true;
+            _uuid = indexStr;
+        }
+        else
+            _index = std::atoi(indexStr.c_str());
+    }
+
+    if (str.find('$') != std::string::npos)
+        parseVariables(str);
+}
+
+void
+PropertyPath::parseVariables(const std::string& name)
+{
+    auto literalStart = 0u;
+
+    for (auto i = 0u; i < name.size(); ++i)
+    {
+        if (name[i] != '$')
+            continue;
+
+        auto end = i + 1;
+        std::string variableName;
+
+        if (end < name.size() && name[end] == '{')
+        {
+            auto closing = name.find('}', end);
+
+            if (closing == std::string::npos)
+                break;
+
+            variableName = name.substr(end + 1, closing - end - 1);
+            end = closing + 1;
+        }
+        else
+        {
+            while (end < name.size() && (std::isalnum(name[end]) || name[end] == '_'))
+                ++end;
+
+            variableName = name.substr(i + 1, end - i - 1);
+        }
+
+        if (variableName.empty())
+            continue;
+
+        if (i != literalStart)
+            _segments.push_back({ name.substr(literalStart, i - literalStart), false, FString("") });
+        _segments.push_back({ name.substr(i, end - i), true, FString(variableName) });
+
+        literalStart = end;
+        i = end - 1;
+    }
+
+    if (!_segments.empty() && literalStart != name.size())
+        _segments.push_back({ name.substr(literalStart), false, FString("") });
+}
+
+std::string
+PropertyPath::resolve(const FStringList& variables) const
+{
+    if (_segments.empty())
+        return *_name;
+
+    std::string result;
+
+    for (const auto& segment : _segments)
+    {
+        if (!segment.isVariable)
+        {
+            result += segment.text;
+            continue;
+        }
+
+        auto variable = std::find_if(variables.begin(), variables.end(), [&](const std::pair<FString, FString>& v)
+        {
+            return v.first == segment.variable;
+        });
+
+        result += variable != variables.end() ? *variable->second : segment.text;
+    }
+
+    return result;
+}
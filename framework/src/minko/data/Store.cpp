@@ -28,6 +28,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace minko::data;
 
+const uint Store::MIN_NUM_CACHED_PATHS = 256;
+
 Store::Store() :
     _providers(),
     _collections(),
@@ -95,6 +97,9 @@ Store::Store(Store&& other)
     _propertySlots = std::move(other._propertySlots);
     _collectionItemAddedSlots = std::move(other._collectionItemAddedSlots);
     _collectionItemRemovedSlots = std::move(other._collectionItemRemovedSlots);
+    _collectionByName = std::move(other._collectionByName);
+    _collectionItemByUuid = std::move(other._collectionItemByUuid);
+    _collectionItemPaths = std::move(other._collectionItemPaths);
 
     other._propertyNameToChangedSignal = nullptr;
     other._propertyNameToAddedSignal = nullptr;
@@ -119,6 +124,9 @@ Store::operator=(Store&& other)
     _propertySlots = other._propertySlots;
     _collectionItemAddedSlots = other._collectionItemAddedSlots;
     _collectionItemRemovedSlots = other._collectionItemRemovedSlots;
+    _collectionByName = std::move(other._collectionByName);
+    _collectionItemByUuid = std::move(other._collectionItemByUuid);
+    _collectionItemPaths = std::move(other._collectionItemPaths);
 
     other._propertyNameToChangedSignal = nullptr;
     other._propertyNameToAddedSignal = nullptr;
@@ -168,6 +176,8 @@ Store::copyFrom(const Store& store, bool deepCopy)
     {
         _collections = store._collections;
         _providers = store._providers;
+        for (auto collection : _collections)
+            indexCollection(collection);
         if (store._lengthProvider)
             _lengthProvider = Provider::create(store._lengthProvider);
     }
@@ -232,6 +242,8 @@ void
 Store::addCollection(std::shared_ptr<Collection> collection)
 {
     _collections.push_back(collection);
+    // the first collection with a given name is the one property names refer to
+    _collectionByName.emplace(collection->name(), collection);
 
     (*_collectionItemAddedSlots)[collection] = collection->itemAdded().connect(
         [this, collection](Collection&, Provider::Ptr provider)
@@ -263,6 +275,40 @@ Store::removeCollection(std::shared_ptr<Collection> collection)
 
     for (auto provider : collection->items())
         doRemoveProvider(provider, collection);
+
+    unindexCollection(collection);
+}
+
+void
+Store::indexCollection(CollectionPtr collection)
+{
+    _collectionByName.emplace(collection->name(), collection);
+
+    auto& items = _collectionItemByUuid[collection.get()];
+
+    for (auto provider : collection->items())
+        items.emplace(provider->uuid(), provider);
+}
+
+void
+Store::unindexCollection(CollectionPtr collection)
+{
+    _collectionItemByUuid.erase(collection.get());
+
+    auto it = _collectionByName.find(collection->name());
+
+    if (it == _collectionByName.end() || it->second != collection)
+        return;
+
+    _collectionByName.erase(it);
+
+    auto nextCollection = std::find_if(_collections.begin(), _collections.end(), [&](CollectionPtr c)
+    {
+        return c->name() == collection->name();
+    });
+
+    if (nextCollection != _collections.end())
+        _collectionByName.emplace(collection->name(), *nextCollection);
 }
 
 void
@@ -354,56 +400,48 @@ Store::providerPropertyRemovedHandler(Provider::Ptr                 provider,
     }
 }
 
-std::pair<Provider::Ptr, std::string>
-Store::getProviderByPropertyName(const std::string& propertyName) const
+std::pair<Provider::Ptr, Store::PropertyName>
+Store::getProviderByPropertyName(const PropertyName& propertyName) const
 {
-    auto pos = propertyName.find_first_of("[");
-
-    if (pos != std::string::npos)
+    if ((*propertyName).find('[') == std::string::npos)
     {
-        auto collectionName = propertyName.substr(0, pos);
+        for (const auto& provider : _providers)
+            if (provider->hasProperty(propertyName))
+                return std::pair<Provider::Ptr, PropertyName>(provider, propertyName);
 
-        for (const auto& collection : _collections)
-            if (collection->name() == collectionName)
-            {
-                auto pos2 = propertyName.find_first_of("]");
-                auto indexStr = propertyName.substr(pos + 1, pos2 - pos - 1);
-                auto pos3 = indexStr.find_first_of("-");
-                auto token = propertyName.substr(pos2 + 2);
-
-                // fetch provider by uuid
-                if (pos3 != std::string::npos && pos3 < pos2)
-                {
-                    for (const auto& provider : collection->items())
-                        if (provider->uuid() == indexStr && provider->hasProperty(token))
-                            return std::pair<Provider::Ptr, std::string>(provider, token);
-                }
-                else // fetch provider by index
-                {
-                    uint index = std::atoi(indexStr.c_str());
+        return std::pair<Provider::Ptr, PropertyName>(nullptr, propertyName);
+    }
 
-                    if (index < collection->items().size())
-                    {
-                        auto provider = collection->items()[index];
+    const auto& path = collectionItemPath(propertyName);
 
-                        if (provider->hasProperty(token))
-                            return std::pair<Provider::Ptr, std::string>(provider, token);
-                    }
-                }
+    auto collectionIt = _collectionByName.find(path.collectionName());
 
-                return std::pair<Provider::Ptr, std::string>(nullptr, token);
-            }
-    }
-    else
+    if (collectionIt == _collectionByName.end())
+        return std::pair<Provider::Ptr, PropertyName>(nullptr, propertyName);
+
+    const auto& collection = collectionIt->second;
+    const auto& token = path.token();
+    Provider::Ptr provider = nullptr;
+
+    if (path.isUuid())
     {
-        for (const auto& provider : _providers)
+        auto items = _collectionItemByUuid.find(collection.get());
+
+        if (items != _collectionItemByUuid.end())
         {
-            if (provider->hasProperty(propertyName))
-                return std::pair<Provider::Ptr, std::string>(provider, propertyName);
+            auto it = items->second.find(path.uuid());
+
+            if (it != items->second.end())
+                provider = it->second;
         }
     }
+    else if (path.index() < collection->items().size())
+        provider = collection->items()[path.index()];
 
-    return std::pair<Provider::Ptr, std::string>(nullptr, propertyName);
+    if (provider != nullptr && provider->hasProperty(token))
+        return std::pair<Provider::Ptr, PropertyName>(provider, token);
+
+    return std::pair<Provider::Ptr, PropertyName>(nullptr, token);
 }
 
 void
@@ -432,6 +470,9 @@ Store::doAddProvider(ProviderPtr provider, CollectionPtr collection)
         }
     ));
 
+    if (collection)
+        _collectionItemByUuid[collection.get()].emplace(provider->uuid(), provider);
+
     for (const auto& property : provider->values())
         providerPropertyAddedHandler(provider, collection, property.first);
 
@@ -470,6 +511,25 @@ Store::doRemoveProvider(ProviderPtr provider, CollectionPtr collection)
     // erase all the slots (property added, changed, removed) for this provider
     _propertySlots->erase(provider);
 
+    if (collection)
+    {
+        auto& items = _collectionItemByUuid[collection.get()];
+        auto itemIt = items.find(provider->uuid());
+
+        if (itemIt != items.end() && itemIt->second == provider)
+        {
+            items.erase(itemIt);
+
+            // the same uuid might still be used by another item of the collection
+            for (const auto& item : collection->items())
+                if (item->uuid() == provider->uuid())
+                {
+                    items.emplace(item->uuid(), item);
+                    break;
+                }
+        }
+    }
+
     // destroy all signals that might have been created for each property declared by the provider
     // warning! erase the signal only if it has no callbacks anymore, otherwise it should be kept valid
     if (!collection)
@@ -581,20 +641,37 @@ Store::removeProviderFromCollection(std::shared_ptr<data::Provider> provider,
 const std::string
 Store::getActualPropertyName(const FStringList& vars, const FString& propertyName)
 {
-    std::string s = *propertyName;
+    // binding names come from a finite set of effect strings: they are parsed once per thread
+    thread_local std::unordered_map<const std::string*, PropertyPath> paths;
+
+    auto pathIt = paths.find(propertyName.value());
+
+    if (pathIt == paths.end())
+        pathIt = paths.emplace(propertyName.value(), PropertyPath(propertyName)).first;
+
+    return pathIt->second.resolve(vars);
+}
+
+const PropertyPath&
+Store::collectionItemPath(const PropertyName& propertyName) const
+{
+    auto pathIt = _collectionItemPaths.find(propertyName.value());
 
-    // FIXME: order vars keys from longer to shorter in order to match the longest matching var name
-    // or use regex_replace
+    if (pathIt != _collectionItemPaths.end())
+        return pathIt->second;
 
-    for (const auto& variableName : vars)
+    // bounded by the number of items the store can address, one entry is evicted at a time so
+    // that the live names stay cached
+    if (_collectionItemPaths.size() >= MIN_NUM_CACHED_PATHS)
     {
-        auto pos = (*propertyName).find("${" + *variableName.first + "}");
+        auto numItems = 0u;
+
+        for (const auto& collection : _collections)
+            numItems += collection->items().size();
 
-        if (pos != std::string::npos)
-            s = s.substr(0, pos) + *variableName.second + s.substr(pos + (*variableName.first).size() + 3);
-        else if ((pos = (*propertyName).find("$" + *variableName.first)) != std::string::npos)
-            s = s.substr(0, pos) + *variableName.second + s.substr(pos + (*variableName.first).size() + 1);
+        if (_collectionItemPaths.size() >= std::max(MIN_NUM_CACHED_PATHS, numItems * 4))
+            _collectionItemPaths.erase(_collectionItemPaths.begin());
     }
 
-    return s;
+    return _collectionItemPaths.emplace(propertyName.value(), PropertyPath(propertyName)).first->second;
 }
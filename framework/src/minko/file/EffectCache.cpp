@@ -0,0 +1,56 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/file/EffectCache.hpp"
+
+using namespace minko;
+using namespace minko::file;
+
+EffectCache::Ptr EffectCache::_default = EffectCache::create();
+
+const EffectCache::BinaryEffect*
+EffectCache::binaryEffect(const std::string& key, HashType contentHash) const
+{
+    auto binaryEffectIt = _binaryEffects.find(key);
+
+    if (binaryEffectIt == _binaryEffects.end() || binaryEffectIt->second.contentHash != contentHash)
+        return nullptr;
+
+    return &binaryEffectIt->second;
+}
+
+void
+EffectCache::binaryEffect(const std::string&                 key,
+                          HashType                           contentHash,
+                          const Includes&                    includes,
+                          const std::vector<unsigned char>&  data)
+{
+    auto& binaryEffect = _binaryEffects[key];
+
+    binaryEffect.contentHash = contentHash;
+    binaryEffect.includes = includes;
+    binaryEffect.data = data;
+}
+
+void
+EffectCache::clear()
+{
+    _binaryEffects.clear();
+}
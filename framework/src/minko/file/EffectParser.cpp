@@ -36,6 +36,8 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/file/FileProtocol.hpp"
 #include "minko/file/Options.hpp"
 #include "minko/file/AssetLibrary.hpp"
+#include "minko/file/EffectCache.hpp"
+#include "minko/Hash.hpp"
 #include "minko/data/Store.hpp"
 #include "minko/log/Logger.hpp"
 
@@ -46,6 +48,332 @@ using namespace minko::data;
 using namespace minko::file;
 using namespace minko::render;
 
+namespace
+{
+    const uint BINARY_EFFECT_MAGIC      = 0x4d4b4658; // "MKFX"
+    const uint BINARY_EFFECT_VERSION    = 1;
+    const uint BINARY_EFFECT_MAX_DEPTH  = 256;
+
+    // Binary effects store the JSON tree of the effect with all its strings (member names,
+    // binding names, shader sources...) interned in a table.
+    enum class BinaryValueType : unsigned char
+    {
+        NULL_VALUE,
+        INT,
+        UINT,
+        REAL,
+        STRING,
+        BOOLEAN,
+        ARRAY,
+        OBJECT
+    };
+
+    class BinaryEffectWriter
+    {
+    private:
+        std::unordered_map<std::string, uint>   _stringIds;
+        std::vector<const std::string*>         _strings;
+        std::vector<unsigned char>              _tree;
+
+    public:
+        void
+        write(const Json::Value& root, std::vector<unsigned char>& data)
+        {
+            writeValue(root);
+
+            data.clear();
+            write(data, BINARY_EFFECT_MAGIC);
+            write(data, BINARY_EFFECT_VERSION);
+            write(data, static_cast<uint>(_strings.size()));
+            for (auto string : _strings)
+            {
+                write(data, static_cast<uint>(string->size()));
+                data.insert(data.end(), string->begin(), string->end());
+            }
+            data.insert(data.end(), _tree.begin(), _tree.end());
+        }
+
+    private:
+        template <typename T>
+        static
+        void
+        write(std::vector<unsigned char>& data, T value)
+        {
+            auto bytes = reinterpret_cast<const unsigned char*>(&value);
+
+            data.insert(data.end(), bytes, bytes + sizeof(T));
+        }
+
+        uint
+        stringId(const std::string& string)
+        {
+            auto stringIdIt = _stringIds.find(string);
+
+            if (stringIdIt != _stringIds.end())
+                return stringIdIt->second;
+
+            auto id = static_cast<uint>(_strings.size());
+
+            _strings.push_back(&_stringIds.emplace(string, id).first->first);
+
+            return id;
+        }
+
+        void
+        writeValue(const Json::Value& value)
+        {
+            switch (value.type())
+            {
+            case Json::intValue:
+                write(_tree, BinaryValueType::INT);
+                write(_tree, static_cast<std::int64_t>(value.asLargestInt()));
+                break;
+            case Json::uintValue:
+                write(_tree, BinaryValueType::UINT);
+                write(_tree, static_cast<std::uint64_t>(value.asLargestUInt()));
+                break;
+            case Json::realValue:
+                write(_tree, BinaryValueType::REAL);
+                write(_tree, value.asDouble());
+                break;
+            case Json::stringValue:
+                write(_tree, BinaryValueType::STRING);
+                write(_tree, stringId(value.asString()));
+                break;
+            case Json::booleanValue:
+                write(_tree, BinaryValueType::BOOLEAN);
+                write(_tree, static_cast<unsigned char>(value.asBool()));
+                break;
+            case Json::arrayValue:
+                write(_tree, BinaryValueType::ARRAY);
+                write(_tree, static_cast<uint>(value.size()));
+                for (auto i = 0u; i < value.size(); ++i)
+                    writeValue(value[i]);
+                break;
+            case Json::objectValue:
+            {
+                auto names = value.getMemberNames();
+
+                write(_tree, BinaryValueType::OBJECT);
+                write(_tree, static_cast<uint>(names.size()));
+                for (const auto& name : names)
+                {
+                    write(_tree, stringId(name));
+                    writeValue(value[name]);
+                }
+                break;
+            }
+            default:
+                write(_tree, BinaryValueType::NULL_VALUE);
+                break;
+            }
+        }
+    };
+
+    class BinaryEffectReader
+    {
+    private:
+        const unsigned char*        _cursor;
+        const unsigned char*        _end;
+        std::vector<std::string>    _strings;
+
+    public:
+        BinaryEffectReader(const std::vector<unsigned char>& data) :
+            _cursor(data.data()),
+            _end(data.data() + data.size())
+        {
+        }
+
+        // Returns false when the data is not a valid binary effect.
+        bool
+        read(Json::Value& root)
+        {
+            uint magic = 0;
+            uint version = 0;
+            uint numStrings = 0;
+
+            if (!read(magic) || magic != BINARY_EFFECT_MAGIC || !read(version) || version != BINARY_EFFECT_VERSION
+                || !read(numStrings))
+                return false;
+
+            _strings.reserve(std::min<uint>(numStrings, _end - _cursor));
+            for (auto i = 0u; i < numStrings; ++i)
+            {
+                uint size = 0;
+
+                if (!read(size) || size > static_cast<uint>(_end - _cursor))
+                    return false;
+
+                _strings.emplace_back(reinterpret_cast<const char*>(_cursor), size);
+                _cursor += size;
+            }
+
+            return readValue(root, 0) && _cursor == _end;
+        }
+
+    private:
+        template <typename T>
+        bool
+        read(T& value)
+        {
+            if (static_cast<std::size_t>(_end - _cursor) < sizeof(T))
+                return false;
+
+            std::memcpy(&value, _cursor, sizeof(T));
+            _cursor += sizeof(T);
+
+            return true;
+        }
+
+        bool
+        readString(std::string& string)
+        {
+            uint id = 0;
+
+            if (!read(id) || id >= _strings.size())
+                return false;
+
+            string = _strings[id];
+
+            return true;
+        }
+
+        bool
+        readValue(Json::Value& value, uint depth)
+        {
+            BinaryValueType type;
+
+            if (depth > BINARY_EFFECT_MAX_DEPTH || !read(type))
+                return false;
+
+            switch (type)
+            {
+            case BinaryValueType::NULL_VALUE:
+                value = Json::Value();
+                return true;
+            case BinaryValueType::INT:
+            {
+                std::int64_t intValue = 0;
+
+                if (!read(intValue))
+                    return false;
+
+                value = static_cast<Json::LargestInt>(intValue);
+
+                return true;
+            }
+            case BinaryValueType::UINT:
+            {
+                std::uint64_t uintValue = 0;
+
+                if (!read(uintValue))
+                    return false;
+
+                value = static_cast<Json::LargestUInt>(uintValue);
+
+                return true;
+            }
+            case BinaryValueType::REAL:
+            {
+                double realValue = 0.;
+
+                if (!read(realValue))
+                    return false;
+
+                value = realValue;
+
+                return true;
+            }
+            case BinaryValueType::STRING:
+            {
+                std::string stringValue;
+
+                if (!readString(stringValue))
+                    return false;
+
+                value = stringValue;
+
+                return true;
+            }
+            case BinaryValueType::BOOLEAN:
+            {
+                unsigned char boolValue = 0;
+
+                if (!read(boolValue))
+                    return false;
+
+                value = boolValue != 0;
+
+                return true;
+            }
+            case BinaryValueType::ARRAY:
+            {
+                uint size = 0;
+
+                if (!read(size) || size > static_cast<uint>(_end - _cursor))
+                    return false;
+
+                value = Json::Value(Json::arrayValue);
+                value.resize(size);
+                for (auto i = 0u; i < size; ++i)
+                    if (!readValue(value[i], depth + 1))
+                        return false;
+
+                return true;
+            }
+            case BinaryValueType::OBJECT:
+            {
+                uint size = 0;
+
+                if (!read(size) || size > static_cast<uint>(_end - _cursor))
+                    return false;
+
+                value = Json::Value(Json::objectValue);
+                for (auto i = 0u; i < size; ++i)
+                {
+                    std::string name;
+
+                    if (!readString(name) || !readValue(value[name], depth + 1))
+                        return false;
+                }
+
+                return true;
+            }
+            default:
+                return false;
+            }
+        }
+    };
+
+    // Replaces the sources of the shaders by their sources with the includes expanded.
+    void
+    expandShaderSources(Json::Value& node, const std::unordered_map<std::string, std::string>& expandedSources)
+    {
+        if (node.isArray())
+        {
+            for (auto i = 0u; i < node.size(); ++i)
+                expandShaderSources(node[i], expandedSources);
+        }
+        else if (node.isObject())
+        {
+            for (const auto& name : node.getMemberNames())
+            {
+                auto& child = node[name];
+
+                if ((name == "vertexShader" || name == "fragmentShader") && child.isString())
+                {
+                    auto expandedSourceIt = expandedSources.find(child.asString());
+
+                    if (expandedSourceIt != expandedSources.end())
+                        child = expandedSourceIt->second;
+                }
+                else
+                    expandShaderSources(child, expandedSources);
+            }
+        }
+    }
+}
+
 const std::string EffectParser::EXTRA_PROPERTY_BLENDING_MODE = "blendingMode";
 const std::string EffectParser::EXTRA_PROPERTY_STENCIL_TEST = "stencilTest";
 
@@ -142,7 +470,12 @@ EffectParser::EffectParser() :
 	_effect(nullptr),
 	_numDependencies(0),
 	_numLoadedDependencies(0),
-	_effectData(data::Provider::create())
+	_effectData(data::Provider::create()),
+	_root(new Json::Value()),
+	_isBinaryEffect(false),
+	_contentHash(0),
+	_numIncludesToValidate(0),
+	_includesChanged(false)
 {
 }
 
@@ -153,26 +486,6 @@ EffectParser::parse(const std::string&				    filename,
 				    const std::vector<unsigned char>&	data,
 				    std::shared_ptr<AssetLibrary>	    assetLibrary)
 {
-	Json::Value root;
-	Json::Reader reader;
-
-    // Add a line ending to avoid JSON parsing error
-    auto tempData = data;
-    tempData.push_back('\n');
-
-    auto parseSuccess = reader.parse(
-        reinterpret_cast<const char*>(&tempData[0]),
-        reinterpret_cast<const char*>(&tempData[tempData.size() - 1]), root, false
-    );
-
-    if (!parseSuccess)
-    {
-        _error->execute(
-            shared_from_this(), 
-            file::Error(resolvedFilename + ": " + reader.getFormattedErrorMessages())
-        );
-    }
-
     _options = options->clone()
         ->loadAsynchronously(false);
 
@@ -187,15 +500,132 @@ EffectParser::parse(const std::string&				    filename,
 	_filename = filename;
 	_resolvedFilename = resolvedFilename;
 	_assetLibrary = assetLibrary;
-	_effectName	= root.get("name", filename).asString();
 
-    parseGlobalScope(root, _globalScope);
+    auto effectCache = EffectCache::defaultCache();
+
+    // the includes of the effect are resolved from its include paths
+    _cacheKey = resolvedFilename + "\n" + std::to_string(_options->includePaths(), "\n");
+    _contentHash = minko::hash(data.data(), data.size());
+
+    auto cachedBinaryEffect = effectCache != nullptr ? effectCache->binaryEffect(_cacheKey, _contentHash) : nullptr;
+
+    if (cachedBinaryEffect != nullptr && !cachedBinaryEffect->includes.empty())
+        validateIncludes(data, *cachedBinaryEffect);
+    else
+        parseEffect(data, cachedBinaryEffect != nullptr ? &cachedBinaryEffect->data : nullptr);
+}
+
+void
+EffectParser::parseEffect(const std::vector<unsigned char>& data, const std::vector<unsigned char>* cachedBinaryEffect)
+{
+    if (isBinaryEffect(data) || cachedBinaryEffect != nullptr)
+    {
+        _isBinaryEffect = true;
+
+        if (!BinaryEffectReader(cachedBinaryEffect != nullptr ? *cachedBinaryEffect : data).read(*_root))
+        {
+            _error->execute(shared_from_this(), file::Error(_resolvedFilename + ": invalid binary effect"));
+
+            return;
+        }
+    }
+    else
+    {
+        Json::Reader reader;
+
+        // Add a line ending to avoid JSON parsing error
+        auto tempData = data;
+        tempData.push_back('\n');
+
+        auto parseSuccess = reader.parse(
+            reinterpret_cast<const char*>(&tempData[0]),
+            reinterpret_cast<const char*>(&tempData[tempData.size() - 1]), *_root, false
+        );
+
+        if (!parseSuccess)
+        {
+            _error->execute(
+                shared_from_this(),
+                file::Error(_resolvedFilename + ": " + reader.getFormattedErrorMessages())
+            );
+        }
+    }
+
+	_effectName	= _root->get("name", _filename).asString();
+
+    parseGlobalScope(*_root, _globalScope);
 
     _effect = render::Effect::create(_effectName);
     if (_numDependencies == _numLoadedDependencies)
         finalize();
 }
 
+void
+EffectParser::validateIncludes(const std::vector<unsigned char>& data, const EffectCache::BinaryEffect& cachedBinaryEffect)
+{
+    // the binary effect embeds its includes: it is used only if none of them changed since
+    auto includes = cachedBinaryEffect.includes;
+
+    _source = data;
+    _cachedBinaryEffect = cachedBinaryEffect.data;
+    _numIncludesToValidate = includes.size();
+    _includesChanged = false;
+
+    for (const auto& include : includes)
+    {
+        // same lookup order as loadGLSLDependencies()
+        if (_options->assetLibrary()->hasBlob(include.filename))
+        {
+            auto& blob = _options->assetLibrary()->blob(include.filename);
+
+            includeValidated(minko::hash(blob.data(), blob.size()) == include.contentHash);
+
+            continue;
+        }
+
+        auto options = _options->clone();
+
+        options->includePaths() = include.includePaths;
+
+        auto loader = Loader::create(options);
+
+        _loaderCompleteSlots[loader] = loader->complete()->connect(std::bind(
+            &EffectParser::includeValidationCompleteHandler,
+            std::static_pointer_cast<EffectParser>(shared_from_this()),
+            std::placeholders::_1,
+            include
+        ));
+
+        // a missing include is reported by the parsing of the effect
+        _loaderErrorSlots[loader] = loader->error()->connect(std::bind(
+            &EffectParser::includeValidated,
+            std::static_pointer_cast<EffectParser>(shared_from_this()),
+            false
+        ));
+
+        loader->queue(include.filename)->load();
+    }
+}
+
+void
+EffectParser::includeValidationCompleteHandler(LoaderPtr loader, const EffectCache::Include& include)
+{
+    const auto& data = loader->files().at(include.filename)->data();
+
+    includeValidated(minko::hash(data.data(), data.size()) == include.contentHash);
+}
+
+void
+EffectParser::includeValidated(bool unchanged)
+{
+    _includesChanged = _includesChanged || !unchanged;
+
+    if (--_numIncludesToValidate != 0)
+        return;
+
+    parseEffect(_source, _includesChanged ? nullptr : &_cachedBinaryEffect);
+}
+
 void
 EffectParser::parseGlobalScope(const Json::Value& node, Scope& scope)
 {
@@ -1491,6 +1921,7 @@ EffectParser::parseShader(const Json::Value& node, const Scope& scope, render::S
 
     blocks->push_front(GLSLBlock(GLSLBlockType::TEXT, ""));
     _shaderToGLSL[shader] = blocks;
+    _shaderSources[shader] = glsl;
     parseGLSL(glsl, _options, blocks, blocks->begin());
 
     return shader;
@@ -1551,6 +1982,8 @@ EffectParser::loadGLSLDependencies(GLSLBlockListPtr		   blocks,
             {
                 auto& data = options->assetLibrary()->blob(block.second);
 
+                _includes.push_back({ block.second, options->includePaths(), minko::hash(data.data(), data.size()) });
+
                 block.first = GLSLBlockType::TEXT;
 #ifdef DEBUG
                 block.second = "//#pragma include(\"" + block.second + "\")\n";
@@ -1617,6 +2050,34 @@ EffectParser::glslIncludeCompleteHandler(LoaderPtr 			        loader,
                                          GLSLBlockListPtr 			blocks,
                                          GLSLBlockList::iterator 	blockIt,
                                          const std::string&         filename)
+{
+    ++_numLoadedDependencies;
+
+    auto file = loader->files().at(filename);
+    const auto& data = file->data();
+
+    _includes.push_back({ filename, loader->options()->includePaths(), minko::hash(data.data(), data.size()) });
+
+    parseInclude(
+        blocks,
+        blockIt,
+        filename,
+        file->resolvedFilename(),
+        std::string((const char*)&data[0], data.size()),
+        loader->options()
+    );
+
+    if (_numDependencies == _numLoadedDependencies && _effect)
+        finalize();
+}
+
+void
+EffectParser::parseInclude(GLSLBlockListPtr         blocks,
+                           GLSLBlockList::iterator  blockIt,
+                           const std::string&       filename,
+                           const std::string&       resolvedFilename,
+                           const std::string&       source,
+                           Options::Ptr             options)
 {
     auto& block = *blockIt;
 
@@ -1629,11 +2090,6 @@ EffectParser::glslIncludeCompleteHandler(LoaderPtr 			        loader,
     block.second = "\n";
 #endif
 
-    ++_numLoadedDependencies;
-
-    auto file = loader->files().at(filename);
-    auto resolvedFilename = file->resolvedFilename();
-    auto options = loader->options();
     auto pos = resolvedFilename.find_last_of("/\\");
 
     if (pos != std::string::npos)
@@ -1643,10 +2099,7 @@ EffectParser::glslIncludeCompleteHandler(LoaderPtr 			        loader,
         options->includePaths().push_back(resolvedFilename.substr(0, pos));
     }
 
-    parseGLSL(std::string((const char*)&file->data()[0], file->data().size()), options, blocks, blockIt);
-
-    if (_numDependencies == _numLoadedDependencies && _effect)
-        finalize();
+    parseGLSL(source, options, blocks, blockIt);
 }
 
 void
@@ -1696,7 +2149,7 @@ EffectParser::createStates(const StateBlock& block)
 }
 
 std::string
-EffectParser::concatenateGLSLBlocks(GLSLBlockListPtr blocks)
+EffectParser::concatenateGLSLBlocks(GLSLBlockListPtr blocks) const
 {
     std::string glsl = "";
 
@@ -1706,6 +2159,38 @@ EffectParser::concatenateGLSLBlocks(GLSLBlockListPtr blocks)
     return glsl;
 }
 
+std::vector<unsigned char>
+EffectParser::binaryEffect() const
+{
+    // the same source always expands the same way, its includes being resolved from the
+    // directory of the effect
+    std::unordered_map<std::string, std::string> expandedSources;
+
+    for (const auto& shaderAndSource : _shaderSources)
+        expandedSources[shaderAndSource.second] = concatenateGLSLBlocks(_shaderToGLSL.at(shaderAndSource.first));
+
+    auto root = *_root;
+    std::vector<unsigned char> data;
+
+    expandShaderSources(root, expandedSources);
+    BinaryEffectWriter().write(root, data);
+
+    return data;
+}
+
+bool
+EffectParser::isBinaryEffect(const std::vector<unsigned char>& data)
+{
+    uint magic = 0;
+
+    if (data.size() < sizeof(uint))
+        return false;
+
+    std::memcpy(&magic, data.data(), sizeof(uint));
+
+    return magic == BINARY_EFFECT_MAGIC;
+}
+
 void
 EffectParser::finalize()
 {
@@ -1728,6 +2213,11 @@ EffectParser::finalize()
 	_effect->data()->copyFrom(_effectData);
     _options->assetLibrary()->effect(_filename, _effect);
 
+    auto effectCache = EffectCache::defaultCache();
+
+    if (effectCache != nullptr && !_isBinaryEffect)
+        effectCache->binaryEffect(_cacheKey, _contentHash, _includes, binaryEffect());
+
     _complete->execute(shared_from_this());
 
     _loaderCompleteSlots.clear();
@@ -67,19 +67,19 @@ FileProtocol::load()
             file.close();
             auto worker = AbstractCanvas::defaultCanvas()->getWorker("file-protocol");
 
-            _workerSlots.insert(std::make_pair(worker, worker->message()->connect([=](async::Worker::Ptr, async::Worker::Message message)
+            _workerSlots.insert(std::make_pair(worker, worker->message()->connect([=](async::Worker::Ptr, const async::Worker::Message& message)
             {
                 if (message.type == "complete")
                 {
-                    void* bytes = &*message.data.begin();
-                    data().assign(static_cast<unsigned char*>(bytes), static_cast<unsigned char*>(bytes) + message.data.size());
+                    auto bytes = reinterpret_cast<const unsigned char*>(message.data.data());
+                    data().assign(bytes, bytes + message.data.size());
                     _complete->execute(loader);
                     _runningLoaders.remove(loader);
                     _workerSlots.erase(worker);
                 }
                 else if (message.type == "progress")
                 {
-                    float ratio = *reinterpret_cast<float*>(&*message.data.begin());
+                    auto ratio = message.get<float>();
 
                     _progress->execute(loader, ratio);
                 }
@@ -92,28 +92,16 @@ FileProtocol::load()
                 }
             })));
 
-            auto offset = options->seekingOffset();
-            auto length = options->seekedLength();
-
-            std::vector<char> offsetByteArray(4);
-            offsetByteArray[0] = (offset & 0xff000000) >> 24;
-            offsetByteArray[1] = (offset & 0x00ff0000) >> 16;
-            offsetByteArray[2] = (offset & 0x0000ff00) >> 8;
-            offsetByteArray[3] = (offset & 0x000000ff);
-
-            std::vector<char> lengthByteArray(4);
-            lengthByteArray[0] = (length & 0xff000000) >> 24;
-            lengthByteArray[1] = (length & 0x00ff0000) >> 16;
-            lengthByteArray[2] = (length & 0x0000ff00) >> 8;
-            lengthByteArray[3] = (length & 0x000000ff);
+            int offset = options->seekingOffset();
+            int length = options->seekedLength();
 
-            std::vector<char> input;
+            std::vector<char> input(2 * sizeof(int) + cleanFilename.size());
 
-            input.insert(input.end(), offsetByteArray.begin(), offsetByteArray.end());
-            input.insert(input.end(), lengthByteArray.begin(), lengthByteArray.end());
-            input.insert(input.end(), cleanFilename.begin(), cleanFilename.end());
+            std::memcpy(&input[0], &offset, sizeof(int));
+            std::memcpy(&input[sizeof(int)], &length, sizeof(int));
+            std::copy(cleanFilename.begin(), cleanFilename.end(), input.begin() + 2 * sizeof(int));
 
-            worker->start(input);
+            worker->start(std::move(input));
         }
         else
         {
@@ -28,21 +28,18 @@ namespace minko
 	{
 		MINKO_DEFINE_WORKER(FileProtocolWorker,
 		{
-            auto seekingOffset = (static_cast<int>(static_cast<unsigned char>(input[0])) << 24) +
-                                 (static_cast<int>(static_cast<unsigned char>(input[1])) << 16) +
-                                 (static_cast<int>(static_cast<unsigned char>(input[2])) << 8) +
-                                 static_cast<int>(static_cast<unsigned char>(input[3]));
+			// The input is written by FileProtocol in the same process: no endianness to care about.
+			int seekingOffset;
+			int seekedLength;
 
-            auto seekedLength = (static_cast<int>(static_cast<unsigned char>(input[4])) << 24) +
-                                (static_cast<int>(static_cast<unsigned char>(input[5])) << 16) +
-                                (static_cast<int>(static_cast<unsigned char>(input[6])) << 8) +
-                                static_cast<int>(static_cast<unsigned char>(input[7]));
+			std::memcpy(&seekingOffset, &input[0], sizeof(int));
+			std::memcpy(&seekedLength, &input[sizeof(int)], sizeof(int));
 
-			std::string filename(input.begin() + 8, input.end());
+			std::string filename(input.begin() + 2 * sizeof(int), input.end());
 
 			std::vector<char> output;
 
-			post(Message { "progress" }.set(0.0f));
+			post(Message("progress", 0.0f));
 
 			auto flags = std::ios::in | std::ios::ate | std::ios::binary;
 
@@ -81,18 +78,18 @@ namespace minko
 
                     progress *= 100.0;
 
-                    post(Message { "progress" }.set(progress));
+                    post(Message("progress", progress));
 
 					offset = nextOffset;
 				}
 
 				file.close();
 
-				post(Message{ "complete" }.set(output));
+				post(Message("complete", std::move(output)));
 			}
 			else
 			{
-				post(Message{ "error" });
+				post(Message("error"));
 			}
 		});
 	}
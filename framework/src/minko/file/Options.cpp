@@ -62,6 +62,8 @@ Options::Options() :
     _trackAssetDescriptor(false),
     _skinningFramerate(30),
     _skinningMethod(component::SkinningMethod::HARDWARE),
+    _skinningPalette(component::SkinningPalette::MATRIX_4X4),
+    _compressSkinningAnimations(false),
     _material(nullptr),
     _effect(nullptr),
     _seekingOffset(0),
@@ -118,6 +120,8 @@ Options::Options(const Options& copy) :
     _trackAssetDescriptor(copy._trackAssetDescriptor),
     _skinningFramerate(copy._skinningFramerate),
     _skinningMethod(copy._skinningMethod),
+    _skinningPalette(copy._skinningPalette),
+    _compressSkinningAnimations(copy._compressSkinningAnimations),
     _effect(copy._effect),
     _textureFormats(copy._textureFormats),
     _material(copy._material),
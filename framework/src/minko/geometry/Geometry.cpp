@@ -19,6 +19,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/geometry/Geometry.hpp"
 
+#include "minko/async/ThreadPool.hpp"
+#include "minko/math/BoundingVolumeHierarchy.hpp"
+#include "minko/math/Simd.hpp"
 #include "minko/math/Ray.hpp"
 #include "minko/render/IndexBuffer.hpp"
 #include "minko/render/VertexBuffer.hpp"
@@ -32,7 +35,9 @@ Geometry::Geometry(const std::string& name) :
 	_data(data::Provider::create()),
 	_vertexSize(0),
 	_numVertices(0),
-	_indexBuffer(nullptr)
+	_indexBuffer(nullptr),
+	_triangleHierarchy(nullptr),
+	_triangleHierarchyInvalid(true)
 {
     _data->set("name", name);
     _data->set("uuid", _data->uuid());
@@ -43,7 +48,10 @@ Geometry::Geometry(const Geometry& geometry) :
 	_vertexSize(geometry._vertexSize),
 	_numVertices(geometry._numVertices),
 	_vertexBuffers(geometry._vertexBuffers),
-	_indexBuffer(geometry._indexBuffer)
+	_indexBuffer(geometry._indexBuffer),
+	// the hierarchy is refit in place: each copy builds its own
+	_triangleHierarchy(nullptr),
+	_triangleHierarchyInvalid(true)
 {
 }
 
@@ -75,6 +83,7 @@ Geometry::addVertexBuffer(render::VertexBuffer::Ptr vertexBuffer)
 		_numVertices = bufNumVertices;
 
 	_vertexBuffers.push_back(vertexBuffer);
+	_triangleHierarchyInvalid = true;
 
 	_vbToVertexSizeChangedSlot[vertexBuffer] = vertexBuffer->vertexSizeChanged()->connect(std::bind(
 		&Geometry::vertexSizeChanged,
@@ -99,6 +108,7 @@ Geometry::removeVertexBuffer(std::list<render::VertexBuffer::Ptr>::iterator vert
 	_data->set("vertex.size", _vertexSize);
 
 	_vertexBuffers.erase(vertexBufferIt);
+	_triangleHierarchyInvalid = true;
 
 	if (_vertexBuffers.size() == 0)
 		_numVertices = 0;
@@ -377,12 +387,7 @@ Geometry::vertexSizeChanged(VertexBuffer::Ptr vertexBuffer, int offset)
 void
 Geometry::removeDuplicatedVertices()
 {
-	std::vector<std::vector<float>> vertices;
-
-	for (auto vb : _vertexBuffers)
-		vertices.push_back(vb->data());
-
-	removeDuplicatedVertices(_indexBuffer->data(),	vertices, numVertices());
+	weldVertices();
 }
 
 void
@@ -390,57 +395,286 @@ Geometry::removeDuplicatedVertices(std::vector<unsigned short>&		indices,
 								   std::vector<std::vector<float>>&	vertices,
 								   uint								numVertices)
 {
-	auto newVertexCount = 0;
-	auto newLimit = 0;
+	weldVertices(indices, vertices, numVertices);
+}
 
-	std::unordered_map<std::string, uint> hashToNewVertexId;
-	std::unordered_map<uint, uint> oldVertexIdToNewVertexId;
+Geometry::Ptr
+Geometry::weldVertices(float epsilon)
+{
+	if (!_indexBuffer || _vertexBuffers.empty())
+		return shared_from_this();
 
-	for (uint oldVertexId = 0; oldVertexId < numVertices; ++oldVertexId)
-	{
-		std::string hash;
+	auto vertices = std::vector<std::vector<float>*>();
+
+	for (auto& vertexBuffer : _vertexBuffers)
+		vertices.push_back(&vertexBuffer->data());
+
+	auto numVertices = _numVertices;
+
+	if (auto ushortIndices = _indexBuffer->dataPointer<unsigned short>())
+		numVertices = weldVertices(*ushortIndices, vertices, _numVertices, epsilon);
+	else if (auto uintIndices = _indexBuffer->dataPointer<unsigned int>())
+		numVertices = weldVertices(*uintIndices, vertices, _numVertices, epsilon);
+
+	if (numVertices == _numVertices)
+		return shared_from_this();
+
+	_numVertices = numVertices;
+	_triangleHierarchyInvalid = true;
+
+	for (auto& vertexBuffer : _vertexBuffers)
+		if (vertexBuffer->isReady())
+			vertexBuffer->upload();
+
+	if (_indexBuffer->isReady())
+		_indexBuffer->upload();
+
+	return shared_from_this();
+}
+
+uint
+Geometry::weldVertices(std::vector<unsigned short>&		indices,
+					   std::vector<std::vector<float>>&	vertices,
+					   uint								numVertices,
+					   float							epsilon)
+{
+	auto streams = std::vector<std::vector<float>*>();
+
+	for (auto& stream : vertices)
+		streams.push_back(&stream);
+
+	return weldVertices(indices, streams, numVertices, epsilon);
+}
+
+uint
+Geometry::weldVertices(std::vector<unsigned int>&			indices,
+					   std::vector<std::vector<float>>&	vertices,
+					   uint								numVertices,
+					   float							epsilon)
+{
+	auto streams = std::vector<std::vector<float>*>();
+
+	for (auto& stream : vertices)
+		streams.push_back(&stream);
+
+	return weldVertices(indices, streams, numVertices, epsilon);
+}
+
+template <typename T>
+uint
+Geometry::weldVertices(std::vector<T>&							indices,
+					   const std::vector<std::vector<float>*>&	vertices,
+					   uint										numVertices,
+					   float									epsilon)
+{
+	static const uint numPartitions		= 64;
+	static const uint partitionShift	= 58;
+	static const uint emptySlot			= 0xffffffff;
+
+	if (numVertices == 0)
+		return 0;
+
+	auto pool = async::ThreadPool::defaultPool();
+	const auto invEpsilon = epsilon > 0.f ? 1.f / epsilon : 0.f;
+	auto vertexSizes = std::vector<uint>();
 
-		for (auto& vb : vertices)
+	for (auto stream : vertices)
+		vertexSizes.push_back(stream->size() / numVertices);
+
+	auto sameVertex = [&](uint a, uint b) -> bool
+	{
+		for (uint k = 0; k < vertices.size(); ++k)
 		{
-			auto vertexSize = vb.size() / numVertices;
+			const auto vertexSize = vertexSizes[k];
+			const auto* va = vertices[k]->data() + a * vertexSize;
+			const auto* vb = vertices[k]->data() + b * vertexSize;
 
 			for (uint i = 0; i < vertexSize; ++i)
-				hash += std::to_string(vb[oldVertexId * vertexSize + i]) + " ";
+				if (weldingKey(va[i], invEpsilon) != weldingKey(vb[i], invEpsilon))
+					return false;
 		}
 
-		auto newVertexId = 0;
+		return true;
+	};
 
-		if (!hashToNewVertexId.count(hash))
+	// FNV-1a over the keys of all the attributes, then a final mix so that the partition
+	// (high bits) and the slot (low bits) do not depend on the same values
+	auto hashes = std::vector<uint64_t>(numVertices);
+
+	pool->parallelFor(numVertices, 4096, [&](uint begin, uint end)
+	{
+		for (uint v = begin; v < end; ++v)
 		{
-			newVertexId = newVertexCount++;
-			hashToNewVertexId[hash] = newVertexId;
-			newLimit = 1 + newVertexId;
+			uint64_t hash = 14695981039346656037ull;
 
-			if (newVertexId != oldVertexId)
+			for (uint k = 0; k < vertices.size(); ++k)
 			{
-				for (auto& vb : vertices)
+				const auto vertexSize = vertexSizes[k];
+				const auto* data = vertices[k]->data() + v * vertexSize;
+
+				for (uint i = 0; i < vertexSize; ++i)
+					hash = (hash ^ weldingKey(data[i], invEpsilon)) * 1099511628211ull;
+			}
+
+			hash ^= hash >> 33;
+			hash *= 0xff51afd7ed558ccdull;
+			hash ^= hash >> 33;
+
+			hashes[v] = hash;
+		}
+	});
+
+	// the vertices are bucketed by partition, in order, and each partition gets its own
+	// open addressing table so that the partitions can be processed in parallel
+	auto partitionOffsets = std::vector<uint>(numPartitions + 1, 0);
+	auto tableOffsets = std::vector<uint>(numPartitions + 1, 0);
+	auto partitionVertices = std::vector<uint>(numVertices);
+
+	for (uint v = 0; v < numVertices; ++v)
+		++partitionOffsets[(hashes[v] >> partitionShift) + 1];
+
+	for (uint p = 0; p < numPartitions; ++p)
+	{
+		const auto numPartitionVertices = partitionOffsets[p + 1];
+		uint tableSize = numPartitionVertices > 0 ? 2 : 0;
+
+		while (tableSize != 0 && tableSize < 2 * numPartitionVertices)
+			tableSize <<= 1;
+
+		partitionOffsets[p + 1] += partitionOffsets[p];
+		tableOffsets[p + 1] = tableOffsets[p] + tableSize;
+	}
+
+	{
+		auto cursors = partitionOffsets;
+
+		for (uint v = 0; v < numVertices; ++v)
+			partitionVertices[cursors[hashes[v] >> partitionShift]++] = v;
+	}
+
+	// each vertex is mapped to its first occurrence
+	auto table = std::vector<uint>(tableOffsets.back(), emptySlot);
+	auto firstOccurrences = std::vector<uint>(numVertices);
+
+	pool->parallelFor(numPartitions, 1, [&](uint begin, uint end)
+	{
+		for (uint p = begin; p < end; ++p)
+		{
+			auto* slots = table.data() + tableOffsets[p];
+			const auto mask = tableOffsets[p + 1] - tableOffsets[p] - 1;
+
+			for (uint j = partitionOffsets[p]; j < partitionOffsets[p + 1]; ++j)
+			{
+				const auto v = partitionVertices[j];
+				auto slot = static_cast<uint>(hashes[v]) & mask;
+
+				while (true)
 				{
-					auto vertexSize = vb.size() / numVertices;
+					const auto candidate = slots[slot];
+
+					if (candidate == emptySlot)
+					{
+						slots[slot] = v;
+						firstOccurrences[v] = v;
+						break;
+					}
+
+					if (hashes[candidate] == hashes[v] && sameVertex(candidate, v))
+					{
+						firstOccurrences[v] = candidate;
+						break;
+					}
+
+					slot = (slot + 1) & mask;
+				}
+			}
+		}
+	});
+
+	// the first occurrences come before their duplicates
+	auto newVertexIds = std::vector<uint>(numVertices);
+	uint newNumVertices = 0;
+
+	for (uint v = 0; v < numVertices; ++v)
+		newVertexIds[v] = firstOccurrences[v] == v ? newNumVertices++ : newVertexIds[firstOccurrences[v]];
 
+	if (newNumVertices == numVertices)
+		return numVertices;
+
+	for (uint k = 0; k < vertices.size(); ++k)
+	{
+		const auto vertexSize = vertexSizes[k];
+		const auto& data = *vertices[k];
+		auto weldedData = std::vector<float>(newNumVertices * vertexSize);
+
+		pool->parallelFor(numVertices, 4096, [&](uint begin, uint end)
+		{
+			for (uint v = begin; v < end; ++v)
+				if (firstOccurrences[v] == v)
 					std::copy(
-						vb.begin() + oldVertexId * vertexSize,
-						vb.begin() + (oldVertexId + 1) * vertexSize,
-						vb.begin() + newVertexId * vertexSize
+						data.begin() + v * vertexSize,
+						data.begin() + (v + 1) * vertexSize,
+						weldedData.begin() + newVertexIds[v] * vertexSize
 					);
-				}
-			}
+		});
+
+		vertices[k]->swap(weldedData);
+	}
+
+	pool->parallelFor(indices.size(), 4096, [&](uint begin, uint end)
+	{
+		for (uint i = begin; i < end; ++i)
+			indices[i] = static_cast<T>(newVertexIds[indices[i]]);
+	});
+
+	return newNumVertices;
+}
+
+std::shared_ptr<math::BoundingVolumeHierarchy>
+Geometry::triangleHierarchy()
+{
+	if (_triangleHierarchy && !_triangleHierarchyInvalid)
+		return _triangleHierarchy;
+
+	const auto ushortIndices = _indexBuffer ? _indexBuffer->dataPointer<unsigned short>() : nullptr;
+	const auto uintIndices = _indexBuffer ? _indexBuffer->dataPointer<unsigned int>() : nullptr;
+	const uint numTriangles = (ushortIndices ? ushortIndices->size() : uintIndices ? uintIndices->size() : 0u) / 3u;
+	auto xyzBuffer = vertexBuffer("position");
+
+	if (!xyzBuffer)
+		throw std::logic_error("Ray casting requires positions.");
+
+	const auto* xyzPtr = &xyzBuffer->data()[0] + xyzBuffer->attribute("position").offset;
+	const auto xyzVertexSize = xyzBuffer->vertexSize();
+	auto minBounds = std::vector<math::vec3>(numTriangles);
+	auto maxBounds = std::vector<math::vec3>(numTriangles);
+
+	for (uint i = 0, offset = 0; i < numTriangles; ++i)
+	{
+		for (uint k = 0; k < 3; ++k, ++offset)
+		{
+			const auto vertexId = ushortIndices
+				? static_cast<uint>((*ushortIndices)[offset])
+				: (*uintIndices)[offset];
+			const auto xyz = math::make_vec3(xyzPtr + vertexId * xyzVertexSize);
+
+			minBounds[i] = k == 0 ? xyz : math::min(minBounds[i], xyz);
+			maxBounds[i] = k == 0 ? xyz : math::max(maxBounds[i], xyz);
 		}
-		else
-			newVertexId = hashToNewVertexId[hash];
+	}
 
-		oldVertexIdToNewVertexId[oldVertexId] = newVertexId;
+	// moved positions keep the same triangles: refitting is enough
+	if (_triangleHierarchy && _triangleHierarchy->numItems() == numTriangles)
+		_triangleHierarchy->refit(minBounds, maxBounds);
+	else
+	{
+		_triangleHierarchy = math::BoundingVolumeHierarchy::create();
+		_triangleHierarchy->build(minBounds, maxBounds, math::BoundingVolumeHierarchy::SplitMethod::SURFACE_AREA_HEURISTIC);
 	}
 
-	for (auto& vb : vertices)
-		vb.resize(newLimit * vb.size() / numVertices);
+	_triangleHierarchyInvalid = false;
 
-	for (auto& index : indices)
-		index = oldVertexIdToNewVertexId[index];
+	return _triangleHierarchy;
 }
 
 bool
@@ -453,94 +687,200 @@ Geometry::cast(std::shared_ptr<math::Ray>	ray,
 {
 	static const auto EPSILON = 0.00001f;
 
-	auto hit = false;
-	auto& indicesData = _indexBuffer->data();
-	auto numIndices = indicesData.size();
+	auto hierarchy = triangleHierarchy();
+
+	const auto ushortIndices = _indexBuffer->dataPointer<unsigned short>();
+	const auto uintIndices = _indexBuffer->dataPointer<unsigned int>();
 
 	auto xyzBuffer = vertexBuffer("position");
-	auto& xyzData = xyzBuffer->data();
-	auto xyzPtr = &xyzData[0];
-	auto xyzVertexSize = xyzBuffer->vertexSize();
-	auto xyzOffset = xyzBuffer->attribute("position").offset;
+	const auto* xyzPtr = &xyzBuffer->data()[0] + xyzBuffer->attribute("position").offset;
+	const auto xyzVertexSize = xyzBuffer->vertexSize();
+
+	const auto& origin = ray->origin();
+	const auto& direction = ray->direction();
 
-	auto minDistance = std::numeric_limits<float>::infinity();
 	auto lambda = math::vec2(0.f);
-	auto triangleIndice = -3;
-
-	math::vec3 v0;
-	math::vec3 v1;
-	math::vec3 v2;
-	math::vec3 edge1;
-	math::vec3 edge2;
-	math::vec3 pvec;
-	math::vec3 tvec;
-	math::vec3 qvec;
-
-	auto dot = 0.f;
-	auto invDot = 0.f;
-	auto u = 0.f;
-	auto v = 0.f;
-	auto t = 0.f;
-
-	for (uint i = 0; i < numIndices; i += 3)
+	auto minDistance = std::numeric_limits<float>::infinity();
+	uint hitTriangle = 0;
+
+	auto intersectTriangle = [&](uint triangleId, float& maxDistance) -> bool
 	{
-		v0 = math::make_vec3(xyzPtr + indicesData[i] * xyzVertexSize);
-		v1 = math::make_vec3(xyzPtr + indicesData[i + 1] * xyzVertexSize);
-		v2 = math::make_vec3(xyzPtr + indicesData[i + 2] * xyzVertexSize);
+		const auto offset = triangleId * 3;
+		const auto vertex = [&](uint k)
+		{
+			const auto vertexId = ushortIndices
+				? static_cast<uint>((*ushortIndices)[offset + k])
+				: (*uintIndices)[offset + k];
 
-		edge1 = v1 - v0;
-		edge2 = v2 - v0;
+			return math::make_vec3(xyzPtr + vertexId * xyzVertexSize);
+		};
 
-		pvec = math::cross(ray->direction(), edge2);
-		dot = math::dot(edge1, pvec);
+		const auto v0 = vertex(0);
+		const auto edge1 = vertex(1) - v0;
+		const auto edge2 = vertex(2) - v0;
+
+		const auto pvec = math::cross(direction, edge2);
+		const auto dot = math::dot(edge1, pvec);
 
 		if (dot > -EPSILON && dot < EPSILON)
-			continue;
+			return false;
 
-		invDot = 1.f / dot;
+		const auto invDot = 1.f / dot;
 
-		tvec = ray->origin() - v0;
-		u = math::dot(tvec, pvec) * invDot;
+		const auto tvec = origin - v0;
+		const auto u = math::dot(tvec, pvec) * invDot;
 		if (u < 0.f || u > 1.f)
-			continue;
+			return false;
 
-		qvec = math::cross(tvec, edge1);
-		v = math::dot(ray->direction(), qvec) * invDot;
+		const auto qvec = math::cross(tvec, edge1);
+		const auto v = math::dot(direction, qvec) * invDot;
 		if (v < 0.f || u + v > 1.f)
-			continue;
+			return false;
 
-		t = math::dot(edge2, qvec) * invDot;
-		if (t < minDistance && t > 0)
-		{
-			minDistance = t;
-			distance = t;
-			triangle = i;
-			hit = true;
+		const auto t = math::dot(edge2, qvec) * invDot;
+		if (t <= 0.f || t >= maxDistance)
+			return false;
 
-			if (hitUv)
-			{
-				lambda.x = u;
-				lambda.y = v;
-			}
+		maxDistance = t;
+		lambda = math::vec2(u, v);
 
-			if (hitXyz)
-			{
-				*hitXyz = {
-					ray->origin().x + minDistance * ray->direction().x,
-					ray->origin().y + minDistance * ray->direction().y,
-					ray->origin().z + minDistance * ray->direction().z					
-				};
-			}
-		}
+		return true;
+	};
+
+	if (!hierarchy->castRay(origin, direction, minDistance, hitTriangle, intersectTriangle))
+		return false;
+
+	distance = minDistance;
+	triangle = hitTriangle * 3;
+
+	if (hitXyz)
+		*hitXyz = origin + minDistance * direction;
+
+	if (hitUv)
+		getHitUv(triangle, lambda, hitUv);
+
+	if (hitNormal)
+		getHitNormal(triangle, hitNormal);
+
+	return true;
+}
+
+uint
+Geometry::castRayPacket(const math::vec3*	origins,
+						const math::vec3*	directions,
+						uint				numRays,
+						float*				distances,
+						uint*				triangles)
+{
+	static const auto EPSILON = 0.00001f;
+
+	auto hierarchy = triangleHierarchy();
 
-		if (hitUv)
-			getHitUv(triangle, lambda, hitUv);
+	const auto ushortIndices = _indexBuffer->dataPointer<unsigned short>();
+	const auto uintIndices = _indexBuffer->dataPointer<unsigned int>();
 
-		if (hitNormal)
-			getHitNormal(triangle, hitNormal);
+	auto xyzBuffer = vertexBuffer("position");
+	const auto* xyzPtr = &xyzBuffer->data()[0] + xyzBuffer->attribute("position").offset;
+	const auto xyzVertexSize = xyzBuffer->vertexSize();
+
+	numRays = std::min(numRays, 4u);
+
+	// SoA copy of the packet, the missing rays repeating the first one
+	alignas(16) float packet[6][4];
+
+	for (uint i = 0; i < 4; ++i)
+	{
+		const auto rayId = i < numRays ? i : 0;
+
+		packet[0][i] = origins[rayId].x;
+		packet[1][i] = origins[rayId].y;
+		packet[2][i] = origins[rayId].z;
+		packet[3][i] = directions[rayId].x;
+		packet[4][i] = directions[rayId].y;
+		packet[5][i] = directions[rayId].z;
 	}
 
-	return hit;
+	const auto originX = math::simd::load(packet[0]);
+	const auto originY = math::simd::load(packet[1]);
+	const auto originZ = math::simd::load(packet[2]);
+	const auto directionX = math::simd::load(packet[3]);
+	const auto directionY = math::simd::load(packet[4]);
+	const auto directionZ = math::simd::load(packet[5]);
+	const auto zero = math::simd::splat(0.f);
+	const auto one = math::simd::splat(1.f);
+	const auto epsilon = math::simd::splat(EPSILON);
+
+	// Moller-Trumbore test of one triangle against the 4 rays
+	auto intersectTriangle = [&](uint triangleId, uint rays, float* maxDistances) -> uint
+	{
+		using namespace math::simd;
+
+		const auto offset = triangleId * 3;
+		const auto vertex = [&](uint k)
+		{
+			const auto vertexId = ushortIndices
+				? static_cast<uint>((*ushortIndices)[offset + k])
+				: (*uintIndices)[offset + k];
+
+			return math::make_vec3(xyzPtr + vertexId * xyzVertexSize);
+		};
+
+		const auto v0 = vertex(0);
+		const auto edge1 = vertex(1) - v0;
+		const auto edge2 = vertex(2) - v0;
+
+		const auto e1x = splat(edge1.x);
+		const auto e1y = splat(edge1.y);
+		const auto e1z = splat(edge1.z);
+		const auto e2x = splat(edge2.x);
+		const auto e2y = splat(edge2.y);
+		const auto e2z = splat(edge2.z);
+
+		const auto px = sub(mul(directionY, e2z), mul(directionZ, e2y));
+		const auto py = sub(mul(directionZ, e2x), mul(directionX, e2z));
+		const auto pz = sub(mul(directionX, e2y), mul(directionY, e2x));
+		const auto dot = madd(e1x, px, madd(e1y, py, mul(e1z, pz)));
+		const auto invDot = div(one, dot);
+
+		const auto tx = sub(originX, splat(v0.x));
+		const auto ty = sub(originY, splat(v0.y));
+		const auto tz = sub(originZ, splat(v0.z));
+		const auto u = mul(madd(tx, px, madd(ty, py, mul(tz, pz))), invDot);
+
+		const auto qx = sub(mul(ty, e1z), mul(tz, e1y));
+		const auto qy = sub(mul(tz, e1x), mul(tx, e1z));
+		const auto qz = sub(mul(tx, e1y), mul(ty, e1x));
+		const auto v = mul(madd(directionX, qx, madd(directionY, qy, mul(directionZ, qz))), invDot);
+		const auto t = mul(madd(e2x, qx, madd(e2y, qy, mul(e2z, qz))), invDot);
+
+		// a NaN distance fails the last test
+		const auto missed = lessThan(max(dot, sub(zero, dot)), epsilon)
+			| lessThan(u, zero)
+			| lessThan(v, zero)
+			| lessThan(one, add(u, v))
+			| lessEqual(t, zero)
+			| (~lessThan(t, loadu(maxDistances)) & 0xfu);
+		const auto hitRays = rays & ~missed;
+
+		alignas(16) float hitDistances[4];
+
+		store(hitDistances, t);
+		for (auto hits = hitRays; hits != 0u; hits &= hits - 1u)
+		{
+			const auto rayId = math::countTrailingZeros(hits);
+
+			maxDistances[rayId] = hitDistances[rayId];
+		}
+
+		return hitRays;
+	};
+
+	const auto hitRays = hierarchy->castRayPacket(origins, directions, numRays, distances, triangles, intersectTriangle);
+
+	for (auto hits = hitRays; hits != 0u; hits &= hits - 1u)
+		triangles[math::countTrailingZeros(hits)] *= 3;
+
+	return hitRays;
 }
 
 void
@@ -551,16 +891,18 @@ Geometry::getHitUv(uint triangle, math::vec2& lambda, math::vec2* hitUv)
 	auto uvPtr = &uvData[0];
 	auto uvVertexSize = uvBuffer->vertexSize();
 	auto uvOffset = uvBuffer->attribute("uv").offset;
-	auto& indicesData = _indexBuffer->data();
+	auto i0 = _indexBuffer->index(triangle);
+	auto i1 = _indexBuffer->index(triangle + 1);
+	auto i2 = _indexBuffer->index(triangle + 2);
 
-	auto u0 = uvData[indicesData[triangle] * uvVertexSize + uvOffset];
-	auto v0 = uvData[indicesData[triangle] * uvVertexSize + uvOffset + 1];
+	auto u0 = uvData[i0 * uvVertexSize + uvOffset];
+	auto v0 = uvData[i0 * uvVertexSize + uvOffset + 1];
 
-	auto u1 = uvData[indicesData[triangle + 1] * uvVertexSize + uvOffset];
-	auto v1 = uvData[indicesData[triangle + 1] * uvVertexSize + uvOffset + 1];
+	auto u1 = uvData[i1 * uvVertexSize + uvOffset];
+	auto v1 = uvData[i1 * uvVertexSize + uvOffset + 1];
 
-	auto u2 = uvData[indicesData[triangle + 2] * uvVertexSize + uvOffset];
-	auto v2 = uvData[indicesData[triangle + 2] * uvVertexSize + uvOffset + 1];
+	auto u2 = uvData[i2 * uvVertexSize + uvOffset];
+	auto v2 = uvData[i2 * uvVertexSize + uvOffset + 1];
 
 	auto z = 1.f - lambda.x - lambda.y;
 
@@ -578,11 +920,10 @@ Geometry::getHitNormal(uint triangle, math::vec3* hitNormal)
 	auto normalPtr = &normalData[0];
 	auto normalVertexSize = normalBuffer->vertexSize();
 	auto normalOffset = normalBuffer->attribute("normal").offset;
-	auto& indicesData = _indexBuffer->data();
 
-	auto v0 = math::make_vec3(normalPtr + indicesData[triangle] * normalVertexSize + normalOffset);
-	auto v1 = math::make_vec3(normalPtr + indicesData[triangle] * normalVertexSize + normalOffset);
-	auto v2 = math::make_vec3(normalPtr + indicesData[triangle] * normalVertexSize + normalOffset);
+	auto v0 = math::make_vec3(normalPtr + _indexBuffer->index(triangle) * normalVertexSize + normalOffset);
+	auto v1 = math::make_vec3(normalPtr + _indexBuffer->index(triangle + 1) * normalVertexSize + normalOffset);
+	auto v2 = math::make_vec3(normalPtr + _indexBuffer->index(triangle + 2) * normalVertexSize + normalOffset);
 
 	auto edge1 = math::normalize(v1 - v0);
 	auto edge2 = math::normalize(v2 - v0);
@@ -21,6 +21,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include <minko/scene/Node.hpp>
 #include <minko/geometry/Bone.hpp>
+#include <minko/animation/AnimationClip.hpp>
 
 using namespace minko;
 using namespace minko::scene;
@@ -31,7 +32,12 @@ Skin::Skin(unsigned int numBones, unsigned int duration, unsigned int numFrames)
 	_numBones(numBones),
 	_duration(duration),
 	_timeFactor(duration > 0 ? numFrames / float(duration) : 0.0f),
+	_numFrames(numFrames),
 	_boneMatricesPerFrame(numFrames, std::vector<math::mat4>(numBones)),
+	_clip(nullptr),
+	_clipCursors(),
+	_clipMatrices(),
+	_clipFrameId(-1),
 	_maxNumVertexBones(0),
 	_numVertexBones(),
 	_vertexBones(),
@@ -44,7 +50,12 @@ Skin::Skin(const Skin& skin) :
 	_numBones(skin._numBones),
 	_duration(skin._duration),
 	_timeFactor(skin._timeFactor),
+	_numFrames(skin._numFrames),
 	_boneMatricesPerFrame(skin._boneMatricesPerFrame),
+	_clip(skin._clip),
+	_clipCursors(),
+	_clipMatrices(),
+	_clipFrameId(-1),
 	_maxNumVertexBones(skin._maxNumVertexBones),
 	_numVertexBones(skin._numVertexBones),
 	_vertexBones(skin._vertexBones),
@@ -70,9 +81,65 @@ Skin::matrix(unsigned int		frameId,
 	assert(frameId < numFrames() && boneId < numBones());
 #endif // DEBUG_SKINNING
 
+	if (_clip)
+		throw std::logic_error("The matrices of a compressed skin cannot be modified.");
+
     _boneMatricesPerFrame[frameId][boneId] = value;
 }
 
+const std::vector<math::mat4>&
+Skin::matrices(unsigned int frameId) const
+{
+	if (!_clip)
+		return _boneMatricesPerFrame[frameId];
+
+	// the clip time unit is the frame: sampling at a frame id returns its key as is
+	if (_clipFrameId != static_cast<int>(frameId))
+	{
+		_clip->sample(frameId, _clipCursors, _clipMatrices);
+		_clipFrameId = frameId;
+	}
+
+	return _clipMatrices;
+}
+
+std::vector<std::vector<math::mat4>>
+Skin::getBoneMatricesPerFrame()
+{
+	if (!_clip)
+		return _boneMatricesPerFrame;
+
+	auto boneMatricesPerFrame = std::vector<std::vector<math::mat4>>(_numFrames);
+
+	for (uint frameId = 0; frameId < _numFrames; ++frameId)
+		boneMatricesPerFrame[frameId] = matrices(frameId);
+
+	return boneMatricesPerFrame;
+}
+
+Skin::Ptr
+Skin::compress()
+{
+	if (_clip || _numFrames == 0 || _numBones == 0)
+		return shared_from_this();
+
+	auto timetables = std::vector<std::vector<uint>>(_numBones, std::vector<uint>(_numFrames));
+	auto matrices = std::vector<std::vector<math::mat4>>(_numBones, std::vector<math::mat4>(_numFrames));
+
+	for (uint boneId = 0; boneId < _numBones; ++boneId)
+		for (uint frameId = 0; frameId < _numFrames; ++frameId)
+		{
+			timetables[boneId][frameId] = frameId;
+			matrices[boneId][frameId] = _boneMatricesPerFrame[frameId][boneId];
+		}
+
+	_clip = animation::AnimationClip::create(_numFrames, timetables, matrices);
+	_clipFrameId = -1;
+	std::vector<std::vector<math::mat4>>().swap(_boneMatricesPerFrame);
+
+	return shared_from_this();
+}
+
 Skin::Ptr
 Skin::reorganizeByVertices()
 {
@@ -84,9 +151,30 @@ Skin::reorganizeByVertices()
 	const unsigned int numVertices	= lastId + 1;
 	const unsigned int numBones		= _bones.size();
 
-	_numVertexBones		.resize(numVertices,			0);
-	_vertexBones		.resize(numVertices * numBones, 0);
-	_vertexBoneWeights	.resize(numVertices * numBones, 0.0f);
+	_numVertexBones.resize(numVertices, 0);
+
+	// first pass to size the vertex arrays with the actual max. number of bones per vertex
+	for (unsigned int boneId = 0; boneId < numBones; ++boneId)
+	{
+		auto bone = _bones[boneId];
+
+		const std::vector<unsigned short>&	vertexIds		= bone->vertexIds();
+		const std::vector<float>&			vertexWeights	= bone->vertexWeights();
+
+		for (unsigned int i = 0; i < vertexIds.size(); ++i)
+			if (vertexWeights[i] > 0.0f)
+				++_numVertexBones[vertexIds[i]];
+	}
+
+	_maxNumVertexBones = 0;
+	for (unsigned int vId = 0; vId < numVertices; ++vId)
+	{
+		_maxNumVertexBones = std::max(_maxNumVertexBones, _numVertexBones[vId]);
+		_numVertexBones[vId] = 0;
+	}
+
+	_vertexBones		.resize(numVertices * _maxNumVertexBones, 0);
+	_vertexBoneWeights	.resize(numVertices * _maxNumVertexBones, 0.0f);
 
 	for (unsigned int boneId = 0; boneId < numBones; ++boneId)
 	{
@@ -114,13 +202,192 @@ Skin::reorganizeByVertices()
 			}
 	}
 
-	_maxNumVertexBones = 0;
-	for (unsigned int vId = 0; vId < numVertices; ++vId)
-		_maxNumVertexBones = std::max(_maxNumVertexBones, _numVertexBones[vId]);
-
 	return shared_from_this();
 }
 
+void
+Skin::computeBonePalette(const std::vector<math::mat4>& boneMatrices, BonePalette& palette)
+{
+	palette.resize(boneMatrices.size() * 12);
+
+	computeBonePalette(boneMatrices, palette.data());
+}
+
+void
+Skin::computeBonePalette(const std::vector<math::mat4>& boneMatrices, float* palette)
+{
+	for (const auto& boneMatrix : boneMatrices)
+	{
+		for (auto i = 0; i < 3; ++i)
+			for (auto j = 0; j < 4; ++j)
+				*palette++ = boneMatrix[j][i];
+	}
+}
+
+void
+Skin::computeDualQuaternionPalette(const std::vector<math::mat4>& boneMatrices, float* palette)
+{
+	for (const auto& boneMatrix : boneMatrices)
+	{
+		auto rotation = math::mat3(
+			math::normalize(math::vec3(boneMatrix[0])),
+			math::normalize(math::vec3(boneMatrix[1])),
+			math::normalize(math::vec3(boneMatrix[2]))
+		);
+		auto real = math::quat_cast(rotation);
+		// dual = 1/2 * translation * real
+		auto dual = .5f * (math::quat(0.f, math::vec3(boneMatrix[3])) * real);
+
+		*palette++ = real.x;
+		*palette++ = real.y;
+		*palette++ = real.z;
+		*palette++ = real.w;
+		*palette++ = dual.x;
+		*palette++ = dual.y;
+		*palette++ = dual.z;
+		*palette++ = dual.w;
+	}
+}
+
+void
+Skin::skinVertices(const BonePalette&	palette,
+				   uint					firstVertexId,
+				   uint					lastVertexId,
+				   const float*			positions,
+				   float*				outPositions,
+				   uint					positionStride,
+				   const float*			normals,
+				   float*				outNormals,
+				   uint					normalStride) const
+{
+#ifdef DEBUG_SKINNING
+	assert(lastVertexId <= numVertices() && palette.size() == _numBones * 12);
+#endif // DEBUG_SKINNING
+
+	const float*		bonePalette	= palette.data();
+	const unsigned int*	boneIds		= _vertexBones.data() + firstVertexId * _maxNumVertexBones;
+	const float*		boneWeights	= _vertexBoneWeights.data() + firstVertexId * _maxNumVertexBones;
+
+	for (auto vId = firstVertexId; vId < lastVertexId; ++vId)
+	{
+		const auto	numVertexBones	= _numVertexBones[vId];
+		const float* position		= positions + vId * positionStride;
+		float*		outPosition		= outPositions + vId * positionStride;
+
+#if MINKO_SIMD == MINKO_SIMD_SSE2
+		__m128 r0 = _mm_setzero_ps();
+		__m128 r1 = _mm_setzero_ps();
+		__m128 r2 = _mm_setzero_ps();
+
+		for (unsigned int j = 0; j < numVertexBones; ++j)
+		{
+			const float*	m = bonePalette + boneIds[j] * 12;
+			const __m128	w = _mm_set1_ps(boneWeights[j]);
+
+			r0 = _mm_add_ps(r0, _mm_mul_ps(w, _mm_load_ps(m)));
+			r1 = _mm_add_ps(r1, _mm_mul_ps(w, _mm_load_ps(m + 4)));
+			r2 = _mm_add_ps(r2, _mm_mul_ps(w, _mm_load_ps(m + 8)));
+		}
+
+		// (r0.p, r1.p, r2.p) computed as the sum of the columns of the transposed products
+		auto transform = [&](__m128 v, float* out)
+		{
+			__m128 x = _mm_mul_ps(r0, v);
+			__m128 y = _mm_mul_ps(r1, v);
+			__m128 z = _mm_mul_ps(r2, v);
+			__m128 zero = _mm_setzero_ps();
+			float result[4];
+
+			_MM_TRANSPOSE4_PS(x, y, z, zero);
+			_mm_storeu_ps(result, _mm_add_ps(_mm_add_ps(x, y), _mm_add_ps(z, zero)));
+
+			out[0] = result[0];
+			out[1] = result[1];
+			out[2] = result[2];
+		};
+
+		transform(_mm_setr_ps(position[0], position[1], position[2], 1.f), outPosition);
+
+		if (normals != nullptr)
+		{
+			const float* normal = normals + vId * normalStride;
+
+			transform(_mm_setr_ps(normal[0], normal[1], normal[2], 0.f), outNormals + vId * normalStride);
+		}
+#elif MINKO_SIMD == MINKO_SIMD_NEON
+		float32x4_t r0 = vdupq_n_f32(0.f);
+		float32x4_t r1 = vdupq_n_f32(0.f);
+		float32x4_t r2 = vdupq_n_f32(0.f);
+
+		for (unsigned int j = 0; j < numVertexBones; ++j)
+		{
+			const float*	m = bonePalette + boneIds[j] * 12;
+			const float		w = boneWeights[j];
+
+			r0 = vmlaq_n_f32(r0, vld1q_f32(m), w);
+			r1 = vmlaq_n_f32(r1, vld1q_f32(m + 4), w);
+			r2 = vmlaq_n_f32(r2, vld1q_f32(m + 8), w);
+		}
+
+		auto transform = [&](float32x4_t v, float* out)
+		{
+			float32x4_t x = vmulq_f32(r0, v);
+			float32x4_t y = vmulq_f32(r1, v);
+			float32x4_t z = vmulq_f32(r2, v);
+			float32x2_t xy = vpadd_f32(
+				vadd_f32(vget_low_f32(x), vget_high_f32(x)),
+				vadd_f32(vget_low_f32(y), vget_high_f32(y))
+			);
+			float32x2_t zz = vadd_f32(vget_low_f32(z), vget_high_f32(z));
+
+			vst1_f32(out, xy);
+			out[2] = vget_lane_f32(zz, 0) + vget_lane_f32(zz, 1);
+		};
+
+		const float p[4] = { position[0], position[1], position[2], 1.f };
+
+		transform(vld1q_f32(p), outPosition);
+
+		if (normals != nullptr)
+		{
+			const float* normal = normals + vId * normalStride;
+			const float n[4] = { normal[0], normal[1], normal[2], 0.f };
+
+			transform(vld1q_f32(n), outNormals + vId * normalStride);
+		}
+#else
+		float m[12] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+
+		for (unsigned int j = 0; j < numVertexBones; ++j)
+		{
+			const float*	boneMatrix	= bonePalette + boneIds[j] * 12;
+			const float		w			= boneWeights[j];
+
+			for (auto k = 0; k < 12; ++k)
+				m[k] += w * boneMatrix[k];
+		}
+
+		const float p[3] = { position[0], position[1], position[2] };
+
+		for (auto i = 0; i < 3; ++i)
+			outPosition[i] = m[i * 4] * p[0] + m[i * 4 + 1] * p[1] + m[i * 4 + 2] * p[2] + m[i * 4 + 3];
+
+		if (normals != nullptr)
+		{
+			const float*	normal		= normals + vId * normalStride;
+			float*			outNormal	= outNormals + vId * normalStride;
+			const float		n[3]		= { normal[0], normal[1], normal[2] };
+
+			for (auto i = 0; i < 3; ++i)
+				outNormal[i] = m[i * 4] * n[0] + m[i * 4 + 1] * n[1] + m[i * 4 + 2] * n[2];
+		}
+#endif
+
+		boneIds		+= _maxNumVertexBones;
+		boneWeights	+= _maxNumVertexBones;
+	}
+}
+
 unsigned short
 Skin::lastVertexId() const
 {
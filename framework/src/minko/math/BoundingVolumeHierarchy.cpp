@@ -0,0 +1,649 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/math/BoundingVolumeHierarchy.hpp"
+
+using namespace minko;
+using namespace minko::math;
+
+/*static*/ const int BoundingVolumeHierarchy::EMPTY_CHILD = std::numeric_limits<int>::min();
+
+namespace
+{
+	// bounds of the empty children: always outside, and neutral for unions
+	const float EMPTY_MIN = 1e30f;
+	const float EMPTY_MAX = -1e30f;
+
+	// number of candidate split planes per axis of the surface area heuristic
+	const uint NUM_BINS = 12;
+
+	float
+	halfArea(const math::vec3& minBound, const math::vec3& maxBound)
+	{
+		const auto size = maxBound - minBound;
+
+		return size.x * size.y + size.y * size.z + size.z * size.x;
+	}
+
+	// node of the hierarchy to traverse with the rays of a packet that hit its box
+	struct PacketEntry
+	{
+		int		child;
+		uint	rays;
+		float	distance;
+	};
+}
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy() :
+	_splitMethod(SplitMethod::MEDIAN)
+{
+}
+
+void
+BoundingVolumeHierarchy::bounds(math::vec3& minBound, math::vec3& maxBound) const
+{
+	minBound = math::vec3(EMPTY_MIN);
+	maxBound = math::vec3(EMPTY_MAX);
+
+	if (_nodes.empty())
+		return;
+
+	const auto& root = _nodes[0];
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		minBound = math::min(minBound, math::vec3(root.minX[i], root.minY[i], root.minZ[i]));
+		maxBound = math::max(maxBound, math::vec3(root.maxX[i], root.maxY[i], root.maxZ[i]));
+	}
+}
+
+void
+BoundingVolumeHierarchy::build(const std::vector<math::vec3>&	minBounds,
+							   const std::vector<math::vec3>&	maxBounds,
+							   SplitMethod						splitMethod)
+{
+	const uint numItems = minBounds.size();
+	auto centers = std::vector<math::vec3>(numItems);
+
+	_nodes.clear();
+	_items.resize(numItems);
+	_splitMethod = splitMethod;
+
+	for (uint i = 0; i < numItems; ++i)
+	{
+		_items[i] = i;
+		centers[i] = (minBounds[i] + maxBounds[i]) * .5f;
+	}
+
+	if (numItems == 0)
+		return;
+
+	_nodes.reserve(numItems / 2 + 1);
+	buildNode(0, numItems, -1, 0, centers, minBounds, maxBounds);
+	refit(minBounds, maxBounds);
+}
+
+int
+BoundingVolumeHierarchy::buildNode(uint								first,
+								   uint								last,
+								   int								parent,
+								   uint								depth,
+								   const std::vector<math::vec3>&	centers,
+								   const std::vector<math::vec3>&	minBounds,
+								   const std::vector<math::vec3>&	maxBounds)
+{
+	const int nodeId = _nodes.size();
+
+	_nodes.push_back(Node());
+
+	auto& node = _nodes.back();
+
+	node.firstItem = first;
+	node.numItems = last - first;
+	node.parent = parent;
+	node.depth = depth;
+
+	for (auto i = 0; i < 4; ++i)
+		node.children[i] = EMPTY_CHILD;
+
+	if (last - first <= 4)
+	{
+		for (auto i = first; i < last; ++i)
+			node.children[i - first] = ~static_cast<int>(_items[i]);
+
+		return nodeId;
+	}
+
+	// 4 children: the items are split in halves, then each half in halves again
+	const auto middle = splitItems(first, last, centers, minBounds, maxBounds);
+	const uint bounds[5] = {
+		first,
+		splitItems(first, middle, centers, minBounds, maxBounds),
+		middle,
+		splitItems(middle, last, centers, minBounds, maxBounds),
+		last
+	};
+
+	for (auto i = 0; i < 4; ++i)
+	{
+		const auto child = bounds[i + 1] - bounds[i] == 1
+			? ~static_cast<int>(_items[bounds[i]])
+			: buildNode(bounds[i], bounds[i + 1], nodeId, depth + 1, centers, minBounds, maxBounds);
+
+		// buildNode() may have reallocated the nodes
+		_nodes[nodeId].children[i] = child;
+	}
+
+	return nodeId;
+}
+
+uint
+BoundingVolumeHierarchy::splitItems(uint							first,
+									uint							last,
+									const std::vector<math::vec3>&	centers,
+									const std::vector<math::vec3>&	minBounds,
+									const std::vector<math::vec3>&	maxBounds)
+{
+	auto minCenter = centers[_items[first]];
+	auto maxCenter = minCenter;
+
+	for (auto i = first + 1; i < last; ++i)
+	{
+		minCenter = math::min(minCenter, centers[_items[i]]);
+		maxCenter = math::max(maxCenter, centers[_items[i]]);
+	}
+
+	const auto extent = maxCenter - minCenter;
+	const uint largestAxis = extent.x > extent.y
+		? (extent.x > extent.z ? 0 : 2)
+		: (extent.y > extent.z ? 1 : 2);
+
+	if (_splitMethod == SplitMethod::MEDIAN || last - first <= 4)
+		return splitItemsAtMedian(first, last, largestAxis, centers);
+
+	// binned surface area heuristic: the centers are sorted in NUM_BINS slices along each axis
+	// and the split between two slices minimizing area(left) * n(left) + area(right) * n(right)
+	// is kept
+	auto bestCost = std::numeric_limits<float>::infinity();
+	uint bestAxis = 0;
+	uint bestBin = 0;
+
+	const auto binId = [&](uint item, uint axis)
+	{
+		const auto bin = static_cast<uint>((centers[item][axis] - minCenter[axis]) / extent[axis] * NUM_BINS);
+
+		return std::min(bin, NUM_BINS - 1);
+	};
+
+	for (uint axis = 0; axis < 3; ++axis)
+	{
+		if (extent[axis] <= 0.f)
+			continue;
+
+		uint binCounts[NUM_BINS] = { 0 };
+		math::vec3 binMin[NUM_BINS];
+		math::vec3 binMax[NUM_BINS];
+
+		for (uint i = first; i < last; ++i)
+		{
+			const auto item = _items[i];
+			const auto bin = binId(item, axis);
+
+			binMin[bin] = binCounts[bin] == 0 ? minBounds[item] : math::min(binMin[bin], minBounds[item]);
+			binMax[bin] = binCounts[bin] == 0 ? maxBounds[item] : math::max(binMax[bin], maxBounds[item]);
+			++binCounts[bin];
+		}
+
+		// cost of the right side of each split, then sweep from the left
+		float rightCosts[NUM_BINS];
+		auto count = 0u;
+		auto boxMin = math::vec3(EMPTY_MIN);
+		auto boxMax = math::vec3(EMPTY_MAX);
+
+		for (auto bin = NUM_BINS - 1; bin > 0; --bin)
+		{
+			if (binCounts[bin] != 0)
+			{
+				boxMin = math::min(boxMin, binMin[bin]);
+				boxMax = math::max(boxMax, binMax[bin]);
+				count += binCounts[bin];
+			}
+			rightCosts[bin] = count == 0 ? 0.f : halfArea(boxMin, boxMax) * count;
+		}
+
+		count = 0u;
+		boxMin = math::vec3(EMPTY_MIN);
+		boxMax = math::vec3(EMPTY_MAX);
+
+		for (uint bin = 0; bin < NUM_BINS - 1; ++bin)
+		{
+			if (binCounts[bin] != 0)
+			{
+				boxMin = math::min(boxMin, binMin[bin]);
+				boxMax = math::max(boxMax, binMax[bin]);
+				count += binCounts[bin];
+			}
+
+			if (count == 0 || count == last - first)
+				continue;
+
+			const auto cost = halfArea(boxMin, boxMax) * count + rightCosts[bin + 1];
+
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = bin;
+			}
+		}
+	}
+
+	if (bestCost == std::numeric_limits<float>::infinity())
+		return splitItemsAtMedian(first, last, largestAxis, centers);
+
+	const auto middle = std::partition(
+		_items.begin() + first,
+		_items.begin() + last,
+		[&](uint item) { return binId(item, bestAxis) <= bestBin; }
+	);
+
+	return middle - _items.begin();
+}
+
+uint
+BoundingVolumeHierarchy::splitItemsAtMedian(uint first, uint last, uint axis, const std::vector<math::vec3>& centers)
+{
+	const auto middle = first + (last - first) / 2;
+
+	std::nth_element(
+		_items.begin() + first,
+		_items.begin() + middle,
+		_items.begin() + last,
+		[&](uint a, uint b) { return centers[a][axis] < centers[b][axis]; }
+	);
+
+	return middle;
+}
+
+void
+BoundingVolumeHierarchy::refit(const std::vector<math::vec3>& minBounds, const std::vector<math::vec3>& maxBounds)
+{
+	// children are always stored after their parent
+	for (auto nodeId = _nodes.size(); nodeId-- > 0;)
+	{
+		auto& node = _nodes[nodeId];
+
+		for (auto i = 0; i < 4; ++i)
+		{
+			const auto child = node.children[i];
+
+			if (child == EMPTY_CHILD)
+			{
+				node.minX[i] = node.minY[i] = node.minZ[i] = EMPTY_MIN;
+				node.maxX[i] = node.maxY[i] = node.maxZ[i] = EMPTY_MAX;
+			}
+			else if (child < 0)
+			{
+				const auto& min = minBounds[~child];
+				const auto& max = maxBounds[~child];
+
+				node.minX[i] = min.x;
+				node.minY[i] = min.y;
+				node.minZ[i] = min.z;
+				node.maxX[i] = max.x;
+				node.maxY[i] = max.y;
+				node.maxZ[i] = max.z;
+			}
+			else
+			{
+				const auto& childNode = _nodes[child];
+
+				node.minX[i] = std::min(std::min(childNode.minX[0], childNode.minX[1]), std::min(childNode.minX[2], childNode.minX[3]));
+				node.minY[i] = std::min(std::min(childNode.minY[0], childNode.minY[1]), std::min(childNode.minY[2], childNode.minY[3]));
+				node.minZ[i] = std::min(std::min(childNode.minZ[0], childNode.minZ[1]), std::min(childNode.minZ[2], childNode.minZ[3]));
+				node.maxX[i] = std::max(std::max(childNode.maxX[0], childNode.maxX[1]), std::max(childNode.maxX[2], childNode.maxX[3]));
+				node.maxY[i] = std::max(std::max(childNode.maxY[0], childNode.maxY[1]), std::max(childNode.maxY[2], childNode.maxY[3]));
+				node.maxZ[i] = std::max(std::max(childNode.maxZ[0], childNode.maxZ[1]), std::max(childNode.maxZ[2], childNode.maxZ[3]));
+			}
+		}
+	}
+}
+
+void
+BoundingVolumeHierarchy::testPlanes(const std::array<math::vec4, 6>& planes, std::vector<uint32_t>& visibleItems) const
+{
+	visibleItems.assign((_items.size() + 31) >> 5, 0u);
+
+	if (_nodes.empty())
+		return;
+
+	const auto zero = simd::splat(0.f);
+	const uint allPlanes = (1u << planes.size()) - 1u;
+	// node to test and planes its box is not known to be entirely inside of
+	auto stack = std::vector<std::pair<int, uint>>();
+
+	stack.reserve(64);
+	stack.push_back(std::make_pair(0, allPlanes));
+
+	while (!stack.empty())
+	{
+		const auto nodeId = stack.back().first;
+		const auto planeMask = stack.back().second;
+		const auto& node = _nodes[nodeId];
+		uint childPlaneMasks[4] = { planeMask, planeMask, planeMask, planeMask };
+		uint outside = 0u;
+
+		stack.pop_back();
+
+		for (uint planeId = 0; planeId < planes.size() && outside != 0xfu; ++planeId)
+		{
+			if ((planeMask & (1u << planeId)) == 0u)
+				continue;
+
+			const auto& plane = planes[planeId];
+			const auto a = simd::splat(plane.x);
+			const auto b = simd::splat(plane.y);
+			const auto c = simd::splat(plane.z);
+			const auto d = simd::splat(plane.w);
+
+			// corners of the 4 boxes the farthest and the nearest along the plane normal
+			const auto farX = simd::load(plane.x >= 0.f ? node.maxX : node.minX);
+			const auto farY = simd::load(plane.y >= 0.f ? node.maxY : node.minY);
+			const auto farZ = simd::load(plane.z >= 0.f ? node.maxZ : node.minZ);
+			const auto nearX = simd::load(plane.x >= 0.f ? node.minX : node.maxX);
+			const auto nearY = simd::load(plane.y >= 0.f ? node.minY : node.maxY);
+			const auto nearZ = simd::load(plane.z >= 0.f ? node.minZ : node.maxZ);
+
+			const auto farDistance = simd::madd(a, farX, simd::madd(b, farY, simd::madd(c, farZ, d)));
+			const auto nearDistance = simd::madd(a, nearX, simd::madd(b, nearY, simd::madd(c, nearZ, d)));
+
+			outside |= simd::lessThan(farDistance, zero);
+
+			// boxes entirely inside this plane do not test it anymore
+			auto inside = ~simd::lessThan(nearDistance, zero) & 0xfu;
+
+			while (inside != 0u)
+			{
+				childPlaneMasks[countTrailingZeros(inside)] &= ~(1u << planeId);
+				inside &= inside - 1u;
+			}
+		}
+
+		for (auto i = 0; i < 4; ++i)
+		{
+			const auto child = node.children[i];
+
+			if (child == EMPTY_CHILD || (outside & (1u << i)) != 0u)
+				continue;
+
+			if (child < 0 || childPlaneMasks[i] == 0u)
+				setVisible(child, visibleItems);
+			else
+				stack.push_back(std::make_pair(child, childPlaneMasks[i]));
+		}
+	}
+}
+
+void
+BoundingVolumeHierarchy::setVisible(int child, std::vector<uint32_t>& visibleItems) const
+{
+	if (child < 0)
+	{
+		const uint itemId = ~child;
+
+		visibleItems[itemId >> 5] |= 1u << (itemId & 31);
+
+		return;
+	}
+
+	const auto& node = _nodes[child];
+
+	for (auto i = node.firstItem; i < node.firstItem + node.numItems; ++i)
+		visibleItems[_items[i] >> 5] |= 1u << (_items[i] & 31);
+}
+
+bool
+BoundingVolumeHierarchy::castRay(const math::vec3&		origin,
+								 const math::vec3&		direction,
+								 float&					distance,
+								 uint&					item,
+								 const RayItemFunction&	intersectItem) const
+{
+	if (_nodes.empty())
+		return false;
+
+	// a null component would give NaNs for the boxes it starts in
+	const auto invDirection = math::vec3(
+		1.f / (std::abs(direction.x) > 1e-30f ? direction.x : 1e-30f),
+		1.f / (std::abs(direction.y) > 1e-30f ? direction.y : 1e-30f),
+		1.f / (std::abs(direction.z) > 1e-30f ? direction.z : 1e-30f)
+	);
+	const auto originX = simd::splat(origin.x);
+	const auto originY = simd::splat(origin.y);
+	const auto originZ = simd::splat(origin.z);
+	const auto invX = simd::splat(invDirection.x);
+	const auto invY = simd::splat(invDirection.y);
+	const auto invZ = simd::splat(invDirection.z);
+	const auto zero = simd::splat(0.f);
+	auto hit = false;
+	// child to visit and distance at which the ray enters its box
+	auto stack = std::vector<std::pair<int, float>>();
+
+	stack.reserve(64);
+	stack.push_back(std::make_pair(0, 0.f));
+
+	while (!stack.empty())
+	{
+		const auto child = stack.back().first;
+		const auto entry = stack.back().second;
+
+		stack.pop_back();
+
+		if (entry >= distance)
+			continue;
+
+		if (child < 0)
+		{
+			if (intersectItem(~child, distance))
+			{
+				item = ~child;
+				hit = true;
+			}
+
+			continue;
+		}
+
+		const auto& node = _nodes[child];
+
+		// slab test of the 4 boxes, using the planes of each axis in the order the ray crosses
+		// them: the empty children, whose min is greater than their max, are always missed
+		const auto nearX = simd::mul(simd::sub(simd::load(invDirection.x >= 0.f ? node.minX : node.maxX), originX), invX);
+		const auto nearY = simd::mul(simd::sub(simd::load(invDirection.y >= 0.f ? node.minY : node.maxY), originY), invY);
+		const auto nearZ = simd::mul(simd::sub(simd::load(invDirection.z >= 0.f ? node.minZ : node.maxZ), originZ), invZ);
+		const auto farX = simd::mul(simd::sub(simd::load(invDirection.x >= 0.f ? node.maxX : node.minX), originX), invX);
+		const auto farY = simd::mul(simd::sub(simd::load(invDirection.y >= 0.f ? node.maxY : node.minY), originY), invY);
+		const auto farZ = simd::mul(simd::sub(simd::load(invDirection.z >= 0.f ? node.maxZ : node.minZ), originZ), invZ);
+
+		const auto tNear = simd::max(simd::max(nearX, nearY), simd::max(nearZ, zero));
+		const auto tFar = simd::min(simd::min(farX, farY), simd::min(farZ, simd::splat(distance)));
+
+		auto hitChildren = simd::lessEqual(tNear, tFar);
+
+		if (hitChildren == 0u)
+			continue;
+
+		alignas(16) float entries[4];
+		int order[4];
+		auto numHitChildren = 0;
+
+		simd::store(entries, tNear);
+
+		// pushed farthest first so that the nearest child is visited next
+		while (hitChildren != 0u)
+		{
+			const int i = countTrailingZeros(hitChildren);
+			auto j = numHitChildren++;
+
+			for (; j > 0 && entries[order[j - 1]] < entries[i]; --j)
+				order[j] = order[j - 1];
+			order[j] = i;
+
+			hitChildren &= hitChildren - 1u;
+		}
+
+		for (auto j = 0; j < numHitChildren; ++j)
+			stack.push_back(std::make_pair(node.children[order[j]], entries[order[j]]));
+	}
+
+	return hit;
+}
+
+uint
+BoundingVolumeHierarchy::castRayPacket(const math::vec3*			origins,
+									   const math::vec3*			directions,
+									   uint							numRays,
+									   float*						distances,
+									   uint*						items,
+									   const RayPacketItemFunction&	intersectItems) const
+{
+	if (_nodes.empty() || numRays == 0)
+		return 0u;
+
+	numRays = std::min(numRays, 4u);
+
+	// SoA copy of the packet, the missing rays repeating the first one
+	alignas(16) float packet[6][4];
+	alignas(16) float packetDistances[4];
+	alignas(16) float entries[4];
+
+	for (uint i = 0; i < 4; ++i)
+	{
+		const auto rayId = i < numRays ? i : 0;
+		const auto& direction = directions[rayId];
+
+		packet[0][i] = origins[rayId].x;
+		packet[1][i] = origins[rayId].y;
+		packet[2][i] = origins[rayId].z;
+		packet[3][i] = 1.f / (std::abs(direction.x) > 1e-30f ? direction.x : 1e-30f);
+		packet[4][i] = 1.f / (std::abs(direction.y) > 1e-30f ? direction.y : 1e-30f);
+		packet[5][i] = 1.f / (std::abs(direction.z) > 1e-30f ? direction.z : 1e-30f);
+		packetDistances[i] = distances[rayId];
+	}
+
+	const auto originX = simd::load(packet[0]);
+	const auto originY = simd::load(packet[1]);
+	const auto originZ = simd::load(packet[2]);
+	const auto invX = simd::load(packet[3]);
+	const auto invY = simd::load(packet[4]);
+	const auto invZ = simd::load(packet[5]);
+	const auto zero = simd::splat(0.f);
+	auto hitRays = 0u;
+	auto stack = std::vector<PacketEntry>();
+
+	stack.reserve(64);
+	stack.push_back({ 0, (1u << numRays) - 1u, 0.f });
+
+	while (!stack.empty())
+	{
+		const auto entry = stack.back();
+
+		stack.pop_back();
+
+		// rays which already hit something closer than the box do not need it anymore
+		auto activeRays = entry.rays;
+
+		for (auto rays = activeRays; rays != 0u; rays &= rays - 1u)
+		{
+			const auto i = countTrailingZeros(rays);
+
+			if (packetDistances[i] <= entry.distance)
+				activeRays &= ~(1u << i);
+		}
+
+		if (activeRays == 0u)
+			continue;
+
+		if (entry.child < 0)
+		{
+			const uint item = ~entry.child;
+			const auto itemHitRays = intersectItems(item, activeRays, packetDistances);
+
+			for (auto rays = itemHitRays; rays != 0u; rays &= rays - 1u)
+				items[countTrailingZeros(rays)] = item;
+			hitRays |= itemHitRays;
+
+			continue;
+		}
+
+		const auto& node = _nodes[entry.child];
+		const auto distance = simd::load(packetDistances);
+		PacketEntry children[4];
+		auto numChildren = 0;
+
+		for (auto i = 0; i < 4; ++i)
+		{
+			if (node.children[i] == EMPTY_CHILD)
+				continue;
+
+			// the rays of a packet may go in different directions: slabs are ordered per ray
+			const auto t0x = simd::mul(simd::sub(simd::splat(node.minX[i]), originX), invX);
+			const auto t1x = simd::mul(simd::sub(simd::splat(node.maxX[i]), originX), invX);
+			const auto t0y = simd::mul(simd::sub(simd::splat(node.minY[i]), originY), invY);
+			const auto t1y = simd::mul(simd::sub(simd::splat(node.maxY[i]), originY), invY);
+			const auto t0z = simd::mul(simd::sub(simd::splat(node.minZ[i]), originZ), invZ);
+			const auto t1z = simd::mul(simd::sub(simd::splat(node.maxZ[i]), originZ), invZ);
+
+			const auto tNear = simd::max(
+				simd::max(simd::min(t0x, t1x), simd::min(t0y, t1y)),
+				simd::max(simd::min(t0z, t1z), zero)
+			);
+			const auto tFar = simd::min(
+				simd::min(simd::max(t0x, t1x), simd::max(t0y, t1y)),
+				simd::min(simd::max(t0z, t1z), distance)
+			);
+
+			const auto childRays = simd::lessEqual(tNear, tFar) & activeRays;
+
+			if (childRays == 0u)
+				continue;
+
+			auto childDistance = std::numeric_limits<float>::infinity();
+
+			simd::store(entries, tNear);
+			for (auto rays = childRays; rays != 0u; rays &= rays - 1u)
+				childDistance = std::min(childDistance, entries[countTrailingZeros(rays)]);
+
+			// pushed farthest first so that the nearest child is visited next
+			auto j = numChildren++;
+
+			for (; j > 0 && children[j - 1].distance < childDistance; --j)
+				children[j] = children[j - 1];
+			children[j] = { node.children[i], childRays, childDistance };
+		}
+
+		for (auto j = 0; j < numChildren; ++j)
+			stack.push_back(children[j]);
+	}
+
+	for (uint i = 0; i < numRays; ++i)
+		distances[i] = packetDistances[i];
+
+	return hitRays;
+}
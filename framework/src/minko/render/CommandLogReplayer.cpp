@@ -0,0 +1,640 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/render/CommandLogReplayer.hpp"
+
+#include "minko/render/CompareMode.hpp"
+#include "minko/render/WrapMode.hpp"
+#include "minko/render/TextureFilter.hpp"
+#include "minko/render/MipFilter.hpp"
+#include "minko/render/TriangleCulling.hpp"
+#include "minko/render/StencilOperation.hpp"
+#include "minko/log/Logger.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+CommandLogReplayer::CommandLogReplayer(AbstractContext::Ptr context) :
+    _context(context),
+    _currentLocations(nullptr),
+    _cursor(nullptr),
+    _end(nullptr),
+    _numCommands(0),
+    _numSkippedCommands(0),
+    _numFrames(0)
+{
+    if (context == nullptr)
+        throw std::invalid_argument("context");
+}
+
+void
+CommandLogReplayer::replay(const std::vector<unsigned char>& log)
+{
+    _cursor = log.data();
+    _end = log.data() + log.size();
+
+    while (_cursor != _end)
+    {
+        auto command = read<unsigned char>();
+
+        if (command >= static_cast<unsigned char>(Command::NUM_COMMANDS))
+        {
+            LOG_ERROR("unknown command " << static_cast<uint>(command));
+            throw std::invalid_argument("log");
+        }
+
+        replayCommand(static_cast<Command>(command));
+        ++_numCommands;
+    }
+
+    _cursor = nullptr;
+    _end = nullptr;
+}
+
+void
+CommandLogReplayer::replayCommand(Command command)
+{
+    switch (command)
+    {
+    case Command::ConfigureViewport:
+    {
+        auto x = read<uint>();
+        auto y = read<uint>();
+        auto width = read<uint>();
+        auto height = read<uint>();
+
+        _context->configureViewport(x, y, width, height);
+        break;
+    }
+    case Command::Clear:
+    {
+        auto red = read<float>();
+        auto green = read<float>();
+        auto blue = read<float>();
+        auto alpha = read<float>();
+        auto depth = read<float>();
+        auto stencil = read<uint>();
+        auto mask = read<uint>();
+
+        _context->clear(red, green, blue, alpha, depth, stencil, mask);
+        break;
+    }
+    case Command::Present:
+        _context->present();
+        ++_numFrames;
+        break;
+    case Command::DrawIndexedTriangles:
+    {
+        auto indexBuffer = resource(read<uint>());
+        auto firstIndex = read<uint>();
+        auto numTriangles = read<int>();
+
+        _context->drawTriangles(indexBuffer, firstIndex, numTriangles);
+        break;
+    }
+    case Command::DrawTriangles:
+    {
+        auto firstIndex = read<uint>();
+        auto numTriangles = read<int>();
+
+        _context->drawTriangles(firstIndex, numTriangles);
+        break;
+    }
+    case Command::DrawTrianglesInstanced:
+    {
+        auto indexBuffer = resource(read<uint>());
+        auto firstIndex = read<uint>();
+        auto numTriangles = read<int>();
+        auto numInstances = read<uint>();
+
+        _context->drawTrianglesInstanced(indexBuffer, firstIndex, numTriangles, numInstances);
+        break;
+    }
+    case Command::CreateVertexBuffer:
+    {
+        auto id = read<uint>();
+
+        _resources[id] = _context->createVertexBuffer(read<uint>());
+        break;
+    }
+    case Command::SetVertexBufferAt:
+    {
+        auto position = attributeLocation(read<uint>());
+        auto vertexBuffer = resource(read<uint>());
+        auto size = read<uint>();
+        auto stride = read<uint>();
+        auto offset = read<uint>();
+
+        if (position >= 0)
+            _context->setVertexBufferAt(position, vertexBuffer, size, stride, offset);
+        break;
+    }
+    case Command::SetVertexAttributeDivisor:
+    {
+        auto position = attributeLocation(read<uint>());
+        auto divisor = read<uint>();
+
+        if (position >= 0)
+            _context->setVertexAttributeDivisor(position, divisor);
+        break;
+    }
+    case Command::UploadVertexBufferData:
+    {
+        auto vertexBuffer = resource(read<uint>());
+        auto offset = read<uint>();
+        auto data = readData();
+
+        _context->uploadVertexBufferData(vertexBuffer, offset, _buffer.size() / sizeof(float), data);
+        break;
+    }
+    case Command::DeleteVertexBuffer:
+    {
+        auto id = read<uint>();
+
+        _context->deleteVertexBuffer(resource(id));
+        _resources.erase(id);
+        break;
+    }
+    case Command::CreateIndexBuffer:
+    {
+        auto id = read<uint>();
+        auto size = read<uint>();
+        auto unsignedIntIndices = read<bool>();
+
+        if (unsignedIntIndices)
+            _unsignedIntIndexBuffers.insert(id);
+
+        _resources[id] = _context->createIndexBuffer(size, unsignedIntIndices);
+        break;
+    }
+    case Command::UploadIndexBufferData:
+    {
+        auto id = read<uint>();
+        auto indexBuffer = resource(id);
+        auto offset = read<uint>();
+        auto data = readData();
+        auto indexSize = _unsignedIntIndexBuffers.count(id) != 0 ? sizeof(unsigned int) : sizeof(unsigned short);
+
+        _context->uploaderIndexBufferData(indexBuffer, offset, _buffer.size() / indexSize, data);
+        break;
+    }
+    case Command::DeleteIndexBuffer:
+    {
+        auto id = read<uint>();
+
+        _context->deleteIndexBuffer(resource(id));
+        _resources.erase(id);
+        _unsignedIntIndexBuffers.erase(id);
+        break;
+    }
+    case Command::CreateTexture:
+    {
+        auto id = read<uint>();
+        auto type = static_cast<TextureType>(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+        auto mipMapping = read<bool>();
+        auto optimizeForRenderToTexture = read<bool>();
+
+        _resources[id] = _context->createTexture(type, width, height, mipMapping, optimizeForRenderToTexture);
+        break;
+    }
+    case Command::CreateRectangleTexture:
+    {
+        auto id = read<uint>();
+        auto type = static_cast<TextureType>(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+
+        _resources[id] = _context->createRectangleTexture(type, width, height);
+        break;
+    }
+    case Command::CreateCompressedTexture:
+    {
+        auto id = read<uint>();
+        auto type = static_cast<TextureType>(read<uint>());
+        auto format = static_cast<TextureFormat>(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+        auto mipMapping = read<bool>();
+
+        _resources[id] = _context->createCompressedTexture(type, format, width, height, mipMapping);
+        break;
+    }
+    case Command::UploadTexture2dData:
+    {
+        auto texture = resource(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+        auto mipLevel = read<uint>();
+
+        _context->uploadTexture2dData(texture, width, height, mipLevel, readData());
+        break;
+    }
+    case Command::UploadCubeTextureData:
+    {
+        auto texture = resource(read<uint>());
+        auto face = static_cast<CubeTexture::Face>(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+        auto mipLevel = read<uint>();
+
+        _context->uploadCubeTextureData(texture, face, width, height, mipLevel, readData());
+        break;
+    }
+    case Command::UploadCompressedTexture2dData:
+    {
+        auto texture = resource(read<uint>());
+        auto format = static_cast<TextureFormat>(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+        auto mipLevel = read<uint>();
+        auto data = readData();
+
+        _context->uploadCompressedTexture2dData(texture, format, width, height, _buffer.size(), mipLevel, data);
+        break;
+    }
+    case Command::UploadCompressedCubeTextureData:
+    {
+        auto texture = resource(read<uint>());
+        auto face = static_cast<CubeTexture::Face>(read<uint>());
+        auto format = static_cast<TextureFormat>(read<uint>());
+        auto width = read<uint>();
+        auto height = read<uint>();
+        auto mipLevel = read<uint>();
+
+        _context->uploadCompressedCubeTextureData(texture, face, format, width, height, mipLevel, readData());
+        break;
+    }
+    case Command::ActivateMipMapping:
+        _context->activateMipMapping(resource(read<uint>()));
+        break;
+    case Command::DeleteTexture:
+    {
+        auto id = read<uint>();
+
+        _context->deleteTexture(resource(id));
+        _resources.erase(id);
+        break;
+    }
+    case Command::SetTextureAt:
+    {
+        auto position = read<uint>();
+        auto texture = read<int>();
+        auto location = read<int>();
+
+        if (texture > 0)
+            texture = resource(texture);
+        if (location >= 0)
+        {
+            location = uniformLocation(location);
+
+            if (location < 0)
+                break;
+        }
+
+        _context->setTextureAt(position, texture, location);
+        break;
+    }
+    case Command::SetSamplerStateAt:
+    {
+        auto position = read<uint>();
+        auto wrapping = static_cast<WrapMode>(read<uint>());
+        auto filtering = static_cast<TextureFilter>(read<uint>());
+        auto mipFiltering = static_cast<MipFilter>(read<uint>());
+
+        _context->setSamplerStateAt(position, wrapping, filtering, mipFiltering);
+        break;
+    }
+    case Command::CreateProgram:
+    {
+        auto id = read<uint>();
+
+        _resources[id] = _context->createProgram();
+        _programShaders[id].clear();
+        break;
+    }
+    case Command::AttachShader:
+    {
+        auto program = read<uint>();
+        auto shader = read<uint>();
+
+        _programShaders[program].push_back(shader);
+        _context->attachShader(resource(program), resource(shader));
+        break;
+    }
+    case Command::LinkProgram:
+    {
+        auto program = read<uint>();
+
+        _context->linkProgram(resource(program));
+        mapProgramLocations(program);
+        break;
+    }
+    case Command::DeleteProgram:
+    {
+        auto id = read<uint>();
+        auto locations = _programLocations.find(id);
+
+        if (locations != _programLocations.end() && &locations->second == _currentLocations)
+            _currentLocations = nullptr;
+
+        _context->deleteProgram(resource(id));
+        _programLocations.erase(id);
+        _programShaders.erase(id);
+        _resources.erase(id);
+        break;
+    }
+    case Command::SetProgram:
+    {
+        auto id = read<uint>();
+        auto locations = _programLocations.find(id);
+
+        _currentLocations = locations != _programLocations.end() ? &locations->second : nullptr;
+        _context->setProgram(resource(id));
+        break;
+    }
+    case Command::CompileShader:
+        _context->compileShader(resource(read<uint>()));
+        break;
+    case Command::SetShaderSource:
+    {
+        auto shader = read<uint>();
+        auto data = static_cast<const char*>(readData());
+        auto& source = _shaderSources[shader];
+
+        source = data != nullptr ? std::string(data, _buffer.size()) : std::string();
+        _context->setShaderSource(resource(shader), source);
+        break;
+    }
+    case Command::CreateVertexShader:
+    {
+        auto id = read<uint>();
+
+        _resources[id] = _context->createVertexShader();
+        break;
+    }
+    case Command::DeleteVertexShader:
+    {
+        auto id = read<uint>();
+
+        _context->deleteVertexShader(resource(id));
+        _shaderSources.erase(id);
+        _resources.erase(id);
+        break;
+    }
+    case Command::CreateFragmentShader:
+    {
+        auto id = read<uint>();
+
+        _resources[id] = _context->createFragmentShader();
+        break;
+    }
+    case Command::DeleteFragmentShader:
+    {
+        auto id = read<uint>();
+
+        _context->deleteFragmentShader(resource(id));
+        _shaderSources.erase(id);
+        _resources.erase(id);
+        break;
+    }
+    case Command::SetBlendingFactors:
+    {
+        auto source = static_cast<Blending::Source>(read<uint>());
+        auto destination = static_cast<Blending::Destination>(read<uint>());
+
+        _context->setBlendingMode(source, destination);
+        break;
+    }
+    case Command::SetBlendingMode:
+        _context->setBlendingMode(static_cast<Blending::Mode>(read<uint>()));
+        break;
+    case Command::SetColorMask:
+        _context->setColorMask(read<bool>());
+        break;
+    case Command::SetDepthTest:
+    {
+        auto depthMask = read<bool>();
+        auto depthFunc = static_cast<CompareMode>(read<uint>());
+
+        _context->setDepthTest(depthMask, depthFunc);
+        break;
+    }
+    case Command::SetStencilTest:
+    {
+        auto stencilFunc = static_cast<CompareMode>(read<uint>());
+        auto stencilRef = read<int>();
+        auto stencilMask = read<uint>();
+        auto stencilFailOp = static_cast<StencilOperation>(read<uint>());
+        auto stencilZFailOp = static_cast<StencilOperation>(read<uint>());
+        auto stencilZPassOp = static_cast<StencilOperation>(read<uint>());
+
+        _context->setStencilTest(stencilFunc, stencilRef, stencilMask, stencilFailOp, stencilZFailOp, stencilZPassOp);
+        break;
+    }
+    case Command::SetScissorTest:
+    {
+        auto scissorTest = read<bool>();
+        auto x = read<int>();
+        auto y = read<int>();
+        auto z = read<int>();
+        auto w = read<int>();
+
+        _context->setScissorTest(scissorTest, math::ivec4(x, y, z, w));
+        break;
+    }
+    case Command::SetTriangleCulling:
+        _context->setTriangleCulling(static_cast<TriangleCulling>(read<uint>()));
+        break;
+    case Command::SetRenderToBackBuffer:
+        _context->setRenderToBackBuffer();
+        break;
+    case Command::SetRenderToTexture:
+    {
+        auto texture = resource(read<uint>());
+        auto enableDepthAndStencil = read<bool>();
+
+        _context->setRenderToTexture(texture, enableDepthAndStencil);
+        break;
+    }
+    case Command::GenerateMipmaps:
+        _context->generateMipmaps(resource(read<uint>()));
+        break;
+    case Command::SetUniformFloat:
+    case Command::SetUniformFloat2:
+    case Command::SetUniformFloat3:
+    case Command::SetUniformFloat4:
+    case Command::SetUniformMatrix4x4:
+    case Command::SetUniformInt:
+    case Command::SetUniformInt2:
+    case Command::SetUniformInt3:
+    case Command::SetUniformInt4:
+    {
+        static const uint numComponents[] = { 1, 2, 3, 4, 16, 1, 2, 3, 4 };
+
+        auto index = static_cast<uint>(command) - static_cast<uint>(Command::SetUniformFloat);
+        auto location = uniformLocation(read<uint>());
+        auto count = read<uint>();
+        auto data = readUniformData(count, numComponents[index]);
+
+        if (location < 0)
+            break;
+
+        auto floats = static_cast<const float*>(data);
+        auto ints = static_cast<const int*>(data);
+
+        switch (command)
+        {
+        case Command::SetUniformFloat:
+            _context->setUniformFloat(location, count, floats);
+            break;
+        case Command::SetUniformFloat2:
+            _context->setUniformFloat2(location, count, floats);
+            break;
+        case Command::SetUniformFloat3:
+            _context->setUniformFloat3(location, count, floats);
+            break;
+        case Command::SetUniformFloat4:
+            _context->setUniformFloat4(location, count, floats);
+            break;
+        case Command::SetUniformMatrix4x4:
+            _context->setUniformMatrix4x4(location, count, floats);
+            break;
+        case Command::SetUniformInt:
+            _context->setUniformInt(location, count, ints);
+            break;
+        case Command::SetUniformInt2:
+            _context->setUniformInt2(location, count, ints);
+            break;
+        case Command::SetUniformInt3:
+            _context->setUniformInt3(location, count, ints);
+            break;
+        default:
+            _context->setUniformInt4(location, count, ints);
+            break;
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void*
+CommandLogReplayer::readData()
+{
+    auto size = read<uint>();
+
+    checkAvailable(size);
+    _buffer.assign(_cursor, _cursor + size);
+    _cursor += size;
+
+    return size != 0 ? _buffer.data() : nullptr;
+}
+
+void*
+CommandLogReplayer::readUniformData(uint count, uint numComponents)
+{
+    auto size = count * numComponents * 4;
+
+    checkAvailable(size);
+    // Copied to keep the values aligned for the context.
+    _buffer.assign(_cursor, _cursor + size);
+    _cursor += size;
+
+    return _buffer.data();
+}
+
+void
+CommandLogReplayer::checkAvailable(uint size)
+{
+    if (_cursor == nullptr || static_cast<uint>(_end - _cursor) < size)
+    {
+        LOG_ERROR("truncated command log");
+        throw std::invalid_argument("log");
+    }
+}
+
+uint
+CommandLogReplayer::resource(uint recordedId)
+{
+    auto it = _resources.find(recordedId);
+
+    return it != _resources.end() ? it->second : recordedId;
+}
+
+int
+CommandLogReplayer::uniformLocation(int recordedLocation)
+{
+    if (_currentLocations == nullptr)
+        return recordedLocation;
+
+    auto it = _currentLocations->uniforms.find(recordedLocation);
+
+    if (it != _currentLocations->uniforms.end())
+        return it->second;
+
+    ++_numSkippedCommands;
+
+    return -1;
+}
+
+int
+CommandLogReplayer::attributeLocation(int recordedLocation)
+{
+    if (_currentLocations == nullptr)
+        return recordedLocation;
+
+    auto it = _currentLocations->attributes.find(recordedLocation);
+
+    if (it != _currentLocations->attributes.end())
+        return it->second;
+
+    ++_numSkippedCommands;
+
+    return -1;
+}
+
+void
+CommandLogReplayer::mapProgramLocations(uint recordedProgram)
+{
+    std::vector<std::string> sources;
+
+    for (auto shader : _programShaders[recordedProgram])
+        if (_shaderSources.count(shader) != 0)
+            sources.push_back(_shaderSources[shader]);
+
+    auto recordedInputs = RecordingContext::parseProgramInputs(sources);
+    auto inputs = _context->getProgramInputs(resource(recordedProgram));
+    auto& locations = _programLocations[recordedProgram];
+
+    locations.uniforms.clear();
+    locations.attributes.clear();
+
+    for (auto& recordedUniform : recordedInputs.uniforms())
+        for (auto& uniform : inputs.uniforms())
+            if (uniform.name == recordedUniform.name)
+                locations.uniforms[recordedUniform.location] = uniform.location;
+
+    for (auto& recordedAttribute : recordedInputs.attributes())
+        for (auto& attribute : inputs.attributes())
+            if (attribute.name == recordedAttribute.name)
+                locations.attributes[recordedAttribute.location] = attribute.location;
+}
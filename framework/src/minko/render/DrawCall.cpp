@@ -21,6 +21,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include "minko/data/Store.hpp"
 #include "minko/log/Logger.hpp"
+#include "minko/Hash.hpp"
 
 // #include <regex>
 
@@ -29,6 +30,7 @@ using namespace minko::render;
 
 const unsigned int DrawCall::MAX_NUM_TEXTURES       = 8;
 const unsigned int DrawCall::MAX_NUM_VERTEXBUFFERS  = 8;
+const std::string DrawCall::INSTANCE_ATTRIBUTE_PREFIX = "aInstance";
 
 DrawCall::DrawCall(uint                   batchId,
                    std::shared_ptr<Pass>  pass,
@@ -67,7 +69,11 @@ DrawCall::DrawCall(uint                   batchId,
     _worldToScreenMatrix(nullptr),
     _modelToWorldMatrixPropertyRemovedSlot(nullptr),
     _worldToScreenMatrixPropertyRemovedSlot(nullptr),
-    _vertexAttribArray(0)
+    _vertexAttribArray(0),
+    _sortIndex(-1),
+    _instanceLeader(nullptr),
+    _firstInstance(0),
+    _numInstances(0)
 {
     _batchIDs = { batchId };
 
@@ -103,6 +109,7 @@ DrawCall::reset()
     _uniformBool.clear();
     _samplers.clear();
     _attributes.clear();
+    _instanceAttributes.clear();
     _vertexAttribArray = 0;
 }
 
@@ -237,8 +244,11 @@ DrawCall::setAttributeValueFromStore(const ProgramInputs::AttributeInput& input,
                                      const data::Store&                   store)
 {
     const auto* attr = store.getUnsafePointer<VertexAttribute>(propertyName);
+    auto& attributes = input.name.compare(0, INSTANCE_ATTRIBUTE_PREFIX.size(), INSTANCE_ATTRIBUTE_PREFIX) == 0
+        ? _instanceAttributes
+        : _attributes;
 
-    _attributes.push_back({
+    attributes.push_back({
         input.location,
         attr->resourceId,
         attr->size,
@@ -709,10 +719,35 @@ DrawCall::render(AbstractContext::Ptr   context,
                  const math::ivec4&     viewport,
                  uint                   clearColor)
 {
-    if (!this->enabled())
+    StateChanges stateChanges;
+
+    render(context, renderTarget, viewport, clearColor, nullptr, stateChanges);
+}
+
+void
+DrawCall::render(AbstractContext::Ptr   context,
+                 AbstractTexture::Ptr   renderTarget,
+                 const math::ivec4&     viewport,
+                 uint                   clearColor,
+                 const DrawCall*        previous,
+                 StateChanges&          stateChanges)
+{
+    // instanced draw calls are rendered by the leader of their instance group, which might itself
+    // be disabled while some of the other instances are not
+    if (instanced() ? _numInstances == 0 : !this->enabled())
         return;
 
-    context->setProgram(_program->id());
+    // uniforms and sampler locations are per-program states: they can only be skipped if the
+    // previous draw call used the very same program
+    const auto sameProgram = previous != nullptr && previous->_program == _program;
+
+    if (sameProgram)
+        ++stateChanges.skipped;
+    else
+    {
+        context->setProgram(_program->id());
+        ++stateChanges.issued;
+    }
 
     auto hasOwnTarget = _target && _target->id;
     auto renderTargetId = hasOwnTarget
@@ -743,48 +778,66 @@ DrawCall::render(AbstractContext::Ptr   context,
     if (targetChanged && !hasOwnTarget && viewport.z >= 0 && viewport.w >= 0)
         context->configureViewport(viewport.x, viewport.y, viewport.z, viewport.w);
 
-    for (const auto& u : _uniformBool)
+    // clearing a new render target resets the depth mask
+    const auto* previousStates = targetChanged ? nullptr : previous;
+
+    for (auto i = 0u; i < _uniformBool.size(); ++i)
     {
-        if (u.size == 1)
-            context->setUniformInt(u.location, u.count, u.data);
-        else if (u.size == 2)
-            context->setUniformInt2(u.location, u.count, u.data);
-        else if (u.size == 3)
-            context->setUniformInt3(u.location, u.count, u.data);
-        else if (u.size == 4)
-            context->setUniformInt4(u.location, u.count, u.data);
+        if (sameProgram && uniformAlreadySubmitted(_uniformBool[i], previous->_uniformBool, i))
+            ++stateChanges.skipped;
+        else
+        {
+            setUniformInt(context, _uniformBool[i]);
+            ++stateChanges.issued;
+        }
     }
 
-    for (const auto& u : _uniformInt)
+    for (auto i = 0u; i < _uniformInt.size(); ++i)
     {
-        if (u.size == 1)
-            context->setUniformInt(u.location, u.count, u.data);
-        else if (u.size == 2)
-            context->setUniformInt2(u.location, u.count, u.data);
-        else if (u.size == 3)
-            context->setUniformInt3(u.location, u.count, u.data);
-        else if (u.size == 4)
-            context->setUniformInt4(u.location, u.count, u.data);
+        if (sameProgram && uniformAlreadySubmitted(_uniformInt[i], previous->_uniformInt, i))
+            ++stateChanges.skipped;
+        else
+        {
+            setUniformInt(context, _uniformInt[i]);
+            ++stateChanges.issued;
+        }
     }
 
-    for (const auto& u : _uniformFloat)
+    for (auto i = 0u; i < _uniformFloat.size(); ++i)
     {
-        if (u.size == 1)
-            context->setUniformFloat(u.location, u.count, u.data);
-        else if (u.size == 2)
-            context->setUniformFloat2(u.location, u.count, u.data);
-        else if (u.size == 3)
-            context->setUniformFloat3(u.location, u.count, u.data);
-        else if (u.size == 4)
-            context->setUniformFloat4(u.location, u.count, u.data);
-        else if (u.size == 16)
-            context->setUniformMatrix4x4(u.location, u.count, u.data);
+        if (sameProgram && uniformAlreadySubmitted(_uniformFloat[i], previous->_uniformFloat, i))
+            ++stateChanges.skipped;
+        else
+        {
+            setUniformFloat(context, _uniformFloat[i]);
+            ++stateChanges.issued;
+        }
     }
 
-    for (const auto& s : _samplers)
+    for (auto i = 0u; i < _samplers.size(); ++i)
     {
-        context->setTextureAt(s.position, *s.sampler->id, s.location);
-        context->setSamplerStateAt(s.position, *s.wrapMode, *s.textureFilter, *s.mipFilter);
+        const auto& s = _samplers[i];
+        const SamplerValue* p = previous != nullptr && i < previous->_samplers.size()
+            ? &previous->_samplers[i]
+            : nullptr;
+
+        if (sameProgram && p != nullptr && p->position == s.position && *p->sampler->id == *s.sampler->id
+            && p->location == s.location)
+            ++stateChanges.skipped;
+        else
+        {
+            context->setTextureAt(s.position, *s.sampler->id, s.location);
+            ++stateChanges.issued;
+        }
+
+        if (p != nullptr && p->position == s.position && *p->sampler->id == *s.sampler->id
+            && *p->wrapMode == *s.wrapMode && *p->textureFilter == *s.textureFilter && *p->mipFilter == *s.mipFilter)
+            ++stateChanges.skipped;
+        else
+        {
+            context->setSamplerStateAt(s.position, *s.wrapMode, *s.textureFilter, *s.mipFilter);
+            ++stateChanges.issued;
+        }
     }
 
     if (_vertexAttribArray == 0)
@@ -799,24 +852,231 @@ DrawCall::render(AbstractContext::Ptr   context,
         }
     }
     if (_vertexAttribArray != -1)
-        context->setVertexAttributeArray(_vertexAttribArray);
+    {
+        if (previous != nullptr && previous->_vertexAttribArray == _vertexAttribArray)
+            ++stateChanges.skipped;
+        else
+        {
+            context->setVertexAttributeArray(_vertexAttribArray);
+            ++stateChanges.issued;
+        }
+    }
+    else
+        for (auto i = 0u; i < _attributes.size(); ++i)
+        {
+            const auto& a = _attributes[i];
+            const AttributeValue* p = previous != nullptr && i < previous->_attributes.size()
+                ? &previous->_attributes[i]
+                : nullptr;
+
+            if (p != nullptr && p->location == a.location && *p->resourceId == *a.resourceId
+                && p->size == a.size && *p->stride == *a.stride && p->offset == a.offset)
+                ++stateChanges.skipped;
+            else
+            {
+                context->setVertexBufferAt(a.location, *a.resourceId, a.size, *a.stride, a.offset);
+                ++stateChanges.issued;
+            }
+        }
+
+    if (previousStates != nullptr && *previousStates->_colorMask == *_colorMask)
+        ++stateChanges.skipped;
+    else
+    {
+        context->setColorMask(*_colorMask);
+        ++stateChanges.issued;
+    }
+
+    if (previousStates != nullptr && *previousStates->_blendingSourceFactor == *_blendingSourceFactor
+        && *previousStates->_blendingDestinationFactor == *_blendingDestinationFactor)
+        ++stateChanges.skipped;
+    else
+    {
+        context->setBlendingMode(*_blendingSourceFactor, *_blendingDestinationFactor);
+        ++stateChanges.issued;
+    }
+
+    if (previousStates != nullptr && *previousStates->_depthMask == *_depthMask && *previousStates->_depthFunc == *_depthFunc)
+        ++stateChanges.skipped;
+    else
+    {
+        context->setDepthTest(*_depthMask, *_depthFunc);
+        ++stateChanges.issued;
+    }
+
+    if (previousStates != nullptr && *previousStates->_stencilFunction == *_stencilFunction
+        && *previousStates->_stencilReference == *_stencilReference && *previousStates->_stencilMask == *_stencilMask
+        && *previousStates->_stencilFailOp == *_stencilFailOp && *previousStates->_stencilZFailOp == *_stencilZFailOp
+        && *previousStates->_stencilZPassOp == *_stencilZPassOp)
+        ++stateChanges.skipped;
+    else
+    {
+        context->setStencilTest(*_stencilFunction, *_stencilReference, *_stencilMask, *_stencilFailOp, *_stencilZFailOp, *_stencilZPassOp);
+        ++stateChanges.issued;
+    }
+
+    if (previousStates != nullptr && *previousStates->_scissorTest == *_scissorTest && *previousStates->_scissorBox == *_scissorBox)
+        ++stateChanges.skipped;
+    else
+    {
+        context->setScissorTest(*_scissorTest, *_scissorBox);
+        ++stateChanges.issued;
+    }
+
+    if (previousStates != nullptr && *previousStates->_triangleCulling == *_triangleCulling)
+        ++stateChanges.skipped;
     else
-        for (const auto& a : _attributes)
-            context->setVertexBufferAt(a.location, *a.resourceId, a.size, *a.stride, a.offset);
-    
-    context->setColorMask(*_colorMask);
-    context->setBlendingMode(*_blendingSourceFactor, *_blendingDestinationFactor);
-    context->setDepthTest(*_depthMask, *_depthFunc);
-    context->setStencilTest(*_stencilFunction, *_stencilReference, *_stencilMask, *_stencilFailOp, *_stencilZFailOp, *_stencilZPassOp);
-    context->setScissorTest(*_scissorTest, *_scissorBox);
-    context->setTriangleCulling(*_triangleCulling);
+    {
+        context->setTriangleCulling(*_triangleCulling);
+        ++stateChanges.issued;
+    }
 
     if (!_pass->isForward())
         context->drawTriangles(0, 2);
+    else if (instanced())
+    {
+        // there is no base instance in OpenGL ES 2: the per-instance attributes are offset instead
+        for (const auto& a : _instanceAttributes)
+        {
+            context->setVertexBufferAt(a.location, *a.resourceId, a.size, *a.stride, a.offset + _firstInstance * *a.stride);
+            context->setVertexAttributeDivisor(a.location, 1);
+            stateChanges.issued += 2;
+        }
+
+        context->drawTrianglesInstanced(*_indexBuffer, *_firstIndex, *_numIndices / 3, _numInstances);
+
+        // without vertex array objects, the divisors would leak into the next draw calls
+        if (_vertexAttribArray == -1)
+            for (const auto& a : _instanceAttributes)
+                context->setVertexAttributeDivisor(a.location, 0);
+    }
     else
         context->drawTriangles(*_indexBuffer, *_firstIndex, *_numIndices / 3);
 }
 
+void
+DrawCall::setUniformInt(const AbsCtxPtr& context, const UniformValue<int>& u)
+{
+    if (u.size == 1)
+        context->setUniformInt(u.location, u.count, u.data);
+    else if (u.size == 2)
+        context->setUniformInt2(u.location, u.count, u.data);
+    else if (u.size == 3)
+        context->setUniformInt3(u.location, u.count, u.data);
+    else if (u.size == 4)
+        context->setUniformInt4(u.location, u.count, u.data);
+}
+
+void
+DrawCall::setUniformFloat(const AbsCtxPtr& context, const UniformValue<float>& u)
+{
+    if (u.size == 1)
+        context->setUniformFloat(u.location, u.count, u.data);
+    else if (u.size == 2)
+        context->setUniformFloat2(u.location, u.count, u.data);
+    else if (u.size == 3)
+        context->setUniformFloat3(u.location, u.count, u.data);
+    else if (u.size == 4)
+        context->setUniformFloat4(u.location, u.count, u.data);
+    else if (u.size == 16)
+        context->setUniformMatrix4x4(u.location, u.count, u.data);
+}
+
+bool
+DrawCall::canBeInstancedWith(const DrawCall& drawCall) const
+{
+    if (!instanced() || drawCall._program != _program || drawCall.zSorted() || zSorted())
+        return false;
+
+    if (drawCall._attributes.size() != _attributes.size()
+        || drawCall._samplers.size() != _samplers.size()
+        || drawCall._uniformFloat.size() != _uniformFloat.size()
+        || drawCall._uniformInt.size() != _uniformInt.size()
+        || drawCall._uniformBool.size() != _uniformBool.size())
+        return false;
+
+    if (drawCall._indexBuffer == nullptr || _indexBuffer == nullptr
+        || drawCall._firstIndex == nullptr || _firstIndex == nullptr
+        || drawCall._numIndices == nullptr || _numIndices == nullptr
+        || *drawCall._indexBuffer != *_indexBuffer
+        || *drawCall._firstIndex != *_firstIndex
+        || *drawCall._numIndices != *_numIndices)
+        return false;
+
+    // draw calls using the same program bind their inputs in the same order
+    for (auto i = 0u; i < _attributes.size(); ++i)
+    {
+        const auto& a = _attributes[i];
+        const auto& b = drawCall._attributes[i];
+
+        if (*a.resourceId != *b.resourceId || *a.stride != *b.stride || a.offset != b.offset)
+            return false;
+    }
+
+    for (auto i = 0u; i < _samplers.size(); ++i)
+    {
+        const auto& a = _samplers[i];
+        const auto& b = drawCall._samplers[i];
+
+        if (a.sampler->id != b.sampler->id || a.wrapMode != b.wrapMode
+            || a.textureFilter != b.textureFilter || a.mipFilter != b.mipFilter)
+            return false;
+    }
+
+    // the uniforms and the states must come from the very same properties (usually the ones of a
+    // shared material) for the instances to keep on matching when those properties are updated
+    for (auto i = 0u; i < _uniformFloat.size(); ++i)
+        if (_uniformFloat[i].data != drawCall._uniformFloat[i].data)
+            return false;
+
+    for (auto i = 0u; i < _uniformInt.size(); ++i)
+        if (_uniformInt[i].data != drawCall._uniformInt[i].data)
+            return false;
+
+    for (auto i = 0u; i < _uniformBool.size(); ++i)
+        if (_uniformBool[i].data != drawCall._uniformBool[i].data)
+            return false;
+
+    return _priority == drawCall._priority
+        && _blendingSourceFactor == drawCall._blendingSourceFactor
+        && _blendingDestinationFactor == drawCall._blendingDestinationFactor
+        && _colorMask == drawCall._colorMask
+        && _depthMask == drawCall._depthMask
+        && _depthFunc == drawCall._depthFunc
+        && _triangleCulling == drawCall._triangleCulling
+        && _stencilFunction == drawCall._stencilFunction
+        && _stencilReference == drawCall._stencilReference
+        && _stencilMask == drawCall._stencilMask
+        && _stencilFailOp == drawCall._stencilFailOp
+        && _stencilZFailOp == drawCall._stencilZFailOp
+        && _stencilZPassOp == drawCall._stencilZPassOp
+        && _scissorTest == drawCall._scissorTest
+        && _scissorBox == drawCall._scissorBox
+        && _target == drawCall._target;
+}
+
+size_t
+DrawCall::samplersHash() const
+{
+    size_t hash = 0;
+
+    for (const auto& s : _samplers)
+        hash_combine<const int*, Hash<const int*>>(hash, s.sampler->id);
+
+    return hash;
+}
+
+size_t
+DrawCall::attributesHash() const
+{
+    size_t hash = 0;
+
+    for (const auto& a : _attributes)
+        hash_combine<const int*, Hash<const int*>>(hash, a.resourceId);
+
+    return hash;
+}
+
 data::ResolvedBinding*
 DrawCall::resolveBinding(const std::string&                                     inputName,
                          const std::unordered_map<std::string, data::Binding>&  bindings)
@@ -20,6 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/DrawCallPool.hpp"
 
 #include "minko/data/ResolvedBinding.hpp"
+#include "minko/render/ProgramBuilder.hpp"
 
 #ifdef MINKO_USE_SPARSE_HASH_MAP
 # include "sparsehash/sparse_hash_map"
@@ -41,31 +42,48 @@ const std::vector<DrawCallPool::PropertyName> DrawCallPool::_sortUsefulPropertyN
     "material[${materialUuid}].target"
 };
 
-bool
-DrawCallPool::SortPropertyKeyComparator::operator()(const SortPropertyTuple& left,
-                                                    const SortPropertyTuple& right) const
+// Render queue sort key layout, from the most to the least significant bits:
+// [63..32] priority (descending), [31..22] target id, [21] zSorted flag,
+// [20..0] eye space depth (descending) for z-sorted draw calls, otherwise the program id in
+// [20..10], then the texture set hash in [9..5] and the vertex attributes hash in [4..0] so that
+// draw calls sharing the same render states are submitted one after the other.
+static const uint64_t SORT_KEY_TARGET_SHIFT     = 22;
+static const uint64_t SORT_KEY_TARGET_MASK      = (1u << 10) - 1;
+static const uint64_t SORT_KEY_ZSORTED_BIT      = 1u << 21;
+static const uint64_t SORT_KEY_PROGRAM_SHIFT    = 10;
+static const uint64_t SORT_KEY_PROGRAM_MASK     = (1u << 11) - 1;
+static const uint64_t SORT_KEY_SAMPLERS_SHIFT   = 5;
+static const uint64_t SORT_KEY_HASH_MASK        = (1u << 5) - 1;
+
+static inline
+uint32_t
+floatToSortableBits(float value)
 {
-    const auto leftPriority = std::get<0>(left);
-    const auto rightPriority = std::get<0>(right);
-
-    const bool samePriority = fabsf(leftPriority - rightPriority) < 1e-3f;
-
-    if (samePriority)
-    {
-        const auto leftTargetId = std::get<1>(left);
-        const auto rightTargetId = std::get<1>(right);
+    uint32_t bits;
 
-        return leftTargetId < rightTargetId;
-    }
+    std::memcpy(&bits, &value, sizeof(float));
 
-    return leftPriority > rightPriority;
+    // flip all the bits of negative values and only the sign bit of positive ones so that
+    // the unsigned integer comparison matches the float comparison
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
 }
 
 DrawCallPool::DrawCallPool() :
     _batchId(0),
     _drawCalls(),
+    _sortKeys(),
+    _drawCallsSwap(),
+    _sortKeysSwap(),
+    _mustSort(false),
+    _mustUpdateInstances(false),
+    _targetIds(),
+    _targetIdToTarget(),
+    _targetIdRefCounts(),
+    _freeTargetIds(),
     _macroToDrawCalls(new MacroToDrawCallsMap()),
     _invalidDrawCalls(),
+    _pendingDrawCalls(),
+    _numLinkedPrograms(0),
     _macroChangedSlot(new MacroToChangedSlotMap()),
     _propChangedSlot(new PropertyChangedSlotMap()),
     _drawCallToPropRebindFuncs(new PropertyRebindFuncMap()),
@@ -136,51 +154,57 @@ DrawCallPool::addDrawCalls(Effect::Ptr              effect,
 void
 DrawCallPool::removeDrawCalls(uint batchId)
 {
-    for (auto& priorityAndTargetIdToDrawCalls : _drawCalls)
+    // compact the queue in place: the relative order of the remaining draw calls is kept
+    // so the queue does not have to be sorted again
+    auto numDrawCalls = 0u;
+
+    for (auto i = 0u; i < _drawCalls.size(); ++i)
     {
-        for (auto& drawCalls : priorityAndTargetIdToDrawCalls.second)
+        auto* drawCall = _drawCalls[i];
+        auto& batchIDs = drawCall->batchIDs();
+        auto it = std::find(batchIDs.begin(), batchIDs.end(), batchId);
+
+        if (it != batchIDs.end())
         {
-            drawCalls.erase(std::remove_if(
-                drawCalls.begin(),
-                drawCalls.end(),
-                [&](DrawCall* drawCall)
-                {
-                    auto& batchIDs = drawCall->batchIDs();
-                    auto it = std::find(batchIDs.begin(), batchIDs.end(), batchId);
+            batchIDs.erase(it);
 
-                    if (it != batchIDs.end())
-                    {
-                        batchIDs.erase(it);
+            if (batchIDs.size() == 0)
+            {
+                if (drawCall->program() != nullptr)
+                    unwatchProgramSignature(
+                        *drawCall,
+                        drawCall->pass()->macroBindings(),
+                        drawCall->rootData(),
+                        drawCall->rendererData(),
+                        drawCall->targetData()
+                    );
+                unbindDrawCall(*drawCall);
 
-                        if (batchIDs.size() != 0)
-                            return false;
+                _invalidDrawCalls.erase(drawCall);
+                _pendingDrawCalls.erase(drawCall);
+                _drawCallsToBeSorted.erase(drawCall);
+                releaseSortKey(_sortKeys[i]);
 
-                        unwatchProgramSignature(
-                            *drawCall,
-                            drawCall->pass()->macroBindings(),
-                            drawCall->rootData(),
-                            drawCall->rendererData(),
-                            drawCall->targetData()
-                        );
-                        unbindDrawCall(*drawCall);
+                delete drawCall;
 
-                        _invalidDrawCalls.erase(drawCall);
-                        _drawCallsToBeSorted.erase(drawCall);
+                assert(_drawCallToPropRebindFuncs->count(drawCall) == 0);
+                for (auto it = _propChangedSlot->begin(); it != _propChangedSlot->end(); ++it)
+                    assert(it->first.second != drawCall);
 
-                        delete drawCall;
+                continue;
+            }
+        }
 
-                        assert(_drawCallToPropRebindFuncs->count(drawCall) == 0);
-                        for (auto it = _propChangedSlot->begin(); it != _propChangedSlot->end(); ++it)
-                            assert(it->first.second != drawCall);
+        drawCall->sortIndex(numDrawCalls);
+        _drawCalls[numDrawCalls] = drawCall;
+        _sortKeys[numDrawCalls] = _sortKeys[i];
+        ++numDrawCalls;
+    }
 
-                        return true;
-                    }
+    _drawCalls.resize(numDrawCalls);
+    _sortKeys.resize(numDrawCalls);
 
-                    return false;
-                }
-            ), drawCalls.end());
-        }
-    }
+    _mustUpdateInstances = true;
 }
 
 void
@@ -378,6 +402,17 @@ DrawCallPool::initializeDrawCall(DrawCall& drawCall, bool forceRebind)
 
     auto program = programAndSignature.first;
 
+    // the draw call keeps its current program, if any, until the selected one is linked
+    if (!program->isReady())
+    {
+        auto& pendingDrawCall = _pendingDrawCalls[&drawCall];
+
+        if (variablesChanged || !pendingDrawCall.first)
+            pendingDrawCall = std::make_pair(variablesChanged, newVariables);
+
+        return;
+    }
+
     if (program == drawCall.program())
     {
         if (variablesChanged)
@@ -413,6 +448,9 @@ DrawCallPool::initializeDrawCall(DrawCall& drawCall, bool forceRebind)
             drawCall.targetData()
         );
     }
+
+    // the program id is part of the sort key
+    updateDrawCallSortKey(&drawCall);
 }
 
 void
@@ -599,6 +637,28 @@ DrawCallPool::stateBindingPropertyAddedHandler(const std::string&       stateNam
 void
 DrawCallPool::update(bool forceSort, bool mustZSort)
 {
+    auto programBuilder = ProgramBuilder::defaultBuilder();
+
+    if (programBuilder != nullptr)
+    {
+        programBuilder->update();
+
+        // the programs might be linked by the builder update of another pool
+        if (programBuilder->numLinkedPrograms() != _numLinkedPrograms)
+        {
+            _numLinkedPrograms = programBuilder->numLinkedPrograms();
+
+            for (auto& pendingDrawCall : _pendingDrawCalls)
+            {
+                auto& invalidDrawCall = _invalidDrawCalls[pendingDrawCall.first];
+
+                if (!invalidDrawCall.first)
+                    invalidDrawCall = pendingDrawCall.second;
+            }
+            _pendingDrawCalls.clear();
+        }
+    }
+
     for (auto& invalidDrawCall : _invalidDrawCalls)
     {
         auto* drawCallPtr = invalidDrawCall.first;
@@ -611,6 +671,9 @@ DrawCallPool::update(bool forceSort, bool mustZSort)
     {
         for (auto& func : drawCallPtrAndFuncList.second)
             func();
+
+        // rebinding states might have changed the priority, the target or the zSorted flag
+        updateDrawCallSortKey(drawCallPtrAndFuncList.first);
     }
 
     _drawCallToPropRebindFuncs->clear();
@@ -619,10 +682,7 @@ DrawCallPool::update(bool forceSort, bool mustZSort)
 #endif
 
     for (auto drawCall : _drawCallsToBeSorted)
-    {
-        removeDrawCallFromSortedBucket(drawCall);
-        addDrawCallToSortedBucket(drawCall);
-    }
+        updateDrawCallSortKey(drawCall);
 
     _drawCallsToBeSorted.clear();
 
@@ -634,6 +694,12 @@ DrawCallPool::update(bool forceSort, bool mustZSort)
 
         zSortDrawCalls();
     }
+
+    if (_mustSort)
+        sortDrawCalls();
+
+    if (_mustUpdateInstances)
+        updateInstances();
 }
 
 void
@@ -657,11 +723,21 @@ void
 DrawCallPool::clear()
 {
     _drawCalls.clear();
+    _sortKeys.clear();
+    _drawCallsSwap.clear();
+    _sortKeysSwap.clear();
+    _mustSort = false;
+    _mustUpdateInstances = false;
+    _targetIds.clear();
+    _targetIdToTarget.clear();
+    _targetIdRefCounts.clear();
+    _freeTargetIds.clear();
     _macroToDrawCalls->clear();
 #ifdef MINKO_USE_SPARSE_HASH_MAP
     _macroToDrawCalls->resize(0);
 #endif
     _invalidDrawCalls.clear();
+    _pendingDrawCalls.clear();
     _macroChangedSlot->clear();
 #ifdef MINKO_USE_SPARSE_HASH_MAP
     _macroChangedSlot->resize(0);
@@ -688,75 +764,291 @@ DrawCallPool::clear()
 void
 DrawCallPool::addDrawCallToSortedBucket(DrawCall* drawCall)
 {
-    const auto priority = drawCall->priority();
-    const auto targetId = drawCall->target().id;
-    const auto zSortedIndex = drawCall->zSorted() ? 1u : 0u;
+    drawCall->sortIndex(_drawCalls.size());
+    _drawCalls.push_back(drawCall);
+    _sortKeys.push_back(computeSortKey(drawCall));
 
-    _drawCalls[SortPropertyTuple(priority, targetId)][zSortedIndex].push_back(drawCall);
+    _mustSort = true;
+    _mustUpdateInstances = true;
 }
 
 void
 DrawCallPool::removeDrawCallFromSortedBucket(DrawCall* drawCall)
 {
-    for (auto& sortPropertiesToDrawCalls : _drawCalls)
+    const auto index = drawCall->sortIndex();
+
+    if (index < 0)
+        return;
+
+    releaseSortKey(_sortKeys[index]);
+
+    // swap with the last draw call of the queue, the order is restored by the next sort
+    auto* lastDrawCall = _drawCalls.back();
+
+    _drawCalls[index] = lastDrawCall;
+    _sortKeys[index] = _sortKeys.back();
+    lastDrawCall->sortIndex(index);
+
+    _drawCalls.pop_back();
+    _sortKeys.pop_back();
+    drawCall->sortIndex(-1);
+
+    _mustSort = true;
+    _mustUpdateInstances = true;
+}
+
+void
+DrawCallPool::updateDrawCallSortKey(DrawCall* drawCall)
+{
+    const auto index = drawCall->sortIndex();
+
+    if (index < 0)
+        return;
+
+    // the draw call has been (re)bound: it might not match the other instances anymore
+    _mustUpdateInstances = true;
+
+    const auto sortKey = computeSortKey(drawCall);
+
+    releaseSortKey(_sortKeys[index]);
+
+    if (sortKey == _sortKeys[index])
+        return;
+
+    _sortKeys[index] = sortKey;
+    _mustSort = true;
+}
+
+uint64_t
+DrawCallPool::computeSortKey(DrawCall* drawCall)
+{
+    // the higher the priority, the earlier the draw call is rendered
+    const uint64_t priority = ~floatToSortableBits(drawCall->priority());
+    const uint64_t targetId = acquireTargetId(drawCall->target().id);
+    uint64_t sortKey = (priority << 32) | ((targetId & SORT_KEY_TARGET_MASK) << SORT_KEY_TARGET_SHIFT);
+
+    if (drawCall->zSorted())
+    {
+        // back to front: the greater the eye space z, the earlier the draw call is rendered
+        const uint64_t depth = ~floatToSortableBits(drawCall->getEyeSpacePosition().z);
+
+        sortKey |= SORT_KEY_ZSORTED_BIT | (depth >> (32 - 21));
+    }
+    else if (drawCall->program())
+    {
+        const auto programId = drawCall->program()->id();
+
+        if (programId > 0)
+            sortKey |= (programId & SORT_KEY_PROGRAM_MASK) << SORT_KEY_PROGRAM_SHIFT;
+
+        sortKey |= (drawCall->samplersHash() & SORT_KEY_HASH_MASK) << SORT_KEY_SAMPLERS_SHIFT;
+        sortKey |= drawCall->attributesHash() & SORT_KEY_HASH_MASK;
+    }
+
+    return sortKey;
+}
+
+void
+DrawCallPool::releaseSortKey(uint64_t sortKey)
+{
+    releaseTargetId(static_cast<uint>((sortKey >> SORT_KEY_TARGET_SHIFT) & SORT_KEY_TARGET_MASK));
+}
+
+uint
+DrawCallPool::acquireTargetId(const int* target)
+{
+    // the back buffer always comes first
+    if (target == nullptr)
+        return 0u;
+
+    auto targetIdIt = _targetIds.find(target);
+    uint targetId;
+
+    if (targetIdIt != _targetIds.end())
+        targetId = targetIdIt->second;
+    else
     {
-        for (auto& drawCalls : sortPropertiesToDrawCalls.second)
+        if (!_freeTargetIds.empty())
         {
-            drawCalls.erase(
-                std::remove(drawCalls.begin(), drawCalls.end(), drawCall),
-                drawCalls.end()
-            );
+            targetId = _freeTargetIds.back();
+            _freeTargetIds.pop_back();
         }
+        else
+        {
+            targetId = static_cast<uint>(_targetIdRefCounts.size() + 1u);
+
+            if (targetId > SORT_KEY_TARGET_MASK)
+                throw std::runtime_error(
+                    "Too many render targets: at most " + std::to_string(SORT_KEY_TARGET_MASK) + " can be used at once."
+                );
+
+            _targetIdToTarget.push_back(nullptr);
+            _targetIdRefCounts.push_back(0u);
+        }
+
+        _targetIds.emplace(target, targetId);
+        _targetIdToTarget[targetId - 1] = target;
     }
+
+    ++_targetIdRefCounts[targetId - 1];
+
+    return targetId;
 }
 
-DrawCall*
-DrawCallPool::findDrawCall(const std::function<bool(DrawCall*)>& predicate)
+void
+DrawCallPool::releaseTargetId(uint targetId)
 {
-    for (const auto& sortPropertiesToDrawCalls : _drawCalls)
+    if (targetId == 0u || --_targetIdRefCounts[targetId - 1] != 0u)
+        return;
+
+    _targetIds.erase(_targetIdToTarget[targetId - 1]);
+    _targetIdToTarget[targetId - 1] = nullptr;
+    _freeTargetIds.push_back(targetId);
+}
+
+void
+DrawCallPool::sortDrawCalls()
+{
+    // LSD radix sort on the 64-bit sort keys, 8 bits at a time
+    // radix sort is stable: draw calls with the same key keep their insertion order
+    const auto numDrawCalls = _drawCalls.size();
+
+    _drawCallsSwap.resize(numDrawCalls);
+    _sortKeysSwap.resize(numDrawCalls);
+
+    for (auto shift = 0u; shift < 64u; shift += 8u)
     {
-        for (const auto& drawCalls : sortPropertiesToDrawCalls.second)
+        std::array<uint, 257> offsets;
+
+        offsets.fill(0u);
+        for (auto sortKey : _sortKeys)
+            ++offsets[((sortKey >> shift) & 0xff) + 1];
+
+        // skip the pass if all the keys share the same digit
+        if (numDrawCalls == 0 || offsets[((_sortKeys[0] >> shift) & 0xff) + 1] == numDrawCalls)
+            continue;
+
+        for (auto i = 1u; i < offsets.size(); ++i)
+            offsets[i] += offsets[i - 1];
+
+        for (auto i = 0u; i < numDrawCalls; ++i)
         {
-            for (auto drawCall : drawCalls)
-            {
-                if (predicate(drawCall))
-                    return drawCall;
-            }
+            const auto destination = offsets[(_sortKeys[i] >> shift) & 0xff]++;
+
+            _drawCallsSwap[destination] = _drawCalls[i];
+            _sortKeysSwap[destination] = _sortKeys[i];
         }
+
+        _drawCalls.swap(_drawCallsSwap);
+        _sortKeys.swap(_sortKeysSwap);
     }
 
-    return nullptr;
+    for (auto i = 0u; i < numDrawCalls; ++i)
+        _drawCalls[i]->sortIndex(i);
+
+    _mustSort = false;
 }
 
 void
-DrawCallPool::foreachDrawCall(const std::function<void(DrawCall*)>& function)
+DrawCallPool::updateInstances()
 {
-    for (const auto& sortPropertiesToDrawCalls : _drawCalls)
+    for (auto drawCall : _drawCalls)
+    {
+        drawCall->instanceLeader(nullptr);
+        drawCall->instances().clear();
+    }
+
+    // only draw calls sharing the same sort key can be merged without changing the rendering order
+    std::vector<DrawCall*> leaders;
+
+    for (auto i = 0u; i < _drawCalls.size(); ++i)
     {
-        for (const auto& drawCalls : sortPropertiesToDrawCalls.second)
+        auto* drawCall = _drawCalls[i];
+
+        if (i == 0 || _sortKeys[i] != _sortKeys[i - 1])
+            leaders.clear();
+
+        if (!drawCall->instanced())
+            continue;
+
+        auto leaderIt = std::find_if(leaders.begin(), leaders.end(), [&](DrawCall* leader)
         {
-            for (auto drawCall : drawCalls)
-            {
-                function(drawCall);
-            }
-        }
+            return leader->canBeInstancedWith(*drawCall);
+        });
+        auto* leader = leaderIt != leaders.end() ? *leaderIt : drawCall;
+
+        if (leader == drawCall && !drawCall->zSorted())
+            leaders.push_back(drawCall);
+
+        drawCall->instanceLeader(leader);
+        leader->instances().push_back(drawCall);
     }
+
+    _mustUpdateInstances = false;
 }
 
-unsigned int
-DrawCallPool::numDrawCalls() const
+uint
+DrawCallPool::packInstances(std::vector<float>& instanceData)
 {
-    auto numDrawCalls = 0u;
+    static const math::mat4 identity;
+
+    auto numInstances = 0u;
 
-    for (const auto& sortPropertiesToDrawCalls : _drawCalls)
+    instanceData.clear();
+
+    for (auto drawCall : _drawCalls)
     {
-        for (const auto& drawCalls : sortPropertiesToDrawCalls.second)
+        if (!drawCall->instanced())
+            continue;
+
+        drawCall->firstInstance(numInstances);
+        drawCall->numInstances(0);
+
+        if (drawCall->instanceLeader() != drawCall)
+            continue;
+
+        for (auto instance : drawCall->instances())
         {
-            numDrawCalls += drawCalls.size();
+            if (!instance->enabled())
+                continue;
+
+            const auto* modelToWorldMatrix = instance->modelToWorldMatrix() != nullptr
+                ? math::value_ptr(*instance->modelToWorldMatrix())
+                : math::value_ptr(identity);
+
+            instanceData.insert(instanceData.end(), modelToWorldMatrix, modelToWorldMatrix + 16);
+            ++numInstances;
         }
+
+        drawCall->numInstances(numInstances - drawCall->firstInstance());
     }
 
-    return numDrawCalls;
+    return numInstances;
+}
+
+DrawCall*
+DrawCallPool::findDrawCall(const std::function<bool(DrawCall*)>& predicate)
+{
+    for (auto drawCall : _drawCalls)
+    {
+        if (predicate(drawCall))
+            return drawCall;
+    }
+
+    return nullptr;
+}
+
+void
+DrawCallPool::foreachDrawCall(const std::function<void(DrawCall*)>& function)
+{
+    for (auto drawCall : _drawCalls)
+        function(drawCall);
+}
+
+unsigned int
+DrawCallPool::numDrawCalls() const
+{
+    return _drawCalls.size();
 }
 
 void
@@ -814,26 +1106,22 @@ DrawCallPool::unbindDrawCall(DrawCall& drawCall)
     //_drawCallToPropRebindFuncs->clear();
 }
 
-bool
-DrawCallPool::compareZSortedDrawCalls(DrawCall* a, DrawCall* b)
-{
-    const auto aPosition = a->getEyeSpacePosition();
-    const auto bPosition = b->getEyeSpacePosition();
-
-    return aPosition.z > bPosition.z;
-}
-
 void
 DrawCallPool::zSortDrawCalls()
 {
-    for (auto& sortPropertiesToDrawCalls : _drawCalls)
+    for (auto i = 0u; i < _drawCalls.size(); ++i)
     {
-        auto& drawCalls = sortPropertiesToDrawCalls.second.at(1u);
+        if ((_sortKeys[i] & SORT_KEY_ZSORTED_BIT) == 0)
+            continue;
 
-        std::sort(
-            drawCalls.begin(),
-            drawCalls.end(),
-            compareZSortedDrawCalls
-        );
+        const auto sortKey = computeSortKey(_drawCalls[i]);
+
+        releaseSortKey(_sortKeys[i]);
+
+        if (sortKey != _sortKeys[i])
+        {
+            _sortKeys[i] = sortKey;
+            _mustSort = true;
+        }
     }
 }
@@ -28,32 +28,63 @@ void
 IndexBuffer::upload(uint	offset,
 					int		count)
 {
-	if (data().empty())
+	auto u16Data = dataPointer<unsigned short>();
+
+	if (u16Data)
+		uploadData(offset, count, *u16Data);
+	else
+		uploadData(offset, count, *dataPointer<unsigned int>());
+}
+
+void
+IndexBuffer::upload(uint                                offset,
+                    int                                 count,
+                    const std::vector<unsigned short>&  data)
+{
+    uploadRange(offset, count, data);
+}
+
+void
+IndexBuffer::upload(uint                                offset,
+                    int                                 count,
+                    const std::vector<unsigned int>&    data)
+{
+    uploadRange(offset, count, data);
+}
+
+template <typename T>
+void
+IndexBuffer::uploadData(uint			offset,
+						int				count,
+						std::vector<T>&	data)
+{
+	if (data.empty())
 		return;
 
-	assert(count <= (int)data().size());
+	assert(count <= (int)data.size());
 
 	if (_id == -1)
-    	_id = _context->createIndexBuffer(data().size());
+    	_id = _context->createIndexBuffer(data.size(), std::is_same<T, unsigned int>::value);
 
 	const auto oldNumIndices	= _numIndices;
-	_numIndices					= count > 0 ? count : data().size();
+	_numIndices					= count > 0 ? count : data.size();
 
 	_context->uploaderIndexBufferData(
 		_id,
 		offset,
         _numIndices,
-		&data()[offset]
+		&data[offset]
 	);
 
 	if (_numIndices != oldNumIndices)
 		_changed->execute(shared_from_this());
 }
 
+template <typename T>
 void
-IndexBuffer::upload(uint                                offset,
-                    int                                 count,
-                    const std::vector<unsigned short>&  data)
+IndexBuffer::uploadRange(uint                   offset,
+                         int                    count,
+                         const std::vector<T>&  data)
 {
     if (data.empty())
         return;
@@ -61,7 +92,7 @@ IndexBuffer::upload(uint                                offset,
     assert(count <= (int)data.size());
 
     if (_id == -1)
-        _id = _context->createIndexBuffer(data.size());
+        _id = _context->createIndexBuffer(data.size(), std::is_same<T, unsigned int>::value);
 
     const auto numIndices = count > 0 ? count : data.size();
     _numIndices = numIndices;
@@ -70,7 +101,7 @@ IndexBuffer::upload(uint                                offset,
         _id,
         offset,
         numIndices,
-        const_cast<unsigned short*>(data.data())
+        const_cast<T*>(data.data())
     );
 
     _changed->execute(shared_from_this());
@@ -0,0 +1,218 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/LightClusters.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	// Signed distance from a view space point to the plane containing the y (resp. x) axis and
+	// the direction of tangent t: positive on the side of the greater tangents.
+	inline
+	float
+	planeDistance(float a, float z, float t)
+	{
+		return (a + t * z) / std::sqrt(1.f + t * t);
+	}
+
+	inline
+	float
+	axisDistance(float value, float min, float max)
+	{
+		return value < min ? min - value : (value > max ? value - max : 0.f);
+	}
+}
+
+LightClusters::LightClusters(uint numClustersX, uint numClustersY, uint numClustersZ, uint maxLightsPerCluster) :
+	_numClustersX(numClustersX),
+	_numClustersY(numClustersY),
+	_numClustersZ(numClustersZ),
+	_maxLightsPerCluster(maxLightsPerCluster),
+	_projection(1.f),
+	_zNear(0.f),
+	_zFar(0.f),
+	_depthScale(0.f),
+	_numDroppedEntries(0)
+{
+	if (numClustersX == 0 || numClustersY == 0 || numClustersZ == 0)
+		throw std::invalid_argument("numClusters");
+	if (maxLightsPerCluster == 0)
+		throw std::invalid_argument("maxLightsPerCluster");
+
+	_tileX.resize(numClustersX + 1);
+	_tileY.resize(numClustersY + 1);
+	_sliceDepth.resize(numClustersZ + 1);
+	_offsets.resize(numClusters(), 0);
+	_counts.resize(numClusters(), 0);
+}
+
+void
+LightClusters::update(const math::mat4&					view,
+					  const math::mat4&					projection,
+					  const std::vector<math::vec4>&	spheres)
+{
+	if (std::abs(projection[2][3] + 1.f) > 1e-6f || projection[3][3] != 0.f)
+		throw std::invalid_argument("projection");
+
+	_projection = projection;
+	_zNear = projection[3][2] / (projection[2][2] - 1.f);
+	_zFar = projection[3][2] / (projection[2][2] + 1.f);
+	_depthScale = static_cast<float>(_numClustersZ) / std::log(_zFar / _zNear);
+
+	// tangents of the tile boundaries: x / depth on the planes where ndc.x = -1 + 2k / numClustersX
+	for (auto k = 0u; k <= _numClustersX; ++k)
+		_tileX[k] = (-1.f + 2.f * k / _numClustersX + projection[2][0]) / projection[0][0];
+	for (auto k = 0u; k <= _numClustersY; ++k)
+		_tileY[k] = (-1.f + 2.f * k / _numClustersY + projection[2][1]) / projection[1][1];
+	for (auto k = 0u; k <= _numClustersZ; ++k)
+		_sliceDepth[k] = _zNear * std::pow(_zFar / _zNear, static_cast<float>(k) / _numClustersZ);
+
+	_entries.clear();
+
+	for (auto light = 0u; light < spheres.size(); ++light)
+	{
+		const auto& sphere = spheres[light];
+
+		if (sphere.w <= 0.f)
+		{
+			for (auto cluster = 0u; cluster < numClusters(); ++cluster)
+				_entries.push_back({ cluster, light });
+		}
+		else
+			binSphere(light, (view * math::vec4(sphere.xyz(), 1.f)).xyz(), sphere.w);
+	}
+
+	// counting sort of the entries: they are already sorted by light, so each list is too and
+	// the lights dropped from a full cluster are the last ones
+	std::fill(_counts.begin(), _counts.end(), 0u);
+	for (const auto& entry : _entries)
+		++_counts[entry.cluster];
+
+	auto offset = 0u;
+
+	_numDroppedEntries = 0;
+	for (auto cluster = 0u; cluster < numClusters(); ++cluster)
+	{
+		const auto count = std::min(_counts[cluster], _maxLightsPerCluster);
+
+		_numDroppedEntries += _counts[cluster] - count;
+		_offsets[cluster] = offset;
+		offset += count;
+	}
+
+	_lightIndices.resize(offset);
+	std::fill(_counts.begin(), _counts.end(), 0u);
+	for (const auto& entry : _entries)
+	{
+		auto& count = _counts[entry.cluster];
+
+		if (count < _maxLightsPerCluster)
+			_lightIndices[_offsets[entry.cluster] + count++] = entry.light;
+	}
+}
+
+void
+LightClusters::binSphere(uint light, const math::vec3& center, float radius)
+{
+	const auto depth = -center.z;
+
+	if (depth + radius < _zNear || depth - radius > _zFar)
+		return;
+
+	const auto minZ = slice(depth - radius);
+	const auto maxZ = slice(depth + radius);
+
+	// conservative column and row ranges: the sphere must reach the inner side of both planes
+	// bounding the tile
+	int minX = _numClustersX, maxX = -1;
+	int minY = _numClustersY, maxY = -1;
+
+	for (auto x = 0; x < static_cast<int>(_numClustersX); ++x)
+		if (planeDistance(center.x, center.z, _tileX[x]) >= -radius
+			&& planeDistance(center.x, center.z, _tileX[x + 1]) <= radius)
+		{
+			minX = std::min(minX, x);
+			maxX = x;
+		}
+	for (auto y = 0; y < static_cast<int>(_numClustersY); ++y)
+		if (planeDistance(center.y, center.z, _tileY[y]) >= -radius
+			&& planeDistance(center.y, center.z, _tileY[y + 1]) <= radius)
+		{
+			minY = std::min(minY, y);
+			maxY = y;
+		}
+
+	// refine with the view space bounding box of each cluster, which trims the corners of the
+	// ranges above
+	const auto radiusSquared = radius * radius;
+
+	for (auto z = minZ; z <= maxZ; ++z)
+	{
+		const auto depth0 = _sliceDepth[z];
+		const auto depth1 = _sliceDepth[z + 1];
+		const auto dz = axisDistance(center.z, -depth1, -depth0);
+
+		for (auto y = minY; y <= maxY; ++y)
+		{
+			const auto dy = axisDistance(
+				center.y,
+				std::min(_tileY[y] * depth0, _tileY[y] * depth1),
+				std::max(_tileY[y + 1] * depth0, _tileY[y + 1] * depth1)
+			);
+
+			for (auto x = minX; x <= maxX; ++x)
+			{
+				const auto dx = axisDistance(
+					center.x,
+					std::min(_tileX[x] * depth0, _tileX[x] * depth1),
+					std::max(_tileX[x + 1] * depth0, _tileX[x + 1] * depth1)
+				);
+
+				if (dx * dx + dy * dy + dz * dz <= radiusSquared)
+					_entries.push_back({ clusterIndex(x, y, z), light });
+			}
+		}
+	}
+}
+
+uint
+LightClusters::cluster(const math::vec3& viewPosition) const
+{
+	const auto clipPosition = _projection * math::vec4(viewPosition, 1.f);
+	const auto depth = std::max(-viewPosition.z, _zNear);
+	const auto x = std::floor((clipPosition.x / depth * .5f + .5f) * _numClustersX);
+	const auto y = std::floor((clipPosition.y / depth * .5f + .5f) * _numClustersY);
+
+	return clusterIndex(
+		static_cast<uint>(math::clamp(x, 0.f, _numClustersX - 1.f)),
+		static_cast<uint>(math::clamp(y, 0.f, _numClustersY - 1.f)),
+		slice(depth)
+	);
+}
+
+uint
+LightClusters::slice(float depth) const
+{
+	const auto z = std::floor(std::log(std::max(depth, _zNear) / _zNear) * _depthScale);
+
+	return static_cast<uint>(math::clamp(z, 0.f, _numClustersZ - 1.f));
+}
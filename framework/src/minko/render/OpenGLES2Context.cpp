@@ -112,6 +112,27 @@ PFNGLGENVERTEXARRAYSOESPROC glGenVertexArrays;
 PFNGLISVERTEXARRAYOESPROC glIsVertexArray;
 #endif
 
+#if MINKO_PLATFORM == MINKO_PLATFORM_ANDROID
+PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor;
+PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstanced;
+#endif
+
+#if MINKO_PLATFORM == MINKO_PLATFORM_IOS
+# undef glVertexAttribDivisor
+# define glVertexAttribDivisor glVertexAttribDivisorEXT
+
+# undef glDrawElementsInstanced
+# define glDrawElementsInstanced glDrawElementsInstancedEXT
+#endif
+
+#if MINKO_PLATFORM == MINKO_PLATFORM_HTML5 || (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS && defined(MINKO_PLUGIN_ANGLE))
+# undef glVertexAttribDivisor
+# define glVertexAttribDivisor glVertexAttribDivisorANGLE
+
+# undef glDrawElementsInstanced
+# define glDrawElementsInstanced glDrawElementsInstancedANGLE
+#endif
+
 #if MINKO_PLATFORM == MINKO_PLATFORM_IOS || MINKO_PLATFORM == MINKO_PLATFORM_HTML5
 # undef glGenVertexArrays
 # define glGenVertexArrays glGenVertexArraysOES
@@ -213,10 +234,10 @@ OpenGLES2Context::OpenGLES2Context() :
 	_viewportHeight(0),
 	_currentTarget(0),
 	_currentIndexBuffer(0),
-	_currentVertexBuffer(8, 0),
-	_currentVertexSize(8, -1),
-	_currentVertexStride(8, -1),
-	_currentVertexOffset(8, -1),
+	_currentVertexBuffer(16, 0),
+	_currentVertexSize(16, -1),
+	_currentVertexStride(16, -1),
+	_currentVertexOffset(16, -1),
 	_currentBoundTexture(0),
 	_currentTexture(8, 0),
 	_currentProgram(0),
@@ -235,6 +256,9 @@ OpenGLES2Context::OpenGLES2Context() :
 	_currentStencilZFailOp(StencilOperation::UNSET),
 	_currentStencilZPassOp(StencilOperation::UNSET),
 	_vertexAttributeEnabled(32u, false),
+	_supportsInstancing(false),
+	_supportsUnsignedIntIndices(false),
+	_supportsProgramBinaries(false),
 	_stencilBits(0)
 {
 #if (MINKO_PLATFORM == MINKO_PLATFORM_WINDOWS) && !defined(MINKO_PLUGIN_ANGLE) && !defined(MINKO_PLUGIN_OFFSCREEN)
@@ -299,6 +323,39 @@ OpenGLES2Context::initializeExtFunctions()
     glDeleteVertexArrays = (PFNGLDELETEVERTEXARRAYSOESPROC)dlsym(libhandle, "glDeleteVertexArraysOES");
     glGenVertexArrays = (PFNGLGENVERTEXARRAYSOESPROC)dlsym(libhandle, "glGenVertexArraysOES");
     glIsVertexArray = (PFNGLISVERTEXARRAYOESPROC)dlsym(libhandle, "glIsVertexArrayOES");
+
+    glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISOREXTPROC)dlsym(libhandle, "glVertexAttribDivisorEXT");
+    glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDEXTPROC)dlsym(libhandle, "glDrawElementsInstancedEXT");
+#endif
+
+#ifdef GL_ES_VERSION_2_0
+    // GL_EXT_instanced_arrays, GL_ANGLE_instanced_arrays...
+    _supportsInstancing = supportsExtension("instanced_arrays");
+#else
+    // glVertexAttribDivisor is core since OpenGL 3.3
+    _supportsInstancing = _oglMajorVersion > 3 || (_oglMajorVersion == 3 && _oglMinorVersion >= 3);
+#endif
+
+#if MINKO_PLATFORM == MINKO_PLATFORM_ANDROID
+    _supportsInstancing = _supportsInstancing && glVertexAttribDivisor && glDrawElementsInstanced;
+#endif
+
+#ifdef GL_ES_VERSION_2_0
+    // GL_OES_element_index_uint
+    _supportsUnsignedIntIndices = supportsExtension("element_index_uint");
+#else
+    _supportsUnsignedIntIndices = true;
+#endif
+
+#if !defined(GL_ES_VERSION_2_0) && defined(GL_PROGRAM_BINARY_LENGTH)
+    // GL_ARB_get_program_binary, core since OpenGL 4.1
+    GLint numProgramBinaryFormats = 0;
+
+    if (_oglMajorVersion > 4 || (_oglMajorVersion == 4 && _oglMinorVersion >= 1)
+        || supportsExtension("get_program_binary"))
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numProgramBinaryFormats);
+
+    _supportsProgramBinaries = numProgramBinaryFormats > 0;
 #endif
 }
 
@@ -424,7 +481,15 @@ OpenGLES2Context::drawTriangles(const uint indexBuffer, const uint firstIndex, c
 	// indices Specifies a pointer to the location where the indices are stored.
 	//
 	// glDrawElements render primitives from array data
-	glDrawElements(GL_TRIANGLES, numTriangles * 3, GL_UNSIGNED_SHORT, reinterpret_cast<GLvoid*>(firstIndex));
+	// indices is a byte offset in the bound index buffer
+	const auto unsignedIntIndices = _unsignedIntIndexBuffers.count(indexBuffer) != 0;
+
+	glDrawElements(
+		GL_TRIANGLES,
+		numTriangles * 3,
+		unsignedIntIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+		reinterpret_cast<GLvoid*>(firstIndex * (unsignedIntIndices ? sizeof(GLuint) : sizeof(GLushort)))
+	);
 
 	checkForErrors();
 }
@@ -439,6 +504,34 @@ OpenGLES2Context::drawTriangles(const uint firstIndex, const int numTriangles)
 	checkForErrors();
 }
 
+void
+OpenGLES2Context::drawTrianglesInstanced(const uint	indexBuffer,
+										 const uint	firstIndex,
+										 const int	numTriangles,
+										 const uint	numInstances)
+{
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+	// https://www.opengl.org/sdk/docs/man/html/glDrawElementsInstanced.xhtml
+	//
+	// void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei primcount);
+	// primcount Specifies the number of instances of the specified range of indices to be rendered.
+	//
+	// glDrawElementsInstanced behaves identically to glDrawElements except that primcount instances of the set
+	// of elements are executed: the vertex attributes with a non-zero divisor advance once every divisor instances.
+	const auto unsignedIntIndices = _unsignedIntIndexBuffers.count(indexBuffer) != 0;
+
+	glDrawElementsInstanced(
+		GL_TRIANGLES,
+		numTriangles * 3,
+		unsignedIntIndices ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT,
+		reinterpret_cast<GLvoid*>(firstIndex * (unsignedIntIndices ? sizeof(GLuint) : sizeof(GLushort))),
+		numInstances
+	);
+
+	checkForErrors();
+}
+
 const uint
 OpenGLES2Context::createVertexBuffer(const uint size)
 {
@@ -588,6 +681,18 @@ OpenGLES2Context::setVertexBufferAt(const uint	position,
     }
 }
 
+void
+OpenGLES2Context::setVertexAttributeDivisor(const uint position, const uint divisor)
+{
+	// https://www.opengl.org/sdk/docs/man/html/glVertexAttribDivisor.xhtml
+	//
+	// void glVertexAttribDivisor(GLuint index, GLuint divisor);
+	// index Specify the index of the generic vertex attribute.
+	// divisor Specify the number of instances that will pass between updates of the generic attribute at slot index.
+	glVertexAttribDivisor(position, divisor);
+
+	checkForErrors();
+}
 
 int
 OpenGLES2Context::createVertexAttributeArray()
@@ -620,8 +725,11 @@ OpenGLES2Context::deleteVertexAttributeArray(const uint vertexArray)
 }
 
 const uint
-OpenGLES2Context::createIndexBuffer(const uint size)
+OpenGLES2Context::createIndexBuffer(const uint size, const bool unsignedIntIndices)
 {
+	if (unsignedIntIndices && !_supportsUnsignedIntIndices)
+		throw std::logic_error("32 bits indices are not supported by this context.");
+
 	uint indexBuffer;
 
 	glGenBuffers(1, &indexBuffer);
@@ -629,9 +737,16 @@ OpenGLES2Context::createIndexBuffer(const uint size)
 
 	_currentIndexBuffer = indexBuffer;
 
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, size * sizeof(GLushort), 0, GL_STATIC_DRAW);
+	glBufferData(
+		GL_ELEMENT_ARRAY_BUFFER,
+		size * (unsignedIntIndices ? sizeof(GLuint) : sizeof(GLushort)),
+		0,
+		GL_STATIC_DRAW
+	);
 
 	_indexBuffers.push_back(indexBuffer);
+	if (unsignedIntIndices)
+		_unsignedIntIndexBuffers.insert(indexBuffer);
 
 	checkForErrors();
 
@@ -648,7 +763,9 @@ OpenGLES2Context::uploaderIndexBufferData(const uint 	indexBuffer,
 
 	_currentIndexBuffer = indexBuffer;
 
-	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * sizeof(GLushort), size * sizeof(GLushort), data);
+	const auto indexSize = _unsignedIntIndexBuffers.count(indexBuffer) != 0 ? sizeof(GLuint) : sizeof(GLushort);
+
+	glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, offset * indexSize, size * indexSize, data);
 
 	checkForErrors();
 }
@@ -660,6 +777,7 @@ OpenGLES2Context::deleteIndexBuffer(const uint indexBuffer)
 		_currentIndexBuffer = 0;
 
 	_indexBuffers.erase(std::find(_indexBuffers.begin(), _indexBuffers.end(), indexBuffer));
+	_unsignedIntIndexBuffers.erase(indexBuffer);
 
 	glDeleteBuffers(1, &indexBuffer);
 
@@ -1207,6 +1325,11 @@ OpenGLES2Context::attachShader(const uint program, const uint shader)
 void
 OpenGLES2Context::linkProgram(const uint program)
 {
+#if !defined(GL_ES_VERSION_2_0) && defined(GL_PROGRAM_BINARY_LENGTH)
+	if (_supportsProgramBinaries)
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+
 	glLinkProgram(program);
 
 #ifdef DEBUG
@@ -1221,6 +1344,55 @@ OpenGLES2Context::linkProgram(const uint program)
 	checkForErrors();
 }
 
+bool
+OpenGLES2Context::getProgramBinary(const uint program, uint& format, std::vector<unsigned char>& binary)
+{
+#if !defined(GL_ES_VERSION_2_0) && defined(GL_PROGRAM_BINARY_LENGTH)
+	if (!_supportsProgramBinaries)
+		return false;
+
+	GLint length = 0;
+
+	glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+		return false;
+
+	GLenum binaryFormat = 0;
+
+	binary.resize(length);
+	glGetProgramBinary(program, length, nullptr, &binaryFormat, &binary[0]);
+	format = binaryFormat;
+
+	checkForErrors();
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+bool
+OpenGLES2Context::programBinary(const uint program, const uint format, const std::vector<unsigned char>& binary)
+{
+#if !defined(GL_ES_VERSION_2_0) && defined(GL_PROGRAM_BINARY_LENGTH)
+	if (!_supportsProgramBinaries || binary.empty())
+		return false;
+
+	GLint linked = GL_FALSE;
+
+	glProgramBinary(program, format, &binary[0], binary.size());
+	glGetProgramiv(program, GL_LINK_STATUS, &linked);
+
+	// an unknown format raises GL_INVALID_ENUM: it is expected and must not be reported
+	while (glGetError() != GL_NO_ERROR)
+		;
+
+	return linked == GL_TRUE;
+#else
+	return false;
+#endif
+}
+
 void
 OpenGLES2Context::deleteProgram(const uint program)
 {
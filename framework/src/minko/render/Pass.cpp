@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/DrawCall.hpp"
 #include "minko/render/States.hpp"
 #include "minko/render/ProgramSignature.hpp"
+#include "minko/render/ProgramBuilder.hpp"
 
 using namespace minko;
 using namespace minko::render;
@@ -45,7 +46,8 @@ Pass::Pass(const std::string&		name,
 	_stateBindings(stateBindings),
 	_macroBindings(macroBindings),
     _states(_stateBindings.defaultValues.providers().front()),
-	_signatureToProgram(),
+	_variants(),
+	_numVariants(0),
 	_uniformFunctions(),
 	_attributeFunctions(),
     _macroFunctions()
@@ -59,59 +61,121 @@ Pass::selectProgram(const EffectVariables&  vars,
 					const Store&			rootData)
 {
 	Program::Ptr program = nullptr;
-    ProgramSignature* signature = nullptr;
+    const ProgramSignature* signature = nullptr;
 
 	if (_macroBindings.bindings.size() == 0)
 		program = _programTemplate;
 	else
 	{
-		signature = new ProgramSignature(_macroBindings, vars, targetData, rendererData, rootData);
-		const auto foundProgramIt = std::find_if(
-            _signatureToProgram.begin(),
-            _signatureToProgram.end(),
-            [&](const std::pair<const ProgramSignature*, Program::Ptr>& signatureAndProgram)
-            {
-                return *signatureAndProgram.first == *signature;
-            }
-        );
-
-        if (foundProgramIt != _signatureToProgram.end())
+		// only the variants that are not known yet get their signature on the heap
+		ProgramSignature candidate(_macroBindings, vars, targetData, rendererData, rootData);
+		auto variant = findVariant(candidate);
+
+        if (variant != nullptr)
         {
-			program = foundProgramIt->second;
-            delete signature;
-            signature = foundProgramIt->first;
+			program = variant->program;
+            signature = variant->signature;
         }
 		else
 		{
+			auto newSignature = new ProgramSignature(candidate);
+
 			program = Program::create(_programTemplate, true);
-            signature->updateProgram(*program);
+            newSignature->updateProgram(*program);
 
-			_signatureToProgram[signature] = program;
+			addVariant(newSignature, program);
+			signature = newSignature;
 		}
-
 	}
 
     return std::pair<std::shared_ptr<Program>, const ProgramSignature*>(finalizeProgram(program), signature);
 }
 
+const Pass::ProgramVariant*
+Pass::findVariant(const ProgramSignature& signature) const
+{
+	if (_variants.empty())
+		return nullptr;
+
+	const auto mask = _variants.size() - 1;
+
+	// linear probing, the table being never more than half full
+	for (auto i = signature.hash() & mask; ; i = (i + 1) & mask)
+	{
+		const auto& variant = _variants[i];
+
+		if (variant.signature == nullptr)
+			return nullptr;
+		if (variant.hash == signature.hash() && *variant.signature == signature)
+			return &variant;
+	}
+}
+
+void
+Pass::addVariant(ProgramSignature* signature, ProgramPtr program)
+{
+	if (2 * (_numVariants + 1) > _variants.size())
+	{
+		auto variants = std::vector<ProgramVariant>(std::max<uint>(16, 2 * _variants.size()));
+
+		_variants.swap(variants);
+		_numVariants = 0;
+
+		for (auto& variant : variants)
+			if (variant.signature != nullptr)
+				addVariant(variant.signature, variant.program);
+	}
+
+	const auto mask = _variants.size() - 1;
+	auto i = signature->hash() & mask;
+
+	while (_variants[i].signature != nullptr)
+		i = (i + 1) & mask;
+
+	_variants[i].hash = signature->hash();
+	_variants[i].signature = signature;
+	_variants[i].program = program;
+	++_numVariants;
+}
+
 Program::Ptr
 Pass::finalizeProgram(Program::Ptr program)
 {
-	if (!program->vertexShader()->isReady())
-		program->vertexShader()->upload();
-	if (!program->fragmentShader()->isReady())
-		program->fragmentShader()->upload();
-	if (!program->isReady())
+	if (program->isReady())
+		return program;
+
+	auto builder = ProgramBuilder::defaultBuilder();
+
+	// the draw calls of the post-processing passes are not rebound when a program gets ready,
+	// see DrawCallPool::addDrawCalls()
+	if (builder == nullptr || !_isForward)
 	{
-		program->upload();
-
-		for (auto& nameAndFunc : _uniformFunctions)
-			nameAndFunc.second(program);
-		for (auto& nameAndFunc : _attributeFunctions)
-			nameAndFunc.second(program);
-        for (auto& nameAndFunc : _macroFunctions)
-			nameAndFunc.second(program);
+		ProgramBuilder::buildNow(program);
+		applyProgramFunctions(program);
+	}
+	else if (!builder->isPending(program))
+	{
+		std::weak_ptr<Pass> pass = shared_from_this();
+
+		builder->build(program, [=](Program::Ptr builtProgram)
+		{
+			auto lockedPass = pass.lock();
+
+			if (lockedPass != nullptr)
+				lockedPass->applyProgramFunctions(builtProgram);
+		});
 	}
 
 	return program;
 }
+
+void
+Pass::applyProgramFunctions(Program::Ptr program)
+{
+	for (auto& nameAndFunc : _uniformFunctions)
+		nameAndFunc.second(program);
+	for (auto& nameAndFunc : _attributeFunctions)
+		nameAndFunc.second(program);
+	for (auto& nameAndFunc : _macroFunctions)
+		nameAndFunc.second(program);
+}
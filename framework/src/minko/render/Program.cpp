@@ -49,6 +49,24 @@ Program::upload()
 	_inputs = _context->getProgramInputs(_id);
 }
 
+bool
+Program::upload(const uint binaryFormat, const std::vector<unsigned char>& binary)
+{
+	_id = _context->createProgram();
+
+	if (!_context->programBinary(_id, binaryFormat, binary))
+	{
+		_context->deleteProgram(_id);
+		_id = -1;
+
+		return false;
+	}
+
+	_inputs = _context->getProgramInputs(_id);
+
+	return true;
+}
+
 void
 Program::dispose()
 {
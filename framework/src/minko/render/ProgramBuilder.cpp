@@ -0,0 +1,178 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/ProgramBuilder.hpp"
+
+#include "minko/render/AbstractContext.hpp"
+#include "minko/render/Program.hpp"
+#include "minko/render/Shader.hpp"
+#include "minko/async/ThreadPool.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+ProgramBuilder::Ptr ProgramBuilder::_default;
+
+ProgramBuilder::ProgramBuilder(std::shared_ptr<async::ThreadPool> pool) :
+	_pool(pool != nullptr ? pool : async::ThreadPool::defaultPool()),
+	_linkTimeBudget(4.f),
+	_numLinkedPrograms(0)
+{
+}
+
+void
+ProgramBuilder::build(ProgramPtr program, const LinkedCallback& linked)
+{
+	if (isPending(program))
+		throw std::logic_error("The program is already being built.");
+
+	auto build = createBuild(program);
+
+	build->linked = linked;
+	_pendingPrograms.insert(program.get());
+	_builds.emplace_back(build, _pool->enqueue([=]() { prepare(*build); }));
+}
+
+uint
+ProgramBuilder::update()
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	auto numLinked = 0u;
+
+	for (auto buildIt = _builds.begin(); buildIt != _builds.end();)
+	{
+		if (numLinked != 0)
+		{
+			auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start);
+
+			if (elapsed.count() >= _linkTimeBudget)
+				break;
+		}
+
+		if (buildIt->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		{
+			++buildIt;
+			continue;
+		}
+
+		auto build = buildIt->first;
+		auto prepared = std::move(buildIt->second);
+
+		buildIt = _builds.erase(buildIt);
+		_pendingPrograms.erase(build->program.get());
+
+		// rethrows the errors of the optimizer
+		prepared.get();
+		link(*build);
+
+		++numLinked;
+		++_numLinkedPrograms;
+
+		if (build->linked)
+			build->linked(build->program);
+	}
+
+	return numLinked;
+}
+
+void
+ProgramBuilder::buildNow(ProgramPtr program)
+{
+	auto vertexShader = program->vertexShader();
+	auto fragmentShader = program->fragmentShader();
+
+	// shaders shared with a program that is already built
+	if (vertexShader->isReady() || fragmentShader->isReady())
+	{
+		if (!vertexShader->isReady())
+			vertexShader->upload();
+		if (!fragmentShader->isReady())
+			fragmentShader->upload();
+
+		program->upload();
+
+		return;
+	}
+
+	auto build = createBuild(program);
+
+	prepare(*build);
+	link(*build);
+}
+
+ProgramBuilder::BuildPtr
+ProgramBuilder::createBuild(ProgramPtr program)
+{
+	auto build = std::make_shared<Build>();
+
+	// the sources are copied so that the pool threads never touch the program
+	build->program = program;
+	build->vertexSource = program->vertexShader()->source();
+	build->fragmentSource = program->fragmentShader()->source();
+	build->cache = ProgramCache::defaultCache();
+	build->key = 0;
+	build->cached = false;
+
+	return build;
+}
+
+void
+ProgramBuilder::prepare(Build& build)
+{
+	if (build.cache != nullptr)
+	{
+		build.key = ProgramCache::key(build.vertexSource, build.fragmentSource);
+		build.cached = build.cache->find(build.key, build.entry);
+	}
+
+	if (!build.cached)
+	{
+		build.entry.vertexSource = Shader::contextSource(Shader::Type::VERTEX_SHADER, build.vertexSource);
+		build.entry.fragmentSource = Shader::contextSource(Shader::Type::FRAGMENT_SHADER, build.fragmentSource);
+	}
+}
+
+void
+ProgramBuilder::link(Build& build)
+{
+	auto program = build.program;
+	auto context = program->context();
+	auto& entry = build.entry;
+
+	if (build.cached && !entry.binary.empty() && entry.driverInfo == context->driverInfo()
+		&& program->upload(entry.binaryFormat, entry.binary))
+		return;
+
+	program->vertexShader()->upload(entry.vertexSource);
+	program->fragmentShader()->upload(entry.fragmentSource);
+	program->upload();
+
+	if (build.cache == nullptr)
+		return;
+
+	// the binary of an entry is refreshed when the driver changed or rejected it
+	if (context->supportsProgramBinaries()
+		&& context->getProgramBinary(program->id(), entry.binaryFormat, entry.binary))
+		entry.driverInfo = context->driverInfo();
+	else if (build.cached)
+		return;
+
+	build.cache->store(build.key, entry);
+}
@@ -0,0 +1,176 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/ProgramCache.hpp"
+
+#include "minko/Hash.hpp"
+#include "minko/log/Logger.hpp"
+
+#include <iomanip>
+
+using namespace minko;
+using namespace minko::render;
+
+ProgramCache::Ptr ProgramCache::_default;
+
+namespace
+{
+	const uint MAGIC	= 0x4d4b5043; // "MKPC"
+	const uint VERSION	= 1;
+
+	void
+	write(std::ostream& stream, uint value)
+	{
+		stream.write(reinterpret_cast<const char*>(&value), sizeof(uint));
+	}
+
+	template <typename T>
+	void
+	write(std::ostream& stream, const T& bytes)
+	{
+		write(stream, uint(bytes.size()));
+		if (!bytes.empty())
+			stream.write(reinterpret_cast<const char*>(&bytes[0]), bytes.size());
+	}
+
+	bool
+	read(std::istream& stream, uint& value)
+	{
+		return !!stream.read(reinterpret_cast<char*>(&value), sizeof(uint));
+	}
+
+	template <typename T>
+	bool
+	read(std::istream& stream, T& bytes)
+	{
+		auto size = 0u;
+
+		if (!read(stream, size))
+			return false;
+
+		bytes.resize(size);
+
+		return size == 0 || !!stream.read(reinterpret_cast<char*>(&bytes[0]), size);
+	}
+}
+
+ProgramCache::KeyType
+ProgramCache::key(const std::string& vertexSource, const std::string& fragmentSource)
+{
+	// the separator keeps "ab" + "c" and "a" + "bc" apart
+	const unsigned char separator = 0xff;
+
+	auto hash = minko::hash(vertexSource.data(), vertexSource.size());
+
+	hash = minko::hash(&separator, 1, hash);
+
+	return minko::hash(fragmentSource.data(), fragmentSource.size(), hash);
+}
+
+bool
+ProgramCache::find(KeyType key, Entry& entry)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto entryIt = _entries.find(key);
+
+	if (entryIt != _entries.end())
+	{
+		entry = entryIt->second;
+
+		return true;
+	}
+
+	if (_directory.empty() || _missingKeys.count(key) != 0)
+		return false;
+
+	if (!load(key, entry))
+	{
+		_missingKeys.insert(key);
+
+		return false;
+	}
+
+	_entries[key] = entry;
+
+	return true;
+}
+
+void
+ProgramCache::store(KeyType key, const Entry& entry)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_entries[key] = entry;
+	_missingKeys.erase(key);
+
+	if (!_directory.empty())
+		save(key, entry);
+}
+
+std::string
+ProgramCache::filename(KeyType key) const
+{
+	std::ostringstream stream;
+
+	stream << _directory << "/" << std::hex << std::setw(16) << std::setfill('0') << key << ".program";
+
+	return stream.str();
+}
+
+bool
+ProgramCache::load(KeyType key, Entry& entry) const
+{
+	std::ifstream file(filename(key), std::ios::in | std::ios::binary);
+
+	if (!file.is_open())
+		return false;
+
+	auto magic = 0u;
+	auto version = 0u;
+
+	return read(file, magic) && magic == MAGIC
+		&& read(file, version) && version == VERSION
+		&& read(file, entry.vertexSource)
+		&& read(file, entry.fragmentSource)
+		&& read(file, entry.driverInfo)
+		&& read(file, entry.binaryFormat)
+		&& read(file, entry.binary);
+}
+
+void
+ProgramCache::save(KeyType key, const Entry& entry) const
+{
+	std::ofstream file(filename(key), std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!file.is_open())
+	{
+		LOG_WARNING("unable to write the program cache file " << filename(key));
+
+		return;
+	}
+
+	write(file, MAGIC);
+	write(file, VERSION);
+	write(file, entry.vertexSource);
+	write(file, entry.fragmentSource);
+	write(file, entry.driverInfo);
+	write(file, entry.binaryFormat);
+	write(file, entry.binary);
+}
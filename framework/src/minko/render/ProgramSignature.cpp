@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/DrawCall.hpp"
 #include "minko/data/BindingMap.hpp"
 #include "minko/data/MacroBinding.hpp"
+#include "minko/Hash.hpp"
 
 #include "sparsehash/sparse_hash_map"
 
@@ -33,6 +34,30 @@ using namespace minko::data;
 
 const uint ProgramSignature::_maxNumMacros = sizeof(MaskType) * 8;
 
+namespace
+{
+    template <typename T>
+    inline
+    void
+    hashValue(ProgramSignature::HashType& hash, const Any& value)
+    {
+        const T* v = Any::unsafe_cast<T>(&value);
+
+        hash = minko::hash(v, sizeof(T), hash);
+    }
+
+    // -0 and +0 compare equal and must have the same hash.
+    template <typename T>
+    inline
+    void
+    hashFloatValue(ProgramSignature::HashType& hash, const Any& value)
+    {
+        const T v = *Any::unsafe_cast<T>(&value) + 0.f;
+
+        hash = minko::hash(&v, sizeof(T), hash);
+    }
+}
+
 ProgramSignature::ProgramSignature(const data::MacroBindingMap& macroBindings,
                                    const EffectVariables&       variables,
                                    const Store&			        targetData,
@@ -100,18 +125,85 @@ ProgramSignature::ProgramSignature(const data::MacroBindingMap& macroBindings,
             ++macroId;
         }
     }
+
+    _hash = computeHash();
 }
 
 ProgramSignature::ProgramSignature(const ProgramSignature& signature) :
     _mask(signature._mask),
-    _values(signature._values)
+    _hash(signature._hash),
+    _values(signature._values),
+    _types(signature._types),
+    _macros(signature._macros)
+{
+}
+
+ProgramSignature::HashType
+ProgramSignature::computeHash() const
 {
+    auto hash = minko::hash(&_mask, sizeof(MaskType));
+
+    auto j = 0u;
+
+    for (auto type : _types)
+    {
+        hash = minko::hash(&type, sizeof(type), hash);
+
+        if (type == MacroBindingMap::MacroType::UNSET)
+            continue;
+
+        const auto& value = _values[j++];
+
+        switch (type)
+        {
+        case MacroBindingMap::MacroType::BOOL:
+            hashValue<bool>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::BOOL2:
+            hashValue<math::bvec2>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::BOOL3:
+            hashValue<math::bvec3>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::BOOL4:
+            hashValue<math::bvec4>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::INT:
+            hashValue<int>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::INT2:
+            hashValue<math::ivec2>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::INT3:
+            hashValue<math::ivec3>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::INT4:
+            hashValue<math::ivec4>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::FLOAT:
+            hashFloatValue<float>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::FLOAT2:
+            hashFloatValue<math::vec2>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::FLOAT3:
+            hashFloatValue<math::vec3>(hash, value);
+            break;
+        case MacroBindingMap::MacroType::FLOAT4:
+            hashFloatValue<math::vec4>(hash, value);
+            break;
+        default:
+            break;
+        }
+    }
+
+    return hash;
 }
 
 bool
 ProgramSignature::operator==(const ProgramSignature& x) const
 {
-	if (_mask != x._mask)
+	if (_hash != x._hash || _mask != x._mask || _types.size() != x._types.size())
 		return false;
 
     auto j = 0;
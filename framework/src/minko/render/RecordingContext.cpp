@@ -0,0 +1,1162 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/render/RecordingContext.hpp"
+
+#include "minko/render/CompareMode.hpp"
+#include "minko/render/WrapMode.hpp"
+#include "minko/render/TextureFilter.hpp"
+#include "minko/render/MipFilter.hpp"
+#include "minko/render/TextureFormatInfo.hpp"
+#include "minko/render/TriangleCulling.hpp"
+#include "minko/render/StencilOperation.hpp"
+#include "minko/log/Logger.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+    typedef std::vector<std::string>                        Tokens;
+    typedef std::unordered_map<std::string, Tokens>         Macros;
+
+    Tokens
+    tokenize(const std::string& line)
+    {
+        Tokens tokens;
+        auto i = 0u;
+
+        while (i < line.size())
+        {
+            auto c = line[i];
+
+            if (std::isspace(c))
+            {
+                ++i;
+            }
+            else if (std::isalpha(c) || c == '_')
+            {
+                auto start = i;
+
+                while (i < line.size() && (std::isalnum(line[i]) || line[i] == '_'))
+                    ++i;
+                tokens.push_back(line.substr(start, i - start));
+            }
+            else if (std::isdigit(c) || (c == '.' && i + 1 < line.size() && std::isdigit(line[i + 1])))
+            {
+                auto start = i;
+
+                while (i < line.size() && (std::isalnum(line[i]) || line[i] == '.'))
+                    ++i;
+                tokens.push_back(line.substr(start, i - start));
+            }
+            else
+            {
+                static const std::string twoCharOperators[] = { "&&", "||", "==", "!=", "<=", ">=" };
+                auto op = std::string(1, c);
+
+                for (auto& twoCharOperator : twoCharOperators)
+                    if (line.compare(i, 2, twoCharOperator) == 0)
+                        op = twoCharOperator;
+
+                tokens.push_back(op);
+                i += op.size();
+            }
+        }
+
+        return tokens;
+    }
+
+    // Evaluates the integer expressions found in #if and #elif directives.
+    class ConditionEvaluator
+    {
+    private:
+        const Tokens&   _tokens;
+        const Macros&   _macros;
+        uint            _position;
+        uint            _depth;
+
+    public:
+        ConditionEvaluator(const Tokens& tokens, const Macros& macros, uint depth = 0) :
+            _tokens(tokens),
+            _macros(macros),
+            _position(0),
+            _depth(depth)
+        {
+        }
+
+        int
+        evaluate()
+        {
+            return logicalOr();
+        }
+
+    private:
+        bool
+        accept(const std::string& token)
+        {
+            if (_position < _tokens.size() && _tokens[_position] == token)
+            {
+                ++_position;
+
+                return true;
+            }
+
+            return false;
+        }
+
+        int
+        logicalOr()
+        {
+            auto value = logicalAnd();
+
+            while (accept("||"))
+                value = logicalAnd() || value;
+
+            return value;
+        }
+
+        int
+        logicalAnd()
+        {
+            auto value = comparison();
+
+            while (accept("&&"))
+                value = comparison() && value;
+
+            return value;
+        }
+
+        int
+        comparison()
+        {
+            auto value = additive();
+
+            while (true)
+            {
+                if (accept("=="))
+                    value = value == additive();
+                else if (accept("!="))
+                    value = value != additive();
+                else if (accept("<="))
+                    value = value <= additive();
+                else if (accept(">="))
+                    value = value >= additive();
+                else if (accept("<"))
+                    value = value < additive();
+                else if (accept(">"))
+                    value = value > additive();
+                else
+                    return value;
+            }
+        }
+
+        int
+        additive()
+        {
+            auto value = unary();
+
+            while (true)
+            {
+                if (accept("+"))
+                    value += unary();
+                else if (accept("-"))
+                    value -= unary();
+                else
+                    return value;
+            }
+        }
+
+        int
+        unary()
+        {
+            if (accept("!"))
+                return !unary();
+            if (accept("-"))
+                return -unary();
+            if (accept("("))
+            {
+                auto value = logicalOr();
+
+                accept(")");
+
+                return value;
+            }
+            if (_position >= _tokens.size())
+                return 0;
+
+            auto token = _tokens[_position++];
+
+            if (token == "defined")
+            {
+                auto parenthesis = accept("(");
+                auto name = _position < _tokens.size() ? _tokens[_position++] : std::string();
+
+                if (parenthesis)
+                    accept(")");
+
+                return _macros.count(name) != 0;
+            }
+
+            if (std::isdigit(token[0]))
+                return std::strtol(token.c_str(), nullptr, 0);
+
+            auto macro = _macros.find(token);
+
+            if (macro == _macros.end() || macro->second.empty() || _depth > 16)
+                return 0;
+
+            return ConditionEvaluator(macro->second, _macros, _depth + 1).evaluate();
+        }
+    };
+
+    std::string
+    stripComments(const std::string& source)
+    {
+        std::string result;
+
+        result.reserve(source.size());
+
+        for (auto i = 0u; i < source.size(); ++i)
+        {
+            if (source.compare(i, 2, "//") == 0)
+            {
+                while (i < source.size() && source[i] != '\n')
+                    ++i;
+                result += '\n';
+            }
+            else if (source.compare(i, 2, "/*") == 0)
+            {
+                auto end = source.find("*/", i + 2);
+
+                end = end == std::string::npos ? source.size() : end + 1;
+                result.append(std::count(source.begin() + i, source.begin() + end, '\n'), '\n');
+                i = end;
+            }
+            else
+                result += source[i];
+        }
+
+        return result;
+    }
+
+    // Runs the preprocessor directives of the source and returns the tokens of the active
+    // code, with the object-like macros expanded.
+    Tokens
+    preprocess(const std::string& source)
+    {
+        struct Condition
+        {
+            bool parentActive;
+            bool taken;
+            bool active;
+        };
+
+        Macros                  macros;
+        std::vector<Condition>  conditions;
+        Tokens                  tokens;
+        std::stringstream       stream(stripComments(source));
+        std::string             line;
+
+        auto active = [&]() { return conditions.empty() || conditions.back().active; };
+
+        while (std::getline(stream, line))
+        {
+            auto lineTokens = tokenize(line);
+
+            if (lineTokens.empty())
+                continue;
+
+            if (lineTokens[0] == "#")
+            {
+                if (lineTokens.size() < 2)
+                    continue;
+
+                auto& directive = lineTokens[1];
+                auto arguments = Tokens(lineTokens.begin() + 2, lineTokens.end());
+
+                if (directive == "ifdef" || directive == "ifndef" || directive == "if")
+                {
+                    auto value = false;
+
+                    if (directive == "if")
+                        value = ConditionEvaluator(arguments, macros).evaluate() != 0;
+                    else if (!arguments.empty())
+                        value = (macros.count(arguments[0]) != 0) == (directive == "ifdef");
+
+                    auto parentActive = active();
+
+                    conditions.push_back({ parentActive, value, parentActive && value });
+                }
+                else if (directive == "elif" && !conditions.empty())
+                {
+                    auto& condition = conditions.back();
+                    auto value = !condition.taken && ConditionEvaluator(arguments, macros).evaluate() != 0;
+
+                    condition.active = condition.parentActive && value;
+                    condition.taken = condition.taken || value;
+                }
+                else if (directive == "else" && !conditions.empty())
+                {
+                    auto& condition = conditions.back();
+
+                    condition.active = condition.parentActive && !condition.taken;
+                    condition.taken = true;
+                }
+                else if (directive == "endif" && !conditions.empty())
+                    conditions.pop_back();
+                else if (!active())
+                    continue;
+                else if (directive == "define" && !arguments.empty())
+                    macros[arguments[0]] = Tokens(arguments.begin() + 1, arguments.end());
+                else if (directive == "undef" && !arguments.empty())
+                    macros.erase(arguments[0]);
+                else if (directive == "version" && !arguments.empty())
+                {
+                    macros["__VERSION__"] = Tokens(1, arguments[0]);
+                    if (arguments[0] == "100")
+                        macros["GL_ES"] = Tokens(1, "1");
+                }
+
+                continue;
+            }
+
+            if (!active())
+                continue;
+
+            for (auto& token : lineTokens)
+            {
+                auto macro = macros.find(token);
+
+                if (macro != macros.end())
+                    tokens.insert(tokens.end(), macro->second.begin(), macro->second.end());
+                else
+                    tokens.push_back(token);
+            }
+        }
+
+        return tokens;
+    }
+
+    ProgramInputs::Type
+    inputType(const std::string& type)
+    {
+        static const std::unordered_map<std::string, ProgramInputs::Type> types = {
+            { "float",          ProgramInputs::Type::float1 },
+            { "vec2",           ProgramInputs::Type::float2 },
+            { "vec3",           ProgramInputs::Type::float3 },
+            { "vec4",           ProgramInputs::Type::float4 },
+            { "int",            ProgramInputs::Type::int1 },
+            { "ivec2",          ProgramInputs::Type::int2 },
+            { "ivec3",          ProgramInputs::Type::int3 },
+            { "ivec4",          ProgramInputs::Type::int4 },
+            { "bool",           ProgramInputs::Type::bool1 },
+            { "bvec2",          ProgramInputs::Type::bool2 },
+            { "bvec3",          ProgramInputs::Type::bool3 },
+            { "bvec4",          ProgramInputs::Type::bool4 },
+            { "mat3",           ProgramInputs::Type::float9 },
+            { "mat4",           ProgramInputs::Type::float16 },
+            { "sampler2D",      ProgramInputs::Type::sampler2d },
+            { "samplerCube",    ProgramInputs::Type::samplerCube }
+        };
+
+        auto it = types.find(type);
+
+        return it != types.end() ? it->second : ProgramInputs::Type::unknown;
+    }
+}
+
+RecordingContext::RecordingContext(bool supportsInstancing) :
+    _errorsEnabled(false),
+    _supportsInstancing(supportsInstancing),
+    _driverInfo("RecordingContext"),
+    _numCommands(static_cast<uint>(Command::NUM_COMMANDS), 0),
+    _numFrames(0),
+    _nextResourceId(1),
+    _currentTarget(0),
+    _currentProgram(0),
+    _viewportWidth(0),
+    _viewportHeight(0)
+{
+}
+
+uint
+RecordingContext::numCommands() const
+{
+    auto total = 0u;
+
+    for (auto numCommands : _numCommands)
+        total += numCommands;
+
+    return total;
+}
+
+void
+RecordingContext::clearLog()
+{
+    _log.clear();
+    _numCommands.assign(static_cast<uint>(Command::NUM_COMMANDS), 0);
+    _numFrames = 0;
+}
+
+void
+RecordingContext::write(Command command)
+{
+    ++_numCommands[static_cast<uint>(command)];
+    _log.push_back(static_cast<unsigned char>(command));
+}
+
+void
+RecordingContext::writeData(const void* data, uint size)
+{
+    if (data == nullptr)
+        size = 0;
+
+    write(size);
+
+    if (size == 0)
+        return;
+
+    auto offset = _log.size();
+
+    _log.resize(offset + size);
+    std::memcpy(&_log[offset], data, size);
+}
+
+void
+RecordingContext::writeUniform(Command command, uint location, uint count, uint numComponents, const void* v)
+{
+    write(command);
+    write(location);
+    write(count);
+
+    auto size = count * numComponents * 4;
+    auto offset = _log.size();
+
+    _log.resize(offset + size);
+    if (size != 0)
+        std::memcpy(&_log[offset], v, size);
+}
+
+void
+RecordingContext::configureViewport(const uint x,
+                                    const uint y,
+                                    const uint width,
+                                    const uint height)
+{
+    _viewportWidth = width;
+    _viewportHeight = height;
+
+    write(Command::ConfigureViewport);
+    write(x);
+    write(y);
+    write(width);
+    write(height);
+}
+
+void
+RecordingContext::clear(float red, float green, float blue, float alpha, float depth, uint stencil, uint mask)
+{
+    write(Command::Clear);
+    write(red);
+    write(green);
+    write(blue);
+    write(alpha);
+    write(depth);
+    write(stencil);
+    write(mask);
+}
+
+void
+RecordingContext::present()
+{
+    ++_numFrames;
+
+    write(Command::Present);
+}
+
+void
+RecordingContext::drawTriangles(const uint indexBuffer, const uint firstIndex, const int numTriangles)
+{
+    write(Command::DrawIndexedTriangles);
+    write(indexBuffer);
+    write(firstIndex);
+    write(numTriangles);
+}
+
+void
+RecordingContext::drawTriangles(const uint firstIndex, const int numTriangles)
+{
+    write(Command::DrawTriangles);
+    write(firstIndex);
+    write(numTriangles);
+}
+
+void
+RecordingContext::drawTrianglesInstanced(const uint indexBuffer,
+                                         const uint firstIndex,
+                                         const int  numTriangles,
+                                         const uint numInstances)
+{
+    write(Command::DrawTrianglesInstanced);
+    write(indexBuffer);
+    write(firstIndex);
+    write(numTriangles);
+    write(numInstances);
+}
+
+const uint
+RecordingContext::createVertexBuffer(const uint size)
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateVertexBuffer);
+    write(id);
+    write(size);
+
+    return id;
+}
+
+void
+RecordingContext::setVertexBufferAt(const uint position,
+                                    const uint vertexBuffer,
+                                    const uint size,
+                                    const uint stride,
+                                    const uint offset)
+{
+    write(Command::SetVertexBufferAt);
+    write(position);
+    write(vertexBuffer);
+    write(size);
+    write(stride);
+    write(offset);
+}
+
+void
+RecordingContext::setVertexAttributeDivisor(const uint position, const uint divisor)
+{
+    write(Command::SetVertexAttributeDivisor);
+    write(position);
+    write(divisor);
+}
+
+void
+RecordingContext::uploadVertexBufferData(const uint vertexBuffer,
+                                         const uint offset,
+                                         const uint size,
+                                         void*      data)
+{
+    write(Command::UploadVertexBufferData);
+    write(vertexBuffer);
+    write(offset);
+    writeData(data, size * sizeof(float));
+}
+
+void
+RecordingContext::deleteVertexBuffer(const uint vertexBuffer)
+{
+    write(Command::DeleteVertexBuffer);
+    write(vertexBuffer);
+}
+
+const uint
+RecordingContext::createIndexBuffer(const uint size, const bool unsignedIntIndices)
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateIndexBuffer);
+    write(id);
+    write(size);
+    write(unsignedIntIndices);
+
+    if (unsignedIntIndices)
+        _unsignedIntIndexBuffers.insert(id);
+
+    return id;
+}
+
+void
+RecordingContext::uploaderIndexBufferData(const uint   indexBuffer,
+                                          const uint   offset,
+                                          const uint   size,
+                                          void*        data)
+{
+    write(Command::UploadIndexBufferData);
+    write(indexBuffer);
+    write(offset);
+    writeData(
+        data,
+        size * (_unsignedIntIndexBuffers.count(indexBuffer) != 0 ? sizeof(unsigned int) : sizeof(unsigned short))
+    );
+}
+
+void
+RecordingContext::deleteIndexBuffer(const uint indexBuffer)
+{
+    write(Command::DeleteIndexBuffer);
+    write(indexBuffer);
+
+    _unsignedIntIndexBuffers.erase(indexBuffer);
+}
+
+uint
+RecordingContext::createTexture(TextureType type,
+                                uint        width,
+                                uint        height,
+                                bool        mipMapping,
+                                bool        optimizeForRenderToTexture)
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateTexture);
+    write(id);
+    write(static_cast<uint>(type));
+    write(width);
+    write(height);
+    write(mipMapping);
+    write(optimizeForRenderToTexture);
+
+    return id;
+}
+
+uint
+RecordingContext::createCompressedTexture(TextureType   type,
+                                          TextureFormat format,
+                                          uint          width,
+                                          uint          height,
+                                          bool          mipMapping)
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateCompressedTexture);
+    write(id);
+    write(static_cast<uint>(type));
+    write(static_cast<uint>(format));
+    write(width);
+    write(height);
+    write(mipMapping);
+
+    return id;
+}
+
+uint
+RecordingContext::createRectangleTexture(TextureType type, uint width, uint height)
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateRectangleTexture);
+    write(id);
+    write(static_cast<uint>(type));
+    write(width);
+    write(height);
+
+    return id;
+}
+
+void
+RecordingContext::uploadTexture2dData(uint  texture,
+                                      uint  width,
+                                      uint  height,
+                                      uint  mipLevel,
+                                      void* data)
+{
+    write(Command::UploadTexture2dData);
+    write(texture);
+    write(width);
+    write(height);
+    write(mipLevel);
+    writeData(data, width * height * 4);
+}
+
+void
+RecordingContext::uploadCubeTextureData(uint                texture,
+                                        CubeTexture::Face   face,
+                                        uint                width,
+                                        uint                height,
+                                        uint                mipLevel,
+                                        void*               data)
+{
+    write(Command::UploadCubeTextureData);
+    write(texture);
+    write(static_cast<uint>(face));
+    write(width);
+    write(height);
+    write(mipLevel);
+    writeData(data, width * height * 4);
+}
+
+void
+RecordingContext::uploadCompressedTexture2dData(uint            texture,
+                                                TextureFormat   format,
+                                                uint            width,
+                                                uint            height,
+                                                uint            size,
+                                                uint            mipLevel,
+                                                void*           data)
+{
+    write(Command::UploadCompressedTexture2dData);
+    write(texture);
+    write(static_cast<uint>(format));
+    write(width);
+    write(height);
+    write(mipLevel);
+    writeData(data, size);
+}
+
+void
+RecordingContext::uploadCompressedCubeTextureData(uint              texture,
+                                                  CubeTexture::Face face,
+                                                  TextureFormat     format,
+                                                  uint              width,
+                                                  uint              height,
+                                                  uint              mipLevel,
+                                                  void*             data)
+{
+    write(Command::UploadCompressedCubeTextureData);
+    write(texture);
+    write(static_cast<uint>(face));
+    write(static_cast<uint>(format));
+    write(width);
+    write(height);
+    write(mipLevel);
+    writeData(data, TextureFormatInfo::textureSize(format, width, height));
+}
+
+void
+RecordingContext::activateMipMapping(uint texture)
+{
+    write(Command::ActivateMipMapping);
+    write(texture);
+}
+
+void
+RecordingContext::deleteTexture(uint texture)
+{
+    write(Command::DeleteTexture);
+    write(texture);
+}
+
+void
+RecordingContext::setTextureAt(uint position, int texture, int location)
+{
+    write(Command::SetTextureAt);
+    write(position);
+    write(texture);
+    write(location);
+}
+
+void
+RecordingContext::setSamplerStateAt(uint            position,
+                                    WrapMode        wrapping,
+                                    TextureFilter   filtering,
+                                    MipFilter       mipFiltering)
+{
+    write(Command::SetSamplerStateAt);
+    write(position);
+    write(static_cast<uint>(wrapping));
+    write(static_cast<uint>(filtering));
+    write(static_cast<uint>(mipFiltering));
+}
+
+const uint
+RecordingContext::createProgram()
+{
+    auto id = _nextResourceId++;
+
+    _programShaders[id];
+
+    write(Command::CreateProgram);
+    write(id);
+
+    return id;
+}
+
+void
+RecordingContext::attachShader(const uint program, const uint shader)
+{
+    _programShaders[program].push_back(shader);
+
+    write(Command::AttachShader);
+    write(program);
+    write(shader);
+}
+
+void
+RecordingContext::linkProgram(const uint program)
+{
+    write(Command::LinkProgram);
+    write(program);
+}
+
+void
+RecordingContext::deleteProgram(const uint program)
+{
+    _programShaders.erase(program);
+    if (_currentProgram == program)
+        _currentProgram = 0;
+
+    write(Command::DeleteProgram);
+    write(program);
+}
+
+void
+RecordingContext::compileShader(const uint shader)
+{
+    write(Command::CompileShader);
+    write(shader);
+}
+
+void
+RecordingContext::setProgram(const uint program)
+{
+    _currentProgram = program;
+
+    write(Command::SetProgram);
+    write(program);
+}
+
+void
+RecordingContext::setShaderSource(const uint shader, const std::string& source)
+{
+    _shaderSources[shader] = source;
+
+    write(Command::SetShaderSource);
+    write(shader);
+    writeData(source.data(), source.size());
+}
+
+const uint
+RecordingContext::createVertexShader()
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateVertexShader);
+    write(id);
+
+    return id;
+}
+
+void
+RecordingContext::deleteVertexShader(const uint vertexShader)
+{
+    _shaderSources.erase(vertexShader);
+
+    write(Command::DeleteVertexShader);
+    write(vertexShader);
+}
+
+const uint
+RecordingContext::createFragmentShader()
+{
+    auto id = _nextResourceId++;
+
+    write(Command::CreateFragmentShader);
+    write(id);
+
+    return id;
+}
+
+void
+RecordingContext::deleteFragmentShader(const uint fragmentShader)
+{
+    _shaderSources.erase(fragmentShader);
+
+    write(Command::DeleteFragmentShader);
+    write(fragmentShader);
+}
+
+ProgramInputs
+RecordingContext::getProgramInputs(const uint program)
+{
+    std::vector<std::string> sources;
+
+    if (_programShaders.count(program) != 0)
+        for (auto shader : _programShaders.at(program))
+            if (_shaderSources.count(shader) != 0)
+                sources.push_back(_shaderSources.at(shader));
+
+    return parseProgramInputs(sources);
+}
+
+/*static*/
+ProgramInputs
+RecordingContext::parseProgramInputs(const std::vector<std::string>& sources)
+{
+    struct Declaration
+    {
+        std::string         name;
+        bool                isUniform;
+        ProgramInputs::Type type;
+        int                 size;
+    };
+
+    std::vector<Declaration>                    declarations;
+    std::unordered_map<std::string, uint>       numReferences;
+    std::unordered_map<std::string, uint>       numDeclarations;
+
+    for (auto& source : sources)
+    {
+        auto tokens = preprocess(source);
+        auto depth = 0;
+
+        for (auto& token : tokens)
+            ++numReferences[token];
+
+        for (auto i = 0u; i < tokens.size(); ++i)
+        {
+            if (tokens[i] == "{")
+                ++depth;
+            else if (tokens[i] == "}")
+                --depth;
+
+            auto isUniform = tokens[i] == "uniform";
+
+            if (depth != 0 || (!isUniform && tokens[i] != "attribute"))
+                continue;
+
+            ++i;
+            while (i < tokens.size()
+                   && (tokens[i] == "lowp" || tokens[i] == "mediump" || tokens[i] == "highp"))
+                ++i;
+
+            if (i >= tokens.size())
+                break;
+
+            auto type = inputType(tokens[i]);
+
+            if (type == ProgramInputs::Type::unknown)
+                LOG_WARNING("unsupported input type \"" << tokens[i] << "\" will not be reported");
+
+            // One declaration can declare several inputs: "uniform vec4 a, b[2];".
+            while (++i < tokens.size() && tokens[i] != ";")
+            {
+                if (tokens[i] == ",")
+                    continue;
+
+                auto name = tokens[i];
+                auto size = 1;
+
+                if (i + 3 < tokens.size() && tokens[i + 1] == "[")
+                {
+                    size = ConditionEvaluator(Tokens(1, tokens[i + 2]), Macros()).evaluate();
+                    i += 3;
+                }
+
+                ++numDeclarations[name];
+                if (type != ProgramInputs::Type::unknown)
+                    declarations.push_back({ name, isUniform, type, size });
+            }
+        }
+    }
+
+    std::vector<ProgramInputs::UniformInput>    uniforms;
+    std::vector<ProgramInputs::AttributeInput>  attributes;
+    std::unordered_set<std::string>             reported;
+    auto                                        uniformLocation = 0;
+    auto                                        attributeLocation = 0;
+
+    for (auto& declaration : declarations)
+    {
+        // Like the GLSL linker, ignore the inputs that are declared but never referenced.
+        if (numReferences[declaration.name] <= numDeclarations[declaration.name]
+            || !reported.insert(declaration.name).second)
+            continue;
+
+        if (declaration.isUniform)
+        {
+            auto name = declaration.size > 1 ? declaration.name + "[0]" : declaration.name;
+
+            uniforms.emplace_back(name, uniformLocation, declaration.size, declaration.type);
+            uniformLocation += declaration.size;
+        }
+        else
+            attributes.emplace_back(declaration.name, attributeLocation++);
+    }
+
+    return ProgramInputs(uniforms, attributes);
+}
+
+void
+RecordingContext::setBlendingMode(Blending::Source source, Blending::Destination destination)
+{
+    write(Command::SetBlendingFactors);
+    write(static_cast<uint>(source));
+    write(static_cast<uint>(destination));
+}
+
+void
+RecordingContext::setBlendingMode(Blending::Mode blendingMode)
+{
+    write(Command::SetBlendingMode);
+    write(static_cast<uint>(blendingMode));
+}
+
+void
+RecordingContext::setDepthTest(bool depthMask, CompareMode depthFunc)
+{
+    write(Command::SetDepthTest);
+    write(depthMask);
+    write(static_cast<uint>(depthFunc));
+}
+
+void
+RecordingContext::setColorMask(bool colorMask)
+{
+    write(Command::SetColorMask);
+    write(colorMask);
+}
+
+void
+RecordingContext::setStencilTest(CompareMode        stencilFunc,
+                                 int                stencilRef,
+                                 uint               stencilMask,
+                                 StencilOperation   stencilFailOp,
+                                 StencilOperation   stencilZFailOp,
+                                 StencilOperation   stencilZPassOp)
+{
+    write(Command::SetStencilTest);
+    write(static_cast<uint>(stencilFunc));
+    write(stencilRef);
+    write(stencilMask);
+    write(static_cast<uint>(stencilFailOp));
+    write(static_cast<uint>(stencilZFailOp));
+    write(static_cast<uint>(stencilZPassOp));
+}
+
+void
+RecordingContext::setScissorTest(bool scissorTest, const math::ivec4& scissorBox)
+{
+    write(Command::SetScissorTest);
+    write(scissorTest);
+    write(scissorBox.x);
+    write(scissorBox.y);
+    write(scissorBox.z);
+    write(scissorBox.w);
+}
+
+void
+RecordingContext::readPixels(uint x, uint y, uint width, uint height, unsigned char* pixels)
+{
+    std::fill(pixels, pixels + width * height * 4, 0);
+}
+
+void
+RecordingContext::readPixels(unsigned char* pixels)
+{
+    readPixels(0, 0, _viewportWidth, _viewportHeight, pixels);
+}
+
+void
+RecordingContext::setTriangleCulling(TriangleCulling triangleCulling)
+{
+    write(Command::SetTriangleCulling);
+    write(static_cast<uint>(triangleCulling));
+}
+
+void
+RecordingContext::setRenderToBackBuffer()
+{
+    _currentTarget = 0;
+
+    write(Command::SetRenderToBackBuffer);
+}
+
+void
+RecordingContext::setRenderToTexture(uint texture, bool enableDepthAndStencil)
+{
+    _currentTarget = texture;
+
+    write(Command::SetRenderToTexture);
+    write(texture);
+    write(enableDepthAndStencil);
+}
+
+void
+RecordingContext::generateMipmaps(uint texture)
+{
+    write(Command::GenerateMipmaps);
+    write(texture);
+}
+
+void
+RecordingContext::setUniformFloat(uint location, uint count, const float* v)
+{
+    writeUniform(Command::SetUniformFloat, location, count, 1, v);
+}
+
+void
+RecordingContext::setUniformFloat2(uint location, uint count, const float* v)
+{
+    writeUniform(Command::SetUniformFloat2, location, count, 2, v);
+}
+
+void
+RecordingContext::setUniformFloat3(uint location, uint count, const float* v)
+{
+    writeUniform(Command::SetUniformFloat3, location, count, 3, v);
+}
+
+void
+RecordingContext::setUniformFloat4(uint location, uint count, const float* v)
+{
+    writeUniform(Command::SetUniformFloat4, location, count, 4, v);
+}
+
+void
+RecordingContext::setUniformMatrix4x4(uint location, uint count, const float* v)
+{
+    writeUniform(Command::SetUniformMatrix4x4, location, count, 16, v);
+}
+
+void
+RecordingContext::setUniformInt(uint location, uint count, const int* v)
+{
+    writeUniform(Command::SetUniformInt, location, count, 1, v);
+}
+
+void
+RecordingContext::setUniformInt2(uint location, uint count, const int* v)
+{
+    writeUniform(Command::SetUniformInt2, location, count, 2, v);
+}
+
+void
+RecordingContext::setUniformInt3(uint location, uint count, const int* v)
+{
+    writeUniform(Command::SetUniformInt3, location, count, 3, v);
+}
+
+void
+RecordingContext::setUniformInt4(uint location, uint count, const int* v)
+{
+    writeUniform(Command::SetUniformInt4, location, count, 4, v);
+}
+
+int
+RecordingContext::createVertexAttributeArray()
+{
+    // Vertex array objects capture the vertex buffer bindings on the driver side: reporting
+    // them as unsupported keeps every binding in the log, so it can be replayed anywhere.
+    return -1;
+}
+
+void
+RecordingContext::setVertexAttributeArray(const uint vertexArray)
+{
+}
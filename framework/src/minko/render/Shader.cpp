@@ -22,6 +22,9 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/AbstractContext.hpp"
 #include "minko/log/Logger.hpp"
 
+#include <atomic>
+#include <mutex>
+
 #ifdef MINKO_GLSL_OPTIMIZER_ENABLED
 # include "glsl_optimizer.h"
 #endif
@@ -29,17 +32,42 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 using namespace minko;
 using namespace minko::render;
 
+namespace
+{
+    std::atomic<uint> numPreprocessedSources(0);
+
 #ifdef MINKO_GLSL_OPTIMIZER_ENABLED
+    // The optimizer is not thread-safe, even with a context per thread: it compiles without the
+    // locks of its builtin functions and glsl_type keeps global tables. Optimizations are
+    // serialized, they still run on the builder threads rather than on the render thread.
+    std::mutex                  optimizerMutex;
+    glslopt_ctx*                optimizer = nullptr;
+
+    // Must be called with optimizerMutex locked.
+    glslopt_ctx*
+    getOptimizer()
+    {
+        if (optimizer == nullptr)
+        {
 # if MINKO_PLATFORM == MINKO_PLATFORM_ANDROID || MINKO_PLATFORM == MINKO_PLATFORM_IOS || MINKO_PLATFORM == MINKO_PLATFORM_HTML5
-const glslopt_ctx* Shader::_glslOptimizer = glslopt_initialize(glslopt_target::kGlslTargetOpenGLES20);
+            optimizer = glslopt_initialize(glslopt_target::kGlslTargetOpenGLES20);
 # else
-const glslopt_ctx* Shader::_glslOptimizer = glslopt_initialize(glslopt_target::kGlslTargetOpenGL);
+            optimizer = glslopt_initialize(glslopt_target::kGlslTargetOpenGL);
 # endif
+        }
+
+        return optimizer;
+    }
 #endif
+}
 
 void
 Shader::dispose()
 {
+    // shaders are not uploaded when their program is loaded from a binary
+    if (_id == -1)
+        return;
+
     if (_type == Type::VERTEX_SHADER)
         _context->deleteVertexShader(_id);
     else if (_type == Type::FRAGMENT_SHADER)
@@ -50,29 +78,60 @@ Shader::dispose()
 
 void
 Shader::upload()
+{
+    upload(contextSource());
+}
+
+void
+Shader::upload(const std::string& contextSource)
 {
     _id = _type == Type::VERTEX_SHADER ? _context->createVertexShader() : _context->createFragmentShader();
 
+    _context->setShaderSource(_id, contextSource);
+    _context->compileShader(_id);
+}
+
+uint
+Shader::numContextSources()
+{
+    return numPreprocessedSources;
+}
+
+std::string
+Shader::contextSource(Type type, const std::string& shaderSource)
+{
+    ++numPreprocessedSources;
+
 #if MINKO_PLATFORM & (MINKO_PLATFORM_ANDROID | MINKO_PLATFORM_IOS | MINKO_PLATFORM_HTML5)
-    std::string source = "#version 100\n" + _source;
+    std::string source = "#version 100\n" + shaderSource;
 #else
-    std::string source = "#version 120\n" + _source;
+    std::string source = "#version 120\n" + shaderSource;
 #endif
 
 #ifdef MINKO_GLSL_OPTIMIZER_ENABLED
-    glslopt_shader* optimizedShader = nullptr;
-
-    if (_type == Type::VERTEX_SHADER)
-        optimizedShader = glslopt_optimize(const_cast<glslopt_ctx*>(_glslOptimizer), kGlslOptShaderVertex, source.c_str(), 0);
-    else
-        optimizedShader = glslopt_optimize(const_cast<glslopt_ctx*>(_glslOptimizer), kGlslOptShaderFragment, source.c_str(), 0);
+    auto optimized = false;
+    auto log = std::string();
 
-    if (glslopt_get_status(optimizedShader))
     {
-        auto optimizedSource = glslopt_get_output(optimizedShader);
-        _context->setShaderSource(_id, optimizedSource);
+        std::lock_guard<std::mutex> lock(optimizerMutex);
+
+        auto optimizedShader = glslopt_optimize(
+            getOptimizer(),
+            type == Type::VERTEX_SHADER ? kGlslOptShaderVertex : kGlslOptShaderFragment,
+            source.c_str(),
+            0
+        );
+
+        optimized = glslopt_get_status(optimizedShader);
+        if (optimized)
+            source = glslopt_get_output(optimizedShader);
+        else
+            log = glslopt_get_log(optimizedShader);
+
+        glslopt_shader_delete(optimizedShader);
     }
-    else
+
+    if (!optimized)
     {
 #ifdef DEBUG
         auto line = std::string();
@@ -87,14 +146,10 @@ Shader::upload()
         }
 #endif
 
-        LOG_ERROR(glslopt_get_log(optimizedShader));
+        LOG_ERROR(log);
         throw std::invalid_argument("source");
     }
-    glslopt_shader_delete(optimizedShader);
-
-#else
-    _context->setShaderSource(_id, source);
 #endif
 
-    _context->compileShader(_id);
+    return source;
 }
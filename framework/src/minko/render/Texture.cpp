@@ -115,37 +115,33 @@ Texture::resize(unsigned int width, unsigned int height, bool resizeSmoothly)
     const auto previousWidth = this->width();
     const auto previousHeight = this->height();
 
-    const auto previousNumMipMaps = data().size() > TextureFormatInfo::textureSize(_format, previousWidth, previousHeight)
-        ? math::getp2(previousWidth) + 1u
+    const auto previousNumMipMaps = hasMipChain()
+        ? TextureProcessor::numMipLevels(previousWidth, previousHeight)
         : 1u;
 
     const auto numMipMaps = previousNumMipMaps > 1u
-        ? math::getp2(width) + 1u
+        ? TextureProcessor::numMipLevels(width, height)
         : 1u;
 
-    auto dataOffset = 0u;
-
     auto newData = std::vector<unsigned char>();
 
     for (auto i = 0u; i < numMipMaps; ++i)
     {
-        const auto mipMapPreviousWidth = math::max(previousWidth >> i, 1u);
-        const auto mipMapPreviousHeight = math::max(previousHeight >> i, 1u);
-        const auto mipMapWidth = width >> i;
-        const auto mipMapHeight = height >> i;
-
-        const auto mipMapDataBegin = data().begin() + dataOffset;
-        const auto mipMapDataEnd = mipMapDataBegin + TextureFormatInfo::textureSize(_format, mipMapPreviousWidth, mipMapPreviousHeight);
-        auto mipMapData = std::vector<unsigned char>(mipMapDataBegin, mipMapDataEnd);
+        // the levels added by an upscale are computed from the smallest previous level
+        const auto previousLevel = math::min(i, previousNumMipMaps - 1u);
+        const auto mipMapPreviousWidth = math::max(previousWidth >> previousLevel, 1u);
+        const auto mipMapPreviousHeight = math::max(previousHeight >> previousLevel, 1u);
+        const auto mipMapWidth = math::max(width >> i, 1u);
+        const auto mipMapHeight = math::max(height >> i, 1u);
 
-        dataOffset += mipMapData.size();
+        auto mipMapData = data().data() + TextureProcessor::mipLevelOffset(previousWidth, previousHeight, previousLevel);
 
         auto newMipMapData = std::vector<unsigned char>();
 
         resizeData(
             mipMapPreviousWidth,
             mipMapPreviousHeight,
-            mipMapData.data(),
+            mipMapData,
             mipMapWidth,
             mipMapHeight,
             resizeSmoothly,
@@ -164,6 +160,29 @@ Texture::resize(unsigned int width, unsigned int height, bool resizeSmoothly)
     _heightGPU = height;
 }
 
+void
+Texture::generateMipChain(TextureProcessor::Filter  filter,
+                          bool                      srgb)
+{
+    if (TextureFormatInfo::isCompressed(_format))
+        throw std::logic_error("mip chains cannot be generated for compressed textures");
+
+    if (_data.empty())
+        return;
+
+    auto chain = std::vector<unsigned char>();
+
+    TextureProcessor::generateMipChain(_width, _height, _data.data(), filter, srgb, chain);
+
+    _data.swap(chain);
+}
+
+bool
+Texture::hasMipChain() const
+{
+    return _data.size() > TextureFormatInfo::textureSize(_format, _width, _height);
+}
+
 void
 Texture::upload()
 {
@@ -216,7 +235,23 @@ Texture::upload()
             );
 
             if (_mipMapping)
-                _context->generateMipmaps(_id);
+            {
+                if (hasMipChain())
+                {
+                    const auto numMipLevels = TextureProcessor::numMipLevels(_widthGPU, _heightGPU);
+
+                    for (auto level = 1u; level < numMipLevels; ++level)
+                        _context->uploadTexture2dData(
+                            _id,
+                            math::max(_widthGPU >> level, 1u),
+                            math::max(_heightGPU >> level, 1u),
+                            level,
+                            &_data[TextureProcessor::mipLevelOffset(_widthGPU, _heightGPU, level)]
+                        );
+                }
+                else
+                    _context->generateMipmaps(_id);
+            }
         }
     }
 }
@@ -0,0 +1,482 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/render/TextureProcessor.hpp"
+
+#include "minko/async/ThreadPool.hpp"
+#include "minko/math/Simd.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+	typedef std::vector<float, math::AlignedAllocator<float>> FloatBuffer;
+
+	// Source pixels [first, first + count) contributing to a destination pixel, their weights
+	// starting at weights[offset].
+	struct Tap
+	{
+		uint first;
+		uint count;
+		uint offset;
+	};
+
+	struct Taps
+	{
+		std::vector<Tap>	taps;
+		std::vector<float>	weights;
+	};
+
+	const uint	SRGB_TABLE_SIZE	= 8192;
+	const float	KAISER_RADIUS	= 3.f;
+	const float	KAISER_ALPHA	= 4.f;
+	const float	PI				= 3.14159265f;
+
+	// Conversions between 8 bits values and floats. fromLinear is indexed by the linear value
+	// quantized on SRGB_TABLE_SIZE steps, enough for every sRGB value to survive a round trip.
+	struct ColorTables
+	{
+		float			toFloat[256];
+		float			toLinear[256];
+		unsigned char	fromLinear[SRGB_TABLE_SIZE];
+
+		ColorTables()
+		{
+			for (uint i = 0; i < 256; ++i)
+			{
+				const float c = i / 255.f;
+
+				toFloat[i] = c;
+				toLinear[i] = c <= .04045f ? c / 12.92f : std::pow((c + .055f) / 1.055f, 2.4f);
+			}
+
+			for (uint i = 0; i < SRGB_TABLE_SIZE; ++i)
+			{
+				const float l = i / float(SRGB_TABLE_SIZE - 1);
+				const float c = l <= .0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.f / 2.4f) - .055f;
+
+				fromLinear[i] = static_cast<unsigned char>(std::min(c * 255.f + .5f, 255.f));
+			}
+		}
+	};
+
+	const ColorTables&
+	colorTables()
+	{
+		static const ColorTables tables;
+
+		return tables;
+	}
+
+	float
+	besselI0(float x)
+	{
+		const float y = x * x * .25f;
+		float sum = 1.f;
+		float term = 1.f;
+
+		for (uint k = 1; k < 32 && term > sum * 1e-8f; ++k)
+		{
+			term *= y / float(k * k);
+			sum += term;
+		}
+
+		return sum;
+	}
+
+	float
+	kaiser(float x)
+	{
+		if (std::abs(x) >= KAISER_RADIUS)
+			return 0.f;
+
+		const float t = x / KAISER_RADIUS;
+		const float window = besselI0(KAISER_ALPHA * std::sqrt(1.f - t * t)) / besselI0(KAISER_ALPHA);
+		const float sinc = x == 0.f ? 1.f : std::sin(PI * x) / (PI * x);
+
+		return sinc * window;
+	}
+
+	void
+	computeTaps(uint size, uint newSize, TextureProcessor::Filter filter, Taps& result)
+	{
+		typedef TextureProcessor::Filter Filter;
+
+		result.taps.resize(newSize);
+		result.weights.clear();
+
+		if (filter == Filter::NEAREST || filter == Filter::LINEAR)
+		{
+			// the first and last pixels of both images are aligned
+			const float factor = newSize > 1 ? float(size - 1) / float(newSize - 1) : 0.f;
+
+			for (uint p = 0; p < newSize; ++p)
+			{
+				const float	x = p * factor;
+				const uint	i = std::min(static_cast<uint>(x), size - 1);
+				const float	dx = x - float(i);
+				auto&		tap = result.taps[p];
+
+				tap.first = i;
+				tap.offset = result.weights.size();
+
+				if (filter == Filter::LINEAR && i < size - 1 && dx > 0.f)
+				{
+					tap.count = 2;
+					result.weights.push_back(1.f - dx);
+					result.weights.push_back(dx);
+				}
+				else
+				{
+					tap.count = 1;
+					result.weights.push_back(1.f);
+				}
+			}
+
+			return;
+		}
+
+		// the filter is stretched when downsampling so that every source pixel contributes
+		const float scale = float(size) / float(newSize);
+		const float filterScale = std::max(scale, 1.f);
+		const float radius = (filter == Filter::BOX ? .5f : KAISER_RADIUS) * filterScale;
+
+		for (uint p = 0; p < newSize; ++p)
+		{
+			const float	center = (p + .5f) * scale;
+			const int	lo = static_cast<int>(std::floor(center - radius));
+			const int	hi = static_cast<int>(std::ceil(center + radius));
+			const uint	first = static_cast<uint>(std::max(lo, 0));
+			const uint	last = static_cast<uint>(std::min(hi, int(size) - 1));
+			auto&		tap = result.taps[p];
+			float		sum = 0.f;
+
+			tap.first = first;
+			tap.count = last - first + 1;
+			tap.offset = result.weights.size();
+			result.weights.resize(tap.offset + tap.count, 0.f);
+
+			for (int j = lo; j <= hi; ++j)
+			{
+				const float x = (j + .5f - center) / filterScale;
+				const float w = filter == Filter::BOX ? (x >= -.5f && x < .5f ? 1.f : 0.f) : kaiser(x);
+				// pixels out of the image are clamped to the edge
+				const uint	i = static_cast<uint>(std::min(std::max(j, 0), int(size) - 1));
+
+				result.weights[tap.offset + i - first] += w;
+				sum += w;
+			}
+
+			if (sum != 0.f)
+				for (uint t = 0; t < tap.count; ++t)
+					result.weights[tap.offset + t] /= sum;
+		}
+	}
+
+	// The 4 channels of a pixel as floats in [0, 1].
+	inline
+	math::simd::float4
+	loadPixel(const unsigned char* pixel)
+	{
+#if MINKO_SIMD == MINKO_SIMD_SSE2
+		int32_t bytes;
+
+		std::memcpy(&bytes, pixel, 4);
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i words = _mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero);
+
+		return _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(words, zero)), _mm_set1_ps(1.f / 255.f));
+#elif MINKO_SIMD == MINKO_SIMD_NEON
+		uint32_t bytes;
+
+		std::memcpy(&bytes, pixel, 4);
+
+		const uint16x8_t words = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(bytes)));
+
+		return vmulq_n_f32(vcvtq_f32_u32(vmovl_u16(vget_low_u16(words))), 1.f / 255.f);
+#else
+		const auto& tables = colorTables();
+
+		return {{ tables.toFloat[pixel[0]], tables.toFloat[pixel[1]], tables.toFloat[pixel[2]], tables.toFloat[pixel[3]] }};
+#endif
+	}
+
+	// Rounds a pixel clamped in [0, 1] to 8 bits per channel.
+	inline
+	void
+	storePixel(math::simd::float4 color, unsigned char* pixel)
+	{
+#if MINKO_SIMD == MINKO_SIMD_SSE2
+		__m128i words = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(color, _mm_set1_ps(255.f)), _mm_set1_ps(.5f)));
+
+		words = _mm_packs_epi32(words, words);
+
+		const int32_t bytes = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+
+		std::memcpy(pixel, &bytes, 4);
+#elif MINKO_SIMD == MINKO_SIMD_NEON
+		const uint16x4_t words = vmovn_u32(vcvtq_u32_f32(vmlaq_n_f32(vdupq_n_f32(.5f), color, 255.f)));
+		const uint32_t bytes = vget_lane_u32(vreinterpret_u32_u8(vmovn_u16(vcombine_u16(words, words))), 0);
+
+		std::memcpy(pixel, &bytes, 4);
+#else
+		for (uint k = 0; k < 4; ++k)
+			pixel[k] = static_cast<unsigned char>(color.v[k] * 255.f + .5f);
+#endif
+	}
+
+	void
+	decodeRow(const unsigned char* src, uint width, bool srgb, float* out)
+	{
+		if (!srgb)
+		{
+			for (uint i = 0; i < width * 4; i += 4)
+				math::simd::store(out + i, loadPixel(src + i));
+
+			return;
+		}
+
+		const auto& tables = colorTables();
+
+		for (uint i = 0; i < width * 4; i += 4)
+		{
+			out[i] = tables.toLinear[src[i]];
+			out[i + 1] = tables.toLinear[src[i + 1]];
+			out[i + 2] = tables.toLinear[src[i + 2]];
+			out[i + 3] = tables.toFloat[src[i + 3]];
+		}
+	}
+
+	void
+	filterRow(const float* src, const Taps& taps, uint newWidth, float* out)
+	{
+		for (uint p = 0; p < newWidth; ++p)
+		{
+			const auto&		tap = taps.taps[p];
+			const float*	pixel = src + tap.first * 4;
+			const float*	weight = taps.weights.data() + tap.offset;
+			auto			color = math::simd::splat(0.f);
+
+			for (uint t = 0; t < tap.count; ++t)
+				color = math::simd::madd(math::simd::splat(weight[t]), math::simd::load(pixel + t * 4), color);
+
+			math::simd::store(out + p * 4, color);
+		}
+	}
+
+	void
+	accumulateRow(const float* src, float weight, uint width, float* out)
+	{
+		const auto w = math::simd::splat(weight);
+
+		for (uint i = 0; i < width * 4; i += 4)
+			math::simd::store(out + i, math::simd::madd(w, math::simd::load(src + i), math::simd::load(out + i)));
+	}
+
+	// Clamps src in place before converting it.
+	void
+	encodeRow(float* src, uint width, bool srgb, unsigned char* out)
+	{
+		const auto	zero = math::simd::splat(0.f);
+		const auto	one = math::simd::splat(1.f);
+
+		if (!srgb)
+		{
+			for (uint i = 0; i < width * 4; i += 4)
+				storePixel(math::simd::min(math::simd::max(math::simd::load(src + i), zero), one), out + i);
+
+			return;
+		}
+
+		const auto& tables = colorTables();
+
+		for (uint i = 0; i < width * 4; i += 4)
+			math::simd::store(src + i, math::simd::min(math::simd::max(math::simd::load(src + i), zero), one));
+
+		for (uint i = 0; i < width * 4; i += 4)
+		{
+			for (uint k = 0; k < 3; ++k)
+				out[i + k] = tables.fromLinear[static_cast<uint>(src[i + k] * (SRGB_TABLE_SIZE - 1) + .5f)];
+
+			out[i + 3] = static_cast<unsigned char>(src[i + 3] * 255.f + .5f);
+		}
+	}
+}
+
+/*static*/
+void
+TextureProcessor::resize(uint							width,
+						 uint							height,
+						 const unsigned char*			data,
+						 uint							newWidth,
+						 uint							newHeight,
+						 Filter							filter,
+						 bool							srgb,
+						 std::vector<unsigned char>&	newData)
+{
+	newData.clear();
+
+	if (newWidth == 0 || newHeight == 0)
+		return;
+
+	const auto size = newWidth * newHeight * 4;
+
+	if (newWidth == width && newHeight == height)
+	{
+		newData.assign(data, data + size);
+		return;
+	}
+
+	Taps horizontalTaps;
+	Taps verticalTaps;
+
+	computeTaps(width, newWidth, filter, horizontalTaps);
+	computeTaps(height, newHeight, filter, verticalTaps);
+
+	newData.resize(size);
+
+	const auto minNumRows = std::max(1u, 65536u / newWidth);
+
+	// nearest sampling only copies pixels
+	if (filter == Filter::NEAREST)
+	{
+		async::ThreadPool::defaultPool()->parallelFor(newHeight, minNumRows, [&](uint begin, uint end)
+		{
+			for (auto q = begin; q < end; ++q)
+			{
+				const auto row = data + verticalTaps.taps[q].first * width * 4;
+
+				for (uint p = 0; p < newWidth; ++p)
+					std::memcpy(&newData[(q * newWidth + p) * 4], row + horizontalTaps.taps[p].first * 4, 4);
+			}
+		});
+
+		return;
+	}
+
+	// Each tile filters the source rows it reads horizontally, then blends them vertically.
+	// Rows read by two tiles are filtered twice, so tiles are large enough to amortize it but
+	// small enough for their rows to stay in cache.
+	async::ThreadPool::defaultPool()->parallelFor(newHeight, minNumRows, [&](uint begin, uint end)
+	{
+		FloatBuffer decoded(width * 4);
+		FloatBuffer rows;
+		FloatBuffer accumulated(newWidth * 4);
+
+		for (auto tileBegin = begin; tileBegin < end; tileBegin += minNumRows)
+		{
+			const auto	tileEnd = std::min(tileBegin + minNumRows, end);
+			auto		firstRow = verticalTaps.taps[tileBegin].first;
+			auto		lastRow = firstRow;
+
+			for (auto q = tileBegin; q < tileEnd; ++q)
+			{
+				const auto& tap = verticalTaps.taps[q];
+
+				firstRow = std::min(firstRow, tap.first);
+				lastRow = std::max(lastRow, tap.first + tap.count);
+			}
+
+			rows.resize((lastRow - firstRow) * newWidth * 4);
+
+			for (auto y = firstRow; y < lastRow; ++y)
+			{
+				decodeRow(data + y * width * 4, width, srgb, decoded.data());
+				filterRow(decoded.data(), horizontalTaps, newWidth, rows.data() + (y - firstRow) * newWidth * 4);
+			}
+
+			for (auto q = tileBegin; q < tileEnd; ++q)
+			{
+				const auto& tap = verticalTaps.taps[q];
+
+				std::fill(accumulated.begin(), accumulated.end(), 0.f);
+
+				for (uint t = 0; t < tap.count; ++t)
+					accumulateRow(
+						rows.data() + (tap.first + t - firstRow) * newWidth * 4,
+						verticalTaps.weights[tap.offset + t],
+						newWidth,
+						accumulated.data()
+					);
+
+				encodeRow(accumulated.data(), newWidth, srgb, &newData[q * newWidth * 4]);
+			}
+		}
+	});
+}
+
+/*static*/
+uint
+TextureProcessor::numMipLevels(uint width, uint height)
+{
+	return math::getp2(std::max(width, height)) + 1;
+}
+
+/*static*/
+uint
+TextureProcessor::mipLevelOffset(uint width, uint height, uint level)
+{
+	uint offset = 0;
+
+	for (uint i = 0; i < level; ++i)
+		offset += std::max(width >> i, 1u) * std::max(height >> i, 1u) * 4;
+
+	return offset;
+}
+
+/*static*/
+void
+TextureProcessor::generateMipChain(uint							width,
+								   uint							height,
+								   const unsigned char*			data,
+								   Filter						filter,
+								   bool							srgb,
+								   std::vector<unsigned char>&	chain)
+{
+	chain.clear();
+
+	if (width == 0 || height == 0)
+		return;
+
+	const auto numLevels = numMipLevels(width, height);
+
+	chain.resize(mipLevelOffset(width, height, numLevels));
+	std::memcpy(chain.data(), data, width * height * 4);
+
+	std::vector<unsigned char> level;
+
+	for (uint i = 1; i < numLevels; ++i)
+	{
+		resize(
+			std::max(width >> (i - 1), 1u),
+			std::max(height >> (i - 1), 1u),
+			chain.data() + mipLevelOffset(width, height, i - 1),
+			std::max(width >> i, 1u),
+			std::max(height >> i, 1u),
+			filter,
+			srgb,
+			level
+		);
+
+		std::memcpy(chain.data() + mipLevelOffset(width, height, i), level.data(), level.size());
+	}
+}
@@ -0,0 +1,191 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/scene/RayQuery.hpp"
+
+#include "minko/async/ThreadPool.hpp"
+#include "minko/component/Surface.hpp"
+#include "minko/component/Transform.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/math/BoundingVolumeHierarchy.hpp"
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+
+using namespace minko;
+using namespace minko::scene;
+
+RayQuery::RayQuery(std::shared_ptr<Node> root, Layout layoutMask) :
+	_root(root),
+	_layoutMask(layoutMask),
+	_hierarchy(math::BoundingVolumeHierarchy::create())
+{
+}
+
+void
+RayQuery::cast(const std::vector<math::vec3>&	origins,
+			   const std::vector<math::vec3>&	directions,
+			   std::vector<Hit>&				hits,
+			   float							maxDistance)
+{
+	const uint numRays = origins.size();
+
+	if (directions.size() != numRays)
+		throw std::invalid_argument("directions");
+
+	hits.assign(numRays, { nullptr, maxDistance, 0u });
+
+	updateSurfaces();
+
+	if (_surfaces.empty())
+		return;
+
+	async::ThreadPool::defaultPool()->parallelFor((numRays + 3) / 4, 16, [&](uint begin, uint end)
+	{
+		for (auto packetId = begin; packetId < end; ++packetId)
+		{
+			const auto first = packetId * 4;
+
+			castPacket(&origins[first], &directions[first], std::min(numRays - first, 4u), &hits[first]);
+		}
+	});
+}
+
+void
+RayQuery::updateSurfaces()
+{
+	auto nodes = NodeSet::create(_root)
+		->descendants(true)
+		->where([&](Node::Ptr node)
+		{
+			return (node->layout() & _layoutMask) != 0
+				&& (node->layout() & BuiltinLayout::IGNORE_RAYCASTING) == 0
+				&& node->hasComponent<component::Surface>();
+		});
+
+	_surfaces.clear();
+	_worldToModel.clear();
+	_minBounds.clear();
+	_maxBounds.clear();
+
+	// updating one matrix updates the matrices of the whole scene: once is enough
+	auto updateMatrices = true;
+
+	for (auto node : nodes->nodes())
+	{
+		auto transform = node->component<component::Transform>();
+		const auto modelToWorld = transform ? transform->modelToWorldMatrix(updateMatrices) : math::mat4(1.f);
+
+		updateMatrices = updateMatrices && !transform;
+
+		for (auto surface : node->components<component::Surface>())
+		{
+			auto geometry = surface->geometry();
+
+			if (!geometry || !geometry->indices() || !geometry->vertexBuffer("position"))
+				continue;
+
+			// built here rather than by the threads of the pool
+			auto minBound = math::vec3();
+			auto maxBound = math::vec3();
+
+			geometry->triangleHierarchy()->bounds(minBound, maxBound);
+
+			if (minBound.x > maxBound.x)
+				continue;
+
+			// world box of the model box
+			const auto center = math::vec3(modelToWorld * math::vec4((minBound + maxBound) * .5f, 1.f));
+			const auto halfSize = (maxBound - minBound) * .5f;
+			auto extent = math::vec3(0.f);
+
+			for (auto i = 0; i < 3; ++i)
+				extent += math::abs(math::vec3(modelToWorld[i])) * halfSize[i];
+
+			_surfaces.push_back(surface);
+			_worldToModel.push_back(math::inverse(modelToWorld));
+			_minBounds.push_back(center - extent);
+			_maxBounds.push_back(center + extent);
+		}
+	}
+
+	_hierarchy->build(_minBounds, _maxBounds, math::BoundingVolumeHierarchy::SplitMethod::SURFACE_AREA_HEURISTIC);
+}
+
+void
+RayQuery::castPacket(const math::vec3* origins, const math::vec3* directions, uint numRays, Hit* hits) const
+{
+	float distances[4];
+	uint surfaceIds[4];
+	uint triangles[4];
+
+	for (uint i = 0; i < numRays; ++i)
+		distances[i] = hits[i].distance;
+
+	auto intersectSurface = [&](uint surfaceId, uint rays, float* maxDistances) -> uint
+	{
+		const auto& worldToModel = _worldToModel[surfaceId];
+		math::vec3 localOrigins[4];
+		math::vec3 localDirections[4];
+		float localDistances[4];
+		uint localTriangles[4];
+		uint rayIds[4];
+		uint numLocalRays = 0;
+
+		// the active rays in model space: the distances along the untouched directions do
+		// not change
+		for (auto activeRays = rays; activeRays != 0u; activeRays &= activeRays - 1u)
+		{
+			const auto rayId = math::countTrailingZeros(activeRays);
+
+			localOrigins[numLocalRays] = math::vec3(worldToModel * math::vec4(origins[rayId], 1.f));
+			localDirections[numLocalRays] = math::mat3(worldToModel) * directions[rayId];
+			localDistances[numLocalRays] = maxDistances[rayId];
+			rayIds[numLocalRays++] = rayId;
+		}
+
+		const auto localHits = _surfaces[surfaceId]->geometry()->castRayPacket(
+			localOrigins, localDirections, numLocalRays, localDistances, localTriangles
+		);
+		auto hitRays = 0u;
+
+		for (auto i = 0u; i < numLocalRays; ++i)
+		{
+			if ((localHits & (1u << i)) == 0u)
+				continue;
+
+			maxDistances[rayIds[i]] = localDistances[i];
+			triangles[rayIds[i]] = localTriangles[i];
+			hitRays |= 1u << rayIds[i];
+		}
+
+		return hitRays;
+	};
+
+	const auto hitRays = _hierarchy->castRayPacket(origins, directions, numRays, distances, surfaceIds, intersectSurface);
+
+	for (auto i = 0u; i < numRays; ++i)
+	{
+		if ((hitRays & (1u << i)) == 0u)
+			continue;
+
+		hits[i].surface = _surfaces[surfaceIds[i]];
+		hits[i].distance = distances[i];
+		hits[i].triangle = triangles[i];
+	}
+}
@@ -258,9 +258,15 @@ AbstractASSIMPParser::getPostProcessingFlags(const aiScene*             scene,
         | aiProcess_ValidateDataStructure
         | aiProcess_RemoveComponent;
 
-    if (options->optimizeForRendering())
+    // large meshes are only split when they cannot be drawn with 32 bits indices
+    if (options->optimizeForRendering() && !options->context()->supportsUnsignedIntIndices())
     {
         flags |= aiProcess_SplitLargeMeshes;
+
+        _importer->SetPropertyInteger(
+            AI_CONFIG_PP_SLM_VERTEX_LIMIT,
+            static_cast<int>(std::numeric_limits<unsigned short>::max()) + 1
+        );
     }
 
     unsigned int removeComponentFlags = 0u;
@@ -620,10 +626,8 @@ AbstractASSIMPParser::createMeshGeometry(scene::Node::Ptr minkoNode, aiMesh* mes
 
     auto indices = render::IndexBuffer::Ptr();
 
-    const auto numIndices = mesh->mNumFaces * 3u;
-
-    if (_options->optimizeForRendering() ||
-        numIndices <= static_cast<unsigned int>(std::numeric_limits<unsigned short>::max()))
+    // the index type depends on the largest index, not on the number of indices
+    if (mesh->mNumVertices <= static_cast<unsigned int>(std::numeric_limits<unsigned short>::max()) + 1u)
     {
         indices = createIndexBuffer<unsigned short>(mesh, _assetLibrary->context());
     }
@@ -1172,12 +1176,18 @@ AbstractASSIMPParser::createSkin(const aiMesh* aimesh)
 	// 	skeletonRoot->addChild(n);
 	// }
 
+	if (_options->compressSkinningAnimations())
+		skin->compress();
+
 	// add skinning component to mesh
     auto skinning = Skinning::create(
         skin->reorganizeByVertices(),
         _options->skinningMethod(),
         _assetLibrary->context(),
-        skeletonRoot
+        skeletonRoot,
+        false,
+        true,
+        _options->skinningPalette()
     );
 
 	meshNode->addComponent(skinning);
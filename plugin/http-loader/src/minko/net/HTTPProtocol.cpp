@@ -235,14 +235,14 @@ HTTPProtocol::load()
     {
         auto worker = AbstractCanvas::defaultCanvas()->getWorker("http");
 
-        _workerSlots.push_back(worker->message()->connect([=](Worker::Ptr, Worker::Message message) {
+        _workerSlots.push_back(worker->message()->connect([=](Worker::Ptr, const Worker::Message& message) {
             if (message.type == "complete")
             {
-                completeHandler(&*message.data.begin(), message.data.size());
+                completeHandler(const_cast<char*>(message.data.data()), message.data.size());
             }
             else if (message.type == "progress")
             {
-                float ratio = *reinterpret_cast<float*>(&*message.data.begin());
+                auto ratio = message.get<float>();
                 progressHandler(int(ratio * 100.f), 100);
             }
             else if (message.type == "error")
@@ -95,9 +95,7 @@ namespace minko
             request.verifyPeer(verifyPeer);
 
             auto _0 = request.progress()->connect([&](float p) {
-                Message message { "progress" };
-                message.set(p);
-                post(message);
+                post(Message("progress", p));
             });
 
             auto _1 = request.error()->connect([&](int e, const std::string& errorMessage) {
@@ -105,9 +103,7 @@ namespace minko
             });
 
             auto _2 = request.complete()->connect([&](const std::vector<char>& output) {
-                Message message { "complete" };
-                message.set(output);
-                post(message);
+                post(Message("complete", output));
             });
 
             request.run();
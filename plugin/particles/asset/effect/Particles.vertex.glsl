@@ -10,6 +10,10 @@ attribute float	time;
 attribute vec3	oldPosition;
 attribute float	rotation;
 attribute float	spriteIndex;
+attribute float	angularVelocity;
+attribute vec3	velocity;
+attribute vec3	force;
+attribute vec2	birth; // birth time, lifetime
 
 uniform mat4	modelToWorldMatrix;
 uniform mat4	viewMatrix;
@@ -17,6 +21,7 @@ uniform mat4	projectionMatrix;
 uniform vec2	spritesheetSize;
 
 uniform float 	timeStep;
+uniform float	systemTime;
 uniform vec4	sizeOverTime;
 uniform	vec4	sizeBySpeed;
 
@@ -33,6 +38,14 @@ void main(void)
 	float	particleTime 		= 0.0;
 	float 	particleVelocity 	= 0.0;
 	vec3	particleColor		= vec3(1.0);
+	vec3	particlePosition	= position;
+	float	particleRotation	= 0.0;
+
+	#if defined(PARTICLE_ROTATION)
+
+		particleRotation = rotation;
+
+	#endif // defined(PARTICLE_ROTATION)
 
 
 	#if defined(PARTICLE_TIME)
@@ -47,6 +60,30 @@ void main(void)
 
 	#endif // defined(PARTICLE_OLD_POSITION)
 
+	#if defined(PARTICLE_BIRTH)
+
+		// stateless particle: everything is evaluated from the spawn parameters and the age
+		float particleAge = systemTime - birth.x;
+
+		if (particleAge < 0.0 || particleAge >= birth.y)
+		{
+			gl_Position = vec4(0.0, 0.0, 2.0, 1.0); // dead, the whole quad is clipped
+
+			return;
+		}
+
+		particleTime		= particleAge / birth.y;
+		particlePosition	= position + (velocity + 0.5 * particleAge * force) * particleAge;
+		particleVelocity	= length(velocity + particleAge * force);
+
+		#if defined(PARTICLE_ANGULAR_VELOCITY)
+
+			particleRotation += angularVelocity * particleAge;
+
+		#endif // defined(PARTICLE_ANGULAR_VELOCITY)
+
+	#endif // defined(PARTICLE_BIRTH)
+
 	#if defined(PARTICLE_COLOR)
 
 		particleColor = color;
@@ -72,7 +109,7 @@ void main(void)
 	#endif // defined(SPRITE_SHEET)
 
 
-	vec4 pos = vec4(position, 1.0);
+	vec4 pos = vec4(particlePosition, 1.0);
 
 	#if !defined(WORLDSPACE_PARTICLES) && defined(MODEL_TO_WORLD)
 
@@ -87,7 +124,7 @@ void main(void)
 
 	#if defined(PARTICLE_ROTATION)
 
-		vec4 offXY_cos_sin = vec4(particleOffset.x, particleOffset.y, cos(rotation), sin(rotation)); // less temp registers !
+		vec4 offXY_cos_sin = vec4(particleOffset.x, particleOffset.y, cos(particleRotation), sin(particleRotation)); // less temp registers !
 
 		particleOffset.xy = vec2(
 			offXY_cos_sin.z * offXY_cos_sin.x - offXY_cos_sin.w * offXY_cos_sin.y, // cos * x - sin * y
@@ -46,6 +46,7 @@ namespace minko
     namespace particle
     {
         struct ParticleData;
+        class ParticleStorage;
         enum class StartDirection;
 
         namespace modifier
@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/component/AbstractComponent.hpp"
 #include "minko/geometry/ParticlesGeometry.hpp"
 #include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStorage.hpp"
 
 namespace minko
 {
@@ -58,21 +59,6 @@ namespace minko
             typedef std::shared_ptr<particle::modifier::IParticleUpdater>        IUpdaterPtr;
             typedef std::shared_ptr<particle::modifier::IParticleModifier>        ModifierPtr;
 
-        private:
-            class ParticleDistanceToCameraComparison
-            {
-            public:
-                component::ParticleSystem*    system;
-
-                inline
-                bool
-                operator() (unsigned int p1Index, unsigned int p2Index)
-                {
-                    return system->getParticleSquaredDistanceToCamera(p1Index)
-                         > system->getParticleSquaredDistanceToCamera(p2Index);
-                };
-            };
-
         private:
             static const unsigned int                                     COUNT_LIMIT;
 
@@ -82,6 +68,7 @@ namespace minko
             SurfacePtr                                                    _surface;
 
             TransformPtr                                                _toWorld;
+            math::mat4                                                    _emitterToWorld;
 
             unsigned int                                                _countLimit;
             unsigned int                                                _maxCount;
@@ -89,7 +76,7 @@ namespace minko
             unsigned int                                                _previousLiveCount;
             std::vector<IInitializerPtr>                                 _initializers;
             std::vector<IUpdaterPtr>                                     _updaters;
-            std::vector<particle::ParticleData>                            _particles;
+            particle::ParticleStorage                                    _particles;
             std::vector<unsigned int>                                    _particleOrder;
             std::vector<float>                                            _particleDistanceToCamera;
 
@@ -97,9 +84,23 @@ namespace minko
             float                                                         _localToWorld[16];
             bool                                                        _isZSorted;
             float                                                         _cameraCoords[3];
-            ParticleDistanceToCameraComparison                            _comparisonObject;
+            std::vector<unsigned int>                                    _sortedOrder;
+            std::vector<unsigned short>                                    _sortKeys;
             bool                                                        _useOldPosition;
 
+            bool                                                        _isAsynchronous;
+            std::future<void>                                            _simulation;
+            std::vector<float>                                            _backVertices;
+            unsigned int                                                _backLiveCount;
+            bool                                                        _backChanged;
+            float                                                         _simulationLocalToWorld[16];
+            float                                                         _simulationCameraCoords[3];
+            math::mat4                                                    _simulationEmitterToWorld;
+
+            bool                                                        _isStateless;
+            float                                                        _clock;
+            unsigned int                                                _nextSlot;
+
             float                                                        _rate;
             FloatSamplerPtr                                                _lifetime;
             ShapePtr                                                    _shape;
@@ -182,6 +183,8 @@ namespace minko
             Ptr
             shape(ShapePtr value)
             {
+                waitForSimulation();
+
                 _shape = value;
 
                 return std::static_pointer_cast<ParticleSystem>(shared_from_this());
@@ -191,6 +194,8 @@ namespace minko
             Ptr
             emissionDirection(particle::StartDirection value)
             {
+                waitForSimulation();
+
                 _emissionDirection = value;
 
                 return std::static_pointer_cast<ParticleSystem>(shared_from_this());
@@ -200,6 +205,8 @@ namespace minko
             Ptr
             emissionVelocity(FloatSamplerPtr value)
             {
+                waitForSimulation();
+
                 _emissionVelocity = value;
 
                 return std::static_pointer_cast<ParticleSystem>(shared_from_this());
@@ -209,6 +216,8 @@ namespace minko
             void
             updateRate(unsigned int updatesPerSecond)
             {
+                waitForSimulation();
+
                 _updateStep = 1.0f / (float)updatesPerSecond;
             }
 
@@ -316,6 +325,34 @@ namespace minko
             Ptr
             useOldPosition(bool);
 
+            // In asynchronous mode, each frame uploads the vertices computed during the previous
+            // frame and starts simulating the next ones on a thread of the default pool, so the
+            // particle systems of a scene are updated in parallel and off the main thread. The
+            // particles are displayed one frame late.
+            Ptr
+            isAsynchronous(bool);
+
+            inline
+            bool
+            isAsynchronous() const
+            {
+                return _isAsynchronous;
+            }
+
+            // In stateless mode, the spawn parameters of each particle are written once in the
+            // vertex buffer and its position, rotation, color and size are evaluated by the vertex
+            // shader from its age. Only the analytic updaters are supported: the *OverTime and
+            // *BySpeed ones, forces and velocities over time having constant samplers.
+            Ptr
+            isStateless(bool);
+
+            inline
+            bool
+            isStateless() const
+            {
+                return _isStateless;
+            }
+
         /**
             inline
             void
@@ -357,6 +394,7 @@ namespace minko
                 return _particleDistanceToCamera[particleIndex];
             };
 
+            // Uses the camera position and the local to world matrix read when the simulation started.
             void
             updateParticleDistancesToCamera();
 
@@ -375,6 +413,8 @@ namespace minko
             void
             countLimit(unsigned int value)
             {
+                waitForSimulation();
+
                 if (value > COUNT_LIMIT)
                     throw std::length_error("A particle system can have a maximum of " + std::to_string(COUNT_LIMIT) + " particles.");
 
@@ -383,18 +423,25 @@ namespace minko
                 updateMaxParticlesCount();
             };
 
+            // The live particles are packed at the beginning of the storage.
             inline
-            std::vector<particle::ParticleData>&
+            particle::ParticleStorage&
             getParticles()
             {
                 return _particles;
             };
 
+            // Emits a particle at the end of the live range.
             void
-            createParticle(unsigned int                         particleIndex,
-                           const particle::shape::EmitterShape&    emitter,
+            createParticle(const particle::shape::EmitterShape&    emitter,
                            float                                timeLived);
 
+            // Samples the shape and the initializers, but not the lifetime.
+            void
+            initParticle(particle::ParticleData&                particle,
+                         const particle::shape::EmitterShape&    emitter,
+                         float                                    timeLived);
+
             //void
             //killParticle(unsigned int                            particleIndex);
 
@@ -416,20 +463,52 @@ namespace minko
             void
             addComponents(unsigned int components, bool blockVSInit = false);
 
-            inline
             void
-            setInVertexBuffer(float* ptr, unsigned int offset, float value)
-            {
-                unsigned int idx = offset;
-                for (unsigned int i = 0; i < 4; ++i)
-                {
-                    ptr[idx] = value;
-                    idx += _geometry->vertexSize();
-                }
-            };
+            updateVertexBuffer();
+
+            // Writes the vertices of the live particles and returns their number.
+            unsigned int
+            updateVertexData(std::vector<float>& vertices);
 
             void
-            updateVertexBuffer();
+            uploadVertexData(unsigned int liveCount);
+
+            // Back to front order of the live particles, by radix sort on their quantized distances.
+            void
+            sortParticles();
+
+            void
+            initStreams();
+
+            // Runs the updates of deltaT seconds and returns whether the particles changed.
+            bool
+            advance(float deltaT, bool emit);
+
+            void
+            simulate(float timeStep, bool emit);
+
+            void
+            startSimulation(float deltaT);
+
+            // Waits for the running simulation, then uploads its vertices when it changed them.
+            void
+            waitForSimulation();
+
+            static
+            bool
+            isAnalytic(IUpdaterPtr updater);
+
+            void
+            updateStateless(float deltaT, bool emit);
+
+            void
+            writeStatelessParticle(unsigned int                     slot,
+                                   const particle::ParticleData&    particle,
+                                   float                            birthTime);
+
+            // Gives a null lifetime to every slot and uploads the whole buffer.
+            void
+            killStatelessParticles();
 
         protected:
             ParticleSystem(AssetLibraryPtr,
@@ -0,0 +1,154 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/ParticlesCommon.hpp"
+#include "minko/math/Simd.hpp"
+
+namespace minko
+{
+    namespace particle
+    {
+        // Structure-of-arrays pool of particles: each attribute is a 16-byte aligned column and
+        // the live particles are always packed in [0, size()). Columns are padded to a multiple
+        // of 4 so that the updaters can process whole SIMD lanes up to paddedSize().
+        class ParticleStorage
+        {
+        public:
+            enum Attribute
+            {
+                X,
+                Y,
+                Z,
+                OLD_X,
+                OLD_Y,
+                OLD_Z,
+                VX,
+                VY,
+                VZ,
+                FX,
+                FY,
+                FZ,
+                R,
+                G,
+                B,
+                SIZE,
+                ROTATION,
+                ANGULAR_VELOCITY,
+                LIFETIME,
+                TIME_LIVED,
+                SPRITE_INDEX,
+                // timeLived / lifetime, as sent to the vertex buffer and to the samplers
+                TIME,
+                // scratch columns the updaters can use to sample their values
+                TEMPORARY_0,
+                TEMPORARY_1,
+                TEMPORARY_2,
+
+                NUM_ATTRIBUTES
+            };
+
+        private:
+            typedef std::vector<float, math::AlignedAllocator<float, 16>> Column;
+
+        private:
+            Column          _data;
+            unsigned int    _capacity;
+            unsigned int    _stride;
+            unsigned int    _size;
+
+        public:
+            ParticleStorage();
+
+            inline
+            unsigned int
+            size() const
+            {
+                return _size;
+            }
+
+            // Number of lanes to process with float4 operations: size() rounded up to 4.
+            inline
+            unsigned int
+            paddedSize() const
+            {
+                return (_size + 3) & ~3u;
+            }
+
+            inline
+            unsigned int
+            capacity() const
+            {
+                return _capacity;
+            }
+
+            inline
+            bool
+            full() const
+            {
+                return _size == _capacity;
+            }
+
+            inline
+            float*
+            attribute(Attribute attribute)
+            {
+                return _data.data() + attribute * _stride;
+            }
+
+            inline
+            const float*
+            attribute(Attribute attribute) const
+            {
+                return _data.data() + attribute * _stride;
+            }
+
+            // Keeps the first min(size(), capacity) particles.
+            void
+            resize(unsigned int capacity);
+
+            inline
+            void
+            clear()
+            {
+                _size = 0;
+            }
+
+            // Appends a particle at the end of the live range and returns its index.
+            unsigned int
+            add(const ParticleData& particle);
+
+            void
+            get(unsigned int index, ParticleData& particle) const;
+
+            // Moves the last particle in the slot of the removed one.
+            void
+            remove(unsigned int index);
+
+            // Removes the particles that lived their whole lifetime.
+            void
+            removeDead();
+
+            // Updates the TIME column from the LIFETIME and TIME_LIVED ones.
+            void
+            updateTimes();
+        };
+    }
+}
@@ -55,7 +55,7 @@ namespace minko
                 };
 
                 void
-                update(std::vector<ParticleData>&, float timeStep) const;
+                update(ParticleStorage&, float timeStep) const;
 
                 unsigned int
                 getNeededComponents() const;
@@ -52,7 +52,7 @@ namespace minko
                 };
 
                 void
-                update(std::vector<ParticleData>&, float) const;
+                update(ParticleStorage&, float) const;
 
                 unsigned int
                 getNeededComponents() const;
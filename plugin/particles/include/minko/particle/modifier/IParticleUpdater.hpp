@@ -34,9 +34,11 @@ namespace minko
                 typedef std::shared_ptr<IParticleUpdater> Ptr;
 
             public:
+                // Updates the live particles, packed in [0, particles.size()). Implementations
+                // can process the columns by float4 lanes up to particles.paddedSize().
                 virtual
                 void
-                update(std::vector<ParticleData>&, float timeStep) const = 0;
+                update(ParticleStorage&, float timeStep) const = 0;
             };
         }
     }
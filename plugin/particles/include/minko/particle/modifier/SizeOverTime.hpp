@@ -54,7 +54,7 @@ namespace minko
                 };
 
                 void
-                update(std::vector<ParticleData>&, float) const;
+                update(ParticleStorage&, float) const;
 
                 unsigned int
                 getNeededComponents() const;
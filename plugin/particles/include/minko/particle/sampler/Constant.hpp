@@ -69,6 +69,13 @@ namespace minko
                     value = _value;
                 };
 
+                virtual
+                void
+                values(const float* times, T* result, unsigned int count) const
+                {
+                    std::fill(result, result + count, _value);
+                };
+
                 virtual
                 T
                 min() const
@@ -130,6 +130,17 @@ namespace minko
                     target = value(time);
                 };
 
+                void
+                values(const float* times, T* result, unsigned int count) const
+                {
+                    for (unsigned int i = 0; i < count; ++i)
+                    {
+                        const float t = std::max(0.0f, std::min(1.0f, (times[i] - _startTime) * _invDeltaTime));
+
+                        result[i] = _startValue + _deltaValue * t;
+                    }
+                };
+
             protected:
                 inline
                 LinearlyInterpolatedValue(T     startValue,
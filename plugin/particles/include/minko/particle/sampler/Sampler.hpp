@@ -42,6 +42,16 @@ namespace minko
                 void
                 set(T& target, float time = 0) const = 0;
 
+                // Samples one value per time, so that updaters do a single virtual call for
+                // all the particles.
+                virtual
+                void
+                values(const float* times, T* result, unsigned int count) const
+                {
+                    for (unsigned int i = 0; i < count; ++i)
+                        result[i] = value(times[i]);
+                }
+
                 virtual
                 T
                 max() const = 0;
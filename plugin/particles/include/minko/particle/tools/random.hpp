@@ -21,6 +21,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 
 #include <random>
 #include <chrono>
+#include <thread>
 
 namespace minko
 {
@@ -28,12 +29,17 @@ namespace minko
     {
         namespace tools
         {
+            // Asynchronous particle systems call it from the threads of the pool: each thread has
+            // its own generator, seeded with its id so that they do not produce the same sequence.
             inline
             float
             rand01()
             {
-                static std::default_random_engine                generator((unsigned int)std::chrono::system_clock::now().time_since_epoch().count());
-                static std::uniform_real_distribution<float>    distribution (0.0f, 1.0f);
+                thread_local std::default_random_engine            generator((unsigned int)(
+                    std::chrono::system_clock::now().time_since_epoch().count()
+                    ^ std::hash<std::thread::id>()(std::this_thread::get_id())
+                ));
+                thread_local std::uniform_real_distribution<float> distribution (0.0f, 1.0f);
 
                 return distribution(generator);
             }
@@ -30,12 +30,20 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/CompareMode.hpp"
 #include "minko/render/ParticleVertexBuffer.hpp"
 #include "minko/render/ParticleIndexBuffer.hpp"
-#include "minko/math/Matrix4x4.hpp"
+#include "minko/math/Simd.hpp"
+#include "minko/async/ThreadPool.hpp"
 #include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStorage.hpp"
 #include "minko/particle/StartDirection.hpp"
 #include "minko/particle/modifier/IParticleModifier.hpp"
 #include "minko/particle/modifier/IParticleInitializer.hpp"
 #include "minko/particle/modifier/IParticleUpdater.hpp"
+#include "minko/particle/modifier/ColorBySpeed.hpp"
+#include "minko/particle/modifier/ColorOverTime.hpp"
+#include "minko/particle/modifier/ForceOverTime.hpp"
+#include "minko/particle/modifier/SizeBySpeed.hpp"
+#include "minko/particle/modifier/SizeOverTime.hpp"
+#include "minko/particle/modifier/VelocityOverTime.hpp"
 #include "minko/particle/shape/Sphere.hpp"
 #include "minko/particle/sampler/Sampler.hpp"
 #include "minko/particle/sampler/Constant.hpp"
@@ -58,6 +66,7 @@ ParticleSystem::ParticleSystem(AssetLibraryPtr        assets,
     _effect                (assets->effect("particles")),
     _surface            (nullptr),
     _toWorld            (nullptr),
+    _emitterToWorld        (1.f),
     _countLimit            (COUNT_LIMIT),
     _maxCount            (0),
     _previousLiveCount    (0),
@@ -65,6 +74,13 @@ ParticleSystem::ParticleSystem(AssetLibraryPtr        assets,
     _isInWorldSpace        (false),
     _isZSorted            (false),
     _useOldPosition        (false),
+    _isAsynchronous        (false),
+    _backLiveCount        (0),
+    _backChanged        (false),
+    _simulationEmitterToWorld(1.f),
+    _isStateless        (false),
+    _clock                (0.0f),
+    _nextSlot            (0),
     _rate                (1.0f / rate),
     _lifetime            (lifetime            ? lifetime            : sampler::Constant<float>::create(1.0f)),
     _shape                (shape                ? shape                : shape::Sphere::create(10)),
@@ -87,8 +103,6 @@ ParticleSystem::ParticleSystem(AssetLibraryPtr        assets,
         _effect
     );
 
-    _comparisonObject.system = (this);
-
     updateMaxParticlesCount();
 }
 
@@ -174,35 +188,117 @@ ParticleSystem::frameBeginHandler(SceneManager::Ptr sceneManager, float time, fl
         return;
 
     if (_isInWorldSpace)
+    {
         _toWorld = targets()[0]->components<Transform>()[0];
+        _emitterToWorld = _toWorld->matrix();
+    }
 
     const float deltaT = 1e-3f * deltaTime; // expects seconds
 
-    if (_updateStep == 0)
+    _material->set<float>("particles.timeStep", _updateStep == 0 ? deltaT : _updateStep);
+
+    if (_isStateless)
+    {
+        _simulationEmitterToWorld = _emitterToWorld;
+        updateStateless(deltaT, _emitting);
+
+        return;
+    }
+
+    if (_isAsynchronous)
     {
-        updateSystem(deltaT, _emitting);
+        startSimulation(deltaT);
+
+        return;
+    }
+
+    std::copy(_localToWorld, _localToWorld + 16, _simulationLocalToWorld);
+    std::copy(_cameraCoords, _cameraCoords + 3, _simulationCameraCoords);
+    _simulationEmitterToWorld = _emitterToWorld;
+
+    if (advance(deltaT, _emitting))
         updateVertexBuffer();
+}
+
+bool
+ParticleSystem::advance(float deltaT, bool emit)
+{
+    if (_updateStep == 0)
+    {
+        simulate(deltaT, emit);
+
+        return true;
     }
-    else
+
+    bool changed = false;
+
+    _time += deltaT;
+
+    while (_time > _updateStep)
     {
-        bool changed = false;
+        simulate(_updateStep, emit);
+        changed = true;
+        _time -= _updateStep;
+    }
 
-        _time += deltaT;
+    return changed;
+}
 
-        while (_time > _updateStep)
-        {
-            updateSystem(_updateStep, _emitting);
-            changed = true;
-            _time -= _updateStep;
-        }
-        if (changed)
-            updateVertexBuffer();
+void
+ParticleSystem::startSimulation(float deltaT)
+{
+    waitForSimulation();
+
+    // everything the simulation reads from the main thread is copied before it starts
+    std::copy(_localToWorld, _localToWorld + 16, _simulationLocalToWorld);
+    std::copy(_cameraCoords, _cameraCoords + 3, _simulationCameraCoords);
+    _simulationEmitterToWorld = _emitterToWorld;
+
+    auto self = std::static_pointer_cast<ParticleSystem>(shared_from_this());
+    auto emit = _emitting;
+
+    if (_backVertices.size() != _geometry->particleVertices()->data().size())
+        _backVertices = _geometry->particleVertices()->data();
+
+    _simulation = async::ThreadPool::defaultPool()->enqueue([self, deltaT, emit]()
+    {
+        self->_backChanged = self->advance(deltaT, emit);
+
+        if (self->_backChanged)
+            self->_backLiveCount = self->updateVertexData(self->_backVertices);
+    });
+}
+
+void
+ParticleSystem::waitForSimulation()
+{
+    if (!_simulation.valid())
+        return;
+
+    _simulation.get();
+
+    // the vertices of the finished simulation become the front ones
+    if (_backChanged)
+    {
+        _geometry->particleVertices()->data().swap(_backVertices);
+        uploadVertexData(_backLiveCount);
+        _backChanged = false;
     }
 }
 
 ParticleSystem::Ptr
 ParticleSystem::add(ModifierPtr    modifier)
 {
+    waitForSimulation();
+
+    if (_isStateless)
+    {
+        auto updater = std::dynamic_pointer_cast<modifier::IParticleUpdater>(modifier);
+
+        if (updater && !isAnalytic(updater))
+            throw std::logic_error("Only analytic updaters can be added to a stateless particle system.");
+    }
+
     addComponents(modifier->getNeededComponents());
 
     modifier->setProperties(_material);
@@ -227,6 +323,8 @@ ParticleSystem::add(ModifierPtr    modifier)
 ParticleSystem::Ptr
 ParticleSystem::remove(ModifierPtr    modifier)
 {
+    waitForSimulation();
+
     IInitializerPtr i = std::dynamic_pointer_cast<modifier::IParticleInitializer> (modifier);
 
     if (i != 0)
@@ -307,11 +405,23 @@ ParticleSystem::has(ModifierPtr modifier) const
 void
 ParticleSystem::fastForward(float time, unsigned int updatesPerSecond)
 {
+    waitForSimulation();
+
+    _simulationEmitterToWorld = _emitterToWorld;
+
     float updateStep = _updateStep;
 
     if (updatesPerSecond != 0)
         updateStep = 1.f / updatesPerSecond;
 
+    if (_isStateless)
+    {
+        // the birth times of the particles do not depend on the update step
+        updateStateless(time, _emitting);
+
+        return;
+    }
+
     while(time > updateStep)
     {
         updateSystem(updateStep, _emitting);
@@ -322,64 +432,103 @@ ParticleSystem::fastForward(float time, unsigned int updatesPerSecond)
 void
 ParticleSystem::updateSystem(float timeStep, bool emit)
 {
+    waitForSimulation();
+
     _material->set<float>("particles.timeStep", timeStep);
 
+    if (_isStateless)
+        updateStateless(timeStep, emit);
+    else
+        simulate(timeStep, emit);
+}
+
+void
+ParticleSystem::simulate(float timeStep, bool emit)
+{
     if (emit && _createTimer < _rate)
         _createTimer += timeStep;
 
-    for (unsigned particleIndex = 0; particleIndex < _particles.size(); ++particleIndex)
-    {
-        ParticleData& particle = _particles[particleIndex];
+    const auto step = math::simd::splat(timeStep);
 
-        if (particle.alive())
+    {
+        float* x            = _particles.attribute(ParticleStorage::X);
+        float* y            = _particles.attribute(ParticleStorage::Y);
+        float* z            = _particles.attribute(ParticleStorage::Z);
+        float* oldx         = _particles.attribute(ParticleStorage::OLD_X);
+        float* oldy         = _particles.attribute(ParticleStorage::OLD_Y);
+        float* oldz         = _particles.attribute(ParticleStorage::OLD_Z);
+        float* timesLived   = _particles.attribute(ParticleStorage::TIME_LIVED);
+
+        for (unsigned int i = 0; i < _particles.paddedSize(); i += 4)
         {
-            particle.timeLived  += timeStep;
-
-            particle.oldx       = particle.x;
-            particle.oldy       = particle.y;
-            particle.oldz       = particle.z;
-
-            //if (part)
-            //if (!(particle.timeLived < particle.lifetime))
-            //    killParticle(particleIndex);
+            math::simd::store(timesLived + i, math::simd::add(math::simd::load(timesLived + i), step));
+            math::simd::store(oldx + i, math::simd::load(x + i));
+            math::simd::store(oldy + i, math::simd::load(y + i));
+            math::simd::store(oldz + i, math::simd::load(z + i));
         }
     }
 
+    _particles.removeDead();
+    _particles.updateTimes();
+
     for (auto& updater : _updaters)
         updater->update(_particles, timeStep);
 
-    for (unsigned particleIndex = 0; particleIndex < _particles.size(); ++particleIndex)
+    while (emit && !(_createTimer < _rate) && !_particles.full())
     {
-        ParticleData& particle = _particles[particleIndex];
+        _createTimer -= _rate;
 
-        if (!particle.alive() && emit && !(_createTimer < _rate))
-        {
-            _createTimer -= _rate;
+        createParticle(*_shape, _createTimer);
+    }
 
-            createParticle(particleIndex, *_shape, _createTimer);
+    // the particles emitted during this step are integrated as well
+    float* x                = _particles.attribute(ParticleStorage::X);
+    float* y                = _particles.attribute(ParticleStorage::Y);
+    float* z                = _particles.attribute(ParticleStorage::Z);
+    float* vx               = _particles.attribute(ParticleStorage::VX);
+    float* vy               = _particles.attribute(ParticleStorage::VY);
+    float* vz               = _particles.attribute(ParticleStorage::VZ);
+    const float* fx         = _particles.attribute(ParticleStorage::FX);
+    const float* fy         = _particles.attribute(ParticleStorage::FY);
+    const float* fz         = _particles.attribute(ParticleStorage::FZ);
+    float* rotations        = _particles.attribute(ParticleStorage::ROTATION);
+    const float* velocities = _particles.attribute(ParticleStorage::ANGULAR_VELOCITY);
+
+    for (unsigned int i = 0; i < _particles.paddedSize(); i += 4)
+    {
+        math::simd::store(rotations + i, math::simd::madd(math::simd::load(velocities + i), step, math::simd::load(rotations + i)));
+
+        const auto newvx = math::simd::madd(math::simd::load(fx + i), step, math::simd::load(vx + i));
+        const auto newvy = math::simd::madd(math::simd::load(fy + i), step, math::simd::load(vy + i));
+        const auto newvz = math::simd::madd(math::simd::load(fz + i), step, math::simd::load(vz + i));
+
+        math::simd::store(vx + i, newvx);
+        math::simd::store(vy + i, newvy);
+        math::simd::store(vz + i, newvz);
+        math::simd::store(x + i, math::simd::madd(newvx, step, math::simd::load(x + i)));
+        math::simd::store(y + i, math::simd::madd(newvy, step, math::simd::load(y + i)));
+        math::simd::store(z + i, math::simd::madd(newvz, step, math::simd::load(z + i)));
+    }
+}
 
-            particle.lifetime = _lifetime->value();
-        }
+void
+ParticleSystem::createParticle(const shape::EmitterShape&    shape,
+                               float                        timeLived)
+{
+    ParticleData particle;
 
-        particle.rotation   += particle.startAngularVelocity * timeStep;
+    initParticle(particle, shape, timeLived);
 
-        particle.startvx    += particle.startfx * timeStep;
-        particle.startvy    += particle.startfy * timeStep;
-        particle.startvz    += particle.startfz * timeStep;
+    particle.lifetime                 = _lifetime->value();
 
-        particle.x          += particle.startvx * timeStep;
-        particle.y          += particle.startvy * timeStep;
-        particle.z          += particle.startvz * timeStep;
-    }
+    _particles.add(particle);
 }
 
 void
-ParticleSystem::createParticle(unsigned int                 particleIndex,
-                               const shape::EmitterShape&    shape,
-                               float                        timeLived)
+ParticleSystem::initParticle(ParticleData&                particle,
+                             const shape::EmitterShape&    shape,
+                             float                        timeLived)
 {
-    ParticleData& particle = _particles[particleIndex];
-
     if (_emissionDirection == StartDirection::NONE)
     {
         shape.initPosition(particle);
@@ -419,15 +568,15 @@ ParticleSystem::createParticle(unsigned int                 particleIndex,
 
     if (_isInWorldSpace)
     {
-        const std::vector<float>& transform = _toWorld->matrix()->data();
+        const math::mat4& transform = _simulationEmitterToWorld;
 
         const float x = particle.x;
         const float y = particle.y;
         const float z = particle.z;
 
-        particle.x = transform[0] * x + transform[1] * y + transform[2] * z + transform[3];
-        particle.y = transform[4] * x + transform[5] * y + transform[6] * z + transform[7];
-        particle.z = transform[8] * x + transform[9] * y + transform[10] * z + transform[11];
+        particle.x = transform[0][0] * x + transform[1][0] * y + transform[2][0] * z + transform[3][0];
+        particle.y = transform[0][1] * x + transform[1][1] * y + transform[2][1] * z + transform[3][1];
+        particle.z = transform[0][2] * x + transform[1][2] * y + transform[2][2] * z + transform[3][2];
 
         if (_emissionDirection != StartDirection::NONE)
         {
@@ -435,9 +584,9 @@ ParticleSystem::createParticle(unsigned int                 particleIndex,
             const float vy = particle.startvy;
             const float vz = particle.startvz;
 
-            particle.startvx = transform[0] * vx + transform[1] * vy + transform[2] * vz;
-            particle.startvy = transform[4] * vx + transform[5] * vy + transform[6] * vz;
-            particle.startvz = transform[8] * vx + transform[9] * vy + transform[10] * vz;
+            particle.startvx = transform[0][0] * vx + transform[1][0] * vy + transform[2][0] * vz;
+            particle.startvy = transform[0][1] * vx + transform[1][1] * vy + transform[2][1] * vz;
+            particle.startvz = transform[0][2] * vx + transform[1][2] * vy + transform[2][2] * vz;
         }
     }
 
@@ -460,25 +609,15 @@ ParticleSystem::createParticle(unsigned int                 particleIndex,
 
     particle.timeLived                = timeLived;
 
-//    particle.alive                     = true;
-
-//    ++_liveCount;
-
     for (auto& initializer : _initializers)
         initializer->initialize(particle, timeLived);
 }
 
-//void
-//ParticleSystem::killParticle(unsigned int particleIndex)
-//{
-//    _particles[particleIndex].alive = false;
-
-    //--_liveCount;
-//}
-
 void
 ParticleSystem::updateMaxParticlesCount()
 {
+    waitForSimulation();
+
     auto value = std::min(_countLimit, (unsigned int)(ceilf(_lifetime->max()/_rate - 1e-3f)));
 
     if (_maxCount == value)
@@ -486,50 +625,27 @@ ParticleSystem::updateMaxParticlesCount()
 
     _maxCount = value;
 
-    uint liveCount = 0;
-    for (auto& particle : _particles)
-        if (particle.alive())
-        {
-            if (liveCount == _maxCount || !( particle.timeLived < _lifetime->max()) )
-                particle.kill();
-            else
-            {
-                if (particle.lifetime < _lifetime->min() || particle.lifetime > _lifetime->max())
-                    particle.lifetime = _lifetime->value();
+    // the particles that do not fit anymore are dropped by the resize
+    resizeParticlesVector();
 
-                if (particle.alive())
-                    ++liveCount;
-            }
+    const float*    timesLived  = _particles.attribute(ParticleStorage::TIME_LIVED);
+    float*          lifetimes   = _particles.attribute(ParticleStorage::LIFETIME);
+
+    for (unsigned int i = 0; i < _particles.size();)
+    {
+        if (!(timesLived[i] < _lifetime->max()))
+        {
+            _particles.remove(i);
+            continue;
         }
 
+        if (lifetimes[i] < _lifetime->min() || lifetimes[i] > _lifetime->max())
+            lifetimes[i] = _lifetime->value();
+        ++i;
+    }
 
- //   //std::cout << "lifetime in [" << _lifetime->min() << " " << _lifetime->max() << "]" << std::endl;
-
-    //for (unsigned int i = 0; i < _particles.size(); ++i)
-    //{
-    //    if (_particles[i].alive())
-    //    {
-    //        if (liveCount == _maxCount ||
-    //            !(_particles[i].timeLived < _lifetime->max()))
-    //            _particles[i].kill();
-    //            //!(_particles[i].timeLived < _lifetime->max()))
-    //            //;//                _particles[i].alive = false;
-    //        else
-    //        {
-    //            //++_liveCount;
-    //            if (_particles[i].lifetime > _lifetime->max() || _particles[i].lifetime < _lifetime->min())
-    //                _particles[i].lifetime = _lifetime->value();
-
-    //            liveCount += _particles[i].alive() ? 1 : 0;
-    //            //if (!(_particles[i].timeLived < _particles[i].lifetime))
-    //                //;// _particles[i].alive = false;
- //               //else
- //                   //++_liveCount;
-    //        }
-    //    }
-    //}
-    resizeParticlesVector();
-    _geometry->initStreams(_maxCount);
+    _particles.updateTimes();
+    initStreams();
 }
 
 void
@@ -540,55 +656,127 @@ ParticleSystem::resizeParticlesVector()
     {
         _particleDistanceToCamera.resize(_maxCount);
         _particleOrder.resize(_maxCount);
-        for (unsigned int i = 0; i < _particleOrder.size(); ++i)
-            _particleOrder[i] = i;
+        _sortedOrder.resize(_maxCount);
+        _sortKeys.resize(_maxCount);
     }
     else
     {
         _particleDistanceToCamera.resize(0);
         _particleOrder.resize(0);
+        _sortedOrder.resize(0);
+        _sortKeys.resize(0);
     }
 }
 
+void
+ParticleSystem::initStreams()
+{
+    _geometry->initStreams(_maxCount);
+
+    if (_isStateless)
+        killStatelessParticles();
+    else if (_isAsynchronous)
+        _backVertices = _geometry->particleVertices()->data();
+}
+
 void
 ParticleSystem::updateParticleDistancesToCamera()
 {
-    for (unsigned int i = 0; i < _particleDistanceToCamera.size(); ++i)
-    {
-        const ParticleData& particle = _particles[i];
+    const float* xs = _particles.attribute(ParticleStorage::X);
+    const float* ys = _particles.attribute(ParticleStorage::Y);
+    const float* zs = _particles.attribute(ParticleStorage::Z);
 
-        float x = particle.x;
-        float y = particle.y;
-        float z = particle.z;
+    for (unsigned int i = 0; i < _particles.size(); ++i)
+    {
+        float x = xs[i];
+        float y = ys[i];
+        float z = zs[i];
 
         if (!_isInWorldSpace)
         {
-            x = _localToWorld[0] * x + _localToWorld[4] * y + _localToWorld[8] * z + _localToWorld[12];
-            y = _localToWorld[1] * x + _localToWorld[5] * y + _localToWorld[9] * z + _localToWorld[13];
-            z = _localToWorld[2] * x + _localToWorld[6] * y + _localToWorld[10] * z + _localToWorld[14];
+            x = _simulationLocalToWorld[0] * xs[i] + _simulationLocalToWorld[4] * ys[i] + _simulationLocalToWorld[8] * zs[i] + _simulationLocalToWorld[12];
+            y = _simulationLocalToWorld[1] * xs[i] + _simulationLocalToWorld[5] * ys[i] + _simulationLocalToWorld[9] * zs[i] + _simulationLocalToWorld[13];
+            z = _simulationLocalToWorld[2] * xs[i] + _simulationLocalToWorld[6] * ys[i] + _simulationLocalToWorld[10] * zs[i] + _simulationLocalToWorld[14];
         }
 
-        float deltaX = _cameraCoords[0] - x;
-        float deltaY = _cameraCoords[1] - y;
-        float deltaZ = _cameraCoords[2] - z;
+        float deltaX = _simulationCameraCoords[0] - x;
+        float deltaY = _simulationCameraCoords[1] - y;
+        float deltaZ = _simulationCameraCoords[2] - z;
 
         _particleDistanceToCamera[i] = deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ;
     }
 }
 
 void
-ParticleSystem::reset()
+ParticleSystem::sortParticles()
 {
-    for (auto& particle : _particles)
-        particle.kill();
+    const unsigned int liveCount = _particles.size();
+
+    if (liveCount == 0)
+        return;
+
+    updateParticleDistancesToCamera();
 
-    //if (_liveCount == 0)
-    //    return;
+    auto minDistance = std::numeric_limits<float>::max();
+    auto maxDistance = 0.f;
 
-    //_liveCount = 0;
+    for (unsigned int i = 0; i < liveCount; ++i)
+    {
+        const float distance = sqrtf(_particleDistanceToCamera[i]);
 
-//    for (auto& particle : _particles)
-//        particle.alive = false;
+        minDistance = std::min(minDistance, distance);
+        maxDistance = std::max(maxDistance, distance);
+    }
+
+    // 16-bit keys, the farthest particle getting 0 so that it is drawn first
+    const float scale = maxDistance > minDistance ? 65535.f / (maxDistance - minDistance) : 0.f;
+
+    for (unsigned int i = 0; i < liveCount; ++i)
+        _sortKeys[i] = (unsigned short)((maxDistance - sqrtf(_particleDistanceToCamera[i])) * scale);
+
+    // least significant byte first, both passes are stable
+    std::array<unsigned int, 256> offsets;
+
+    offsets.fill(0);
+    for (unsigned int i = 0; i < liveCount; ++i)
+        ++offsets[_sortKeys[i] & 0xff];
+    for (unsigned int i = 0, offset = 0; i < 256; ++i)
+    {
+        const unsigned int count = offsets[i];
+
+        offsets[i] = offset;
+        offset += count;
+    }
+    for (unsigned int i = 0; i < liveCount; ++i)
+        _sortedOrder[offsets[_sortKeys[i] & 0xff]++] = i;
+
+    offsets.fill(0);
+    for (unsigned int i = 0; i < liveCount; ++i)
+        ++offsets[_sortKeys[i] >> 8];
+    for (unsigned int i = 0, offset = 0; i < 256; ++i)
+    {
+        const unsigned int count = offsets[i];
+
+        offsets[i] = offset;
+        offset += count;
+    }
+    for (unsigned int i = 0; i < liveCount; ++i)
+    {
+        const unsigned int index = _sortedOrder[i];
+
+        _particleOrder[offsets[_sortKeys[index] >> 8]++] = index;
+    }
+}
+
+void
+ParticleSystem::reset()
+{
+    waitForSimulation();
+
+    _particles.clear();
+
+    if (_isStateless)
+        killStatelessParticles();
 }
 
 
@@ -596,21 +784,37 @@ void
 ParticleSystem::addComponents(unsigned int components, bool blockVSInit)
 {
     typedef std::tuple<std::string, VertexComponentFlags, unsigned int> ComponentInfo;
-    static const std::array<ComponentInfo, 6> OPTIONAL_COMPONENTS =
+    static const std::array<ComponentInfo, 10> OPTIONAL_COMPONENTS =
     {
         std::make_tuple("size",          VertexComponentFlags::SIZE,            1),
         std::make_tuple("color",         VertexComponentFlags::COLOR,           3),
         std::make_tuple("time",          VertexComponentFlags::TIME,            1),
         std::make_tuple("oldPosition",   VertexComponentFlags::OLD_POSITION,    3),
         std::make_tuple("rotation",      VertexComponentFlags::ROTATION,        1),
-        std::make_tuple("spriteIndex",   VertexComponentFlags::SPRITE_INDEX,    1)
+        std::make_tuple("spriteIndex",   VertexComponentFlags::SPRITE_INDEX,    1),
+        std::make_tuple("angularVelocity", VertexComponentFlags::ANG_VELOCITY,  1),
+        std::make_tuple("velocity",      VertexComponentFlags::STATELESS,       3),
+        std::make_tuple("force",         VertexComponentFlags::STATELESS,       3),
+        std::make_tuple("birth",         VertexComponentFlags::STATELESS,       2)
     };
 
     if (_format == components)
         return;
 
+    waitForSimulation();
+
     _format |= components;
 
+    if (_isStateless)
+    {
+        // the normalized time and the speed are computed from the age in the vertex shader
+        _format |= VertexComponentFlags::STATELESS;
+        _format &= ~(VertexComponentFlags::TIME | VertexComponentFlags::OLD_POSITION);
+
+        if (_format & VertexComponentFlags::ROTATION)
+            _format |= VertexComponentFlags::ANG_VELOCITY;
+    }
+
     // FIXME: should be made fully dynamic
     auto vertexBuffer = _geometry->particleVertices();
 
@@ -643,12 +847,14 @@ ParticleSystem::addComponents(unsigned int components, bool blockVSInit)
     _geometry->addVertexBuffer(vertexBuffer);
 
     if (!blockVSInit)
-        _geometry->initStreams(_maxCount);
+        initStreams();
 }
 
 unsigned int
 ParticleSystem::updateVertexFormat()
 {
+    waitForSimulation();
+
     _format = VertexComponentFlags::DEFAULT;
 
     /*
@@ -676,7 +882,10 @@ ParticleSystem::updateVertexFormat()
     if (_useOldPosition)
         addComponents(VertexComponentFlags::OLD_POSITION, true);
 
-    _geometry->initStreams(_maxCount);
+    if (_isStateless)
+        addComponents(VertexComponentFlags::STATELESS, true);
+
+    initStreams();
 
     return _format;
 }
@@ -684,69 +893,123 @@ ParticleSystem::updateVertexFormat()
 void
 ParticleSystem::updateVertexBuffer()
 {
-    //if (_liveCount == 0)
-    //    return;
+    // stateless particles are written when they are spawned
+    if (_isStateless)
+        return;
+
+    uploadVertexData(updateVertexData(_geometry->particleVertices()->data()));
+}
+
+unsigned int
+ParticleSystem::updateVertexData(std::vector<float>& vertices)
+{
+    const unsigned int liveCount = _particles.size();
 
     if (_isZSorted)
+        sortParticles();
+
+    // columns copied after the offset of each vertex, in the order of the vertex attributes
+    std::array<const float*, 16>    columns;
+    unsigned int                    numColumns  = 0;
+
+    columns[numColumns++] = _particles.attribute(ParticleStorage::X);
+    columns[numColumns++] = _particles.attribute(ParticleStorage::Y);
+    columns[numColumns++] = _particles.attribute(ParticleStorage::Z);
+
+    if (_format & VertexComponentFlags::SIZE)
+        columns[numColumns++] = _particles.attribute(ParticleStorage::SIZE);
+
+    if (_format & VertexComponentFlags::COLOR)
     {
-        updateParticleDistancesToCamera();
-        std::sort(_particleOrder.begin(), _particleOrder.end(), _comparisonObject);
+        columns[numColumns++] = _particles.attribute(ParticleStorage::R);
+        columns[numColumns++] = _particles.attribute(ParticleStorage::G);
+        columns[numColumns++] = _particles.attribute(ParticleStorage::B);
     }
 
-    std::vector<float>&    vsData            = _geometry->particleVertices()->data();
-    float*                vertexIterator    = &(*vsData.begin());
+    if (_format & VertexComponentFlags::TIME)
+        columns[numColumns++] = _particles.attribute(ParticleStorage::TIME);
 
-    unsigned int liveCount = 0;
-
-    for (unsigned int particleIndex = 0; particleIndex < _maxCount; ++particleIndex)
+    if (_format & VertexComponentFlags::OLD_POSITION)
     {
-        ParticleData* particle;
+        columns[numColumns++] = _particles.attribute(ParticleStorage::OLD_X);
+        columns[numColumns++] = _particles.attribute(ParticleStorage::OLD_Y);
+        columns[numColumns++] = _particles.attribute(ParticleStorage::OLD_Z);
+    }
 
-        if (_isZSorted)
-            particle = &_particles[_particleOrder[particleIndex]];
-        else
-            particle = &_particles[particleIndex];
+    if (_format & VertexComponentFlags::ROTATION)
+        columns[numColumns++] = _particles.attribute(ParticleStorage::ROTATION);
 
-        unsigned int i = 5;
+    if (_format & VertexComponentFlags::SPRITE_INDEX)
+        columns[numColumns++] = _particles.attribute(ParticleStorage::SPRITE_INDEX);
 
-        if (particle->alive())
-        {
-            setInVertexBuffer(vertexIterator, 2, particle->x);
-            setInVertexBuffer(vertexIterator, 3, particle->y);
-            setInVertexBuffer(vertexIterator, 4, particle->z);
+    const unsigned int  vertexSize      = _geometry->vertexSize();
+    const unsigned int  numGroups       = (numColumns + 3) >> 2;
+    float*              vertexIterator  = vertices.data() + 2;
+
+    // the last group of 4 columns is completed with the last column, whose copies are not stored
+    for (unsigned int i = numColumns; i < numGroups << 2; ++i)
+        columns[i] = columns[numColumns - 1];
 
-            if (_format & VertexComponentFlags::SIZE)
-                setInVertexBuffer(vertexIterator, i++, particle->size);
+    // 4 particles at a time: each group of 4 columns is loaded, transposed into the rows of the
+    // particles, and each row is stored in the 4 vertices of its particle
+    for (unsigned int firstParticle = 0; firstParticle < liveCount; firstParticle += 4)
+    {
+        const unsigned int numParticles = std::min(4u, liveCount - firstParticle);
+
+        for (unsigned int group = 0; group < numGroups; ++group)
+        {
+            const float* const*     groupColumns    = &columns[group << 2];
+            const unsigned int      numValues       = std::min(4u, numColumns - (group << 2));
+            math::simd::float4      rows[4];
 
-            if (_format & VertexComponentFlags::COLOR)
+            if (_isZSorted)
             {
-                setInVertexBuffer(vertexIterator, i++, particle->r);
-                setInVertexBuffer(vertexIterator, i++, particle->g);
-                setInVertexBuffer(vertexIterator, i++, particle->b);
-            }
+                alignas(16) float lanes[4][4];
 
-            if (_format & VertexComponentFlags::TIME)
-                setInVertexBuffer(vertexIterator, i++, particle->timeLived / particle->lifetime);
+                for (unsigned int i = 0; i < 4; ++i)
+                    for (unsigned int j = 0; j < 4; ++j)
+                        lanes[i][j] = groupColumns[i][_particleOrder[firstParticle + std::min(j, numParticles - 1)]];
 
-            if (_format & VertexComponentFlags::OLD_POSITION)
+                for (unsigned int i = 0; i < 4; ++i)
+                    rows[i] = math::simd::load(lanes[i]);
+            }
+            else
             {
-                setInVertexBuffer(vertexIterator, i++, particle->oldx);
-                setInVertexBuffer(vertexIterator, i++, particle->oldy);
-                setInVertexBuffer(vertexIterator, i++, particle->oldz);
+                // the columns are aligned and padded to a multiple of 4
+                for (unsigned int i = 0; i < 4; ++i)
+                    rows[i] = math::simd::load(groupColumns[i] + firstParticle);
             }
 
-            if (_format & VertexComponentFlags::ROTATION)
-                setInVertexBuffer(vertexIterator, i++, particle->rotation);
+            math::simd::transpose(rows[0], rows[1], rows[2], rows[3]);
 
-            if (_format & VertexComponentFlags::SPRITE_INDEX)
-                setInVertexBuffer(vertexIterator, i++, particle->spriteIndex);
-
-            vertexIterator += 4 * _geometry->vertexSize();
-            ++liveCount;
+            for (unsigned int i = 0; i < numParticles; ++i)
+            {
+                float* vertex = vertexIterator + ((firstParticle + i) << 2) * vertexSize + (group << 2);
+
+                if (numValues == 4)
+                {
+                    for (unsigned int j = 0; j < 4; ++j)
+                        math::simd::storeu(vertex + j * vertexSize, rows[i]);
+                }
+                else
+                {
+                    alignas(16) float row[4];
+
+                    math::simd::store(row, rows[i]);
+
+                    for (unsigned int j = 0; j < 4; ++j)
+                        std::memcpy(vertex + j * vertexSize, row, numValues * sizeof(float));
+                }
+            }
         }
     }
 
-//    std::cout << "liveCount = " << _liveCount << " " << liveCount << std::endl;
+    return liveCount;
+}
+
+void
+ParticleSystem::uploadVertexData(unsigned int liveCount)
+{
     _geometry->particleVertices()->upload(0, liveCount << 2);
 
     if (liveCount != _previousLiveCount)
@@ -760,6 +1023,8 @@ ParticleSystem::updateVertexBuffer()
 ParticleSystem::Ptr
 ParticleSystem::isInWorldSpace(bool value)
 {
+    waitForSimulation();
+
     _isInWorldSpace = value;
 
     _material->isInWorldSpace(value);
@@ -770,6 +1035,8 @@ ParticleSystem::isInWorldSpace(bool value)
 ParticleSystem::Ptr
 ParticleSystem::isZSorted(bool value)
 {
+    waitForSimulation();
+
     _isZSorted = value;
 
     resizeParticlesVector();
@@ -780,6 +1047,8 @@ ParticleSystem::isZSorted(bool value)
 ParticleSystem::Ptr
 ParticleSystem::useOldPosition(bool value)
 {
+    waitForSimulation();
+
     if (value != _useOldPosition)
     {
         _useOldPosition = value;
@@ -787,4 +1056,205 @@ ParticleSystem::useOldPosition(bool value)
     }
 
     return std::static_pointer_cast<ParticleSystem>(shared_from_this());
-};
\ No newline at end of file
+};
+
+ParticleSystem::Ptr
+ParticleSystem::isAsynchronous(bool value)
+{
+    waitForSimulation();
+
+    _isAsynchronous = value;
+
+    if (_isAsynchronous)
+        _backVertices = _geometry->particleVertices()->data();
+    else
+        _backVertices.clear();
+
+    return std::static_pointer_cast<ParticleSystem>(shared_from_this());
+}
+
+ParticleSystem::Ptr
+ParticleSystem::isStateless(bool value)
+{
+    waitForSimulation();
+
+    if (value == _isStateless)
+        return std::static_pointer_cast<ParticleSystem>(shared_from_this());
+
+    if (value)
+        for (auto& updater : _updaters)
+            if (!isAnalytic(updater))
+                throw std::logic_error("A particle system with non analytic updaters cannot be stateless.");
+
+    _isStateless = value;
+    _clock = 0.f;
+    _createTimer = 0.f;
+    _particles.clear();
+
+    if (_isStateless)
+        _material->set<float>("particles.time", _clock);
+    else
+        _material->unset("particles.time");
+
+    updateVertexFormat();
+
+    return std::static_pointer_cast<ParticleSystem>(shared_from_this());
+}
+
+/*static*/
+bool
+ParticleSystem::isAnalytic(IUpdaterPtr updater)
+{
+    // evaluated by the vertex shader from the normalized time or the speed
+    if (std::dynamic_pointer_cast<modifier::ColorOverTime>(updater)
+        || std::dynamic_pointer_cast<modifier::SizeOverTime>(updater)
+        || std::dynamic_pointer_cast<modifier::ColorBySpeed>(updater)
+        || std::dynamic_pointer_cast<modifier::SizeBySpeed>(updater))
+        return true;
+
+    // constant forces and velocities are added to the spawn parameters
+    std::shared_ptr<modifier::Modifier3<float>> modifier3 = std::dynamic_pointer_cast<modifier::ForceOverTime>(updater);
+
+    if (!modifier3)
+        modifier3 = std::dynamic_pointer_cast<modifier::VelocityOverTime>(updater);
+
+    return modifier3
+        && modifier3->x()->min() == modifier3->x()->max()
+        && modifier3->y()->min() == modifier3->y()->max()
+        && modifier3->z()->min() == modifier3->z()->max();
+}
+
+void
+ParticleSystem::updateStateless(float deltaT, bool emit)
+{
+    _clock += deltaT;
+    _material->set<float>("particles.time", _clock);
+
+    if (!emit || _maxCount == 0)
+        return;
+
+    _createTimer += deltaT;
+
+    // the particles spawned before the last _maxCount ones would already be dead
+    const auto numParticles = (unsigned int)(_createTimer / _rate);
+
+    if (numParticles > _maxCount)
+        _createTimer -= (numParticles - _maxCount) * _rate;
+
+    const unsigned int  firstSlot   = _nextSlot;
+    unsigned int        numSpawned  = 0;
+
+    while (!(_createTimer < _rate) && numSpawned < _maxCount)
+    {
+        _createTimer -= _rate;
+
+        ParticleData particle;
+
+        initParticle(particle, *_shape, 0.f);
+
+        particle.lifetime = _lifetime->value();
+
+        for (auto& updater : _updaters)
+        {
+            if (auto force = std::dynamic_pointer_cast<modifier::ForceOverTime>(updater))
+            {
+                particle.startfx += force->x()->max();
+                particle.startfy += force->y()->max();
+                particle.startfz += force->z()->max();
+            }
+            else if (auto velocity = std::dynamic_pointer_cast<modifier::VelocityOverTime>(updater))
+            {
+                particle.startvx += velocity->x()->max();
+                particle.startvy += velocity->y()->max();
+                particle.startvz += velocity->z()->max();
+            }
+        }
+
+        writeStatelessParticle(_nextSlot, particle, _clock - _createTimer);
+
+        _nextSlot = (_nextSlot + 1) % _maxCount;
+        ++numSpawned;
+    }
+
+    if (numSpawned == 0)
+        return;
+
+    // only the slots written by this update are uploaded, in two ranges when the ring wraps
+    auto vertexBuffer = _geometry->particleVertices();
+
+    if (firstSlot + numSpawned <= _maxCount)
+        vertexBuffer->upload(firstSlot << 2, numSpawned << 2);
+    else
+    {
+        vertexBuffer->upload(firstSlot << 2, (_maxCount - firstSlot) << 2);
+        vertexBuffer->upload(0, _nextSlot << 2);
+    }
+}
+
+void
+ParticleSystem::writeStatelessParticle(unsigned int         slot,
+                                       const ParticleData&  particle,
+                                       float                birthTime)
+{
+    float           row[24];
+    unsigned int    numColumns  = 0;
+
+    // same order as the vertex attributes
+    row[numColumns++] = particle.x;
+    row[numColumns++] = particle.y;
+    row[numColumns++] = particle.z;
+
+    if (_format & VertexComponentFlags::SIZE)
+        row[numColumns++] = particle.size;
+
+    if (_format & VertexComponentFlags::COLOR)
+    {
+        row[numColumns++] = particle.r;
+        row[numColumns++] = particle.g;
+        row[numColumns++] = particle.b;
+    }
+
+    if (_format & VertexComponentFlags::ROTATION)
+        row[numColumns++] = particle.rotation;
+
+    if (_format & VertexComponentFlags::SPRITE_INDEX)
+        row[numColumns++] = particle.spriteIndex;
+
+    if (_format & VertexComponentFlags::ANG_VELOCITY)
+        row[numColumns++] = particle.startAngularVelocity;
+
+    row[numColumns++] = particle.startvx;
+    row[numColumns++] = particle.startvy;
+    row[numColumns++] = particle.startvz;
+    row[numColumns++] = particle.startfx;
+    row[numColumns++] = particle.startfy;
+    row[numColumns++] = particle.startfz;
+    row[numColumns++] = birthTime;
+    row[numColumns++] = particle.lifetime;
+
+    const unsigned int  vertexSize      = _geometry->vertexSize();
+    const unsigned int  rowSize         = numColumns * sizeof(float);
+    float*              vertexIterator  = _geometry->particleVertices()->data().data() + 4 * slot * vertexSize + 2;
+
+    std::memcpy(vertexIterator, row, rowSize);
+    std::memcpy(vertexIterator + vertexSize, row, rowSize);
+    std::memcpy(vertexIterator + 2 * vertexSize, row, rowSize);
+    std::memcpy(vertexIterator + 3 * vertexSize, row, rowSize);
+}
+
+void
+ParticleSystem::killStatelessParticles()
+{
+    auto&               vertices    = _geometry->particleVertices()->data();
+    const unsigned int  vertexSize  = _geometry->vertexSize();
+
+    // everything but the corner offsets, so that the lifetime of each slot is 0
+    for (unsigned int i = 0; i + vertexSize <= vertices.size(); i += vertexSize)
+        std::fill(vertices.begin() + i + 2, vertices.begin() + i + vertexSize, 0.f);
+
+    _nextSlot = 0;
+    _previousLiveCount = 0;
+
+    // every slot is drawn, the dead ones are collapsed by the vertex shader
+    uploadVertexData(_maxCount);
+}
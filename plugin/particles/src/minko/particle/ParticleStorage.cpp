@@ -0,0 +1,158 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/particle/ParticleStorage.hpp"
+#include "minko/particle/ParticleData.hpp"
+
+using namespace minko;
+using namespace minko::particle;
+
+ParticleStorage::ParticleStorage() :
+    _data(),
+    _capacity(0),
+    _stride(0),
+    _size(0)
+{
+}
+
+void
+ParticleStorage::resize(unsigned int capacity)
+{
+    const unsigned int stride   = (capacity + 3) & ~3u;
+    const unsigned int size     = std::min(_size, capacity);
+    Column data(NUM_ATTRIBUTES * stride, 0.f);
+
+    for (unsigned int i = 0; i < NUM_ATTRIBUTES && size != 0; ++i)
+        std::copy(_data.begin() + i * _stride, _data.begin() + i * _stride + size, data.begin() + i * stride);
+
+    _data.swap(data);
+    _capacity = capacity;
+    _stride = stride;
+    _size = size;
+}
+
+unsigned int
+ParticleStorage::add(const ParticleData& particle)
+{
+    if (full())
+        throw std::length_error("The particle storage is full.");
+
+    const unsigned int index = _size++;
+    float* data = _data.data() + index;
+
+    data[X * _stride]                   = particle.x;
+    data[Y * _stride]                   = particle.y;
+    data[Z * _stride]                   = particle.z;
+    data[OLD_X * _stride]               = particle.oldx;
+    data[OLD_Y * _stride]               = particle.oldy;
+    data[OLD_Z * _stride]               = particle.oldz;
+    data[VX * _stride]                  = particle.startvx;
+    data[VY * _stride]                  = particle.startvy;
+    data[VZ * _stride]                  = particle.startvz;
+    data[FX * _stride]                  = particle.startfx;
+    data[FY * _stride]                  = particle.startfy;
+    data[FZ * _stride]                  = particle.startfz;
+    data[R * _stride]                   = particle.r;
+    data[G * _stride]                   = particle.g;
+    data[B * _stride]                   = particle.b;
+    data[SIZE * _stride]                = particle.size;
+    data[ROTATION * _stride]            = particle.rotation;
+    data[ANGULAR_VELOCITY * _stride]    = particle.startAngularVelocity;
+    data[LIFETIME * _stride]            = particle.lifetime;
+    data[TIME_LIVED * _stride]          = particle.timeLived;
+    data[SPRITE_INDEX * _stride]        = particle.spriteIndex;
+    data[TIME * _stride]                = particle.lifetime > 0.f ? particle.timeLived / particle.lifetime : 0.f;
+
+    return index;
+}
+
+void
+ParticleStorage::get(unsigned int index, ParticleData& particle) const
+{
+    const float* data = _data.data() + index;
+
+    particle.x                      = data[X * _stride];
+    particle.y                      = data[Y * _stride];
+    particle.z                      = data[Z * _stride];
+    particle.oldx                   = data[OLD_X * _stride];
+    particle.oldy                   = data[OLD_Y * _stride];
+    particle.oldz                   = data[OLD_Z * _stride];
+    particle.startvx                = data[VX * _stride];
+    particle.startvy                = data[VY * _stride];
+    particle.startvz                = data[VZ * _stride];
+    particle.startfx                = data[FX * _stride];
+    particle.startfy                = data[FY * _stride];
+    particle.startfz                = data[FZ * _stride];
+    particle.r                      = data[R * _stride];
+    particle.g                      = data[G * _stride];
+    particle.b                      = data[B * _stride];
+    particle.size                   = data[SIZE * _stride];
+    particle.rotation               = data[ROTATION * _stride];
+    particle.startAngularVelocity   = data[ANGULAR_VELOCITY * _stride];
+    particle.lifetime               = data[LIFETIME * _stride];
+    particle.timeLived              = data[TIME_LIVED * _stride];
+    particle.spriteIndex            = data[SPRITE_INDEX * _stride];
+}
+
+void
+ParticleStorage::remove(unsigned int index)
+{
+    const unsigned int last = --_size;
+
+    if (index == last)
+        return;
+
+    for (unsigned int i = 0; i < NUM_ATTRIBUTES; ++i)
+        _data[i * _stride + index] = _data[i * _stride + last];
+}
+
+void
+ParticleStorage::removeDead()
+{
+    const float* lifetimes      = attribute(LIFETIME);
+    const float* timesLived     = attribute(TIME_LIVED);
+    unsigned int i              = 0;
+
+    while (i < _size)
+    {
+        // skip whole lanes of live particles
+        if ((i & 3) == 0 && i + 4 <= _size
+            && math::simd::lessThan(math::simd::load(timesLived + i), math::simd::load(lifetimes + i)) == 0xf)
+            i += 4;
+        else if (timesLived[i] < lifetimes[i])
+            ++i;
+        else
+            remove(i);
+    }
+}
+
+void
+ParticleStorage::updateTimes()
+{
+    const float*    lifetimes   = attribute(LIFETIME);
+    const float*    timesLived  = attribute(TIME_LIVED);
+    float*          times       = attribute(TIME);
+    const auto      epsilon     = math::simd::splat(1e-30f);
+
+    for (unsigned int i = 0; i < paddedSize(); i += 4)
+        math::simd::store(times + i, math::simd::div(
+            math::simd::load(timesLived + i),
+            math::simd::max(math::simd::load(lifetimes + i), epsilon)
+        ));
+}
@@ -20,7 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/data/ParticlesProvider.hpp"
 #include "minko/math/Vector4.hpp"
 #include "minko/particle/modifier/ColorOverTime.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStorage.hpp"
 #include "minko/particle/sampler/LinearlyInterpolatedValue.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
 
@@ -44,7 +44,7 @@ ColorOverTime::ColorOverTime(LinearlyInterpolatedValue<math::Vector3>::Ptr color
 }
 
 void
-ColorOverTime::update(std::vector<ParticleData>&, float timeStep) const
+ColorOverTime::update(ParticleStorage&, float timeStep) const
 {
 
 }
@@ -18,7 +18,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "minko/particle/modifier/ForceOverTime.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStorage.hpp"
 #include "minko/particle/sampler/Sampler.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
 
@@ -36,24 +36,30 @@ ForceOverTime::ForceOverTime(SamplerPtr fx,
 }
 
 void
-ForceOverTime::update(std::vector<ParticleData>&     particles,
-                          float                            timeStep) const
+ForceOverTime::update(ParticleStorage&    particles,
+                      float               timeStep) const
 {
-    float sqTime = timeStep * timeStep;
-
-    for (auto& particle : particles)
-        if (particle.alive())
-            {
-                const float t = particle.lifetime > 0.0f
-                    ? particle.timeLived / particle.lifetime
-                    : 0.0f;
-
-                particle.x += _x->value(t) * sqTime;
-                particle.y += _y->value(t) * sqTime;
-                particle.z += _z->value(t) * sqTime;
-            }
-}
+    const unsigned int  numLanes    = particles.paddedSize();
+    const float*        times       = particles.attribute(ParticleStorage::TIME);
+    float*              fx          = particles.attribute(ParticleStorage::TEMPORARY_0);
+    float*              fy          = particles.attribute(ParticleStorage::TEMPORARY_1);
+    float*              fz          = particles.attribute(ParticleStorage::TEMPORARY_2);
+    float*              x           = particles.attribute(ParticleStorage::X);
+    float*              y           = particles.attribute(ParticleStorage::Y);
+    float*              z           = particles.attribute(ParticleStorage::Z);
+    const auto          sqTime      = math::simd::splat(timeStep * timeStep);
+
+    _x->values(times, fx, numLanes);
+    _y->values(times, fy, numLanes);
+    _z->values(times, fz, numLanes);
 
+    for (unsigned int i = 0; i < numLanes; i += 4)
+    {
+        math::simd::store(x + i, math::simd::madd(math::simd::load(fx + i), sqTime, math::simd::load(x + i)));
+        math::simd::store(y + i, math::simd::madd(math::simd::load(fy + i), sqTime, math::simd::load(y + i)));
+        math::simd::store(z + i, math::simd::madd(math::simd::load(fz + i), sqTime, math::simd::load(z + i)));
+    }
+}
 
 unsigned int
 ForceOverTime::getNeededComponents() const
@@ -20,7 +20,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/data/ParticlesProvider.hpp"
 #include "minko/math/Vector4.hpp"
 #include "minko/particle/modifier/SizeBySpeed.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStorage.hpp"
 #include "minko/particle/sampler/LinearlyInterpolatedValue.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
 
@@ -41,7 +41,7 @@ SizeBySpeed::SizeBySpeed(LinearlyInterpolatedValue<float>::Ptr size):
 }
 
 void
-SizeBySpeed::update(std::vector<ParticleData>&, float) const
+SizeBySpeed::update(ParticleStorage&, float) const
 {
 
 }
@@ -18,7 +18,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 */
 
 #include "minko/particle/modifier/VelocityOverTime.hpp"
-#include "minko/particle/ParticleData.hpp"
+#include "minko/particle/ParticleStorage.hpp"
 #include "minko/particle/sampler/Sampler.hpp"
 #include "minko/particle/tools/VertexComponentFlags.hpp"
 
@@ -36,27 +36,31 @@ VelocityOverTime::VelocityOverTime(SamplerPtr vx,
 }
 
 void
-VelocityOverTime::update(std::vector<ParticleData>& particles,
-                             float                      timeStep) const
+VelocityOverTime::update(ParticleStorage&   particles,
+                         float              timeStep) const
 {
-    for (auto& particle : particles)
-        if (particle.alive())
-            {
-                const float t = particle.lifetime > 0.0f
-                    ? particle.timeLived / particle.lifetime
-                    : 0.0f;
+    const unsigned int  numLanes    = particles.paddedSize();
+    const float*        times       = particles.attribute(ParticleStorage::TIME);
+    float*              vx          = particles.attribute(ParticleStorage::TEMPORARY_0);
+    float*              vy          = particles.attribute(ParticleStorage::TEMPORARY_1);
+    float*              vz          = particles.attribute(ParticleStorage::TEMPORARY_2);
+    float*              x           = particles.attribute(ParticleStorage::X);
+    float*              y           = particles.attribute(ParticleStorage::Y);
+    float*              z           = particles.attribute(ParticleStorage::Z);
+    const auto          step        = math::simd::splat(timeStep);
 
-                const float dx = _x->value(t) * timeStep;
-                const float dy = _y->value(t) * timeStep;
-                const float dz = _z->value(t) * timeStep;
+    _x->values(times, vx, numLanes);
+    _y->values(times, vy, numLanes);
+    _z->values(times, vz, numLanes);
 
-                particle.x += dx;
-                particle.y += dy;
-                particle.z += dz;
-            }
+    for (unsigned int i = 0; i < numLanes; i += 4)
+    {
+        math::simd::store(x + i, math::simd::madd(math::simd::load(vx + i), step, math::simd::load(x + i)));
+        math::simd::store(y + i, math::simd::madd(math::simd::load(vy + i), step, math::simd::load(y + i)));
+        math::simd::store(z + i, math::simd::madd(math::simd::load(vz + i), step, math::simd::load(z + i)));
+    }
 }
 
-
 unsigned int
 VelocityOverTime::getNeededComponents() const
 {
@@ -36,7 +36,7 @@ namespace minko
         private:
             static std::unordered_set<Ptr>                              _activeInstances;
 
-            Signal<async::Worker::Ptr, async::Worker::Message>::Slot    _workerSlot;
+            async::Worker::MessageSignal::Slot                          _workerSlot;
 
         public:
             inline static
@@ -997,8 +997,17 @@ Canvas::step()
     }
 
 #if MINKO_PLATFORM != MINKO_PLATFORM_HTML5
-    for (auto worker : _activeWorkers)
+    for (auto workerIt = _activeWorkers.begin(); workerIt != _activeWorkers.end();)
+    {
+        auto worker = *workerIt;
+
         worker->poll();
+
+        if (worker->finished())
+            workerIt = _activeWorkers.erase(workerIt);
+        else
+            ++workerIt;
+    }
 #endif
 
     auto absoluteTime = std::chrono::high_resolution_clock::now();
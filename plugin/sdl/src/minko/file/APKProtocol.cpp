@@ -71,7 +71,7 @@ APKProtocol::load()
             auto instance = std::static_pointer_cast<APKProtocol>(shared_from_this());
 
             _workerSlot = worker->message()->connect(
-                [this, instance](async::Worker::Ptr, async::Worker::Message message)
+                [this, instance](async::Worker::Ptr, const async::Worker::Message& message)
                 {
                     if (message.type == "complete")
                     {
@@ -42,7 +42,7 @@ namespace minko
 
 			std::vector<char> output;
 
-			post(Message { "progress" }.set(0.0f));
+			post(Message("progress", 0.0f));
 
             SDL_RWops* file = SDL_RWFromFile(filename.c_str(), "rb");
 
@@ -79,18 +79,18 @@ namespace minko
 
                     progress *= 100.0;
 
-                    post(Message { "progress" }.set(progress));
+                    post(Message("progress", progress));
 
 					offset = nextOffset;
 				}
 
 				file->close(file);
 
-				post(Message{ "complete" }.set(output));
+				post(Message("complete", std::move(output)));
 			}
 			else
 			{
-				post(Message{ "error" });
+				post(Message("error"));
 			}
 		});
 	}
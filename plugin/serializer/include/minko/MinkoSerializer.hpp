@@ -6,6 +6,7 @@
 #include "minko/file/SceneWriter.hpp"
 #include "minko/file/SceneParser.hpp"
 #include "minko/file/GeometryWriter.hpp"
+#include "minko/file/HashVertexWelder.hpp"
 #include "minko/file/GeometryParser.hpp"
 #include "minko/file/MaterialParser.hpp"
 #include "minko/file/MaterialWriter.hpp"
@@ -40,6 +40,7 @@ namespace minko
 		class Dependency;
 		class GeometryParser;
 		class GeometryWriter;
+		class HashVertexWelder;
         class LinkedAsset;
 		class MaterialParser;
 		class MaterialWriter;
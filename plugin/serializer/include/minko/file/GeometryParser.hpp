@@ -103,6 +103,11 @@ namespace minko
             deserializeIndexBufferChar(std::string&          serializedIndexBuffer,
                                        AbstractContextPtr    context);
 
+            static
+            IndexBufferPtr
+            deserializeIndexBufferInt(std::string&          serializedIndexBuffer,
+                                      AbstractContextPtr    context);
+
         };
     }
 }
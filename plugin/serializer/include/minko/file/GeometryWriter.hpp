@@ -107,6 +107,10 @@ namespace minko
             std::string
             serializeIndexStreamChar(std::shared_ptr<render::IndexBuffer> indexBuffer);
 
+            static
+            std::string
+            serializeIndexStreamInt(std::shared_ptr<render::IndexBuffer> indexBuffer);
+
             static
             std::string
             serializeVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer);
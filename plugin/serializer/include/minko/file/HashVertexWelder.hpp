@@ -0,0 +1,118 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Common.hpp"
+#include "minko/SerializerCommon.hpp"
+#include "minko/file/AbstractWriterPreprocessor.hpp"
+
+namespace minko
+{
+    namespace file
+    {
+        // Welds the vertices of each geometry with Geometry::weldVertices(): only the vertices
+        // having the same attributes, or the same attributes once snapped to a grid of size
+        // epsilon, are merged. Unlike VertexWelder, no attribute is averaged, which makes it
+        // suitable for large meshes.
+        class HashVertexWelder :
+            public AbstractWriterPreprocessor<std::shared_ptr<scene::Node>>
+        {
+        public:
+            typedef std::shared_ptr<HashVertexWelder>                           Ptr;
+
+            typedef std::shared_ptr<AssetLibrary>                               AssetLibraryPtr;
+
+            typedef std::shared_ptr<geometry::Geometry>                         GeometryPtr;
+
+            typedef std::shared_ptr<scene::Node>                                NodePtr;
+
+            typedef std::function<bool(NodePtr)>                                NodePredicateFunction;
+
+        private:
+            StatusChangedSignal::Ptr            _statusChanged;
+            float                               _progressRate;
+
+            NodePredicateFunction               _nodePredicateFunction;
+            float                               _epsilon;
+
+        public:
+            ~HashVertexWelder() = default;
+
+            static
+            Ptr
+            create(float epsilon = 0.f)
+            {
+                auto instance = Ptr(new HashVertexWelder(epsilon));
+
+                return instance;
+            }
+
+            inline
+            const NodePredicateFunction&
+            nodePredicateFunction() const
+            {
+                return _nodePredicateFunction;
+            }
+
+            inline
+            Ptr
+            nodePredicateFunction(const NodePredicateFunction& func)
+            {
+                _nodePredicateFunction = func;
+
+                return std::static_pointer_cast<HashVertexWelder>(shared_from_this());
+            }
+
+            inline
+            float
+            epsilon() const
+            {
+                return _epsilon;
+            }
+
+            inline
+            Ptr
+            epsilon(float value)
+            {
+                _epsilon = value;
+
+                return std::static_pointer_cast<HashVertexWelder>(shared_from_this());
+            }
+
+            float
+            progressRate() const override
+            {
+                return _progressRate;
+            }
+
+            StatusChangedSignal::Ptr
+            statusChanged() override
+            {
+                return _statusChanged;
+            }
+
+            void
+            process(NodePtr& node, AssetLibraryPtr assetLibrary) override;
+
+        private:
+            HashVertexWelder(float epsilon);
+        };
+    }
+}
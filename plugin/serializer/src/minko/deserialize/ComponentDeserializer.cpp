@@ -433,7 +433,9 @@ ComponentDeserializer::deserializeSkinning(file::SceneVersion sceneVersion,
         options->skinningMethod(),
         context,
 		root,
-		true
+		true,
+		true,
+		options->skinningPalette()
     );
 
     return skinning;
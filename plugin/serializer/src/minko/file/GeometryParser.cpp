@@ -46,6 +46,11 @@ GeometryParser::initialize()
         1
     );
 
+    registerIndexBufferParserFunction(
+        std::bind(&GeometryParser::deserializeIndexBufferInt, std::placeholders::_1, std::placeholders::_2),
+        2
+    );
+
     registerVertexBufferParserFunction(
         std::bind(&GeometryParser::deserializeVertexBuffer, std::placeholders::_1, std::placeholders::_2),
         0
@@ -92,6 +97,15 @@ GeometryParser::deserializeIndexBufferChar(std::string&
     return render::IndexBuffer::create(context, vector);
 }
 
+GeometryParser::IndexBufferPtr
+GeometryParser::deserializeIndexBufferInt(std::string&                             serializedIndexBuffer,
+                                          std::shared_ptr<render::AbstractContext> context)
+{
+    std::vector<unsigned int> vector = deserialize::TypeDeserializer::deserializeVector<unsigned int>(serializedIndexBuffer);
+
+    return render::IndexBuffer::create(context, vector);
+}
+
 void
 GeometryParser::parse(const std::string&                filename,
                       const std::string&                resolvedFilename,
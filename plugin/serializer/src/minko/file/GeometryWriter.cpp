@@ -55,6 +55,15 @@ GeometryWriter::initialize()
 		1
 	);
 
+	registerIndexBufferWriterFunction(
+		std::bind(
+			GeometryWriter::serializeIndexStreamInt,
+			std::placeholders::_1
+		),
+        [=](std::shared_ptr<geometry::Geometry> geometry) { return geometry->indices()->unsignedIntIndices(); },
+		2
+	);
+
 	registerVertexBufferWriterFunction(
 		std::bind(
 			GeometryWriter::serializeVertexStream,
@@ -105,6 +114,12 @@ GeometryWriter::serializeIndexStreamChar(std::shared_ptr<render::IndexBuffer> in
 	return serialize::TypeSerializer::serializeVector<unsigned short, unsigned char>(indexBuffer->data());
 }
 
+std::string
+GeometryWriter::serializeIndexStreamInt(std::shared_ptr<render::IndexBuffer> indexBuffer)
+{
+	return serialize::TypeSerializer::serializeVector<unsigned int>(*indexBuffer->dataPointer<unsigned int>());
+}
+
 std::string
 GeometryWriter::serializeVertexStream(std::shared_ptr<render::VertexBuffer> vertexBuffer)
 {
@@ -156,7 +171,7 @@ GeometryWriter::computeMetaData(std::shared_ptr<geometry::Geometry> geometry,
 bool
 GeometryWriter::indexBufferFitCharCompression(std::shared_ptr<geometry::Geometry> geometry)
 {
-    if (geometry->indices()->data().empty())
+    if (geometry->indices()->unsignedIntIndices() || geometry->indices()->data().empty())
         return false;
 
 	std::vector<unsigned short>::iterator maxIndice = std::max_element(geometry->indices()->data().begin(), geometry->indices()->data().end());
@@ -0,0 +1,82 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/component/Surface.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/file/HashVertexWelder.hpp"
+#include "minko/geometry/Geometry.hpp"
+#include "minko/scene/Node.hpp"
+#include "minko/scene/NodeSet.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::file;
+using namespace minko::geometry;
+using namespace minko::scene;
+
+HashVertexWelder::HashVertexWelder(float epsilon) :
+    AbstractWriterPreprocessor<Node::Ptr>(),
+    _statusChanged(StatusChangedSignal::create()),
+    _progressRate(0.f),
+    _nodePredicateFunction([](Node::Ptr) -> bool { return true; }),
+    _epsilon(epsilon)
+{
+}
+
+void
+HashVertexWelder::process(Node::Ptr& node, AssetLibrary::Ptr assetLibrary)
+{
+    if (statusChanged() && statusChanged()->numCallbacks() > 0u)
+        statusChanged()->execute(shared_from_this(), "HashVertexWelder: start");
+
+    auto geometrySet = std::unordered_set<Geometry::Ptr>();
+
+    auto surfaceNodeSet = NodeSet::create(node)
+        ->descendants(true)
+        ->where([this](Node::Ptr descendant) -> bool
+            {
+                return descendant->hasComponent<Surface>() &&
+                    (!nodePredicateFunction() || nodePredicateFunction()(descendant));
+            }
+        );
+
+    for (auto surfaceNode : surfaceNodeSet->nodes())
+        for (auto surface : surfaceNode->components<Surface>())
+            if (surface->geometry()->indices() && surface->geometry()->numVertices() > 0u)
+                geometrySet.insert(surface->geometry());
+
+    auto geometryIndex = 0;
+
+    for (auto geometry : geometrySet)
+    {
+        _progressRate = geometryIndex / float(geometrySet.size());
+
+        if (statusChanged() && statusChanged()->numCallbacks() > 0u)
+            statusChanged()->execute(shared_from_this(), "HashVertexWelder: processing geometry with " + std::to_string(geometry->numVertices()) + " vertices");
+
+        geometry->weldVertices(_epsilon);
+
+        ++geometryIndex;
+    }
+
+    _progressRate = 1.f;
+
+    if (statusChanged() && statusChanged()->numCallbacks() > 0u)
+        statusChanged()->execute(shared_from_this(), "HashVertexWelder: stop");
+}
@@ -31,6 +31,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SO
 #include "minko/render/AbstractTexture.hpp"
 #include "minko/render/Texture.hpp"
 #include "minko/render/TextureFormatInfo.hpp"
+#include "minko/render/TextureProcessor.hpp"
 
 using namespace minko;
 using namespace minko::file;
@@ -267,17 +268,17 @@ StreamedTextureWriter::writeRGBATexture(AbstractTexture::Ptr
     const auto baseWidth = texture->width();
     const auto baseHeight = texture->height();
 
-    auto mipLevelTemplate = Texture::create(
-        texture->context(),
+    auto mipChain = std::vector<unsigned char>();
+
+    TextureProcessor::generateMipChain(
         baseWidth,
         baseHeight,
-        false,
-        false,
-        true
+        texture->data().data(),
+        TextureProcessor::Filter::BOX,
+        writerOptions->useTextureSRGBSpace(textureType),
+        mipChain
     );
 
-    mipLevelTemplate->data(texture->data().data());
-
     const auto numMipLevels = math::getp2(baseWidth) + 1;
 
     mipLevels.resize(numMipLevels);
@@ -291,13 +292,14 @@ StreamedTextureWriter::writeRGBATexture(AbstractTexture::Ptr
         const auto mipLevelWidth = std::max(baseWidth >> i, 1u);
         const auto mipLevelHeight = std::max(baseHeight >> i, 1u);
 
-        mipLevelTemplate->resize(mipLevelWidth, mipLevelHeight, true);
+        const auto mipLevelBegin = mipChain.begin() + TextureProcessor::mipLevelOffset(baseWidth, baseHeight, i);
+        const auto mipLevel = std::vector<unsigned char>(mipLevelBegin, mipLevelBegin + mipLevelWidth * mipLevelHeight * 4);
 
         auto mipLevelData = std::vector<unsigned char>();
 
         auto writer = PNGWriter::create();
 
-        writer->writeToStream(mipLevelData, mipLevelTemplate->data(), mipLevelWidth, mipLevelHeight);
+        writer->writeToStream(mipLevelData, mipLevel, mipLevelWidth, mipLevelHeight);
 
         blob.write(reinterpret_cast<const char*>(mipLevelData.data()), mipLevelData.size());
 
@@ -276,3 +276,124 @@ TEST_F(SignalTest, SameCallbackTwice)
 
     ASSERT_EQ(s.numCallbacks(), 1);
 }
+
+TEST_F(SignalTest, ReentrantExecute)
+{
+    Signal<int> s;
+    auto v = 0;
+
+    auto _ = s.connect([&](int i)
+    {
+        v += i;
+        if (i > 0)
+            s.execute(i - 1);
+    });
+
+    s.execute(3);
+
+    ASSERT_EQ(v, 6);
+}
+
+TEST_F(SignalTest, DisconnectSelfDuringExecute)
+{
+    Signal<> s;
+    auto v = 0;
+    Signal<>::Slot slot1;
+
+    slot1 = s.connect([&]()
+    {
+        ++v;
+        slot1 = nullptr;
+    });
+    auto slot2 = s.connect([&]() { ++v; });
+
+    s.execute();
+    s.execute();
+
+    ASSERT_EQ(s.numCallbacks(), 1);
+    ASSERT_EQ(v, 3);
+}
+
+TEST_F(SignalTest, ConnectAndDisconnectDuringExecute)
+{
+    Signal<> s;
+    auto v = 0;
+    Signal<>::Slot slot2;
+
+    auto slot1 = s.connect([&]()
+    {
+        slot2 = s.connect([&]() { v += 10; }, 1.f);
+        slot2 = nullptr;
+        slot2 = s.connect([&]() { v += 100; }, 1.f);
+    });
+
+    s.execute();
+
+    ASSERT_EQ(s.numCallbacks(), 2);
+    ASSERT_EQ(v, 0);
+
+    slot1 = nullptr;
+    s.execute();
+
+    ASSERT_EQ(s.numCallbacks(), 1);
+    ASSERT_EQ(v, 100);
+}
+
+TEST_F(SignalTest, PriorityAfterExecute)
+{
+    Signal<> s;
+    std::vector<int> order;
+    std::list<Signal<>::Slot> slots;
+
+    slots.push_back(s.connect([&]()
+    {
+        order.push_back(0);
+        if (slots.size() == 1)
+            slots.push_back(s.connect([&]() { order.push_back(1); }, 1.f));
+    }));
+
+    s.execute();
+    s.execute();
+
+    ASSERT_EQ(order, std::vector<int>({ 0, 1, 0 }));
+}
+
+TEST_F(SignalTest, DestroyDuringExecute)
+{
+    auto s = new Signal<>();
+    auto v = 0;
+
+    auto _ = s->connect([&]()
+    {
+        delete s;
+    }, 1.f);
+    auto __ = s->connect([&]()
+    {
+        ++v;
+    });
+
+    s->execute();
+
+    ASSERT_EQ(v, 0);
+    ASSERT_EQ(_->signal(), nullptr);
+}
+
+// Compares the dispatch cost with the list-based signal; disabled by default, the timings are
+// recorded as test properties when run with --gtest_also_run_disabled_tests.
+TEST_F(SignalTest, DISABLED_ExecuteBenchmark)
+{
+    for (auto numListeners : { 1u, 10u, 1000u })
+    {
+        auto numExecutes = 1000000u / numListeners;
+        auto signalCounter = 0u;
+        auto listSignalCounter = 0u;
+        auto signalTime = benchmarkExecute<Signal<int>>(numListeners, numExecutes, signalCounter);
+        auto listSignalTime = benchmarkExecute<ListSignal<int>>(numListeners, numExecutes, listSignalCounter);
+
+        RecordProperty("nsPerExecute" + std::to_string(numListeners), static_cast<int>(signalTime));
+        RecordProperty("nsPerListExecute" + std::to_string(numListeners), static_cast<int>(listSignalTime));
+
+        ASSERT_EQ(signalCounter, numListeners * numExecutes);
+        ASSERT_EQ(signalCounter, listSignalCounter);
+    }
+}
@@ -28,6 +28,62 @@ namespace minko
 	class SignalTest :
 		public ::testing::Test
 	{
+	protected:
+		// Reference implementation of the previous list-based Signal, which copied its callbacks
+		// on every execute(), used as a baseline by the benchmarks.
+		template <typename... A>
+		class ListSignal
+		{
+		public:
+			typedef std::function<void(A...)>	Callback;
+			typedef std::shared_ptr<int>		Slot;
 
+		private:
+			std::list<std::pair<Callback, std::weak_ptr<int>>> _callbacks;
+
+		public:
+			Slot
+			connect(Callback callback)
+			{
+				auto slot = std::make_shared<int>(0);
+
+				_callbacks.emplace_back(callback, slot);
+
+				return slot;
+			}
+
+			void
+			execute(A... arguments) const
+			{
+				auto callbacks = _callbacks;
+
+				for (auto& callback : callbacks)
+					if (!callback.second.expired())
+						callback.first(arguments...);
+			}
+		};
+
+		// Returns the average duration of one execute() in nanoseconds.
+		template <typename S>
+		double
+		benchmarkExecute(uint numListeners, uint numExecutes, uint& counter)
+		{
+			S signal;
+			std::vector<typename S::Slot> slots;
+
+			for (auto i = 0u; i < numListeners; ++i)
+				slots.push_back(signal.connect([&](int value) { counter += value; }));
+
+			auto start = std::chrono::high_resolution_clock::now();
+
+			for (auto i = 0u; i < numExecutes; ++i)
+				signal.execute(1);
+
+			auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::high_resolution_clock::now() - start
+			).count();
+
+			return (double)duration / numExecutes;
+		}
 	};
 }
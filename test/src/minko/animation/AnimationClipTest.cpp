@@ -0,0 +1,219 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "AnimationClipTest.hpp"
+
+using namespace minko;
+using namespace minko::animation;
+
+void
+AnimationClipTest::createTrack(uint						numKeys,
+							   uint						keyDuration,
+							   std::vector<uint>&		timetable,
+							   std::vector<math::mat4>&	matrices)
+{
+	timetable.clear();
+	matrices.clear();
+
+	for (uint keyId = 0; keyId < numKeys; ++keyId)
+	{
+		auto translation = (math::vec3(rand(), rand(), rand()) / float(RAND_MAX) - .5f) * 10.f;
+		auto axis = math::normalize(math::vec3(rand(), rand(), rand()) / float(RAND_MAX) + .1f);
+		auto angle = rand() / float(RAND_MAX) * 6.f - 3.f;
+		auto scale = math::vec3(rand() % 100 + 50) / 100.f;
+
+		timetable.push_back(keyId * keyDuration);
+		matrices.push_back(math::translate(translation) * math::rotate(angle, axis) * math::scale(scale));
+	}
+}
+
+void
+AnimationClipTest::assertMatrixNear(const math::mat4& expected, const math::mat4& value, float epsilon)
+{
+	for (auto i = 0; i < 4; ++i)
+		for (auto j = 0; j < 4; ++j)
+			ASSERT_NEAR(expected[i][j], value[i][j], epsilon);
+}
+
+TEST_F(AnimationClipTest, Create)
+{
+	auto timetables = std::vector<std::vector<uint>>(3);
+	auto matrices = std::vector<std::vector<math::mat4>>(3);
+
+	for (auto i = 0; i < 3; ++i)
+		createTrack(10 + i, 33, timetables[i], matrices[i]);
+
+	auto clip = AnimationClip::create(400, timetables, matrices);
+
+	ASSERT_EQ(clip->duration(), 400);
+	ASSERT_EQ(clip->numTracks(), 3);
+	ASSERT_EQ(clip->numKeys(2), 12);
+	ASSERT_GT(clip->memorySize(), 0);
+	ASSERT_LT(clip->memorySize(), 33 * sizeof(math::mat4));
+}
+
+TEST_F(AnimationClipTest, CreateInvalidTracks)
+{
+	auto timetables = std::vector<std::vector<uint>>(1);
+	auto matrices = std::vector<std::vector<math::mat4>>(1);
+
+	ASSERT_THROW(AnimationClip::create(100, timetables, matrices), std::invalid_argument);
+
+	createTrack(2, 10, timetables[0], matrices[0]);
+	matrices[0].pop_back();
+
+	ASSERT_THROW(AnimationClip::create(100, timetables, matrices), std::logic_error);
+	ASSERT_THROW(AnimationClip::create(100, timetables, std::vector<std::vector<math::mat4>>()), std::logic_error);
+}
+
+TEST_F(AnimationClipTest, SampleKeys)
+{
+	const auto numTracks = 7u;
+	auto timetables = std::vector<std::vector<uint>>(numTracks);
+	auto matrices = std::vector<std::vector<math::mat4>>(numTracks);
+
+	for (auto i = 0u; i < numTracks; ++i)
+		createTrack(20, 40, timetables[i], matrices[i]);
+
+	auto clip = AnimationClip::create(19 * 40, timetables, matrices);
+	auto cursors = AnimationClip::Cursors();
+	auto sampled = std::vector<math::mat4>();
+
+	for (auto keyId = 0u; keyId < 20u; ++keyId)
+	{
+		clip->sample(keyId * 40, cursors, sampled);
+
+		ASSERT_EQ(sampled.size(), numTracks);
+		for (auto trackId = 0u; trackId < numTracks; ++trackId)
+			assertMatrixNear(matrices[trackId][keyId], sampled[trackId], 2e-3f);
+	}
+}
+
+TEST_F(AnimationClipTest, SampleInterpolatesRotations)
+{
+	auto timetables = std::vector<std::vector<uint>>(1, std::vector<uint>({ 0, 100 }));
+	auto matrices = std::vector<std::vector<math::mat4>>(1, std::vector<math::mat4>({
+		math::translate(math::vec3(0.f, 0.f, 0.f)),
+		math::translate(math::vec3(0.f, 4.f, 0.f)) * math::rotate(math::half_pi<float>(), math::vec3(0.f, 0.f, 1.f))
+	}));
+
+	auto clip = AnimationClip::create(100, timetables, matrices);
+	auto cursors = AnimationClip::Cursors();
+	auto sampled = std::vector<math::mat4>();
+
+	clip->sample(50, cursors, sampled);
+
+	assertMatrixNear(
+		math::translate(math::vec3(0.f, 2.f, 0.f)) * math::rotate(math::quarter_pi<float>(), math::vec3(0.f, 0.f, 1.f)),
+		sampled[0],
+		1e-3f
+	);
+}
+
+TEST_F(AnimationClipTest, SampleBackward)
+{
+	const auto numTracks = 5u;
+	auto timetables = std::vector<std::vector<uint>>(numTracks);
+	auto matrices = std::vector<std::vector<math::mat4>>(numTracks);
+
+	for (auto i = 0u; i < numTracks; ++i)
+		createTrack(30, 20 + i, timetables[i], matrices[i]);
+
+	auto clip = AnimationClip::create(600, timetables, matrices);
+	auto cursors = AnimationClip::Cursors();
+	auto sampled = std::vector<math::mat4>();
+
+	clip->sample(550, cursors, sampled);
+
+	// the cursors are ahead of the time now: the result must not depend on them
+	for (auto time = 500; time >= -600; time -= 37)
+	{
+		auto freshCursors = AnimationClip::Cursors();
+		auto expected = std::vector<math::mat4>();
+
+		clip->sample(time, freshCursors, expected);
+		clip->sample(time, cursors, sampled);
+
+		for (auto trackId = 0u; trackId < numTracks; ++trackId)
+			assertMatrixNear(expected[trackId], sampled[trackId], 1e-6f);
+	}
+}
+
+TEST_F(AnimationClipTest, SampleMatchesMatrix4x4Timeline)
+{
+	auto timetables = std::vector<std::vector<uint>>(1);
+	auto matrices = std::vector<std::vector<math::mat4>>(1);
+
+	// translations only, so that both interpolations are the same
+	for (auto keyId = 0u; keyId < 10u; ++keyId)
+	{
+		timetables[0].push_back(keyId * 50);
+		matrices[0].push_back(math::translate((math::vec3(rand(), rand(), rand()) / float(RAND_MAX) - .5f) * 10.f));
+	}
+
+	auto clip = AnimationClip::create(450, timetables, matrices);
+	auto timeline = Matrix4x4Timeline::create("matrix", 450, timetables[0], matrices[0], true);
+	auto cursors = AnimationClip::Cursors();
+	auto sampled = std::vector<math::mat4>();
+
+	for (auto time = 0u; time < 900u; time += 7)
+	{
+		clip->sample(time, cursors, sampled);
+
+		assertMatrixNear(timeline->interpolate(time), sampled[0], 1e-3f);
+	}
+}
+
+// Not a correctness test: the memory used by the keys of a clip of 60 bones sampled at 30 frames
+// per second for 10 seconds, and the time spent sampling it for a crowd of 200 characters. Disabled
+// by default, both are recorded as test properties.
+TEST_F(AnimationClipTest, DISABLED_SampleBenchmark)
+{
+	const auto numCharacters = 200u;
+	const auto numBones = 60u;
+	const auto numKeys = 300u;
+	const auto keyDuration = 33u;
+
+	auto timetables = std::vector<std::vector<uint>>(numBones);
+	auto matrices = std::vector<std::vector<math::mat4>>(numBones);
+
+	for (auto i = 0u; i < numBones; ++i)
+		createTrack(numKeys, keyDuration, timetables[i], matrices[i]);
+
+	auto clip = AnimationClip::create((numKeys - 1) * keyDuration, timetables, matrices);
+	auto cursors = std::vector<AnimationClip::Cursors>(numCharacters);
+	auto sampled = std::vector<math::mat4>(numBones);
+	const auto numFrames = 100u;
+
+	auto start = std::clock();
+	for (auto frame = 0u; frame < numFrames; ++frame)
+		for (auto characterId = 0u; characterId < numCharacters; ++characterId)
+			clip->sample(frame * 16 + characterId * 7, cursors[characterId], sampled);
+
+	auto sampleTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numFrames;
+
+	const auto matricesSize = numBones * numKeys * sizeof(math::mat4);
+
+	RecordProperty("matricesKB", static_cast<int>(matricesSize / 1024));
+	RecordProperty("compressedKB", static_cast<int>(clip->memorySize() / 1024));
+	RecordProperty("msPerFrame", std::to_string(sampleTime));
+
+	ASSERT_LT(clip->memorySize() * 2, matricesSize);
+}
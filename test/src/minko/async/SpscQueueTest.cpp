@@ -0,0 +1,127 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "SpscQueueTest.hpp"
+
+using namespace minko;
+using namespace minko::async;
+
+TEST_F(SpscQueueTest, Capacity)
+{
+    ASSERT_EQ(SpscQueue<int>(3).capacity(), 4u);
+    ASSERT_EQ(SpscQueue<int>(0).capacity(), 2u);
+    ASSERT_EQ(SpscQueue<int>(16).capacity(), 16u);
+}
+
+TEST_F(SpscQueueTest, PushPopOrder)
+{
+    SpscQueue<int> queue(4);
+    auto value = 0;
+
+    ASSERT_TRUE(queue.empty());
+    ASSERT_FALSE(queue.tryPop(value));
+
+    for (auto i = 0; i < 10; ++i)
+    {
+        ASSERT_TRUE(queue.tryPush(int(i)));
+        ASSERT_TRUE(queue.tryPush(int(i + 100)));
+        ASSERT_TRUE(queue.tryPop(value));
+        ASSERT_EQ(value, i);
+        ASSERT_TRUE(queue.tryPop(value));
+        ASSERT_EQ(value, i + 100);
+    }
+
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST_F(SpscQueueTest, Full)
+{
+    SpscQueue<std::vector<char>> queue(2);
+    auto item = std::vector<char>(10, 'a');
+
+    ASSERT_TRUE(queue.tryPush(std::vector<char>(1)));
+    ASSERT_TRUE(queue.tryPush(std::vector<char>(2)));
+    ASSERT_FALSE(queue.tryPush(std::move(item)));
+    // a rejected item is left untouched
+    ASSERT_EQ(item.size(), 10u);
+
+    auto popped = std::vector<char>();
+
+    ASSERT_TRUE(queue.tryPop(popped));
+    ASSERT_EQ(popped.size(), 1u);
+    ASSERT_TRUE(queue.tryPush(std::move(item)));
+    ASSERT_TRUE(queue.tryPop(popped));
+    ASSERT_EQ(popped.size(), 2u);
+    ASSERT_TRUE(queue.tryPop(popped));
+    ASSERT_EQ(popped.size(), 10u);
+}
+
+TEST_F(SpscQueueTest, MoveOnlyMessages)
+{
+    SpscQueue<Worker::Message> queue(4);
+    auto data = std::vector<char>(1024, 'a');
+    auto bytes = data.data();
+
+    ASSERT_TRUE(queue.tryPush(Worker::Message("complete", std::move(data))));
+    ASSERT_TRUE(queue.tryPush(Worker::Message("progress", 0.5f)));
+
+    Worker::Message message;
+
+    ASSERT_TRUE(queue.tryPop(message));
+    ASSERT_EQ(message.type, "complete");
+    // the buffer changed hands without being copied
+    ASSERT_EQ(message.data.data(), bytes);
+
+    ASSERT_TRUE(queue.tryPop(message));
+    ASSERT_EQ(message.type, "progress");
+    ASSERT_EQ(message.get<float>(), 0.5f);
+    ASSERT_THROW(message.get<double>(), std::logic_error);
+}
+
+TEST_F(SpscQueueTest, ProducerConsumer)
+{
+    const auto numItems = 100000u;
+    SpscQueue<uint> queue(64);
+
+    std::thread producer([&]()
+    {
+        for (auto i = 0u; i < numItems; ++i)
+            while (!queue.tryPush(uint(i)))
+                std::this_thread::yield();
+    });
+
+    auto expected = 0u;
+    auto value = 0u;
+
+    while (expected < numItems)
+    {
+        if (!queue.tryPop(value))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        ASSERT_EQ(value, expected);
+        ++expected;
+    }
+
+    producer.join();
+
+    ASSERT_TRUE(queue.empty());
+}
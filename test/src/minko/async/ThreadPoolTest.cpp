@@ -0,0 +1,169 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "ThreadPoolTest.hpp"
+
+using namespace minko;
+using namespace minko::async;
+
+TEST_F(ThreadPoolTest, ParallelFor)
+{
+    auto pool = ThreadPool::create(3);
+    auto counts = std::vector<uint>(10000, 0u);
+
+    for (auto i = 0; i < 10; ++i)
+        pool->parallelFor(counts.size(), 16, [&](uint begin, uint end)
+        {
+            for (auto j = begin; j < end; ++j)
+                ++counts[j];
+        });
+
+    for (auto count : counts)
+        ASSERT_EQ(count, 10u);
+}
+
+TEST_F(ThreadPoolTest, ParallelForMinChunkSize)
+{
+    auto pool = ThreadPool::create(3);
+    std::mutex mutex;
+    auto ranges = std::vector<std::pair<uint, uint>>();
+
+    pool->parallelFor(1000, 300, [&](uint begin, uint end)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        ranges.push_back(std::make_pair(begin, end));
+    });
+
+    std::sort(ranges.begin(), ranges.end());
+
+    auto next = 0u;
+
+    for (auto& range : ranges)
+    {
+        ASSERT_EQ(range.first, next);
+        ASSERT_TRUE(range.second - range.first >= 300 || range.second == 1000);
+        next = range.second;
+    }
+    ASSERT_EQ(next, 1000u);
+}
+
+TEST_F(ThreadPoolTest, NestedParallelFor)
+{
+    auto pool = ThreadPool::create(3);
+    std::atomic<uint> sum(0);
+
+    pool->parallelFor(64, 1, [&](uint begin, uint end)
+    {
+        for (auto i = begin; i < end; ++i)
+            pool->parallelFor(100, 10, [&](uint b, uint e)
+            {
+                sum += e - b;
+            });
+    });
+
+    ASSERT_EQ(sum, 6400u);
+}
+
+TEST_F(ThreadPoolTest, ParallelForException)
+{
+    auto pool = ThreadPool::create(3);
+    std::atomic<uint> sum(0);
+    std::atomic<uint> failed(0);
+
+    ASSERT_THROW(pool->parallelFor(1000, 10, [&](uint begin, uint end)
+    {
+        if (begin <= 500 && 500 < end)
+        {
+            failed = end - begin;
+            throw std::runtime_error("chunk");
+        }
+
+        sum += end - begin;
+    }), std::runtime_error);
+
+    // the other chunks were still processed and the pool can be used again
+    ASSERT_EQ(sum + failed, 1000u);
+
+    sum = 0;
+    pool->parallelFor(1000, 10, [&](uint begin, uint end)
+    {
+        sum += end - begin;
+    });
+
+    ASSERT_EQ(sum, 1000u);
+}
+
+TEST_F(ThreadPoolTest, Enqueue)
+{
+    auto pool = ThreadPool::create(3);
+    std::atomic<uint> sum(0);
+    auto futures = std::vector<std::future<void>>();
+
+    for (auto i = 0u; i < 100; ++i)
+        futures.push_back(pool->enqueue([&, i]()
+        {
+            sum += i;
+        }));
+
+    for (auto& future : futures)
+        future.get();
+
+    ASSERT_EQ(sum, 4950u);
+}
+
+TEST_F(ThreadPoolTest, EnqueueParallelFor)
+{
+    auto pool = ThreadPool::create(3);
+    auto counts = std::vector<uint>(10000, 0u);
+    std::atomic<uint> sum(0);
+
+    // tasks running a parallelFor on the same pool, while the calling thread runs another one
+    auto future = pool->enqueue([&]()
+    {
+        pool->parallelFor(100, 10, [&](uint begin, uint end)
+        {
+            sum += end - begin;
+        });
+    });
+
+    pool->parallelFor(counts.size(), 16, [&](uint begin, uint end)
+    {
+        for (auto j = begin; j < end; ++j)
+            ++counts[j];
+    });
+
+    future.get();
+
+    ASSERT_EQ(sum, 100u);
+    for (auto count : counts)
+        ASSERT_EQ(count, 1u);
+}
+
+TEST_F(ThreadPoolTest, EnqueueException)
+{
+    auto pool = ThreadPool::create(1);
+    auto future = pool->enqueue([]()
+    {
+        throw std::runtime_error("task");
+    });
+
+    ASSERT_THROW(future.get(), std::runtime_error);
+}
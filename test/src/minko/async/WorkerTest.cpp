@@ -0,0 +1,137 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "WorkerTest.hpp"
+
+using namespace minko;
+using namespace minko::async;
+
+namespace
+{
+    MINKO_DECLARE_WORKER(CountingWorker)
+
+    MINKO_DEFINE_WORKER(CountingWorker,
+    {
+        uint numMessages;
+
+        std::memcpy(&numMessages, &input[0], sizeof(uint));
+
+        for (auto i = 0u; i < numMessages; ++i)
+            post(Message("progress", i));
+
+        post(Message("complete", std::vector<char>(input.begin() + sizeof(uint), input.end())));
+    });
+
+    MINKO_DECLARE_WORKER(ThrowingWorker)
+
+    MINKO_DEFINE_WORKER(ThrowingWorker,
+    {
+        throw std::runtime_error("ThrowingWorker");
+    });
+
+    void
+    pollUntilFinished(const std::list<Worker::Ptr>& workers)
+    {
+        auto numFinished = 0u;
+
+        while (numFinished != workers.size())
+        {
+            numFinished = 0;
+
+            for (auto& worker : workers)
+            {
+                worker->poll();
+                numFinished += worker->finished() ? 1 : 0;
+            }
+
+            std::this_thread::yield();
+        }
+    }
+}
+
+TEST_F(WorkerTest, Messages)
+{
+    // more messages than the queue can hold: post() has to wait for poll()
+    const auto numMessages = 5000u;
+    auto worker = CountingWorker::create("counting");
+    auto input = std::vector<char>(sizeof(uint));
+    auto next = 0u;
+    auto complete = std::string();
+
+    std::memcpy(&input[0], &numMessages, sizeof(uint));
+    input.insert(input.end(), { 'd', 'o', 'n', 'e' });
+
+    auto _ = worker->message()->connect([&](Worker::Ptr, const Worker::Message& message)
+    {
+        if (message.type == "progress")
+            ASSERT_EQ(message.get<uint>(), next++);
+        else if (message.type == "complete")
+            complete.assign(message.data.begin(), message.data.end());
+    });
+
+    ASSERT_FALSE(worker->finished());
+
+    worker->start(std::move(input));
+    pollUntilFinished({ worker });
+
+    ASSERT_EQ(next, numMessages);
+    ASSERT_EQ(complete, "done");
+}
+
+TEST_F(WorkerTest, ManyWorkers)
+{
+    auto workers = std::list<Worker::Ptr>();
+    auto slots = std::list<Worker::MessageSignal::Slot>();
+    auto numComplete = 0u;
+
+    for (auto i = 0u; i < 2000u; ++i)
+    {
+        auto worker = CountingWorker::create("counting");
+        auto input = std::vector<char>(sizeof(uint), 0);
+
+        slots.push_back(worker->message()->connect([&](Worker::Ptr, const Worker::Message& message)
+        {
+            if (message.type == "complete")
+                ++numComplete;
+        }));
+
+        worker->start(std::move(input));
+        workers.push_back(worker);
+    }
+
+    pollUntilFinished(workers);
+
+    ASSERT_EQ(numComplete, 2000u);
+}
+
+TEST_F(WorkerTest, Error)
+{
+    auto worker = ThrowingWorker::create("throwing");
+    auto error = false;
+
+    auto _ = worker->message()->connect([&](Worker::Ptr, const Worker::Message& message)
+    {
+        error = error || message.type == "error";
+    });
+
+    worker->start(std::vector<char>());
+    pollUntilFinished({ worker });
+
+    ASSERT_TRUE(error);
+}
@@ -0,0 +1,129 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/ClusteredLightingTest.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+namespace
+{
+    scene::Node::Ptr
+    createScene(ClusteredLighting::Ptr clusteredLighting, uint numLights)
+    {
+        auto root = scene::Node::create("root")
+            ->addComponent(SceneManager::create(MinkoTests::canvas()));
+        auto camera = scene::Node::create("camera")
+            ->addComponent(Renderer::create())
+            ->addComponent(PerspectiveCamera::create(16.f / 9.f, .785f, .1f, 100.f))
+            ->addComponent(clusteredLighting);
+
+        root->addChild(camera);
+
+        for (auto i = 0u; i < numLights; ++i)
+        {
+            auto light = PointLight::create();
+
+            light->range(2.f);
+            root->addChild(scene::Node::create()
+                ->addComponent(Transform::create(math::translate(math::vec3(
+                    (i % 25) * 2.f - 25.f, (i / 25) * 1.f - 10.f, -5.f - (i % 7) * 10.f
+                ))))
+                ->addComponent(light)
+            );
+        }
+
+        return root;
+    }
+}
+
+TEST_F(ClusteredLightingTest, Create)
+{
+    auto clusteredLighting = ClusteredLighting::create(16, 8, 24, 32);
+
+    ASSERT_EQ(clusteredLighting->clusters()->numClusters(), 16u * 8u * 24u);
+    ASSERT_EQ(clusteredLighting->data()->get<int>("clusteredLightingMaxLights"), 32);
+}
+
+TEST_F(ClusteredLightingTest, TooManyLightsPerClusterThrows)
+{
+    ASSERT_THROW(ClusteredLighting::create(16, 8, 24, 256), std::invalid_argument);
+}
+
+TEST_F(ClusteredLightingTest, AddToCamera)
+{
+    auto clusteredLighting = ClusteredLighting::create();
+    auto root = createScene(clusteredLighting, 0);
+    auto camera = root->children().front();
+
+    ASSERT_TRUE(camera->data().hasProperty("clusteredLightingMaxLights"));
+
+    camera->removeComponent(clusteredLighting);
+
+    ASSERT_FALSE(camera->data().hasProperty("clusteredLightingMaxLights"));
+}
+
+TEST_F(ClusteredLightingTest, BinLightsEveryFrame)
+{
+    auto clusteredLighting = ClusteredLighting::create();
+    auto root = createScene(clusteredLighting, 500);
+    auto camera = root->children().front();
+
+    root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+    ASSERT_EQ(clusteredLighting->numLights(), 500u);
+    ASSERT_FALSE(clusteredLighting->clusters()->lightIndices().empty());
+    ASSERT_TRUE(camera->data().hasProperty("clusteredLightingClusters"));
+    ASSERT_TRUE(camera->data().hasProperty("clusteredLightingIndices"));
+    ASSERT_TRUE(camera->data().hasProperty("clusteredLightingLights"));
+    ASSERT_EQ(
+        camera->data().get<math::vec2>("clusteredLightingLightsSize"),
+        math::vec2(ClusteredLighting::TEXTURE_WIDTH, 16.f)
+    );
+
+    root->removeChild(root->children().back());
+    root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+    ASSERT_EQ(clusteredLighting->numLights(), 499u);
+}
+
+TEST_F(ClusteredLightingTest, UnboundedLightsAndAttenuation)
+{
+    auto clusteredLighting = ClusteredLighting::create();
+    auto root = createScene(clusteredLighting, 2);
+    auto camera = root->children().front();
+    auto unboundedLight = PointLight::create(1.f, 1.f, .5f, .09f, .032f);
+
+    root->addChild(scene::Node::create()
+        ->addComponent(Transform::create(math::translate(math::vec3(0.f, 0.f, -10.f))))
+        ->addComponent(unboundedLight)
+    );
+    root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+    ASSERT_EQ(clusteredLighting->numLights(), 3u);
+    ASSERT_EQ(clusteredLighting->numUnboundedLights(), 1u);
+    // the largest attenuation coefficient is the quantization scale of the coefficients
+    ASSERT_FLOAT_EQ(camera->data().get<math::vec3>("clusteredLightingScales").z, .5f);
+
+    unboundedLight->range(3.f);
+    root->component<SceneManager>()->nextFrame(0.f, 0.f);
+
+    ASSERT_EQ(clusteredLighting->numUnboundedLights(), 0u);
+}
@@ -727,7 +727,10 @@ TEST_F(DirectionalLightTest, RenderersAndDrawCalls)
         int* depthTarget = shadowMappingDepthPass->states().target().id;
 
         ASSERT_EQ(depthTarget, nullptr);
-        ASSERT_EQ(drawCalls.count(std::tuple<float, int*>(render::States::DEFAULT_PRIORITY, depthTarget)), 1);
+        ASSERT_TRUE(std::any_of(drawCalls.begin(), drawCalls.end(), [&](render::DrawCall* drawCall)
+        {
+            return drawCall->priority() == render::States::DEFAULT_PRIORITY && drawCall->target().id == depthTarget;
+        }));
 
         ++rendererIndex;
     }
@@ -0,0 +1,89 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "minko/component/PickingTest.hpp"
+
+using namespace minko;
+using namespace minko::component;
+
+namespace
+{
+    scene::Node::Ptr
+    createCube(scene::Node::Ptr root, geometry::Geometry::Ptr geometry, const math::vec3& position)
+    {
+        auto cube = scene::Node::create()
+            ->addComponent(Transform::create(math::translate(position)))
+            ->addComponent(Surface::create(
+                geometry,
+                material::BasicMaterial::create(),
+                root->component<SceneManager>()->assets()->effect("effect/Basic.effect")
+            ));
+
+        root->addChild(cube);
+
+        return cube;
+    }
+}
+
+TEST_F(PickingTest, RayCast)
+{
+    auto canvas = MinkoTests::canvas();
+    auto sceneManager = SceneManager::create(canvas);
+    auto root = scene::Node::create("root")->addComponent(sceneManager);
+    auto camera = scene::Node::create("camera")
+        ->addComponent(Renderer::create())
+        ->addComponent(PerspectiveCamera::create(canvas->aspectRatio(), .785f, .1f, 100.f));
+
+    root->addChild(camera);
+
+    auto loader = sceneManager->assets()->loader();
+
+    loader->options()->loadAsynchronously(false);
+    loader->queue("effect/Basic.effect");
+    loader->load();
+
+    // the clone refits its own triangle hierarchy
+    auto geometry = geometry::CubeGeometry::create(canvas->context());
+    auto nearCube = createCube(root, geometry, math::vec3(0.f, 0.f, -5.f));
+    auto farCube = createCube(root, geometry->clone(), math::vec3(0.f, 0.f, -10.f));
+
+    auto picking = Picking::create(camera, true, true, nullptr, nullptr, PickingMode::RAY_CAST);
+    scene::Node::Ptr pickedNode = nullptr;
+    auto mouseOver = picking->mouseOver()->connect([&](scene::Node::Ptr node) { pickedNode = node; });
+
+    root->addComponent(picking);
+
+    auto mouse = canvas->mouse();
+
+    mouse->x(canvas->width() / 2);
+    mouse->y(canvas->height() / 2);
+    mouse->move()->execute(mouse, 0, 0);
+    sceneManager->nextFrame(0.f, 0.f);
+
+    ASSERT_EQ(pickedNode, nearCube);
+    ASSERT_EQ(picking->pickedSurface(), nearCube->component<Surface>());
+
+    nearCube->component<Transform>()->matrix(math::translate(math::vec3(10.f, 0.f, -5.f)));
+    mouse->x(canvas->width() / 2 + 1);
+    mouse->move()->execute(mouse, 1, 0);
+    sceneManager->nextFrame(0.f, 0.f);
+
+    ASSERT_EQ(pickedNode, farCube);
+}
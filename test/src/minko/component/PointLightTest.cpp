@@ -286,3 +286,21 @@ TEST_F(PointLightTest, Clone)
 
 	ASSERT_FALSE(l1->position() == l2->position());	
 }
+
+TEST_F(PointLightTest, Range)
+{
+	auto root = scene::Node::create("root");
+	auto lights = scene::Node::create("lights");
+	auto light = PointLight::create();
+
+	lights->addComponent(light);
+	root->addChild(lights);
+
+	ASSERT_TRUE(light->range() <= 0.f);
+	ASSERT_TRUE(root->data().get<float>("pointLight[0].range") <= 0.f);
+
+	light->range(10.f);
+
+	ASSERT_EQ(light->range(), 10.f);
+	ASSERT_EQ(root->data().get<float>("pointLight[0].range"), 10.f);
+}
@@ -296,27 +296,78 @@ TEST_F(RendererTest, SetEffect)
     root->addComponent(s);
 
     sceneManager->nextFrame(0.f, 0.f);
-    for (const auto& sortPropertiesToDrawCalls : renderer->drawCallPool().drawCalls())
-    {
-        for (const auto& drawCalls : sortPropertiesToDrawCalls.second)
-        {
-            for (auto drawCall : drawCalls)
-            {
-                ASSERT_EQ(drawCall->pass(), basic->technique("default")[0]);
-            }
-        }
-    }
+    for (auto drawCall : renderer->drawCallPool().drawCalls())
+        ASSERT_EQ(drawCall->pass(), basic->technique("default")[0]);
 
     renderer->effect(phong);
     sceneManager->nextFrame(0.f, 0.f);
-    for (const auto& sortPropertiesToDrawCalls : renderer->drawCallPool().drawCalls())
-    {
-        for (const auto& drawCalls : sortPropertiesToDrawCalls.second)
-        {
-            for (auto drawCall : drawCalls)
-            {
-                ASSERT_EQ(drawCall->pass(), phong->technique("default")[0]);
-            }
-        }
-    }
+    for (auto drawCall : renderer->drawCallPool().drawCalls())
+        ASSERT_EQ(drawCall->pass(), phong->technique("default")[0]);
+}
+
+TEST_F(RendererTest, MinimizeStateChanges)
+{
+    auto fx = MinkoTests::loadEffect("effect/Basic.effect");
+    auto renderer = Renderer::create();
+    auto root = scene::Node::create()
+        ->addComponent(SceneManager::create(MinkoTests::canvas()))
+        ->addComponent(PerspectiveCamera::create(1.f))
+        ->addComponent(renderer);
+
+    auto material = material::BasicMaterial::create();
+    material->diffuseColor(math::vec4(1.f));
+
+    auto geometry = geometry::CubeGeometry::create(MinkoTests::canvas()->context());
+
+    root->addComponent(Surface::create(geometry, material, fx));
+    root->addComponent(Surface::create(geometry, material, fx));
+
+    renderer->render(MinkoTests::canvas()->context());
+    ASSERT_EQ(renderer->numDrawCalls(), 2);
+    ASSERT_EQ(renderer->numSkippedStateChanges(), 0);
+
+    auto numStateChanges = renderer->numStateChanges();
+
+    renderer->minimizeStateChanges(true);
+    renderer->render(MinkoTests::canvas()->context());
+    ASSERT_EQ(renderer->numDrawCalls(), 2);
+    ASSERT_GT(renderer->numSkippedStateChanges(), 0);
+    ASSERT_EQ(renderer->numStateChanges() + renderer->numSkippedStateChanges(), numStateChanges);
+    ASSERT_LT(renderer->numStateChanges(), numStateChanges);
+}
+
+TEST_F(RendererTest, Instancing)
+{
+    auto fx = MinkoTests::loadEffect("effect/Basic.effect");
+    auto renderer = Renderer::create();
+    auto root = scene::Node::create()
+        ->addComponent(SceneManager::create(MinkoTests::canvas()))
+        ->addComponent(PerspectiveCamera::create(1.f))
+        ->addComponent(renderer);
+
+    auto material = material::BasicMaterial::create();
+    material->diffuseColor(math::vec4(1.f));
+
+    auto geometry = geometry::CubeGeometry::create(MinkoTests::canvas()->context());
+    auto numTriangles = geometry->indices()->numIndices() / 3;
+
+    for (auto i = 0; i < 10; ++i)
+        root->addChild(scene::Node::create()
+            ->addComponent(Transform::create(math::translate(math::vec3((float)i, 0.f, 0.f))))
+            ->addComponent(Surface::create(geometry, material, fx))
+        );
+
+    renderer->render(MinkoTests::canvas()->context());
+    ASSERT_EQ(renderer->numDrawCalls(), 10);
+    ASSERT_EQ(renderer->numTriangles(), 10 * numTriangles);
+
+    renderer->instancing(true);
+    renderer->render(MinkoTests::canvas()->context());
+
+    ASSERT_EQ(renderer->numDrawCalls(), MinkoTests::canvas()->context()->supportsInstancing() ? 1 : 10);
+    ASSERT_EQ(renderer->numTriangles(), 10 * numTriangles);
+
+    renderer->instancing(false);
+    renderer->render(MinkoTests::canvas()->context());
+    ASSERT_EQ(renderer->numDrawCalls(), 10);
 }
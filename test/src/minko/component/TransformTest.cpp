@@ -25,6 +25,46 @@ using namespace minko;
 using namespace minko::component;
 using namespace minko::scene;
 
+void
+TransformTest::checkModelToWorldMatrices(Node::Ptr root)
+{
+    auto nodes = NodeSet::create(root)->descendants(true);
+
+    for (auto node : nodes->nodes())
+    {
+        auto transform = node->component<Transform>();
+
+        if (transform == nullptr)
+            continue;
+
+        auto expected = transform->matrix();
+
+        for (auto ancestor = node->parent(); ancestor != nullptr; ancestor = ancestor->parent())
+            if (ancestor->hasComponent<Transform>())
+                expected = ancestor->component<Transform>()->matrix() * expected;
+
+        for (auto i = 0; i < 4; ++i)
+            for (auto j = 0; j < 4; ++j)
+                ASSERT_NEAR(transform->modelToWorldMatrix()[i][j], expected[i][j], 1e-3f);
+    }
+}
+
+std::vector<Node::Ptr>
+TransformTest::createTree(uint numNodes, uint numChildren)
+{
+    std::vector<Node::Ptr> nodes(1, Node::create("root")->addComponent(Transform::create()));
+
+    for (auto i = 1u; i < numNodes; ++i)
+    {
+        auto node = Node::create()->addComponent(Transform::create(math::translate(math::vec3(1.f, 0.f, 0.f))));
+
+        nodes[(i - 1) / numChildren]->addChild(node);
+        nodes.push_back(node);
+    }
+
+    return nodes;
+}
+
 TEST_F(TransformTest, UniqueRootTransform)
 {
 	auto root = Node::create();
@@ -614,3 +654,297 @@ TEST_F(TransformTest, EmptyAncestorPath)
     ASSERT_EQ(n100->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(4.f, 0.f, 0.f)));
     ASSERT_EQ(n101->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(6.f, 0.f, 0.f)));
 }
+
+TEST_F(TransformTest, ModelToWorldUpdateThroughNodesWithoutTransform)
+{
+    auto root = Node::create("root")->addComponent(Transform::create());
+    auto n0 = Node::create("n0");
+    auto n00 = Node::create("n00")->addComponent(Transform::create(math::translate(math::vec3(1.f, 0.f, 0.f))));
+    auto n01 = Node::create("n01")->addComponent(Transform::create(math::translate(math::vec3(2.f, 0.f, 0.f))));
+    auto n1 = Node::create("n1")->addComponent(Transform::create(math::translate(math::vec3(0.f, 3.f, 0.f))));
+    auto n010 = Node::create("n010")->addComponent(Transform::create(math::translate(math::vec3(0.f, 0.f, 4.f))));
+
+    root->addChild(n0);
+    root->addChild(n1);
+    n0->addChild(n00);
+    n0->addChild(n01);
+    n01->addChild(n010);
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(n010->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(2.f, 0.f, 4.f)));
+
+    root->component<Transform>()->matrix(math::translate(math::vec3(10.f, 0.f, 0.f)));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(n00->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(11.f, 0.f, 0.f)));
+    ASSERT_EQ(n01->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(12.f, 0.f, 0.f)));
+    ASSERT_EQ(n1->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(10.f, 3.f, 0.f)));
+    ASSERT_EQ(n010->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(12.f, 0.f, 4.f)));
+    ASSERT_EQ(n010->data().get<math::mat4>("modelToWorldMatrix"), math::translate(math::vec3(12.f, 0.f, 4.f)));
+}
+
+TEST_F(TransformTest, MatrixPropertyChanged)
+{
+    auto root = Node::create("root")->addComponent(Transform::create());
+    auto n0 = Node::create("n0")->addComponent(Transform::create());
+
+    root->addChild(n0);
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    n0->data().set("matrix", math::translate(math::vec3(0.f, 1.f, 0.f)));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(n0->component<Transform>()->modelToWorldMatrix(), math::translate(math::vec3(0.f, 1.f, 0.f)));
+}
+
+TEST_F(TransformTest, MatricesChanged)
+{
+    auto root = Node::create("root")->addComponent(Transform::create());
+    auto n0 = Node::create("n0")->addComponent(Transform::create());
+    auto n1 = Node::create("n1")->addComponent(Transform::create());
+    auto n10 = Node::create("n10")->addComponent(Transform::create());
+
+    root->addChild(n0);
+    root->addChild(n1);
+    n1->addChild(n10);
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    auto rootTransform = root->component<Transform::RootTransform>();
+    auto numExecutes = 0;
+    auto firstId = 0u;
+    auto lastId = 0u;
+    auto _ = rootTransform->matricesChanged()->connect(
+        [&](Transform::RootTransform::Ptr r, uint first, uint last)
+        {
+            ++numExecutes;
+            firstId = first;
+            lastId = last;
+        }
+    );
+
+    n1->component<Transform>()->matrix(math::translate(math::vec3(1.f, 0.f, 0.f)));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(numExecutes, 1);
+    ASSERT_EQ(rootTransform->numNodes(), 4u);
+    ASSERT_EQ(rootTransform->node(firstId), n1);
+    ASSERT_EQ(rootTransform->node(lastId - 1), n10);
+    ASSERT_EQ(lastId - firstId, 2u);
+    ASSERT_EQ(rootTransform->modelToWorldMatrix(lastId - 1), math::translate(math::vec3(1.f, 0.f, 0.f)));
+
+    // nothing changed
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(numExecutes, 1);
+}
+
+TEST_F(TransformTest, SimdMultiply)
+{
+    auto a = math::translate(math::vec3(1.f, 2.f, 3.f)) * math::rotate(.5f, math::vec3(0.f, 1.f, 0.f));
+    auto b = math::scale(math::vec3(2.f, 3.f, 4.f)) * math::rotate(1.2f, math::vec3(1.f, 0.f, 0.f));
+    math::mat4 result;
+
+    math::multiply(a, b, result);
+
+    for (auto i = 0; i < 4; ++i)
+        for (auto j = 0; j < 4; ++j)
+            ASSERT_FLOAT_EQ(result[i][j], (a * b)[i][j]);
+}
+
+// Disabled by default, run with --gtest_also_run_disabled_tests: the frame time is recorded as a
+// test property.
+TEST_F(TransformTest, DISABLED_UpdateBenchmark)
+{
+    const auto numNodes = 50000;
+    const auto numChildren = 4;
+    const auto numFrames = 50;
+
+    auto nodes = createTree(numNodes, numChildren);
+    auto root = nodes.front();
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    auto start = std::clock();
+
+    for (auto frame = 0; frame < numFrames; ++frame)
+    {
+        // animate one node out of 8 and the root, so every node has to be updated
+        for (auto i = 0; i < numNodes; i += 8)
+        {
+            auto transform = nodes[i]->component<Transform>();
+
+            transform->matrix(math::rotate(.01f * frame, math::vec3(0.f, 1.f, 0.f)) * transform->matrix());
+        }
+
+        root->component<Transform>()->updateModelToWorldMatrix();
+    }
+
+    auto time = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numFrames;
+
+    RecordProperty("msPerFrame", std::to_string(time));
+
+    auto leaf = nodes.back()->component<Transform>();
+    auto parent = nodes[(numNodes - 2) / numChildren]->component<Transform>();
+
+    ASSERT_EQ(leaf->modelToWorldMatrix(), parent->modelToWorldMatrix() * leaf->matrix());
+}
+
+TEST_F(TransformTest, AddSubtreeToExistingNode)
+{
+    auto nodes = createTree(20, 3);
+    auto root = nodes.front();
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    auto subtree = createTree(10, 2);
+
+    subtree.front()->component<Transform>()->matrix(math::translate(math::vec3(0.f, 5.f, 0.f)));
+    nodes[2]->addChild(subtree.front());
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(root->component<Transform::RootTransform>()->numNodes(), 30u);
+    checkModelToWorldMatrices(root);
+
+    nodes[2]->component<Transform>()->matrix(math::translate(math::vec3(0.f, 0.f, 2.f)));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    checkModelToWorldMatrices(root);
+}
+
+TEST_F(TransformTest, RemoveAndAddBackSubtree)
+{
+    auto nodes = createTree(20, 3);
+    auto root = nodes.front();
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    nodes[1]->removeChild(nodes[5]);
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(root->component<Transform::RootTransform>()->numNodes(), 16u);
+
+    nodes[3]->addChild(nodes[5]);
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(root->component<Transform::RootTransform>()->numNodes(), 20u);
+    checkModelToWorldMatrices(root);
+
+    nodes[3]->component<Transform>()->matrix(math::translate(math::vec3(0.f, 0.f, 2.f)));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    checkModelToWorldMatrices(root);
+}
+
+TEST_F(TransformTest, RemoveTransformWithDescendants)
+{
+    auto nodes = createTree(20, 3);
+    auto root = nodes.front();
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    nodes[1]->removeComponent(nodes[1]->component<Transform>());
+    root->component<Transform>()->matrix(math::translate(math::vec3(0.f, 3.f, 0.f)));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(root->component<Transform::RootTransform>()->numNodes(), 19u);
+    checkModelToWorldMatrices(root);
+
+    nodes[1]->addComponent(Transform::create(math::translate(math::vec3(0.f, 0.f, 7.f))));
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    ASSERT_EQ(root->component<Transform::RootTransform>()->numNodes(), 20u);
+    checkModelToWorldMatrices(root);
+}
+
+TEST_F(TransformTest, RandomMutations)
+{
+    auto nodes = createTree(200, 3);
+    auto root = nodes.front();
+    auto detached = std::vector<Node::Ptr>();
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    for (auto frame = 0; frame < 50; ++frame)
+    {
+        for (auto mutation = 0; mutation < 10; ++mutation)
+        {
+            auto node = nodes[1 + rand() % (nodes.size() - 1)];
+
+            switch (rand() % 4)
+            {
+            case 0:
+                if (node->parent() != nullptr && node->root() == root)
+                {
+                    node->parent()->removeChild(node);
+                    detached.push_back(node);
+                }
+                break;
+            case 1:
+                if (!detached.empty() && node->root() == root)
+                {
+                    node->addChild(detached.back());
+                    detached.pop_back();
+                }
+                break;
+            case 2:
+                if (node->hasComponent<Transform>())
+                    node->removeComponent(node->component<Transform>());
+                else
+                    node->addComponent(Transform::create(math::translate(math::vec3(0.f, 1.f, 0.f))));
+                break;
+            default:
+                if (node->hasComponent<Transform>())
+                    node->component<Transform>()->matrix(math::rotate(.1f, math::vec3(0.f, 0.f, 1.f)) * node->component<Transform>()->matrix());
+                break;
+            }
+        }
+
+        root->component<Transform>()->updateModelToWorldMatrix();
+
+        checkModelToWorldMatrices(root);
+        if (HasFatalFailure())
+            return;
+    }
+}
+
+// Disabled by default as well, for the cost of hierarchy changes.
+TEST_F(TransformTest, DISABLED_MutationBenchmark)
+{
+    const auto numNodes = 100000;
+    const auto numMutations = 100;
+    const auto numFrames = 50;
+
+    auto nodes = createTree(numNodes, 4);
+    auto root = nodes.front();
+    auto subtrees = std::vector<std::vector<Node::Ptr>>();
+
+    for (auto i = 0; i < numMutations / 2; ++i)
+        subtrees.push_back(createTree(8, 2));
+
+    root->component<Transform>()->updateModelToWorldMatrix();
+
+    auto start = std::clock();
+
+    // every frame, half of the mutations add a small subtree somewhere in the scene and the
+    // other half remove the subtrees added during the previous frame
+    for (auto frame = 0; frame < numFrames; ++frame)
+    {
+        for (auto& subtree : subtrees)
+        {
+            auto subtreeRoot = subtree.front();
+
+            if (subtreeRoot->parent() != nullptr)
+                subtreeRoot->parent()->removeChild(subtreeRoot);
+            nodes[rand() % numNodes]->addChild(subtreeRoot);
+        }
+
+        root->component<Transform>()->updateModelToWorldMatrix();
+    }
+
+    auto time = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numFrames;
+
+    RecordProperty("msPerFrame", std::to_string(time));
+
+    ASSERT_EQ(root->component<Transform::RootTransform>()->numNodes(), static_cast<uint>(numNodes + 8 * numMutations / 2));
+}
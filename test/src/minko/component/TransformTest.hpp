@@ -30,7 +30,15 @@ namespace minko
 		class TransformTest :
 			public ::testing::Test
 		{
-
+		protected:
+			// Checks the model to world matrix of every node below root against the product of
+			// the local matrices of its ancestors.
+			void
+			checkModelToWorldMatrices(scene::Node::Ptr root);
+
+			// Builds a tree of numNodes nodes with a Transform, each node having numChildren children.
+			std::vector<scene::Node::Ptr>
+			createTree(uint numNodes, uint numChildren);
 		};
 	}
 }
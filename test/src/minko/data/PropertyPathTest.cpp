@@ -0,0 +1,67 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PropertyPathTest.hpp"
+
+using namespace minko::data;
+
+TEST_F(PropertyPathTest, ProviderProperty)
+{
+    PropertyPath path("diffuseColor");
+
+    ASSERT_FALSE(path.isCollectionItem());
+    ASSERT_FALSE(path.hasVariables());
+    ASSERT_EQ(*path.token(), "diffuseColor");
+}
+
+TEST_F(PropertyPathTest, CollectionItemByIndex)
+{
+    PropertyPath path("material[3].diffuseColor");
+
+    ASSERT_TRUE(path.isCollectionItem());
+    ASSERT_FALSE(path.isUuid());
+    ASSERT_EQ(*path.collectionName(), "material");
+    ASSERT_EQ(path.index(), 3u);
+    ASSERT_EQ(*path.token(), "diffuseColor");
+}
+
+TEST_F(PropertyPathTest, CollectionItemByUuid)
+{
+    PropertyPath path("geometry[1234-abcd].position");
+
+    ASSERT_TRUE(path.isCollectionItem());
+    ASSERT_TRUE(path.isUuid());
+    ASSERT_EQ(*path.collectionName(), "geometry");
+    ASSERT_EQ(path.uuid(), "1234-abcd");
+    ASSERT_EQ(*path.token(), "position");
+}
+
+TEST_F(PropertyPathTest, Resolve)
+{
+    PropertyPath::FStringList variables = {
+        { PropertyPath::FString("geometryUuid"), PropertyPath::FString("1234-abcd") },
+        { PropertyPath::FString("i"), PropertyPath::FString("2") }
+    };
+
+    PropertyPath path("geometry[${geometryUuid}].uv$i");
+
+    ASSERT_TRUE(path.hasVariables());
+    ASSERT_EQ(path.resolve(variables), "geometry[1234-abcd].uv2");
+    ASSERT_EQ(path.resolve(PropertyPath::FStringList()), "geometry[${geometryUuid}].uv$i");
+}
@@ -264,6 +264,90 @@ TEST_F(StoreTest, getCollectionNth)
     ASSERT_EQ(c.get<int>("test[2].foo"), 424242);
 }
 
+TEST_F(StoreTest, getCollectionNthManyPaths)
+{
+    Store c;
+    auto cc = Collection::create("test");
+
+    c.addCollection(cc);
+    for (auto i = 0; i < 1000; ++i)
+    {
+        auto p = Provider::create();
+
+        p->set("foo", i);
+        cc->pushBack(p);
+    }
+
+    // more distinct paths than the store keeps parsed, twice
+    for (auto pass = 0; pass < 2; ++pass)
+        for (auto i = 0; i < 1000; ++i)
+            ASSERT_EQ(c.get<int>("test[" + std::to_string(i) + "].foo"), i);
+}
+
+TEST_F(StoreTest, getCollectionItemByUuid)
+{
+    Store c;
+    auto p0 = Provider::create();
+    auto p1 = Provider::create();
+    auto cc = Collection::create("test");
+
+    p0->set("foo", 42);
+    p1->set("foo", 4242);
+    c.addCollection(cc);
+    cc->pushBack(p0);
+    cc->pushBack(p1);
+
+    ASSERT_EQ(c.get<int>("test[" + p0->uuid() + "].foo"), 42);
+    ASSERT_EQ(c.get<int>("test[" + p1->uuid() + "].foo"), 4242);
+    ASSERT_FALSE(c.hasProperty("test[" + p1->uuid() + "].bar"));
+
+    cc->remove(p0);
+
+    ASSERT_FALSE(c.hasProperty("test[" + p0->uuid() + "].foo"));
+    ASSERT_EQ(c.get<int>("test[" + p1->uuid() + "].foo"), 4242);
+    ASSERT_EQ(c.get<int>("test[0].foo"), 4242);
+
+    c.removeCollection(cc);
+
+    ASSERT_FALSE(c.hasProperty("test[" + p1->uuid() + "].foo"));
+}
+
+TEST_F(StoreTest, getCollectionItemFromSameNameCollections)
+{
+    Store c;
+    auto p0 = Provider::create();
+    auto p1 = Provider::create();
+    auto c0 = Collection::create("test");
+    auto c1 = Collection::create("test");
+
+    p0->set("foo", 42);
+    p1->set("foo", 4242);
+    c0->pushBack(p0);
+    c1->pushBack(p1);
+    c.addCollection(c0);
+    c.addCollection(c1);
+
+    ASSERT_EQ(c.get<int>("test[0].foo"), 42);
+
+    c.removeCollection(c0);
+
+    ASSERT_EQ(c.get<int>("test[0].foo"), 4242);
+    ASSERT_EQ(c.get<int>("test[" + p1->uuid() + "].foo"), 4242);
+}
+
+TEST_F(StoreTest, getActualPropertyName)
+{
+    std::list<std::pair<Store::PropertyName, Store::PropertyName>> variables = {
+        { Store::PropertyName("materialUuid"), Store::PropertyName("a-b") },
+        { Store::PropertyName("lightId"), Store::PropertyName("2") }
+    };
+
+    ASSERT_EQ(Store::getActualPropertyName(variables, "diffuseColor"), "diffuseColor");
+    ASSERT_EQ(Store::getActualPropertyName(variables, "material[${materialUuid}].diffuseColor"), "material[a-b].diffuseColor");
+    ASSERT_EQ(Store::getActualPropertyName(variables, "light[$lightId].color"), "light[2].color");
+    ASSERT_EQ(Store::getActualPropertyName(variables, "geometry[${geometryUuid}].indices"), "geometry[${geometryUuid}].indices");
+}
+
 TEST_F(StoreTest, collectionPropertyAdded)
 {
     Store c;
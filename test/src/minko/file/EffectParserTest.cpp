@@ -36,6 +36,28 @@ EffectParserTest::loadEffect(const std::string& filename)
     return lib->effect(filename);
 }
 
+EffectParser::Ptr
+EffectParserTest::parseEffect(const std::string& filename, AssetLibrary::Ptr assets)
+{
+    auto parser = EffectParser::create();
+    auto loader = Loader::create(assets->loader());
+    auto options = loader->options()->clone()->parserFunction([](const std::string&) -> AbstractParser::Ptr
+    {
+        return nullptr;
+    });
+
+    auto complete = loader->complete()->connect([&](Loader::Ptr completeLoader)
+    {
+        auto file = completeLoader->files().at(filename);
+
+        parser->parse(filename, file->resolvedFilename(), assets->loader()->options(), file->data(), assets);
+    });
+
+    loader->queue(filename, options)->load();
+
+    return parser;
+}
+
 /******************/
 /*** Attributes ***/
 /******************/
@@ -2509,3 +2531,104 @@ TEST_F(EffectParserTest, ExtendedPassOverridesMacroDefault)
     ASSERT_EQ(fx->techniques().at("default")[1]->macroBindings().types["FOO"], data::MacroBindingMap::MacroType::INT);
     ASSERT_EQ(fx->techniques().at("default")[1]->macroBindings().defaultValues.get<int>("FOO"), 23);
 }
+
+/**********************/
+/*** Binary effects ***/
+/**********************/
+
+TEST_F(EffectParserTest, BinaryEffect)
+{
+    auto assets = AssetLibrary::create(MinkoTests::canvas()->context());
+    auto parser = parseEffect("effect/uniform/binding/OneUniformBindingAndDefault.effect", assets);
+    auto binaryEffect = parser->binaryEffect();
+
+    ASSERT_TRUE(EffectParser::isBinaryEffect(binaryEffect));
+
+    auto binaryParser = EffectParser::create();
+
+    binaryParser->parse("OneUniformBindingAndDefault.effect", "OneUniformBindingAndDefault.effect", assets->loader()->options(), binaryEffect, assets);
+
+    auto fx = parser->effect();
+    auto binaryFx = binaryParser->effect();
+
+    ASSERT_NE(binaryFx, nullptr);
+    ASSERT_EQ(binaryFx->techniques().size(), 1);
+    ASSERT_EQ(binaryFx->techniques().at("default").size(), 1);
+
+    auto pass = fx->techniques().at("default")[0];
+    auto binaryPass = binaryFx->techniques().at("default")[0];
+
+    ASSERT_EQ(binaryPass->uniformBindings().bindings.at("uDiffuseColor").propertyName, "diffuseColor");
+    ASSERT_EQ(binaryPass->uniformBindings().defaultValues.get<math::vec4>("uDiffuseColor"), pass->uniformBindings().defaultValues.get<math::vec4>("uDiffuseColor"));
+    // the include of the vertex shader is expanded
+    ASSERT_EQ(binaryPass->program()->vertexShader()->source(), pass->program()->vertexShader()->source());
+    ASSERT_EQ(binaryPass->program()->fragmentShader()->source(), pass->program()->fragmentShader()->source());
+}
+
+TEST_F(EffectParserTest, InvalidBinaryEffect)
+{
+    auto assets = AssetLibrary::create(MinkoTests::canvas()->context());
+    auto binaryEffect = parseEffect("effect/uniform/binding/OneUniformBindingAndDefault.effect", assets)->binaryEffect();
+    auto parser = EffectParser::create();
+    auto numErrors = 0;
+    auto error = parser->error()->connect([&](AbstractParser::Ptr, const Error&) { ++numErrors; });
+
+    binaryEffect.resize(binaryEffect.size() / 2);
+    parser->parse("Invalid.effect", "Invalid.effect", assets->loader()->options(), binaryEffect, assets);
+
+    ASSERT_EQ(numErrors, 1);
+    ASSERT_EQ(parser->effect(), nullptr);
+}
+
+TEST_F(EffectParserTest, EffectCacheEnabledByDefault)
+{
+    ASSERT_NE(EffectCache::defaultCache(), nullptr);
+}
+
+TEST_F(EffectParserTest, EffectCacheIncludeChanged)
+{
+    auto defaultCache = EffectCache::defaultCache();
+    auto cache = EffectCache::create();
+    auto filename = "effect/uniform/binding/OneUniformBindingAndDefault.effect";
+    auto include = std::string("void main(void) { gl_Position = vec4(1.0); }\n");
+    auto changedInclude = std::string("void main(void) { gl_Position = vec4(2.0); }\n");
+
+    EffectCache::defaultCache(cache);
+
+    auto assets = AssetLibrary::create(MinkoTests::canvas()->context());
+    auto changedAssets = AssetLibrary::create(MinkoTests::canvas()->context());
+
+    assets->blob("../../dummy.glsl", std::vector<unsigned char>(include.begin(), include.end()));
+    changedAssets->blob("../../dummy.glsl", std::vector<unsigned char>(changedInclude.begin(), changedInclude.end()));
+
+    auto fx = MinkoTests::loadEffect(filename, assets);
+    auto changedFx = MinkoTests::loadEffect(filename, changedAssets);
+
+    EffectCache::defaultCache(defaultCache);
+
+    ASSERT_EQ(cache->numBinaryEffects(), 1u);
+    ASSERT_NE(changedFx, nullptr);
+    ASSERT_NE(fx->techniques().at("default")[0]->program()->vertexShader()->source().find("vec4(1.0)"), std::string::npos);
+    ASSERT_NE(changedFx->techniques().at("default")[0]->program()->vertexShader()->source().find("vec4(2.0)"), std::string::npos);
+}
+
+TEST_F(EffectParserTest, EffectCacheReload)
+{
+    auto defaultCache = EffectCache::defaultCache();
+    auto cache = EffectCache::create();
+
+    EffectCache::defaultCache(cache);
+
+    auto fx = MinkoTests::loadEffect("effect/uniform/binding/OneUniformBindingAndDefault.effect");
+    auto cachedFx = MinkoTests::loadEffect("effect/uniform/binding/OneUniformBindingAndDefault.effect");
+
+    EffectCache::defaultCache(defaultCache);
+
+    ASSERT_EQ(cache->numBinaryEffects(), 1u);
+    ASSERT_NE(cachedFx, nullptr);
+    ASSERT_NE(cachedFx, fx);
+    ASSERT_EQ(
+        cachedFx->techniques().at("default")[0]->program()->vertexShader()->source(),
+        fx->techniques().at("default")[0]->program()->vertexShader()->source()
+    );
+}
@@ -34,6 +34,11 @@ namespace minko
             render::Effect::Ptr
             loadEffect(const std::string& filename);
 
+            // Parses filename with a parser of its own, the file being loaded as a blob.
+            static
+            EffectParser::Ptr
+            parseEffect(const std::string& filename, AssetLibrary::Ptr assets);
+
             template<typename T>
             void
             checkStateBindingWithDefaultValue(const std::string& effectFile, 
@@ -0,0 +1,135 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "gtest/gtest.h"
+
+#include "minko/MinkoTests.hpp"
+
+#include "minko/component/Surface.hpp"
+#include "minko/file/AssetLibrary.hpp"
+#include "minko/file/HashVertexWelder.hpp"
+#include "minko/file/HashVertexWelderTest.hpp"
+#include "minko/geometry/SphereGeometry.hpp"
+#include "minko/material/Material.hpp"
+#include "minko/scene/Node.hpp"
+
+using namespace minko;
+using namespace minko::file;
+
+scene::Node::Ptr
+HashVertexWelderTest::createScene()
+{
+    auto root = scene::Node::create("root")
+        ->addComponent(component::SceneManager::create(MinkoTests::canvas()));
+
+    auto context = MinkoTests::canvas()->context();
+    auto sphere = geometry::SphereGeometry::create(context, 20);
+    const auto& sphereIndices = sphere->indices()->data();
+    auto meshGeometry = geometry::Geometry::create();
+
+    for (auto sphereVertexBuffer : sphere->vertexBuffers())
+    {
+        const auto vertexSize = sphereVertexBuffer->vertexSize();
+        auto data = std::vector<float>();
+
+        for (auto index : sphereIndices)
+            data.insert(
+                data.end(),
+                sphereVertexBuffer->data().begin() + index * vertexSize,
+                sphereVertexBuffer->data().begin() + (index + 1) * vertexSize
+            );
+
+        auto vertexBuffer = render::VertexBuffer::create(context, data);
+
+        for (const auto& attribute : sphereVertexBuffer->attributes())
+            vertexBuffer->addAttribute(*attribute.name, attribute.size, attribute.offset);
+
+        meshGeometry->addVertexBuffer(vertexBuffer);
+    }
+
+    auto indices = std::vector<unsigned short>(sphereIndices.size());
+
+    for (auto i = 0u; i < indices.size(); ++i)
+        indices[i] = i;
+
+    meshGeometry->indices(render::IndexBuffer::create(context, indices));
+
+    auto mesh = scene::Node::create("mesh")
+        ->addComponent(component::Surface::create(
+            meshGeometry,
+            material::Material::create(),
+            nullptr
+        ));
+
+    root->addChild(mesh);
+
+    return root;
+}
+
+TEST_F(HashVertexWelderTest, Create)
+{
+    auto vertexWelder = HashVertexWelder::create();
+}
+
+TEST_F(HashVertexWelderTest, Process)
+{
+    auto scene = createScene();
+
+    auto geometry = scene->children()[0u]->component<component::Surface>()->geometry();
+    const auto numIndices = geometry->indices()->numIndices();
+
+    auto vertexWelder = HashVertexWelder::create();
+
+    vertexWelder->process(scene, scene->component<component::SceneManager>()->assets());
+
+    ASSERT_LT(geometry->numVertices(), numIndices);
+    ASSERT_EQ(geometry->indices()->numIndices(), numIndices);
+    ASSERT_FLOAT_EQ(vertexWelder->progressRate(), 1.f);
+}
+
+TEST_F(HashVertexWelderTest, NodePredicateFunction)
+{
+    auto scene = createScene();
+
+    auto geometry = scene->children()[0u]->component<component::Surface>()->geometry();
+    const auto numVertices = geometry->numVertices();
+
+    auto vertexWelder = HashVertexWelder::create()
+        ->nodePredicateFunction([](scene::Node::Ptr node) -> bool { return node->name() != "mesh"; });
+
+    vertexWelder->process(scene, scene->component<component::SceneManager>()->assets());
+
+    ASSERT_EQ(geometry->numVertices(), numVertices);
+}
+
+TEST_F(HashVertexWelderTest, Epsilon)
+{
+    auto exactScene = createScene();
+    auto scene = createScene();
+
+    auto exactGeometry = exactScene->children()[0u]->component<component::Surface>()->geometry();
+    auto geometry = scene->children()[0u]->component<component::Surface>()->geometry();
+
+    HashVertexWelder::create()->process(exactScene, exactScene->component<component::SceneManager>()->assets());
+    HashVertexWelder::create(10.f)->process(scene, scene->component<component::SceneManager>()->assets());
+
+    // every attribute of the unit sphere falls in the same cell
+    ASSERT_EQ(geometry->numVertices(), 1u);
+    ASSERT_GT(exactGeometry->numVertices(), 1u);
+}
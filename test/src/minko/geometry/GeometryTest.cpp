@@ -25,6 +25,45 @@ using namespace minko;
 using namespace minko::geometry;
 using namespace minko::render;
 
+bool
+GeometryTest::castAllTriangles(Geometry::Ptr geometry, math::Ray::Ptr ray, float& distance, uint& triangle)
+{
+	const auto& indices = geometry->indices()->data();
+	auto xyzBuffer = geometry->vertexBuffer("position");
+	const auto& xyzData = xyzBuffer->data();
+	auto hit = false;
+
+	distance = std::numeric_limits<float>::infinity();
+
+	for (uint i = 0; i < indices.size(); i += 3)
+	{
+		auto v0 = math::make_vec3(&xyzData[indices[i] * xyzBuffer->vertexSize()]);
+		auto edge1 = math::make_vec3(&xyzData[indices[i + 1] * xyzBuffer->vertexSize()]) - v0;
+		auto edge2 = math::make_vec3(&xyzData[indices[i + 2] * xyzBuffer->vertexSize()]) - v0;
+
+		auto pvec = math::cross(ray->direction(), edge2);
+		auto dot = math::dot(edge1, pvec);
+
+		if (std::abs(dot) < 0.00001f)
+			continue;
+
+		auto tvec = ray->origin() - v0;
+		auto u = math::dot(tvec, pvec) / dot;
+		auto qvec = math::cross(tvec, edge1);
+		auto v = math::dot(ray->direction(), qvec) / dot;
+		auto t = math::dot(edge2, qvec) / dot;
+
+		if (u >= 0.f && v >= 0.f && u + v <= 1.f && t > 0.f && t < distance)
+		{
+			distance = t;
+			triangle = i;
+			hit = true;
+		}
+	}
+
+	return hit;
+}
+
 TEST_F(GeometryTest, Create)
 {
 	try
@@ -426,3 +465,317 @@ TEST_F(GeometryTest, ComputeExistingNormals)
     ASSERT_EQ(normalData.size(), expectedNormalData.size());
     ASSERT_TRUE(std::equal(normalData.begin(), normalData.end(), expectedNormalData.begin()));
 }
+
+TEST_F(GeometryTest, Cast)
+{
+	auto sphere = SphereGeometry::create(MinkoTests::canvas()->context(), 40);
+	auto numHits = 0;
+
+	for (auto i = 0; i < 500; ++i)
+	{
+		auto origin = math::normalize(math::vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100) + math::vec3(.5f)) * 2.f;
+		auto target = math::vec3(rand() % 100 - 50, rand() % 100 - 50, rand() % 100 - 50) / 100.f;
+		auto ray = math::Ray::create(origin, math::normalize(target - origin));
+
+		auto expectedDistance = 0.f;
+		uint expectedTriangle = 0;
+		auto expectedHit = castAllTriangles(sphere, ray, expectedDistance, expectedTriangle);
+
+		auto distance = 0.f;
+		uint triangle = 0;
+		auto hitXyz = math::vec3();
+
+		ASSERT_EQ(sphere->cast(ray, distance, triangle, &hitXyz), expectedHit);
+		if (!expectedHit)
+			continue;
+
+		++numHits;
+		ASSERT_EQ(triangle, expectedTriangle);
+		ASSERT_FLOAT_EQ(distance, expectedDistance);
+		ASSERT_NEAR(math::length(hitXyz), .5f, .01f);
+	}
+
+	ASSERT_GT(numHits, 0);
+}
+
+TEST_F(GeometryTest, CastAfterInvalidateTriangleHierarchy)
+{
+	auto quad = QuadGeometry::create(MinkoTests::canvas()->context());
+	auto ray = math::Ray::create(math::vec3(0.f, 0.f, 10.f), math::vec3(0.f, 0.f, -1.f));
+	auto distance = 0.f;
+	uint triangle = 0;
+
+	ASSERT_TRUE(quad->cast(ray, distance, triangle));
+	ASSERT_FLOAT_EQ(distance, 10.f);
+
+	// positions modified in place, as the software skinning does
+	auto xyzBuffer = quad->vertexBuffer("position");
+	auto& xyzData = xyzBuffer->data();
+
+	for (uint i = 0; i < quad->numVertices(); ++i)
+		xyzData[i * xyzBuffer->vertexSize() + 2] = 5.f;
+	quad->invalidateTriangleHierarchy();
+
+	ASSERT_TRUE(quad->cast(ray, distance, triangle));
+	ASSERT_FLOAT_EQ(distance, 5.f);
+}
+
+TEST_F(GeometryTest, CastUnsignedIntIndices)
+{
+	auto quad = QuadGeometry::create(MinkoTests::canvas()->context());
+	auto ray = math::Ray::create(math::vec3(.2f, -.1f, 10.f), math::vec3(0.f, 0.f, -1.f));
+	auto expectedDistance = 0.f;
+	uint expectedTriangle = 0;
+	auto expectedUv = math::vec2();
+
+	ASSERT_TRUE(quad->cast(ray, expectedDistance, expectedTriangle, nullptr, &expectedUv));
+
+	const auto& indices = quad->indices()->data();
+
+	quad->indices(render::IndexBuffer::create(
+		MinkoTests::canvas()->context(),
+		std::vector<unsigned int>(indices.begin(), indices.end())
+	));
+
+	ASSERT_TRUE(quad->indices()->unsignedIntIndices());
+	ASSERT_THROW(quad->indices()->data(), std::logic_error);
+
+	auto distance = 0.f;
+	uint triangle = 0;
+	auto uv = math::vec2();
+
+	ASSERT_TRUE(quad->cast(ray, distance, triangle, nullptr, &uv));
+	ASSERT_EQ(triangle, expectedTriangle);
+	ASSERT_FLOAT_EQ(distance, expectedDistance);
+	ASSERT_FLOAT_EQ(uv.x, expectedUv.x);
+	ASSERT_FLOAT_EQ(uv.y, expectedUv.y);
+}
+
+TEST_F(GeometryTest, CastRayPacket)
+{
+	auto sphere = SphereGeometry::create(MinkoTests::canvas()->context(), 40);
+	auto numHits = 0;
+
+	for (auto i = 0; i < 200; ++i)
+	{
+		const uint numRays = i % 4 + 1;
+		auto origin = math::normalize(math::vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100) + math::vec3(.5f)) * 2.f;
+		auto target = math::vec3(rand() % 100 - 50, rand() % 100 - 50, rand() % 100 - 50) / 100.f;
+		math::vec3 origins[4];
+		math::vec3 directions[4];
+		float distances[4];
+		uint triangles[4];
+
+		for (uint j = 0; j < numRays; ++j)
+		{
+			origins[j] = origin + math::vec3(j % 2, j / 2, 0.f) * .05f;
+			directions[j] = math::normalize(target - origins[j]);
+			distances[j] = std::numeric_limits<float>::infinity();
+		}
+
+		auto hitRays = sphere->castRayPacket(origins, directions, numRays, distances, triangles);
+
+		ASSERT_EQ(hitRays >> numRays, 0u);
+
+		for (uint j = 0; j < numRays; ++j)
+		{
+			auto distance = 0.f;
+			uint triangle = 0;
+			auto hit = sphere->cast(math::Ray::create(origins[j], directions[j]), distance, triangle);
+
+			ASSERT_EQ((hitRays & (1u << j)) != 0u, hit);
+			if (!hit)
+				continue;
+
+			++numHits;
+			ASSERT_EQ(triangles[j], triangle);
+			ASSERT_NEAR(distances[j], distance, 1e-5f);
+		}
+	}
+
+	ASSERT_GT(numHits, 0);
+}
+
+// Cost of a ray cast testing every triangle against the triangle hierarchy. Disabled by default,
+// the timings are recorded as test properties.
+TEST_F(GeometryTest, DISABLED_CastBenchmark)
+{
+	const auto numRays = 1000;
+	auto sphere = SphereGeometry::create(MinkoTests::canvas()->context(), 100);
+	auto rays = std::vector<math::Ray::Ptr>();
+
+	for (auto i = 0; i < numRays; ++i)
+	{
+		auto origin = math::normalize(math::vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100) + math::vec3(.5f)) * 2.f;
+
+		rays.push_back(math::Ray::create(origin, math::normalize(-origin)));
+	}
+
+	auto distance = 0.f;
+	uint triangle = 0;
+	auto numHits = 0;
+	auto start = std::clock();
+
+	for (auto& ray : rays)
+		numHits += castAllTriangles(sphere, ray, distance, triangle) ? 1 : 0;
+
+	auto allTrianglesTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numRays;
+
+	start = std::clock();
+	sphere->triangleHierarchy();
+
+	auto buildTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC;
+
+	start = std::clock();
+	for (auto& ray : rays)
+		numHits -= sphere->cast(ray, distance, triangle) ? 1 : 0;
+
+	auto hierarchyTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numRays;
+
+	ASSERT_EQ(numHits, 0);
+
+	RecordProperty("msPerRayAllTriangles", std::to_string(allTrianglesTime));
+	RecordProperty("msPerRayHierarchy", std::to_string(hierarchyTime));
+	RecordProperty("msHierarchyBuild", std::to_string(buildTime));
+}
+
+TEST_F(GeometryTest, WeldVertices)
+{
+	auto sphere = SphereGeometry::create(MinkoTests::canvas()->context(), 20);
+	const auto& sphereIndices = sphere->indices()->data();
+	auto soup = Geometry::create();
+	auto rows = std::vector<std::vector<float>>(sphereIndices.size());
+
+	// one vertex per index
+	for (auto sphereVertexBuffer : sphere->vertexBuffers())
+	{
+		const auto vertexSize = sphereVertexBuffer->vertexSize();
+		const auto& sphereData = sphereVertexBuffer->data();
+		auto data = std::vector<float>();
+
+		for (uint i = 0; i < sphereIndices.size(); ++i)
+		{
+			auto begin = sphereData.begin() + sphereIndices[i] * vertexSize;
+
+			data.insert(data.end(), begin, begin + vertexSize);
+			rows[i].insert(rows[i].end(), begin, begin + vertexSize);
+		}
+
+		auto vertexBuffer = VertexBuffer::create(MinkoTests::canvas()->context(), data);
+
+		for (const auto& attribute : sphereVertexBuffer->attributes())
+			vertexBuffer->addAttribute(*attribute.name, attribute.size, attribute.offset);
+		soup->addVertexBuffer(vertexBuffer);
+	}
+
+	auto indices = std::vector<unsigned short>(sphereIndices.size());
+
+	for (uint i = 0; i < indices.size(); ++i)
+		indices[i] = i;
+	soup->indices(IndexBuffer::create(MinkoTests::canvas()->context(), indices));
+
+	soup->weldVertices();
+
+	ASSERT_EQ(soup->numVertices(), std::set<std::vector<float>>(rows.begin(), rows.end()).size());
+
+	const auto& soupIndices = soup->indices()->data();
+
+	for (uint i = 0; i < soupIndices.size(); ++i)
+	{
+		auto row = std::vector<float>();
+
+		for (auto vertexBuffer : soup->vertexBuffers())
+		{
+			auto begin = vertexBuffer->data().begin() + soupIndices[i] * vertexBuffer->vertexSize();
+
+			ASSERT_EQ(vertexBuffer->numVertices(), soup->numVertices());
+			row.insert(row.end(), begin, begin + vertexBuffer->vertexSize());
+		}
+
+		ASSERT_EQ(row, rows[i]);
+	}
+}
+
+TEST_F(GeometryTest, WeldVerticesEpsilon)
+{
+	auto quads = std::vector<float>
+	{
+		0.f, 0.f, 0.f,			1.f, 0.f, 0.f,			1.f, 1.f, 0.f,			0.f, 1.f, 0.f,
+		0.0001f, 0.f, 0.f,		1.f, -0.f, 0.0001f,		1.0001f, 1.f, 0.f,		0.f, 0.9999f, 0.f
+	};
+	auto indices = std::vector<unsigned short> { 0, 1, 2, 0, 2, 3, 4, 5, 6, 4, 6, 7 };
+	auto vertices = std::vector<std::vector<float>> { quads };
+
+	ASSERT_EQ(Geometry::weldVertices(indices, vertices, 8), 8u);
+	ASSERT_EQ(Geometry::weldVertices(indices, vertices, 8, 0.001f), 4u);
+	ASSERT_EQ(vertices[0].size(), 12u);
+	ASSERT_EQ(indices, std::vector<unsigned short>({ 0, 1, 2, 0, 2, 3, 0, 1, 2, 0, 2, 3 }));
+}
+
+TEST_F(GeometryTest, WeldVerticesUnsignedIntIndices)
+{
+	const uint numVertices = 40000;
+	auto positions = std::vector<float>(2 * 3 * numVertices);
+	auto uvs = std::vector<float>(2 * 2 * numVertices);
+	auto indices = std::vector<unsigned int>(2 * numVertices);
+
+	// vertices i and i + numVertices are the same
+	for (uint i = 0; i < 2 * numVertices; ++i)
+	{
+		const auto v = i % numVertices;
+
+		positions[i * 3] = float(v % 200);
+		positions[i * 3 + 1] = float(v / 200);
+		positions[i * 3 + 2] = 0.f;
+		uvs[i * 2] = float(v % 200) / 200.f;
+		uvs[i * 2 + 1] = float(v / 200) / 200.f;
+		indices[i] = 2 * numVertices - 1 - i;
+	}
+
+	auto vertices = std::vector<std::vector<float>> { positions, uvs };
+
+	ASSERT_EQ(Geometry::weldVertices(indices, vertices, 2 * numVertices), numVertices);
+	ASSERT_EQ(vertices[0].size(), 3 * numVertices);
+	ASSERT_EQ(vertices[1].size(), 2 * numVertices);
+
+	for (uint i = 0; i < indices.size(); ++i)
+	{
+		const auto v = (2 * numVertices - 1 - i) % numVertices;
+
+		ASSERT_EQ(indices[i], v);
+		ASSERT_EQ(vertices[0][v * 3], positions[v * 3]);
+		ASSERT_EQ(vertices[1][v * 2 + 1], uvs[v * 2 + 1]);
+	}
+}
+
+// Welds the unindexed vertices of a dense sphere. Disabled by default, the welding time and the
+// resulting vertex count are recorded as test properties.
+TEST_F(GeometryTest, DISABLED_WeldVerticesBenchmark)
+{
+	auto sphere = SphereGeometry::create(MinkoTests::canvas()->context(), 200);
+	const auto& sphereIndices = sphere->indices()->data();
+	auto vertices = std::vector<std::vector<float>>();
+	auto indices = std::vector<unsigned int>(sphereIndices.size());
+
+	for (auto vertexBuffer : sphere->vertexBuffers())
+	{
+		const auto vertexSize = vertexBuffer->vertexSize();
+		auto data = std::vector<float>();
+
+		for (auto index : sphereIndices)
+			data.insert(data.end(), vertexBuffer->data().begin() + index * vertexSize, vertexBuffer->data().begin() + (index + 1) * vertexSize);
+		vertices.push_back(data);
+	}
+
+	for (uint i = 0; i < indices.size(); ++i)
+		indices[i] = i;
+
+	auto start = std::chrono::high_resolution_clock::now();
+	auto numVertices = Geometry::weldVertices(indices, vertices, indices.size());
+	auto weldTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	ASSERT_LE(numVertices, sphere->numVertices());
+
+	RecordProperty("weldedVertices", static_cast<int>(numVertices));
+	RecordProperty("msWeld", std::to_string(weldTime));
+}
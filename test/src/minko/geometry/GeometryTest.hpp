@@ -30,6 +30,10 @@ namespace minko
 		class GeometryTest :
 			public ::testing::Test
 		{
+		protected:
+			// Closest hit of the ray by testing every triangle, as Geometry::cast() used to.
+			bool
+			castAllTriangles(Geometry::Ptr geometry, math::Ray::Ptr ray, float& distance, uint& triangle);
 		};
 	}
 }
@@ -0,0 +1,334 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "SkinTest.hpp"
+
+using namespace minko;
+using namespace minko::geometry;
+
+Skin::Ptr
+SkinTest::createSkin(uint numVertices, uint numBones, uint numVertexBones)
+{
+	auto skin = Skin::create(numBones, 1000, 1);
+	auto vertexIds = std::vector<std::vector<unsigned short>>(numBones);
+	auto vertexWeights = std::vector<std::vector<float>>(numBones);
+
+	for (uint vId = 0; vId < numVertices; ++vId)
+	{
+		auto boneId = rand() % numBones;
+		auto totalWeight = 0.f;
+
+		for (uint j = 0; j < numVertexBones; ++j)
+		{
+			auto weight = j + 1 < numVertexBones ? (1.f - totalWeight) * (rand() % 100) / 100.f : 1.f - totalWeight;
+
+			// distinct bones for a given vertex
+			boneId = (boneId + 1 + rand() % 3) % numBones;
+			totalWeight += weight;
+
+			vertexIds[boneId].push_back(vId);
+			vertexWeights[boneId].push_back(weight);
+		}
+	}
+
+	for (uint boneId = 0; boneId < numBones; ++boneId)
+	{
+		skin->bone(boneId, Bone::create(nullptr, math::mat4(1.f), vertexIds[boneId], vertexWeights[boneId]));
+		skin->matrix(
+			0,
+			boneId,
+			math::translate(math::vec3(rand() % 10, rand() % 10, rand() % 10))
+			* math::rotate((rand() % 628) / 100.f, math::normalize(math::vec3(1.f, rand() % 10, rand() % 10)))
+		);
+	}
+
+	return skin->reorganizeByVertices();
+}
+
+void
+SkinTest::referenceSkinning(Skin::Ptr						skin,
+							const std::vector<math::mat4>&	boneMatrices,
+							const std::vector<float>&		input,
+							std::vector<float>&				output,
+							uint							vertexSize,
+							uint							offset,
+							bool							doDeltaTransform)
+{
+	const unsigned int numVertices = skin->numVertices();
+	unsigned int index = offset;
+
+	for (unsigned int vId = 0; vId < numVertices; ++vId)
+	{
+		math::vec4 v1 = math::vec4(input[index], input[index + 1], input[index + 2], 1.f);
+		math::vec4 v2 = math::vec4(0.f);
+
+		const unsigned int numVertexBones = skin->numVertexBones(vId);
+		for (unsigned int j = 0; j < numVertexBones; ++j)
+		{
+			unsigned int boneId = 0;
+			float boneWeight = 0.0f;
+
+			skin->vertexBoneData(vId, j, boneId, boneWeight);
+
+			const math::mat4& boneMatrix = (boneMatrices[boneId]);
+
+			if (!doDeltaTransform)
+				v2 += boneWeight * (boneMatrix * v1);
+			else
+				v2 += math::vec4(boneWeight * (math::mat3(boneMatrix)) * math::vec3(v1), 0.f);
+		}
+
+		output[index] = v2.x;
+		output[index + 1] = v2.y;
+		output[index + 2] = v2.z;
+
+		index += vertexSize;
+	}
+}
+
+TEST_F(SkinTest, ReorganizeByVertices)
+{
+	auto skin = createSkin(100, 10, 3);
+
+	ASSERT_EQ(skin->numVertices(), 100);
+	ASSERT_EQ(skin->maxNumVertexBones(), 3);
+	ASSERT_EQ(skin->vertexBoneIds().size(), 300);
+	ASSERT_EQ(skin->vertexBoneWeights().size(), 300);
+
+	for (uint vId = 0; vId < skin->numVertices(); ++vId)
+	{
+		auto totalWeight = 0.f;
+
+		for (uint j = 0; j < skin->numVertexBones(vId); ++j)
+			totalWeight += skin->vertexBoneWeight(vId, j);
+
+		ASSERT_NEAR(totalWeight, 1.f, 1e-5f);
+	}
+}
+
+TEST_F(SkinTest, ComputeBonePalette)
+{
+	auto matrix = math::translate(math::vec3(1.f, 2.f, 3.f)) * math::rotate(.5f, math::vec3(0.f, 1.f, 0.f));
+	auto palette = Skin::BonePalette();
+
+	Skin::computeBonePalette(std::vector<math::mat4>(2, matrix), palette);
+
+	ASSERT_EQ(palette.size(), 24);
+	for (auto boneId = 0; boneId < 2; ++boneId)
+		for (auto i = 0; i < 3; ++i)
+			for (auto j = 0; j < 4; ++j)
+				ASSERT_FLOAT_EQ(palette[boneId * 12 + i * 4 + j], matrix[j][i]);
+}
+
+TEST_F(SkinTest, ComputeDualQuaternionPalette)
+{
+	auto boneMatrices = std::vector<math::mat4>();
+
+	for (auto i = 0; i < 10; ++i)
+		boneMatrices.push_back(
+			math::translate(math::vec3(rand() % 10, rand() % 10, rand() % 10))
+			* math::rotate((rand() % 628) / 100.f, math::normalize(math::vec3(1.f, rand() % 10, rand() % 10)))
+		);
+
+	auto palette = std::vector<float>(boneMatrices.size() * 8);
+
+	Skin::computeDualQuaternionPalette(boneMatrices, palette.data());
+
+	for (uint boneId = 0; boneId < boneMatrices.size(); ++boneId)
+	{
+		auto real = math::vec4(palette[boneId * 8], palette[boneId * 8 + 1], palette[boneId * 8 + 2], palette[boneId * 8 + 3]);
+		auto dual = math::vec4(palette[boneId * 8 + 4], palette[boneId * 8 + 5], palette[boneId * 8 + 6], palette[boneId * 8 + 7]);
+		auto p = math::vec3(1.f, -2.f, 3.f);
+
+		// same transform as skinning_moveVertex() with SKINNING_PALETTE == 2
+		auto rotated = p + 2.f * math::cross(math::vec3(real), math::cross(math::vec3(real), p) + real.w * p);
+		auto translation = 2.f * (real.w * math::vec3(dual) - dual.w * math::vec3(real) + math::cross(math::vec3(real), math::vec3(dual)));
+		auto expected = boneMatrices[boneId] * math::vec4(p, 1.f);
+
+		ASSERT_NEAR(math::length(real), 1.f, 1e-5f);
+		ASSERT_NEAR(math::dot(real, dual), 0.f, 1e-4f);
+		for (auto i = 0; i < 3; ++i)
+			ASSERT_NEAR(rotated[i] + translation[i], expected[i], 1e-4f);
+	}
+}
+
+TEST_F(SkinTest, SkinVertices)
+{
+	const uint numVertices = 1000;
+	const uint vertexSize = 8;
+	auto skin = createSkin(numVertices, 30, 4);
+	auto input = std::vector<float>(numVertices * vertexSize);
+
+	for (auto& f : input)
+		f = (rand() % 2000) / 100.f - 10.f;
+
+	auto expected = input;
+	auto output = input;
+	auto palette = Skin::BonePalette();
+
+	// positions at offset 0 and normals at offset 3 of interleaved vertices
+	referenceSkinning(skin, skin->matrices(0), input, expected, vertexSize, 0, false);
+	referenceSkinning(skin, skin->matrices(0), input, expected, vertexSize, 3, true);
+
+	Skin::computeBonePalette(skin->matrices(0), palette);
+	skin->skinVertices(palette, 0, numVertices, input.data(), output.data(), vertexSize, input.data() + 3, output.data() + 3, vertexSize);
+
+	for (uint i = 0; i < input.size(); ++i)
+		ASSERT_NEAR(output[i], expected[i], 1e-3f);
+}
+
+TEST_F(SkinTest, SkinVerticesInPlace)
+{
+	const uint numVertices = 100;
+	auto skin = createSkin(numVertices, 10, 2);
+	auto data = std::vector<float>(numVertices * 3);
+
+	for (auto& f : data)
+		f = (rand() % 2000) / 100.f - 10.f;
+
+	auto expected = data;
+	auto palette = Skin::BonePalette();
+
+	referenceSkinning(skin, skin->matrices(0), data, expected, 3, 0, false);
+	Skin::computeBonePalette(skin->matrices(0), palette);
+	skin->skinVertices(palette, 0, numVertices, data.data(), data.data(), 3, nullptr, nullptr, 0);
+
+	for (uint i = 0; i < data.size(); ++i)
+		ASSERT_NEAR(data[i], expected[i], 1e-3f);
+}
+
+TEST_F(SkinTest, SkinVerticesRange)
+{
+	const uint numVertices = 100;
+	auto skin = createSkin(numVertices, 10, 2);
+	auto input = std::vector<float>(numVertices * 3, 1.f);
+	auto output = std::vector<float>(numVertices * 3, 42.f);
+	auto expected = input;
+	auto palette = Skin::BonePalette();
+
+	referenceSkinning(skin, skin->matrices(0), input, expected, 3, 0, false);
+	Skin::computeBonePalette(skin->matrices(0), palette);
+	skin->skinVertices(palette, 10, 20, input.data(), output.data(), 3, nullptr, nullptr, 0);
+
+	for (uint i = 0; i < output.size(); ++i)
+	{
+		if (i >= 30 && i < 60)
+			ASSERT_NEAR(output[i], expected[i], 1e-3f);
+		else
+			ASSERT_EQ(output[i], 42.f);
+	}
+}
+
+TEST_F(SkinTest, Compress)
+{
+	const uint numBones = 8;
+	const uint numFrames = 12;
+	auto skin = Skin::create(numBones, 400, numFrames);
+	auto expected = std::vector<std::vector<math::mat4>>(numFrames, std::vector<math::mat4>(numBones));
+
+	for (uint frameId = 0; frameId < numFrames; ++frameId)
+		for (uint boneId = 0; boneId < numBones; ++boneId)
+		{
+			expected[frameId][boneId] = math::translate(math::vec3(boneId, frameId * .5f, -2.f))
+				* math::rotate(.3f * frameId + boneId, math::normalize(math::vec3(1.f, boneId, 2.f)))
+				* math::scale(math::vec3(1.f + .1f * boneId));
+			skin->matrix(frameId, boneId, expected[frameId][boneId]);
+		}
+
+	ASSERT_EQ(skin->clip(), nullptr);
+	ASSERT_EQ(skin->compress(), skin);
+	ASSERT_NE(skin->clip(), nullptr);
+	ASSERT_EQ(skin->numFrames(), numFrames);
+	ASSERT_EQ(skin->clip()->numTracks(), numBones);
+	ASSERT_THROW(skin->matrix(0, 0, math::mat4(1.f)), std::logic_error);
+
+	// frames in any order, each one being a key of the clip
+	for (auto frameId : { 0u, 5u, 6u, 11u, 3u, 0u })
+	{
+		const auto& matrices = skin->matrices(frameId);
+
+		ASSERT_EQ(matrices.size(), numBones);
+		for (uint boneId = 0; boneId < numBones; ++boneId)
+			for (auto i = 0; i < 4; ++i)
+				for (auto j = 0; j < 4; ++j)
+					ASSERT_NEAR(matrices[boneId][i][j], expected[frameId][boneId][i][j], 2e-3f);
+	}
+
+	// clones share the clip, but not the decoded frame
+	auto clone = skin->clone();
+
+	ASSERT_EQ(clone->clip(), skin->clip());
+	ASSERT_NEAR(clone->matrices(7)[2][3][1], expected[7][2][3][1], 2e-3f);
+	ASSERT_NEAR(skin->matrices(0)[2][3][1], expected[0][2][3][1], 2e-3f);
+}
+
+// Compares the per vertex reference skinning with the bone palette, on one and on all the threads of
+// the default pool. Disabled by default, the time per frame of each variant is recorded as a test
+// property (--gtest_also_run_disabled_tests --gtest_output=xml).
+TEST_F(SkinTest, DISABLED_SoftwareSkinningBenchmark)
+{
+	const uint numCharacters = 20;
+	const uint numVertices = 10000;
+	const uint vertexSize = 8;
+	const uint numFrames = 20;
+	auto skin = createSkin(numVertices, 60, 4);
+	auto input = std::vector<float>(numVertices * vertexSize);
+	auto output = input;
+	auto palette = Skin::BonePalette();
+	auto pool = async::ThreadPool::defaultPool();
+
+	for (auto& f : input)
+		f = (rand() % 2000) / 100.f - 10.f;
+
+	auto benchmark = [&](const std::string& name, std::function<void()> skinCharacter)
+	{
+		auto start = std::chrono::steady_clock::now();
+
+		for (uint frame = 0; frame < numFrames; ++frame)
+			for (uint i = 0; i < numCharacters; ++i)
+				skinCharacter();
+
+		auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count()
+			/ numFrames;
+
+		RecordProperty(name, std::to_string(time));
+	};
+
+	benchmark("msPerFrameReference", [&]()
+	{
+		referenceSkinning(skin, skin->matrices(0), input, output, vertexSize, 0, false);
+		referenceSkinning(skin, skin->matrices(0), input, output, vertexSize, 3, true);
+	});
+
+	benchmark("msPerFramePalette", [&]()
+	{
+		Skin::computeBonePalette(skin->matrices(0), palette);
+		skin->skinVertices(palette, 0, numVertices, input.data(), output.data(), vertexSize, input.data() + 3, output.data() + 3, vertexSize);
+	});
+
+	benchmark("msPerFramePaletteParallel", [&]()
+	{
+		Skin::computeBonePalette(skin->matrices(0), palette);
+		pool->parallelFor(numVertices, 256, [&](uint begin, uint end)
+		{
+			skin->skinVertices(palette, begin, end, input.data(), output.data(), vertexSize, input.data() + 3, output.data() + 3, vertexSize);
+		});
+	});
+}
@@ -0,0 +1,53 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#pragma once
+
+#include "minko/Minko.hpp"
+#include "minko/geometry/Skin.hpp"
+#include "minko/geometry/Bone.hpp"
+
+#include "gtest/gtest.h"
+
+namespace minko
+{
+	namespace geometry
+	{
+		class SkinTest :
+			public ::testing::Test
+		{
+		protected:
+			// Skin of numVertices vertices influenced by numVertexBones random bones each,
+			// with random bone matrices for a single frame.
+			Skin::Ptr
+			createSkin(uint numVertices, uint numBones, uint numVertexBones);
+
+			// Per vertex and per bone math::mat4 products, as Skinning used to do it.
+			void
+			referenceSkinning(Skin::Ptr						skin,
+							  const std::vector<math::mat4>&	boneMatrices,
+							  const std::vector<float>&			input,
+							  std::vector<float>&				output,
+							  uint								vertexSize,
+							  uint								offset,
+							  bool								doDeltaTransform);
+		};
+	}
+}
@@ -0,0 +1,478 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "BoundingVolumeHierarchyTest.hpp"
+
+using namespace minko;
+using namespace minko::math;
+
+void
+BoundingVolumeHierarchyTest::createBoxes(uint numBoxes, float worldSize, std::vector<vec3>& minBounds, std::vector<vec3>& maxBounds)
+{
+	minBounds.clear();
+	maxBounds.clear();
+
+	for (uint i = 0; i < numBoxes; ++i)
+	{
+		auto center = (vec3(rand(), rand(), rand()) / float(RAND_MAX) - .5f) * worldSize;
+		auto halfSize = vec3(rand() % 100 + 1, rand() % 100 + 1, rand() % 100 + 1) / 100.f;
+
+		minBounds.push_back(center - halfSize);
+		maxBounds.push_back(center + halfSize);
+	}
+}
+
+std::vector<bool>
+BoundingVolumeHierarchyTest::testBoxes(Frustum::Ptr frustum, const std::vector<vec3>& minBounds, const std::vector<vec3>& maxBounds)
+{
+	auto visible = std::vector<bool>(minBounds.size());
+
+	for (uint i = 0; i < minBounds.size(); ++i)
+	{
+		auto result = frustum->testBoundingBox(Box::create(maxBounds[i], minBounds[i]));
+
+		visible[i] = result == ShapePosition::INSIDE || result == ShapePosition::AROUND;
+	}
+
+	return visible;
+}
+
+TEST_F(BoundingVolumeHierarchyTest, Build)
+{
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto bvh = BoundingVolumeHierarchy::create();
+
+	createBoxes(1000, 100.f, minBounds, maxBounds);
+	bvh->build(minBounds, maxBounds);
+
+	ASSERT_EQ(bvh->numItems(), 1000);
+
+	auto items = bvh->items();
+
+	std::sort(items.begin(), items.end());
+	for (uint i = 0; i < items.size(); ++i)
+		ASSERT_EQ(items[i], i);
+
+	// every item is referenced once, by a node whose box contains it
+	auto numReferences = std::vector<uint>(1000, 0);
+
+	for (const auto& node : bvh->nodes())
+		for (auto i = 0; i < 4; ++i)
+		{
+			auto child = node.children[i];
+
+			if (child >= 0 || child == BoundingVolumeHierarchy::EMPTY_CHILD)
+				continue;
+
+			++numReferences[~child];
+			ASSERT_EQ(node.minX[i], minBounds[~child].x);
+			ASSERT_EQ(node.maxZ[i], maxBounds[~child].z);
+		}
+
+	for (auto n : numReferences)
+		ASSERT_EQ(n, 1);
+}
+
+TEST_F(BoundingVolumeHierarchyTest, TestPlanes)
+{
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto bvh = BoundingVolumeHierarchy::create();
+	auto frustum = Frustum::create();
+	auto visibleItems = std::vector<uint32_t>();
+
+	createBoxes(5000, 200.f, minBounds, maxBounds);
+	bvh->build(minBounds, maxBounds);
+
+	for (auto i = 0; i < 20; ++i)
+	{
+		auto view = lookAt(vec3(0.f), vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100), vec3(0.f, 1.f, 0.f));
+
+		frustum->updateFromMatrix(perspective(.785f, 1.33f, .1f, 50.f + rand() % 50) * view);
+		bvh->testPlanes(frustum->planes(), visibleItems);
+
+		auto expected = testBoxes(frustum, minBounds, maxBounds);
+		auto numVisible = 0;
+
+		for (uint itemId = 0; itemId < expected.size(); ++itemId)
+		{
+			auto visible = (visibleItems[itemId >> 5] & (1u << (itemId & 31))) != 0;
+
+			ASSERT_EQ(visible, expected[itemId]);
+			numVisible += visible ? 1 : 0;
+		}
+
+		ASSERT_GT(numVisible, 0);
+	}
+}
+
+TEST_F(BoundingVolumeHierarchyTest, Refit)
+{
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto bvh = BoundingVolumeHierarchy::create();
+	auto frustum = Frustum::create();
+	auto visibleItems = std::vector<uint32_t>();
+
+	createBoxes(2000, 200.f, minBounds, maxBounds);
+	bvh->build(minBounds, maxBounds);
+
+	// move some boxes far away, then back in front of the camera
+	for (uint i = 0; i < minBounds.size(); i += 3)
+	{
+		auto offset = vec3(0.f, 0.f, -20.f) - (minBounds[i] + maxBounds[i]) * .5f;
+
+		minBounds[i] += offset;
+		maxBounds[i] += offset;
+	}
+	bvh->refit(minBounds, maxBounds);
+
+	frustum->updateFromMatrix(perspective(.785f, 1.33f, .1f, 100.f));
+	bvh->testPlanes(frustum->planes(), visibleItems);
+
+	auto expected = testBoxes(frustum, minBounds, maxBounds);
+
+	for (uint itemId = 0; itemId < expected.size(); ++itemId)
+	{
+		ASSERT_EQ((visibleItems[itemId >> 5] & (1u << (itemId & 31))) != 0, expected[itemId]);
+		if (itemId % 3 == 0)
+		{
+			ASSERT_TRUE(expected[itemId]);
+		}
+	}
+}
+
+TEST_F(BoundingVolumeHierarchyTest, Empty)
+{
+	auto bvh = BoundingVolumeHierarchy::create();
+	auto frustum = Frustum::create();
+	auto visibleItems = std::vector<uint32_t>(4, 0xffffffff);
+
+	bvh->build(std::vector<vec3>(), std::vector<vec3>());
+	frustum->updateFromMatrix(perspective(.785f, 1.33f, .1f, 100.f));
+	bvh->testPlanes(frustum->planes(), visibleItems);
+
+	ASSERT_TRUE(visibleItems.empty());
+}
+
+TEST_F(BoundingVolumeHierarchyTest, CastRay)
+{
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto boxes = std::vector<Box::Ptr>();
+	auto bvh = BoundingVolumeHierarchy::create();
+
+	createBoxes(5000, 200.f, minBounds, maxBounds);
+	for (uint i = 0; i < minBounds.size(); ++i)
+		boxes.push_back(Box::create(maxBounds[i], minBounds[i]));
+	bvh->build(minBounds, maxBounds);
+
+	auto numHits = 0;
+
+	for (auto i = 0; i < 200; ++i)
+	{
+		// from outside of the boxes, towards a point among them
+		auto origin = normalize(vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100) + vec3(.5f)) * 400.f;
+		auto target = vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100);
+		auto ray = Ray::create(origin, normalize(target - origin));
+
+		auto expectedItem = -1;
+		auto expectedDistance = std::numeric_limits<float>::infinity();
+
+		for (uint itemId = 0; itemId < boxes.size(); ++itemId)
+		{
+			auto distance = 0.f;
+
+			if (boxes[itemId]->cast(ray, distance) && distance < expectedDistance)
+			{
+				expectedItem = itemId;
+				expectedDistance = distance;
+			}
+		}
+
+		auto distance = std::numeric_limits<float>::infinity();
+		uint item = 0;
+		auto numTests = 0u;
+		auto hit = bvh->castRay(ray->origin(), ray->direction(), distance, item, [&](uint itemId, float& maxDistance)
+		{
+			auto itemDistance = 0.f;
+
+			++numTests;
+			if (!boxes[itemId]->cast(ray, itemDistance) || itemDistance >= maxDistance)
+				return false;
+
+			maxDistance = itemDistance;
+
+			return true;
+		});
+
+		ASSERT_EQ(hit, expectedItem >= 0);
+		if (!hit)
+			continue;
+
+		++numHits;
+		ASSERT_EQ(item, expectedItem);
+		ASSERT_FLOAT_EQ(distance, expectedDistance);
+		ASSERT_LT(numTests, boxes.size() / 10);
+	}
+
+	ASSERT_GT(numHits, 0);
+}
+
+TEST_F(BoundingVolumeHierarchyTest, CastRayAlongAxis)
+{
+	auto bvh = BoundingVolumeHierarchy::create();
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+
+	// a row of unit boxes along z: the null x and y components of the ray must not hide them
+	for (auto i = 0; i < 10; ++i)
+	{
+		minBounds.push_back(vec3(-.5f, -.5f, -i * 2.f - .5f));
+		maxBounds.push_back(vec3(.5f, .5f, -i * 2.f + .5f));
+	}
+	bvh->build(minBounds, maxBounds);
+
+	auto origin = vec3(0.f, .25f, 10.f);
+	auto distance = std::numeric_limits<float>::infinity();
+	uint item = 0;
+	auto entry = [&](uint itemId, float& maxDistance)
+	{
+		auto itemDistance = origin.z - maxBounds[itemId].z;
+
+		if (itemDistance < 0.f || itemDistance >= maxDistance)
+			return false;
+
+		maxDistance = itemDistance;
+
+		return true;
+	};
+
+	ASSERT_TRUE(bvh->castRay(origin, vec3(0.f, 0.f, -1.f), distance, item, entry));
+	ASSERT_EQ(item, 0);
+	ASSERT_FLOAT_EQ(distance, 9.5f);
+
+	// the boxes behind the origin are ignored
+	origin = vec3(0.f, 0.f, -5.f);
+	distance = std::numeric_limits<float>::infinity();
+	ASSERT_TRUE(bvh->castRay(origin, vec3(0.f, 0.f, -1.f), distance, item, entry));
+	ASSERT_EQ(item, 3);
+	ASSERT_FLOAT_EQ(distance, .5f);
+
+	origin = vec3(0.f, 0.f, 10.f);
+	distance = 5.f;
+	ASSERT_FALSE(bvh->castRay(origin, vec3(0.f, 0.f, -1.f), distance, item, entry));
+
+	origin = vec3(2.f, 0.f, 10.f);
+	distance = std::numeric_limits<float>::infinity();
+	ASSERT_FALSE(bvh->castRay(origin, vec3(0.f, 0.f, -1.f), distance, item, entry));
+	ASSERT_FALSE(BoundingVolumeHierarchy::create()->castRay(origin, vec3(0.f, 0.f, -1.f), distance, item, entry));
+}
+
+TEST_F(BoundingVolumeHierarchyTest, BuildSurfaceAreaHeuristic)
+{
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto bvh = BoundingVolumeHierarchy::create();
+	auto frustum = Frustum::create();
+	auto visibleItems = std::vector<uint32_t>();
+
+	createBoxes(5000, 200.f, minBounds, maxBounds);
+	bvh->build(minBounds, maxBounds, BoundingVolumeHierarchy::SplitMethod::SURFACE_AREA_HEURISTIC);
+
+	auto items = bvh->items();
+
+	std::sort(items.begin(), items.end());
+	for (uint i = 0; i < items.size(); ++i)
+		ASSERT_EQ(items[i], i);
+
+	// the subtree of every node holds the items it references
+	for (const auto& node : bvh->nodes())
+		for (auto i = 0; i < 4; ++i)
+			if (node.children[i] < 0 && node.children[i] != BoundingVolumeHierarchy::EMPTY_CHILD)
+			{
+				ASSERT_NE(
+					std::find(
+						bvh->items().begin() + node.firstItem,
+						bvh->items().begin() + node.firstItem + node.numItems,
+						~node.children[i]
+					),
+					bvh->items().begin() + node.firstItem + node.numItems
+				);
+			}
+
+	frustum->updateFromMatrix(perspective(.785f, 1.33f, .1f, 100.f));
+	bvh->testPlanes(frustum->planes(), visibleItems);
+
+	auto expected = testBoxes(frustum, minBounds, maxBounds);
+
+	for (uint itemId = 0; itemId < expected.size(); ++itemId)
+		ASSERT_EQ((visibleItems[itemId >> 5] & (1u << (itemId & 31))) != 0, expected[itemId]);
+}
+
+TEST_F(BoundingVolumeHierarchyTest, CastRayPacket)
+{
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto boxes = std::vector<Box::Ptr>();
+
+	createBoxes(5000, 200.f, minBounds, maxBounds);
+	for (uint i = 0; i < minBounds.size(); ++i)
+		boxes.push_back(Box::create(maxBounds[i], minBounds[i]));
+
+	for (auto splitMethod : { BoundingVolumeHierarchy::SplitMethod::MEDIAN, BoundingVolumeHierarchy::SplitMethod::SURFACE_AREA_HEURISTIC })
+	{
+		auto bvh = BoundingVolumeHierarchy::create();
+		auto numHits = 0;
+
+		bvh->build(minBounds, maxBounds, splitMethod);
+
+		for (auto packetId = 0; packetId < 200; ++packetId)
+		{
+			// rays from nearby origins towards nearby points, some of the packets being incomplete
+			const uint numRays = packetId % 4 + 1;
+			auto origin = normalize(vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100) + vec3(.5f)) * 400.f;
+			auto target = vec3(rand() % 200 - 100, rand() % 200 - 100, rand() % 200 - 100);
+			std::vector<Ray::Ptr> rays;
+			vec3 origins[4];
+			vec3 directions[4];
+			float distances[4];
+			uint items[4];
+
+			for (uint i = 0; i < numRays; ++i)
+			{
+				origins[i] = origin + vec3(i % 2, i / 2, 0.f);
+				directions[i] = normalize(target + vec3(0.f, i % 2, i / 2) * 5.f - origins[i]);
+				distances[i] = std::numeric_limits<float>::infinity();
+				rays.push_back(Ray::create(origins[i], directions[i]));
+			}
+
+			auto hitRays = bvh->castRayPacket(origins, directions, numRays, distances, items, [&](uint itemId, uint rayMask, float* maxDistances)
+			{
+				auto itemHitRays = 0u;
+
+				for (uint i = 0; i < 4; ++i)
+				{
+					auto distance = 0.f;
+
+					if ((rayMask & (1u << i)) == 0u || !boxes[itemId]->cast(rays[i], distance) || distance >= maxDistances[i])
+						continue;
+
+					maxDistances[i] = distance;
+					itemHitRays |= 1u << i;
+				}
+
+				return itemHitRays;
+			});
+
+			ASSERT_EQ(hitRays >> numRays, 0u);
+
+			for (uint i = 0; i < numRays; ++i)
+			{
+				auto distance = std::numeric_limits<float>::infinity();
+				uint item = 0;
+				auto hit = bvh->castRay(origins[i], directions[i], distance, item, [&](uint itemId, float& maxDistance)
+				{
+					auto itemDistance = 0.f;
+
+					if (!boxes[itemId]->cast(rays[i], itemDistance) || itemDistance >= maxDistance)
+						return false;
+
+					maxDistance = itemDistance;
+
+					return true;
+				});
+
+				ASSERT_EQ((hitRays & (1u << i)) != 0u, hit);
+				if (!hit)
+					continue;
+
+				++numHits;
+				ASSERT_EQ(items[i], item);
+				ASSERT_FLOAT_EQ(distances[i], distance);
+			}
+		}
+
+		ASSERT_GT(numHits, 0);
+	}
+}
+
+// Frustum culling of 100k boxes one by one versus through the hierarchy. Only run on demand
+// (--gtest_also_run_disabled_tests), the timings end up in the XML report as test properties.
+TEST_F(BoundingVolumeHierarchyTest, DISABLED_CullingBenchmark)
+{
+	const auto numBoxes = 100000u;
+	const auto numFrames = 20;
+	auto minBounds = std::vector<vec3>();
+	auto maxBounds = std::vector<vec3>();
+	auto bvh = BoundingVolumeHierarchy::create();
+	auto frustum = Frustum::create();
+	auto visibleItems = std::vector<uint32_t>();
+	auto boxes = std::vector<Box::Ptr>();
+
+	createBoxes(numBoxes, 1000.f, minBounds, maxBounds);
+	for (uint i = 0; i < numBoxes; ++i)
+		boxes.push_back(Box::create(maxBounds[i], minBounds[i]));
+	bvh->build(minBounds, maxBounds);
+
+	auto setFrame = [&](int frame)
+	{
+		auto direction = vec3(std::cos(frame * .3f), 0.f, std::sin(frame * .3f));
+
+		frustum->updateFromMatrix(perspective(.785f, 1.33f, .1f, 300.f) * lookAt(vec3(0.f), direction, vec3(0.f, 1.f, 0.f)));
+	};
+
+	auto start = std::clock();
+	auto numVisible = 0u;
+
+	for (auto frame = 0; frame < numFrames; ++frame)
+	{
+		setFrame(frame);
+		for (auto& box : boxes)
+		{
+			auto result = frustum->testBoundingBox(box);
+
+			numVisible += result == ShapePosition::INSIDE || result == ShapePosition::AROUND ? 1 : 0;
+		}
+	}
+
+	auto boxesTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numFrames;
+
+	start = std::clock();
+	for (auto frame = 0; frame < numFrames; ++frame)
+	{
+		setFrame(frame);
+		bvh->testPlanes(frustum->planes(), visibleItems);
+	}
+
+	auto bvhTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numFrames;
+
+	start = std::clock();
+	for (auto frame = 0; frame < numFrames; ++frame)
+		bvh->refit(minBounds, maxBounds);
+
+	auto refitTime = 1000.0 * (std::clock() - start) / CLOCKS_PER_SEC / numFrames;
+
+	RecordProperty("visibleBoxes", static_cast<int>(numVisible / numFrames));
+	RecordProperty("msPerFrameBoxes", std::to_string(boxesTime));
+	RecordProperty("msPerFrameHierarchy", std::to_string(bvhTime));
+	RecordProperty("msPerRefit", std::to_string(refitTime));
+}
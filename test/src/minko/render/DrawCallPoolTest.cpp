@@ -48,7 +48,7 @@ createDrawCallWithState(const std::string& effectFile,
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    return pool.drawCalls().begin()->second.at(0u).front();
+    return pool.drawCalls().front();
 }
 
 
@@ -75,9 +75,9 @@ TEST_F(DrawCallPoolTest, UniformDefaultToBindingSwap)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    ASSERT_EQ(pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms().size(), 1);
+    ASSERT_EQ(pool.drawCalls().front()->boundFloatUniforms().size(), 1);
     ASSERT_EQ(
-        pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms()[0].data,
+        pool.drawCalls().front()->boundFloatUniforms()[0].data,
         math::value_ptr(pass->uniformBindings().defaultValues.get<math::vec4>("uDiffuseColor"))
     );
 
@@ -87,13 +87,13 @@ TEST_F(DrawCallPoolTest, UniformDefaultToBindingSwap)
     targetData.addProvider(p);
     pool.update();
 
-    ASSERT_EQ(pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms().size(), 1);
+    ASSERT_EQ(pool.drawCalls().front()->boundFloatUniforms().size(), 1);
     ASSERT_NE(
-        pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms()[0].data,
+        pool.drawCalls().front()->boundFloatUniforms()[0].data,
         math::value_ptr(pass->uniformBindings().defaultValues.get<math::vec4>("uDiffuseColor"))
     );
     ASSERT_EQ(
-        pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms()[0].data,
+        pool.drawCalls().front()->boundFloatUniforms()[0].data,
         math::value_ptr(targetData.get<math::vec4>("diffuseColor"))
     );
 }
@@ -120,22 +120,22 @@ TEST_F(DrawCallPoolTest, UniformBindingToDefaultSwap)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    ASSERT_EQ(pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms().size(), 1);
+    ASSERT_EQ(pool.drawCalls().front()->boundFloatUniforms().size(), 1);
     ASSERT_NE(
-        pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms()[0].data,
+        pool.drawCalls().front()->boundFloatUniforms()[0].data,
         math::value_ptr(pass->uniformBindings().defaultValues.get<math::vec4>("uDiffuseColor"))
     );
     ASSERT_EQ(
-        pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms()[0].data,
+        pool.drawCalls().front()->boundFloatUniforms()[0].data,
         math::value_ptr(targetData.get<math::vec4>("diffuseColor"))
     );
 
     p->unset("diffuseColor");
     pool.update();
 
-    ASSERT_EQ(pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms().size(), 1);
+    ASSERT_EQ(pool.drawCalls().front()->boundFloatUniforms().size(), 1);
     ASSERT_EQ(
-        pool.drawCalls().begin()->second.at(0u).front()->boundFloatUniforms()[0].data,
+        pool.drawCalls().front()->boundFloatUniforms()[0].data,
         math::value_ptr(pass->uniformBindings().defaultValues.get<math::vec4>("uDiffuseColor"))
     );
 }
@@ -156,19 +156,19 @@ TEST_F(DrawCallPoolTest, WatchAndDefineIntMacro)
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
     ASSERT_EQ(targetData.propertyChanged("bar").numCallbacks(), 1);
-    ASSERT_FALSE(pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().end());
+    ASSERT_FALSE(pool.drawCalls().front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().front()->program()->definedMacroNames().end());
 
     auto p = data::Provider::create();
     p->set("bar", 42);
     targetData.addProvider(p);
     pool.update();
 
-    ASSERT_TRUE(pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().end());
+    ASSERT_TRUE(pool.drawCalls().front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().front()->program()->definedMacroNames().end());
 
     p->unset("bar");
     pool.update();
 
-    ASSERT_FALSE(pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().end());
+    ASSERT_FALSE(pool.drawCalls().front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().front()->program()->definedMacroNames().end());
 }
 
 TEST_F(DrawCallPoolTest, WatchAndDefineVariableIntMacro)
@@ -189,18 +189,18 @@ TEST_F(DrawCallPoolTest, WatchAndDefineVariableIntMacro)
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
     ASSERT_EQ(targetData.propertyChanged("material[" + materialUuid + "].bar").numCallbacks(), 1);
-    ASSERT_FALSE(pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().end());
+    ASSERT_FALSE(pool.drawCalls().front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().front()->program()->definedMacroNames().end());
 
     p->set("bar", 42);
     targetData.addProvider(p, "material");
     pool.update();
 
-    ASSERT_TRUE(pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().end());
+    ASSERT_TRUE(pool.drawCalls().front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().front()->program()->definedMacroNames().end());
 
     p->unset("bar");
     pool.update();
 
-    ASSERT_FALSE(pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().begin()->second.at(0u).front()->program()->definedMacroNames().end());
+    ASSERT_FALSE(pool.drawCalls().front()->program()->definedMacroNames().find("FOO") != pool.drawCalls().front()->program()->definedMacroNames().end());
 }
 
 TEST_F(DrawCallPoolTest, StopWatchingMacroAfterDrawCallsRemoved)
@@ -249,6 +249,72 @@ TEST_F(DrawCallPoolTest, SameMacroBindingDifferentVariables)
     ASSERT_EQ(targetData.propertyChanged("material[" + materialUuid2 + "].bar").numCallbacks(), 1);
 }
 
+TEST_F(DrawCallPoolTest, DrawCallsSortedByPriority)
+{
+    auto fx = MinkoTests::loadEffect("effect/state/binding/with-default-value/priority/StatesBindingPriorityWithDefaultValueFirst.effect");
+    DrawCallPool pool;
+    data::Store rootData;
+    data::Store rendererData;
+    data::Store targetData;
+    auto material1 = material::Material::create();
+    auto material2 = material::Material::create();
+
+    material1->data()->set(States::PROPERTY_PRIORITY, 10.f);
+    material2->data()->set(States::PROPERTY_PRIORITY, 20.f);
+    targetData.addProvider(material1->data(), component::Surface::MATERIAL_COLLECTION_NAME);
+    targetData.addProvider(material2->data(), component::Surface::MATERIAL_COLLECTION_NAME);
+
+    pool.addDrawCalls(fx, "default", { { "materialUuid", material1->uuid() } }, rootData, rendererData, targetData);
+    pool.addDrawCalls(fx, "default", { { "materialUuid", material2->uuid() } }, rootData, rendererData, targetData);
+    pool.update();
+
+    ASSERT_EQ(pool.numDrawCalls(), 2);
+    ASSERT_EQ(pool.drawCalls()[0]->priority(), 20.f);
+    ASSERT_EQ(pool.drawCalls()[1]->priority(), 10.f);
+
+    material1->data()->set(States::PROPERTY_PRIORITY, 30.f);
+    pool.update();
+
+    ASSERT_EQ(pool.drawCalls()[0]->priority(), 30.f);
+    ASSERT_EQ(pool.drawCalls()[1]->priority(), 20.f);
+    ASSERT_EQ(pool.drawCalls()[0]->sortIndex(), 0);
+    ASSERT_EQ(pool.drawCalls()[1]->sortIndex(), 1);
+}
+
+TEST_F(DrawCallPoolTest, RemoveDrawCallsKeepsOrder)
+{
+    auto fx = MinkoTests::loadEffect("effect/state/binding/with-default-value/priority/StatesBindingPriorityWithDefaultValueFirst.effect");
+    DrawCallPool pool;
+    data::Store rootData;
+    data::Store rendererData;
+    data::Store targetData;
+    std::vector<material::Material::Ptr> materials;
+    std::vector<uint> batchIds;
+
+    for (auto i = 0; i < 4; ++i)
+    {
+        auto material = material::Material::create();
+
+        material->data()->set(States::PROPERTY_PRIORITY, float(i));
+        targetData.addProvider(material->data(), component::Surface::MATERIAL_COLLECTION_NAME);
+        materials.push_back(material);
+
+        batchIds.push_back(pool.addDrawCalls(
+            fx, "default", { { "materialUuid", material->uuid() } }, rootData, rendererData, targetData
+        ));
+    }
+    pool.update();
+
+    pool.removeDrawCalls(batchIds[2]);
+
+    ASSERT_EQ(pool.numDrawCalls(), 3);
+    ASSERT_EQ(pool.drawCalls()[0]->priority(), 3.f);
+    ASSERT_EQ(pool.drawCalls()[1]->priority(), 1.f);
+    ASSERT_EQ(pool.drawCalls()[2]->priority(), 0.f);
+    for (auto i = 0; i < 3; ++i)
+        ASSERT_EQ(pool.drawCalls()[i]->sortIndex(), i);
+}
+
 /** Sampler states binding swap **/
 
 TEST_F(DrawCallPoolTest, SamplerStateSwapWrapModeBindingToDefaultClamp)
@@ -291,7 +357,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapWrapModeBindingToDefaultClamp)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -348,7 +414,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapWrapModeBindingToDefaultRepeat)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -405,7 +471,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapTextureFilterBindingToDefaultLinear)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -465,7 +531,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapTextureFilterBindingToDefaultNearest)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -524,7 +590,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapMipFilterBindingToDefaultNone)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -581,7 +647,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapMipFilterBindingToDefaultLinear)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -638,7 +704,7 @@ TEST_F(DrawCallPoolTest, SamplerStateSwapMipFilterBindingToDefaultNearest)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -695,7 +761,7 @@ TEST_F(DrawCallPoolTest, SamplerStatesBindingWrapModeNoDefaultValue)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -744,7 +810,7 @@ TEST_F(DrawCallPoolTest, SamplerStateTextureFilterBindingNoDefaultValue)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -793,7 +859,7 @@ TEST_F(DrawCallPoolTest, SamplerStatesBindingMipFilterNoDefaultValue)
 
     auto drawCalls = pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-    auto& samplers = pool.drawCalls().begin()->second.at(0u).front()->samplers();
+    auto& samplers = pool.drawCalls().front()->samplers();
     auto& sampler = samplers[0];
 
     ASSERT_EQ(samplers.size(), 1);
@@ -64,8 +64,7 @@ namespace minko
 
                 pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
 
-                const auto& drawCalls = pool.drawCalls().begin()->second;
-                auto drawCall = drawCalls.at(0u).empty() ? drawCalls.at(1u).front() : drawCalls.at(0u).front();
+                auto drawCall = pool.drawCalls().front();
                 auto stateDefaultValues = drawCall->pass()->stateBindings().defaultValues;
 
                 material->data()->set(stateName, stateMaterialValue);
@@ -121,7 +120,7 @@ namespace minko
                 };
 
                 pool.addDrawCalls(fx, "default", variables, rootData, rendererData, targetData);
-                auto drawCall = pool.drawCalls().begin()->second.at(0u).front();
+                auto drawCall = pool.drawCalls().front();
                 auto stateDefaultValues = drawCall->pass()->stateBindings().defaultValues;
 
                 material->data()->set(stateName, stateMaterialValue);
@@ -0,0 +1,269 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "LightClustersTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+    math::mat4
+    createProjection()
+    {
+        return math::perspective(.785f, 16.f / 9.f, .1f, 100.f);
+    }
+
+    bool
+    clusterHasLight(LightClusters::Ptr clusters, uint cluster, uint light)
+    {
+        const auto begin = clusters->lightIndices().begin() + clusters->offsets()[cluster];
+        const auto end = begin + clusters->counts()[cluster];
+
+        return std::find(begin, end, light) != end;
+    }
+
+    float
+    randomFloat()
+    {
+        return rand() / float(RAND_MAX) * 2.f - 1.f;
+    }
+
+    uint
+    numEntries(LightClusters::Ptr clusters)
+    {
+        auto num = 0u;
+
+        for (auto count : clusters->counts())
+            num += count;
+
+        return num;
+    }
+}
+
+TEST_F(LightClustersTest, Create)
+{
+    auto clusters = LightClusters::create(4, 3, 2, 8);
+
+    ASSERT_EQ(clusters->numClusters(), 24u);
+    ASSERT_EQ(clusters->maxLightsPerCluster(), 8u);
+    ASSERT_EQ(clusters->offsets().size(), 24u);
+    ASSERT_EQ(clusters->counts().size(), 24u);
+    ASSERT_EQ(clusters->clusterIndex(3, 2, 1), 23u);
+}
+
+TEST_F(LightClustersTest, CreateEmptyGridThrows)
+{
+    ASSERT_THROW(LightClusters::create(0, 8, 24), std::invalid_argument);
+    ASSERT_THROW(LightClusters::create(16, 8, 24, 0), std::invalid_argument);
+}
+
+TEST_F(LightClustersTest, OrthographicProjectionThrows)
+{
+    auto clusters = LightClusters::create();
+
+    ASSERT_THROW(
+        clusters->update(math::mat4(1.f), math::ortho(-1.f, 1.f, -1.f, 1.f, .1f, 100.f), {}),
+        std::invalid_argument
+    );
+}
+
+TEST_F(LightClustersTest, DepthRange)
+{
+    auto clusters = LightClusters::create();
+
+    clusters->update(math::mat4(1.f), createProjection(), {});
+
+    ASSERT_NEAR(clusters->zNear(), .1f, 1e-4f);
+    ASSERT_NEAR(clusters->zFar(), 100.f, 1e-1f);
+    ASSERT_TRUE(clusters->lightIndices().empty());
+}
+
+TEST_F(LightClustersTest, ClusterOfPosition)
+{
+    auto clusters = LightClusters::create(16, 8, 24);
+
+    clusters->update(math::mat4(1.f), createProjection(), {});
+
+    // the center of the screen is at the corner of the 4 middle tiles
+    ASSERT_EQ(clusters->cluster(math::vec3(.001f, .001f, -.11f)), clusters->clusterIndex(8, 4, 0));
+    ASSERT_EQ(clusters->cluster(math::vec3(-.001f, -.001f, -.11f)), clusters->clusterIndex(7, 3, 0));
+    ASSERT_EQ(clusters->cluster(math::vec3(0.f, 0.f, -99.f)) / 128u, 23u);
+    // slices are exponential: sqrt(near * far) is the middle of the depth range
+    ASSERT_EQ(clusters->cluster(math::vec3(0.f, 0.f, -std::sqrt(10.f) * 1.01f)) / 128u, 12u);
+    ASSERT_EQ(clusters->cluster(math::vec3(0.f, 0.f, -std::sqrt(10.f) * .99f)) / 128u, 11u);
+}
+
+TEST_F(LightClustersTest, LightBehindCameraIsSkipped)
+{
+    auto clusters = LightClusters::create();
+
+    clusters->update(math::mat4(1.f), createProjection(), { math::vec4(0.f, 0.f, 10.f, 5.f) });
+
+    ASSERT_EQ(numEntries(clusters), 0u);
+}
+
+TEST_F(LightClustersTest, LightBeyondFarPlaneIsSkipped)
+{
+    auto clusters = LightClusters::create();
+
+    clusters->update(math::mat4(1.f), createProjection(), { math::vec4(0.f, 0.f, -120.f, 10.f) });
+
+    ASSERT_EQ(numEntries(clusters), 0u);
+}
+
+TEST_F(LightClustersTest, LightOutsideFrustumIsSkipped)
+{
+    auto clusters = LightClusters::create();
+
+    clusters->update(math::mat4(1.f), createProjection(), { math::vec4(50.f, 0.f, -10.f, 1.f) });
+
+    ASSERT_EQ(numEntries(clusters), 0u);
+}
+
+TEST_F(LightClustersTest, UnboundedLightReachesEveryCluster)
+{
+    auto clusters = LightClusters::create(4, 4, 4);
+
+    clusters->update(math::mat4(1.f), createProjection(), { math::vec4(0.f, 0.f, 10.f, -1.f) });
+
+    for (auto cluster = 0u; cluster < clusters->numClusters(); ++cluster)
+    {
+        ASSERT_EQ(clusters->counts()[cluster], 1u);
+        ASSERT_TRUE(clusterHasLight(clusters, cluster, 0));
+    }
+}
+
+TEST_F(LightClustersTest, SmallLightReachesFewClusters)
+{
+    auto clusters = LightClusters::create(16, 8, 24);
+
+    // well inside the cluster (9, 5, 16)
+    clusters->update(math::mat4(1.f), createProjection(), { math::vec4(1.38f, 1.55f, -11.5f, .05f) });
+
+    const auto cluster = clusters->cluster(math::vec3(1.38f, 1.55f, -11.5f));
+
+    ASSERT_EQ(cluster, clusters->clusterIndex(9, 5, 16));
+    ASSERT_TRUE(clusterHasLight(clusters, cluster, 0));
+    ASSERT_EQ(numEntries(clusters), 1u);
+}
+
+TEST_F(LightClustersTest, BinningIsConservative)
+{
+    auto clusters = LightClusters::create(16, 8, 24, 255);
+    auto view = math::lookAt(math::vec3(3.f, 2.f, 5.f), math::vec3(0.f), math::vec3(0.f, 1.f, 0.f));
+    auto projection = createProjection();
+    auto spheres = std::vector<math::vec4>();
+
+    for (auto i = 0u; i < 200; ++i)
+        spheres.push_back(math::vec4(
+            randomFloat() * 20.f,
+            randomFloat() * 20.f,
+            randomFloat() * 20.f,
+            .1f + (randomFloat() + 1.f) * 2.f
+        ));
+
+    clusters->update(view, projection, spheres);
+
+    ASSERT_EQ(clusters->numDroppedEntries(), 0u);
+
+    for (auto light = 0u; light < spheres.size(); ++light)
+    {
+        const auto& sphere = spheres[light];
+
+        for (auto i = 0u; i < 100; ++i)
+        {
+            auto offset = math::vec3(randomFloat(), randomFloat(), randomFloat());
+
+            if (math::length(offset) > 1.f)
+                continue;
+
+            auto position = sphere.xyz() + offset * sphere.w;
+            auto viewPosition = (view * math::vec4(position, 1.f)).xyz();
+            auto clipPosition = projection * math::vec4(viewPosition, 1.f);
+
+            // only the fragments that can be rendered matter
+            if (clipPosition.w < .1f || clipPosition.w > 100.f
+                || std::abs(clipPosition.x) > clipPosition.w || std::abs(clipPosition.y) > clipPosition.w)
+                continue;
+
+            ASSERT_TRUE(clusterHasLight(clusters, clusters->cluster(viewPosition), light));
+        }
+    }
+}
+
+TEST_F(LightClustersTest, ListsAreSortedByLight)
+{
+    auto clusters = LightClusters::create(8, 4, 8);
+    auto spheres = std::vector<math::vec4>();
+
+    for (auto i = 0u; i < 50; ++i)
+        spheres.push_back(math::vec4(std::cos(i * .5f) * 5.f, std::sin(i * .3f) * 3.f, -2.f - i * .4f, 2.f));
+
+    clusters->update(math::mat4(1.f), createProjection(), spheres);
+
+    ASSERT_GT(numEntries(clusters), 0u);
+    ASSERT_EQ(clusters->lightIndices().size(), numEntries(clusters));
+
+    for (auto cluster = 0u; cluster < clusters->numClusters(); ++cluster)
+    {
+        const auto begin = clusters->lightIndices().begin() + clusters->offsets()[cluster];
+
+        ASSERT_TRUE(std::is_sorted(begin, begin + clusters->counts()[cluster]));
+    }
+}
+
+TEST_F(LightClustersTest, MaxLightsPerCluster)
+{
+    auto clusters = LightClusters::create(16, 8, 24, 4);
+    auto spheres = std::vector<math::vec4>(10, math::vec4(0.f, 0.f, -10.f, 1.f));
+
+    clusters->update(math::mat4(1.f), createProjection(), spheres);
+
+    const auto cluster = clusters->cluster(math::vec3(0.f, 0.f, -10.f));
+
+    ASSERT_EQ(clusters->counts()[cluster], 4u);
+    for (auto light = 0u; light < 4u; ++light)
+        ASSERT_TRUE(clusterHasLight(clusters, cluster, light));
+    ASSERT_FALSE(clusterHasLight(clusters, cluster, 4));
+    ASSERT_GT(clusters->numDroppedEntries(), 0u);
+    ASSERT_EQ(clusters->numDroppedEntries() + numEntries(clusters), 10u * numEntries(clusters) / 4u);
+}
+
+TEST_F(LightClustersTest, GridDoesNotDependOnNumLights)
+{
+    auto clusters = LightClusters::create(16, 8, 24, 64);
+    auto spheres = std::vector<math::vec4>();
+
+    for (auto i = 0u; i < 500; ++i)
+        spheres.push_back(math::vec4((i % 25) * 2.f - 25.f, (i / 25) * 1.f - 10.f, -5.f - (i % 7) * 10.f, 3.f));
+
+    clusters->update(math::mat4(1.f), createProjection(), spheres);
+
+    ASSERT_EQ(clusters->offsets().size(), clusters->numClusters());
+    ASSERT_EQ(clusters->counts().size(), clusters->numClusters());
+
+    for (auto cluster = 0u; cluster < clusters->numClusters(); ++cluster)
+    {
+        ASSERT_LE(clusters->counts()[cluster], 64u);
+        for (auto i = 0u; i < clusters->counts()[cluster]; ++i)
+            ASSERT_LT(clusters->lightIndices()[clusters->offsets()[cluster] + i], 500u);
+    }
+}
@@ -0,0 +1,167 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "PassTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+void
+PassTest::SetUp()
+{
+    _targetProvider = data::Provider::create();
+    _targetData.addProvider(_targetProvider);
+}
+
+void
+PassTest::TearDown()
+{
+    ProgramCache::defaultCache(nullptr);
+}
+
+Pass::Ptr
+PassTest::createPass(AbstractContext::Ptr context)
+{
+    auto vertexShader = Shader::create(
+        context, Shader::Type::VERTEX_SHADER, "void main(void) { gl_Position = vec4(NUM_LIGHTS); }"
+    );
+    auto fragmentShader = Shader::create(
+        context, Shader::Type::FRAGMENT_SHADER, "void main(void) { gl_FragColor = vec4(1.0); }"
+    );
+    auto program = Program::create("PassTest", context, vertexShader, fragmentShader);
+
+    data::BindingMap attributeBindings;
+    data::BindingMap uniformBindings;
+    data::BindingMap stateBindings;
+    data::MacroBindingMap macroBindings;
+    States states;
+
+    stateBindings.defaultValues.addProvider(states.data());
+    macroBindings.bindings["NUM_LIGHTS"] = data::MacroBinding("numLights", data::Binding::Source::TARGET, 0, 1000);
+    macroBindings.types["NUM_LIGHTS"] = data::MacroBindingMap::MacroType::INT;
+
+    return Pass::create("PassTest", true, program, attributeBindings, uniformBindings, stateBindings, macroBindings);
+}
+
+TEST_F(PassTest, SelectProgramVariants)
+{
+    auto pass = createPass(RecordingContext::create());
+    auto programs = std::vector<Program::Ptr>();
+
+    for (auto i = 0; i < 200; ++i)
+    {
+        _targetProvider->set("numLights", i);
+
+        auto programAndSignature = pass->selectProgram(_variables, _targetData, _rendererData, _rootData);
+
+        ASSERT_NE(programAndSignature.second, nullptr);
+        ASSERT_TRUE(programAndSignature.first->isReady());
+        ASSERT_EQ(std::count(programs.begin(), programs.end(), programAndSignature.first), 0);
+
+        programs.push_back(programAndSignature.first);
+    }
+
+    ASSERT_EQ(pass->numVariants(), 200u);
+
+    for (auto i = 199; i >= 0; --i)
+    {
+        _targetProvider->set("numLights", i);
+
+        ASSERT_EQ(pass->selectProgram(_variables, _targetData, _rendererData, _rootData).first, programs[i]);
+    }
+
+    ASSERT_EQ(pass->numVariants(), 200u);
+}
+
+TEST_F(PassTest, SelectProgramUndefinedMacro)
+{
+    auto pass = createPass(RecordingContext::create());
+
+    _targetProvider->set("numLights", 0);
+
+    auto defined = pass->selectProgram(_variables, _targetData, _rendererData, _rootData).first;
+
+    _targetProvider->unset("numLights");
+
+    auto undefined = pass->selectProgram(_variables, _targetData, _rendererData, _rootData).first;
+
+    ASSERT_NE(defined, undefined);
+    ASSERT_EQ(pass->numVariants(), 2u);
+}
+
+TEST_F(PassTest, CopyKeepsVariants)
+{
+    auto pass = createPass(RecordingContext::create());
+
+    for (auto i = 0; i < 20; ++i)
+    {
+        _targetProvider->set("numLights", i);
+        pass->selectProgram(_variables, _targetData, _rendererData, _rootData);
+    }
+
+    auto copy = Pass::create(pass);
+
+    ASSERT_EQ(copy->numVariants(), 20u);
+
+    for (auto i = 0; i < 20; ++i)
+    {
+        _targetProvider->set("numLights", i);
+
+        ASSERT_EQ(
+            copy->selectProgram(_variables, _targetData, _rendererData, _rootData).first,
+            pass->selectProgram(_variables, _targetData, _rendererData, _rootData).first
+        );
+    }
+
+    ASSERT_EQ(copy->numVariants(), 20u);
+}
+
+TEST_F(PassTest, ProgramCache)
+{
+    auto cache = ProgramCache::create();
+
+    ProgramCache::defaultCache(cache);
+
+    auto pass = createPass(RecordingContext::create());
+
+    _targetProvider->set("numLights", 3);
+
+    auto program = pass->selectProgram(_variables, _targetData, _rendererData, _rootData).first;
+    auto key = ProgramCache::key(program->vertexShader()->source(), program->fragmentShader()->source());
+    ProgramCache::Entry entry;
+
+    ASSERT_TRUE(cache->find(key, entry));
+    ASSERT_EQ(entry.vertexSource, program->vertexShader()->contextSource());
+    ASSERT_EQ(entry.fragmentSource, program->fragmentShader()->contextSource());
+    // the recording context does not support binaries
+    ASSERT_TRUE(entry.binary.empty());
+
+    // another pass built from the same effect uploads the cached sources as they are
+    auto cachedEntry = entry;
+
+    cachedEntry.vertexSource += "// cached\n";
+    cache->store(key, cachedEntry);
+
+    auto context = RecordingContext::create();
+    auto otherProgram = createPass(context)->selectProgram(_variables, _targetData, _rendererData, _rootData).first;
+    auto log = std::string(context->log().begin(), context->log().end());
+
+    ASSERT_TRUE(otherProgram->isReady());
+    ASSERT_NE(log.find(cachedEntry.vertexSource), std::string::npos);
+}
@@ -0,0 +1,200 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ProgramBuilderTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+void
+ProgramBuilderTest::SetUp()
+{
+    _targetProvider = data::Provider::create();
+    _targetData.addProvider(_targetProvider);
+}
+
+void
+ProgramBuilderTest::TearDown()
+{
+    ProgramBuilder::defaultBuilder(nullptr);
+    ProgramCache::defaultCache(nullptr);
+}
+
+Pass::Ptr
+ProgramBuilderTest::createPass(AbstractContext::Ptr context)
+{
+    auto vertexShader = Shader::create(
+        context, Shader::Type::VERTEX_SHADER, "void main(void) { gl_Position = vec4(NUM_LIGHTS); }"
+    );
+    auto fragmentShader = Shader::create(
+        context, Shader::Type::FRAGMENT_SHADER, "uniform float uAlpha; void main(void) { gl_FragColor = vec4(uAlpha); }"
+    );
+    auto program = Program::create("ProgramBuilderTest", context, vertexShader, fragmentShader);
+
+    data::BindingMap attributeBindings;
+    data::BindingMap uniformBindings;
+    data::BindingMap stateBindings;
+    data::MacroBindingMap macroBindings;
+    States states;
+
+    stateBindings.defaultValues.addProvider(states.data());
+    macroBindings.bindings["NUM_LIGHTS"] = data::MacroBinding("numLights", data::Binding::Source::TARGET, 0, 1000);
+    macroBindings.types["NUM_LIGHTS"] = data::MacroBindingMap::MacroType::INT;
+
+    return Pass::create("ProgramBuilderTest", true, program, attributeBindings, uniformBindings, stateBindings, macroBindings);
+}
+
+Program::Ptr
+ProgramBuilderTest::selectProgram(Pass::Ptr pass, int numLights)
+{
+    _targetProvider->set("numLights", numLights);
+
+    return pass->selectProgram(_variables, _targetData, _rendererData, _rootData).first;
+}
+
+void
+ProgramBuilderTest::linkAll(ProgramBuilder::Ptr builder)
+{
+    while (builder->numPendingPrograms() != 0)
+        if (builder->update() == 0)
+            std::this_thread::yield();
+}
+
+TEST_F(ProgramBuilderTest, PendingUntilLinked)
+{
+    auto builder = ProgramBuilder::create(async::ThreadPool::create(2));
+
+    ProgramBuilder::defaultBuilder(builder);
+
+    auto pass = createPass(RecordingContext::create());
+    auto program = selectProgram(pass, 3);
+
+    ASSERT_FALSE(program->isReady());
+    ASSERT_TRUE(builder->isPending(program));
+
+    // selecting the variant again does not start another build
+    ASSERT_EQ(selectProgram(pass, 3), program);
+    ASSERT_EQ(builder->numPendingPrograms(), 1u);
+
+    linkAll(builder);
+
+    ASSERT_TRUE(program->isReady());
+    ASSERT_FALSE(builder->isPending(program));
+    ASSERT_EQ(builder->numLinkedPrograms(), 1u);
+    ASSERT_EQ(selectProgram(pass, 3), program);
+}
+
+TEST_F(ProgramBuilderTest, NoDefaultBuilder)
+{
+    auto numContextSources = Shader::numContextSources();
+    auto program = selectProgram(createPass(RecordingContext::create()), 3);
+
+    ASSERT_TRUE(program->isReady());
+    ASSERT_EQ(Shader::numContextSources(), numContextSources + 2);
+}
+
+TEST_F(ProgramBuilderTest, PreprocessOncePerShader)
+{
+    auto builder = ProgramBuilder::create(async::ThreadPool::create(4));
+
+    ProgramBuilder::defaultBuilder(builder);
+
+    auto numContextSources = Shader::numContextSources();
+    auto pass = createPass(RecordingContext::create());
+    auto programs = std::vector<Program::Ptr>();
+
+    for (auto i = 0; i < 32; ++i)
+        programs.push_back(selectProgram(pass, i));
+    for (auto i = 0; i < 32; ++i)
+        selectProgram(pass, i);
+
+    ASSERT_EQ(builder->numPendingPrograms(), 32u);
+
+    linkAll(builder);
+
+    ASSERT_EQ(Shader::numContextSources(), numContextSources + 64);
+    ASSERT_EQ(builder->numLinkedPrograms(), 32u);
+    for (auto program : programs)
+        ASSERT_TRUE(program->isReady());
+}
+
+TEST_F(ProgramBuilderTest, CachedProgramsAreNotPreprocessed)
+{
+    auto builder = ProgramBuilder::create(async::ThreadPool::create(2));
+
+    ProgramBuilder::defaultBuilder(builder);
+    ProgramCache::defaultCache(ProgramCache::create());
+
+    auto firstPass = createPass(RecordingContext::create());
+
+    for (auto i = 0; i < 8; ++i)
+        selectProgram(firstPass, i);
+    linkAll(builder);
+
+    // the same effect loaded in another context, as in the next run of the application
+    auto numContextSources = Shader::numContextSources();
+    auto secondPass = createPass(RecordingContext::create());
+    auto programs = std::vector<Program::Ptr>();
+
+    for (auto i = 0; i < 8; ++i)
+        programs.push_back(selectProgram(secondPass, i));
+    linkAll(builder);
+
+    ASSERT_EQ(Shader::numContextSources(), numContextSources);
+    for (auto program : programs)
+        ASSERT_TRUE(program->isReady());
+}
+
+TEST_F(ProgramBuilderTest, LinkTimeBudget)
+{
+    auto builder = ProgramBuilder::create(async::ThreadPool::create(2));
+
+    ProgramBuilder::defaultBuilder(builder);
+    builder->linkTimeBudget(0.f);
+
+    auto pass = createPass(RecordingContext::create());
+
+    for (auto i = 0; i < 8; ++i)
+        selectProgram(pass, i);
+
+    // with no budget, one program is linked per update
+    while (builder->numPendingPrograms() != 0)
+        ASSERT_LE(builder->update(), 1u);
+
+    ASSERT_EQ(builder->numLinkedPrograms(), 8u);
+}
+
+TEST_F(ProgramBuilderTest, UniformsAppliedOnceLinked)
+{
+    auto builder = ProgramBuilder::create(async::ThreadPool::create(2));
+
+    ProgramBuilder::defaultBuilder(builder);
+
+    auto pass = createPass(RecordingContext::create());
+    auto program = selectProgram(pass, 3);
+
+    // the program is not linked yet: the value is set once it is
+    pass->setUniform("uAlpha", .5f);
+
+    ASSERT_EQ(program->setUniformNames().count("uAlpha"), 0u);
+
+    linkAll(builder);
+
+    ASSERT_EQ(program->setUniformNames().count("uAlpha"), 1u);
+}
@@ -0,0 +1,60 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+#include "minko/Minko.hpp"
+
+#include "gtest/gtest.h"
+
+namespace minko
+{
+    namespace render
+    {
+        class ProgramBuilderTest :
+            public ::testing::Test
+        {
+        protected:
+            data::Store             _targetData;
+            data::Store             _rendererData;
+            data::Store             _rootData;
+            data::Provider::Ptr     _targetProvider;
+            EffectVariables         _variables;
+
+        protected:
+            void
+            SetUp();
+
+            void
+            TearDown();
+
+            // A forward pass with a NUM_LIGHTS integer macro bound to the numLights property of
+            // the target.
+            Pass::Ptr
+            createPass(AbstractContext::Ptr context);
+
+            Program::Ptr
+            selectProgram(Pass::Ptr pass, int numLights);
+
+            // Updates builder until it has no pending program anymore.
+            void
+            linkAll(ProgramBuilder::Ptr builder);
+        };
+    }
+}
@@ -0,0 +1,101 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "ProgramCacheTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+    ProgramCache::Entry
+    createEntry()
+    {
+        ProgramCache::Entry entry;
+
+        entry.vertexSource = "void main(void) { gl_Position = vec4(0.0); }";
+        entry.fragmentSource = "void main(void) { gl_FragColor = vec4(1.0); }";
+        entry.driverInfo = "driver";
+        entry.binaryFormat = 42;
+        entry.binary = { 1, 2, 3, 4 };
+
+        return entry;
+    }
+}
+
+TEST_F(ProgramCacheTest, Key)
+{
+    ASSERT_EQ(ProgramCache::key("a", "b"), ProgramCache::key("a", "b"));
+    ASSERT_NE(ProgramCache::key("a", "b"), ProgramCache::key("b", "a"));
+    ASSERT_NE(ProgramCache::key("ab", "c"), ProgramCache::key("a", "bc"));
+}
+
+TEST_F(ProgramCacheTest, StoreInMemory)
+{
+    auto cache = ProgramCache::create();
+    auto key = ProgramCache::key("vertex", "fragment");
+
+    ProgramCache::Entry entry;
+
+    ASSERT_FALSE(cache->find(key, entry));
+
+    cache->store(key, createEntry());
+
+    ASSERT_TRUE(cache->find(key, entry));
+    ASSERT_EQ(entry.vertexSource, createEntry().vertexSource);
+    ASSERT_EQ(entry.binary, createEntry().binary);
+}
+
+TEST_F(ProgramCacheTest, StoreOnDisk)
+{
+    auto key = ProgramCache::key("ProgramCacheTest", "StoreOnDisk");
+
+    ProgramCache::create(".")->store(key, createEntry());
+
+    // a new cache, as in the next run of the application
+    auto cache = ProgramCache::create(".");
+    ProgramCache::Entry entry;
+
+    ASSERT_TRUE(cache->find(key, entry));
+    ASSERT_EQ(entry.vertexSource, createEntry().vertexSource);
+    ASSERT_EQ(entry.fragmentSource, createEntry().fragmentSource);
+    ASSERT_EQ(entry.driverInfo, createEntry().driverInfo);
+    ASSERT_EQ(entry.binaryFormat, createEntry().binaryFormat);
+    ASSERT_EQ(entry.binary, createEntry().binary);
+
+    std::ostringstream filename;
+
+    filename << "./" << std::hex << std::setw(16) << std::setfill('0') << key << ".program";
+    std::remove(filename.str().c_str());
+}
+
+TEST_F(ProgramCacheTest, InvalidFile)
+{
+    auto key = ProgramCache::key("ProgramCacheTest", "InvalidFile");
+    std::ostringstream filename;
+
+    filename << "./" << std::hex << std::setw(16) << std::setfill('0') << key << ".program";
+    std::ofstream(filename.str(), std::ios::binary) << "not a program";
+
+    ProgramCache::Entry entry;
+
+    ASSERT_FALSE(ProgramCache::create(".")->find(key, entry));
+
+    std::remove(filename.str().c_str());
+}
@@ -164,3 +164,75 @@ TEST_F(ProgramSignatureTest, MaxNumMacros)
 
     ASSERT_EQ(signature.mask(), std::numeric_limits<ProgramSignature::MaskType>::max());
 }
+
+TEST_F(ProgramSignatureTest, Hash)
+{
+    data::MacroBindingMap macroBindings;
+
+    macroBindings.bindings["FOO"] = { "foo", data::Binding::Source::TARGET };
+    macroBindings.types["FOO"] = data::MacroBindingMap::MacroType::INT;
+    macroBindings.bindings["BAR"] = { "bar", data::Binding::Source::TARGET };
+    macroBindings.types["BAR"] = data::MacroBindingMap::MacroType::UNSET;
+
+    ProgramSignature signature1(macroBindings, _variables, _targetData, _rendererData, _rootData);
+    ProgramSignature signature2(macroBindings, _variables, _targetData, _rendererData, _rootData);
+
+    ASSERT_EQ(signature1.hash(), signature2.hash());
+    ASSERT_TRUE(signature1 == signature2);
+
+    _targetProvider->set("foo", 43);
+
+    ProgramSignature signature3(macroBindings, _variables, _targetData, _rendererData, _rootData);
+
+    ASSERT_NE(signature1.hash(), signature3.hash());
+    ASSERT_TRUE(signature1 != signature3);
+
+    _targetProvider->set("foo", 42);
+    _targetProvider->unset("bar");
+
+    ProgramSignature signature4(macroBindings, _variables, _targetData, _rendererData, _rootData);
+
+    ASSERT_NE(signature1.hash(), signature4.hash());
+    ASSERT_TRUE(signature1 != signature4);
+}
+
+TEST_F(ProgramSignatureTest, FloatZeroHash)
+{
+    data::MacroBindingMap macroBindings;
+
+    macroBindings.bindings["FOO"] = { "floatFoo", data::Binding::Source::TARGET };
+    macroBindings.types["FOO"] = data::MacroBindingMap::MacroType::FLOAT;
+
+    _targetProvider->set("floatFoo", 0.f);
+
+    ProgramSignature positiveZero(macroBindings, _variables, _targetData, _rendererData, _rootData);
+
+    _targetProvider->set("floatFoo", -0.f);
+
+    ProgramSignature negativeZero(macroBindings, _variables, _targetData, _rendererData, _rootData);
+
+    ASSERT_TRUE(positiveZero == negativeZero);
+    ASSERT_EQ(positiveZero.hash(), negativeZero.hash());
+}
+
+TEST_F(ProgramSignatureTest, Copy)
+{
+    data::MacroBindingMap macroBindings;
+
+    macroBindings.bindings["FOO"] = { "foo", data::Binding::Source::TARGET };
+    macroBindings.types["FOO"] = data::MacroBindingMap::MacroType::INT;
+
+    ProgramSignature signature(macroBindings, _variables, _targetData, _rendererData, _rootData);
+    ProgramSignature copy(signature);
+
+    ASSERT_TRUE(copy == signature);
+    ASSERT_EQ(copy.hash(), signature.hash());
+    ASSERT_EQ(copy.types().size(), 1);
+    ASSERT_EQ(copy.macros().size(), 1);
+
+    _targetProvider->set("foo", 43);
+
+    ProgramSignature other(macroBindings, _variables, _targetData, _rendererData, _rootData);
+
+    ASSERT_FALSE(copy == other);
+}
@@ -0,0 +1,241 @@
+/*
+Copyright (c) 2013 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "RecordingContextTest.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::render;
+
+scene::Node::Ptr
+RecordingContextTest::createScene(RecordingContext::Ptr context, uint numSurfaces)
+{
+    auto fx = MinkoTests::loadEffect("effect/Basic.effect", file::AssetLibrary::create(context));
+    auto root = scene::Node::create()
+        ->addComponent(SceneManager::create(MinkoTests::canvas()))
+        ->addComponent(PerspectiveCamera::create(1.f))
+        ->addComponent(Renderer::create());
+
+    auto material = material::BasicMaterial::create();
+    material->diffuseColor(math::vec4(1.f));
+
+    auto geometry = geometry::CubeGeometry::create(context);
+
+    for (auto i = 0u; i < numSurfaces; ++i)
+        root->addChild(scene::Node::create()
+            ->addComponent(Transform::create(math::translate(math::vec3((float)i, 0.f, 0.f))))
+            ->addComponent(Surface::create(geometry, material, fx))
+        );
+
+    return root;
+}
+
+TEST_F(RecordingContextTest, Create)
+{
+    auto context = RecordingContext::create();
+
+    ASSERT_EQ(context->numCommands(), 0);
+    ASSERT_TRUE(context->log().empty());
+    ASSERT_FALSE(context->supportsInstancing());
+    ASSERT_TRUE(RecordingContext::create(true)->supportsInstancing());
+}
+
+TEST_F(RecordingContextTest, RecordCommands)
+{
+    auto context = RecordingContext::create();
+    auto indexBuffer = context->createIndexBuffer(3);
+    std::vector<unsigned short> indices = { 0, 1, 2 };
+
+    context->uploaderIndexBufferData(indexBuffer, 0, 3, &indices[0]);
+    context->drawTriangles(indexBuffer, 0, 1);
+    context->drawTriangles(indexBuffer, 0, 1);
+    context->present();
+
+    ASSERT_EQ(context->numCommands(), 5);
+    ASSERT_EQ(context->numCommands(RecordingContext::Command::DrawIndexedTriangles), 2);
+    ASSERT_EQ(context->numFrames(), 1);
+    ASSERT_FALSE(context->log().empty());
+
+    context->clearLog();
+
+    ASSERT_EQ(context->numCommands(), 0);
+    ASSERT_TRUE(context->log().empty());
+}
+
+TEST_F(RecordingContextTest, ResourceIdsAreUnique)
+{
+    auto context = RecordingContext::create();
+    auto vertexBuffer = context->createVertexBuffer(12);
+    auto indexBuffer = context->createIndexBuffer(3);
+    auto texture = context->createTexture(TextureType::Texture2D, 4, 4, false);
+    auto program = context->createProgram();
+
+    ASSERT_NE(vertexBuffer, 0);
+    ASSERT_NE(vertexBuffer, indexBuffer);
+    ASSERT_NE(indexBuffer, texture);
+    ASSERT_NE(texture, program);
+}
+
+TEST_F(RecordingContextTest, ParseProgramInputs)
+{
+    std::vector<std::string> sources = {
+        "#define NUM_LIGHTS 2\n"
+        "attribute vec3 aPosition;\n"
+        "attribute vec2 aUV; // unused\n"
+        "uniform mat4 uModelToWorldMatrix;\n"
+        "uniform highp vec3 uLightColors[NUM_LIGHTS];\n"
+        "#ifdef SKINNING\n"
+        "uniform mat4 uBones[32];\n"
+        "#endif\n"
+        "void main() { gl_Position = uModelToWorldMatrix * vec4(aPosition + uLightColors[0], 1.0); }\n",
+        "uniform sampler2D uDiffuseMap;\n"
+        "uniform float uAlphaThreshold;\n"
+        "void main() { gl_FragColor = texture2D(uDiffuseMap, vec2(0.0)); }\n"
+    };
+
+    auto inputs = RecordingContext::parseProgramInputs(sources);
+
+    ASSERT_EQ(inputs.attributes().size(), 1);
+    ASSERT_EQ(inputs.attributes()[0].name, "aPosition");
+    ASSERT_EQ(inputs.uniforms().size(), 3);
+    ASSERT_EQ(inputs.uniforms()[0].name, "uModelToWorldMatrix");
+    ASSERT_EQ(inputs.uniforms()[0].type, ProgramInputs::Type::float16);
+    ASSERT_EQ(inputs.uniforms()[1].name, "uLightColors[0]");
+    ASSERT_EQ(inputs.uniforms()[1].size, 2);
+    ASSERT_EQ(inputs.uniforms()[1].type, ProgramInputs::Type::float3);
+    ASSERT_EQ(inputs.uniforms()[2].name, "uDiffuseMap");
+    ASSERT_EQ(inputs.uniforms()[2].type, ProgramInputs::Type::sampler2d);
+}
+
+TEST_F(RecordingContextTest, RecordFrame)
+{
+    auto context = RecordingContext::create();
+    auto root = createScene(context, 10);
+    auto renderer = root->component<Renderer>();
+
+    context->clearLog();
+    renderer->render(context);
+    context->present();
+
+    ASSERT_EQ(renderer->numDrawCalls(), 10);
+    ASSERT_EQ(context->numCommands(RecordingContext::Command::DrawIndexedTriangles), 10);
+    ASSERT_EQ(context->numFrames(), 1);
+}
+
+TEST_F(RecordingContextTest, ReplayIntoRecordingContext)
+{
+    auto context = RecordingContext::create();
+    auto root = createScene(context, 10);
+
+    root->component<Renderer>()->render(context);
+    context->present();
+
+    auto target = RecordingContext::create();
+    auto replayer = CommandLogReplayer::create(target);
+
+    replayer->replay(context->log());
+
+    ASSERT_EQ(replayer->numCommands(), context->numCommands());
+    ASSERT_EQ(replayer->numSkippedCommands(), 0);
+    ASSERT_EQ(replayer->numFrames(), 1);
+    ASSERT_EQ(target->log(), context->log());
+}
+
+TEST_F(RecordingContextTest, ReplayUnsignedIntIndices)
+{
+    auto context = RecordingContext::create();
+    auto indexBuffer = render::IndexBuffer::create(context, std::vector<unsigned int>({ 0, 70000, 70001 }));
+
+    context->drawTriangles(indexBuffer->id(), 0, 1);
+
+    auto target = RecordingContext::create();
+    auto replayer = CommandLogReplayer::create(target);
+
+    replayer->replay(context->log());
+
+    ASSERT_TRUE(context->supportsUnsignedIntIndices());
+    ASSERT_EQ(indexBuffer->index(2), 70001);
+    ASSERT_EQ(replayer->numCommands(), 3);
+    ASSERT_EQ(target->log(), context->log());
+}
+
+TEST_F(RecordingContextTest, ReplayIntoOpenGLES2Context)
+{
+    auto context = RecordingContext::create();
+    auto root = createScene(context, 10);
+
+    root->component<Renderer>()->render(context);
+    context->present();
+
+    auto replayer = CommandLogReplayer::create(MinkoTests::canvas()->context());
+
+    replayer->replay(context->log());
+
+    ASSERT_EQ(replayer->numCommands(), context->numCommands());
+    ASSERT_EQ(replayer->numFrames(), 1);
+}
+
+TEST_F(RecordingContextTest, ReplayTruncatedLog)
+{
+    auto context = RecordingContext::create();
+
+    context->createVertexBuffer(12);
+
+    auto log = context->log();
+
+    log.pop_back();
+
+    ASSERT_THROW(CommandLogReplayer::create(RecordingContext::create())->replay(log), std::invalid_argument);
+}
+
+// Not a correctness test: records the number of context calls per frame and the CPU time spent per
+// draw call when rendering a large scene, to keep an eye on submission overhead regressions.
+// Disabled by default: run it with --gtest_also_run_disabled_tests, the figures are written as test
+// properties by --gtest_output=xml.
+TEST_F(RecordingContextTest, DISABLED_RenderBenchmark)
+{
+    const auto numSurfaces = 2000u;
+    const auto numFrames = 20u;
+
+    auto context = RecordingContext::create();
+    auto root = createScene(context, numSurfaces);
+    auto renderer = root->component<Renderer>();
+
+    // The first frame creates the draw calls and uploads the resources.
+    renderer->render(context);
+    context->clearLog();
+
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (auto i = 0u; i < numFrames; ++i)
+    {
+        renderer->render(context);
+        context->present();
+    }
+
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start
+    ).count();
+
+    RecordProperty("contextCallsPerFrame", static_cast<int>(context->numCommands() / numFrames));
+    RecordProperty("nsPerDrawCall", static_cast<int>(duration / (numFrames * numSurfaces)));
+
+    ASSERT_EQ(context->numFrames(), numFrames);
+    ASSERT_EQ(context->numCommands(RecordingContext::Command::DrawIndexedTriangles), numFrames * numSurfaces);
+}
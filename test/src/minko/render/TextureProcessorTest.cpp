@@ -0,0 +1,291 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include "TextureProcessorTest.hpp"
+
+using namespace minko;
+using namespace minko::render;
+
+namespace
+{
+    typedef TextureProcessor::Filter Filter;
+
+    std::vector<unsigned char>
+    createImage(uint width, uint height)
+    {
+        auto image = std::vector<unsigned char>(width * height * 4);
+
+        for (auto i = 0u; i < image.size(); ++i)
+            image[i] = static_cast<unsigned char>((i * 7919u) ^ (i >> 5));
+
+        return image;
+    }
+
+    // The scalar bilinear resize AbstractTexture::resizeData() used to implement.
+    std::vector<unsigned char>
+    resizeBilinear(uint width, uint height, const std::vector<unsigned char>& data, uint newWidth, uint newHeight)
+    {
+        auto result = std::vector<unsigned char>(newWidth * newHeight * 4);
+        const auto xFactor = float(width - 1) / float(newWidth - 1);
+        const auto yFactor = float(height - 1) / float(newHeight - 1);
+
+        for (auto q = 0u; q < newHeight; ++q)
+        {
+            const auto y = q * yFactor;
+            const auto j = std::min(static_cast<uint>(y), height - 1);
+            const auto dy = y - j;
+
+            for (auto p = 0u; p < newWidth; ++p)
+            {
+                const auto x = p * xFactor;
+                const auto i = std::min(static_cast<uint>(x), width - 1);
+                const auto dx = x - i;
+                const auto i1 = std::min(i + 1, width - 1);
+                const auto j1 = std::min(j + 1, height - 1);
+
+                for (auto k = 0u; k < 4; ++k)
+                {
+                    const auto color = (1.f - dx) * (1.f - dy) * data[(i + j * width) * 4 + k]
+                        + dx * (1.f - dy) * data[(i1 + j * width) * 4 + k]
+                        + (1.f - dx) * dy * data[(i + j1 * width) * 4 + k]
+                        + dx * dy * data[(i1 + j1 * width) * 4 + k];
+
+                    result[(p + q * newWidth) * 4 + k] = static_cast<unsigned char>(color + .5f);
+                }
+            }
+        }
+
+        return result;
+    }
+
+    uint
+    maxDifference(const std::vector<unsigned char>& a, const std::vector<unsigned char>& b)
+    {
+        auto difference = 0;
+
+        for (auto i = 0u; i < a.size(); ++i)
+            difference = std::max(difference, std::abs(int(a[i]) - int(b[i])));
+
+        return difference;
+    }
+}
+
+TEST_F(TextureProcessorTest, ResizeSameSize)
+{
+    auto image = createImage(13, 7);
+    auto result = std::vector<unsigned char>();
+
+    TextureProcessor::resize(13, 7, image.data(), 13, 7, Filter::KAISER, true, result);
+
+    ASSERT_EQ(image, result);
+}
+
+TEST_F(TextureProcessorTest, ResizeToZero)
+{
+    auto image = createImage(4, 4);
+    auto result = std::vector<unsigned char>(3);
+
+    TextureProcessor::resize(4, 4, image.data(), 0, 4, Filter::LINEAR, false, result);
+
+    ASSERT_TRUE(result.empty());
+}
+
+TEST_F(TextureProcessorTest, ResizeNearest)
+{
+    auto image = createImage(2, 2);
+    auto result = std::vector<unsigned char>();
+
+    TextureProcessor::resize(2, 2, image.data(), 4, 4, Filter::NEAREST, true, result);
+
+    ASSERT_EQ(result.size(), 4u * 4u * 4u);
+
+    // corner aligned: the last row and column only repeat the last source pixels
+    for (auto k = 0u; k < 4; ++k)
+    {
+        ASSERT_EQ(result[k], image[k]);
+        ASSERT_EQ(result[(3 + 0 * 4) * 4 + k], image[(1 + 0 * 2) * 4 + k]);
+        ASSERT_EQ(result[(0 + 3 * 4) * 4 + k], image[(0 + 1 * 2) * 4 + k]);
+        ASSERT_EQ(result[(3 + 3 * 4) * 4 + k], image[(1 + 1 * 2) * 4 + k]);
+    }
+}
+
+TEST_F(TextureProcessorTest, ResizeLinearMatchesScalar)
+{
+    auto image = createImage(37, 23);
+    auto result = std::vector<unsigned char>();
+
+    TextureProcessor::resize(37, 23, image.data(), 64, 64, Filter::LINEAR, false, result);
+
+    ASSERT_EQ(result.size(), 64u * 64u * 4u);
+    ASSERT_LE(maxDifference(result, resizeBilinear(37, 23, image, 64, 64)), 1u);
+
+    TextureProcessor::resize(37, 23, image.data(), 16, 8, Filter::LINEAR, false, result);
+
+    ASSERT_LE(maxDifference(result, resizeBilinear(37, 23, image, 16, 8)), 1u);
+}
+
+TEST_F(TextureProcessorTest, ResizeBoxAverages)
+{
+    auto image = createImage(512, 256);
+    auto result = std::vector<unsigned char>();
+
+    TextureProcessor::resize(512, 256, image.data(), 256, 128, Filter::BOX, false, result);
+
+    auto expected = std::vector<unsigned char>(256 * 128 * 4);
+
+    for (auto y = 0u; y < 128; ++y)
+        for (auto x = 0u; x < 256; ++x)
+            for (auto k = 0u; k < 4; ++k)
+            {
+                const auto sum = image[(2 * x + 2 * y * 512) * 4 + k]
+                    + image[(2 * x + 1 + 2 * y * 512) * 4 + k]
+                    + image[(2 * x + (2 * y + 1) * 512) * 4 + k]
+                    + image[(2 * x + 1 + (2 * y + 1) * 512) * 4 + k];
+
+                expected[(x + y * 256) * 4 + k] = static_cast<unsigned char>(sum / 4.f + .5f);
+            }
+
+    ASSERT_LE(maxDifference(result, expected), 1u);
+}
+
+TEST_F(TextureProcessorTest, ResizeBoxSRGB)
+{
+    // black and white pixels, alpha 0 and 255
+    const auto image = std::vector<unsigned char>{
+        0, 0, 0, 0,         255, 255, 255, 255,
+        255, 255, 255, 255, 0, 0, 0, 0
+    };
+    auto result = std::vector<unsigned char>();
+
+    TextureProcessor::resize(2, 2, image.data(), 1, 1, Filter::BOX, false, result);
+
+    ASSERT_EQ(result, std::vector<unsigned char>({ 128, 128, 128, 128 }));
+
+    // half the light, encoded back to sRGB, alpha being averaged as is
+    TextureProcessor::resize(2, 2, image.data(), 1, 1, Filter::BOX, true, result);
+
+    ASSERT_EQ(result, std::vector<unsigned char>({ 188, 188, 188, 128 }));
+}
+
+TEST_F(TextureProcessorTest, SRGBRoundTrip)
+{
+    // 32x32 image made of 2x2 blocks of the same value, the value of block i being i
+    auto image = std::vector<unsigned char>(32 * 32 * 4);
+
+    for (auto y = 0u; y < 32; ++y)
+        for (auto x = 0u; x < 32; ++x)
+            for (auto k = 0u; k < 4; ++k)
+                image[(x + y * 32) * 4 + k] = static_cast<unsigned char>(x / 2 + (y / 2) * 16);
+
+    auto result = std::vector<unsigned char>();
+
+    TextureProcessor::resize(32, 32, image.data(), 16, 16, Filter::BOX, true, result);
+
+    for (auto i = 0u; i < 256; ++i)
+        for (auto k = 0u; k < 4; ++k)
+            ASSERT_EQ(result[i * 4 + k], i);
+}
+
+TEST_F(TextureProcessorTest, ResizeKaiser)
+{
+    auto image = std::vector<unsigned char>(64 * 64 * 4);
+
+    for (auto i = 0u; i < image.size(); i += 4)
+    {
+        image[i] = 10;
+        image[i + 1] = 100;
+        image[i + 2] = 200;
+        image[i + 3] = 255;
+    }
+
+    auto result = std::vector<unsigned char>();
+
+    // a constant image remains constant, even on the edges
+    TextureProcessor::resize(64, 64, image.data(), 16, 8, Filter::KAISER, true, result);
+
+    ASSERT_EQ(result.size(), 16u * 8u * 4u);
+
+    for (auto i = 0u; i < result.size(); i += 4)
+    {
+        ASSERT_EQ(result[i], 10);
+        ASSERT_EQ(result[i + 1], 100);
+        ASSERT_EQ(result[i + 2], 200);
+        ASSERT_EQ(result[i + 3], 255);
+    }
+
+    // black then white columns: the ringing around the edge is clamped instead of wrapping
+    for (auto i = 0u; i < image.size(); ++i)
+        image[i] = (i / 4) % 64 < 32 ? 0 : 255;
+
+    TextureProcessor::resize(64, 64, image.data(), 32, 32, Filter::KAISER, false, result);
+
+    for (auto i = 0u; i < result.size(); ++i)
+    {
+        if ((i / 4) % 32 < 16)
+            ASSERT_LT(result[i], 128);
+        else
+            ASSERT_GE(result[i], 128);
+    }
+
+    ASSERT_EQ(result[0], 0);
+    ASSERT_EQ(result[31 * 4], 255);
+}
+
+TEST_F(TextureProcessorTest, MipChainLayout)
+{
+    ASSERT_EQ(TextureProcessor::numMipLevels(1, 1), 1u);
+    ASSERT_EQ(TextureProcessor::numMipLevels(8, 2), 4u);
+    ASSERT_EQ(TextureProcessor::numMipLevels(2, 8), 4u);
+    ASSERT_EQ(TextureProcessor::mipLevelOffset(8, 2, 0), 0u);
+    ASSERT_EQ(TextureProcessor::mipLevelOffset(8, 2, 1), 64u);
+    ASSERT_EQ(TextureProcessor::mipLevelOffset(8, 2, 2), 80u);
+    ASSERT_EQ(TextureProcessor::mipLevelOffset(8, 2, 3), 88u);
+
+    auto image = createImage(8, 2);
+    auto chain = std::vector<unsigned char>();
+
+    TextureProcessor::generateMipChain(8, 2, image.data(), Filter::BOX, false, chain);
+
+    ASSERT_EQ(chain.size(), (16u + 4u + 2u + 1u) * 4u);
+    ASSERT_TRUE(std::equal(image.begin(), image.end(), chain.begin()));
+}
+
+TEST_F(TextureProcessorTest, MipChainLevels)
+{
+    auto image = createImage(256, 256);
+    auto chain = std::vector<unsigned char>();
+
+    TextureProcessor::generateMipChain(256, 256, image.data(), Filter::BOX, true, chain);
+
+    ASSERT_EQ(chain.size(), TextureProcessor::mipLevelOffset(256, 256, 9));
+
+    // each level is the previous one resized
+    for (auto level = 1u; level < 9; ++level)
+    {
+        const auto size = 256u >> level;
+        const auto previous = chain.begin() + TextureProcessor::mipLevelOffset(256, 256, level - 1);
+        const auto current = chain.begin() + TextureProcessor::mipLevelOffset(256, 256, level);
+        auto expected = std::vector<unsigned char>();
+
+        TextureProcessor::resize(size * 2, size * 2, &*previous, size, size, Filter::BOX, true, expected);
+
+        ASSERT_TRUE(std::equal(expected.begin(), expected.end(), current));
+    }
+}
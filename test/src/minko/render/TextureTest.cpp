@@ -57,4 +57,26 @@ TEST_F(TextureTest, UploadRenderTarget)
     {
         ASSERT_TRUE(false);
     }
-}
\ No newline at end of file
+}
+
+TEST_F(TextureTest, GenerateMipChain)
+{
+    auto texture = render::Texture::create(MinkoTests::canvas()->context(), 4, 4, true);
+    auto data = std::vector<unsigned char>(4 * 4 * 4, 255);
+
+    texture->data(data.data());
+
+    ASSERT_FALSE(texture->hasMipChain());
+
+    texture->generateMipChain();
+
+    ASSERT_TRUE(texture->hasMipChain());
+    ASSERT_EQ(texture->data().size(), (16u + 4u + 1u) * 4u);
+
+    texture->upload();
+
+    // resizing keeps a complete chain
+    texture->resize(8, 8, true);
+
+    ASSERT_EQ(texture->data().size(), (64u + 16u + 4u + 1u) * 4u);
+}
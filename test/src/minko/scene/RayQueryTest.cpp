@@ -0,0 +1,264 @@
+/*
+Copyright (c) 2014 Aerys
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and
+associated documentation files (the "Software"), to deal in the Software without restriction,
+including without limitation the rights to use, copy, modify, merge, publish, distribute,
+sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or
+substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include "minko/scene/RayQueryTest.hpp"
+
+#include "minko/MinkoTests.hpp"
+
+using namespace minko;
+using namespace minko::component;
+using namespace minko::scene;
+
+Node::Ptr
+RayQueryTest::createScene(uint gridSize, uint numSphereSegments)
+{
+	auto root = Node::create("root")->addComponent(Transform::create());
+	auto geometry = geometry::SphereGeometry::create(MinkoTests::canvas()->context(), numSphereSegments);
+	auto material = material::Material::create();
+
+	for (uint x = 0; x < gridSize; ++x)
+		for (uint y = 0; y < gridSize; ++y)
+		{
+			auto scale = .5f + (x + y) % 3 * .25f;
+
+			root->addChild(Node::create()
+				->addComponent(Transform::create(
+					math::scale(math::translate(math::vec3(x * 2.f, y * 2.f, 0.f)), math::vec3(scale))
+				))
+				->addComponent(Surface::create(geometry, material))
+			);
+		}
+
+	return root;
+}
+
+bool
+RayQueryTest::castAllSurfaces(Node::Ptr								root,
+							  const math::vec3&						origin,
+							  const math::vec3&						direction,
+							  std::shared_ptr<component::Surface>&	surface,
+							  float&								distance,
+							  uint&									triangle)
+{
+	auto hit = false;
+
+	root->component<Transform>()->modelToWorldMatrix(true);
+	distance = std::numeric_limits<float>::infinity();
+	for (auto node : root->children())
+	{
+		if ((node->layout() & BuiltinLayout::IGNORE_RAYCASTING) != 0)
+			continue;
+
+		auto worldToModel = math::inverse(node->component<Transform>()->modelToWorldMatrix());
+		auto ray = math::Ray::create(
+			math::vec3(worldToModel * math::vec4(origin, 1.f)),
+			math::vec3(worldToModel * math::vec4(direction, 0.f))
+		);
+		auto surfaceDistance = 0.f;
+		uint surfaceTriangle = 0;
+
+		if (node->component<Surface>()->geometry()->cast(ray, surfaceDistance, surfaceTriangle)
+			&& surfaceDistance < distance)
+		{
+			hit = true;
+			surface = node->component<Surface>();
+			distance = surfaceDistance;
+			triangle = surfaceTriangle;
+		}
+	}
+
+	return hit;
+}
+
+TEST_F(RayQueryTest, Create)
+{
+	auto root = Node::create();
+	auto query = RayQuery::create(root);
+
+	ASSERT_EQ(query->root(), root);
+	ASSERT_EQ(query->layoutMask(), LayoutMask::EVERYTHING);
+	ASSERT_EQ(query->numSurfaces(), 0u);
+}
+
+TEST_F(RayQueryTest, Cast)
+{
+	auto root = createScene(5, 20);
+	auto query = RayQuery::create(root);
+	auto origins = std::vector<math::vec3>();
+	auto directions = std::vector<math::vec3>();
+	auto hits = std::vector<RayQuery::Hit>();
+	auto numHits = 0;
+
+	for (auto i = 0; i < 501; ++i)
+	{
+		auto target = math::vec3(rand() % 1000, rand() % 1000, rand() % 200 - 100) / 100.f;
+
+		origins.push_back(math::vec3(4.f, 4.f, 20.f) + math::vec3(i % 4, i / 4 % 4, 0.f) * .1f);
+		directions.push_back(math::normalize(target - origins.back()));
+	}
+
+	query->cast(origins, directions, hits);
+
+	ASSERT_EQ(query->numSurfaces(), 25u);
+	ASSERT_EQ(hits.size(), origins.size());
+
+	for (uint i = 0; i < origins.size(); ++i)
+	{
+		std::shared_ptr<Surface> surface;
+		auto distance = 0.f;
+		uint triangle = 0;
+		auto hit = castAllSurfaces(root, origins[i], directions[i], surface, distance, triangle);
+
+		ASSERT_EQ(hits[i].surface != nullptr, hit);
+		if (!hit)
+			continue;
+
+		++numHits;
+		ASSERT_EQ(hits[i].surface, surface);
+		ASSERT_EQ(hits[i].triangle, triangle);
+		ASSERT_NEAR(hits[i].distance, distance, 1e-4f);
+	}
+
+	ASSERT_GT(numHits, 0);
+}
+
+TEST_F(RayQueryTest, CastMaxDistance)
+{
+	auto root = createScene(1, 20);
+	auto query = RayQuery::create(root);
+	auto origins = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, 10.f));
+	auto directions = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, -1.f));
+	auto hits = std::vector<RayQuery::Hit>();
+
+	query->cast(origins, directions, hits, 9.f);
+	ASSERT_EQ(hits[0].surface, nullptr);
+
+	query->cast(origins, directions, hits, 10.f);
+	ASSERT_NE(hits[0].surface, nullptr);
+	ASSERT_NEAR(hits[0].distance, 9.75f, .01f);
+}
+
+TEST_F(RayQueryTest, CastAfterTransformChanged)
+{
+	auto root = createScene(1, 20);
+	auto query = RayQuery::create(root);
+	auto origins = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, 10.f));
+	auto directions = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, -1.f));
+	auto hits = std::vector<RayQuery::Hit>();
+
+	query->cast(origins, directions, hits);
+	ASSERT_NE(hits[0].surface, nullptr);
+
+	root->children()[0]->component<Transform>()->matrix(math::translate(math::vec3(5.f, 0.f, 0.f)));
+	query->cast(origins, directions, hits);
+	ASSERT_EQ(hits[0].surface, nullptr);
+}
+
+TEST_F(RayQueryTest, CastIgnoreRaycasting)
+{
+	auto root = createScene(1, 20);
+	auto query = RayQuery::create(root);
+	auto origins = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, 10.f));
+	auto directions = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, -1.f));
+	auto hits = std::vector<RayQuery::Hit>();
+
+	root->children()[0]->layout(BuiltinLayout::DEFAULT | BuiltinLayout::IGNORE_RAYCASTING);
+	query->cast(origins, directions, hits);
+
+	ASSERT_EQ(query->numSurfaces(), 0u);
+	ASSERT_EQ(hits[0].surface, nullptr);
+}
+
+TEST_F(RayQueryTest, CastLayoutMask)
+{
+	auto root = createScene(1, 20);
+	auto query = RayQuery::create(root, BuiltinLayout::PICKING);
+	auto origins = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, 10.f));
+	auto directions = std::vector<math::vec3>(1, math::vec3(0.f, 0.f, -1.f));
+	auto hits = std::vector<RayQuery::Hit>();
+
+	query->cast(origins, directions, hits);
+	ASSERT_EQ(hits[0].surface, nullptr);
+
+	query->layoutMask(BuiltinLayout::DEFAULT);
+	query->cast(origins, directions, hits);
+	ASSERT_NE(hits[0].surface, nullptr);
+}
+
+TEST_F(RayQueryTest, CastInvalidDirections)
+{
+	auto query = RayQuery::create(createScene(1, 20));
+	auto hits = std::vector<RayQuery::Hit>();
+
+	ASSERT_THROW(
+		query->cast(std::vector<math::vec3>(2), std::vector<math::vec3>(1), hits),
+		std::invalid_argument
+	);
+}
+
+// Rays per second against every surface versus through RayQuery. Skipped unless disabled tests are
+// requested, the rates are recorded as properties of the test.
+TEST_F(RayQueryTest, DISABLED_CastBenchmark)
+{
+	const auto width = 256;
+	const auto height = 256;
+	auto root = createScene(10, 60);
+	auto query = RayQuery::create(root);
+	auto origins = std::vector<math::vec3>();
+	auto directions = std::vector<math::vec3>();
+	auto hits = std::vector<RayQuery::Hit>();
+
+	// primary rays of a perspective camera looking at the grid, row after row
+	for (auto y = 0; y < height; ++y)
+		for (auto x = 0; x < width; ++x)
+		{
+			origins.push_back(math::vec3(9.f, 9.f, 30.f));
+			directions.push_back(math::normalize(math::vec3(x / (width - 1.f) - .5f, y / (height - 1.f) - .5f, -1.f)));
+		}
+
+	const auto numLoopRays = 2000;
+	std::shared_ptr<Surface> surface;
+	auto distance = 0.f;
+	uint triangle = 0;
+	auto start = std::clock();
+
+	for (auto i = 0; i < numLoopRays; ++i)
+	{
+		auto rayId = i * origins.size() / numLoopRays;
+
+		castAllSurfaces(root, origins[rayId], directions[rayId], surface, distance, triangle);
+	}
+
+	auto loopRaysPerSecond = numLoopRays / ((double)(std::clock() - start) / CLOCKS_PER_SEC);
+
+	// the first cast also builds the triangle hierarchies
+	query->cast(origins, directions, hits);
+
+	auto startTime = std::chrono::high_resolution_clock::now();
+
+	query->cast(origins, directions, hits);
+
+	auto queryTime = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+	auto numHits = std::count_if(hits.begin(), hits.end(), [](const RayQuery::Hit& hit) { return hit.surface != nullptr; });
+
+	ASSERT_GT(numHits, 0);
+
+	RecordProperty("raysPerSecondAllSurfaces", static_cast<int>(loopRaysPerSecond));
+	RecordProperty("raysPerSecondRayQuery", static_cast<int>(origins.size() / queryTime));
+}